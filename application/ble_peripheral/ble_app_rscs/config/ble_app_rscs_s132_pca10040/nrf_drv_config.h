@@ -78,7 +78,7 @@
 #define TIMER2_INSTANCE_INDEX      (TIMER1_ENABLED+TIMER0_ENABLED)
 #endif
 
-#define TIMER3_ENABLED 0
+#define TIMER3_ENABLED 1
 
 #if (TIMER3_ENABLED == 1)
 #define TIMER3_CONFIG_FREQUENCY    NRF_TIMER_FREQ_16MHz
@@ -385,7 +385,7 @@
 
 
 /* SAADC */
-#define SAADC_ENABLED 0
+#define SAADC_ENABLED 1
 
 #if (SAADC_ENABLED == 1)
 #define SAADC_CONFIG_RESOLUTION      NRF_SAADC_RESOLUTION_10BIT
@@ -36,16 +36,24 @@
 #include "ble_rscs.h"
 #include "ble_dis.h"
 #include "ble_conn_params.h"
+#include "ble_conn_params_policy.h"
+#include "ble_evt_router.h"
 #include "boards.h"
 #include "sensorsim.h"
+#include "app_saadc_acq.h"
 #include "softdevice_handler.h"
 #include "app_timer.h"
 #include "device_manager.h"
 #include "pstorage.h"
+#include "fstorage.h"
 #include "app_trace.h"
 #include "bsp.h"
 #include "bsp_btn_ble.h"
 #include "nrf_delay.h"
+#include "app_profiler.h"
+#include "app_util_platform.h"
+#include "app_energy.h"
+#include "ble_radio_notification.h"
 #ifdef BLE_DFU_APP_SUPPORT
 #include "ble_dfu.h"
 #include "dfu_app_handler.h"
@@ -53,6 +61,9 @@
 
 #ifdef BLE_DATA_SYNC_SUPPORT
 #include "ble_data_sync.h"
+#if APP_ENERGY_ENABLED
+STATIC_ASSERT(APP_ENERGY_REPORT_SIZE <= BLE_DATA_SYNC_DIAG_MAX_LEN);
+#endif
 #endif //BLE_DATA_SYNC_SUPPORT
 
 #define IS_SRVC_CHANGED_CHARACT_PRESENT 1                                          /**< Include or not the service_changed characteristic. if not enabled, the server's database cannot be changed for the lifetime of the device*/
@@ -69,9 +80,18 @@
 #define APP_TIMER_OP_QUEUE_SIZE         4                                          /**< Size of timer operation queues. */
 
 #define BATTERY_LEVEL_MEAS_INTERVAL     APP_TIMER_TICKS(2000, APP_TIMER_PRESCALER)  /**< Battery level measurement interval (ticks). */
-#define MIN_BATTERY_LEVEL               81                                          /**< Minimum battery level as returned by the simulated measurement function. */
-#define MAX_BATTERY_LEVEL               100                                         /**< Maximum battery level as returned by the simulated measurement function. */
-#define BATTERY_LEVEL_INCREMENT         1                                           /**< Value by which the battery level is incremented/decremented for each call to the simulated measurement function. */
+#define BATTERY_SAMPLE_INTERVAL_US      10000                                       /**< Time between two conversions of the supply voltage (microseconds). */
+#define BATTERY_SAMPLE_BUFFER_SIZE      32                                          /**< Number of conversions stored before the CPU is woken up. */
+#define BATTERY_DECIMATION_FACTOR       64                                          /**< Number of conversions averaged into one battery voltage. */
+#define BATTERY_ADC_TIMER_INSTANCE      3                                           /**< TIMER instance that triggers the supply voltage conversions. */
+
+#define ADC_REF_VOLTAGE_IN_MILLIVOLTS   600                                         /**< Reference voltage (in milli volts) used by the SAADC. */
+#define ADC_PRE_SCALING_COMPENSATION    6                                           /**< The SAADC is configured with a gain of 1/6, the result is multiplied by 6 to get the actual voltage. */
+#define ADC_RES_10BIT                   1024                                        /**< Maximum digital value for 10-bit SAADC conversion. */
+
+/**@brief Macro for converting an SAADC result to milli volts. */
+#define ADC_RESULT_IN_MILLI_VOLTS(ADC_VALUE)                                        \
+        ((((ADC_VALUE) * ADC_REF_VOLTAGE_IN_MILLIVOLTS) / ADC_RES_10BIT) * ADC_PRE_SCALING_COMPENSATION)
 
 #define SPEED_AND_CADENCE_MEAS_INTERVAL 1000                                        /**< Speed and cadence measurement interval (milliseconds). */
 
@@ -97,6 +117,18 @@
 #define NEXT_CONN_PARAMS_UPDATE_DELAY   APP_TIMER_TICKS(30000, APP_TIMER_PRESCALER)/**< Time between each call to sd_ble_gap_conn_param_update after the first call (30 seconds). */
 #define MAX_CONN_PARAMS_UPDATE_COUNT    3                                           /**< Number of attempts before giving up the connection parameter negotiation. */
 
+#define FAST_MIN_CONN_INTERVAL          MSEC_TO_UNITS(7.5, UNIT_1_25_MS)            /**< Minimum connection interval when there is traffic demand (7.5 ms). */
+#define FAST_MAX_CONN_INTERVAL          MSEC_TO_UNITS(30, UNIT_1_25_MS)             /**< Maximum connection interval when there is traffic demand (30 ms). */
+#define POLICY_EVAL_INTERVAL            APP_TIMER_TICKS(1000, APP_TIMER_PRESCALER)  /**< Time between traffic demand evaluations (1 second). */
+#define POLICY_RX_HIGH_BYTES            200                                         /**< Bytes written by the peer per evaluation at or above which fast parameters are requested. */
+#define POLICY_RX_LOW_BYTES             20                                          /**< Bytes written by the peer per evaluation at or below which demand is low. */
+#define POLICY_TX_HIGH_PACKETS          8                                           /**< Packets sent per evaluation at or above which fast parameters are requested. */
+#define POLICY_TX_LOW_PACKETS           2                                           /**< Packets sent per evaluation at or below which demand is low. */
+#define POLICY_TX_QUEUE_HIGH            4                                           /**< Queued packets at or above which fast parameters are requested. */
+#define POLICY_BULK_HIGH_BYTES          64                                          /**< Pending bulk bytes at or above which fast parameters are requested. A full Diagnostics read leaves more after its first part. */
+#define POLICY_IDLE_EVALS               5                                           /**< Evaluations with low demand before slow parameters are requested back. */
+#define POLICY_RETRY_EVALS              30                                          /**< Evaluations to wait after the peer rejected a request. */
+
 #define SEC_PARAM_BOND                  1                                           /**< Perform bonding. */
 #define SEC_PARAM_MITM                  0                                           /**< Man In The Middle protection not required. */
 #define SEC_PARAM_LESC                  0                                           /**< LE Secure Connections not enabled. */
@@ -106,6 +138,9 @@
 #define SEC_PARAM_MIN_KEY_SIZE          7                                           /**< Minimum encryption key size. */
 #define SEC_PARAM_MAX_KEY_SIZE          16                                          /**< Maximum encryption key size. */
 
+#define SD_EVT_RING_SIZE                8                                           /**< Number of SoftDevice events held between the stack event interrupt and their handlers. Must be a power of two. */
+#define SD_EVT_BATCH_SIZE               4                                           /**< Maximum number of SoftDevice events dispatched per pass when a scheduler is used. */
+
 #define DEAD_BEEF                       0xDEADBEEF                                  /**< Value used as error code on stack dump, can be used to identify stack location on stack unwind. */
 
 #ifdef BLE_DFU_APP_SUPPORT
@@ -134,8 +169,9 @@ static uint16_t                         m_conn_handle = BLE_CONN_HANDLE_INVALID;
 static ble_bas_t                        m_bas;                                      /**< Structure used to identify the battery service. */
 static ble_rscs_t                       m_rscs;                                     /**< Structure used to identify the running speed and cadence service. */
 
-static sensorsim_cfg_t                  m_battery_sim_cfg;                         /**< Battery Level sensor simulator configuration. */
-static sensorsim_state_t                m_battery_sim_state;                       /**< Battery Level sensor simulator state. */
+static volatile uint8_t                 m_battery_level = 100;                     /**< Latest battery level, computed from the filtered supply voltage. */
+static nrf_saadc_value_t                m_battery_samples[2 * BATTERY_SAMPLE_BUFFER_SIZE]; /**< Double buffer for supply voltage conversions. */
+static const nrf_drv_timer_t            m_battery_adc_timer = NRF_DRV_TIMER_INSTANCE(BATTERY_ADC_TIMER_INSTANCE); /**< TIMER that triggers the supply voltage conversions. */
 
 static sensorsim_cfg_t                  m_speed_mps_sim_cfg;                       /**< Speed simulator configuration. */
 static sensorsim_state_t                m_speed_mps_sim_state;                     /**< Speed simulator state. */
@@ -185,7 +221,7 @@ static void battery_level_update(void)
     uint32_t err_code;
     uint8_t  battery_level;
 
-    battery_level = (uint8_t)sensorsim_measure(&m_battery_sim_state, &m_battery_sim_cfg);
+    battery_level = m_battery_level;
 
     err_code = ble_bas_battery_level_update(&m_bas, battery_level);
     if ((err_code != NRF_SUCCESS) &&
@@ -210,6 +246,58 @@ static void battery_level_meas_timeout_handler(void * p_context)
 {
     UNUSED_PARAMETER(p_context);
     battery_level_update();
+
+    // Keeps energy accounting correct across RTC wraps.
+    app_energy_update();
+}
+
+
+/**@brief Function for handling a filtered supply voltage result.
+ *
+ * @param[in]   p_results       Filtered conversion result of the supply voltage channel.
+ * @param[in]   channel_count   Number of results, always 1.
+ */
+static void battery_adc_handler(int16_t const * p_results, uint8_t channel_count)
+{
+    UNUSED_PARAMETER(channel_count);
+
+    int32_t millivolts = ADC_RESULT_IN_MILLI_VOLTS((int32_t)p_results[0]);
+
+    m_battery_level = battery_level_in_percent((millivolts > 0) ? (uint16_t)millivolts : 0);
+}
+
+
+/**@brief Function for starting the continuous supply voltage measurement.
+ *
+ * @details The supply voltage is sampled every BATTERY_SAMPLE_INTERVAL_US by the TIMER through
+ *          PPI. The conversions are averaged, and the battery level is updated once every
+ *          BATTERY_DECIMATION_FACTOR conversions.
+ */
+static void battery_adc_init(void)
+{
+    uint32_t err_code;
+
+    static const nrf_saadc_channel_config_t channel_config =
+        NRF_DRV_SAADC_DEFAULT_CHANNEL_CONFIG_SE(NRF_SAADC_INPUT_VDD);
+
+    app_saadc_acq_config_t acq_config =
+    {
+        .p_channels         = &channel_config,
+        .channel_count      = 1,
+        .p_timer            = &m_battery_adc_timer,
+        .sample_interval_us = BATTERY_SAMPLE_INTERVAL_US,
+        .p_buffer           = m_battery_samples,
+        .buffer_size        = BATTERY_SAMPLE_BUFFER_SIZE,
+        .decimator          =
+        {
+            .filter    = DECIMATOR_FILTER_AVERAGE,
+            .factor    = BATTERY_DECIMATION_FACTOR,
+            .ema_shift = 0
+        }
+    };
+
+    err_code = app_saadc_acq_start(&acq_config, battery_adc_handler);
+    APP_ERROR_CHECK(err_code);
 }
 
 
@@ -255,7 +343,11 @@ static void rsc_meas_timeout_handler(void * p_context)
     rsc_sim_measurement(&rscs_measurement);
 
     err_code = ble_rscs_measurement_send(&m_rscs, &rscs_measurement);
-    if (
+    if (err_code == NRF_SUCCESS)
+    {
+        ble_conn_params_policy_tx_queued(1);
+    }
+    else if (
         (err_code != NRF_SUCCESS)
         &&
         (err_code != NRF_ERROR_INVALID_STATE)
@@ -426,6 +518,61 @@ static void reset_prepare(void)
 #endif // BLE_DFU_APP_SUPPORT
 
 
+/**@brief Function for passing a routed BLE event to the Running Speed and Cadence Service. */
+static void rscs_ble_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_rscs_on_ble_evt((ble_rscs_t *)p_context, p_ble_evt);
+}
+
+
+/**@brief Function for passing a routed BLE event to the Battery Service. */
+static void bas_ble_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_bas_on_ble_evt((ble_bas_t *)p_context, p_ble_evt);
+}
+
+
+#ifdef BLE_DFU_APP_SUPPORT
+/**@brief Function for passing a routed BLE event to the DFU Service. */
+static void dfu_ble_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_dfu_on_ble_evt((ble_dfu_t *)p_context, p_ble_evt);
+}
+#endif // BLE_DFU_APP_SUPPORT
+
+
+#ifdef BLE_DATA_SYNC_SUPPORT
+/**@brief Function for passing a routed BLE event to the data sync Service. */
+static void data_sync_ble_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_data_sync_on_ble_evt((ble_data_sync_t *)p_context, p_ble_evt);
+}
+#endif // BLE_DATA_SYNC_SUPPORT
+
+
+/**@brief Function for registering a service with the BLE event router.
+ *
+ * @details The service receives GATT Server events for the attributes from its service handle up
+ *          to the next registered service, and all events that do not refer to an attribute.
+ *
+ * @param[in] service_handle  Handle of the service.
+ * @param[in] handler         Event handler of the service.
+ * @param[in] p_context       Service instance.
+ */
+static void service_evt_route_register(uint16_t                 service_handle,
+                                       ble_evt_router_handler_t handler,
+                                       void                   * p_context)
+{
+    uint32_t err_code;
+
+    err_code = ble_evt_router_service_register(service_handle, handler, p_context);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = ble_evt_router_subscribe(handler, p_context);
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**@brief Function for initializing services that will be used by the application.
  *
  * @details Initialize the Running Speed and Cadence, Battery and Device Information services.
@@ -460,6 +607,7 @@ static void services_init(void)
 
     err_code = ble_rscs_init(&m_rscs, &rscs_init);
     APP_ERROR_CHECK(err_code);
+    service_evt_route_register(m_rscs.service_handle, rscs_ble_evt_route, &m_rscs);
 
     // Initialize Battery Service.
     memset(&bas_init, 0, sizeof(bas_init));
@@ -478,6 +626,7 @@ static void services_init(void)
 
     err_code = ble_bas_init(&m_bas, &bas_init);
     APP_ERROR_CHECK(err_code);
+    service_evt_route_register(m_bas.service_handle, bas_ble_evt_route, &m_bas);
 
     // Initialize Device Information Service.
     memset(&dis_init, 0, sizeof(dis_init));
@@ -504,6 +653,7 @@ static void services_init(void)
 
     err_code = ble_dfu_init(&m_dfus, &dfus_init);
     APP_ERROR_CHECK(err_code);
+    service_evt_route_register(m_dfus.service_handle, dfu_ble_evt_route, &m_dfus);
 
     dfu_app_reset_prepare_set(reset_prepare);
     dfu_app_dm_appl_instance_set(m_app_handle);
@@ -516,9 +666,14 @@ static void services_init(void)
 		memset(&data_syncs_init, 0, sizeof(data_syncs_init));
 		
 		data_syncs_init.revision = 0X02;
+#if APP_ENERGY_ENABLED
+		data_syncs_init.diag_encode = app_energy_report_encode;
+#endif
+		data_syncs_init.pending_handler = ble_conn_params_policy_bulk_pending_set;
 		
 		err_code = ble_data_sync_init(&m_data_syncs, &data_syncs_init);
     APP_ERROR_CHECK(err_code);
+    service_evt_route_register(m_data_syncs.service_handle, data_sync_ble_evt_route, &m_data_syncs);
 	  
 #endif
 }
@@ -528,13 +683,6 @@ static void services_init(void)
  */
 static void sensor_simulator_init(void)
 {
-    m_battery_sim_cfg.min          = MIN_BATTERY_LEVEL;
-    m_battery_sim_cfg.max          = MAX_BATTERY_LEVEL;
-    m_battery_sim_cfg.incr         = BATTERY_LEVEL_INCREMENT;
-    m_battery_sim_cfg.start_at_max = true;
-
-    sensorsim_init(&m_battery_sim_state, &m_battery_sim_cfg);
-
     // speed is in units of meters per second divided by 256
     m_speed_mps_sim_cfg.min          = (uint32_t)(MIN_SPEED_MPS * 256);
     m_speed_mps_sim_cfg.max          = (uint32_t)(MAX_SPEED_MPS * 256);
@@ -591,6 +739,12 @@ static void on_conn_params_evt(ble_conn_params_evt_t * p_evt)
 {
     uint32_t err_code;
 
+    if (ble_conn_params_policy_on_conn_params_evt(p_evt))
+    {
+        // Outcome of a traffic driven parameter change, the connection is kept either way.
+        return;
+    }
+
     if (p_evt->evt_type == BLE_CONN_PARAMS_EVT_FAILED)
     {
         err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_CONN_INTERVAL_UNACCEPTABLE);
@@ -632,6 +786,43 @@ static void conn_params_init(void)
 }
 
 
+/**@brief Function for initializing the Connection Parameters Policy module.
+ *
+ * @details Switches to fast parameters while there is traffic, and back to the parameters set in
+ *          gap_params_init() when the link has been idle for a while.
+ */
+static void conn_params_policy_init(void)
+{
+    uint32_t                      err_code;
+    ble_conn_params_policy_init_t policy_init;
+
+    memset(&policy_init, 0, sizeof(policy_init));
+
+    policy_init.low_power_params.min_conn_interval       = MIN_CONN_INTERVAL;
+    policy_init.low_power_params.max_conn_interval       = MAX_CONN_INTERVAL;
+    policy_init.low_power_params.slave_latency           = SLAVE_LATENCY;
+    policy_init.low_power_params.conn_sup_timeout        = CONN_SUP_TIMEOUT;
+    policy_init.high_throughput_params.min_conn_interval = FAST_MIN_CONN_INTERVAL;
+    policy_init.high_throughput_params.max_conn_interval = FAST_MAX_CONN_INTERVAL;
+    policy_init.high_throughput_params.slave_latency     = 0;
+    policy_init.high_throughput_params.conn_sup_timeout  = CONN_SUP_TIMEOUT;
+    policy_init.eval_interval                            = POLICY_EVAL_INTERVAL;
+    policy_init.rx_high_bytes                            = POLICY_RX_HIGH_BYTES;
+    policy_init.rx_low_bytes                             = POLICY_RX_LOW_BYTES;
+    policy_init.tx_high_packets                          = POLICY_TX_HIGH_PACKETS;
+    policy_init.tx_low_packets                           = POLICY_TX_LOW_PACKETS;
+    policy_init.tx_queue_high                            = POLICY_TX_QUEUE_HIGH;
+    policy_init.bulk_high_bytes                          = POLICY_BULK_HIGH_BYTES;
+    policy_init.idle_evals                               = POLICY_IDLE_EVALS;
+    policy_init.retry_evals                              = POLICY_RETRY_EVALS;
+    policy_init.evt_handler                              = NULL;
+    policy_init.error_handler                            = conn_params_error_handler;
+
+    err_code = ble_conn_params_policy_init(&policy_init);
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**@brief Function for putting the chip into sleep mode.
  *
  * @note This function will not return.
@@ -690,10 +881,19 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
             err_code = bsp_indication_set(BSP_INDICATE_CONNECTED);
             APP_ERROR_CHECK(err_code);
             m_conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            fs_radio_conn_interval_set(
+                p_ble_evt->evt.gap_evt.params.connected.conn_params.max_conn_interval * UNIT_1_25_MS);
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            fs_radio_conn_interval_set(
+                p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params.max_conn_interval *
+                UNIT_1_25_MS);
             break;
 
         case BLE_GAP_EVT_DISCONNECTED:
             m_conn_handle = BLE_CONN_HANDLE_INVALID;
+            fs_radio_conn_interval_set(0);
             break;
 
         default:
@@ -712,24 +912,14 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
  */
 static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
 {
-    dm_ble_evt_handler(p_ble_evt);
-    ble_rscs_on_ble_evt(&m_rscs, p_ble_evt);
-    ble_bas_on_ble_evt(&m_bas, p_ble_evt);
-    ble_conn_params_on_ble_evt(p_ble_evt);
-    bsp_btn_ble_on_ble_evt(p_ble_evt);
-    on_ble_evt(p_ble_evt);
-    ble_advertising_on_ble_evt(p_ble_evt);
-#ifdef BLE_DFU_APP_SUPPORT
-    /** @snippet [Propagating BLE Stack events to DFU Service] */
-    ble_dfu_on_ble_evt(&m_dfus, p_ble_evt);
-    /** @snippet [Propagating BLE Stack events to DFU Service] */
-#endif // BLE_DFU_APP_SUPPORT
-
-	#ifdef BLE_DATA_SYNC_SUPPORT
-    /** @snippet [Propagating BLE Stack events to data sync Service] */
-    ble_data_sync_on_ble_evt(&m_data_syncs, p_ble_evt);
-    /** @snippet [Propagating BLE Stack events to data sync Service] */
-#endif // BLE_DATA_SYNC_SUPPORT
+    APP_PROFILE("dm", dm_ble_evt_handler(p_ble_evt));
+    // Services registered in services_init() only receive events that concern them.
+    APP_PROFILE("services", ble_evt_router_on_ble_evt(p_ble_evt));
+    APP_PROFILE("conn_params", ble_conn_params_on_ble_evt(p_ble_evt));
+    APP_PROFILE("conn_policy", ble_conn_params_policy_on_ble_evt(p_ble_evt));
+    APP_PROFILE("bsp_btn", bsp_btn_ble_on_ble_evt(p_ble_evt));
+    APP_PROFILE("on_ble_evt", on_ble_evt(p_ble_evt));
+    APP_PROFILE("advertising", ble_advertising_on_ble_evt(p_ble_evt));
 }
 
 
@@ -742,8 +932,9 @@ static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
  */
 static void sys_evt_dispatch(uint32_t sys_evt)
 {
-    pstorage_sys_event_handler(sys_evt);
-    ble_advertising_on_sys_evt(sys_evt);
+    APP_PROFILE("pstorage", pstorage_sys_event_handler(sys_evt));
+    APP_PROFILE("fstorage", fs_sys_event_handler(sys_evt));
+    APP_PROFILE("adv_sys", ble_advertising_on_sys_evt(sys_evt));
 }
 
 
@@ -757,8 +948,10 @@ static void ble_stack_init(void)
     
     nrf_clock_lf_cfg_t clock_lf_cfg = NRF_CLOCK_LFCLKSRC;
     
-    // Initialize the SoftDevice handler module.
-    SOFTDEVICE_HANDLER_INIT(&clock_lf_cfg, NULL);
+    // Initialize the SoftDevice handler module. Pending events are pulled into a ring, taking
+    // System and BLE events in turn, so that a burst of notifications does not hold back the
+    // flash operation results.
+    SOFTDEVICE_HANDLER_RING_INIT(&clock_lf_cfg, SD_EVT_RING_SIZE, SD_EVT_BATCH_SIZE, NULL);
     
     ble_enable_params_t ble_enable_params;
     err_code = softdevice_enable_get_default_config(CENTRAL_LINK_COUNT,
@@ -928,7 +1121,41 @@ static void buttons_leds_init(bool * p_erase_bonds)
  */
 static void power_manage(void)
 {
+    APP_ENERGY_END(APP_ENERGY_CPU);
     uint32_t err_code = sd_app_evt_wait();
+    APP_ENERGY_BEGIN(APP_ENERGY_CPU);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for handling Radio Notification events.
+ *
+ * @details fstorage starts its flash operations in the radio idle windows that follow.
+ *
+ * @param[in]   radio_active   True before a radio event, false after it.
+ */
+static void radio_notification_evt_handler(bool radio_active)
+{
+    fs_radio_notification_evt_handler(radio_active);
+}
+
+
+/**@brief Function for starting Radio Notification and energy accounting.
+ *
+ * @details Radio activity is reported through Radio Notification, so radio time includes the
+ *          800 us notification distance before each radio event.
+ */
+static void energy_accounting_init(void)
+{
+    uint32_t err_code;
+
+#if APP_ENERGY_ENABLED
+    app_energy_init(NULL);
+#endif
+
+    err_code = ble_radio_notification_init(APP_IRQ_PRIORITY_LOW,
+                                           NRF_RADIO_NOTIFICATION_DISTANCE_800US,
+                                           radio_notification_evt_handler);
     APP_ERROR_CHECK(err_code);
 }
 
@@ -1038,6 +1265,7 @@ int main(void)
 
     // Initialize.
     app_trace_init();
+    app_profiler_init();
     timers_init();
 	
 		bool erase_bonds;
@@ -1049,10 +1277,13 @@ int main(void)
     advertising_init();
     services_init();
     sensor_simulator_init();
+    battery_adc_init();
     conn_params_init();
+    conn_params_policy_init();
 
     // Start execution.
     application_timers_start();
+    energy_accounting_init();
     err_code = ble_advertising_start(BLE_ADV_MODE_FAST);
     APP_ERROR_CHECK(err_code);
 		
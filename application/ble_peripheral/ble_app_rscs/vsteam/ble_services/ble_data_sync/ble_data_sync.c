@@ -14,6 +14,7 @@
 #include "ble_types.h"
 #include "ble_gatts.h"
 #include "ble_srv_common.h"
+#include "ble_gatt_table.h"
 #include <stddef.h>
 #include "sdk_common.h"
 #include "app_error.h"
@@ -35,6 +36,8 @@ enum
 
 static bool     m_is_data_sync_service_initialized = false;                           /**< Variable to check if the DFU service was initialized by the application.*/
 static uint8_t  m_notif_buffer[MAX_NOTIF_BUFFER_LEN];                           /**< Buffer used for sending notifications to peer. */
+static uint8_t  m_diag_buffer[BLE_DATA_SYNC_DIAG_MAX_LEN];                      /**< Buffer used for encoding the Diagnostics characteristic. */
+static uint16_t m_diag_len;                                                     /**< Length of the Diagnostics characteristic being read. */
 
 /**@brief     Function for handling the @ref BLE_GAP_EVT_CONNECTED event from the S110 SoftDevice.
  *
@@ -128,6 +131,72 @@ static void on_write(ble_data_sync_t * p_data, ble_evt_t * p_ble_evt)
 }
 
 
+/**@brief     Function for reporting the bytes left in the ongoing transfer, when they change.
+ *
+ * @param[in] p_data  Data sync Service structure.
+ * @param[in] bytes   Bytes still to be sent.
+ */
+static void pending_set(ble_data_sync_t * p_data, uint32_t bytes)
+{
+    if ((p_data->pending_handler != NULL) && (bytes != p_data->pending))
+    {
+        p_data->pending_handler(bytes);
+    }
+    p_data->pending = bytes;
+}
+
+
+/**@brief     Function for handling the @ref BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST event from the SoftDevice.
+ *
+ * @details   The Diagnostics characteristic is encoded when a read starts at offset 0. The rest
+ *            of a long read is served from the stored value, so all parts come from the same
+ *            snapshot. The peer reads ATT_MTU - 1 bytes per part, the bytes after the part being
+ *            read are reported as pending.
+ *
+ * @param[in] p_data     Data sync Service structure.
+ * @param[in] p_ble_evt Pointer to the event received from BLE stack.
+ */
+static void on_rw_authorize_request(ble_data_sync_t * p_data, ble_evt_t * p_ble_evt)
+{
+    ble_gatts_evt_rw_authorize_request_t * p_req = &p_ble_evt->evt.gatts_evt.params.authorize_request;
+    ble_gatts_rw_authorize_reply_params_t  reply;
+    uint16_t                               len   = sizeof(m_diag_buffer);
+    uint32_t                               part_end;
+    uint32_t                               err_code;
+
+    if ((p_req->type != BLE_GATTS_AUTHORIZE_TYPE_READ) ||
+        (p_req->request.read.handle != p_data->data_sync_diag_handles.value_handle))
+    {
+        return;
+    }
+
+    memset(&reply, 0, sizeof(reply));
+    reply.type                    = BLE_GATTS_AUTHORIZE_TYPE_READ;
+    reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
+
+    if (p_req->request.read.offset == 0)
+    {
+        if ((p_data->diag_encode == NULL) || (p_data->diag_encode(m_diag_buffer, &len) != NRF_SUCCESS))
+        {
+            len = 0;
+        }
+        reply.params.read.update = 1;
+        reply.params.read.len    = len;
+        reply.params.read.p_data = m_diag_buffer;
+        m_diag_len               = len;
+    }
+
+    part_end = p_req->request.read.offset + (GATT_MTU_SIZE_DEFAULT - 1);
+    pending_set(p_data, (part_end < m_diag_len) ? (m_diag_len - part_end) : 0);
+
+    err_code = sd_ble_gatts_rw_authorize_reply(p_ble_evt->evt.gatts_evt.conn_handle, &reply);
+    if ((err_code != NRF_SUCCESS) && (p_data->error_handler != NULL))
+    {
+        p_data->error_handler(err_code);
+    }
+}
+
+
 /**@brief     Function for handling the BLE_GAP_EVT_DISCONNECTED event from the S110 SoftDevice.
  *
  * @param[in] p_data     DFU Service Structure.
@@ -136,6 +205,7 @@ static void on_write(ble_data_sync_t * p_data, ble_evt_t * p_ble_evt)
 static void on_disconnect(ble_data_sync_t * p_data, ble_evt_t * p_ble_evt)
 {
     p_data->conn_handle = BLE_CONN_HANDLE_INVALID;
+    pending_set(p_data, 0);
 }
 
 
@@ -159,6 +229,10 @@ void ble_data_sync_on_ble_evt(ble_data_sync_t * p_data, ble_evt_t * p_ble_evt)
                 on_write(p_data, p_ble_evt);
                 break;
 
+            case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
+                on_rw_authorize_request(p_data, p_ble_evt);
+                break;
+
             case BLE_GAP_EVT_DISCONNECTED:
                 on_disconnect(p_data, p_ble_evt);
                 break;
@@ -171,163 +245,67 @@ void ble_data_sync_on_ble_evt(ble_data_sync_t * p_data, ble_evt_t * p_ble_evt)
 }
 
 
-/**@brief       Function for adding data layout Revision characteristic to the BLE Stack.
- *
- * @param[in]   p_data data sync Service structure.
- *
- * @return      NRF_SUCCESS on success. Otherwise an error code.
- */
-static uint32_t data_sync_rev_char_add(ble_data_sync_t * const p_data, ble_data_sync_init_t const * const p_data_sync_init)
+/**@brief Attribute table of the data sync Service. */
+static const ble_gatt_table_entry_t m_data_sync_table[] =
 {
-    // OUR_JOB: Step 2.A, Add a custom characteristic UUID
-		uint32_t            err_code;
-		ble_uuid_t          char_uuid;
-	
-	  char_uuid.type = p_data->uuid_type;
-		char_uuid.uuid = BLE_DATA_SYNC_REV_CHAR_UUID;
-		
-    
-    // OUR_JOB: Step 2.F Add read/write properties to our characteristic
-    ble_gatts_char_md_t char_md;
-    memset(&char_md, 0, sizeof(char_md));		
-		char_md.char_props.read = 1;
-		char_md.char_props.write = 0;
-    
-    // OUR_JOB: Step 3.A, Configuring Client Characteristic Configuration Descriptor metadata and add to char_md structure
-    ble_gatts_attr_md_t cccd_md;
-    memset(&cccd_md, 0, sizeof(cccd_md));
-    
-    // OUR_JOB: Step 2.B, Configure the attribute metadata
-    ble_gatts_attr_md_t attr_md;
-    memset(&attr_md, 0, sizeof(attr_md));  
-		attr_md.vloc        = BLE_GATTS_VLOC_STACK;
-    
-    // OUR_JOB: Step 2.G, Set read/write security levels to our characteristic
-    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.read_perm);
-		BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.write_perm);
-    
-    // OUR_JOB: Step 2.C, Configure the characteristic value attribute
-    ble_gatts_attr_t    attr_char_value;
-    memset(&attr_char_value, 0, sizeof(attr_char_value));
-		
-		attr_char_value.p_uuid      = &char_uuid;
-		attr_char_value.p_attr_md   = &attr_md;
-    
-    // OUR_JOB: Step 2.H, Set characteristic length in number of bytes
-		attr_char_value.max_len     = sizeof(uint16_t);
-		attr_char_value.init_len    = sizeof(uint16_t);
-		
-		attr_char_value.p_value     = (uint8_t *) &p_data_sync_init->revision;
-
-    // OUR_JOB: Step 2.E, Add our new characteristic to the service
-	  err_code = sd_ble_gatts_characteristic_add(p_data->service_handle,\
-                                   &char_md,\
-                                   &attr_char_value,\
-                                   &p_data->data_sync_rev_handles);
-		APP_ERROR_CHECK(err_code);
-		
-    return NRF_SUCCESS;
-}
+    BLE_GATT_TABLE_SERVICE(BLE_DATA_SYNC_SERVICE_UUID,
+                           BLE_GATT_TABLE_FLAG_VS_UUID,
+                           offsetof(ble_data_sync_t, service_handle)),
+
+    // Data layout Revision characteristic.
+    BLE_GATT_TABLE_CHAR_INIT_CONTEXT(BLE_DATA_SYNC_REV_CHAR_UUID,
+                                     BLE_GATT_TABLE_FLAG_VS_UUID,
+                                     BLE_GATT_TABLE_PROP_READ,
+                                     SEC_OPEN, SEC_NO_ACCESS, SEC_NO_ACCESS,
+                                     sizeof(uint16_t),
+                                     offsetof(ble_data_sync_t, revision),
+                                     sizeof(uint16_t),
+                                     offsetof(ble_data_sync_t, data_sync_rev_handles)),
+
+    // Data sync Control Point characteristic.
+    BLE_GATT_TABLE_CHAR(BLE_DATA_SYNC_CTRL_PT_UUID,
+                        BLE_GATT_TABLE_FLAG_VS_UUID,
+                        BLE_GATT_TABLE_PROP_WRITE | BLE_GATT_TABLE_PROP_NOTIFY,
+                        SEC_NO_ACCESS, SEC_OPEN, SEC_OPEN,
+                        BLE_L2CAP_MTU_DEF,
+                        offsetof(ble_data_sync_t, data_sync_ctrl_pt_handles)),
+
+    // Diagnostics characteristic, encoded on each read.
+    BLE_GATT_TABLE_CHAR(BLE_DATA_SYNC_DIAG_CHAR_UUID,
+                        BLE_GATT_TABLE_FLAG_VS_UUID | BLE_GATT_TABLE_FLAG_VAR_LEN | BLE_GATT_TABLE_FLAG_RD_AUTH,
+                        BLE_GATT_TABLE_PROP_READ,
+                        SEC_OPEN, SEC_NO_ACCESS, SEC_NO_ACCESS,
+                        BLE_DATA_SYNC_DIAG_MAX_LEN,
+                        offsetof(ble_data_sync_t, data_sync_diag_handles)),
+};
 
-/**@brief       Function for adding data layout Revision characteristic to the BLE Stack.
- *
- * @param[in]   p_data data sync Service structure.
- *
- * @return      NRF_SUCCESS on success. Otherwise an error code.
- */
-static uint32_t data_sync_ctrl_pt_add(ble_data_sync_t * const p_data)
-{
-    // OUR_JOB: Step 2.A, Add a custom characteristic UUID
-		uint32_t            err_code;
-		ble_uuid_t          char_uuid;
-	
-		char_uuid.type = p_data->uuid_type;
-		char_uuid.uuid = BLE_DATA_SYNC_CTRL_PT_UUID;
-
-    // OUR_JOB: Step 2.F Add read/write properties to our characteristic
-    ble_gatts_char_md_t char_md;
-    memset(&char_md, 0, sizeof(char_md));			;
-    
-	  char_md.char_props.write  = 1;
-    char_md.char_props.notify = 1;
-    char_md.p_char_user_desc  = NULL;
-    char_md.p_char_pf         = NULL;
-    char_md.p_user_desc_md    = NULL;
-    char_md.p_cccd_md         = NULL;
-    char_md.p_sccd_md         = NULL;
-	
-    // OUR_JOB: Step 3.A, Configuring Client Characteristic Configuration Descriptor metadata and add to char_md structure
-    ble_gatts_attr_md_t cccd_md;
-    memset(&cccd_md, 0, sizeof(cccd_md));
-		
-    
-    // OUR_JOB: Step 2.B, Configure the attribute metadata
-    ble_gatts_attr_md_t attr_md;
-    memset(&attr_md, 0, sizeof(attr_md));  
-		attr_md.vloc        = BLE_GATTS_VLOC_STACK;
-    
-    // OUR_JOB: Step 2.G, Set read/write security levels to our characteristic
-    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.read_perm);
-		BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.write_perm);
-    
-    // OUR_JOB: Step 2.C, Configure the characteristic value attribute
-    ble_gatts_attr_t    attr_char_value;
-    memset(&attr_char_value, 0, sizeof(attr_char_value));
-		
-		attr_char_value.p_uuid      = &char_uuid;
-		attr_char_value.p_attr_md   = &attr_md;
-    
-    // OUR_JOB: Step 2.H, Set characteristic length in number of bytes
-    attr_char_value.init_len  = 0;
-    attr_char_value.init_offs = 0;
-    attr_char_value.max_len   = BLE_L2CAP_MTU_DEF;
-    attr_char_value.p_value   = NULL;
-		
-		
-    // OUR_JOB: Step 2.E, Add our new characteristic to the service
-	  err_code = sd_ble_gatts_characteristic_add(p_data->service_handle,\
-                                   &char_md,\
-                                   &attr_char_value,\
-                                   &p_data->data_sync_ctrl_pt_handles);
-		APP_ERROR_CHECK(err_code);
-		
-    return NRF_SUCCESS;
-}
 
 uint32_t ble_data_sync_init(ble_data_sync_t * p_data, ble_data_sync_init_t * p_data_init)
 {
-    uint32_t   err_code; // Variable to hold return codes from library and softdevice functions
+    uint32_t      err_code;
+    uint8_t       uuid_type;
+    ble_uuid128_t base_uuid = VSTEAM_BLE_BASE_UUID;
 
-    // FROM_SERVICE_TUTORIAL: Declare 16-bit service and 128-bit base UUIDs and add them to the BLE stack
+    err_code = sd_ble_uuid_vs_add(&base_uuid, &uuid_type);
+    VERIFY_SUCCESS(err_code);
 
-    ble_uuid_t        service_uuid;
-    ble_uuid128_t     base_uuid = VSTEAM_BLE_BASE_UUID;
-    service_uuid.uuid = BLE_DATA_SYNC_SERVICE_UUID;
-    err_code = sd_ble_uuid_vs_add(&base_uuid, &service_uuid.type);
-    
-    
-    // OUR_JOB: Step 3.B, Set our service connection handle to default value. I.e. an invalid handle since we are not yet in a connection.
-		p_data->conn_handle = BLE_CONN_HANDLE_INVALID;
-	
-    // FROM_SERVICE_TUTORIAL: Add our service
-    err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY,
-                                        &service_uuid,
-                                        &p_data->service_handle);
-    
-    p_data->uuid_type = service_uuid.type;
-
-    // OUR_JOB: Call the function our_char_add() to add our new characteristic to the service. 
-		//revsion characteristic
-    err_code = data_sync_rev_char_add(p_data, p_data_init); 
-		
-		
-		//data sync control point
-		err_code = data_sync_ctrl_pt_add(p_data);
-    
-		
-		m_is_data_sync_service_initialized = true;
-		
-		return NRF_SUCCESS; 
+    p_data->conn_handle     = BLE_CONN_HANDLE_INVALID;
+    p_data->uuid_type       = uuid_type;
+    p_data->revision        = p_data_init->revision;
+    p_data->diag_encode     = p_data_init->diag_encode;
+    p_data->pending_handler = p_data_init->pending_handler;
+    p_data->pending         = 0;
+
+    err_code = ble_gatt_table_add(m_data_sync_table,
+                                  sizeof(m_data_sync_table) / sizeof(m_data_sync_table[0]),
+                                  uuid_type,
+                                  p_data,
+                                  sizeof(ble_data_sync_t));
+    VERIFY_SUCCESS(err_code);
+
+    m_is_data_sync_service_initialized = true;
+
+    return NRF_SUCCESS;
 }
 
 uint32_t ble_data_sync_response_send(ble_data_sync_t         * p_data,
@@ -15,6 +15,9 @@
 #define BLE_DATA_SYNC_CTRL_PT_UUID                 0x1572                       /**< The UUID of the data sync Control Point. */
 #define BLE_DATA_SYNC_STATUS_REP_UUID              0x1573                       /**< The UUID of the data sync Status Report Characteristic. */
 #define BLE_DATA_SYNC_REV_CHAR_UUID                0x1574                       /**< The UUID of the data sync Revision Characteristic. */
+#define BLE_DATA_SYNC_DIAG_CHAR_UUID               0x1575                       /**< The UUID of the data sync Diagnostics Characteristic. */
+
+#define BLE_DATA_SYNC_DIAG_MAX_LEN                 96                           /**< Maximum length (in bytes) of the Diagnostics Characteristic. */
 
 
 typedef enum
@@ -75,6 +78,25 @@ typedef struct
     } evt;
 } ble_data_sync_evt_t;
 
+/**@brief Function for encoding the value of the Diagnostics Characteristic.
+ *
+ * @param[out]    p_buf   Output buffer.
+ * @param[in,out] p_len   In: size of p_buf. Out: number of bytes written.
+ *
+ * @return NRF_SUCCESS, or an error code if nothing was written.
+ */
+typedef uint32_t (*ble_data_sync_diag_encode_t) (uint8_t * p_buf, uint16_t * p_len);
+
+/**@brief Function for reporting the bytes still to be sent in a transfer of the service.
+ *
+ * @details Called with a non-zero count when a long read of the Diagnostics Characteristic
+ *          starts, with the count left after each part, and with 0 when the transfer has ended.
+ *          Matches @ref ble_conn_params_policy_bulk_pending_set.
+ *
+ * @param[in] bytes  Bytes still to be sent, 0 when no transfer is ongoing.
+ */
+typedef void (*ble_data_sync_pending_handler_t) (uint32_t bytes);
+
 // Forward declaration of the ble_data_sync_t type.
 typedef struct ble_data_sync_s ble_data_sync_t;
 
@@ -92,6 +114,10 @@ struct ble_data_sync_s
     ble_gatts_char_handles_t     data_sync_ctrl_pt_handles;             /**< Handles related to the DFU Control Point characteristic. */
     ble_gatts_char_handles_t     data_sync_status_rep_handles;          /**< Handles related to the DFU Status Report characteristic. */
     ble_gatts_char_handles_t     data_sync_rev_handles;                 /**< Handles related to the DFU Revision characteristic. */
+    ble_gatts_char_handles_t     data_sync_diag_handles;                /**< Handles related to the Diagnostics characteristic. */
+    ble_data_sync_diag_encode_t  diag_encode;                           /**< Function encoding the Diagnostics characteristic on each read. */
+    ble_data_sync_pending_handler_t pending_handler;                    /**< Function told the bytes left in a transfer. */
+    uint32_t                     pending;                               /**< Bytes left in the ongoing transfer. */
     ble_data_sync_evt_handler_t  evt_handler;                           /**< The event handler to be called when an event is to be sent to the application.*/
     ble_srv_error_handler_t      error_handler;                         /**< Function to be called in case of an error. */
 };
@@ -100,6 +126,8 @@ struct ble_data_sync_s
 typedef struct
 {
     uint16_t                     revision;                              /**< Revision number to be exposed by the DFU service. */
+    ble_data_sync_diag_encode_t  diag_encode;                           /**< Function encoding the Diagnostics characteristic on each read. NULL if there is nothing to report. */
+    ble_data_sync_pending_handler_t pending_handler;                    /**< Function told the bytes left in a transfer, so that the connection parameters can follow. NULL if not needed. */
     ble_data_sync_evt_handler_t  evt_handler;                           /**< Event handler to be called for handling events in the Device Firmware Update Service. */
     ble_srv_error_handler_t      error_handler;                         /**< Function to be called in case of an error. */
 } ble_data_sync_init_t;
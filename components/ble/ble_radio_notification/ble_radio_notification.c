@@ -11,6 +11,8 @@
 
 #include "ble_radio_notification.h"
 #include <stdlib.h>
+#include "nrf_nvic.h"
+#include "app_energy_hook.h"
 
 
 static bool                                 m_radio_active = false;  /**< Current radio state. */
@@ -20,6 +22,15 @@ static ble_radio_notification_evt_handler_t m_evt_handler  = NULL;   /**< Applic
 void SWI1_IRQHandler(void)
 {
     m_radio_active = !m_radio_active;
+    if (m_radio_active)
+    {
+        APP_ENERGY_BEGIN(APP_ENERGY_RADIO);
+    }
+    else
+    {
+        APP_ENERGY_END(APP_ENERGY_RADIO);
+    }
+
     if (m_evt_handler != NULL)
     {
         m_evt_handler(m_radio_active);
@@ -28,7 +39,7 @@ void SWI1_IRQHandler(void)
 
 
 uint32_t ble_radio_notification_init(uint32_t                             irq_priority,
-                                     nrf_radio_notification_distance_t    distance,
+                                     uint8_t                              distance,
                                      ble_radio_notification_evt_handler_t evt_handler)
 {
     uint32_t err_code;
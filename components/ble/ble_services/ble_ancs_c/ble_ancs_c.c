@@ -14,6 +14,7 @@
  */
 
 #include "ble_ancs_c.h"
+#include <string.h>
 #include "ble_err.h"
 #include "ble_srv_common.h"
 #include "nrf_assert.h"
@@ -36,6 +37,8 @@
 #define TX_BUFFER_MASK                   0x07                     /**< TX buffer mask. Must be a mask of contiguous zeroes followed by a contiguous sequence of ones: 000...111. */
 #define TX_BUFFER_SIZE                   (TX_BUFFER_MASK + 1)     /**< Size of send buffer, which is 1 higher than the mask. */
 #define WRITE_MESSAGE_LENGTH             20                       /**< Length of the write message for CCCD/control point. */
+#define PREP_WRITE_LENGTH                (WRITE_MESSAGE_LENGTH - 2) /**< Length of the data in a Prepare Write Request, which also carries the offset. */
+#define APP_ATTR_REQ_MAX_LENGTH          (BLE_ANCS_ATTR_DATA_MAX + 3) /**< Command ID, app identifier, NUL terminator and attribute ID. */
 #define BLE_CCCD_NOTIFY_BIT_MASK         0x0001                   /**< Enable notification bit. */
 
 #define BLE_ANCS_MAX_DISCOVERED_CENTRALS DEVICE_MANAGER_MAX_BONDS /**< Maximum number of discovered services that can be stored in the flash. This number should be identical to maximum number of bonded peer devices. */
@@ -144,6 +147,17 @@ static void on_disconnected(ble_ancs_c_t * p_ancs, const ble_evt_t * p_ble_evt)
     if (p_ancs->conn_handle == p_ble_evt->evt.gap_evt.conn_handle)
     {
         p_ancs->conn_handle = BLE_CONN_HANDLE_INVALID;
+
+        // Responses to pending requests will not arrive.
+        for (uint32_t i = 0; i < BLE_ANCS_APP_ATTR_CACHE_SIZE; i++)
+        {
+            if (p_ancs->app_cache[i].state == BLE_ANCS_APP_CACHE_PENDING)
+            {
+                p_ancs->app_cache[i].state = BLE_ANCS_APP_CACHE_FREE;
+            }
+        }
+        p_ancs->parse_state        = COMMAND_ID_AND_NOTIF_UID;
+        p_ancs->current_attr_index = 0;
     }
 }
 
@@ -208,6 +222,60 @@ void ble_ancs_c_on_db_disc_evt(ble_ancs_c_t * p_ancs, ble_db_discovery_evt_t * p
 }
 
 
+/**@brief Function for getting the number of free entries in the transmit buffer.
+ */
+static uint32_t tx_buffer_free_get(void)
+{
+    // One entry is kept unused, so that a full buffer can be told apart from an empty one.
+    return TX_BUFFER_MASK - ((m_tx_insert_index - m_tx_index) & TX_BUFFER_MASK);
+}
+
+
+/**@brief Function for taking the next free entry in the transmit buffer.
+ *
+ * @return The entry, or NULL if the buffer is full.
+ */
+static tx_message_t * tx_buffer_alloc(void)
+{
+    tx_message_t * p_msg;
+
+    if (tx_buffer_free_get() == 0)
+    {
+        return NULL;
+    }
+
+    p_msg              = &m_tx_buffer[m_tx_insert_index++];
+    m_tx_insert_index &= TX_BUFFER_MASK;
+    memset(p_msg, 0, sizeof(tx_message_t));
+
+    return p_msg;
+}
+
+
+/**@brief Function for checking if a control point command is waiting in the transmit buffer.
+ *
+ * @param[in] p_value  Start of the command.
+ * @param[in] len      Number of bytes to compare.
+ */
+static bool tx_buffer_cp_cmd_queued(const uint8_t * p_value, uint16_t len)
+{
+    for (uint32_t i = m_tx_index; i != m_tx_insert_index; i = (i + 1) & TX_BUFFER_MASK)
+    {
+        const ble_gattc_write_params_t * p_params = &m_tx_buffer[i].req.write_req.gattc_params;
+
+        if (   (m_tx_buffer[i].type == WRITE_REQ)
+            && (p_params->write_op != BLE_GATT_OP_EXEC_WRITE_REQ)
+            && (p_params->offset == 0)
+            && (p_params->len >= len)
+            && (memcmp(m_tx_buffer[i].req.write_req.gattc_value, p_value, len) == 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
 /**@brief Function for passing any pending request from the buffer to the stack.
  */
 static void tx_buffer_process(void)
@@ -236,11 +304,134 @@ static void tx_buffer_process(void)
 }
 
 
+/**@brief Function for finding an app in the attribute cache.
+ *
+ * @param[in] p_ancs    Pointer to an ANCS instance.
+ * @param[in] p_app_id  NUL-terminated app identifier.
+ *
+ * @return The cache entry of the app, or NULL if the app is not in the cache.
+ */
+static ble_ancs_c_app_cache_entry_t * app_cache_find(ble_ancs_c_t * p_ancs, const uint8_t * p_app_id)
+{
+    for (uint32_t i = 0; i < BLE_ANCS_APP_ATTR_CACHE_SIZE; i++)
+    {
+        ble_ancs_c_app_cache_entry_t * p_entry = &p_ancs->app_cache[i];
+
+        if (   (p_entry->state != BLE_ANCS_APP_CACHE_FREE)
+            && (strcmp((const char *)p_entry->app_id, (const char *)p_app_id) == 0))
+        {
+            return p_entry;
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for getting the cache entry to replace, the least recently used one.
+ *
+ * @details Entries waiting for a response are never replaced.
+ *
+ * @return A free or valid entry, or NULL if all entries are pending.
+ */
+static ble_ancs_c_app_cache_entry_t * app_cache_victim_get(ble_ancs_c_t * p_ancs)
+{
+    ble_ancs_c_app_cache_entry_t * p_victim = NULL;
+
+    for (uint32_t i = 0; i < BLE_ANCS_APP_ATTR_CACHE_SIZE; i++)
+    {
+        ble_ancs_c_app_cache_entry_t * p_entry = &p_ancs->app_cache[i];
+
+        if (p_entry->state == BLE_ANCS_APP_CACHE_FREE)
+        {
+            return p_entry;
+        }
+        if (   (p_entry->state == BLE_ANCS_APP_CACHE_VALID)
+            && ((p_victim == NULL) || (p_entry->last_used < p_victim->last_used)))
+        {
+            p_victim = p_entry;
+        }
+    }
+    return p_victim;
+}
+
+
+/**@brief Function for giving a cached app attribute to the application.
+ */
+static void app_cache_evt_send(ble_ancs_c_t * p_ancs, ble_ancs_c_app_cache_entry_t * p_entry)
+{
+    ble_ancs_c_evt_t evt;
+
+    p_entry->last_used = ++p_ancs->app_cache_clock;
+
+    evt.evt_type             = BLE_ANCS_C_EVT_APP_ATTRIBUTE;
+    evt.conn_handle          = p_ancs->conn_handle;
+    evt.app_attr.p_app_id    = p_entry->app_id;
+    evt.app_attr.attr_id     = BLE_ANCS_APP_ATTR_ID_DISPLAY_NAME;
+    evt.app_attr.attr_len    = p_entry->display_name_len;
+    evt.app_attr.p_attr_data = p_entry->display_name;
+    p_ancs->evt_handler(&evt);
+}
+
+
+/**@brief Function for finishing an attribute of a Data Source response.
+ *        Used in the @ref parse_get_notif_attrs_response state machine.
+ *
+ * @details NUL-terminates the attribute data and passes it to the application, if the attribute
+ *          was requested. When the last expected attribute is done, the parser is ready for the
+ *          next response.
+ *
+ * @param[in] p_ancs     Pointer to an ANCS instance to which the event belongs.
+ *
+ * @return The next parse state.
+ */
+static ble_ancs_c_parse_state_t attr_done(ble_ancs_c_t * p_ancs)
+{
+    if (p_ancs->p_data_dest != NULL)
+    {
+        p_ancs->p_data_dest[MIN(p_ancs->evt.attr.attr_len, p_ancs->data_dest_len)] = '\0';
+
+        if (p_ancs->command_id == BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES)
+        {
+            ANCS_LOG("[ANCS]: Attribute finished!\n\r");
+            p_ancs->evt.evt_type = BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE;
+            p_ancs->evt_handler(&p_ancs->evt);
+        }
+        else
+        {
+            p_ancs->p_app_entry->state            = BLE_ANCS_APP_CACHE_VALID;
+            p_ancs->p_app_entry->display_name_len = p_ancs->evt.attr.attr_len;
+            app_cache_evt_send(p_ancs, p_ancs->p_app_entry);
+        }
+    }
+
+    if (p_ancs->expected_number_of_attrs > 0)
+    {
+        p_ancs->expected_number_of_attrs--;
+    }
+    if (p_ancs->expected_number_of_attrs == 0)
+    {
+        ANCS_LOG("[ANCS]: All requested attributes received\n\r");
+        if (   (p_ancs->command_id == BLE_ANCS_COMMAND_ID_GET_APP_ATTRIBUTES)
+            && (p_ancs->p_app_entry != NULL)
+            && (p_ancs->p_app_entry->state == BLE_ANCS_APP_CACHE_PENDING))
+        {
+            // The response did not carry the display name, allow a new request.
+            p_ancs->p_app_entry->state = BLE_ANCS_APP_CACHE_FREE;
+        }
+        p_ancs->current_attr_index = 0;
+        return COMMAND_ID_AND_NOTIF_UID;
+    }
+    return ATTR_ID;
+}
+
+
 /**@brief Function for parsing command id and notification id.
  *        Used in the @ref parse_get_notif_attrs_response state machine.
  *
  * @details UID and command ID will be received only once at the beginning of the first 
  *          GATTC notification of a new attribute request for a given iOS notification.
+ *          They can be split over two GATTC notifications, so current_attr_index counts the
+ *          bytes parsed so far.
  *
  * @param[in] p_ancs     Pointer to an ANCS instance to which the event belongs.
  * @param[in] p_data_src Pointer to data that was received from the Notification Provider.
@@ -252,27 +443,92 @@ static ble_ancs_c_parse_state_t command_id_and_notif_parse(ble_ancs_c_t * p_ancs
                                                            const uint8_t * p_data_src,
                                                            uint32_t * index)
 {
-    ble_ancs_c_command_id_values_t command_id;
+    uint8_t byte = p_data_src[(*index)++];
 
-    command_id = (ble_ancs_c_command_id_values_t) p_data_src[(*index)++];
-    
-    if(command_id != BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES)
+    if (p_ancs->current_attr_index == 0)
     {
-        ANCS_LOG("[ANCS]: Invalid Command ID");
-        return DONE;
+        p_ancs->command_id = (ble_ancs_c_command_id_values_t)byte;
+
+        switch (p_ancs->command_id)
+        {
+            case BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES:
+                p_ancs->evt.attr.notif_uid       = 0;
+                p_ancs->expected_number_of_attrs = p_ancs->number_of_requested_attr;
+                break;
+
+            case BLE_ANCS_COMMAND_ID_GET_APP_ATTRIBUTES:
+                p_ancs->expected_number_of_attrs = 1;
+                return APP_ID;
+
+            default:
+                ANCS_LOG("[ANCS]: Invalid Command ID");
+                return DONE;
+        }
+    }
+    else
+    {
+        p_ancs->evt.attr.notif_uid |= (uint32_t)byte << (8 * (p_ancs->current_attr_index - 1));
     }
 
-     p_ancs->evt.attr.notif_uid  = uint32_decode(&p_data_src[*index]);
-     *index                     += sizeof(uint32_t);
-     return ATTR_ID;
+    if (++p_ancs->current_attr_index <= sizeof(uint32_t))
+    {
+        return COMMAND_ID_AND_NOTIF_UID;
+    }
+    if (p_ancs->expected_number_of_attrs == 0)
+    {
+        p_ancs->current_attr_index = 0;
+        return COMMAND_ID_AND_NOTIF_UID;
+    }
+    return ATTR_ID;
+}
 
+/**@brief Function for parsing the app identifier of a Get App Attributes response.
+ *        Used in the @ref parse_get_notif_attrs_response state machine.
+ *
+ * @details The identifier is NUL-terminated and can be split over several GATTC notifications.
+ *          All bytes up to the terminator that are in this notification are copied at once.
+ *
+ * @param[in] p_ancs       Pointer to an ANCS instance to which the event belongs.
+ * @param[in] p_data_src   Pointer to data that was received from the Notification Provider.
+ * @param[in] index        Pointer to an index that helps us keep track of the current data to be parsed.
+ * @param[in] hvx_data_len Length of the data that was received from the Notification Provider.
+ *
+ * @return The next parse state.
+ */
+static ble_ancs_c_parse_state_t app_id_parse(ble_ancs_c_t  * p_ancs,
+                                             const uint8_t * p_data_src,
+                                             uint32_t      * index,
+                                             const uint16_t  hvx_data_len)
+{
+    const uint8_t * p_start = &p_data_src[*index];
+    const uint8_t * p_nul   = memchr(p_start, '\0', hvx_data_len - *index);
+    uint32_t        len     = (p_nul != NULL) ? (uint32_t)(p_nul - p_start) : (hvx_data_len - *index);
+    uint32_t        room    = BLE_ANCS_ATTR_DATA_MAX - MIN(p_ancs->current_attr_index, BLE_ANCS_ATTR_DATA_MAX);
+
+    memcpy(&p_ancs->app_id[p_ancs->current_attr_index], p_start, MIN(len, room));
+    p_ancs->current_attr_index = MIN(p_ancs->current_attr_index + len, BLE_ANCS_ATTR_DATA_MAX + 1);
+    *index                    += len;
+
+    if (p_nul == NULL)
+    {
+        return APP_ID;
+    }
+    (*index)++;
+
+    p_ancs->p_app_entry = NULL;
+    if (p_ancs->current_attr_index <= BLE_ANCS_ATTR_DATA_MAX)
+    {
+        p_ancs->app_id[p_ancs->current_attr_index] = '\0';
+        p_ancs->p_app_entry = app_cache_find(p_ancs, p_ancs->app_id);
+    }
+    return ATTR_ID;
 }
 
 /**@brief Function for parsing the id of an iOS attribute.
  *        Used in the @ref parse_get_notif_attrs_response state machine.
  *
- * @details We only request attributes that are registered with @ref ble_ancs_c_attr_add
- *          once they have been reveiced we stop parsing.
+ * @details Only attributes that are registered with @ref ble_ancs_c_attr_add are stored.
+ *          Others are parsed and skipped, so the parser stays in step with the data.
  *
  * @param[in] p_ancs     Pointer to an ANCS instance to which the event belongs.
  * @param[in] p_data_src Pointer to data that was received from the Notification Provider.
@@ -284,25 +540,28 @@ static ble_ancs_c_parse_state_t attr_id_parse(ble_ancs_c_t * p_ancs,
                                               const uint8_t * p_data_src,
                                               uint32_t * index)
 {
-    p_ancs->evt.attr.attr_id     = (ble_ancs_c_notif_attr_id_values_t) p_data_src[(*index)++];
-    p_ancs->evt.attr.p_attr_data = p_ancs->ancs_attr_list[p_ancs->evt.attr.attr_id].p_attr_data;
+    uint8_t attr_id = p_data_src[(*index)++];
 
-    if (p_ancs->expected_number_of_attrs == 0)
-    {
-        ANCS_LOG("[ANCS]: All requested attributes received\n\r");
-       // (*index)++;
-        return DONE;
-    }
-    else if (p_ancs->ancs_attr_list[p_ancs->evt.attr.attr_id].get == true)
+    p_ancs->p_data_dest   = NULL;
+    p_ancs->data_dest_len = 0;
+
+    if (p_ancs->command_id == BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES)
     {
-        ANCS_LOG("[ANCS]: Attribute ID %i \n\r", p_ancs->evt.attr.attr_id);
-        return ATTR_LEN1;
+        if ((attr_id < BLE_ANCS_NB_OF_ATTRS) && p_ancs->ancs_attr_list[attr_id].get)
+        {
+            ANCS_LOG("[ANCS]: Attribute ID %i \n\r", attr_id);
+            p_ancs->evt.attr.attr_id     = (ble_ancs_c_notif_attr_id_values_t)attr_id;
+            p_ancs->evt.attr.p_attr_data = p_ancs->ancs_attr_list[attr_id].p_attr_data;
+            p_ancs->p_data_dest          = p_ancs->ancs_attr_list[attr_id].p_attr_data;
+            p_ancs->data_dest_len        = p_ancs->ancs_attr_list[attr_id].attr_len;
+        }
     }
-    else
+    else if ((attr_id == BLE_ANCS_APP_ATTR_ID_DISPLAY_NAME) && (p_ancs->p_app_entry != NULL))
     {
-        p_ancs->expected_number_of_attrs--;
-        return ATTR_ID;
+        p_ancs->p_data_dest   = p_ancs->p_app_entry->display_name;
+        p_ancs->data_dest_len = BLE_ANCS_ATTR_DATA_MAX;
     }
+    return ATTR_LEN1;
 }
 
 
@@ -349,50 +608,44 @@ static ble_ancs_c_parse_state_t attr_len2_parse(ble_ancs_c_t * p_ancs, const uin
     else
     {
         ANCS_LOG("[ANCS]: Attribute LEN %i \n\r", p_ancs->evt.attr.attr_len);
-        p_ancs->evt.evt_type = BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE;
-        p_ancs->evt_handler(&p_ancs->evt);
-        return ATTR_ID;
+        return attr_done(p_ancs);
     }
 }
 
 /**@brief Function for parsing the data of an iOS attribute.
  *        Used in the @ref parse_get_notif_attrs_response state machine.
  *
- * @details Read the data of the attribute into our local buffer.
+ * @details Takes all the data of the attribute that is in this GATTC notification at once. The
+ *          part that fits is copied into the attribute buffer, the rest is skipped.
  *
- * @param[in] p_ancs     Pointer to an ANCS instance to which the event belongs.
- * @param[in] p_data_src Pointer to data that was received from the Notification Provider.
- * @param[in] index      Pointer to an index that helps us keep track of the current data to be parsed.
+ * @param[in] p_ancs       Pointer to an ANCS instance to which the event belongs.
+ * @param[in] p_data_src   Pointer to data that was received from the Notification Provider.
+ * @param[in] index        Pointer to an index that helps us keep track of the current data to be parsed.
+ * @param[in] hvx_data_len Length of the data that was received from the Notification Provider.
  *
  * @return The next parse state.
  */
-static ble_ancs_c_parse_state_t attr_data_parse(ble_ancs_c_t * p_ancs, const uint8_t * p_data_src, uint32_t * index)
+static ble_ancs_c_parse_state_t attr_data_parse(ble_ancs_c_t  * p_ancs,
+                                                const uint8_t * p_data_src,
+                                                uint32_t      * index,
+                                                const uint16_t  hvx_data_len)
 {
-    // We have not reached the end of the attribute, nor our max allocated internal size.
-    // Proceed with copying data over to our buffer.
-    if (   (p_ancs->current_attr_index < p_ancs->ancs_attr_list[p_ancs->evt.attr.attr_id].attr_len)
-        && (p_ancs->current_attr_index < p_ancs->evt.attr.attr_len))
+    uint32_t len = MIN((uint32_t)(p_ancs->evt.attr.attr_len - p_ancs->current_attr_index),
+                       hvx_data_len - *index);
+
+    if (p_ancs->current_attr_index < p_ancs->data_dest_len)
     {
-        p_ancs->evt.attr.p_attr_data[p_ancs->current_attr_index++] = p_data_src[(*index)++];
+        memcpy(&p_ancs->p_data_dest[p_ancs->current_attr_index],
+               &p_data_src[*index],
+               MIN(len, (uint32_t)(p_ancs->data_dest_len - p_ancs->current_attr_index)));
     }
 
-    // We have reached the end of the attribute, or our max allocated internal size.
-    // Stop copying data over to our buffer. NUL-terminate at the current index.
-    if ( (p_ancs->current_attr_index == p_ancs->evt.attr.attr_len) ||
-         (p_ancs->current_attr_index == p_ancs->ancs_attr_list[p_ancs->evt.attr.attr_id].attr_len))
+    p_ancs->current_attr_index += len;
+    *index                     += len;
+
+    if (p_ancs->current_attr_index == p_ancs->evt.attr.attr_len)
     {
-        p_ancs->evt.attr.p_attr_data[p_ancs->current_attr_index] = '\0';
-        
-        // If our max buffer size is smaller than the remaining attribute data, we must
-        // increase index to skip the data until the start of the next attribute.
-        if (p_ancs->current_attr_index < p_ancs->evt.attr.attr_len)
-        {
-            (*index) += (p_ancs->evt.attr.attr_len - p_ancs->current_attr_index);
-        }
-        ANCS_LOG("[ANCS]: Attribute finished!\n\r");
-        p_ancs->evt.evt_type = BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE;
-        p_ancs->evt_handler(&p_ancs->evt);
-        return ATTR_ID;
+        return attr_done(p_ancs);
     }
     return ATTR_DATA;
 }
@@ -405,14 +658,17 @@ static ble_ancs_c_parse_state_t attr_data_parse(ble_ancs_c_t * p_ancs, const uin
  *          UID and command ID will be received only once at the beginning of the first
  *          GATTC notification of a new attribute request for a given iOS notification.
  *          After this, we can loop several ATTR_ID > LENGTH > DATA > ATTR_ID > LENGTH > DATA until
- *          we have received all attributes we wanted as a Notification Consumer.
- *          The Notification Provider can also simply stop sending attributes.
+ *          we have received all attributes we wanted as a Notification Consumer. The parser is
+ *          then ready for the next response.
  *
  *    |1 Byte  |  4 Bytes    |1 Byte |2 Bytes | X Bytes            |1 Bytes| 2 Bytes| X Bytes   
  *    +--------+-------------+-------+--------+- - - - - - - - - - +-------+--------+- - - - - - -
  *    | CMD_ID |  NOTIF_UID  |ATTR_ID| LENGTH |        DATA        |ATTR_ID| LENGTH |    DATA
  *    +--------+-------------+-------+--------+- - - - - - - - - - +-------+--------+- - - - - - -
  *
+ *          Responses to Get App Attributes have a NUL-terminated app identifier instead of the
+ *          notification UID.
+ *
  * @param[in] p_ancs     Pointer to an ANCS instance to which the event belongs.
  * @param[in] p_data_src Pointer to data that was received from the Notification Provider.
  * @param[in] hvx_len    Length of the data that was received from the Notification Provider.
@@ -431,6 +687,10 @@ static void parse_get_notif_attrs_response(ble_ancs_c_t  * p_ancs,
                 p_ancs->parse_state = command_id_and_notif_parse(p_ancs, p_data_src, &index);
                 break;
 
+            case APP_ID:
+                p_ancs->parse_state = app_id_parse(p_ancs, p_data_src, &index, hvx_data_len);
+                break;
+
             case ATTR_ID:
                 p_ancs->parse_state = attr_id_parse(p_ancs, p_data_src, &index);
                 break;
@@ -444,7 +704,7 @@ static void parse_get_notif_attrs_response(ble_ancs_c_t  * p_ancs,
                 break;
 
             case ATTR_DATA:
-                p_ancs->parse_state = attr_data_parse(p_ancs, p_data_src, &index);
+                p_ancs->parse_state = attr_data_parse(p_ancs, p_data_src, &index, hvx_data_len);
                 break;
 
             case DONE:
@@ -494,6 +754,7 @@ static void parse_notif(const ble_ancs_c_t * p_ancs,
     {
         ancs_evt.evt_type = BLE_ANCS_C_EVT_INVALID_NOTIF;
         p_ancs->evt_handler(&ancs_evt);
+        return;
     }
 
     /*lint --e{415} --e{416} -save suppress Warning 415: possible access out of bond */
@@ -615,6 +876,9 @@ uint32_t ble_ancs_c_init(ble_ancs_c_t * p_ancs, const ble_ancs_c_init_t * p_ancs
     p_ancs->parse_state = COMMAND_ID_AND_NOTIF_UID;
     p_ancs->p_data_dest = NULL;
     p_ancs->current_attr_index = 0;
+    p_ancs->p_app_entry     = NULL;
+    p_ancs->app_cache_clock = 0;
+    memset(p_ancs->app_cache, 0, sizeof(p_ancs->app_cache));
 
     p_ancs->evt_handler    = p_ancs_init->evt_handler;
     p_ancs->error_handler  = p_ancs_init->error_handler;
@@ -625,7 +889,9 @@ uint32_t ble_ancs_c_init(ble_ancs_c_t * p_ancs, const ble_ancs_c_init_t * p_ancs
 
     // Make sure instance of service is clear. GATT handles inside the service and characteristics are set to @ref BLE_GATT_HANDLE_INVALID.
     memset(&p_ancs->service, 0, sizeof(ble_ancs_c_service_t));
-    memset(m_tx_buffer, 0, TX_BUFFER_SIZE);
+    memset(m_tx_buffer, 0, sizeof(m_tx_buffer));
+    m_tx_index        = 0;
+    m_tx_insert_index = 0;
 
     // Assign UUID types.
     err_code = sd_ble_uuid_vs_add(&ble_ancs_base_uuid128, &p_ancs->service.service.uuid.type);
@@ -655,15 +921,18 @@ uint32_t ble_ancs_c_init(ble_ancs_c_t * p_ancs, const ble_ancs_c_init_t * p_ancs
  * @param[in] enable       Enable or disable GATTC notifications.
  *
  * @retval NRF_SUCCESS              If the message was created successfully.
- * @retval NRF_ERROR_INVALID_PARAM  If one of the input parameters was invalid.
+ * @retval NRF_ERROR_NO_MEM         If the transmit buffer is full.
  */
 static uint32_t cccd_configure(const uint16_t conn_handle, const uint16_t handle_cccd, bool enable)
 {
     tx_message_t * p_msg;
     uint16_t       cccd_val = enable ? BLE_CCCD_NOTIFY_BIT_MASK : 0;
 
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
+    p_msg = tx_buffer_alloc();
+    if (p_msg == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
 
     p_msg->req.write_req.gattc_params.handle   = handle_cccd;
     p_msg->req.write_req.gattc_params.len      = 2;
@@ -712,11 +981,24 @@ uint32_t ble_ancs_get_notif_attrs(ble_ancs_c_t       * p_ancs,
                                   const uint32_t       p_uid)
 {
     tx_message_t * p_msg;
+    uint8_t        cmd[1 + sizeof(uint32_t)];
 
     uint32_t index                   = 0;
+
+    // Skip the request if the same notification is already waiting to be requested.
+    cmd[0] = BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES;
+    (void)uint32_encode(p_uid, &cmd[1]);
+    if (tx_buffer_cp_cmd_queued(cmd, sizeof(cmd)))
+    {
+        return NRF_SUCCESS;
+    }
+
+    p_msg = tx_buffer_alloc();
+    if (p_msg == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
     p_ancs->number_of_requested_attr = 0;
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
 
     p_msg->req.write_req.gattc_params.handle   = p_ancs->service.control_point_char.handle_value;
     p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
@@ -749,7 +1031,6 @@ uint32_t ble_ancs_get_notif_attrs(ble_ancs_c_t       * p_ancs,
     p_msg->req.write_req.gattc_params.len = index;
     p_msg->conn_handle                    = p_ancs->conn_handle;
     p_msg->type                           = WRITE_REQ;
-    p_ancs->expected_number_of_attrs      = p_ancs->number_of_requested_attr;
 
     tx_buffer_process();
 
@@ -784,10 +1065,125 @@ uint32_t ble_ancs_c_request_attrs(ble_ancs_c_t * p_ancs,
     err_code = ble_ancs_verify_notification_format(p_notif);
     VERIFY_SUCCESS(err_code);
 
-    err_code            = ble_ancs_get_notif_attrs(p_ancs, p_notif->notif_uid);
-    p_ancs->parse_state = COMMAND_ID_AND_NOTIF_UID;
+    err_code = ble_ancs_get_notif_attrs(p_ancs, p_notif->notif_uid);
     VERIFY_SUCCESS(err_code);
 
+    // The parser is ready for a new response after every complete one. Only recover from a
+    // response that could not be parsed.
+    if (p_ancs->parse_state == DONE)
+    {
+        p_ancs->parse_state        = COMMAND_ID_AND_NOTIF_UID;
+        p_ancs->current_attr_index = 0;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for queuing a control point command that may be longer than one write.
+ *
+ * @details Commands that do not fit in one Write Request are sent as Prepare Write Requests
+ *          followed by an Execute Write Request.
+ *
+ * @retval NRF_SUCCESS      If the command was queued.
+ * @retval NRF_ERROR_NO_MEM If the transmit buffer does not have room for the whole command.
+ */
+static uint32_t cp_long_write_queue(const ble_ancs_c_t * p_ancs, const uint8_t * p_value, uint16_t len)
+{
+    uint32_t num_msgs = (len <= WRITE_MESSAGE_LENGTH) ? 1 : (CEIL_DIV(len, PREP_WRITE_LENGTH) + 1);
+
+    if (tx_buffer_free_get() < num_msgs)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    for (uint16_t offset = 0; offset < len; )
+    {
+        tx_message_t * p_msg   = tx_buffer_alloc();
+        uint16_t       msg_len = (num_msgs == 1) ? len : MIN(PREP_WRITE_LENGTH, len - offset);
+
+        memcpy(p_msg->req.write_req.gattc_value, &p_value[offset], msg_len);
+        p_msg->req.write_req.gattc_params.handle   = p_ancs->service.control_point_char.handle_value;
+        p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
+        p_msg->req.write_req.gattc_params.offset   = offset;
+        p_msg->req.write_req.gattc_params.len      = msg_len;
+        p_msg->req.write_req.gattc_params.write_op = (num_msgs == 1) ? BLE_GATT_OP_WRITE_REQ :
+                                                                       BLE_GATT_OP_PREP_WRITE_REQ;
+        p_msg->conn_handle                         = p_ancs->conn_handle;
+        p_msg->type                                = WRITE_REQ;
+        offset                                    += msg_len;
+    }
+
+    if (num_msgs > 1)
+    {
+        tx_message_t * p_msg = tx_buffer_alloc();
+
+        p_msg->req.write_req.gattc_params.handle   = p_ancs->service.control_point_char.handle_value;
+        p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_EXEC_WRITE_REQ;
+        p_msg->req.write_req.gattc_params.flags    = BLE_GATT_EXEC_WRITE_FLAG_PREPARED_WRITE;
+        p_msg->conn_handle                         = p_ancs->conn_handle;
+        p_msg->type                                = WRITE_REQ;
+    }
+
+    tx_buffer_process();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_ancs_c_app_attr_request(ble_ancs_c_t  * p_ancs,
+                                     const uint8_t * p_app_id,
+                                     const uint16_t  len)
+{
+    ble_ancs_c_app_cache_entry_t * p_entry;
+    uint8_t                        cmd[APP_ATTR_REQ_MAX_LENGTH];
+    uint32_t                       err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_ancs);
+    VERIFY_PARAM_NOT_NULL(p_app_id);
+
+    if ((len == 0) || (len > BLE_ANCS_ATTR_DATA_MAX) || (memchr(p_app_id, '\0', len) != NULL))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    cmd[0] = BLE_ANCS_COMMAND_ID_GET_APP_ATTRIBUTES;
+    memcpy(&cmd[1], p_app_id, len);
+    cmd[len + 1] = '\0';
+    cmd[len + 2] = BLE_ANCS_APP_ATTR_ID_DISPLAY_NAME;
+
+    p_entry = app_cache_find(p_ancs, &cmd[1]);
+    if (p_entry != NULL)
+    {
+        if (p_entry->state == BLE_ANCS_APP_CACHE_VALID)
+        {
+            app_cache_evt_send(p_ancs, p_entry);
+        }
+        // Otherwise a request is in progress and the event will follow the response.
+        return NRF_SUCCESS;
+    }
+
+    p_entry = app_cache_victim_get(p_ancs);
+    if (p_entry == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    err_code = cp_long_write_queue(p_ancs, cmd, len + 3);
+    VERIFY_SUCCESS(err_code);
+
+    memcpy(p_entry->app_id, &cmd[1], len + 1);
+    p_entry->display_name[0]  = '\0';
+    p_entry->display_name_len = 0;
+    p_entry->state            = BLE_ANCS_APP_CACHE_PENDING;
+    p_entry->last_used        = ++p_ancs->app_cache_clock;
+
+    if (p_ancs->parse_state == DONE)
+    {
+        p_ancs->parse_state        = COMMAND_ID_AND_NOTIF_UID;
+        p_ancs->current_attr_index = 0;
+    }
+
     return NRF_SUCCESS;
 }
 
@@ -90,6 +90,10 @@
 #define BLE_ANCS_NB_OF_ATTRS                8   /**< Number of iOS notification attributes: AppIdentifier, Title, Subtitle, Message, MessageSize, Date, PositiveActionLabel, NegativeActionLabel. */
 #define BLE_ANCS_NB_OF_EVT_ID               3   /**< Number of iOS notification events: Added, Modified, Removed.*/
 
+#ifndef BLE_ANCS_APP_ATTR_CACHE_SIZE
+#define BLE_ANCS_APP_ATTR_CACHE_SIZE        4   /**< Number of iOS apps whose attributes are kept by @ref ble_ancs_c_app_attr_request. */
+#endif
+
 /** @brief Length of the iOS notification data.
  *
  * @details 8 bytes:
@@ -118,7 +122,8 @@ typedef enum
     BLE_ANCS_C_EVT_DISCOVERY_FAILED,           /**< It was not possible to discover the service or characteristics of the connected peer. */
     BLE_ANCS_C_EVT_NOTIF,                      /**< An iOS notification was received on the notification source control point. */
     BLE_ANCS_C_EVT_INVALID_NOTIF,              /**< An iOS notification was received on the notification source control point, but the format is invalid. */
-    BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE             /**< A received iOS notification attribute has been parsed. */
+    BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE,            /**< A received iOS notification attribute has been parsed. */
+    BLE_ANCS_C_EVT_APP_ATTRIBUTE               /**< An iOS app attribute has been parsed, or found in the cache. */
 } ble_ancs_c_evt_type_t;
 
 /**@brief Category IDs for iOS notifications. */
@@ -167,6 +172,12 @@ typedef enum
     BLE_ANCS_NOTIF_ATTR_ID_NEGATIVE_ACTION_LABEL,  /**< The notification has a "Negative action" that can be executed associated with it. */
 } ble_ancs_c_notif_attr_id_values_t;
 
+/**@brief IDs for iOS app attributes. */
+typedef enum
+{
+    BLE_ANCS_APP_ATTR_ID_DISPLAY_NAME,             /**< Identifies that the attribute data is the "Display Name" of the app. */
+} ble_ancs_c_app_attr_id_values_t;
+
 
 /**@brief Flags for iOS notifications. */
 typedef struct
@@ -188,6 +199,7 @@ typedef enum
     ATTR_LEN1,                 /**< Parsing the LSB of the attribute length. */
     ATTR_LEN2,                 /**< Parsing the MSB of the attribute length. */
     ATTR_DATA,                 /**< Parsing the attribute data. */
+    APP_ID,                    /**< Parsing the NUL-terminated app identifier of a Get App Attributes response. */
     DONE                       /**< Parsing is done. */
 } ble_ancs_c_parse_state_t;
 
@@ -212,6 +224,33 @@ typedef struct
     uint8_t                         * p_attr_data;  /**< Pointer to where the memory is allocated for storing incoming attributes. */
 } ble_ancs_c_evt_notif_attr_t;
 
+/**@brief iOS app attribute structure. */
+typedef struct
+{
+    uint8_t                         * p_app_id;     /**< NUL-terminated identifier of the app that the attribute belongs to. */
+    uint16_t                          attr_len;     /**< Length of the attribute data. */
+    ble_ancs_c_app_attr_id_values_t   attr_id;      /**< Attribute ID. */
+    uint8_t                         * p_attr_data;  /**< NUL-terminated attribute data. */
+} ble_ancs_c_evt_app_attr_t;
+
+/**@brief States of an app attribute cache entry. */
+typedef enum
+{
+    BLE_ANCS_APP_CACHE_FREE,     /**< The entry is not in use. */
+    BLE_ANCS_APP_CACHE_PENDING,  /**< The attributes of the app have been requested. */
+    BLE_ANCS_APP_CACHE_VALID     /**< The attributes of the app are cached. */
+} ble_ancs_c_app_cache_state_t;
+
+/**@brief Cached attributes of an iOS app. */
+typedef struct
+{
+    ble_ancs_c_app_cache_state_t state;                                /**< State of the entry. */
+    uint32_t                     last_used;                            /**< Value of the cache clock when the entry was last used. */
+    uint8_t                      app_id[BLE_ANCS_ATTR_DATA_MAX + 1];   /**< NUL-terminated app identifier. */
+    uint16_t                     display_name_len;                     /**< Length of the display name sent by the peer. */
+    uint8_t                      display_name[BLE_ANCS_ATTR_DATA_MAX + 1]; /**< NUL-terminated display name, truncated to @ref BLE_ANCS_ATTR_DATA_MAX. */
+} ble_ancs_c_app_cache_entry_t;
+
 
 /**@brief iOS notification attribute content wanted by our application. */
 typedef struct
@@ -247,6 +286,7 @@ typedef struct
     uint16_t                    conn_handle;      /**< Connection handle on which the ANCS service was discovered on the peer device. This will be filled if the evt_type is @ref BLE_ANCS_C_EVT_DISCOVERY_COMPLETE.*/
     ble_ancs_c_evt_notif_t      notif;            /**< iOS notification. Will be filled if evt_type is @ref BLE_ANCS_C_EVT_NOTIF. */
     ble_ancs_c_evt_notif_attr_t attr;             /**< Currently received attribute for a given notification. Will be filled if the evt_type is @ref BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE. */
+    ble_ancs_c_evt_app_attr_t   app_attr;         /**< App attribute. Will be filled if the evt_type is @ref BLE_ANCS_C_EVT_APP_ATTRIBUTE. */
     ble_ancs_c_service_t        service;          /**< Info on the discovered Alert Notification Service discovered. This will be filled if the evt_type is @ref BLE_ANCS_C_EVT_DISCOVERY_COMPLETE.*/
     uint32_t                    error_code;       /**< Additional status or error code if the event was caused by a stack error or GATT status, for example, during service discovery. */
 } ble_ancs_c_evt_t;
@@ -270,6 +310,12 @@ typedef struct
     uint8_t                * p_data_dest;                             /**< Attribute that the parsed data will be copied into. */
     uint16_t                 current_attr_index;                      /**< Variable to keep track of how much (for a given attribute) we are done parsing. */
     ble_ancs_c_evt_t         evt;                                     /**< The event is filled with several iteration of the parse_get_notif_attrs_response function when requesting iOS notification attributes. So we must allocate memory for it here.*/
+    ble_ancs_c_command_id_values_t command_id;                        /**< Command of the response being parsed. */
+    uint16_t                 data_dest_len;                           /**< Size of the buffer at p_data_dest, not counting the NUL terminator. */
+    uint8_t                  app_id[BLE_ANCS_ATTR_DATA_MAX + 1];      /**< App identifier of the Get App Attributes response being parsed. */
+    ble_ancs_c_app_cache_entry_t * p_app_entry;                       /**< Cache entry of the Get App Attributes response being parsed, or NULL. */
+    ble_ancs_c_app_cache_entry_t app_cache[BLE_ANCS_APP_ATTR_CACHE_SIZE]; /**< Attributes of recently seen apps. */
+    uint32_t                 app_cache_clock;                         /**< Incremented every time a cache entry is used, to find the least recently used one. */
 } ble_ancs_c_t;
 
 
@@ -382,18 +428,46 @@ uint32_t ble_ancs_c_attr_add(ble_ancs_c_t                          * p_ancs,
 
 
 /**@brief Function for requesting attributes for a notification.
+ *
+ * @details If a request for the same notification is still waiting to be sent, the request is
+ *          not repeated.
  *
  * @param[in] p_ancs   iOS notification structure. This structure must be supplied by
  *                     the application. It identifies the particular client instance to use.
  * @param[in] p_notif  Pointer to the notification whose attributes will be requested from
  *                     the Notification Provider.
  *
- * @retval NRF_SUCCESS If all operations were successful. Otherwise, an error code is returned.
+ * @retval NRF_SUCCESS      If all operations were successful.
+ * @retval NRF_ERROR_NO_MEM If the request queue is full.
+ * @return Otherwise, an error code is returned.
  */
 uint32_t ble_ancs_c_request_attrs(ble_ancs_c_t                 * p_ancs,
                                   const ble_ancs_c_evt_notif_t * p_notif);
 
 
+/**@brief Function for getting the attributes of an iOS app.
+ *
+ * @details The display name of the app is kept in a small cache, with the least recently used
+ *          app replaced first. If the app is cached, @ref BLE_ANCS_C_EVT_APP_ATTRIBUTE is given
+ *          to the event handler before this function returns. If a request for the app is already
+ *          in progress, nothing is sent. Otherwise, a Get App Attributes command is queued and the
+ *          event follows when the response has been parsed.
+ *
+ * @param[in] p_ancs      ANCS client instance.
+ * @param[in] p_app_id    App identifier, as received in the @ref BLE_ANCS_NOTIF_ATTR_ID_APP_IDENTIFIER
+ *                        attribute.
+ * @param[in] len         Length of the app identifier, without NUL terminator.
+ *
+ * @retval NRF_SUCCESS              If the attributes were found in the cache, or requested.
+ * @retval NRF_ERROR_INVALID_LENGTH If the app identifier is empty or longer than @ref BLE_ANCS_ATTR_DATA_MAX.
+ * @retval NRF_ERROR_NO_MEM         If all cache entries are waiting for a response, or the
+ *                                  request queue is full.
+ */
+uint32_t ble_ancs_c_app_attr_request(ble_ancs_c_t  * p_ancs,
+                                     const uint8_t * p_app_id,
+                                     const uint16_t  len);
+
+
 /**@brief Function for assigning handle to a this instance of ancs_c.
  *
  * @details Call this function when a link has been established with a peer to
@@ -298,7 +298,7 @@ uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t * new_params)
     m_preferred_conn_params = *new_params;
     // Set the connection params in stack
     err_code = sd_ble_gap_ppcp_set(&m_preferred_conn_params);
-    if (err_code == NRF_SUCCESS)
+    if ((err_code == NRF_SUCCESS) && (m_conn_handle != BLE_CONN_HANDLE_INVALID))
     {
         if (!is_conn_params_ok(&m_current_conn_params))
         {
@@ -91,6 +91,8 @@ uint32_t ble_conn_params_stop(void);
  *       amount of data.
  *       If the given parameters does not match the current connection's parameters
  *       this function initiates a new negotiation.
+ *       When there is no connection, only the preferred parameters are updated. They are
+ *       used for the next connection and no event is generated.
  *
  * @param[in]   new_params  This contains the new connections parameters to setup.
  *
@@ -0,0 +1,372 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_conn_params_policy.h"
+#include <string.h>
+#include "nordic_common.h"
+#include "sdk_common.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+
+/**@brief Demand seen in one evaluation interval. */
+typedef enum
+{
+    DEMAND_LOW,                                                 /**< All inputs are at or below the low thresholds. */
+    DEMAND_MEDIUM,                                              /**< Between the thresholds, the mode in use is kept. */
+    DEMAND_HIGH                                                 /**< At least one input is at or above its high threshold. */
+} demand_t;
+
+static ble_conn_params_policy_init_t  m_config;                 /**< Configuration as specified by the application. */
+static ble_conn_params_policy_stats_t m_stats;                  /**< Statistics of the module. */
+static ble_conn_params_policy_mode_t  m_mode;                   /**< Mode whose parameters are in use. */
+static ble_conn_params_policy_mode_t  m_requested_mode;         /**< Mode whose parameters were last requested. */
+static bool                           m_request_pending;        /**< A request made by this module is being negotiated. */
+static bool                           m_initial_done;           /**< The ble_conn_params module has reported the outcome of its own negotiation. */
+static uint16_t                       m_conn_handle;            /**< Current connection handle. */
+static uint8_t                        m_tx_queued;              /**< Packets queued in the SoftDevice. */
+static uint32_t                       m_bulk_pending;           /**< Bytes pending in a bulk transfer. */
+static uint32_t                       m_rx_bytes;               /**< Bytes written by the peer in the current evaluation interval. */
+static uint16_t                       m_tx_packets;             /**< Packets sent in the current evaluation interval. */
+static uint8_t                        m_idle_count;             /**< Consecutive evaluations with low demand. */
+static uint8_t                        m_retry_count;            /**< Evaluations left before a rejected request may be retried. */
+APP_TIMER_DEF(m_eval_timer_id);                                 /**< Demand evaluation timer. */
+
+
+/**@brief Function for classifying the demand from the inputs of one evaluation interval. */
+static demand_t demand_get(void)
+{
+    if (   (m_rx_bytes     >= m_config.rx_high_bytes)
+        || (m_tx_packets   >= m_config.tx_high_packets)
+        || (m_tx_queued    >= m_config.tx_queue_high)
+        || (m_bulk_pending >= m_config.bulk_high_bytes))
+    {
+        return DEMAND_HIGH;
+    }
+
+    if (   (m_rx_bytes     <= m_config.rx_low_bytes)
+        && (m_tx_packets   <= m_config.tx_low_packets)
+        && (m_tx_queued    == 0)
+        && (m_bulk_pending == 0))
+    {
+        return DEMAND_LOW;
+    }
+
+    return DEMAND_MEDIUM;
+}
+
+
+/**@brief Function for passing an event to the application. */
+static void evt_send(ble_conn_params_policy_evt_type_t evt_type)
+{
+    if (m_config.evt_handler != NULL)
+    {
+        ble_conn_params_policy_evt_t evt;
+
+        evt.evt_type = evt_type;
+        evt.mode     = m_mode;
+        m_config.evt_handler(&evt);
+    }
+}
+
+
+/**@brief Function for requesting the parameters of a mode. */
+static void mode_request(ble_conn_params_policy_mode_t mode)
+{
+    uint32_t              err_code;
+    ble_gap_conn_params_t params;
+
+    params = (mode == BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT) ? m_config.high_throughput_params
+                                                                  : m_config.low_power_params;
+
+    // Set before the request, the outcome may be reported before it returns.
+    m_requested_mode  = mode;
+    m_request_pending = true;
+    m_stats.requests++;
+
+    err_code = ble_conn_params_change_conn_params(&params);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_request_pending = false;
+        m_retry_count     = m_config.retry_evals;
+
+        if ((err_code != NRF_ERROR_BUSY) && (m_config.error_handler != NULL))
+        {
+            m_config.error_handler(err_code);
+        }
+    }
+}
+
+
+/**@brief Function for evaluating the demand and requesting a new mode if needed. */
+static void evaluate(void)
+{
+    demand_t demand = demand_get();
+
+    if (demand != DEMAND_LOW)
+    {
+        m_idle_count = 0;
+    }
+    else if (m_idle_count < UINT8_MAX)
+    {
+        m_idle_count++;
+    }
+
+    if (   (m_conn_handle == BLE_CONN_HANDLE_INVALID) || !m_initial_done
+        || m_request_pending || (m_retry_count > 0))
+    {
+        return;
+    }
+
+    if (   (m_mode == BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER)
+        && (demand == DEMAND_HIGH))
+    {
+        mode_request(BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT);
+    }
+    else if (   (m_mode == BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT)
+             && (m_idle_count >= m_config.idle_evals))
+    {
+        mode_request(BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER);
+    }
+}
+
+
+static void eval_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if (m_retry_count > 0)
+    {
+        m_retry_count--;
+    }
+
+    if (m_mode == BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT)
+    {
+        m_stats.high_throughput_evals++;
+    }
+    else
+    {
+        m_stats.low_power_evals++;
+    }
+
+    evaluate();
+
+    m_rx_bytes   = 0;
+    m_tx_packets = 0;
+}
+
+
+uint32_t ble_conn_params_policy_init(ble_conn_params_policy_init_t const * p_init)
+{
+    VERIFY_PARAM_NOT_NULL(p_init);
+    VERIFY_TRUE(p_init->eval_interval != 0, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_init->rx_low_bytes < p_init->rx_high_bytes, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_init->tx_low_packets < p_init->tx_high_packets, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_init->tx_queue_high != 0, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_init->bulk_high_bytes != 0, NRF_ERROR_INVALID_PARAM);
+
+    m_config          = *p_init;
+    m_mode            = BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER;
+    m_requested_mode  = BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER;
+    m_request_pending = false;
+    m_initial_done    = false;
+    m_conn_handle     = BLE_CONN_HANDLE_INVALID;
+    m_tx_queued       = 0;
+    m_bulk_pending    = 0;
+    m_rx_bytes        = 0;
+    m_tx_packets      = 0;
+    m_idle_count      = 0;
+    m_retry_count     = 0;
+
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    return app_timer_create(&m_eval_timer_id,
+                            APP_TIMER_MODE_REPEATED,
+                            eval_timeout_handler);
+}
+
+
+void ble_conn_params_policy_tx_queued(uint8_t count)
+{
+    CRITICAL_REGION_ENTER();
+    m_tx_queued = (count > (UINT8_MAX - m_tx_queued)) ? UINT8_MAX : (m_tx_queued + count);
+    CRITICAL_REGION_EXIT();
+}
+
+
+void ble_conn_params_policy_bulk_pending_set(uint32_t bytes)
+{
+    m_bulk_pending = bytes;
+
+    if ((bytes >= m_config.bulk_high_bytes) && (m_mode == BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER))
+    {
+        evaluate();
+    }
+}
+
+
+bool ble_conn_params_policy_on_conn_params_evt(ble_conn_params_evt_t const * p_evt)
+{
+    if (!m_request_pending)
+    {
+        // No request is made before this, so the outcome of the initial negotiation always
+        // reaches the application.
+        m_initial_done = true;
+        return false;
+    }
+
+    m_request_pending = false;
+
+    if (p_evt->evt_type == BLE_CONN_PARAMS_EVT_SUCCEEDED)
+    {
+        m_mode       = m_requested_mode;
+        m_idle_count = 0;
+        evt_send(BLE_CONN_PARAMS_POLICY_EVT_MODE_CHANGED);
+    }
+    else
+    {
+        m_stats.rejected++;
+        m_retry_count = m_config.retry_evals;
+        evt_send(BLE_CONN_PARAMS_POLICY_EVT_REQUEST_REJECTED);
+    }
+
+    return true;
+}
+
+
+ble_conn_params_policy_mode_t ble_conn_params_policy_mode_get(void)
+{
+    return m_mode;
+}
+
+
+void ble_conn_params_policy_stats_get(ble_conn_params_policy_stats_t * p_stats)
+{
+    if (p_stats != NULL)
+    {
+        *p_stats = m_stats;
+    }
+}
+
+
+static void on_connect(ble_evt_t * p_ble_evt)
+{
+    uint32_t err_code;
+
+    m_conn_handle         = p_ble_evt->evt.gap_evt.conn_handle;
+    m_mode                = BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER;
+    m_request_pending     = false;
+    m_tx_queued           = 0;
+    m_rx_bytes            = 0;
+    m_tx_packets          = 0;
+    m_idle_count          = 0;
+    m_retry_count         = 0;
+    m_stats.conn_interval = p_ble_evt->evt.gap_evt.params.connected.conn_params.max_conn_interval;
+    m_stats.slave_latency = p_ble_evt->evt.gap_evt.params.connected.conn_params.slave_latency;
+
+    err_code = app_timer_start(m_eval_timer_id, m_config.eval_interval, NULL);
+    if ((err_code != NRF_SUCCESS) && (m_config.error_handler != NULL))
+    {
+        m_config.error_handler(err_code);
+    }
+}
+
+
+static void on_disconnect(void)
+{
+    uint32_t err_code;
+
+    m_conn_handle     = BLE_CONN_HANDLE_INVALID;
+    m_mode            = BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER;
+    m_request_pending = false;
+    m_initial_done    = false;
+    m_bulk_pending    = 0;
+
+    err_code = app_timer_stop(m_eval_timer_id);
+    if ((err_code != NRF_SUCCESS) && (m_config.error_handler != NULL))
+    {
+        m_config.error_handler(err_code);
+    }
+
+    // The preferred parameters and the PPCP still hold the last request. Restore the low power
+    // parameters so that the next connection starts in low power mode.
+    if (m_requested_mode != BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER)
+    {
+        ble_gap_conn_params_t params = m_config.low_power_params;
+
+        err_code = ble_conn_params_change_conn_params(&params);
+        if (err_code == NRF_SUCCESS)
+        {
+            m_requested_mode = BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER;
+        }
+        else if (m_config.error_handler != NULL)
+        {
+            m_config.error_handler(err_code);
+        }
+    }
+}
+
+
+static void on_tx_complete(ble_evt_t * p_ble_evt)
+{
+    uint8_t count = p_ble_evt->evt.common_evt.params.tx_complete.count;
+
+    m_tx_packets       += count;
+    m_stats.tx_packets += count;
+
+    CRITICAL_REGION_ENTER();
+    m_tx_queued = (count > m_tx_queued) ? 0 : (m_tx_queued - count);
+    CRITICAL_REGION_EXIT();
+}
+
+
+static void on_write(ble_evt_t * p_ble_evt)
+{
+    uint16_t len = p_ble_evt->evt.gatts_evt.params.write.len;
+
+    m_rx_bytes       += len;
+    m_stats.rx_bytes += len;
+}
+
+
+void ble_conn_params_policy_on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            on_connect(p_ble_evt);
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            on_disconnect();
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            on_tx_complete(p_ble_evt);
+            break;
+
+        case BLE_GATTS_EVT_WRITE:
+            on_write(p_ble_evt);
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            m_stats.conn_interval =
+                p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params.max_conn_interval;
+            m_stats.slave_latency =
+                p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params.slave_latency;
+            break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
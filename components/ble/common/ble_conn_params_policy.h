@@ -0,0 +1,173 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**
+ * @file
+ *
+ * @defgroup ble_conn_params_policy Connection Parameters Policy
+ * @ingroup ble_sdk_lib
+ * @{
+ * @brief Module for switching connection parameters based on traffic demand.
+ *
+ * @details The module keeps the connection on a set of low power parameters (long connection
+ *          interval, slave latency) and switches to a set of high throughput parameters when
+ *          there is traffic demand. Demand is evaluated periodically from:
+ *          - the number of notifications/indications queued in the SoftDevice, reported by the
+ *            application with @ref ble_conn_params_policy_tx_queued and completed as reported by
+ *            the SoftDevice,
+ *          - the number of bytes pending in a bulk transfer, reported by the application with
+ *            @ref ble_conn_params_policy_bulk_pending_set,
+ *          - the number of bytes written by the peer and of packets sent, per evaluation
+ *            interval.
+ *
+ *          The rates have separate thresholds for entering and leaving high throughput mode, and
+ *          low power parameters are only requested back after demand has been low for a number
+ *          of consecutive evaluations. A rejected request is retried after a back-off.
+ *
+ *          The parameter updates themselves are negotiated through the @ref ble_conn_params
+ *          module, which must be initialized first. Events from that module must be passed to
+ *          @ref ble_conn_params_policy_on_conn_params_evt, so that the outcome of requests made
+ *          by this module is not mistaken for a failed initial negotiation. No request is made
+ *          on a connection before the outcome of the initial negotiation has been reported, so
+ *          that outcome is always left to the application. On disconnection, the low power
+ *          parameters are restored as preferred parameters for the next connection, which is why
+ *          BLE events must be passed to this module after @ref ble_conn_params_on_ble_evt.
+ *
+ * @note The module handles a single connection, like @ref ble_conn_params.
+ */
+
+#ifndef BLE_CONN_PARAMS_POLICY_H__
+#define BLE_CONN_PARAMS_POLICY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_conn_params.h"
+#include "ble_srv_common.h"
+
+/**@brief Connection parameter modes. */
+typedef enum
+{
+    BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER,          /**< Low power parameters are used. */
+    BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT     /**< High throughput parameters are used. */
+} ble_conn_params_policy_mode_t;
+
+/**@brief Connection Parameters Policy event types. */
+typedef enum
+{
+    BLE_CONN_PARAMS_POLICY_EVT_MODE_CHANGED,        /**< The peer accepted the parameters of a new mode. */
+    BLE_CONN_PARAMS_POLICY_EVT_REQUEST_REJECTED     /**< The peer did not accept the parameters of a new mode. */
+} ble_conn_params_policy_evt_type_t;
+
+/**@brief Connection Parameters Policy event. */
+typedef struct
+{
+    ble_conn_params_policy_evt_type_t evt_type;     /**< Type of event. */
+    ble_conn_params_policy_mode_t     mode;         /**< Mode in use after the event. */
+} ble_conn_params_policy_evt_t;
+
+/**@brief Connection Parameters Policy event handler type. */
+typedef void (*ble_conn_params_policy_evt_handler_t)(ble_conn_params_policy_evt_t * p_evt);
+
+/**@brief Connection Parameters Policy init structure. */
+typedef struct
+{
+    ble_gap_conn_params_t                low_power_params;       /**< Parameters used when there is no traffic demand. These should match the parameters given to @ref ble_conn_params_init. */
+    ble_gap_conn_params_t                high_throughput_params; /**< Parameters used when there is traffic demand. */
+    uint32_t                             eval_interval;          /**< Time between demand evaluations (in number of timer ticks). */
+    uint32_t                             rx_high_bytes;          /**< Bytes written by the peer per evaluation interval at or above which high throughput is requested. */
+    uint32_t                             rx_low_bytes;           /**< Bytes written by the peer per evaluation interval at or below which demand is low again. */
+    uint16_t                             tx_high_packets;        /**< Packets sent per evaluation interval at or above which high throughput is requested. */
+    uint16_t                             tx_low_packets;         /**< Packets sent per evaluation interval at or below which demand is low again. */
+    uint8_t                              tx_queue_high;          /**< Number of queued packets at or above which high throughput is requested. */
+    uint32_t                             bulk_high_bytes;        /**< Pending bulk bytes at or above which high throughput is requested. */
+    uint8_t                              idle_evals;             /**< Consecutive evaluations with low demand before low power parameters are requested. */
+    uint8_t                              retry_evals;            /**< Evaluations to wait after a rejected request before requesting again. */
+    ble_conn_params_policy_evt_handler_t evt_handler;            /**< Event handler, or NULL. */
+    ble_srv_error_handler_t              error_handler;          /**< Function to be called in case of an error. */
+} ble_conn_params_policy_init_t;
+
+/**@brief Connection Parameters Policy statistics. */
+typedef struct
+{
+    uint32_t requests;              /**< Parameter changes requested. */
+    uint32_t rejected;              /**< Requests that were not accepted. */
+    uint32_t high_throughput_evals; /**< Evaluations spent in high throughput mode. */
+    uint32_t low_power_evals;       /**< Evaluations spent in low power mode. */
+    uint32_t rx_bytes;              /**< Bytes written by the peer. */
+    uint32_t tx_packets;            /**< Packets sent. */
+    uint16_t conn_interval;         /**< Connection interval in use (in 1.25 ms units). */
+    uint16_t slave_latency;         /**< Slave latency in use. */
+} ble_conn_params_policy_stats_t;
+
+/**@brief Function for initializing the Connection Parameters Policy module.
+ *
+ * @param[in] p_init  Policy configuration.
+ *
+ * @retval NRF_SUCCESS              The module was initialized.
+ * @retval NRF_ERROR_NULL           p_init was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM  The low thresholds are above the high thresholds, or
+ *                                  eval_interval is 0.
+ * @return Otherwise, the error returned when creating the evaluation timer.
+ */
+uint32_t ble_conn_params_policy_init(ble_conn_params_policy_init_t const * p_init);
+
+/**@brief Function for reporting that packets were queued with @ref sd_ble_gatts_hvx.
+ *
+ * @param[in] count  Number of packets that were queued successfully.
+ */
+void ble_conn_params_policy_tx_queued(uint8_t count);
+
+/**@brief Function for reporting the number of bytes pending in a bulk transfer.
+ *
+ * @details Demand is evaluated immediately when the pending bytes reach the threshold, so that
+ *          the transfer does not wait for the next evaluation.
+ *
+ * @param[in] bytes  Bytes still to be transferred, 0 when no transfer is ongoing.
+ */
+void ble_conn_params_policy_bulk_pending_set(uint32_t bytes);
+
+/**@brief Function for handling events from the @ref ble_conn_params module.
+ *
+ * @param[in] p_evt  Event from the Connection Parameters module.
+ *
+ * @retval true   The event concerned a request made by this module and was handled.
+ * @retval false  The event must be handled by the application.
+ */
+bool ble_conn_params_policy_on_conn_params_evt(ble_conn_params_evt_t const * p_evt);
+
+/**@brief Function for getting the mode in use.
+ */
+ble_conn_params_policy_mode_t ble_conn_params_policy_mode_get(void);
+
+/**@brief Function for getting the statistics of the module.
+ *
+ * @param[out] p_stats  Statistics, accumulated since initialization.
+ */
+void ble_conn_params_policy_stats_get(ble_conn_params_policy_stats_t * p_stats);
+
+/**@brief Function for handling the Application's BLE Stack events.
+ *
+ * @note Events must be passed to this function after @ref ble_conn_params_on_ble_evt. On
+ *       disconnection, the low power parameters are restored through
+ *       @ref ble_conn_params_change_conn_params, which only updates the preferred parameters
+ *       once the @ref ble_conn_params module has seen the disconnection. Passed before it, the
+ *       module would request the update on the closed link and fail the initial negotiation of
+ *       the next connection.
+ *
+ * @param[in] p_ble_evt  The event received from the BLE stack.
+ */
+void ble_conn_params_policy_on_ble_evt(ble_evt_t * p_ble_evt);
+
+#endif // BLE_CONN_PARAMS_POLICY_H__
+
+/** @} */
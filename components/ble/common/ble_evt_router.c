@@ -0,0 +1,172 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_evt_router.h"
+#include <stdlib.h>
+#include "nrf_error.h"
+#include "sdk_common.h"
+
+
+/**@brief Registered event handler. */
+typedef struct
+{
+    uint16_t                 start_handle;  /**< First handle owned by the handler, 0 for subscribers. */
+    ble_evt_router_handler_t handler;
+    void                   * p_context;
+} router_entry_t;
+
+static router_entry_t m_services[BLE_EVT_ROUTER_MAX_SERVICES];        /**< Sorted by start_handle. */
+static uint8_t        m_service_count;
+static router_entry_t m_subscribers[BLE_EVT_ROUTER_MAX_SUBSCRIBERS];
+static uint8_t        m_subscriber_count;
+
+
+/**@brief Function for getting the attribute an event refers to.
+ *
+ * @param[in]  p_ble_evt  The BLE event.
+ *
+ * @return The attribute handle, or BLE_GATT_HANDLE_INVALID if the event does not refer to a
+ *         single attribute.
+ */
+static uint16_t attr_handle_get(ble_evt_t const * p_ble_evt)
+{
+    ble_gatts_evt_t const * p_gatts_evt = &p_ble_evt->evt.gatts_evt;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GATTS_EVT_WRITE:
+            if (   (p_gatts_evt->params.write.op == BLE_GATTS_OP_EXEC_WRITE_REQ_CANCEL)
+                || (p_gatts_evt->params.write.op == BLE_GATTS_OP_EXEC_WRITE_REQ_NOW))
+            {
+                return BLE_GATT_HANDLE_INVALID;
+            }
+            return p_gatts_evt->params.write.handle;
+
+        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
+            if (p_gatts_evt->params.authorize_request.type == BLE_GATTS_AUTHORIZE_TYPE_READ)
+            {
+                return p_gatts_evt->params.authorize_request.request.read.handle;
+            }
+            if (   (p_gatts_evt->params.authorize_request.request.write.op == BLE_GATTS_OP_EXEC_WRITE_REQ_CANCEL)
+                || (p_gatts_evt->params.authorize_request.request.write.op == BLE_GATTS_OP_EXEC_WRITE_REQ_NOW))
+            {
+                return BLE_GATT_HANDLE_INVALID;
+            }
+            return p_gatts_evt->params.authorize_request.request.write.handle;
+
+        case BLE_GATTS_EVT_HVC:
+            return p_gatts_evt->params.hvc.handle;
+
+        default:
+            return BLE_GATT_HANDLE_INVALID;
+    }
+}
+
+
+/**@brief Function for finding the service that owns an attribute.
+ *
+ * @param[in]  handle  Attribute handle.
+ *
+ * @return The owning entry, or NULL if the handle is below all registered services.
+ */
+static router_entry_t const * service_find(uint16_t handle)
+{
+    router_entry_t const * p_owner = NULL;
+    uint32_t               low     = 0;
+    uint32_t               high    = m_service_count;
+
+    // Find the last entry with start_handle <= handle.
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+
+        if (m_services[mid].start_handle <= handle)
+        {
+            p_owner = &m_services[mid];
+            low     = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return p_owner;
+}
+
+
+ret_code_t ble_evt_router_service_register(uint16_t                 start_handle,
+                                           ble_evt_router_handler_t handler,
+                                           void                   * p_context)
+{
+    uint32_t i;
+
+    VERIFY_PARAM_NOT_NULL(handler);
+    VERIFY_TRUE(start_handle != BLE_GATT_HANDLE_INVALID, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(m_service_count < BLE_EVT_ROUTER_MAX_SERVICES, NRF_ERROR_NO_MEM);
+
+    // Insertion sort, services are normally registered in handle order.
+    for (i = m_service_count; i > 0; i--)
+    {
+        if (m_services[i - 1].start_handle == start_handle)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        if (m_services[i - 1].start_handle < start_handle)
+        {
+            break;
+        }
+        m_services[i] = m_services[i - 1];
+    }
+
+    m_services[i].start_handle = start_handle;
+    m_services[i].handler      = handler;
+    m_services[i].p_context    = p_context;
+    m_service_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_evt_router_subscribe(ble_evt_router_handler_t handler, void * p_context)
+{
+    VERIFY_PARAM_NOT_NULL(handler);
+    VERIFY_TRUE(m_subscriber_count < BLE_EVT_ROUTER_MAX_SUBSCRIBERS, NRF_ERROR_NO_MEM);
+
+    m_subscribers[m_subscriber_count].start_handle = BLE_GATT_HANDLE_INVALID;
+    m_subscribers[m_subscriber_count].handler      = handler;
+    m_subscribers[m_subscriber_count].p_context    = p_context;
+    m_subscriber_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_evt_router_on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    uint16_t handle = attr_handle_get(p_ble_evt);
+
+    if (handle != BLE_GATT_HANDLE_INVALID)
+    {
+        router_entry_t const * p_owner = service_find(handle);
+
+        if (p_owner != NULL)
+        {
+            p_owner->handler(p_ble_evt, p_owner->p_context);
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < m_subscriber_count; i++)
+    {
+        m_subscribers[i].handler(p_ble_evt, m_subscribers[i].p_context);
+    }
+}
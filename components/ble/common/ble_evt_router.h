@@ -0,0 +1,95 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**
+ * @file
+ *
+ * @defgroup ble_evt_router BLE event router
+ * @ingroup ble_sdk_lib
+ * @{
+ * @brief Module for delivering BLE events only to the modules they concern.
+ *
+ * @details Services register the first attribute handle of their service together with an event
+ *          handler. A service owns all handles from its first handle up to the first handle of the
+ *          next registered service. GATT Server events that refer to an attribute (write,
+ *          read/write authorize request and handle value confirmation) are delivered only to the
+ *          owner of that attribute, found by binary search in a table sorted by handle.
+ *
+ *          All other events, such as GAP events, are delivered to the subscribers registered with
+ *          @ref ble_evt_router_subscribe.
+ *
+ *          A service typically registers both, so that it is told about connections and
+ *          disconnections, but only sees writes to its own attributes.
+ *
+ *          To function, this module must be provided with BLE events from the SoftDevice through
+ *          the @ref ble_evt_router_on_ble_evt function.
+ */
+
+#ifndef BLE_EVT_ROUTER_H__
+#define BLE_EVT_ROUTER_H__
+
+#include <stdint.h>
+#include "ble.h"
+#include "sdk_errors.h"
+
+#ifndef BLE_EVT_ROUTER_MAX_SERVICES
+#define BLE_EVT_ROUTER_MAX_SERVICES     8   /**< Maximum number of registered attribute ranges. */
+#endif
+
+#ifndef BLE_EVT_ROUTER_MAX_SUBSCRIBERS
+#define BLE_EVT_ROUTER_MAX_SUBSCRIBERS  8   /**< Maximum number of subscribers to non-attribute events. */
+#endif
+
+/**@brief Event handler type.
+ *
+ * @param[in]  p_ble_evt  The BLE event.
+ * @param[in]  p_context  Context given at registration.
+ */
+typedef void (*ble_evt_router_handler_t)(ble_evt_t * p_ble_evt, void * p_context);
+
+/**@brief Function for registering the attributes of a service.
+ *
+ * @param[in]  start_handle  First handle of the service, normally its service handle.
+ * @param[in]  handler       Handler to receive events about the attributes of the service.
+ * @param[in]  p_context     Context passed to the handler.
+ *
+ * @retval NRF_SUCCESS              The service was registered.
+ * @retval NRF_ERROR_NULL           handler was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM  start_handle is invalid or already registered.
+ * @retval NRF_ERROR_NO_MEM         The table is full.
+ */
+ret_code_t ble_evt_router_service_register(uint16_t                 start_handle,
+                                           ble_evt_router_handler_t handler,
+                                           void                   * p_context);
+
+/**@brief Function for subscribing to events that do not refer to an attribute.
+ *
+ * @param[in]  handler    Handler to receive the events.
+ * @param[in]  p_context  Context passed to the handler.
+ *
+ * @retval NRF_SUCCESS              The handler was subscribed.
+ * @retval NRF_ERROR_NULL           handler was NULL.
+ * @retval NRF_ERROR_NO_MEM         The table is full.
+ */
+ret_code_t ble_evt_router_subscribe(ble_evt_router_handler_t handler, void * p_context);
+
+/**@brief Function for delivering a BLE event to its owner or to the subscribers.
+ *
+ * @details Events about an attribute below the first registered handle are dropped.
+ *
+ * @param[in]  p_ble_evt  The BLE event.
+ */
+void ble_evt_router_on_ble_evt(ble_evt_t * p_ble_evt);
+
+#endif /* BLE_EVT_ROUTER_H__ */
+
+/** @} */
@@ -0,0 +1,290 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_gatt_table.h"
+#include <string.h>
+#include "sdk_common.h"
+
+
+/**@brief Metadata structures shared by all entries of a table. */
+typedef struct
+{
+    ble_uuid_t          uuid;
+    ble_gatts_attr_md_t attr_md;
+    ble_gatts_attr_md_t cccd_md;
+    ble_gatts_char_md_t char_md;
+    ble_gatts_attr_t    attr;
+} table_md_t;
+
+
+/**@brief Function for converting a security requirement to a security mode.
+ *
+ * @param[in]  level   Security requirement, see @ref security_req_t.
+ * @param[out] p_perm  Security mode.
+ */
+static void sec_mode_set(uint8_t level, ble_gap_conn_sec_mode_t * p_perm)
+{
+    switch (level)
+    {
+        case SEC_OPEN:
+            BLE_GAP_CONN_SEC_MODE_SET_OPEN(p_perm);
+            break;
+
+        case SEC_JUST_WORKS:
+            BLE_GAP_CONN_SEC_MODE_SET_ENC_NO_MITM(p_perm);
+            break;
+
+        case SEC_MITM:
+            BLE_GAP_CONN_SEC_MODE_SET_ENC_WITH_MITM(p_perm);
+            break;
+
+        case SEC_SIGNED:
+            BLE_GAP_CONN_SEC_MODE_SET_SIGNED_NO_MITM(p_perm);
+            break;
+
+        case SEC_SIGNED_MITM:
+            BLE_GAP_CONN_SEC_MODE_SET_SIGNED_WITH_MITM(p_perm);
+            break;
+
+        default:
+            BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(p_perm);
+            break;
+    }
+}
+
+
+/**@brief Function for checking that a field of the given size at the given offset fits in the
+ *        context.
+ */
+static bool context_fits(uint32_t offset, uint32_t size, size_t context_size)
+{
+    return ((offset + size) <= context_size);
+}
+
+
+/**@brief Function for filling in the value attribute shared by characteristics and descriptors.
+ *
+ * @param[in]  p_entry    Table entry.
+ * @param[in]  p_context  Context structure.
+ * @param[out] p_md       Metadata structures.
+ */
+static void value_attr_set(ble_gatt_table_entry_t const * p_entry,
+                           void                         * p_context,
+                           table_md_t                   * p_md)
+{
+    memset(&p_md->attr_md, 0, sizeof(p_md->attr_md));
+    sec_mode_set(p_entry->read_access,  &p_md->attr_md.read_perm);
+    sec_mode_set(p_entry->write_access, &p_md->attr_md.write_perm);
+
+    p_md->attr_md.rd_auth = (p_entry->flags & BLE_GATT_TABLE_FLAG_RD_AUTH)   ? 1 : 0;
+    p_md->attr_md.wr_auth = (p_entry->flags & BLE_GATT_TABLE_FLAG_WR_AUTH)   ? 1 : 0;
+    p_md->attr_md.vlen    = (p_entry->flags & BLE_GATT_TABLE_FLAG_VAR_LEN)   ? 1 : 0;
+    p_md->attr_md.vloc    = (p_entry->flags & BLE_GATT_TABLE_FLAG_VLOC_USER) ? BLE_GATTS_VLOC_USER
+                                                                              : BLE_GATTS_VLOC_STACK;
+
+    memset(&p_md->attr, 0, sizeof(p_md->attr));
+    p_md->attr.p_uuid    = &p_md->uuid;
+    p_md->attr.p_attr_md = &p_md->attr_md;
+    p_md->attr.max_len   = p_entry->max_len;
+
+    if (p_entry->flags & BLE_GATT_TABLE_FLAG_INIT_CONTEXT)
+    {
+        p_md->attr.p_value  = (uint8_t *)p_context + p_entry->init_offset;
+        p_md->attr.init_len = p_entry->init_len;
+    }
+    else if (p_entry->p_init_value != NULL)
+    {
+        p_md->attr.p_value  = (uint8_t *)p_entry->p_init_value;
+        p_md->attr.init_len = p_entry->init_len;
+    }
+}
+
+
+ret_code_t ble_gatt_table_validate(ble_gatt_table_entry_t const * p_table,
+                                   uint32_t                       count,
+                                   size_t                         context_size)
+{
+    bool in_service = false;
+    bool in_char    = false;
+
+    VERIFY_PARAM_NOT_NULL(p_table);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ble_gatt_table_entry_t const * p_entry = &p_table[i];
+        uint32_t                       handle_size;
+
+        switch (p_entry->type)
+        {
+            case BLE_GATT_TABLE_TYPE_SERVICE:
+                in_service  = true;
+                in_char     = false;
+                handle_size = sizeof(uint16_t);
+                break;
+
+            case BLE_GATT_TABLE_TYPE_CHAR:
+                VERIFY_TRUE(in_service, NRF_ERROR_INVALID_PARAM);
+                in_char     = true;
+                handle_size = sizeof(ble_gatts_char_handles_t);
+                break;
+
+            case BLE_GATT_TABLE_TYPE_DESC:
+                VERIFY_TRUE(in_char, NRF_ERROR_INVALID_PARAM);
+                handle_size = sizeof(uint16_t);
+                break;
+
+            default:
+                return NRF_ERROR_INVALID_PARAM;
+        }
+
+        if (p_entry->handle_offset != BLE_GATT_TABLE_NO_HANDLE)
+        {
+            VERIFY_TRUE(context_fits(p_entry->handle_offset, handle_size, context_size),
+                        NRF_ERROR_INVALID_PARAM);
+        }
+
+        if (p_entry->type == BLE_GATT_TABLE_TYPE_SERVICE)
+        {
+            continue;
+        }
+
+        VERIFY_TRUE(p_entry->init_len <= p_entry->max_len, NRF_ERROR_INVALID_PARAM);
+
+        if (p_entry->flags & BLE_GATT_TABLE_FLAG_INIT_CONTEXT)
+        {
+            VERIFY_TRUE(context_fits(p_entry->init_offset, p_entry->init_len, context_size),
+                        NRF_ERROR_INVALID_PARAM);
+        }
+
+        if (p_entry->flags & BLE_GATT_TABLE_FLAG_VLOC_USER)
+        {
+            // The value is kept in application memory, which must be large enough for the value.
+            VERIFY_TRUE((p_entry->flags & BLE_GATT_TABLE_FLAG_INIT_CONTEXT) &&
+                        context_fits(p_entry->init_offset, p_entry->max_len, context_size),
+                        NRF_ERROR_INVALID_PARAM);
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_gatt_table_add(ble_gatt_table_entry_t const * p_table,
+                              uint32_t                       count,
+                              uint8_t                        vs_uuid_type,
+                              void                         * p_context,
+                              size_t                         context_size)
+{
+    ret_code_t err_code;
+    table_md_t md;
+    uint16_t   service_handle = BLE_GATT_HANDLE_INVALID;
+
+    if (p_context == NULL)
+    {
+        context_size = 0;
+    }
+
+    err_code = ble_gatt_table_validate(p_table, count, context_size);
+    VERIFY_SUCCESS(err_code);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ble_gatt_table_entry_t const * p_entry  = &p_table[i];
+        uint8_t                      * p_handle = NULL;
+
+        if (p_entry->handle_offset != BLE_GATT_TABLE_NO_HANDLE)
+        {
+            p_handle = (uint8_t *)p_context + p_entry->handle_offset;
+        }
+
+        md.uuid.uuid = p_entry->uuid;
+        md.uuid.type = (p_entry->flags & BLE_GATT_TABLE_FLAG_VS_UUID) ? vs_uuid_type
+                                                                      : BLE_UUID_TYPE_BLE;
+
+        switch (p_entry->type)
+        {
+            case BLE_GATT_TABLE_TYPE_SERVICE:
+                err_code = sd_ble_gatts_service_add((p_entry->flags & BLE_GATT_TABLE_FLAG_SECONDARY)
+                                                    ? BLE_GATTS_SRVC_TYPE_SECONDARY
+                                                    : BLE_GATTS_SRVC_TYPE_PRIMARY,
+                                                    &md.uuid,
+                                                    &service_handle);
+                if ((err_code == NRF_SUCCESS) && (p_handle != NULL))
+                {
+                    memcpy(p_handle, &service_handle, sizeof(service_handle));
+                }
+                break;
+
+            case BLE_GATT_TABLE_TYPE_CHAR:
+            {
+                ble_gatts_char_handles_t char_handles;
+
+                value_attr_set(p_entry, p_context, &md);
+
+                memset(&md.char_md, 0, sizeof(md.char_md));
+                md.char_md.char_props.broadcast     = (p_entry->props & BLE_GATT_TABLE_PROP_BROADCAST)      ? 1 : 0;
+                md.char_md.char_props.read          = (p_entry->props & BLE_GATT_TABLE_PROP_READ)           ? 1 : 0;
+                md.char_md.char_props.write_wo_resp = (p_entry->props & BLE_GATT_TABLE_PROP_WRITE_WO_RESP)  ? 1 : 0;
+                md.char_md.char_props.write         = (p_entry->props & BLE_GATT_TABLE_PROP_WRITE)          ? 1 : 0;
+                md.char_md.char_props.notify        = (p_entry->props & BLE_GATT_TABLE_PROP_NOTIFY)         ? 1 : 0;
+                md.char_md.char_props.indicate      = (p_entry->props & BLE_GATT_TABLE_PROP_INDICATE)       ? 1 : 0;
+                md.char_md.char_props.auth_signed_wr = (p_entry->props & BLE_GATT_TABLE_PROP_AUTH_SIGNED_WR) ? 1 : 0;
+
+                if (p_entry->props & (BLE_GATT_TABLE_PROP_NOTIFY | BLE_GATT_TABLE_PROP_INDICATE))
+                {
+                    memset(&md.cccd_md, 0, sizeof(md.cccd_md));
+                    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&md.cccd_md.read_perm);
+                    sec_mode_set(p_entry->cccd_write_access, &md.cccd_md.write_perm);
+                    md.cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+
+                    md.char_md.p_cccd_md = &md.cccd_md;
+                }
+
+                err_code = sd_ble_gatts_characteristic_add(service_handle,
+                                                           &md.char_md,
+                                                           &md.attr,
+                                                           &char_handles);
+                if ((err_code == NRF_SUCCESS) && (p_handle != NULL))
+                {
+                    memcpy(p_handle, &char_handles, sizeof(char_handles));
+                }
+                break;
+            }
+
+            case BLE_GATT_TABLE_TYPE_DESC:
+            {
+                uint16_t desc_handle;
+
+                value_attr_set(p_entry, p_context, &md);
+
+                // Placed sequentially, after the last added characteristic.
+                err_code = sd_ble_gatts_descriptor_add(BLE_GATT_HANDLE_INVALID,
+                                                       &md.attr,
+                                                       &desc_handle);
+                if ((err_code == NRF_SUCCESS) && (p_handle != NULL))
+                {
+                    memcpy(p_handle, &desc_handle, sizeof(desc_handle));
+                }
+                break;
+            }
+
+            default:
+                // Rejected by the validation.
+                err_code = NRF_ERROR_INVALID_PARAM;
+                break;
+        }
+
+        VERIFY_SUCCESS(err_code);
+    }
+
+    return NRF_SUCCESS;
+}
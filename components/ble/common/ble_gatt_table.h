@@ -0,0 +1,269 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**
+ * @file
+ *
+ * @defgroup ble_gatt_table GATT attribute table builder
+ * @ingroup ble_sdk_lib
+ * @{
+ * @brief Module for building GATT Server attributes from a constant table.
+ *
+ * @details A service describes its attributes as a constant array of @ref ble_gatt_table_entry_t,
+ *          declared with the BLE_GATT_TABLE_* macros. The table is placed in flash, and the
+ *          macros reject invalid lengths and security levels at compile time.
+ *
+ *          @ref ble_gatt_table_add validates the whole table before it adds anything, so a broken
+ *          table never leaves a partially populated attribute table behind. It then adds the
+ *          attributes back to back, reusing a single set of metadata structures for all entries.
+ *
+ *          Handles assigned by the SoftDevice are written into a context structure given by the
+ *          caller, normally the service structure, at the offsets stored in the table. Initial
+ *          values that are only known at run time can be taken from the same structure.
+ *
+ * @code
+ * static const ble_gatt_table_entry_t m_table[] =
+ * {
+ *     BLE_GATT_TABLE_SERVICE(MY_SERVICE_UUID, BLE_GATT_TABLE_FLAG_VS_UUID,
+ *                            offsetof(my_service_t, service_handle)),
+ *     BLE_GATT_TABLE_CHAR(MY_CHAR_UUID, BLE_GATT_TABLE_FLAG_VS_UUID,
+ *                         BLE_GATT_TABLE_PROP_READ | BLE_GATT_TABLE_PROP_NOTIFY,
+ *                         SEC_OPEN, SEC_NO_ACCESS, SEC_OPEN, 20,
+ *                         offsetof(my_service_t, my_char_handles)),
+ * };
+ *
+ * err_code = ble_gatt_table_add(m_table, sizeof(m_table) / sizeof(m_table[0]), uuid_type,
+ *                               p_my_service, sizeof(my_service_t));
+ * @endcode
+ */
+
+#ifndef BLE_GATT_TABLE_H__
+#define BLE_GATT_TABLE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ble_gatts.h"
+#include "ble_srv_common.h"
+#include "sdk_errors.h"
+
+/**@brief Types of table entries. */
+typedef enum
+{
+    BLE_GATT_TABLE_TYPE_SERVICE,        /**< Service declaration. */
+    BLE_GATT_TABLE_TYPE_CHAR,           /**< Characteristic, added to the last declared service. */
+    BLE_GATT_TABLE_TYPE_DESC            /**< Descriptor, added to the last declared characteristic. */
+} ble_gatt_table_type_t;
+
+/**
+ * @defgroup ble_gatt_table_props Characteristic properties
+ * @{
+ */
+#define BLE_GATT_TABLE_PROP_BROADCAST       0x01    /**< Broadcast. */
+#define BLE_GATT_TABLE_PROP_READ            0x02    /**< Read. */
+#define BLE_GATT_TABLE_PROP_WRITE_WO_RESP   0x04    /**< Write Without Response. */
+#define BLE_GATT_TABLE_PROP_WRITE           0x08    /**< Write. */
+#define BLE_GATT_TABLE_PROP_NOTIFY          0x10    /**< Notify. A CCCD is added. */
+#define BLE_GATT_TABLE_PROP_INDICATE        0x20    /**< Indicate. A CCCD is added. */
+#define BLE_GATT_TABLE_PROP_AUTH_SIGNED_WR  0x40    /**< Authenticated Signed Writes. */
+/** @} */
+
+/**
+ * @defgroup ble_gatt_table_flags Entry flags
+ * @{
+ */
+#define BLE_GATT_TABLE_FLAG_VS_UUID         0x01    /**< The UUID is relative to the vendor specific base given to @ref ble_gatt_table_add. */
+#define BLE_GATT_TABLE_FLAG_VAR_LEN         0x02    /**< The value has variable length. */
+#define BLE_GATT_TABLE_FLAG_VLOC_USER       0x04    /**< The value is located in the context, at the initial value offset, instead of in the stack. */
+#define BLE_GATT_TABLE_FLAG_RD_AUTH         0x08    /**< Reads are authorized by the application. */
+#define BLE_GATT_TABLE_FLAG_WR_AUTH         0x10    /**< Writes are authorized by the application. */
+#define BLE_GATT_TABLE_FLAG_INIT_CONTEXT    0x20    /**< The initial value is located in the context, at the initial value offset. */
+#define BLE_GATT_TABLE_FLAG_SECONDARY       0x40    /**< Declare a secondary service instead of a primary service. */
+/** @} */
+
+#define BLE_GATT_TABLE_NO_HANDLE            0xFFFF  /**< Handle offset of an entry whose handle is not kept. */
+
+/**@brief Table entry. Use the BLE_GATT_TABLE_* macros to declare entries. */
+typedef struct
+{
+    uint16_t     uuid;              /**< 16-bit UUID, or 16-bit offset into a vendor specific base. */
+    uint8_t      type;              /**< Entry type, see @ref ble_gatt_table_type_t. */
+    uint8_t      flags;             /**< Entry flags, see @ref ble_gatt_table_flags. */
+    uint8_t      props;             /**< Characteristic properties, see @ref ble_gatt_table_props. */
+    uint8_t      read_access;       /**< Security requirement for reading the value, see @ref security_req_t. */
+    uint8_t      write_access;      /**< Security requirement for writing the value, see @ref security_req_t. */
+    uint8_t      cccd_write_access; /**< Security requirement for writing the CCCD, see @ref security_req_t. */
+    uint16_t     max_len;           /**< Maximum length of the value. */
+    uint16_t     init_len;          /**< Length of the initial value. */
+    uint16_t     init_offset;       /**< Offset of the initial value in the context, if @ref BLE_GATT_TABLE_FLAG_INIT_CONTEXT is set. */
+    uint16_t     handle_offset;     /**< Offset in the context where the handle is stored, or @ref BLE_GATT_TABLE_NO_HANDLE. A service stores a uint16_t, a characteristic a @ref ble_gatts_char_handles_t and a descriptor a uint16_t. */
+    void const * p_init_value;      /**< Initial value, or NULL. */
+} ble_gatt_table_entry_t;
+
+/**@brief Macro evaluating to 0 if a condition holds at compile time, and failing the build
+ *        otherwise.
+ */
+#define BLE_GATT_TABLE_CHECK(COND)  (0 * sizeof(char[(COND) ? 1 : -1]))
+
+/**@brief Macro for checking a security requirement at compile time. */
+#define BLE_GATT_TABLE_SEC(LEVEL)   ((LEVEL) + BLE_GATT_TABLE_CHECK((LEVEL) <= SEC_SIGNED_MITM))
+
+/**@brief Macro for checking a value length at compile time. */
+#define BLE_GATT_TABLE_LEN(MAX_LEN, INIT_LEN)                                   \
+    ((MAX_LEN) + BLE_GATT_TABLE_CHECK(((MAX_LEN) > 0)                        && \
+                                      ((MAX_LEN) <= BLE_GATTS_VAR_ATTR_LEN_MAX) && \
+                                      ((INIT_LEN) <= (MAX_LEN))))
+
+/**@brief Macro for declaring a service.
+ *
+ * @param[in] UUID           16-bit UUID of the service.
+ * @param[in] FLAGS          @ref BLE_GATT_TABLE_FLAG_VS_UUID and/or
+ *                           @ref BLE_GATT_TABLE_FLAG_SECONDARY.
+ * @param[in] HANDLE_OFFSET  Offset of the uint16_t service handle in the context.
+ */
+#define BLE_GATT_TABLE_SERVICE(UUID, FLAGS, HANDLE_OFFSET)                      \
+    {                                                                           \
+        .uuid          = (UUID),                                                \
+        .type          = BLE_GATT_TABLE_TYPE_SERVICE,                           \
+        .flags         = (FLAGS),                                               \
+        .handle_offset = (HANDLE_OFFSET),                                       \
+    }
+
+/**@brief Macro for declaring a characteristic with the value initialized to zero length.
+ *
+ * @param[in] UUID           16-bit UUID of the characteristic.
+ * @param[in] FLAGS          Entry flags, see @ref ble_gatt_table_flags.
+ * @param[in] PROPS          Characteristic properties, see @ref ble_gatt_table_props.
+ * @param[in] READ           Security requirement for reading the value.
+ * @param[in] WRITE          Security requirement for writing the value.
+ * @param[in] CCCD_WRITE     Security requirement for writing the CCCD.
+ * @param[in] MAX_LEN        Maximum length of the value.
+ * @param[in] HANDLE_OFFSET  Offset of the @ref ble_gatts_char_handles_t in the context.
+ */
+#define BLE_GATT_TABLE_CHAR(UUID, FLAGS, PROPS, READ, WRITE, CCCD_WRITE, MAX_LEN, HANDLE_OFFSET) \
+    BLE_GATT_TABLE_CHAR_INIT(UUID, FLAGS, PROPS, READ, WRITE, CCCD_WRITE, MAX_LEN,           \
+                             NULL, 0, HANDLE_OFFSET)
+
+/**@brief Macro for declaring a characteristic with a constant initial value.
+ *
+ * @param[in] P_INIT    Initial value.
+ * @param[in] INIT_LEN  Length of the initial value.
+ *
+ * See @ref BLE_GATT_TABLE_CHAR for the other parameters.
+ */
+#define BLE_GATT_TABLE_CHAR_INIT(UUID, FLAGS, PROPS, READ, WRITE, CCCD_WRITE, MAX_LEN,     \
+                                 P_INIT, INIT_LEN, HANDLE_OFFSET)                          \
+    {                                                                                      \
+        .uuid              = (UUID),                                                       \
+        .type              = BLE_GATT_TABLE_TYPE_CHAR,                                     \
+        .flags             = (FLAGS),                                                      \
+        .props             = (PROPS),                                                      \
+        .read_access       = BLE_GATT_TABLE_SEC(READ),                                     \
+        .write_access      = BLE_GATT_TABLE_SEC(WRITE),                                    \
+        .cccd_write_access = BLE_GATT_TABLE_SEC(CCCD_WRITE),                               \
+        .max_len           = BLE_GATT_TABLE_LEN(MAX_LEN, INIT_LEN),                        \
+        .init_len          = (INIT_LEN),                                                   \
+        .handle_offset     = (HANDLE_OFFSET),                                              \
+        .p_init_value      = (P_INIT),                                                     \
+    }
+
+/**@brief Macro for declaring a characteristic whose initial value is located in the context.
+ *
+ * @param[in] INIT_OFFSET  Offset of the initial value in the context.
+ * @param[in] INIT_LEN     Length of the initial value.
+ *
+ * See @ref BLE_GATT_TABLE_CHAR for the other parameters.
+ */
+#define BLE_GATT_TABLE_CHAR_INIT_CONTEXT(UUID, FLAGS, PROPS, READ, WRITE, CCCD_WRITE, MAX_LEN, \
+                                         INIT_OFFSET, INIT_LEN, HANDLE_OFFSET)                 \
+    {                                                                                          \
+        .uuid              = (UUID),                                                           \
+        .type              = BLE_GATT_TABLE_TYPE_CHAR,                                         \
+        .flags             = (FLAGS) | BLE_GATT_TABLE_FLAG_INIT_CONTEXT,                       \
+        .props             = (PROPS),                                                          \
+        .read_access       = BLE_GATT_TABLE_SEC(READ),                                         \
+        .write_access      = BLE_GATT_TABLE_SEC(WRITE),                                        \
+        .cccd_write_access = BLE_GATT_TABLE_SEC(CCCD_WRITE),                                   \
+        .max_len           = BLE_GATT_TABLE_LEN(MAX_LEN, INIT_LEN),                            \
+        .init_len          = (INIT_LEN),                                                       \
+        .init_offset       = (INIT_OFFSET),                                                    \
+        .handle_offset     = (HANDLE_OFFSET),                                                  \
+    }
+
+/**@brief Macro for declaring a descriptor of the last declared characteristic.
+ *
+ * @param[in] UUID           16-bit UUID of the descriptor.
+ * @param[in] FLAGS          Entry flags, see @ref ble_gatt_table_flags.
+ * @param[in] READ           Security requirement for reading the descriptor.
+ * @param[in] WRITE          Security requirement for writing the descriptor.
+ * @param[in] MAX_LEN        Maximum length of the descriptor.
+ * @param[in] P_INIT         Initial value, or NULL.
+ * @param[in] INIT_LEN       Length of the initial value.
+ * @param[in] HANDLE_OFFSET  Offset of the uint16_t descriptor handle in the context.
+ */
+#define BLE_GATT_TABLE_DESC(UUID, FLAGS, READ, WRITE, MAX_LEN, P_INIT, INIT_LEN, HANDLE_OFFSET) \
+    {                                                                                           \
+        .uuid          = (UUID),                                                                \
+        .type          = BLE_GATT_TABLE_TYPE_DESC,                                              \
+        .flags         = (FLAGS),                                                               \
+        .read_access   = BLE_GATT_TABLE_SEC(READ),                                              \
+        .write_access  = BLE_GATT_TABLE_SEC(WRITE),                                             \
+        .max_len       = BLE_GATT_TABLE_LEN(MAX_LEN, INIT_LEN),                                 \
+        .init_len      = (INIT_LEN),                                                            \
+        .handle_offset = (HANDLE_OFFSET),                                                       \
+        .p_init_value  = (P_INIT),                                                              \
+    }
+
+/**@brief Function for validating an attribute table without adding it.
+ *
+ * @details Checks the parts of the table that cannot be checked at compile time: entry order,
+ *          and that handles and initial values located in the context fit in it.
+ *
+ * @param[in] p_table       Attribute table.
+ * @param[in] count         Number of entries in the table.
+ * @param[in] context_size  Size of the context structure, or 0 if no context is used.
+ *
+ * @retval NRF_SUCCESS              The table is valid.
+ * @retval NRF_ERROR_NULL           p_table was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM  The table is invalid.
+ */
+ret_code_t ble_gatt_table_validate(ble_gatt_table_entry_t const * p_table,
+                                   uint32_t                       count,
+                                   size_t                         context_size);
+
+/**@brief Function for adding the attributes described by a table to the GATT Server.
+ *
+ * @details The table is validated before any attribute is added.
+ *
+ * @param[in]  p_table       Attribute table.
+ * @param[in]  count         Number of entries in the table.
+ * @param[in]  vs_uuid_type  UUID type of the vendor specific base used by entries with
+ *                           @ref BLE_GATT_TABLE_FLAG_VS_UUID, as returned by
+ *                           @ref sd_ble_uuid_vs_add.
+ * @param[out] p_context     Structure receiving handles and holding initial values, normally
+ *                           the service structure. May be NULL if no entry refers to it.
+ * @param[in]  context_size  Size of the context structure.
+ *
+ * @retval NRF_SUCCESS              All attributes were added.
+ * @retval NRF_ERROR_NULL           p_table was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM  The table is invalid, or refers to a context that was not
+ *                                  given. Nothing was added.
+ * @return Otherwise, the error returned by the SoftDevice when adding an attribute.
+ */
+ret_code_t ble_gatt_table_add(ble_gatt_table_entry_t const * p_table,
+                              uint32_t                       count,
+                              uint8_t                        vs_uuid_type,
+                              void                         * p_context,
+                              size_t                         context_size);
+
+#endif // BLE_GATT_TABLE_H__
+
+/** @} */
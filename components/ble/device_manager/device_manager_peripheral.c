@@ -402,6 +402,38 @@ typedef struct
 
 STATIC_ASSERT(sizeof(dm_gatt_client_context_t) % 4 == 0);  /**< Check to ensure GATT Client context information is a multiple of 4. */
 STATIC_ASSERT((DEVICE_MANAGER_APP_CONTEXT_SIZE % 4) == 0); /**< Check to ensure device manager application context information is a multiple of 4. */
+STATIC_ASSERT(DEVICE_MANAGER_MAX_BONDS < DM_INVALID_ID);   /**< Check to ensure every device instance can be identified with an 8-bit identifier. */
+
+#define BOND_BITMAP_WORDS  ((DEVICE_MANAGER_MAX_BONDS + 31) / 32) /**< Number of words needed for a bitmap holding one bit per device instance. */
+#define BOND_INDEX_KEY_LEN (BLE_GAP_ADDR_LEN + 1)                  /**< Length of the search key of a bond index entry. */
+
+/**@brief Entry of a bond index.
+ *
+ * @details The key is a copy of the indexed field rather than a reference into the peer table,
+ *          so that the index remains sorted while the SoftDevice writes distributed keys into
+ *          the peer table during a security procedure.
+ */
+typedef struct
+{
+    uint8_t key[BOND_INDEX_KEY_LEN]; /**< Search key, address type followed by address, or diversifier. */
+    uint8_t device_id;               /**< Device instance the key belongs to. */
+} bond_index_entry_t;
+
+/**@brief Bonded devices sorted on a search key, searched using binary search.
+ */
+typedef struct
+{
+    bond_index_entry_t entry[DEVICE_MANAGER_MAX_BONDS]; /**< Entries sorted in ascending key order. */
+    uint32_t           count;                           /**< Number of entries in use. */
+} bond_index_t;
+
+/**@brief Device instances kept in ascending order.
+ */
+typedef struct
+{
+    uint8_t  device_id[DEVICE_MANAGER_MAX_BONDS]; /**< Device instances in ascending order. */
+    uint32_t count;                               /**< Number of device instances in the list. */
+} bond_list_t;
 
 /**@brief Connection instance definition. Maintains information with respect to an active peer.
  */
@@ -476,7 +508,13 @@ static dm_gatts_context_t     m_gatts_table[DEVICE_MANAGER_MAX_CONNECTIONS];
 static connection_instance_t  m_connection_table[DEVICE_MANAGER_MAX_CONNECTIONS];   /**< Table to maintain active peer information. An instance is allocated in the table when a new connection is established and freed on disconnection. */
 static application_instance_t m_application_table[DEVICE_MANAGER_MAX_APPLICATIONS]; /**< Table to maintain application instances. */
 static pstorage_handle_t      m_storage_handle;                                     /**< Persistent storage handle for blocks requested by the module. */
-static uint32_t               m_peer_addr_update;                                   /**< 32-bit bitmap to remember peer device address update. */
+static uint32_t               m_peer_addr_update[BOND_BITMAP_WORDS];                /**< Bitmap to remember peer device address update. */
+static uint32_t               m_peer_id_dirty[BOND_BITMAP_WORDS];                   /**< Bitmap of device instances whose peer identification has changed since it was last written to persistent memory. */
+static uint32_t               m_peer_assigned[BOND_BITMAP_WORDS];                   /**< Bitmap of allocated device instances, used to find a free instance. */
+static bond_index_t           m_addr_index;                                         /**< Bonded devices indexed on identification address. */
+static bond_index_t           m_ediv_index;                                         /**< Bonded devices indexed on encrypted diversifier. */
+static bond_list_t            m_whitelist_addr_list;                                /**< Bonded devices identified by address, candidates for the whitelist. */
+static bond_list_t            m_whitelist_irk_list;                                 /**< Bonded devices identified by IRK, candidates for the whitelist. */
 static ble_gap_id_key_t       m_local_id_info;                                      /**< ID information of central in case resolvable address is used. */
 static bool                   m_module_initialized = false;                         /**< State indicating if module is initialized or not. */
 static uint8_t                m_irk_index_table[DEVICE_MANAGER_MAX_BONDS];          /**< List maintaining IRK index list. */
@@ -549,13 +587,48 @@ const service_context_apply_t m_service_context_apply[DM_SERVICE_CONTEXT_COUNT]
 
 const uint32_t m_context_init_len = 0xFFFFFFFF; /**< Constant used to update the initial value for context in the flash. */
 
+/**@brief Function for setting the bit of the device identified by 'index' in a device bitmap.
+ *
+ * @param[in] p_bitmap Device bitmap.
+ * @param[in] index    Device identifier.
+ */
+static __INLINE void bond_bit_set(uint32_t * p_bitmap, uint32_t index)
+{
+    p_bitmap[index >> 5] |= ((uint32_t)BIT_0 << (index & 0x1F));
+}
+
+
+/**@brief Function for clearing the bit of the device identified by 'index' in a device bitmap.
+ *
+ * @param[in] p_bitmap Device bitmap.
+ * @param[in] index    Device identifier.
+ */
+static __INLINE void bond_bit_clear(uint32_t * p_bitmap, uint32_t index)
+{
+    p_bitmap[index >> 5] &= (~((uint32_t)BIT_0 << (index & 0x1F)));
+}
+
+
+/**@brief Function for reading the bit of the device identified by 'index' in a device bitmap.
+ *
+ * @param[in] p_bitmap Device bitmap.
+ * @param[in] index    Device identifier.
+ *
+ * @retval true if the bit is set, false otherwise.
+ */
+static __INLINE bool bond_bit_is_set(uint32_t const * p_bitmap, uint32_t index)
+{
+    return ((p_bitmap[index >> 5] & ((uint32_t)BIT_0 << (index & 0x1F))) ? true : false);
+}
+
+
 /**@brief Function for setting update status for the device identified by 'index'.
  *
  * @param[in] index Device identifier.
  */
 static __INLINE void update_status_bit_set(uint32_t index)
 {
-    m_peer_addr_update |= (BIT_0 << index);
+    bond_bit_set(m_peer_addr_update, index);
 }
 
 
@@ -565,7 +638,7 @@ static __INLINE void update_status_bit_set(uint32_t index)
  */
 static __INLINE void update_status_bit_reset(uint32_t index)
 {
-    m_peer_addr_update &= (~((uint32_t)BIT_0 << index));
+    bond_bit_clear(m_peer_addr_update, index);
 }
 
 
@@ -577,7 +650,244 @@ static __INLINE void update_status_bit_reset(uint32_t index)
  */
 static __INLINE bool update_status_bit_is_set(uint32_t index)
 {
-    return ((m_peer_addr_update & (BIT_0 << index)) ? true : false);
+    return bond_bit_is_set(m_peer_addr_update, index);
+}
+
+
+/**@brief Function for building the bond index key of a peer address.
+ *
+ * @param[in]  p_addr Peer address.
+ * @param[out] p_key  Search key.
+ */
+static __INLINE void addr_key_make(ble_gap_addr_t const * p_addr, uint8_t * p_key)
+{
+    p_key[0] = p_addr->addr_type;
+    memcpy(&p_key[1], p_addr->addr, BLE_GAP_ADDR_LEN);
+}
+
+
+/**@brief Function for building the bond index key of an encrypted diversifier.
+ *
+ * @param[in]  ediv  Encrypted diversifier.
+ * @param[out] p_key Search key.
+ */
+static __INLINE void ediv_key_make(uint16_t ediv, uint8_t * p_key)
+{
+    memset(p_key, 0, BOND_INDEX_KEY_LEN);
+    p_key[0] = (uint8_t)(ediv >> 8);
+    p_key[1] = (uint8_t)(ediv);
+}
+
+
+/**@brief Function for finding the position of the first entry in a bond index with a key that
+ *        is not less than 'p_key'.
+ *
+ * @param[in] p_index Bond index.
+ * @param[in] p_key   Search key.
+ *
+ * @return Position in the range (0, count).
+ */
+static uint32_t bond_index_lower_bound(bond_index_t const * p_index, uint8_t const * p_key)
+{
+    uint32_t low  = 0;
+    uint32_t high = p_index->count;
+
+    while (low < high)
+    {
+        uint32_t mid = (low + high) >> 1;
+
+        if (memcmp(p_index->entry[mid].key, p_key, BOND_INDEX_KEY_LEN) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+
+/**@brief Function for searching a device in a bond index.
+ *
+ * @param[in]  p_index        Bond index.
+ * @param[in]  p_key          Search key.
+ * @param[out] p_device_index Device index.
+ *
+ * @retval NRF_SUCCESS         Operation success.
+ * @retval NRF_ERROR_NOT_FOUND Operation failure.
+ */
+static ret_code_t bond_index_find(bond_index_t const * p_index,
+                                  uint8_t const      * p_key,
+                                  uint32_t           * p_device_index)
+{
+    uint32_t pos = bond_index_lower_bound(p_index, p_key);
+
+    if ((pos < p_index->count) &&
+        (memcmp(p_index->entry[pos].key, p_key, BOND_INDEX_KEY_LEN) == 0))
+    {
+        (*p_device_index) = p_index->entry[pos].device_id;
+        return NRF_SUCCESS;
+    }
+
+    return NRF_ERROR_NOT_FOUND;
+}
+
+
+/**@brief Function for adding a device to a bond index.
+ *
+ * @note A device must be removed from the index before it is added again.
+ *
+ * @param[in] p_index Bond index.
+ * @param[in] p_key   Search key of the device.
+ * @param[in] index   Device identifier.
+ */
+static void bond_index_insert(bond_index_t * p_index, uint8_t const * p_key, uint32_t index)
+{
+    uint32_t pos = bond_index_lower_bound(p_index, p_key);
+
+    memmove(&p_index->entry[pos + 1],
+            &p_index->entry[pos],
+            (p_index->count - pos) * sizeof(bond_index_entry_t));
+
+    memcpy(p_index->entry[pos].key, p_key, BOND_INDEX_KEY_LEN);
+    p_index->entry[pos].device_id = index;
+    p_index->count++;
+}
+
+
+/**@brief Function for removing a device from a bond index, if present.
+ *
+ * @param[in] p_index Bond index.
+ * @param[in] index   Device identifier.
+ */
+static void bond_index_remove(bond_index_t * p_index, uint32_t index)
+{
+    for (uint32_t pos = 0; pos < p_index->count; pos++)
+    {
+        if (p_index->entry[pos].device_id == index)
+        {
+            p_index->count--;
+            memmove(&p_index->entry[pos],
+                    &p_index->entry[pos + 1],
+                    (p_index->count - pos) * sizeof(bond_index_entry_t));
+            break;
+        }
+    }
+}
+
+
+/**@brief Function for adding a device to a list of device instances, keeping ascending order.
+ *
+ * @param[in] p_list List of device instances.
+ * @param[in] index  Device identifier.
+ */
+static void bond_list_insert(bond_list_t * p_list, uint32_t index)
+{
+    uint32_t pos = p_list->count;
+
+    while ((pos > 0) && (p_list->device_id[pos - 1] > index))
+    {
+        p_list->device_id[pos] = p_list->device_id[pos - 1];
+        pos--;
+    }
+
+    p_list->device_id[pos] = index;
+    p_list->count++;
+}
+
+
+/**@brief Function for removing a device from a list of device instances, if present.
+ *
+ * @param[in] p_list List of device instances.
+ * @param[in] index  Device identifier.
+ */
+static void bond_list_remove(bond_list_t * p_list, uint32_t index)
+{
+    for (uint32_t pos = 0; pos < p_list->count; pos++)
+    {
+        if (p_list->device_id[pos] == index)
+        {
+            p_list->count--;
+            memmove(&p_list->device_id[pos],
+                    &p_list->device_id[pos + 1],
+                    p_list->count - pos);
+            break;
+        }
+    }
+}
+
+
+/**@brief Function for bringing the lookup indices and whitelist candidates in line with the peer
+ *        table entry of the device identified by 'index'.
+ *
+ * @details Must be called whenever the identification information of a device instance is
+ *          allocated, modified or freed.
+ *
+ * @param[in] index Device identifier.
+ */
+static void peer_index_update(uint32_t index)
+{
+    peer_id_t const * p_peer = &m_peer_table[index];
+    uint8_t           key[BOND_INDEX_KEY_LEN];
+
+    bond_index_remove(&m_addr_index, index);
+    bond_index_remove(&m_ediv_index, index);
+    bond_list_remove(&m_whitelist_addr_list, index);
+    bond_list_remove(&m_whitelist_irk_list, index);
+
+    if (p_peer->id_bitmap == UNASSIGNED)
+    {
+        bond_bit_clear(m_peer_assigned, index);
+        return;
+    }
+
+    bond_bit_set(m_peer_assigned, index);
+
+    if (p_peer->peer_id.id_addr_info.addr_type != INVALID_ADDR_TYPE)
+    {
+        addr_key_make(&p_peer->peer_id.id_addr_info, key);
+        bond_index_insert(&m_addr_index, key, index);
+    }
+
+    if (p_peer->ediv != EDIV_INIT_VAL)
+    {
+        ediv_key_make(p_peer->ediv, key);
+        bond_index_insert(&m_ediv_index, key, index);
+    }
+
+    if ((p_peer->id_bitmap & ADDR_ENTRY) == 0)
+    {
+        bond_list_insert(&m_whitelist_addr_list, index);
+    }
+
+    if ((p_peer->id_bitmap & IRK_ENTRY) == 0)
+    {
+        bond_list_insert(&m_whitelist_irk_list, index);
+    }
+}
+
+
+/**@brief Function for comparing the stored fields of two peer identification entries.
+ *
+ * @param[in] p_a First entry.
+ * @param[in] p_b Second entry.
+ *
+ * @retval true if the entries hold the same identification information, false otherwise.
+ */
+static bool peer_id_is_equal(peer_id_t const * p_a, peer_id_t const * p_b)
+{
+    return ((p_a->id_bitmap                       == p_b->id_bitmap)                       &&
+            (p_a->ediv                            == p_b->ediv)                            &&
+            (p_a->peer_id.id_addr_info.addr_type  == p_b->peer_id.id_addr_info.addr_type)  &&
+            (memcmp(p_a->peer_id.id_addr_info.addr,
+                    p_b->peer_id.id_addr_info.addr,
+                    BLE_GAP_ADDR_LEN) == 0)                                                &&
+            (memcmp(p_a->peer_id.id_info.irk,
+                    p_b->peer_id.id_info.irk,
+                    BLE_GAP_SEC_KEY_LEN) == 0));
 }
 
 
@@ -634,6 +944,10 @@ static __INLINE void peer_instance_init(uint32_t index)
 
     //Reset the status bit.
     update_status_bit_reset(index);
+    bond_bit_clear(m_peer_id_dirty, index);
+
+    //Remove the instance from the lookup indices.
+    peer_index_update(index);
 
 #if (DEVICE_MANAGER_APP_CONTEXT_SIZE != 0)
     //Initialize the application context for bond device.
@@ -702,45 +1016,48 @@ static ret_code_t connection_instance_find(uint16_t   conn_handle,
 static __INLINE ret_code_t device_instance_allocate(uint8_t *              p_device_index,
                                                     ble_gap_addr_t const * p_addr)
 {
-    ret_code_t err_code;
-    uint32_t   index;
+    uint32_t index;
 
-    err_code = DM_DEVICE_CONTEXT_FULL;
-
-    for (index = 0; index < DEVICE_MANAGER_MAX_BONDS; index++)
+    //Skip words in which all device instances are allocated.
+    for (index = 0; index < DEVICE_MANAGER_MAX_BONDS; index += 32)
     {
-        DM_TRC("[DM]:[DI 0x%02X]: Device type 0x%02X.\r\n",
-               index, m_peer_table[index].peer_id.id_addr_info.addr_type);
-        DM_TRC("[DM]: Device Addr 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X.\r\n",
-               m_peer_table[index].peer_id.id_addr_info.addr[0],
-               m_peer_table[index].peer_id.id_addr_info.addr[1],
-               m_peer_table[index].peer_id.id_addr_info.addr[2],
-               m_peer_table[index].peer_id.id_addr_info.addr[3],
-               m_peer_table[index].peer_id.id_addr_info.addr[4],
-               m_peer_table[index].peer_id.id_addr_info.addr[5]);
-
-        if (m_peer_table[index].id_bitmap == UNASSIGNED)
+        if (m_peer_assigned[index >> 5] != 0xFFFFFFFF)
         {
-            if (p_addr->addr_type != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
-            {
-                m_peer_table[index].id_bitmap            &= (~ADDR_ENTRY);
-                m_peer_table[index].peer_id.id_addr_info  = (*p_addr);
-            }
-            else
-            {
-                m_peer_table[index].id_bitmap &= (~IRK_ENTRY);
-            }
-
-            (*p_device_index) = index;
-            err_code          = NRF_SUCCESS;
+            break;
+        }
+    }
 
-            DM_LOG("[DM]: Allocated device instance 0x%02X\r\n", index);
-            
+    for (; index < DEVICE_MANAGER_MAX_BONDS; index++)
+    {
+        if (!bond_bit_is_set(m_peer_assigned, index))
+        {
             break;
         }
     }
 
-    return err_code;
+    if (index >= DEVICE_MANAGER_MAX_BONDS)
+    {
+        return DM_DEVICE_CONTEXT_FULL;
+    }
+
+    if (p_addr->addr_type != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
+    {
+        m_peer_table[index].id_bitmap            &= (~ADDR_ENTRY);
+        m_peer_table[index].peer_id.id_addr_info  = (*p_addr);
+    }
+    else
+    {
+        m_peer_table[index].id_bitmap &= (~IRK_ENTRY);
+    }
+
+    bond_bit_set(m_peer_id_dirty, index);
+    peer_index_update(index);
+
+    (*p_device_index) = index;
+
+    DM_LOG("[DM]: Allocated device instance 0x%02X\r\n", index);
+
+    return NRF_SUCCESS;
 }
 
 
@@ -777,8 +1094,12 @@ static __INLINE ret_code_t device_instance_free(uint32_t device_index)
 
 /**@brief Function for searching for the device in the bonded device list.
  *
- * @param[in]  p_addr         Peer identification information.
+ * @details The device is looked up on address when 'p_addr' is provided, otherwise on the
+ *          encrypted diversifier.
+ *
+ * @param[in]  p_addr         Peer identification information, or NULL.
  * @param[out] p_device_index Device index.
+ * @param[in]  ediv           Encrypted diversifier, used when 'p_addr' is NULL.
  *
  * @retval NRF_SUCCESS         Operation success.
  * @retval NRF_ERROR_NOT_FOUND Operation failure.
@@ -786,10 +1107,8 @@ static __INLINE ret_code_t device_instance_free(uint32_t device_index)
 static ret_code_t device_instance_find(ble_gap_addr_t const * p_addr, uint32_t * p_device_index, uint16_t ediv)
 {
     ret_code_t err_code;
-    uint32_t   index;
+    uint8_t    key[BOND_INDEX_KEY_LEN];
 
-    err_code = NRF_ERROR_NOT_FOUND;
-    
     if (NULL != p_addr)
     {
         DM_TRC("[DM]: Searching for device 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X.\r\n",
@@ -799,30 +1118,21 @@ static ret_code_t device_instance_find(ble_gap_addr_t const * p_addr, uint32_t *
                p_addr->addr[3],
                p_addr->addr[4],
                p_addr->addr[5]);
-    }
 
-    for (index = 0; index < DEVICE_MANAGER_MAX_BONDS; index++)
+        addr_key_make(p_addr, key);
+        err_code = bond_index_find(&m_addr_index, key, p_device_index);
+    }
+    else
     {
-        DM_TRC("[DM]:[DI 0x%02X]: Device type 0x%02X.\r\n",
-               index, m_peer_table[index].peer_id.id_addr_info.addr_type);
-        DM_TRC("[DM]: Device Addr 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X.\r\n",
-               m_peer_table[index].peer_id.id_addr_info.addr[0],
-               m_peer_table[index].peer_id.id_addr_info.addr[1],
-               m_peer_table[index].peer_id.id_addr_info.addr[2],
-               m_peer_table[index].peer_id.id_addr_info.addr[3],
-               m_peer_table[index].peer_id.id_addr_info.addr[4],
-               m_peer_table[index].peer_id.id_addr_info.addr[5]);
-
-        if (((NULL == p_addr) && (ediv == m_peer_table[index].ediv)) ||
-            ((NULL != p_addr) && (memcmp(&m_peer_table[index].peer_id.id_addr_info, p_addr, sizeof(ble_gap_addr_t)) == 0)))
-        {
-            DM_LOG("[DM]: Found device at instance 0x%02X\r\n", index);
+        DM_TRC("[DM]: Searching for device with EDIV 0x%04X.\r\n", ediv);
 
-            (*p_device_index) = index;
-            err_code          = NRF_SUCCESS;
+        ediv_key_make(ediv, key);
+        err_code = bond_index_find(&m_ediv_index, key, p_device_index);
+    }
 
-            break;
-        }
+    if (err_code == NRF_SUCCESS)
+    {
+        DM_LOG("[DM]: Found device at instance 0x%02X\r\n", (*p_device_index));
     }
 
     return err_code;
@@ -943,9 +1253,9 @@ static __INLINE void device_context_store(dm_handle_t const * p_handle, device_s
 
     if (err_code == NRF_SUCCESS)
     {
-        if ((STATE_BOND_INFO_UPDATE ==
-             (m_connection_table[p_handle->connection_id].state & STATE_BOND_INFO_UPDATE)) ||
-            (state == UPDATE_PEER_ADDR))
+        if ((state == UPDATE_PEER_ADDR) ||
+            (STATE_BOND_INFO_UPDATE ==
+             (m_connection_table[p_handle->connection_id].state & STATE_BOND_INFO_UPDATE)))
         {
             DM_LOG("[DM]:[DI %02X]:[CI %02X]: -> Updating bonding information.\r\n",
                    p_handle->device_id, p_handle->connection_id);
@@ -968,11 +1278,20 @@ static __INLINE void device_context_store(dm_handle_t const * p_handle, device_s
             store_fn = storage_operation_dummy_handler;
         }
 
-        //Store the peer id.
-        err_code = store_fn(&block_handle,
-                            (uint8_t *)&m_peer_table[p_handle->device_id],
-                            PEER_ID_SIZE,
-                            PEER_ID_STORAGE_OFFSET);
+        //Store the peer id, only if it has changed since it was last written.
+        if ((store_fn != storage_operation_dummy_handler) &&
+            bond_bit_is_set(m_peer_id_dirty, p_handle->device_id))
+        {
+            err_code = store_fn(&block_handle,
+                                (uint8_t *)&m_peer_table[p_handle->device_id],
+                                PEER_ID_SIZE,
+                                PEER_ID_STORAGE_OFFSET);
+
+            if (err_code == NRF_SUCCESS)
+            {
+                bond_bit_clear(m_peer_id_dirty, p_handle->device_id);
+            }
+        }
 
         if ((err_code == NRF_SUCCESS) && (state != UPDATE_PEER_ADDR))
         {
@@ -1431,7 +1750,6 @@ static void dm_pstorage_cb_handler(pstorage_handle_t * p_handle,
     dm_event_t        dm_event;
     dm_handle_t       dm_handle;
     dm_context_t      context_data;
-    pstorage_handle_t block_handle;
     uint32_t          index_count;
     uint32_t          err_code;
 
@@ -1449,17 +1767,16 @@ static void dm_pstorage_cb_handler(pstorage_handle_t * p_handle,
     context_data.p_data = p_data;
     context_data.len    = data_len;
 
-    for (uint32_t index = 0; index < DEVICE_MANAGER_MAX_BONDS; index++)
+    //Blocks are allocated contiguously, derive the device instance from the block offset.
+    if ((p_handle->module_id == m_storage_handle.module_id) &&
+        (p_handle->block_id >= m_storage_handle.block_id))
     {
-        err_code = pstorage_block_identifier_get(&m_storage_handle, index, &block_handle);
-        if ((err_code == NRF_SUCCESS) &&
-            (
-                (memcmp(p_handle, &block_handle, sizeof(pstorage_handle_t)) == 0)
-            )
-           )
+        index_count = p_handle->block_id - m_storage_handle.block_id;
+
+        if (((index_count % ALL_CONTEXT_SIZE) == 0) &&
+            ((index_count / ALL_CONTEXT_SIZE) < DEVICE_MANAGER_MAX_BONDS))
         {
-            dm_handle.device_id = index;
-            break;
+            dm_handle.device_id = index_count / ALL_CONTEXT_SIZE;
         }
     }
 
@@ -1657,6 +1974,11 @@ ret_code_t dm_init(dm_init_param_t const * const p_init_param)
 
     memset(m_gatts_table, 0, sizeof(m_gatts_table));
 
+    memset(&m_addr_index, 0, sizeof(m_addr_index));
+    memset(&m_ediv_index, 0, sizeof(m_ediv_index));
+    memset(&m_whitelist_addr_list, 0, sizeof(m_whitelist_addr_list));
+    memset(&m_whitelist_irk_list, 0, sizeof(m_whitelist_irk_list));
+
     //Initialization of all device instances.
     for (index = 0; index < DEVICE_MANAGER_MAX_BONDS; index++)
     {
@@ -1712,6 +2034,8 @@ ret_code_t dm_init(dm_init_param_t const * const p_init_param)
                     }
                     else
                     {
+                        peer_index_update(index);
+
                         DM_TRC("[DM]:[DI 0x%02X]: Device type 0x%02X.\r\n",
                                index,
                                m_peer_table[index].peer_id.id_addr_info.addr_type);
@@ -1881,38 +2205,45 @@ ret_code_t dm_whitelist_create(dm_application_instance_t const * p_handle,
 
     uint32_t addr_count = 0;
     uint32_t irk_count  = 0;
-    bool     connected  = false;
+    uint32_t connected[BOND_BITMAP_WORDS];
+    uint32_t index;
 
-    for (uint32_t index = 0; index < DEVICE_MANAGER_MAX_BONDS; index++)
-    {
-        connected = false;
+    //Devices that are currently connected are not part of the whitelist.
+    memset(connected, 0, sizeof(connected));
 
-        for (uint32_t c_index = 0; c_index < DEVICE_MANAGER_MAX_CONNECTIONS; c_index++)
+    for (uint32_t c_index = 0; c_index < DEVICE_MANAGER_MAX_CONNECTIONS; c_index++)
+    {
+        if ((m_connection_table[c_index].bonded_dev_id != DM_INVALID_ID) &&
+            ((m_connection_table[c_index].state & STATE_CONNECTED) == STATE_CONNECTED))
         {
-            if ((index == m_connection_table[c_index].bonded_dev_id) &&
-                ((m_connection_table[c_index].state & STATE_CONNECTED) == STATE_CONNECTED))
-            {
-                connected = true;
-                break;
-            }
+            bond_bit_set(connected, m_connection_table[c_index].bonded_dev_id);
         }
+    }
 
-        if (connected == false)
+    for (uint32_t pos = 0;
+         (pos < m_whitelist_irk_list.count) && (irk_count < p_whitelist->irk_count);
+         pos++)
+    {
+        index = m_whitelist_irk_list.device_id[pos];
+
+        if (!bond_bit_is_set(connected, index))
         {
-            if ((irk_count < p_whitelist->irk_count) &&
-                ((m_peer_table[index].id_bitmap & IRK_ENTRY) == 0))
-            {
-                p_whitelist->pp_irks[irk_count] = &m_peer_table[index].peer_id.id_info;
-                m_irk_index_table[irk_count]    = index;
-                irk_count++;
-            }
+            p_whitelist->pp_irks[irk_count] = &m_peer_table[index].peer_id.id_info;
+            m_irk_index_table[irk_count]    = index;
+            irk_count++;
+        }
+    }
 
-            if ((addr_count < p_whitelist->addr_count) &&
-                (m_peer_table[index].id_bitmap & ADDR_ENTRY) == 0)
-            {
-                p_whitelist->pp_addrs[addr_count] = &m_peer_table[index].peer_id.id_addr_info;
-                addr_count++;
-            }
+    for (uint32_t pos = 0;
+         (pos < m_whitelist_addr_list.count) && (addr_count < p_whitelist->addr_count);
+         pos++)
+    {
+        index = m_whitelist_addr_list.device_id[pos];
+
+        if (!bond_bit_is_set(connected, index))
+        {
+            p_whitelist->pp_addrs[addr_count] = &m_peer_table[index].peer_id.id_addr_info;
+            addr_count++;
         }
     }
 
@@ -2344,6 +2675,8 @@ ret_code_t dm_peer_addr_set(dm_handle_t const    * p_handle,
         (p_addr->addr_type != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE))
     {
         m_peer_table[p_handle->device_id].peer_id.id_addr_info = (*p_addr);
+        bond_bit_set(m_peer_id_dirty, p_handle->device_id);
+        peer_index_update(p_handle->device_id);
         update_status_bit_set(p_handle->device_id);
         device_context_store(p_handle, UPDATE_PEER_ADDR);
         err_code = NRF_SUCCESS;
@@ -2716,7 +3049,7 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
                        p_ble_evt->evt.gap_evt.params.sec_params_request.peer_params.bond);
 
                 keys_exchanged.keys_peer.p_enc_key  = NULL;
-                keys_exchanged.keys_peer.p_id_key   = &m_peer_table[m_connection_table[index].bonded_dev_id].peer_id; 
+                keys_exchanged.keys_peer.p_id_key   = NULL;
                 keys_exchanged.keys_peer.p_sign_key = NULL;
                 keys_exchanged.keys_peer.p_pk       = NULL;
                 keys_exchanged.keys_own.p_enc_key   = &m_bond_table[index].peer_enc_key;
@@ -2724,6 +3057,13 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
                 keys_exchanged.keys_own.p_sign_key  = NULL;
                 keys_exchanged.keys_own.p_pk        = NULL;
 
+                //Without a device instance, the peer keys are not kept.
+                if (m_connection_table[index].bonded_dev_id != DM_INVALID_ID)
+                {
+                    keys_exchanged.keys_peer.p_id_key =
+                        &m_peer_table[m_connection_table[index].bonded_dev_id].peer_id;
+                }
+
                 err_code = sd_ble_gap_sec_params_reply(p_ble_evt->evt.gap_evt.conn_handle,
                                                        BLE_GAP_SEC_STATUS_SUCCESS,
                                                        &m_application_table[0].sec_param, 
@@ -2792,6 +3132,8 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
                 {
                     if (handle.device_id != DM_INVALID_ID)
                     {
+                        peer_id_t peer_before = m_peer_table[handle.device_id];
+
                         m_connection_table[index].state |= STATE_BONDED;
 
                         //IRK and/or public address is shared, update it.
@@ -2823,6 +3165,13 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
                                 m_peer_table[handle.device_id].id_bitmap &= (~IRK_ENTRY);
                             }
 
+                            //Only write the peer identification again if bonding changed it.
+                            if (!peer_id_is_equal(&peer_before, &m_peer_table[handle.device_id]))
+                            {
+                                bond_bit_set(m_peer_id_dirty, handle.device_id);
+                                peer_index_update(handle.device_id);
+                            }
+
                             device_context_store(&handle, FIRST_BOND_STORE);
                         }
                     }
@@ -30,6 +30,20 @@
 #define IM_ADDR_CLEARTEXT_LENGTH    3
 #define IM_ADDR_CIPHERTEXT_LENGTH   3
 
+#ifndef IM_PEER_CACHE_SIZE
+#define IM_PEER_CACHE_SIZE          16  /**< Number of bonded peers whose identity is kept in RAM. */
+#endif
+
+#ifndef IM_RPA_CACHE_SIZE
+#define IM_RPA_CACHE_SIZE           4   /**< Number of recently resolved private addresses kept in RAM. */
+#endif
+
+#ifndef IM_ECB_BLOCK_ENCRYPT
+/**@brief AES-128 block encryption used for address resolution. Can be replaced by a software
+ *        implementation when building for a host. */
+#define IM_ECB_BLOCK_ENCRYPT(p_ecb_data) sd_ecb_block_encrypt(p_ecb_data)
+#endif
+
 typedef struct
 {
     pm_peer_id_t   peer_id;
@@ -37,6 +51,24 @@ typedef struct
     ble_gap_addr_t peer_address;
 } im_connection_t;
 
+/**@brief Identity of a bonded peer, cached so that connections can be matched without reading
+ *        flash. */
+typedef struct
+{
+    pm_peer_id_t   peer_id;                         /**< PM_PEER_ID_INVALID if the entry is unused. */
+    bool           irk_valid;                       /**< Whether the peer distributed a valid IRK. */
+    ble_gap_addr_t id_addr;                         /**< Identity address of the peer. */
+    uint8_t        ecb_key[SOC_ECB_KEY_LENGTH];     /**< IRK of the peer, byte-reversed for the ECB. */
+} im_peer_cache_entry_t;
+
+/**@brief Resolvable private address that was recently resolved. */
+typedef struct
+{
+    pm_peer_id_t peer_id;                           /**< PM_PEER_ID_INVALID if the entry is unused. */
+    uint8_t      addr[BLE_GAP_ADDR_LEN];            /**< The resolvable private address. */
+    uint32_t     last_used;                         /**< Value of rpa_cache_tick at last use. */
+} im_rpa_cache_entry_t;
+
 typedef struct
 {
     im_evt_handler_t              evt_handlers[MAX_REGISTRANTS];
@@ -47,6 +79,11 @@ typedef struct
     ble_gap_addr_t                whitelist_addrs[BLE_GAP_WHITELIST_ADDR_MAX_COUNT];
     uint8_t                       n_irk_whitelist_peer_ids;
     ble_conn_state_user_flag_id_t conn_state_user_flag_id;
+    im_peer_cache_entry_t         peer_cache[IM_PEER_CACHE_SIZE];
+    bool                          peer_cache_loaded;    /**< Whether peer_cache reflects flash. */
+    bool                          peer_cache_complete;  /**< Whether all bonded peers fit in peer_cache. */
+    im_rpa_cache_entry_t          rpa_cache[IM_RPA_CACHE_SIZE];
+    uint32_t                      rpa_cache_tick;
 } im_t;
 
 static im_t m_im = {.n_registrants = 0};
@@ -64,6 +101,11 @@ static void internal_state_reset()
     {
         m_im.connections[i].conn_handle = BLE_CONN_HANDLE_INVALID;
     }
+    for (uint32_t i = 0; i < IM_RPA_CACHE_SIZE; i++)
+    {
+        m_im.rpa_cache[i].peer_id = PM_PEER_ID_INVALID;
+    }
+    m_im.peer_cache_loaded = false;
 }
 
 
@@ -210,9 +252,301 @@ bool addr_compare(ble_gap_addr_t const * p_addr1, ble_gap_addr_t const * p_addr2
 }
 
 
+/**@brief Function for finding the cache entry of a peer.
+ *
+ * @param[in] peer_id  The peer to look for.
+ *
+ * @return The entry, or NULL if the peer is not cached.
+ */
+static im_peer_cache_entry_t * peer_cache_entry_find(pm_peer_id_t peer_id)
+{
+    for (uint32_t i = 0; i < IM_PEER_CACHE_SIZE; i++)
+    {
+        if (m_im.peer_cache[i].peer_id == peer_id)
+        {
+            return &m_im.peer_cache[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for caching the identity of a peer from its bonding data in flash.
+ *
+ * @details Uses the peer's existing entry if it has one, otherwise a free entry. If the peer has
+ *          no bonding data, its entry is freed. If there is no free entry the cache is marked as
+ *          incomplete.
+ *
+ * @param[in] peer_id  The peer to cache.
+ */
+static void peer_cache_entry_load(pm_peer_id_t peer_id)
+{
+    pm_peer_data_flash_t    bonding_data;
+    im_peer_cache_entry_t * p_entry = peer_cache_entry_find(peer_id);
+    ret_code_t              err_code;
+
+    err_code = pdb_read_buf_get(peer_id, PM_PEER_DATA_ID_BONDING, &bonding_data, NULL);
+    if (err_code != NRF_SUCCESS)
+    {
+        if (p_entry != NULL)
+        {
+            p_entry->peer_id = PM_PEER_ID_INVALID;
+        }
+        return;
+    }
+
+    if (p_entry == NULL)
+    {
+        p_entry = peer_cache_entry_find(PM_PEER_ID_INVALID);
+        if (p_entry == NULL)
+        {
+            m_im.peer_cache_complete = false;
+            return;
+        }
+    }
+
+    ble_gap_id_key_t const * p_peer_id_key = &bonding_data.p_bonding_data->peer_id;
+
+    p_entry->peer_id   = peer_id;
+    p_entry->id_addr   = p_peer_id_key->id_addr_info;
+    p_entry->irk_valid = is_valid_irk(&p_peer_id_key->id_info);
+    for (uint32_t i = 0; i < SOC_ECB_KEY_LENGTH; i++)
+    {
+        p_entry->ecb_key[i] = p_peer_id_key->id_info.irk[SOC_ECB_KEY_LENGTH - 1 - i];
+    }
+}
+
+
+/**@brief Function for filling the peer cache with all bonded peers. */
+static void peer_cache_load(void)
+{
+    for (uint32_t i = 0; i < IM_PEER_CACHE_SIZE; i++)
+    {
+        m_im.peer_cache[i].peer_id = PM_PEER_ID_INVALID;
+    }
+    m_im.peer_cache_complete = true;
+
+    pm_peer_id_t peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
+    while (peer_id != PM_PEER_ID_INVALID)
+    {
+        peer_cache_entry_load(peer_id);
+        peer_id = pdb_next_peer_id_get(peer_id);
+    }
+
+    m_im.peer_cache_loaded = true;
+}
+
+
+/**@brief Function for forgetting all resolved addresses of a peer.
+ *
+ * @param[in] peer_id  The peer, or PM_PEER_ID_INVALID to forget all addresses.
+ */
+static void rpa_cache_remove(pm_peer_id_t peer_id)
+{
+    for (uint32_t i = 0; i < IM_RPA_CACHE_SIZE; i++)
+    {
+        if ((peer_id == PM_PEER_ID_INVALID) || (m_im.rpa_cache[i].peer_id == peer_id))
+        {
+            m_im.rpa_cache[i].peer_id = PM_PEER_ID_INVALID;
+        }
+    }
+}
+
+
+/**@brief Function for looking up a recently resolved address.
+ *
+ * @param[in] p_addr  Resolvable private address.
+ *
+ * @return The peer the address was resolved to, or PM_PEER_ID_INVALID.
+ */
+static pm_peer_id_t rpa_cache_find(ble_gap_addr_t const * p_addr)
+{
+    for (uint32_t i = 0; i < IM_RPA_CACHE_SIZE; i++)
+    {
+        if (   (m_im.rpa_cache[i].peer_id != PM_PEER_ID_INVALID)
+            && (memcmp(m_im.rpa_cache[i].addr, p_addr->addr, BLE_GAP_ADDR_LEN) == 0))
+        {
+            m_im.rpa_cache[i].last_used = ++m_im.rpa_cache_tick;
+            return m_im.rpa_cache[i].peer_id;
+        }
+    }
+    return PM_PEER_ID_INVALID;
+}
+
+
+/**@brief Function for remembering a resolved address, replacing the least recently used one.
+ *
+ * @param[in] p_addr   Resolvable private address.
+ * @param[in] peer_id  The peer the address was resolved to.
+ */
+static void rpa_cache_add(ble_gap_addr_t const * p_addr, pm_peer_id_t peer_id)
+{
+    im_rpa_cache_entry_t * p_entry = &m_im.rpa_cache[0];
+
+    for (uint32_t i = 0; i < IM_RPA_CACHE_SIZE; i++)
+    {
+        if (m_im.rpa_cache[i].peer_id == PM_PEER_ID_INVALID)
+        {
+            p_entry = &m_im.rpa_cache[i];
+            break;
+        }
+        if ((int32_t)(m_im.rpa_cache[i].last_used - p_entry->last_used) < 0)
+        {
+            p_entry = &m_im.rpa_cache[i];
+        }
+    }
+
+    p_entry->peer_id   = peer_id;
+    p_entry->last_used = ++m_im.rpa_cache_tick;
+    memcpy(p_entry->addr, p_addr->addr, BLE_GAP_ADDR_LEN);
+}
+
+
+/**@brief Function for resolving an address against all cached IRKs.
+ *
+ * @details Same computation as @ref im_address_resolve, but the cleartext and expected
+ *          ciphertext are prepared once, and the keys are already byte-reversed.
+ *
+ * @param[in] p_addr  Resolvable private address.
+ *
+ * @return The matching peer, or PM_PEER_ID_INVALID.
+ */
+static pm_peer_id_t peer_cache_address_resolve(ble_gap_addr_t const * p_addr)
+{
+    nrf_ecb_hal_data_t ecb_hal_data;
+    ret_code_t         err_code;
+
+    memset(ecb_hal_data.cleartext, 0, SOC_ECB_KEY_LENGTH - IM_ADDR_CLEARTEXT_LENGTH);
+    for (uint32_t i = 0; i < IM_ADDR_CLEARTEXT_LENGTH; i++)
+    {
+        ecb_hal_data.cleartext[SOC_ECB_KEY_LENGTH - 1 - i] = p_addr->addr[IM_ADDR_CIPHERTEXT_LENGTH + i];
+    }
+
+    for (uint32_t i = 0; i < IM_PEER_CACHE_SIZE; i++)
+    {
+        im_peer_cache_entry_t const * p_entry = &m_im.peer_cache[i];
+        uint32_t                      j;
+
+        if ((p_entry->peer_id == PM_PEER_ID_INVALID) || !p_entry->irk_valid)
+        {
+            continue;
+        }
+
+        memcpy(ecb_hal_data.key, p_entry->ecb_key, SOC_ECB_KEY_LENGTH);
+        err_code = IM_ECB_BLOCK_ENCRYPT(&ecb_hal_data); // Can only return NRF_SUCCESS.
+        UNUSED_VARIABLE(err_code);
+
+        for (j = 0; j < IM_ADDR_CIPHERTEXT_LENGTH; j++)
+        {
+            if (ecb_hal_data.ciphertext[SOC_ECB_KEY_LENGTH - 1 - j] != p_addr->addr[j])
+            {
+                break;
+            }
+        }
+        if (j == IM_ADDR_CIPHERTEXT_LENGTH)
+        {
+            return p_entry->peer_id;
+        }
+    }
+    return PM_PEER_ID_INVALID;
+}
+
+
+/**@brief Function for searching the bonding data in flash of peers that are not cached.
+ *
+ * @param[in] p_addr  Public, static or resolvable private address.
+ *
+ * @return The matching peer, or PM_PEER_ID_INVALID.
+ */
+static pm_peer_id_t uncached_peer_find(ble_gap_addr_t const * p_addr)
+{
+    pm_peer_id_t compared_peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
+    while (compared_peer_id != PM_PEER_ID_INVALID)
+    {
+        pm_peer_data_flash_t compared_data;
+
+        if (   (peer_cache_entry_find(compared_peer_id) == NULL)
+            && (pdb_read_buf_get(compared_peer_id,
+                                 PM_PEER_DATA_ID_BONDING,
+                                 &compared_data,
+                                 NULL) == NRF_SUCCESS))
+        {
+            if (p_addr->addr_type == BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
+            {
+                if (im_address_resolve(p_addr, &compared_data.p_bonding_data->peer_id.id_info))
+                {
+                    return compared_peer_id;
+                }
+            }
+            else if (addr_compare(p_addr, &compared_data.p_bonding_data->peer_id.id_addr_info))
+            {
+                return compared_peer_id;
+            }
+        }
+        compared_peer_id = pdb_next_peer_id_get(compared_peer_id);
+    }
+    return PM_PEER_ID_INVALID;
+}
+
+
+/**@brief Function for finding the bonded peer that uses an address.
+ *
+ * @details Resolvable private addresses are first looked up among the recently resolved ones,
+ *          then resolved against the cached IRKs. Flash is only read for peers that did not fit
+ *          in the cache.
+ *
+ * @param[in] p_addr  Address of the peer. Must not be a non-resolvable private address.
+ *
+ * @return The matching peer, or PM_PEER_ID_INVALID.
+ */
+static pm_peer_id_t bonded_peer_find(ble_gap_addr_t const * p_addr)
+{
+    pm_peer_id_t peer_id = PM_PEER_ID_INVALID;
+
+    if (!m_im.peer_cache_loaded)
+    {
+        peer_cache_load();
+    }
+
+    if (p_addr->addr_type == BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
+    {
+        peer_id = rpa_cache_find(p_addr);
+        if (peer_id != PM_PEER_ID_INVALID)
+        {
+            return peer_id;
+        }
+        peer_id = peer_cache_address_resolve(p_addr);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < IM_PEER_CACHE_SIZE; i++)
+        {
+            if (   (m_im.peer_cache[i].peer_id != PM_PEER_ID_INVALID)
+                && addr_compare(p_addr, &m_im.peer_cache[i].id_addr))
+            {
+                peer_id = m_im.peer_cache[i].peer_id;
+                break;
+            }
+        }
+    }
+
+    if ((peer_id == PM_PEER_ID_INVALID) && !m_im.peer_cache_complete)
+    {
+        peer_id = uncached_peer_find(p_addr);
+    }
+
+    if (   (peer_id != PM_PEER_ID_INVALID)
+        && (p_addr->addr_type == BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE))
+    {
+        rpa_cache_add(p_addr, peer_id);
+    }
+
+    return peer_id;
+}
+
+
 void im_ble_evt_handler(ble_evt_t * ble_evt)
 {
-    ret_code_t err_code;
     switch (ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_CONNECTED:
@@ -228,57 +562,13 @@ void im_ble_evt_handler(ble_evt_t * ble_evt)
             else if (   ble_evt->evt.gap_evt.params.connected.peer_addr.addr_type
                      != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE)
             {
-                /* Search the database for bonding data matching the one that triggered the event.
+                /* Search the bonded peers for one matching the address that triggered the event.
                  * Public and static addresses can be matched on address alone, while resolvable
                  * random addresses can be resolved agains known IRKs. Non-resolvable random addresses
                  * are never matching because they are not longterm form of identification.
                  */
-                pm_peer_id_t compared_peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
-                while (   (compared_peer_id        != PM_PEER_ID_INVALID)
-                       && (bonded_matching_peer_id == PM_PEER_ID_INVALID))
-                {
-                    pm_peer_data_flash_t compared_data;
-                    switch (ble_evt->evt.gap_evt.params.connected.peer_addr.addr_type)
-                    {
-                        case BLE_GAP_ADDR_TYPE_PUBLIC:
-                            /* fall-through */
-                        case BLE_GAP_ADDR_TYPE_RANDOM_STATIC:
-                            err_code = pdb_read_buf_get(compared_peer_id,
-                                                        PM_PEER_DATA_ID_BONDING,
-                                                        &compared_data,
-                                                        NULL);
-                            if ((err_code == NRF_SUCCESS) &&
-                                addr_compare(&ble_evt->evt.gap_evt.params.connected.peer_addr,
-                                             &compared_data.p_bonding_data->peer_id.id_addr_info)
-                            )
-                            {
-                                bonded_matching_peer_id = compared_peer_id;
-                            }
-                            break;
-
-                        case BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE:
-                            err_code = pdb_read_buf_get(compared_peer_id,
-                                                        PM_PEER_DATA_ID_BONDING,
-                                                        &compared_data,
-                                                        NULL);
-                            if (err_code == NRF_SUCCESS &&
-                                im_address_resolve(&ble_evt->evt.gap_evt.params.connected.peer_addr,
-                                                   &compared_data.p_bonding_data->peer_id.id_info)
-                            )
-                            {
-                                bonded_matching_peer_id = compared_peer_id;
-                            }
-                            break;
-
-                        case BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE:
-                            // Should not happen.
-                            break;
-
-                        default:
-                            break;
-                    }
-                    compared_peer_id = pdb_next_peer_id_get(compared_peer_id);
-                }
+                bonded_matching_peer_id
+                        = bonded_peer_find(&ble_evt->evt.gap_evt.params.connected.peer_addr);
             }
             uint8_t new_index = new_connection(ble_evt->evt.gap_evt.conn_handle, &ble_evt->evt.gap_evt.params.connected.peer_addr);
             UNUSED_VARIABLE(new_index);
@@ -329,6 +619,45 @@ bool is_duplicate_bonding_data(pm_peer_data_bonding_t const * p_bonding_data1,
 static void pdb_evt_handler(pdb_evt_t const * p_event)
 {
     ret_code_t err_code;
+
+    if ((p_event != NULL) && m_im.peer_cache_loaded)
+    {
+        // Keep the cached identities in sync with flash.
+        switch (p_event->evt_id)
+        {
+            case PDB_EVT_WRITE_BUF_STORED:
+                /* fall-through */
+            case PDB_EVT_RAW_STORED:
+                /* fall-through */
+            case PDB_EVT_CLEARED:
+                if (p_event->data_id == PM_PEER_DATA_ID_BONDING)
+                {
+                    rpa_cache_remove(p_event->peer_id);
+                    peer_cache_entry_load(p_event->peer_id);
+                }
+                break;
+
+            case PDB_EVT_PEER_FREED:
+            {
+                im_peer_cache_entry_t * p_entry = peer_cache_entry_find(p_event->peer_id);
+                rpa_cache_remove(p_event->peer_id);
+                if (p_entry != NULL)
+                {
+                    p_entry->peer_id = PM_PEER_ID_INVALID;
+                }
+                if (!m_im.peer_cache_complete)
+                {
+                    // A free entry is now available for a peer that did not fit.
+                    m_im.peer_cache_loaded = false;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
     if ((p_event != NULL) && (p_event->evt_id == PDB_EVT_WRITE_BUF_STORED))
     {
         // If new data about peer id has been stored it is compared to other peers peer ids in
@@ -704,7 +1033,7 @@ void ah(uint8_t const * p_k, uint8_t const * p_r, uint8_t * p_local_hash)
         ecb_hal_data.cleartext[SOC_ECB_KEY_LENGTH - 1 - i] = p_r[i];
     }
 
-    err_code = sd_ecb_block_encrypt(&ecb_hal_data); // Can only return NRF_SUCCESS.
+    err_code = IM_ECB_BLOCK_ENCRYPT(&ecb_hal_data); // Can only return NRF_SUCCESS.
     UNUSED_VARIABLE(err_code);
 
     for (uint32_t i = 0; i < IM_ADDR_CIPHERTEXT_LENGTH; i++)
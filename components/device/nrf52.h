@@ -754,7 +754,8 @@ typedef struct {                                    /*!< UARTE Structure
   __I  uint32_t  RESERVED1[52];
   __IO uint32_t  EVENTS_CTS;                        /*!< CTS is activated (set low). Clear To Send.                            */
   __IO uint32_t  EVENTS_NCTS;                       /*!< CTS is deactivated (set high). Not Clear To Send.                     */
-  __I  uint32_t  RESERVED2[2];
+  __IO uint32_t  EVENTS_RXDRDY;                     /*!< Data received in RXD                                                  */
+  __I  uint32_t  RESERVED2;
   __IO uint32_t  EVENTS_ENDRX;                      /*!< Receive buffer is filled up                                           */
   __I  uint32_t  RESERVED3[3];
   __IO uint32_t  EVENTS_ENDTX;                      /*!< Last TX byte transmitted                                              */
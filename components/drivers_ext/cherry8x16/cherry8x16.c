@@ -27,6 +27,8 @@ static uint8_t m_transmitted_keys[CHERRY8x16_MAX_NUM_OF_PRESSED_KEYS];       //!
 static uint8_t m_num_of_currently_pressed_keys;                              //!< Number of keys in m_currently_pressed_keys
 static uint8_t m_number_of_transmitted_keys;                                 //!< Number of keys in m_transmitted_keys
 
+static uint8_t m_matrix_reported[CHERRY8x16_MATRIX_SIZE];                   //!< Matrix state that has been reported by cherry8x16_key_changes_get.
+
 static uint8_t m_key_packet[KEY_PACKET_SIZE]; //!< Stores last created key packet. One byte is used for modifier keys, one for OEMs. Key values are USB HID keycodes.
 
 static const uint8_t volatile * m_row_port;    //!< Pointer to location where row IO can be read
@@ -63,6 +65,7 @@ static void cherry8x16_keypacket_addkey(uint8_t key);
 static void cherry8x16_keypacket_create(uint8_t * key_packet, uint8_t key_packet_size);
 static void cherry8x16_remap_fn_keys(uint8_t * keys, uint8_t number_of_keys);
 static uint8_t cherry8x16_row_read(void);
+static bool cherry8x16_snapshot_is_ghosted(const uint8_t * p_snapshot);
 
 cherry8x16_status_t cherry8x16_init(const uint8_t volatile * row_port,
                                     uint16_t               * column_port,
@@ -94,6 +97,11 @@ cherry8x16_status_t cherry8x16_init(const uint8_t volatile * row_port,
                 m_currently_pressed_keys[i] = 0;
                 m_transmitted_keys[i]       = 0;
             }
+
+            for (uint_fast8_t i = CHERRY8x16_MATRIX_SIZE; i--;)
+            {
+                m_matrix_reported[i] = 0;
+            }
         }
 
         if (key_lookup_matrix == CHERRY8x16_DEFAULT_KEY_LOOKUP_MATRIX)
@@ -147,6 +155,59 @@ bool cherry8x16_new_packet(const uint8_t ** p_key_packet, uint8_t * p_key_packet
 }
 
 
+void cherry8x16_matrix_scan(uint8_t * p_snapshot)
+{
+    for (uint_fast8_t column = CHERRY8x16_NUM_OF_COLUMNS; column--;)
+    {
+        *m_column_port     = (uint16_t)(1UL << column);
+        p_snapshot[column] = cherry8x16_row_read();
+    }
+    *m_column_port = 0x0000;
+}
+
+
+uint8_t cherry8x16_key_changes_get(const uint8_t           * p_snapshot,
+                                   cherry8x16_key_change_t * p_changes,
+                                   uint8_t                   max_changes)
+{
+    uint8_t num_of_changes = 0;
+
+    if (cherry8x16_snapshot_is_ghosted(p_snapshot))
+    {
+        return 0;
+    }
+
+    for (uint_fast8_t column = 0; column < CHERRY8x16_NUM_OF_COLUMNS; column++)
+    {
+        uint_fast8_t changed = p_snapshot[column] ^ m_matrix_reported[column];
+
+        // Whole columns without changes are skipped with a single compare.
+        for (uint_fast8_t row = 0; (changed != 0) && (row < CHERRY8x16_NUM_OF_ROWS); row++)
+        {
+            uint_fast8_t row_mask = 1U << row;
+
+            if (changed & row_mask)
+            {
+                if (num_of_changes == max_changes)
+                {
+                    return num_of_changes;
+                }
+
+                changed                   &= ~row_mask;
+                m_matrix_reported[column] ^= (uint8_t)row_mask;
+
+                p_changes[num_of_changes].key_index = (uint8_t)(column * CHERRY8x16_NUM_OF_ROWS + row);
+                p_changes[num_of_changes].keycode   = matrix_lookup[column * CHERRY8x16_NUM_OF_ROWS + row];
+                p_changes[num_of_changes].pressed   = (p_snapshot[column] & row_mask) != 0;
+                num_of_changes++;
+            }
+        }
+    }
+
+    return num_of_changes;
+}
+
+
 /**
  * @brief Function for reading and returning keyboard matrix row state.
  *
@@ -218,6 +279,34 @@ static bool cherry8x16_keymatrix_read(uint8_t * pressed_keys, uint8_t * number_o
 }
 
 
+/**
+ * @brief Function for checking a matrix snapshot for keys blocking each other.
+ *
+ * @param p_snapshot Snapshot of the key matrix.
+ * @return
+ * @retval true If some keys were blocking each other.
+ * @retval false If all pressed keys can be determined reliably.
+ */
+static bool cherry8x16_snapshot_is_ghosted(const uint8_t * p_snapshot)
+{
+    uint_fast8_t blocking_mask = 0;
+
+    for (uint_fast8_t column = CHERRY8x16_NUM_OF_COLUMNS; column--;)
+    {
+        uint_fast8_t row_state = p_snapshot[column];
+
+        // More than one key on the column, and one of their rows is shared with another column.
+        if ((row_state & (row_state - 1)) && (blocking_mask & row_state))
+        {
+            return true;
+        }
+        blocking_mask |= row_state;
+    }
+
+    return false;
+}
+
+
 /**
  * @brief Function for remapping the keypad, F11 and F12 keys in case when Fn key is pressed.
  *
@@ -38,6 +38,8 @@
 #define KEY_PACKET_SIZE (KEY_PACKET_KEY_INDEX+KEY_PACKET_MAX_KEYS) //!< Total size of the key packet in bytes
 #define KEY_PACKET_NO_KEY (0) //!< Value to be stored to key index to indicate no key is pressed
 
+#define CHERRY8x16_MATRIX_SIZE (16) //!< Size of a key matrix snapshot in bytes, one byte of row states per column
+
 
 /**
  * Describes return values for:
@@ -50,6 +52,16 @@ typedef enum
   CHERRY8x16_INVALID_PARAMETER /*!< Given parameters were not valid */
 } cherry8x16_status_t;
 
+/**
+ * Describes a key that changed state between two matrix snapshots.
+ */
+typedef struct
+{
+  uint8_t key_index; /*!< Position in the matrix, column * 8 + row. */
+  uint8_t keycode;   /*!< HID keycode from the key lookup matrix. */
+  bool    pressed;   /*!< True if the key was pressed, false if it was released. */
+} cherry8x16_key_change_t;
+
 /**
  * @brief Function for initializing the driver.
  *
@@ -75,6 +87,32 @@ cherry8x16_status_t cherry8x16_init(const uint8_t volatile * row_port, uint16_t
  */
 bool cherry8x16_new_packet(const uint8_t ** p_key_packet, uint8_t *p_key_packet_size);
 
+/**
+ * @brief Function for reading the whole key matrix into a snapshot buffer.
+ *
+ * @details The snapshot is a plain byte array, so it can also be filled by a peripheral (for
+ *          example EasyDMA) and passed directly to @ref cherry8x16_key_changes_get.
+ *
+ * @param p_snapshot Buffer of @ref CHERRY8x16_MATRIX_SIZE bytes. Byte n holds the row states of column n.
+ */
+void cherry8x16_matrix_scan(uint8_t * p_snapshot);
+
+/**
+ * @brief Function for getting the keys that changed state since the last reported snapshot.
+ *
+ * @details All changes are reported in one batch. If there are more changes than fit in
+ *          @p p_changes, the rest are reported by the next call. Snapshots with ghosting are
+ *          ignored.
+ *
+ * @param p_snapshot  Snapshot of @ref CHERRY8x16_MATRIX_SIZE bytes.
+ * @param p_changes   Array that will hold the key changes.
+ * @param max_changes Number of elements in @p p_changes.
+ * @return Number of key changes stored in @p p_changes.
+ */
+uint8_t cherry8x16_key_changes_get(const uint8_t           * p_snapshot,
+                                   cherry8x16_key_change_t * p_changes,
+                                   uint8_t                   max_changes);
+
 /**
  *@}
  **/
@@ -298,6 +298,13 @@
 //Compile time flag
 #define UART_EASY_DMA_SUPPORT     1
 #define UART_LEGACY_SUPPORT       1
+#define UART_RX_STREAM_SUPPORT    0
+
+#if (UART_RX_STREAM_SUPPORT == 1)
+// TIMER instances used for byte counting and idle detection, must be enabled above.
+#define UART0_CONFIG_RX_STREAM_COUNTER_TIMER 1
+#define UART0_CONFIG_RX_STREAM_IDLE_TIMER    2
+#endif
 #endif //NRF52
 #endif
 
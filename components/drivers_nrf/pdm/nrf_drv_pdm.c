@@ -28,11 +28,14 @@ typedef enum
 /** @brief PDM interface control block.*/
 typedef struct
 {
-    nrf_drv_state_t             drv_state;        ///< Driver state.
-    nrf_drv_pdm_state_t         status;           ///< Sampling state.
-    nrf_drv_pdm_event_handler_t event_handler;    ///< Event handler function pointer.
-    uint16_t                    buffer_length;    ///< Length of a single buffer in 16-bit words.
-    uint32_t *                  buffers[2];       ///< Sample buffers.
+    nrf_drv_state_t              drv_state;       ///< Driver state.
+    nrf_drv_pdm_state_t          status;          ///< Sampling state.
+    nrf_drv_pdm_event_handler_t  event_handler;   ///< Event handler function pointer.
+    uint16_t                     buffer_length;   ///< Length of a single buffer in 16-bit words.
+    uint32_t *                   buffers[2];      ///< Sample buffers.
+    nrf_drv_pdm_buffer_request_t buffer_request;  ///< Buffer request handler, NULL if the sample buffers are used.
+    uint32_t *                   p_current;       ///< Buffer being filled, if buffer requests are used.
+    uint32_t *                   p_next;          ///< Buffer to be filled next, if buffer requests are used.
 } nrf_drv_pdm_cb_t;
 
 static nrf_drv_pdm_cb_t m_cb;
@@ -45,7 +48,11 @@ void PDM_IRQHandler(void)
         nrf_pdm_event_clear(NRF_PDM_EVENT_END);
         
         //Buffer is ready to process.
-        if (nrf_pdm_buffer_get() == m_cb.buffers[0])
+        if (m_cb.buffer_request != NULL)
+        {
+            m_cb.event_handler(m_cb.p_current, m_cb.buffer_length);
+        }
+        else if (nrf_pdm_buffer_get() == m_cb.buffers[0])
         {
             m_cb.event_handler(m_cb.buffers[1], m_cb.buffer_length);
         }
@@ -60,7 +67,13 @@ void PDM_IRQHandler(void)
         m_cb.status = NRF_PDM_STATE_RUNNING;
         
         //Swap buffer.
-        if (nrf_pdm_buffer_get() == m_cb.buffers[0])
+        if (m_cb.buffer_request != NULL)
+        {
+            m_cb.p_current = m_cb.p_next;
+            m_cb.p_next    = (uint32_t *)m_cb.buffer_request();
+            nrf_pdm_buffer_set(m_cb.p_next, m_cb.buffer_length);
+        }
+        else if (nrf_pdm_buffer_get() == m_cb.buffers[0])
         {
             nrf_pdm_buffer_set(m_cb.buffers[1],m_cb.buffer_length);
         }
@@ -101,6 +114,7 @@ ret_code_t nrf_drv_pdm_init(nrf_drv_pdm_config_t const * p_config,
     m_cb.buffers[1] = (uint32_t*)p_config->buffer_b;
     m_cb.buffer_length = p_config->buffer_length;
     m_cb.event_handler = event_handler;
+    m_cb.buffer_request = NULL;
     m_cb.status = NRF_PDM_STATE_IDLE;
     
     nrf_pdm_buffer_set(m_cb.buffers[0],m_cb.buffer_length);
@@ -144,6 +158,11 @@ ret_code_t nrf_drv_pdm_start(void)
     }
     m_cb.status = NRF_PDM_STATE_TRANSITION;
     m_cb.drv_state = NRF_DRV_STATE_POWERED_ON;
+    if (m_cb.buffer_request != NULL)
+    {
+        m_cb.p_next = (uint32_t *)m_cb.buffer_request();
+        nrf_pdm_buffer_set(m_cb.p_next, m_cb.buffer_length);
+    }
     nrf_pdm_enable();
     nrf_pdm_event_clear(NRF_PDM_EVENT_STARTED);
     nrf_pdm_task_trigger(NRF_PDM_TASK_START);
@@ -168,3 +187,16 @@ ret_code_t nrf_drv_pdm_stop(void)
     nrf_pdm_task_trigger(NRF_PDM_TASK_STOP);
     return NRF_SUCCESS;
 }
+
+
+void nrf_drv_pdm_buffer_request_set(nrf_drv_pdm_buffer_request_t buffer_request)
+{
+    ASSERT(m_cb.drv_state != NRF_DRV_STATE_UNINITIALIZED);
+    ASSERT(m_cb.status == NRF_PDM_STATE_IDLE);
+
+    m_cb.buffer_request = buffer_request;
+    if (buffer_request == NULL)
+    {
+        nrf_pdm_buffer_set(m_cb.buffers[0], m_cb.buffer_length);
+    }
+}
@@ -93,6 +93,18 @@ typedef struct
 typedef void (*nrf_drv_pdm_event_handler_t)(uint32_t * buffer, uint16_t length);
 
 
+/**
+ * @brief   Handler for PDM interface buffer requests.
+ *
+ * This handler is called when the interface has started filling a buffer and needs the next one.
+ * It must return a buffer of the length given in the configuration, which is then passed to the
+ * event handler when it is full.
+ *
+ * @return Sample buffer. Must not be NULL.
+ */
+typedef int16_t * (*nrf_drv_pdm_buffer_request_t)(void);
+
+
 /**
  * @brief Function for initializing the PDM interface.
  *
@@ -149,6 +161,21 @@ __STATIC_INLINE bool nrf_drv_pdm_enable_check()
 ret_code_t nrf_drv_pdm_start(void);
 
 
+/**
+ * @brief Function for taking sample buffers from the application instead of alternating between
+ *        the two buffers given in the configuration.
+ *
+ * When a buffer request handler is set, the application decides which buffer is filled next, so
+ * that a full buffer can be kept for as long as needed, for example in an audio buffer pool.
+ * The buffers from the configuration are not used.
+ *
+ * This function must be called while sampling is stopped.
+ *
+ * @param[in] buffer_request Buffer request handler, or NULL to use the configured buffers.
+ */
+void nrf_drv_pdm_buffer_request_set(nrf_drv_pdm_buffer_request_t buffer_request);
+
+
 /**
  * @brief   Function for stopping PDM sampling.
  *
@@ -21,6 +21,7 @@
 #include "nrf_soc.h"
 #include "app_util.h"
 #include "app_error.h"
+#include "app_energy_hook.h"
 
 #define INVALID_OPCODE             0x00                                /**< Invalid op code identifier. */
 #define SOC_MAX_WRITE_SIZE         PSTORAGE_FLASH_PAGE_SIZE            /**< Maximum write size allowed for a single call to \ref sd_flash_write as specified in the SoC API. */
@@ -36,6 +37,7 @@
 #define MASK_SINGLE_PAGE_OPERATION (1 << 1)                            /**< Flag for checking if command is a single flash page operation. */
 #define MASK_MODULE_INITIALIZED    (1 << 2)                            /**< Flag for checking if the module has been initialized. */
 #define MASK_FLASH_API_ERR_BUSY    (1 << 3)                            /**< Flag for checking if flash API returned NRF_ERROR_BUSY. */
+#define MASK_FLASH_OP_EXECUTING    (1 << 4)                            /**< Flag for checking if a flash operation requested by this module is executing. */
 
 /**
  * @defgroup api_param_check API Parameters check macros.
@@ -313,6 +315,8 @@ static void flash_api_err_code_process(uint32_t err_code)
     switch (err_code)
     {
         case NRF_SUCCESS:
+            m_flags |= MASK_FLASH_OP_EXECUTING;
+            APP_ENERGY_BEGIN(APP_ENERGY_FLASH);
             break;
             
         case NRF_ERROR_BUSY:
@@ -1115,6 +1119,14 @@ static void flash_operation_failure_run(void)
  */
 void pstorage_sys_event_handler(uint32_t sys_evt)
 {  
+    if ((m_flags & MASK_FLASH_OP_EXECUTING) &&
+        ((sys_evt == NRF_EVT_FLASH_OPERATION_SUCCESS) || (sys_evt == NRF_EVT_FLASH_OPERATION_ERROR)))
+    {
+        // The SoftDevice executes one flash operation at a time, so this event is for ours.
+        m_flags &= ~MASK_FLASH_OP_EXECUTING;
+        APP_ENERGY_END(APP_ENERGY_FLASH);
+    }
+
     if (m_state != STATE_IDLE && m_state != STATE_ERROR)
     {        
         switch (sys_evt)
@@ -15,6 +15,7 @@
 #include "nrf_gpio.h"
 #include "nrf_assert.h"
 #include "app_util_platform.h"
+#include "app_energy_hook.h"
 
 
 #ifndef NRF52
@@ -274,6 +275,7 @@ void nrf_drv_spi_uninit(nrf_drv_spi_t const * const p_instance)
                 nrf_spim_task_trigger(p_spim, NRF_SPIM_TASK_STOP);
                 while (!nrf_spim_event_check(p_spim, NRF_SPIM_EVENT_STOPPED)) {}
                 p_cb->transfer_in_progress = false;
+                APP_ENERGY_END(APP_ENERGY_SPI);
             }
         }
         nrf_spim_disable(p_spim);
@@ -319,6 +321,12 @@ static void finish_transfer(spi_control_block_t * p_cb)
         nrf_gpio_pin_set(p_cb->ss_pin);
     }
 
+    // Repeated transfers are not accounted.
+    if (p_cb->transfer_in_progress)
+    {
+        APP_ENERGY_END(APP_ENERGY_SPI);
+    }
+
     // By clearing this flag before calling the handler we allow subsequent
     // transfers to be started directly from the handler function.
     p_cb->transfer_in_progress = false;
@@ -464,6 +472,10 @@ static ret_code_t spim_xfer(NRF_SPIM_Type                * p_spim,
     if ((p_xfer_desc->p_tx_buffer != NULL && !nrf_drv_is_in_RAM(p_xfer_desc->p_tx_buffer)) ||
         (p_xfer_desc->p_rx_buffer != NULL && !nrf_drv_is_in_RAM(p_xfer_desc->p_rx_buffer)))
     {
+        if (p_cb->transfer_in_progress)
+        {
+            APP_ENERGY_END(APP_ENERGY_SPI);
+        }
         p_cb->transfer_in_progress = false;
         return NRF_ERROR_INVALID_ADDR;
     }
@@ -528,6 +540,8 @@ ret_code_t nrf_drv_spi_xfer(nrf_drv_spi_t     const * const p_instance,
         if (p_cb->handler && !(flags & (NRF_DRV_SPI_FLAG_REPEATED_XFER | NRF_DRV_SPI_FLAG_NO_XFER_EVT_HANDLER)))
         {
             p_cb->transfer_in_progress = true;
+            // Non-blocking transfers are accounted until the interrupt handler finishes them.
+            APP_ENERGY_BEGIN(APP_ENERGY_SPI);
         }
     }
 
@@ -547,6 +561,10 @@ ret_code_t nrf_drv_spi_xfer(nrf_drv_spi_t     const * const p_instance,
     (
         if (flags)
         {
+            if (p_cb->transfer_in_progress)
+            {
+                APP_ENERGY_END(APP_ENERGY_SPI);
+            }
             p_cb->transfer_in_progress = false;
             return NRF_ERROR_NOT_SUPPORTED;
         }
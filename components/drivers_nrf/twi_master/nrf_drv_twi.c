@@ -16,6 +16,7 @@
 #include "nrf_assert.h"
 #include "app_util_platform.h"
 #include "nrf_delay.h"
+#include "app_energy_hook.h"
 
 #include <stdio.h>
 
@@ -531,6 +532,12 @@ __STATIC_INLINE ret_code_t twi_xfer(twi_control_block_t           * p_cb,
         return NRF_ERROR_NOT_SUPPORTED;
     }
 
+    // Non-blocking transfers are accounted until the interrupt handler finishes them.
+    if (p_cb->busy && (p_cb->handler != NULL))
+    {
+        APP_ENERGY_BEGIN(APP_ENERGY_TWI);
+    }
+
     p_cb->flags       = flags;
     p_cb->xfer_desc   = *p_xfer_desc;
     p_cb->curr_length = p_xfer_desc->primary_length;
@@ -588,7 +595,10 @@ __STATIC_INLINE ret_code_t twim_xfer(twi_control_block_t           * p_cb,
     nrf_twim_task_t  start_task = NRF_TWIM_TASK_STARTTX;
     nrf_twim_event_t evt_to_wait = NRF_TWIM_EVENT_STOPPED;
 
-    if (!nrf_drv_is_in_RAM(p_xfer_desc->p_primary_buf))
+    // Buffers are checked before the transfer is started or accounted.
+    if (!nrf_drv_is_in_RAM(p_xfer_desc->p_primary_buf) ||
+        ((p_xfer_desc->type == NRF_DRV_TWI_XFER_TXTX) &&
+         !nrf_drv_is_in_RAM(p_xfer_desc->p_secondary_buf)))
     {
         return NRF_ERROR_INVALID_ADDR;
     }
@@ -606,6 +616,12 @@ __STATIC_INLINE ret_code_t twim_xfer(twi_control_block_t           * p_cb,
                       (NRF_DRV_TWI_FLAG_REPEATED_XFER & flags)) ? false: true;
     }
 
+    // Non-blocking transfers are accounted until the interrupt handler finishes them.
+    if (p_cb->busy && (p_cb->handler != NULL))
+    {
+        APP_ENERGY_BEGIN(APP_ENERGY_TWI);
+    }
+
     p_cb->xfer_desc = *p_xfer_desc;
     p_cb->repeated = (flags & NRF_DRV_TWI_FLAG_REPEATED_XFER) ? true : false;
     nrf_twim_address_set(p_twim, p_xfer_desc->address);
@@ -620,10 +636,6 @@ __STATIC_INLINE ret_code_t twim_xfer(twi_control_block_t           * p_cb,
         ASSERT(!(flags & NRF_DRV_TWI_FLAG_REPEATED_XFER));
         ASSERT(!(flags & NRF_DRV_TWI_FLAG_HOLD_XFER));
         ASSERT(!(flags & NRF_DRV_TWI_FLAG_NO_XFER_EVT_HANDLER));
-        if (!nrf_drv_is_in_RAM(p_xfer_desc->p_secondary_buf))
-        {
-            return NRF_ERROR_INVALID_ADDR;
-        }
         nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_SUSPEND_MASK);
         nrf_twim_tx_buffer_set(p_twim, p_xfer_desc->p_primary_buf, p_xfer_desc->primary_length);
         nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_TXSTARTED);
@@ -880,6 +892,10 @@ static void irq_handler_twim(NRF_TWIM_Type * p_twim, twi_control_block_t * p_cb)
 
     if (!p_cb->repeated)
     {
+        if (p_cb->busy)
+        {
+            APP_ENERGY_END(APP_ENERGY_TWI);
+        }
         p_cb->busy = false;
     }
     p_cb->handler(&event, p_cb->p_context);
@@ -936,6 +952,10 @@ static void irq_handler_twi(NRF_TWI_Type * p_twi, twi_control_block_t * p_cb)
             event.type = NRF_DRV_TWI_EVT_DONE;
         }
 
+        if (p_cb->busy)
+        {
+            APP_ENERGY_END(APP_ENERGY_TWI);
+        }
         p_cb->busy = false;
 
         if (!(NRF_DRV_TWI_FLAG_NO_XFER_EVT_HANDLER & p_cb->flags))
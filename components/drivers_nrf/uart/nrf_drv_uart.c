@@ -16,6 +16,7 @@
 #include "nrf_drv_common.h"
 #include "nrf_gpio.h"
 #include "app_util_platform.h"
+#include "app_energy_hook.h"
 
 // This set of macros makes it possible to exclude parts of code, when one type
 // of supported peripherals is not used.
@@ -47,11 +48,23 @@
     #error "Wrong configuration."
 #endif
 
+#if defined(UARTE_IN_USE) && (UART_RX_STREAM_SUPPORT == 1)
+#define UARTE_RX_STREAM_IN_USE
+#include "sdk_common.h"
+#include "nrf_drv_timer.h"
+#include "nrf_drv_ppi.h"
+
+#define PPI_CHANNEL_INVALID ((nrf_ppi_channel_t)UINT8_MAX)
+
+/**@brief Bytes that must still be free in the current half to set up the next one late. */
+#define RX_STREAM_ARM_MARGIN 2
+#endif
+
 #ifndef IS_EASY_DMA_RAM_ADDRESS
     #define IS_EASY_DMA_RAM_ADDRESS(addr) (((uint32_t)addr & 0xFFFF0000) == 0x20000000)
 #endif
 
-#define TX_COUNTER_ABORT_REQ_VALUE 256
+#define TX_COUNTER_ABORT_REQ_VALUE SIZE_MAX
 
 typedef struct
 {
@@ -60,11 +73,32 @@ typedef struct
     uint8_t          const * p_tx_buffer;
     uint8_t                * p_rx_buffer;
     uint8_t                * p_rx_secondary_buffer;
-    volatile uint16_t        tx_counter;
-    uint8_t                  tx_buffer_length;
-    uint8_t                  rx_buffer_length;
-    uint8_t                  rx_secondary_buffer_length;
-    volatile uint8_t         rx_counter;
+    volatile size_t          tx_counter;
+    size_t                   tx_buffer_length;
+    size_t                   rx_buffer_length;
+    size_t                   rx_secondary_buffer_length;
+    volatile size_t          rx_counter;
+#if defined(UARTE_IN_USE)
+    size_t                   tx_dma_length;      ///< Length of the TX EasyDMA transfer in progress.
+    size_t                   rx_dma_length;      ///< Length of the RX EasyDMA transfer in progress.
+    bool                     rx_dma_started;     ///< RXSTARTED received for the transfer in progress.
+    bool                     rx_dma_next_armed;  ///< Next transfer is started by the ENDRX_STARTRX shortcut.
+#endif
+#if defined(UARTE_RX_STREAM_IN_USE)
+    bool                     rx_stream_active;
+    uint8_t                  rx_stream_half;     ///< Index of the buffer half being filled.
+    size_t                   rx_stream_half_length;
+    uint32_t                 rx_stream_base;     ///< Byte count at the start of the current half.
+    uint32_t                 rx_stream_reported; ///< Byte count reported to the user.
+    volatile uint8_t         rx_stream_held;     ///< Bit n set: half n has data not released by the user.
+    bool                     rx_stream_started;  ///< RXSTARTED was handled for the current transfer.
+    bool                     rx_stream_next_armed; ///< The other half is set up for the ENDRX_STARTRX shortcut.
+    volatile bool            rx_stream_stalled;  ///< No transfer running, both halves are held.
+    bool                     rx_stream_stopping;
+    nrf_ppi_channel_t        rx_stream_ppi_count;
+    nrf_ppi_channel_t        rx_stream_ppi_idle;
+    uint8_t                  interrupt_priority;
+#endif
     bool                     rx_enabled;
     nrf_drv_state_t          state;
 #if (defined(UARTE_IN_USE) && defined(UART_IN_USE))
@@ -75,6 +109,15 @@ typedef struct
 static uart_control_block_t m_cb;
 static const nrf_drv_uart_config_t m_default_config = NRF_DRV_UART_DEFAULT_CONFIG;
 
+#if defined(UARTE_RX_STREAM_IN_USE)
+static const nrf_drv_timer_t m_rx_stream_counter =
+    NRF_DRV_TIMER_INSTANCE(UART0_CONFIG_RX_STREAM_COUNTER_TIMER);
+static const nrf_drv_timer_t m_rx_stream_idle_timer =
+    NRF_DRV_TIMER_INSTANCE(UART0_CONFIG_RX_STREAM_IDLE_TIMER);
+
+static void rx_stream_resources_free(void);
+#endif
+
 __STATIC_INLINE void apply_config(nrf_drv_uart_config_t const * p_config)
 {
     nrf_gpio_pin_set(p_config->pseltxd);
@@ -140,7 +183,8 @@ __STATIC_INLINE void interrupts_disable(void)
         nrf_uarte_int_disable(NRF_UARTE0, NRF_UARTE_INT_ENDRX_MASK |
                                           NRF_UARTE_INT_ENDTX_MASK |
                                           NRF_UARTE_INT_ERROR_MASK |
-                                          NRF_UARTE_INT_RXTO_MASK);
+                                          NRF_UARTE_INT_RXTO_MASK  |
+                                          NRF_UARTE_INT_RXSTARTED_MASK);
     )
     CODE_FOR_UART
     (
@@ -225,6 +269,12 @@ ret_code_t nrf_drv_uart_init(nrf_drv_uart_config_t const * p_config,
 
     m_cb.handler = event_handler;
     m_cb.p_context = p_config->p_context;
+#if defined(UARTE_RX_STREAM_IN_USE)
+    m_cb.interrupt_priority  = p_config->interrupt_priority;
+    m_cb.rx_stream_active    = false;
+    m_cb.rx_stream_ppi_count = PPI_CHANNEL_INVALID;
+    m_cb.rx_stream_ppi_idle  = PPI_CHANNEL_INVALID;
+#endif
 
     if (m_cb.handler)
     {
@@ -242,6 +292,15 @@ ret_code_t nrf_drv_uart_init(nrf_drv_uart_config_t const * p_config,
 
 void nrf_drv_uart_uninit(void)
 {
+#if defined(UARTE_RX_STREAM_IN_USE)
+    if (m_cb.rx_stream_active)
+    {
+        nrf_uarte_shorts_disable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
+        rx_stream_resources_free();
+        m_cb.rx_stream_active = false;
+        APP_ENERGY_END(APP_ENERGY_UART);
+    }
+#endif
     uart_disable();
 
     if (m_cb.handler)
@@ -275,7 +334,7 @@ __STATIC_INLINE ret_code_t nrf_drv_uart_tx_for_uart()
 
     if (m_cb.handler == NULL)
     {
-        while (m_cb.tx_counter < (uint16_t) m_cb.tx_buffer_length)
+        while (m_cb.tx_counter < m_cb.tx_buffer_length)
         {
             while (!nrf_uart_event_check(NRF_UART0, NRF_UART_EVENT_TXDRDY) &&
                     m_cb.tx_counter != TX_COUNTER_ABORT_REQ_VALUE)
@@ -306,14 +365,22 @@ __STATIC_INLINE ret_code_t nrf_drv_uart_tx_for_uart()
 #endif
 
 #if defined(UARTE_IN_USE)
-__STATIC_INLINE ret_code_t nrf_drv_uart_tx_for_uarte()
-{    
-    ret_code_t err_code = NRF_SUCCESS;
-    
+/**@brief Function for starting the EasyDMA transfer of the next part of the TX buffer. */
+__STATIC_INLINE void uarte_tx_dma_start(void)
+{
+    m_cb.tx_dma_length = MIN(m_cb.tx_buffer_length - m_cb.tx_counter, NRF_DRV_UART_DMA_MAX_LENGTH);
+
     nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ENDTX);
     nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_TXSTOPPED);
-    nrf_uarte_tx_buffer_set(NRF_UARTE0, m_cb.p_tx_buffer, m_cb.tx_buffer_length);
+    nrf_uarte_tx_buffer_set(NRF_UARTE0, &m_cb.p_tx_buffer[m_cb.tx_counter], m_cb.tx_dma_length);
     nrf_uarte_task_trigger(NRF_UARTE0, NRF_UARTE_TASK_STARTTX);
+}
+
+__STATIC_INLINE ret_code_t nrf_drv_uart_tx_for_uarte()
+{    
+    ret_code_t err_code = NRF_SUCCESS;
+
+    uarte_tx_dma_start();
 
     if (m_cb.handler == NULL)
     {
@@ -321,15 +388,27 @@ __STATIC_INLINE ret_code_t nrf_drv_uart_tx_for_uarte()
         bool txstopped;
         do
         {
-            endtx     = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDTX);
-            txstopped = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_TXSTOPPED);
-        }
-        while ((!endtx) && (!txstopped));
+            do
+            {
+                endtx     = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDTX);
+                txstopped = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_TXSTOPPED);
+            }
+            while ((!endtx) && (!txstopped));
 
-        if (txstopped)
-        {
-            err_code = NRF_ERROR_FORBIDDEN;
+            if (txstopped)
+            {
+                err_code = NRF_ERROR_FORBIDDEN;
+                break;
+            }
+
+            m_cb.tx_counter += m_cb.tx_dma_length;
+            if (m_cb.tx_counter < m_cb.tx_buffer_length)
+            {
+                uarte_tx_dma_start();
+            }
         }
+        while (m_cb.tx_counter < m_cb.tx_buffer_length);
+
         m_cb.tx_buffer_length = 0;
     }
     
@@ -337,7 +416,7 @@ __STATIC_INLINE ret_code_t nrf_drv_uart_tx_for_uarte()
 }
 #endif
 
-ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, uint8_t length)
+ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, size_t length)
 {
     ASSERT(m_cb.state == NRF_DRV_STATE_INITIALIZED);
     ASSERT(length>0);
@@ -361,6 +440,12 @@ ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, uint8_t length)
     m_cb.p_tx_buffer      = p_data;
     m_cb.tx_counter       = 0;
 
+    // Non-blocking transmissions are accounted until the TX done event.
+    if (m_cb.handler)
+    {
+        APP_ENERGY_BEGIN(APP_ENERGY_UART);
+    }
+
     CODE_FOR_UARTE
     (
         return nrf_drv_uart_tx_for_uarte();
@@ -398,7 +483,7 @@ __STATIC_INLINE void rx_byte(void)
     m_cb.rx_counter++;
 }
 
-__STATIC_INLINE ret_code_t nrf_drv_uart_rx_for_uart(uint8_t * p_data, uint8_t length, bool second_buffer)
+__STATIC_INLINE ret_code_t nrf_drv_uart_rx_for_uart(uint8_t * p_data, size_t length, bool second_buffer)
 {
     if ((!m_cb.rx_enabled) && (!second_buffer))
     {
@@ -457,30 +542,81 @@ __STATIC_INLINE ret_code_t nrf_drv_uart_rx_for_uart(uint8_t * p_data, uint8_t le
 #endif
 
 #if defined(UARTE_IN_USE)
-__STATIC_INLINE ret_code_t nrf_drv_uart_rx_for_uarte(uint8_t * p_data, uint8_t length, bool second_buffer)
+#define UARTE_RX_INT_MASK (NRF_UARTE_INT_ERROR_MASK | NRF_UARTE_INT_ENDRX_MASK | \
+                           NRF_UARTE_INT_RXSTARTED_MASK)
+
+/**@brief Function for starting the EasyDMA transfer of the next part of the primary RX buffer. */
+__STATIC_INLINE void uarte_rx_dma_start(void)
 {
+    m_cb.rx_dma_length     = MIN(m_cb.rx_buffer_length - m_cb.rx_counter, NRF_DRV_UART_DMA_MAX_LENGTH);
+    m_cb.rx_dma_started    = false;
+    m_cb.rx_dma_next_armed = false;
+
     nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX);
     nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_RXTO);
-    nrf_uarte_rx_buffer_set(NRF_UARTE0, p_data, length);
-    if (!second_buffer)
+    nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_RXSTARTED);
+    nrf_uarte_rx_buffer_set(NRF_UARTE0, &m_cb.p_rx_buffer[m_cb.rx_counter], m_cb.rx_dma_length);
+    nrf_uarte_task_trigger(NRF_UARTE0, NRF_UARTE_TASK_STARTRX);
+}
+
+/**@brief Function for preparing the EasyDMA transfer that follows the one in progress.
+ *
+ * @details RXD.PTR and RXD.MAXCNT are double buffered once RXSTARTED has been generated, so the
+ *          next transfer is started by the ENDRX_STARTRX shortcut without CPU involvement. It
+ *          continues in the primary buffer if it is longer than a single transfer, and in the
+ *          secondary buffer otherwise.
+ */
+__STATIC_INLINE void uarte_rx_dma_next_arm(void)
+{
+    size_t offset = m_cb.rx_counter + m_cb.rx_dma_length;
+
+    if (offset < m_cb.rx_buffer_length)
     {
-        nrf_uarte_task_trigger(NRF_UARTE0, NRF_UARTE_TASK_STARTRX);
+        nrf_uarte_rx_buffer_set(NRF_UARTE0, &m_cb.p_rx_buffer[offset],
+                                MIN(m_cb.rx_buffer_length - offset, NRF_DRV_UART_DMA_MAX_LENGTH));
+    }
+    else if (m_cb.rx_secondary_buffer_length != 0)
+    {
+        nrf_uarte_rx_buffer_set(NRF_UARTE0, m_cb.p_rx_secondary_buffer,
+                                MIN(m_cb.rx_secondary_buffer_length, NRF_DRV_UART_DMA_MAX_LENGTH));
     }
     else
+    {
+        return;
+    }
+
+    // If the transfer in progress has already ended, the shortcut comes too late and the
+    // next transfer is started from the interrupt handler instead.
+    if (!nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX))
     {
         nrf_uarte_shorts_enable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
+        m_cb.rx_dma_next_armed = true;
     }
+}
 
+__STATIC_INLINE ret_code_t nrf_drv_uart_rx_for_uarte(uint8_t * p_data, size_t length, bool second_buffer)
+{
     if (m_cb.handler == NULL)
     {
         bool endrx;
         bool rxto;
         bool error;
-        do {
-            endrx  = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX);
-            rxto   = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_RXTO);
-            error  = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ERROR);
-        }while ((!endrx) && (!rxto) && (!error));
+
+        do
+        {
+            uarte_rx_dma_start();
+            do {
+                endrx  = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX);
+                rxto   = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_RXTO);
+                error  = nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ERROR);
+            }while ((!endrx) && (!rxto) && (!error));
+
+            if (error || rxto)
+            {
+                break;
+            }
+            m_cb.rx_counter += m_cb.rx_dma_length;
+        } while (m_cb.rx_counter < m_cb.rx_buffer_length);
 
         m_cb.rx_buffer_length = 0;
 
@@ -496,16 +632,34 @@ __STATIC_INLINE ret_code_t nrf_drv_uart_rx_for_uarte(uint8_t * p_data, uint8_t l
     }
     else
     {
-        nrf_uarte_int_enable(NRF_UARTE0, NRF_UARTE_INT_ERROR_MASK | NRF_UARTE_INT_ENDRX_MASK);
+        if (!second_buffer)
+        {
+            uarte_rx_dma_start();
+        }
+        else if (m_cb.rx_dma_started)
+        {
+            uarte_rx_dma_next_arm();
+        }
+        else
+        {
+            // The secondary buffer is armed when RXSTARTED is handled.
+        }
+        nrf_uarte_int_enable(NRF_UARTE0, UARTE_RX_INT_MASK);
     }
     return NRF_SUCCESS;
 }
 #endif
 
-ret_code_t nrf_drv_uart_rx(uint8_t * p_data, uint8_t length)
+ret_code_t nrf_drv_uart_rx(uint8_t * p_data, size_t length)
 {
     ASSERT(m_cb.state == NRF_DRV_STATE_INITIALIZED);
     ASSERT(length>0);
+#if defined(UARTE_RX_STREAM_IN_USE)
+    if (m_cb.rx_stream_active)
+    {
+        return NRF_ERROR_BUSY;
+    }
+#endif
 
     CODE_FOR_UARTE
     (
@@ -523,7 +677,7 @@ ret_code_t nrf_drv_uart_rx(uint8_t * p_data, uint8_t length)
     {
         CODE_FOR_UARTE
         (
-            nrf_uarte_int_disable(NRF_UARTE0, NRF_UARTE_INT_ERROR_MASK | NRF_UARTE_INT_ENDRX_MASK);
+            nrf_uarte_int_disable(NRF_UARTE0, UARTE_RX_INT_MASK);
         )
         CODE_FOR_UART
         (
@@ -538,7 +692,7 @@ ret_code_t nrf_drv_uart_rx(uint8_t * p_data, uint8_t length)
             {
                 CODE_FOR_UARTE
                 (
-                    nrf_uarte_int_enable(NRF_UARTE0, NRF_UARTE_INT_ERROR_MASK | NRF_UARTE_INT_ENDRX_MASK);
+                    nrf_uarte_int_enable(NRF_UARTE0, UARTE_RX_INT_MASK);
                 )
                 CODE_FOR_UART
                 (
@@ -586,6 +740,7 @@ void nrf_drv_uart_rx_enable(void)
         {
             rx_enable();
             m_cb.rx_enabled = true;
+            APP_ENERGY_BEGIN(APP_ENERGY_UART);
         }
     )
 }
@@ -600,6 +755,10 @@ void nrf_drv_uart_rx_disable(void)
     CODE_FOR_UART
     (
         nrf_uart_task_trigger(NRF_UART0, NRF_UART_TASK_STOPRX);
+        if (m_cb.rx_enabled)
+        {
+            APP_ENERGY_END(APP_ENERGY_UART);
+        }
         m_cb.rx_enabled = false;
     )
 }
@@ -620,7 +779,7 @@ uint32_t nrf_drv_uart_errorsrc_get(void)
     return errsrc;
 }
 
-__STATIC_INLINE void rx_done_event(uint8_t bytes, uint8_t * p_data)
+__STATIC_INLINE void rx_done_event(size_t bytes, uint8_t * p_data)
 {
     nrf_drv_uart_event_t event;
 
@@ -631,7 +790,7 @@ __STATIC_INLINE void rx_done_event(uint8_t bytes, uint8_t * p_data)
     m_cb.handler(&event,m_cb.p_context);
 }
 
-__STATIC_INLINE void tx_done_event(uint8_t bytes)
+__STATIC_INLINE void tx_done_event(size_t bytes)
 {
     nrf_drv_uart_event_t event;
 
@@ -640,6 +799,7 @@ __STATIC_INLINE void tx_done_event(uint8_t bytes)
     event.data.rxtx.p_data = (uint8_t *)m_cb.p_tx_buffer;
 
     m_cb.tx_buffer_length = 0;
+    APP_ENERGY_END(APP_ENERGY_UART);
 
     m_cb.handler(&event,m_cb.p_context);
 }
@@ -673,6 +833,7 @@ void nrf_drv_uart_rx_abort(void)
 {
     CODE_FOR_UARTE
     (
+        nrf_uarte_shorts_disable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
         nrf_uarte_task_trigger(NRF_UARTE0, NRF_UARTE_TASK_STOPRX);
     )
     CODE_FOR_UART
@@ -716,7 +877,7 @@ __STATIC_INLINE void uart_irq_handler()
             if (m_cb.rx_secondary_buffer_length)
             {
                 uint8_t * p_data     = m_cb.p_rx_buffer;
-                uint8_t   rx_counter = m_cb.rx_counter;
+                size_t    rx_counter = m_cb.rx_counter;
                 
                 //Switch to secondary buffer.
                 m_cb.rx_buffer_length = m_cb.rx_secondary_buffer_length;
@@ -740,7 +901,7 @@ __STATIC_INLINE void uart_irq_handler()
 
     if (nrf_uart_event_check(NRF_UART0, NRF_UART_EVENT_TXDRDY))
     {
-        if (m_cb.tx_counter < (uint16_t) m_cb.tx_buffer_length)
+        if (m_cb.tx_counter < m_cb.tx_buffer_length)
         {
             tx_byte();
         }
@@ -773,17 +934,18 @@ __STATIC_INLINE void uart_irq_handler()
 #endif
 
 #if defined(UARTE_IN_USE)
-__STATIC_INLINE void uarte_irq_handler()
+__STATIC_INLINE void uarte_rx_irq_handler(void)
 {
     if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ERROR))
     {
         nrf_drv_uart_event_t event;
 
         nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ERROR);
+        nrf_uarte_shorts_disable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
 
         event.type                   = NRF_DRV_UART_EVT_ERROR;
         event.data.error.error_mask  = nrf_uarte_errorsrc_get_and_clear(NRF_UARTE0);
-        event.data.error.rxtx.bytes  = nrf_uarte_rx_amount_get(NRF_UARTE0);
+        event.data.error.rxtx.bytes  = m_cb.rx_counter;
         event.data.error.rxtx.p_data = m_cb.p_rx_buffer;
 
         //abort transfer
@@ -795,26 +957,72 @@ __STATIC_INLINE void uarte_irq_handler()
     else if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX))
     {
         nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX);
-        uint8_t amount = nrf_uarte_rx_amount_get(NRF_UARTE0);
+        nrf_uarte_shorts_disable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
+
+        size_t amount  = nrf_uarte_rx_amount_get(NRF_UARTE0);
+        bool   started = m_cb.rx_dma_next_armed;
+
+        m_cb.rx_dma_started    = false;
+        m_cb.rx_dma_next_armed = false;
+
         // If the transfer was stopped before completion, amount of transfered bytes
-        // will not be equal to the buffer length. Interrupted trunsfer is ignored.
-        if (amount == m_cb.rx_buffer_length)
+        // will not be equal to the transfer length. Interrupted transfer is reported on RXTO.
+        if ((m_cb.rx_buffer_length != 0) && (amount == m_cb.rx_dma_length))
         {
-            if (m_cb.rx_secondary_buffer_length)
+            m_cb.rx_counter += amount;
+
+            if (m_cb.rx_counter < m_cb.rx_buffer_length)
+            {
+                if (started)
+                {
+                    m_cb.rx_dma_length = MIN(m_cb.rx_buffer_length - m_cb.rx_counter,
+                                             NRF_DRV_UART_DMA_MAX_LENGTH);
+                }
+                else
+                {
+                    uarte_rx_dma_start();
+                }
+            }
+            else if (m_cb.rx_secondary_buffer_length)
             {
-                uint8_t * p_data = m_cb.p_rx_buffer;
-                nrf_uarte_shorts_disable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
+                uint8_t * p_data     = m_cb.p_rx_buffer;
+                size_t    rx_counter = m_cb.rx_counter;
+
+                //Switch to secondary buffer.
                 m_cb.rx_buffer_length = m_cb.rx_secondary_buffer_length;
                 m_cb.p_rx_buffer = m_cb.p_rx_secondary_buffer;
                 m_cb.rx_secondary_buffer_length = 0;
-                rx_done_event(amount, p_data);
+                m_cb.rx_counter = 0;
+                if (started)
+                {
+                    m_cb.rx_dma_length = MIN(m_cb.rx_buffer_length, NRF_DRV_UART_DMA_MAX_LENGTH);
+                }
+                else
+                {
+                    uarte_rx_dma_start();
+                }
+                rx_done_event(rx_counter, p_data);
             }
             else
             {
                 m_cb.rx_buffer_length = 0;
-                rx_done_event(amount, m_cb.p_rx_buffer);
+                rx_done_event(m_cb.rx_counter, m_cb.p_rx_buffer);
             }
         }
+        else
+        {
+            m_cb.rx_counter += amount;
+        }
+    }
+
+    if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_RXSTARTED))
+    {
+        nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_RXSTARTED);
+        if (m_cb.rx_buffer_length)
+        {
+            m_cb.rx_dma_started = true;
+            uarte_rx_dma_next_arm();
+        }
     }
 
     if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_RXTO))
@@ -823,16 +1031,347 @@ __STATIC_INLINE void uarte_irq_handler()
         if (m_cb.rx_buffer_length)
         {
             m_cb.rx_buffer_length = 0;
-            rx_done_event(nrf_uarte_rx_amount_get(NRF_UARTE0), m_cb.p_rx_buffer);
+            rx_done_event(m_cb.rx_counter, m_cb.p_rx_buffer);
         }
     }
+}
+
+#if defined(UARTE_RX_STREAM_IN_USE)
+/**@brief Function for reporting the stream bytes received into the current half.
+ *
+ * @param[in] received Number of bytes received into the current half.
+ */
+static void rx_stream_report(size_t received)
+{
+    uint8_t * p_half   = &m_cb.p_rx_buffer[m_cb.rx_stream_half * m_cb.rx_stream_half_length];
+    size_t    reported = m_cb.rx_stream_reported - m_cb.rx_stream_base;
+
+    if (received > reported)
+    {
+        m_cb.rx_stream_reported = m_cb.rx_stream_base + received;
+        m_cb.rx_stream_held    |= (1 << m_cb.rx_stream_half);
+        rx_done_event(received - reported, &p_half[reported]);
+    }
+}
+
+/**@brief Function for setting up the other half as the next transfer. */
+static void rx_stream_next_arm(void)
+{
+    nrf_uarte_rx_buffer_set(NRF_UARTE0,
+        &m_cb.p_rx_buffer[(m_cb.rx_stream_half ^ 1) * m_cb.rx_stream_half_length],
+        m_cb.rx_stream_half_length);
+    nrf_uarte_shorts_enable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
+    m_cb.rx_stream_next_armed = true;
+}
+
+/**@brief Function for restarting reception into the current half after a stall. */
+static void rx_stream_restart(void)
+{
+    m_cb.rx_stream_stalled = false;
+    m_cb.rx_stream_started = false;
+    nrf_uarte_rx_buffer_set(NRF_UARTE0,
+        &m_cb.p_rx_buffer[m_cb.rx_stream_half * m_cb.rx_stream_half_length],
+        m_cb.rx_stream_half_length);
+    nrf_uarte_task_trigger(NRF_UARTE0, NRF_UARTE_TASK_STARTRX);
+}
+
+/**@brief Idle timer event handler. Runs at the UART interrupt priority. */
+static void rx_stream_idle_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    // A completed half is reported by the ENDRX handler.
+    // While stalled, the counted bytes wait in the UARTE and are not in the buffer yet.
+    if ((event_type == NRF_TIMER_EVENT_COMPARE0) && m_cb.rx_stream_active &&
+        !m_cb.rx_stream_stalled && !nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX))
+    {
+        uint32_t received = nrf_drv_timer_capture(&m_rx_stream_counter, NRF_TIMER_CC_CHANNEL0) -
+                            m_cb.rx_stream_base;
+
+        rx_stream_report(MIN(received, m_cb.rx_stream_half_length));
+    }
+}
+
+/**@brief Counter event handler. The counter does not generate interrupts. */
+static void rx_stream_counter_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    UNUSED_PARAMETER(event_type);
+    UNUSED_PARAMETER(p_context);
+}
+
+/**@brief Function for releasing the PPI channels used by continuous reception. */
+static void rx_stream_ppi_free(void)
+{
+    if (m_cb.rx_stream_ppi_count != PPI_CHANNEL_INVALID)
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_disable(m_cb.rx_stream_ppi_count));
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(m_cb.rx_stream_ppi_count));
+        m_cb.rx_stream_ppi_count = PPI_CHANNEL_INVALID;
+    }
+    if (m_cb.rx_stream_ppi_idle != PPI_CHANNEL_INVALID)
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_disable(m_cb.rx_stream_ppi_idle));
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(m_cb.rx_stream_ppi_idle));
+        m_cb.rx_stream_ppi_idle = PPI_CHANNEL_INVALID;
+    }
+}
+
+/**@brief Function for releasing the resources used by continuous reception. */
+static void rx_stream_resources_free(void)
+{
+    rx_stream_ppi_free();
+    nrf_drv_timer_uninit(&m_rx_stream_idle_timer);
+    nrf_drv_timer_uninit(&m_rx_stream_counter);
+}
+
+__STATIC_INLINE void uarte_rx_stream_irq_handler(void)
+{
+    if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ERROR))
+    {
+        nrf_drv_uart_event_t event;
+
+        nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ERROR);
+
+        // Reception continues, only the error is reported.
+        event.type                   = NRF_DRV_UART_EVT_ERROR;
+        event.data.error.error_mask  = nrf_uarte_errorsrc_get_and_clear(NRF_UARTE0);
+        event.data.error.rxtx.bytes  = 0;
+        event.data.error.rxtx.p_data = NULL;
+
+        m_cb.handler(&event,m_cb.p_context);
+    }
+
+    if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX))
+    {
+        nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX);
+
+        size_t amount = nrf_uarte_rx_amount_get(NRF_UARTE0);
+
+        // The shortcut has fired if it was enabled. It is enabled again by RXSTARTED if the
+        // half after the next one has been released by then.
+        nrf_uarte_shorts_disable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
+
+        rx_stream_report(amount);
+
+        m_cb.rx_stream_base    += amount;
+        m_cb.rx_stream_reported = m_cb.rx_stream_base;
+        m_cb.rx_stream_half    ^= 1;
+        m_cb.rx_stream_started  = false;
+
+        if (m_cb.rx_stream_next_armed)
+        {
+            // The other half is already being filled through the shortcut.
+            m_cb.rx_stream_next_armed = false;
+        }
+        else if (!m_cb.rx_stream_stopping)
+        {
+            // The other half was not released in time. The UARTE keeps the bytes that arrive
+            // until the reception restarts, and holds the peer off with RTS if flow control
+            // is used.
+            m_cb.rx_stream_stalled = true;
+        }
+    }
+
+    if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_RXSTARTED))
+    {
+        nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_RXSTARTED);
+
+        // The other half becomes the next transfer only once the user has released it.
+        m_cb.rx_stream_started = true;
+        if (!(m_cb.rx_stream_held & (1 << (m_cb.rx_stream_half ^ 1))) && !m_cb.rx_stream_stopping)
+        {
+            rx_stream_next_arm();
+        }
+    }
+    else if (m_cb.rx_stream_started && !m_cb.rx_stream_next_armed && !m_cb.rx_stream_stopping &&
+             !(m_cb.rx_stream_held & (1 << (m_cb.rx_stream_half ^ 1))) &&
+             !nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX))
+    {
+        // The other half was released during the current transfer. It is set up only if the
+        // current half cannot fill up before the shortcut is enabled, otherwise ENDRX restarts.
+        uint32_t received = nrf_drv_timer_capture(&m_rx_stream_counter, NRF_TIMER_CC_CHANNEL0) -
+                            m_cb.rx_stream_base;
+
+        if (received + RX_STREAM_ARM_MARGIN <= m_cb.rx_stream_half_length)
+        {
+            rx_stream_next_arm();
+        }
+    }
+
+    // Also reached through nrf_drv_uart_rx_stream_release(), which pends the interrupt.
+    if (m_cb.rx_stream_stalled && !(m_cb.rx_stream_held & (1 << m_cb.rx_stream_half)) &&
+        !m_cb.rx_stream_stopping)
+    {
+        rx_stream_restart();
+    }
+
+    if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_RXTO))
+    {
+        nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_RXTO);
+        rx_stream_resources_free();
+        m_cb.rx_stream_active = false;
+        APP_ENERGY_END(APP_ENERGY_UART);
+    }
+}
+
+ret_code_t nrf_drv_uart_rx_stream_start(uint8_t * p_buffer, size_t length, uint32_t idle_timeout_us)
+{
+    ret_code_t err_code;
+
+    ASSERT(m_cb.state == NRF_DRV_STATE_INITIALIZED);
+
+#if defined(UART_IN_USE)
+    VERIFY_TRUE(m_cb.use_easy_dma, NRF_ERROR_INVALID_STATE);
+#endif
+    VERIFY_TRUE(m_cb.handler != NULL, NRF_ERROR_INVALID_STATE);
+    VERIFY_TRUE(!m_cb.rx_stream_active && (m_cb.rx_buffer_length == 0), NRF_ERROR_INVALID_STATE);
+    VERIFY_TRUE((length != 0) && ((length & 1) == 0) &&
+                (length <= NRF_DRV_UART_RX_STREAM_MAX_LENGTH), NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(idle_timeout_us != 0, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(IS_EASY_DMA_RAM_ADDRESS(p_buffer), NRF_ERROR_INVALID_ADDR);
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code == NRF_SUCCESS) || (err_code == MODULE_ALREADY_INITIALIZED))
+    {
+        err_code = nrf_drv_ppi_channel_alloc(&m_cb.rx_stream_ppi_count);
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = nrf_drv_ppi_channel_alloc(&m_cb.rx_stream_ppi_idle);
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        rx_stream_ppi_free();
+        return NRF_ERROR_NO_MEM;
+    }
+
+    // The idle timer runs at the UART interrupt priority so that its handler
+    // cannot preempt the UART interrupt handler or be preempted by it.
+    nrf_drv_timer_config_t timer_config =
+    {
+        .frequency          = NRF_TIMER_FREQ_1MHz,
+        .mode               = NRF_TIMER_MODE_COUNTER,
+        .bit_width          = NRF_TIMER_BIT_WIDTH_32,
+        .interrupt_priority = m_cb.interrupt_priority,
+        .p_context          = NULL
+    };
+
+    err_code = nrf_drv_timer_init(&m_rx_stream_counter, &timer_config, rx_stream_counter_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        rx_stream_ppi_free();
+        return err_code;
+    }
+    nrf_drv_timer_clear(&m_rx_stream_counter);
+    nrf_drv_timer_enable(&m_rx_stream_counter);
+
+    timer_config.mode = NRF_TIMER_MODE_TIMER;
+    err_code = nrf_drv_timer_init(&m_rx_stream_idle_timer, &timer_config, rx_stream_idle_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_timer_uninit(&m_rx_stream_counter);
+        rx_stream_ppi_free();
+        return err_code;
+    }
+    // Expires once without data, which reports nothing.
+    nrf_drv_timer_extended_compare(&m_rx_stream_idle_timer, NRF_TIMER_CC_CHANNEL0,
+        nrf_drv_timer_us_to_ticks(&m_rx_stream_idle_timer, idle_timeout_us),
+        (nrf_timer_short_mask_t)(NRF_TIMER_SHORT_COMPARE0_STOP_MASK |
+                                 NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK), true);
+    nrf_drv_timer_enable(&m_rx_stream_idle_timer);
+
+    // Every received byte increments the counter and restarts the idle timer.
+    uint32_t rxdrdy = nrf_uarte_event_address_get(NRF_UARTE0, NRF_UARTE_EVENT_RXDRDY);
+
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_assign(m_cb.rx_stream_ppi_count, rxdrdy,
+        nrf_drv_timer_task_address_get(&m_rx_stream_counter, NRF_TIMER_TASK_COUNT)));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_fork_assign(m_cb.rx_stream_ppi_count,
+        nrf_drv_timer_task_address_get(&m_rx_stream_idle_timer, NRF_TIMER_TASK_CLEAR)));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_assign(m_cb.rx_stream_ppi_idle, rxdrdy,
+        nrf_drv_timer_task_address_get(&m_rx_stream_idle_timer, NRF_TIMER_TASK_START)));
+
+    m_cb.p_rx_buffer           = p_buffer;
+    m_cb.rx_stream_half        = 0;
+    m_cb.rx_stream_half_length = length / 2;
+    m_cb.rx_stream_base        = 0;
+    m_cb.rx_stream_reported    = 0;
+    m_cb.rx_stream_held        = 0;
+    m_cb.rx_stream_started     = false;
+    m_cb.rx_stream_next_armed  = false;
+    m_cb.rx_stream_stalled     = false;
+    m_cb.rx_stream_stopping    = false;
+    m_cb.rx_stream_active      = true;
+    APP_ENERGY_BEGIN(APP_ENERGY_UART);
+
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_enable(m_cb.rx_stream_ppi_count));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_enable(m_cb.rx_stream_ppi_idle));
+
+    nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ENDRX);
+    nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_RXTO);
+    nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_RXSTARTED);
+    // RXSTARTED sets up the second half and enables the ENDRX_STARTRX shortcut.
+    nrf_uarte_rx_buffer_set(NRF_UARTE0, p_buffer, m_cb.rx_stream_half_length);
+    nrf_uarte_int_enable(NRF_UARTE0, UARTE_RX_INT_MASK);
+    nrf_uarte_task_trigger(NRF_UARTE0, NRF_UARTE_TASK_STARTRX);
+
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_uart_rx_stream_stop(void)
+{
+    if (m_cb.rx_stream_active)
+    {
+        // ENDRX reports the remaining bytes, RXTO releases the resources.
+        m_cb.rx_stream_stopping = true;
+        nrf_uarte_shorts_disable(NRF_UARTE0, NRF_UARTE_SHORT_ENDRX_STARTRX);
+        nrf_uarte_task_trigger(NRF_UARTE0, NRF_UARTE_TASK_STOPRX);
+    }
+}
+
+void nrf_drv_uart_rx_stream_release(void)
+{
+    if (m_cb.rx_stream_active)
+    {
+        m_cb.rx_stream_held = 0;
+        if (m_cb.rx_stream_stalled || !m_cb.rx_stream_next_armed)
+        {
+            // The released half is set up again, or the reception restarted, in the UART
+            // interrupt where the stream is handled.
+            NVIC_SetPendingIRQ(UART0_IRQn);
+        }
+    }
+}
+#endif // defined(UARTE_RX_STREAM_IN_USE)
+
+__STATIC_INLINE void uarte_irq_handler()
+{
+#if defined(UARTE_RX_STREAM_IN_USE)
+    if (m_cb.rx_stream_active)
+    {
+        uarte_rx_stream_irq_handler();
+    }
+    else
+#endif
+    {
+        uarte_rx_irq_handler();
+    }
 
     if (nrf_uarte_event_check(NRF_UARTE0, NRF_UARTE_EVENT_ENDTX))
     {
         nrf_uarte_event_clear(NRF_UARTE0, NRF_UARTE_EVENT_ENDTX);
         if (m_cb.tx_buffer_length)
         {
-            tx_done_event(nrf_uarte_tx_amount_get(NRF_UARTE0));
+            size_t amount = nrf_uarte_tx_amount_get(NRF_UARTE0);
+
+            m_cb.tx_counter += amount;
+            if ((amount == m_cb.tx_dma_length) && (m_cb.tx_counter < m_cb.tx_buffer_length))
+            {
+                uarte_tx_dma_start();
+            }
+            else
+            {
+                tx_done_event(m_cb.tx_counter);
+            }
         }
     }
 }
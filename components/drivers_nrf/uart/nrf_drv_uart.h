@@ -26,6 +26,7 @@
 #ifndef NRF_DRV_UART_H
 #define NRF_DRV_UART_H
 
+#include <stddef.h>
 #include "nrf_uart.h"
 #ifdef NRF52
 #include "nrf_uarte.h"
@@ -34,6 +35,12 @@
 #include "sdk_errors.h"
 #include "nrf_drv_config.h"
 
+/**@brief Maximum number of bytes in a single EasyDMA transfer of the UARTE peripheral. */
+#define NRF_DRV_UART_DMA_MAX_LENGTH        255
+
+/**@brief Maximum size of the buffer used by @ref nrf_drv_uart_rx_stream_start. */
+#define NRF_DRV_UART_RX_STREAM_MAX_LENGTH  (2 * NRF_DRV_UART_DMA_MAX_LENGTH)
+
 /**
  * @brief Types of UART driver events.
  */
@@ -102,7 +109,7 @@ typedef struct
 typedef struct
 {
     uint8_t * p_data; ///< Pointer to memory used for transfer.
-    uint8_t   bytes;  ///< Number of bytes transfered.
+    size_t    bytes;  ///< Number of bytes transfered.
 } nrf_drv_uart_xfer_evt_t;
 
 /**@brief Structure for UART error event. */
@@ -183,6 +190,10 @@ __STATIC_INLINE uint32_t nrf_drv_uart_event_address_get(nrf_uart_event_t event);
  *       are placed in the Data RAM region. If they are not and UARTE instance is
  *       used, this function will fail with error code NRF_ERROR_INVALID_ADDR.
  *
+ * @note Transfers longer than @ref NRF_DRV_UART_DMA_MAX_LENGTH bytes are split into
+ *       several EasyDMA transfers by the driver. A single @ref NRF_DRV_UART_EVT_TX_DONE
+ *       event is generated when the whole buffer has been sent.
+ *
  * @param[in] p_data Pointer to data.
  * @param[in] length Number of bytes to send.
  *
@@ -192,7 +203,7 @@ __STATIC_INLINE uint32_t nrf_drv_uart_event_address_get(nrf_uart_event_t event);
  *                                   (blocking mode only, also see @ref nrf_drv_uart_rx_disable).
  * @retval    NRF_ERROR_INVALID_ADDR If p_data does not point to RAM buffer (UARTE only).
  */
-ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, uint8_t length);
+ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, size_t length);
 
 /**
  * @brief Function for checking if UART is currently transmitting.
@@ -227,6 +238,9 @@ void nrf_drv_uart_tx_abort(void);
  * @note Peripherals using EasyDMA (i.e. UARTE) require that the transfer buffers
  *       are placed in the Data RAM region. If they are not and UARTE instance is
  *       used, this function will fail with error code NRF_ERROR_INVALID_ADDR.
+ * @note Buffers longer than @ref NRF_DRV_UART_DMA_MAX_LENGTH bytes are received as several
+ *       EasyDMA transfers that are chained without CPU involvement as long as the
+ *       interrupt is served within one transfer time.
  * @param[in] p_data Pointer to data.
  * @param[in] length Number of bytes to receive.
  *
@@ -239,7 +253,7 @@ void nrf_drv_uart_tx_abort(void);
  * @retval    NRF_ERROR_INTERNAL If UART peripheral reported an error.
  * @retval    NRF_ERROR_INVALID_ADDR If p_data does not point to RAM buffer (UARTE only).
  */
-ret_code_t nrf_drv_uart_rx(uint8_t * p_data, uint8_t length);
+ret_code_t nrf_drv_uart_rx(uint8_t * p_data, size_t length);
 
 /**
  * @brief Function for enabling receiver.
@@ -269,6 +283,59 @@ void nrf_drv_uart_rx_disable(void);
  */
 void nrf_drv_uart_rx_abort(void);
 
+#if defined(NRF52) && (UART_RX_STREAM_SUPPORT == 1)
+/**
+ * @brief Function for starting continuous reception.
+ *
+ * The buffer is split into two halves that are filled alternately by EasyDMA. The ENDRX_STARTRX
+ * shortcut restarts reception into the other half, so no data is lost while the CPU processes
+ * the completed half. Received bytes are counted by a TIMER in counter mode. A second TIMER
+ * measures the time since the last byte. When the line has been idle for @p idle_timeout_us,
+ * the bytes received so far are reported without stopping the reception.
+ *
+ * Data is reported with @ref NRF_DRV_UART_EVT_RX_DONE events. Each event carries a chunk of
+ * bytes that were not reported before. The chunks stay valid until they are released with
+ * @ref nrf_drv_uart_rx_stream_release. A filled half is only reused once all data reported from
+ * it was released. If both halves are held, reception pauses: the UARTE keeps the next few bytes
+ * and deasserts RTS if flow control is used, otherwise further bytes are lost. Errors are
+ * reported with @ref NRF_DRV_UART_EVT_ERROR events and do not stop the reception.
+ *
+ * @note Supported only in non-blocking Easy DMA mode. The TIMER instances selected by
+ *       UART0_CONFIG_RX_STREAM_COUNTER_TIMER and UART0_CONFIG_RX_STREAM_IDLE_TIMER must be
+ *       enabled in nrf_drv_config.h and must not be used by the application.
+ *
+ * @param[in] p_buffer        Pointer to the buffer. Must be placed in Data RAM.
+ * @param[in] length          Size of the buffer. Must be even and not larger than
+ *                            @ref NRF_DRV_UART_RX_STREAM_MAX_LENGTH.
+ * @param[in] idle_timeout_us Idle time after which the pending data is reported.
+ *
+ * @retval    NRF_SUCCESS             If the reception was started.
+ * @retval    NRF_ERROR_INVALID_STATE If the driver is not in non-blocking Easy DMA mode, or if a
+ *                                    reception is already in progress.
+ * @retval    NRF_ERROR_INVALID_PARAM If the buffer size or the idle timeout is invalid.
+ * @retval    NRF_ERROR_INVALID_ADDR  If p_buffer does not point to a RAM buffer.
+ * @retval    NRF_ERROR_NO_MEM        If no PPI channels are available.
+ */
+ret_code_t nrf_drv_uart_rx_stream_start(uint8_t * p_buffer, size_t length, uint32_t idle_timeout_us);
+
+/**
+ * @brief Function for stopping continuous reception.
+ *
+ * The bytes that were received but not yet reported are reported with a final
+ * @ref NRF_DRV_UART_EVT_RX_DONE event from the UART interrupt context.
+ */
+void nrf_drv_uart_rx_stream_stop(void);
+
+/**
+ * @brief Function for releasing the data reported so far by continuous reception.
+ *
+ * Call it once the chunks of all @ref NRF_DRV_UART_EVT_RX_DONE events so far have been read or
+ * copied, either from the event handler or later. Releasing from the event handler keeps the
+ * reception continuous.
+ */
+void nrf_drv_uart_rx_stream_release(void);
+#endif // defined(NRF52) && (UART_RX_STREAM_SUPPORT == 1)
+
 /**
  * @brief Function for reading error source mask. Mask contains values from @ref nrf_uart_error_mask_t.
  * @note Function should be used in blocking mode only. In case of non-blocking mode error event is
@@ -22,6 +22,10 @@ All rights reserved.
 #endif // LEDDRIVER_ACTIVE
 
 #define BURST_PACKET_SIZE                  8u                            /**< The burst packet size. */
+#define BURST_QUEUE_SIZE                   8u                            /**< Number of burst segments that can be queued in pipelined mode (power of 2). */
+
+STATIC_ASSERT((ANTFS_BURST_SEGMENT_SIZE % BURST_PACKET_SIZE) == 0);
+STATIC_ASSERT((BURST_QUEUE_SIZE & (BURST_QUEUE_SIZE - 1u)) == 0);
 
 #define ANTFS_CONNECTION_TYPE_OFFSET       0x00u                         /**< The connection type offset within ANT-FS message. */
 #define ANTFS_COMMAND_OFFSET               0x01u                         /**< The command offset within ANT-FS message. */
@@ -156,6 +160,14 @@ typedef struct
     antfs_substate_t sub_state;                                           /**< ANT-FS sub-state. */
 } antfs_states_t;
 
+typedef struct
+{
+    const uint8_t * p_data;                                               /**< Segment data, either referenced or pointing to inline_data. */
+    uint16_t        size;                                                 /**< Segment size (bytes). */
+    uint8_t         flags;                                                /**< Burst segment flags. */
+    uint8_t         inline_data[BURST_PACKET_SIZE];                       /**< Copy of short segments. */
+} burst_segment_t;
+
 typedef struct
 {
     antfs_event_return_t * p_queue;                                       /**< ANT-FS event queue. */
@@ -209,6 +221,12 @@ static antfs_event_queue_t m_event_queue;                                 /**< E
 
 static antfs_burst_wait_handler_t m_burst_wait_handler = NULL;            /**< Burst wait handler */
 
+// Pipelined download.
+static const antfs_download_source_t * mp_download_source = NULL;         /**< Download data source, NULL when data is provided through ANTFS_EVENT_DOWNLOAD_REQUEST_DATA. */
+static burst_segment_t m_burst_queue[BURST_QUEUE_SIZE];                   /**< Burst segments waiting for the burst handler. */
+static uint32_t        m_burst_queue_head;                                /**< Burst segment queue head index. */
+static uint32_t        m_burst_queue_tail;                                /**< Burst segment queue tail index. */
+
 
 const char * antfs_hostname_get(void)
 {
@@ -235,6 +253,169 @@ static void wait_burst_request_to_complete(void)
 }
 
 
+/**@brief Function for discarding all queued burst segments.
+ */
+static void burst_queue_reset(void)
+{
+    m_burst_queue_head = 0;
+    m_burst_queue_tail = 0;
+}
+
+
+/**@brief Function for checking if the burst segment queue is empty.
+ */
+static bool burst_queue_is_empty(void)
+{
+    return (m_burst_queue_head == m_burst_queue_tail);
+}
+
+
+/**@brief Function for handing queued burst segments to the burst handler.
+ *
+ * A segment is only submitted when the burst handler is done with the previous one, so this
+ * function never blocks.
+ */
+static void burst_queue_submit(void)
+{
+    while ((m_burst_wait == 0) && !burst_queue_is_empty())
+    {
+        burst_segment_t * p_segment = &m_burst_queue[m_burst_queue_tail];
+
+        const uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
+                                                                p_segment->size,
+                                                                (uint8_t *)p_segment->p_data,
+                                                                p_segment->flags);
+
+        m_burst_queue_tail = (m_burst_queue_tail + 1u) & (BURST_QUEUE_SIZE - 1u);
+
+        if (err_code == NRF_ANT_ERROR_TRANSFER_SEQUENCE_NUMBER_ERROR)
+        {
+            // The burst failed before we were able to catch it, so the rest of it is stale.
+            // The message processing will send client back to correct state.
+            burst_queue_reset();
+            return;
+        }
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+
+/**@brief Function for getting the number of burst segments that can still be queued.
+ */
+static uint32_t burst_queue_free_get(void)
+{
+    const uint32_t used = (m_burst_queue_head - m_burst_queue_tail) & (BURST_QUEUE_SIZE - 1u);
+
+    // One slot separates head from tail, and one is kept for the segment in the burst handler.
+    return (BURST_QUEUE_SIZE - 2u) - used;
+}
+
+
+/**@brief Function for waiting until all queued burst segments are handed to the burst handler.
+ */
+static void burst_queue_drain(void)
+{
+    while (!burst_queue_is_empty())
+    {
+        wait_burst_request_to_complete();
+        burst_queue_submit();
+    }
+}
+
+
+/**@brief Function for adding a segment to the burst segment queue.
+ *
+ * Segments up to one burst packet are copied. Longer segments are referenced and must stay valid
+ * until sent, which holds for data provided by the download source.
+ *
+ * @param[in] p_data           Segment data.
+ * @param[in] size             Segment size, a multiple of BURST_PACKET_SIZE.
+ * @param[in] flags            Burst segment flags.
+ *
+ * @retval NRF_SUCCESS      Segment queued.
+ * @retval NRF_ERROR_NO_MEM No room in the queue.
+ */
+static uint32_t burst_queue_put(const uint8_t * p_data, uint32_t size, uint8_t flags)
+{
+    const uint32_t head = m_burst_queue_head;
+    const uint32_t next = (head + 1u) & (BURST_QUEUE_SIZE - 1u);
+
+    // Keep one slot free, as the last submitted segment may still be in use by the burst handler.
+    if (((next + 1u) & (BURST_QUEUE_SIZE - 1u)) == m_burst_queue_tail)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    burst_segment_t * p_segment = &m_burst_queue[head];
+
+    if (size <= BURST_PACKET_SIZE)
+    {
+        memcpy(p_segment->inline_data, p_data, size);
+        p_segment->p_data = p_segment->inline_data;
+    }
+    else
+    {
+        p_segment->p_data = p_data;
+    }
+    p_segment->size  = size;
+    p_segment->flags = flags;
+
+    m_burst_queue_head = next;
+
+    burst_queue_submit();
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for sending a burst segment and waiting until the burst handler is done with it.
+ *
+ * Queued segments are sent first to keep the order of the burst.
+ *
+ * @param[in] p_data           Segment data.
+ * @param[in] size             Segment size, a multiple of BURST_PACKET_SIZE.
+ * @param[in] flags            Burst segment flags.
+ *
+ * @return Error code returned by the burst handler.
+ */
+static uint32_t burst_request_blocking(const uint8_t * p_data, uint32_t size, uint8_t flags)
+{
+    burst_queue_drain();
+    wait_burst_request_to_complete();
+
+    const uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
+                                                            size,
+                                                            (uint8_t *)p_data,
+                                                            flags);
+
+    wait_burst_request_to_complete();
+
+    return err_code;
+}
+
+
+/**@brief Function for sending a burst segment of a download response.
+ *
+ * Blocks like @ref burst_request_blocking, unless a download source is set. In that case the
+ * segment is queued and sent as soon as the burst handler is ready for it.
+ *
+ * @param[in] p_data           Segment data.
+ * @param[in] size             Segment size, a multiple of BURST_PACKET_SIZE.
+ * @param[in] flags            Burst segment flags.
+ *
+ * @return Error code returned by the burst handler or the queue.
+ */
+static uint32_t burst_request(const uint8_t * p_data, uint32_t size, uint8_t flags)
+{
+    if (mp_download_source == NULL)
+    {
+        return burst_request_blocking(p_data, size, flags);
+    }
+
+    return burst_queue_put(p_data, size, flags);
+}
+
+
 /**@brief Function for stopping ANT-FS timeout, which is possibly currently running.
  */
 static void timeout_disable(void)
@@ -316,14 +497,9 @@ static void beacon_transmit(uint32_t message_type)
     else if(message_type == MESG_BURST_DATA_ID)
     {
         // Send as the first packet of a burst.
-        const uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                                sizeof(tx_buffer),
-                                                                tx_buffer,
-                                                                BURST_SEGMENT_START);
+        const uint32_t err_code = burst_request(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_START);
         APP_ERROR_CHECK(err_code);
 
-        wait_burst_request_to_complete();
-
         // This is the first packet of a burst response, disable command timeout while bursting.
         timeout_disable();
     }
@@ -373,14 +549,9 @@ static void authenticate_response_transmit(uint8_t response_type,
        )
     {
         // Send second packet (auth response).
-        err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                sizeof(tx_buffer),
-                                                tx_buffer,
-                                                BURST_SEGMENT_CONTINUE);
+        err_code = burst_request_blocking(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_CONTINUE);
         APP_ERROR_CHECK(err_code);
 
-        wait_burst_request_to_complete();
-
         // Round size to a multiple of 8 bytes.
         uint8_t tx_buffer_authenticate[ANTFS_AUTH_STRING_MAX + 1u];
 
@@ -395,14 +566,9 @@ static void authenticate_response_transmit(uint8_t response_type,
         }
 
         // Send auth string (last packets of the burst).
-        err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                password_length,
-                                                tx_buffer_authenticate,
-                                                BURST_SEGMENT_END);
+        err_code = burst_request_blocking(tx_buffer_authenticate, password_length, BURST_SEGMENT_END);
         APP_ERROR_CHECK(err_code);
 
-        wait_burst_request_to_complete();
-
         m_link_command_in_progress = ANTFS_RSP_AUTHENTICATE_ID;
     }
     else
@@ -410,13 +576,8 @@ static void authenticate_response_transmit(uint8_t response_type,
         // If the authorization is rejected or there is no valid password, the auth response is the
         // last packet.
 
-        err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                sizeof(tx_buffer),
-                                                tx_buffer,
-                                                BURST_SEGMENT_END);
+        err_code = burst_request_blocking(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_END);
         APP_ERROR_CHECK(err_code);
-
-        wait_burst_request_to_complete();
     }
 
     // Switch to appropiate state.
@@ -575,6 +736,151 @@ static void event_queue_write(antfs_event_t event_code)
 }
 
 
+/**@brief Function for requesting the next block of download data.
+ *
+ * The data is requested from the application through ANTFS_EVENT_DOWNLOAD_REQUEST_DATA, or read
+ * from the download source by @ref antfs_burst_process.
+ */
+static void download_data_request(void)
+{
+    m_is_data_request_pending = true;
+
+    if (mp_download_source == NULL)
+    {
+        event_queue_write(ANTFS_EVENT_DOWNLOAD_REQUEST_DATA);
+    }
+}
+
+
+/**@brief Function for bursting a block of download data.
+ *
+ * Without a download source, the block is rounded up to a multiple of BURST_PACKET_SIZE and sent
+ * from the application buffer directly. With a download source, the whole packets are sent
+ * straight from the source data and only a trailing partial packet is copied and padded.
+ *
+ * @param[in] p_data           Data to burst.
+ * @param[in] size             Number of data bytes.
+ *
+ * @return Error code returned by the burst handler or the queue.
+ */
+static uint32_t download_data_burst(const uint8_t * p_data, uint32_t size)
+{
+    if (mp_download_source == NULL)
+    {
+        uint32_t num_of_bytes_to_burst = size;
+
+        if (num_of_bytes_to_burst & (BURST_PACKET_SIZE - 1u))
+        {
+            // Round up total number bytes to a multiple of BURST_PACKET_SIZE to be sent to
+            // burst handler.
+            num_of_bytes_to_burst &= ~(BURST_PACKET_SIZE - 1u);
+            num_of_bytes_to_burst += BURST_PACKET_SIZE;
+        }
+
+        return burst_request_blocking(p_data, num_of_bytes_to_burst, BURST_SEGMENT_CONTINUE);
+    }
+
+    const uint32_t whole_bytes = size & ~(BURST_PACKET_SIZE - 1u);
+    uint32_t       err_code    = NRF_SUCCESS;
+
+    if (whole_bytes != 0)
+    {
+        err_code = burst_queue_put(p_data, whole_bytes, BURST_SEGMENT_CONTINUE);
+    }
+
+    if ((err_code == NRF_SUCCESS) && (whole_bytes != size))
+    {
+        uint8_t tx_buffer[BURST_PACKET_SIZE] = {0};
+
+        memcpy(tx_buffer, &p_data[whole_bytes], size - whole_bytes);
+        err_code = burst_queue_put(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_CONTINUE);
+    }
+
+    return err_code;
+}
+
+
+/**@brief Function for checking if a block of download data and the CRC footer that may follow it
+ *        fit in the burst segment queue.
+ *
+ * Always true without a download source, as the data is then sent blocking.
+ *
+ * @param[in] size             Number of data bytes.
+ */
+static bool download_data_burst_fits(uint32_t size)
+{
+    uint32_t segments = 1u;     // CRC footer.
+
+    if (mp_download_source == NULL)
+    {
+        return true;
+    }
+
+    if (size >= BURST_PACKET_SIZE)
+    {
+        segments++;             // Whole packets, sent from the source data.
+    }
+    if ((size & (BURST_PACKET_SIZE - 1u)) != 0)
+    {
+        segments++;             // Trailing partial packet.
+    }
+
+    return (burst_queue_free_get() >= segments);
+}
+
+
+/**@brief Function for serving a pending download data request from the download source.
+ */
+static void download_source_serve(void)
+{
+    const uint8_t * p_data = NULL;
+    uint32_t        length = MIN(m_bytes_remaining.data, ANTFS_BURST_SEGMENT_SIZE);
+
+    if ((m_current_state.sub_state.trans_sub_state == ANTFS_TRANS_SUBSTATE_VERIFY_CRC) &&
+        (m_link_burst_index.data < m_saved_crc_offset))
+    {
+        // Stop exactly at the save point, so that the CRC can be compared directly and the data
+        // segments that follow stay aligned to burst packets.
+        length = MIN(length, m_saved_crc_offset - m_link_burst_index.data);
+    }
+
+    m_is_data_request_pending = false;
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    const uint32_t available = mp_download_source->read(mp_download_source->p_context,
+                                                        m_file_index.data,
+                                                        m_link_burst_index.data,
+                                                        length,
+                                                        &p_data);
+
+    if ((available < length) &&
+        (m_current_state.sub_state.trans_sub_state == ANTFS_TRANS_SUBSTATE_DOWNLOADING))
+    {
+        // Only the last block of the transfer may end with a partial burst packet.
+        length = available & ~(BURST_PACKET_SIZE - 1u);
+    }
+    else
+    {
+        length = MIN(available, length);
+    }
+
+    if ((length == 0) || (p_data == NULL))
+    {
+        event_queue_write(ANTFS_EVENT_DOWNLOAD_FAIL);
+        return;
+    }
+
+    UNUSED_VARIABLE(antfs_input_data_download(m_file_index.data,
+                                              m_link_burst_index.data,
+                                              length,
+                                              p_data));
+}
+
+
 /**@brief Function for transmitting download request response message.
  *
  * @param[in] response         Download response code.
@@ -597,14 +903,9 @@ static void download_request_response_transmit(uint8_t response)
     tx_buffer[6] = m_bytes_remaining.bytes.byte2;
     tx_buffer[7] = m_bytes_remaining.bytes.byte3;
 
-    uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                     sizeof(tx_buffer),
-                                                     tx_buffer,
-                                                     BURST_SEGMENT_CONTINUE);
+    uint32_t err_code = burst_request(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_CONTINUE);
     APP_ERROR_CHECK(err_code);
 
-    wait_burst_request_to_complete();
-
     // Second part of the download response.
 
     // The offset the data will start from in this block.
@@ -623,24 +924,14 @@ static void download_request_response_transmit(uint8_t response)
         // If the download was rejected or there is no data to send.
 
         // Set response to end since we're not downloading any data.
-        err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                sizeof(tx_buffer),
-                                                tx_buffer,
-                                                BURST_SEGMENT_END);
+        err_code = burst_request(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_END);
         APP_ERROR_CHECK(err_code);
-
-        wait_burst_request_to_complete();
     }
     else
     {
         // Response will continue (data packets + CRC footer to follow).
-        err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                sizeof(tx_buffer),
-                                                tx_buffer,
-                                                BURST_SEGMENT_CONTINUE);
+        err_code = burst_request(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_CONTINUE);
         APP_ERROR_CHECK(err_code);
-
-        wait_burst_request_to_complete();
     }
 
     m_link_command_in_progress = ANTFS_CMD_DOWNLOAD_ID;
@@ -750,9 +1041,11 @@ void antfs_download_req_resp_prepare(uint8_t response,
         m_is_data_request_pending = true;
 
         // Request data from application.
-        event_queue_write(ANTFS_EVENT_DOWNLOAD_REQUEST_DATA);
+        download_data_request();
 
         m_current_state.sub_state.trans_sub_state = ANTFS_TRANS_SUBSTATE_VERIFY_CRC;
+
+        antfs_burst_process();
     }
 }
 
@@ -861,27 +1154,22 @@ uint32_t antfs_input_data_download(uint16_t index,
                 m_transfer_crc = crc_crc16_update(m_transfer_crc, p_message, num_bytes);
 
                 // Request more data.
-                event_queue_write(ANTFS_EVENT_DOWNLOAD_REQUEST_DATA);
+                download_data_request();
             }
         }
 
         // Append data.
         if (m_current_state.sub_state.trans_sub_state == ANTFS_TRANS_SUBSTATE_DOWNLOADING)
         {
-            uint32_t num_of_bytes_to_burst = num_bytes;
-
-            if (num_of_bytes_to_burst & (BURST_PACKET_SIZE - 1u))
+            if (!download_data_burst_fits(num_bytes))
             {
-                // Round up total number bytes to a multiple of BURST_PACKET_SIZE to be sent to
-                // burst handler.
-                num_of_bytes_to_burst &= ~(BURST_PACKET_SIZE - 1u);
-                num_of_bytes_to_burst += BURST_PACKET_SIZE;
+                // The queue is still full of the download response. The data request stays
+                // pending, and is served again when the burst handler has taken more segments.
+                m_is_data_request_pending = true;
+                return 0;
             }
 
-            uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                             num_of_bytes_to_burst,
-                                                             (uint8_t*)&(p_message[block_offset]),
-                                                             BURST_SEGMENT_CONTINUE);
+            uint32_t err_code = download_data_burst(&(p_message[block_offset]), num_bytes);
             if(err_code != NRF_ANT_ERROR_TRANSFER_SEQUENCE_NUMBER_ERROR)
             {
                 // If burst failed before we are able to catch it, we will get a TRANSFER_SEQUENCE_NUMBER_ERROR
@@ -889,8 +1177,6 @@ uint32_t antfs_input_data_download(uint16_t index,
                 APP_ERROR_CHECK(err_code);
             }
 
-            wait_burst_request_to_complete();
-
             // Update current burst index.
             m_link_burst_index.data += num_bytes;
             // Update remaining bytes.
@@ -921,7 +1207,7 @@ uint32_t antfs_input_data_download(uint16_t index,
                 // If we have not finished the download.
 
                 // Request more data.
-                event_queue_write(ANTFS_EVENT_DOWNLOAD_REQUEST_DATA);
+                download_data_request();
 
                 m_is_data_request_pending = true;
             }
@@ -940,10 +1226,7 @@ uint32_t antfs_input_data_download(uint16_t index,
                 tx_buffer[6] = (uint8_t)m_transfer_crc;
                 tx_buffer[7] = (uint8_t)(m_transfer_crc >> 8u);
 
-                err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                        sizeof(tx_buffer),
-                                                        tx_buffer,
-                                                        BURST_SEGMENT_END);
+                err_code = burst_request(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_END);
                 if(err_code != NRF_ANT_ERROR_TRANSFER_SEQUENCE_NUMBER_ERROR)
                 {
                     // If burst failed before we are able to catch it, we will get a TRANSFER_SEQUENCE_NUMBER_ERROR
@@ -951,8 +1234,6 @@ uint32_t antfs_input_data_download(uint16_t index,
                     APP_ERROR_CHECK(err_code);
                 }
 
-                wait_burst_request_to_complete();
-
                 m_is_crc_pending          = false;
                 m_max_transfer_index.data = 0;
             }
@@ -1033,14 +1314,9 @@ bool antfs_upload_req_resp_transmit(uint8_t response,
     tx_buffer[7] = m_link_burst_index.bytes.byte3;
 
 
-    uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                     sizeof(tx_buffer),
-                                                     tx_buffer,
-                                                     BURST_SEGMENT_CONTINUE);
+    uint32_t err_code = burst_request_blocking(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_CONTINUE);
     APP_ERROR_CHECK(err_code);
 
-    wait_burst_request_to_complete();
-
     // Third packet.
 
     // Maximum number of bytes that can be written to the file.
@@ -1054,14 +1330,9 @@ bool antfs_upload_req_resp_transmit(uint8_t response,
     tx_buffer[6] = m_block_size.bytes.byte2;
     tx_buffer[7] = m_block_size.bytes.byte3;
 
-    err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                            sizeof(tx_buffer),
-                                            tx_buffer,
-                                            BURST_SEGMENT_CONTINUE);
+    err_code = burst_request_blocking(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_CONTINUE);
     APP_ERROR_CHECK(err_code);
 
-    wait_burst_request_to_complete();
-
     // Fourth packet.
 
     tx_buffer[0] = 0;
@@ -1074,14 +1345,9 @@ bool antfs_upload_req_resp_transmit(uint8_t response,
     tx_buffer[6] = (uint8_t) m_transfer_crc;
     tx_buffer[7] = (uint8_t)(m_transfer_crc >> 8);
 
-    err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                            sizeof(tx_buffer),
-                                            tx_buffer,
-                                            BURST_SEGMENT_END);
+    err_code = burst_request_blocking(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_END);
     APP_ERROR_CHECK(err_code);
 
-    wait_burst_request_to_complete();
-
     m_link_command_in_progress = ANTFS_CMD_UPLOAD_REQUEST_ID;
 
     if (response != 0)
@@ -1128,14 +1394,9 @@ bool antfs_upload_data_resp_transmit(bool data_upload_success)
     beacon_transmit(MESG_BURST_DATA_ID);
 
     // Send last packet.
-    uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                     sizeof(tx_buffer),
-                                                     tx_buffer,
-                                                     BURST_SEGMENT_END);
+    uint32_t err_code = burst_request_blocking(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_END);
     APP_ERROR_CHECK(err_code);
 
-    wait_burst_request_to_complete();
-
     m_link_command_in_progress = ANTFS_CMD_UPLOAD_REQUEST_ID;
 
     // Reset maximum index.
@@ -1168,13 +1429,8 @@ void antfs_erase_req_resp_transmit(uint8_t response)
     tx_buffer[6] = 0;
     tx_buffer[7] = 0;
 
-    uint32_t err_code = sd_ant_burst_handler_request(ANTFS_CHANNEL,
-                                                     sizeof(tx_buffer),
-                                                     tx_buffer,
-                                                     BURST_SEGMENT_END);
+    uint32_t err_code = burst_request_blocking(tx_buffer, sizeof(tx_buffer), BURST_SEGMENT_END);
     APP_ERROR_CHECK(err_code);
-
-    wait_burst_request_to_complete();
 }
 
 
@@ -2055,6 +2311,8 @@ void antfs_message_process(uint8_t * p_message)
                 {
                     case EVENT_TRANSFER_TX_FAILED:
                         m_link_command_in_progress = ANTFS_CMD_NONE;
+                        // Anything still queued belongs to the failed burst.
+                        burst_queue_reset();
                         // Switch into the appropriate state after the failure. Must be ready for
                         // the host to do a retry.
                         switch (m_current_state.state)
@@ -2182,6 +2440,12 @@ void antfs_message_process(uint8_t * p_message)
                         }
                         break;
 
+                    case EVENT_TRANSFER_TX_START:
+                    case EVENT_TRANSFER_NEXT_DATA_BLOCK:
+                        // The burst handler has taken a segment. The next one is queued, and
+                        // download data read, below.
+                        break;
+
                     case EVENT_TX:
 #ifdef LEDDRIVER_ACTIVE
                         err_code = bsp_indication_set(BSP_INDICATE_SENT_OK);
@@ -2210,10 +2474,65 @@ void antfs_message_process(uint8_t * p_message)
                 // No implementation needed.
                 return;
         }
+
+        antfs_burst_process();
+    }
+}
+
+
+void antfs_burst_process(void)
+{
+    if (mp_download_source == NULL)
+    {
+        return;
+    }
+
+    burst_queue_submit();
+
+    // Prepare the next data segment while the current one is on air.
+    while (burst_queue_is_empty() &&
+        m_is_data_request_pending &&
+        (m_current_state.state == ANTFS_STATE_TRANS) &&
+        (
+            (m_current_state.sub_state.trans_sub_state == ANTFS_TRANS_SUBSTATE_VERIFY_CRC) ||
+            (m_current_state.sub_state.trans_sub_state == ANTFS_TRANS_SUBSTATE_DOWNLOADING)
+        )
+       )
+    {
+        download_source_serve();
     }
 }
 
 
+void antfs_download_source_set(const antfs_download_source_t * p_source)
+{
+    burst_queue_drain();
+
+    mp_download_source = p_source;
+}
+
+
+uint32_t antfs_download_region_read(void           * p_context,
+                                    uint16_t         file_index,
+                                    uint32_t         offset,
+                                    uint32_t         length,
+                                    const uint8_t ** pp_data)
+{
+    const antfs_download_region_t * p_region = (const antfs_download_region_t *)p_context;
+
+    UNUSED_PARAMETER(file_index);
+
+    if ((p_region == NULL) || (offset >= p_region->size))
+    {
+        return 0;
+    }
+
+    *pp_data = &(p_region->p_start[offset]);
+
+    return MIN(length, p_region->size - offset);
+}
+
+
 void antfs_channel_setup(void)
 {
     // Start channel configuration.
@@ -2286,6 +2605,8 @@ static void state_machine_reset(void)
     m_is_crc_pending          = false;
     m_is_data_request_pending = false;
 
+    burst_queue_reset();
+
     m_friendly_name.is_name_set = false;
     m_friendly_name.index       = 0;
 
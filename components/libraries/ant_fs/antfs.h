@@ -101,6 +101,7 @@ All rights reserved.
 
 #define ANTFS_MAX_FILE_SIZE               0xFFFFFFFFu                                                                                    /**< Maximum file size, as specified by directory structure. */
 #define ANTFS_BURST_BLOCK_SIZE            16u                                                                                            /**< Size of each block of burst data that the client attempts to send when it processes a data request event. */
+#define ANTFS_BURST_SEGMENT_SIZE          512u                                                                                           /**< Size of each segment of burst data read from the download source (bytes, multiple of 8). */
 
 /**@brief ANT-FS beacon status. */
 typedef union
@@ -242,6 +243,40 @@ typedef struct
  * executed while waiting for the burst busy flag. */
 typedef void(*antfs_burst_wait_handler_t)(void);
 
+/**@brief Download data read function.
+ *
+ * Gives direct access to the file data, without copying it. The data could for example be in a
+ * flash region, or in a flash data storage record opened with fds_record_open. It must stay valid
+ * and unchanged until the download is completed or has failed.
+ *
+ * @param[in]  p_context          Context of the download source.
+ * @param[in]  file_index         Index of the file downloaded.
+ * @param[in]  offset             File offset of the requested data.
+ * @param[in]  length             Number of bytes requested.
+ * @param[out] pp_data            Location of the requested data.
+ *
+ * @return Number of bytes available at @p pp_data, up to @p length, or 0 if the data cannot be read.
+ */
+typedef uint32_t (*antfs_download_read_t)(void           * p_context,
+                                          uint16_t         file_index,
+                                          uint32_t         offset,
+                                          uint32_t         length,
+                                          const uint8_t ** pp_data);
+
+/**@brief ANT-FS download data source. */
+typedef struct
+{
+    antfs_download_read_t read;                                 /**< Read function. */
+    void *                p_context;                            /**< Context passed to the read function. */
+} antfs_download_source_t;
+
+/**@brief Memory region download data source context, see @ref antfs_download_region_read. */
+typedef struct
+{
+    const uint8_t * p_start;                                    /**< Start of the region. */
+    uint32_t        size;                                       /**< Size of the region (bytes). */
+} antfs_download_region_t;
+
 /**@brief Function for setting initial ANT-FS configuration parameters.
  *
  * @param[in] p_params                 The initial ANT-FS configuration parameters.
@@ -343,6 +378,41 @@ void antfs_message_process(uint8_t * p_message);
  */
 void antfs_channel_setup(void);
 
+/**@brief Function for setting the source of download data.
+ *
+ * With a download source, ANTFS_EVENT_DOWNLOAD_REQUEST_DATA is not generated. Data is instead read
+ * from the source in segments of ANTFS_BURST_SEGMENT_SIZE bytes, burst directly from the
+ * source memory, and the CRC is updated one segment at a time. The bursts of download responses
+ * are then sent without waiting for the burst handler: the next segment is prepared while the
+ * current one is being transmitted, and @ref antfs_burst_process passes it on as soon as the burst
+ * handler is ready.
+ *
+ * @param[in] p_source            Download source, or NULL to request data from the application.
+ *                                The source structure must stay valid while it is set.
+ */
+void antfs_download_source_set(const antfs_download_source_t * p_source);
+
+/**@brief Function for advancing a pipelined download.
+ *
+ * Never blocks. @ref antfs_message_process calls it for every ANT-FS channel event, including the
+ * burst transfer events (EVENT_TRANSFER_TX_START, EVENT_TRANSFER_NEXT_DATA_BLOCK and
+ * EVENT_TRANSFER_TX_COMPLETED), so the download advances as the burst handler takes segments.
+ * Calling it from elsewhere, for example from the burst wait handler, is optional.
+ */
+void antfs_burst_process(void);
+
+/**@brief Download read function for data in a memory region, such as a flash page.
+ *
+ * @details Use with a context of type @ref antfs_download_region_t. The file index is ignored,
+ *          so a read function that serves several files can call this function with the region
+ *          of the requested file.
+ */
+uint32_t antfs_download_region_read(void           * p_context,
+                                    uint16_t         file_index,
+                                    uint32_t         offset,
+                                    uint32_t         length,
+                                    const uint8_t ** pp_data);
+
 #endif // ANTFS_H__
 
 /**
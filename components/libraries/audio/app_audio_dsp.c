@@ -0,0 +1,216 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_audio_dsp.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "nrf.h"
+#define AUDIO_DSP_SIMD 1
+#else
+#define AUDIO_DSP_SIMD 0
+#endif
+
+#define GAIN_SHIFT  12
+#define Q15_SHIFT   15
+#define DC_SHIFT    16
+
+int16_t const app_audio_resample_16k_8k_coeffs[APP_AUDIO_RESAMPLE_16K_8K_TAPS] =
+{
+       4,    64,    21,  -125,  -106,   224,   317,  -301,
+    -722,   245,  1401,   149, -2572, -1502,  5794, 13493,
+   13493,  5794, -1502, -2572,   149,  1401,   245,  -722,
+    -301,   317,   224,  -106,  -125,    21,    64,     4
+};
+
+
+static int16_t saturate(int32_t value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+
+#if AUDIO_DSP_SIMD
+// Two adjacent samples, read and written without alignment requirements.
+static uint32_t pair_read(int16_t const * p_samples)
+{
+    uint32_t pair;
+    memcpy(&pair, p_samples, sizeof(pair));
+    return pair;
+}
+
+
+static void pair_write(int16_t * p_samples, uint32_t pair)
+{
+    memcpy(p_samples, &pair, sizeof(pair));
+}
+#endif
+
+
+void app_audio_gain(int16_t * p_samples, uint16_t count, int16_t gain)
+{
+    int32_t const round = 1 << (GAIN_SHIFT - 1);
+
+#if AUDIO_DSP_SIMD
+    for (; count >= 2; count -= 2, p_samples += 2)
+    {
+        uint32_t pair = pair_read(p_samples);
+        int32_t  low  = __SSAT((__SMULBB(pair, (uint32_t)gain) + round) >> GAIN_SHIFT, 16);
+        int32_t  high = __SSAT((__SMULTB(pair, (uint32_t)gain) + round) >> GAIN_SHIFT, 16);
+
+        pair_write(p_samples, __PKHBT((uint32_t)low, (uint32_t)high, 16));
+    }
+#endif
+
+    for (; count > 0; count--, p_samples++)
+    {
+        *p_samples = saturate(((int32_t)*p_samples * gain + round) >> GAIN_SHIFT);
+    }
+}
+
+
+void app_audio_dc_filter_init(app_audio_dc_filter_t * p_filter, int16_t pole)
+{
+    p_filter->pole   = pole;
+    p_filter->x_prev = 0;
+    p_filter->y_prev = 0;
+}
+
+
+void app_audio_dc_filter(app_audio_dc_filter_t * p_filter, int16_t * p_samples, uint16_t count)
+{
+    int16_t x_prev = p_filter->x_prev;
+    int32_t y_prev = p_filter->y_prev;
+
+    // y[n] = x[n] - x[n-1] + pole * y[n-1], with y kept in Q15.16. The
+    // recursion depends on the previous output, so there is no SIMD version.
+    for (uint16_t i = 0; i < count; i++)
+    {
+        int16_t x = p_samples[i];
+        int64_t y = ((int64_t)(x - x_prev) * (1 << DC_SHIFT)) +
+                    (((int64_t)p_filter->pole * y_prev) >> Q15_SHIFT);
+
+        if (y > INT32_MAX)
+        {
+            y = INT32_MAX;
+        }
+        else if (y < INT32_MIN)
+        {
+            y = INT32_MIN;
+        }
+
+        y_prev       = (int32_t)y;
+        x_prev       = x;
+        p_samples[i] = saturate((int32_t)((y + (1 << (DC_SHIFT - 1))) >> DC_SHIFT));
+    }
+
+    p_filter->x_prev = x_prev;
+    p_filter->y_prev = y_prev;
+}
+
+
+ret_code_t app_audio_fir_decim_init(app_audio_fir_decim_t * p_fir,
+                                    int16_t const *         p_coeffs,
+                                    uint16_t                num_taps,
+                                    uint8_t                 factor,
+                                    int16_t *               p_state,
+                                    uint16_t                block_size)
+{
+    if ((p_fir == NULL) || (p_coeffs == NULL) || (p_state == NULL) ||
+        (num_taps < 2) || ((num_taps % 2) != 0) || (factor == 0) ||
+        (block_size < factor) || ((block_size % factor) != 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_fir->p_coeffs   = p_coeffs;
+    p_fir->p_state    = p_state;
+    p_fir->num_taps   = num_taps;
+    p_fir->block_size = block_size;
+    p_fir->factor     = factor;
+
+    memset(p_state, 0, (num_taps - 1) * sizeof(int16_t));
+
+    return NRF_SUCCESS;
+}
+
+
+// Dot product of num_taps coefficients and samples, num_taps even.
+static int16_t fir_output(int16_t const * p_coeffs, int16_t const * p_samples, uint16_t num_taps)
+{
+    int64_t acc = 0;
+
+#if AUDIO_DSP_SIMD
+    for (uint16_t k = 0; k < num_taps; k += 2)
+    {
+        acc = (int64_t)__SMLALD(pair_read(&p_coeffs[k]), pair_read(&p_samples[k]), (uint64_t)acc);
+    }
+#else
+    for (uint16_t k = 0; k < num_taps; k++)
+    {
+        acc += (int32_t)p_coeffs[k] * p_samples[k];
+    }
+#endif
+
+    return saturate((int32_t)((acc + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT));
+}
+
+
+uint16_t app_audio_fir_decim(app_audio_fir_decim_t * p_fir,
+                             int16_t const *         p_in,
+                             int16_t *               p_out,
+                             uint16_t                count)
+{
+    uint16_t history   = p_fir->num_taps - 1;
+    uint16_t out_count = 0;
+
+    if ((count > p_fir->block_size) || ((count % p_fir->factor) != 0))
+    {
+        return 0;
+    }
+
+    // Input sample i is stored at p_state[history + i], after the history of
+    // the previous call. The output for input i is computed from p_state[i]
+    // up to and including input i.
+    memcpy(&p_fir->p_state[history], p_in, count * sizeof(int16_t));
+
+    for (uint16_t i = p_fir->factor - 1; i < count; i += p_fir->factor)
+    {
+        p_out[out_count++] = fir_output(p_fir->p_coeffs, &p_fir->p_state[i], p_fir->num_taps);
+    }
+
+    memmove(p_fir->p_state, &p_fir->p_state[count], history * sizeof(int16_t));
+
+    return out_count;
+}
+
+
+ret_code_t app_audio_resample_16k_8k_init(app_audio_fir_decim_t * p_fir,
+                                          int16_t *               p_state,
+                                          uint16_t                block_size)
+{
+    return app_audio_fir_decim_init(p_fir,
+                                    app_audio_resample_16k_8k_coeffs,
+                                    APP_AUDIO_RESAMPLE_16K_8K_TAPS,
+                                    2,
+                                    p_state,
+                                    block_size);
+}
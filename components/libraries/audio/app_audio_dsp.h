@@ -0,0 +1,141 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_audio_dsp Audio processing kernels
+ * @{
+ * @ingroup app_common
+ * @brief Fixed-point kernels for 16-bit audio: gain, DC removal, FIR decimation and
+ *        16 kHz to 8 kHz resampling.
+ *
+ * @details On cores with the DSP extension (Cortex-M4), the kernels use the SIMD instructions
+ *          to process two samples per instruction. On other targets, including host computers,
+ *          plain C versions with identical results are used.
+ */
+
+#ifndef APP_AUDIO_DSP_H__
+#define APP_AUDIO_DSP_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define APP_AUDIO_GAIN_UNITY              4096 /**< Gain value that leaves the samples unchanged (Q3.12). */
+#define APP_AUDIO_RESAMPLE_16K_8K_TAPS    32   /**< Number of taps of the built-in 16 kHz to 8 kHz low-pass filter. */
+
+/**@brief Macro for getting the number of samples needed for the state of a FIR decimator.
+ *
+ * @param[in] NUM_TAPS   Number of filter taps.
+ * @param[in] BLOCK_SIZE Largest number of input samples passed in one call.
+ */
+#define APP_AUDIO_FIR_STATE_SIZE(NUM_TAPS, BLOCK_SIZE) ((NUM_TAPS) - 1 + (BLOCK_SIZE))
+
+/**@brief DC removal filter state. */
+typedef struct
+{
+    int16_t pole;   /**< Pole of the high-pass filter (Q15). Values closer to 32767 give a lower cut-off frequency. */
+    int16_t x_prev; /**< Previous input sample. */
+    int32_t y_prev; /**< Previous output sample (Q15.16). */
+} app_audio_dc_filter_t;
+
+/**@brief FIR decimator state. */
+typedef struct
+{
+    int16_t const * p_coeffs;   /**< Filter coefficients (Q15). The last coefficient is applied to the newest sample. */
+    int16_t *       p_state;    /**< History of input samples, @ref APP_AUDIO_FIR_STATE_SIZE samples. */
+    uint16_t        num_taps;   /**< Number of coefficients. */
+    uint16_t        block_size; /**< Largest number of input samples per call. */
+    uint8_t         factor;     /**< Decimation factor. */
+} app_audio_fir_decim_t;
+
+/**@brief Coefficients of the 16 kHz to 8 kHz low-pass filter (-6 dB at 3.6 kHz, unity DC gain). */
+extern int16_t const app_audio_resample_16k_8k_coeffs[APP_AUDIO_RESAMPLE_16K_8K_TAPS];
+
+/**@brief Function for scaling samples in place, with saturation.
+ *
+ * @param[in,out] p_samples Samples.
+ * @param[in]     count     Number of samples.
+ * @param[in]     gain      Gain (Q3.12), @ref APP_AUDIO_GAIN_UNITY is 1.0.
+ */
+void app_audio_gain(int16_t * p_samples, uint16_t count, int16_t gain);
+
+/**@brief Function for initializing a DC removal filter.
+ *
+ * @param[out] p_filter Filter state.
+ * @param[in]  pole     Pole of the filter (Q15). 32604 (0.995) gives a cut-off of about 13 Hz at
+ *                      16 kHz.
+ */
+void app_audio_dc_filter_init(app_audio_dc_filter_t * p_filter, int16_t pole);
+
+/**@brief Function for removing the DC component of samples in place.
+ *
+ * @param[in,out] p_filter  Filter state.
+ * @param[in,out] p_samples Samples.
+ * @param[in]     count     Number of samples.
+ */
+void app_audio_dc_filter(app_audio_dc_filter_t * p_filter, int16_t * p_samples, uint16_t count);
+
+/**@brief Function for initializing a FIR decimator.
+ *
+ * @param[out] p_fir      Decimator state.
+ * @param[in]  p_coeffs   Filter coefficients (Q15). Must stay valid while the decimator is used.
+ * @param[in]  num_taps   Number of coefficients, even.
+ * @param[in]  factor     Decimation factor.
+ * @param[in]  p_state    Memory for the sample history, of
+ *                        @ref APP_AUDIO_FIR_STATE_SIZE(num_taps, block_size) samples.
+ * @param[in]  block_size Largest number of input samples per call, a multiple of factor.
+ *
+ * @retval NRF_SUCCESS             If the decimator was initialized.
+ * @retval NRF_ERROR_INVALID_PARAM If a parameter is out of range.
+ */
+ret_code_t app_audio_fir_decim_init(app_audio_fir_decim_t * p_fir,
+                                    int16_t const *         p_coeffs,
+                                    uint16_t                num_taps,
+                                    uint8_t                 factor,
+                                    int16_t *               p_state,
+                                    uint16_t                block_size);
+
+/**@brief Function for filtering and decimating a block of samples.
+ *
+ * @param[in,out] p_fir Decimator state.
+ * @param[in]     p_in  Input samples.
+ * @param[out]    p_out Output samples, count / factor samples. May be the same as p_in.
+ * @param[in]     count Number of input samples, a multiple of factor and at most block_size.
+ *
+ * @return Number of output samples.
+ */
+uint16_t app_audio_fir_decim(app_audio_fir_decim_t * p_fir,
+                             int16_t const *         p_in,
+                             int16_t *               p_out,
+                             uint16_t                count);
+
+/**@brief Function for initializing a 16 kHz to 8 kHz resampler.
+ *
+ * @details The resampler is a FIR decimator by 2 using @ref app_audio_resample_16k_8k_coeffs.
+ *          Samples are resampled with @ref app_audio_fir_decim.
+ *
+ * @param[out] p_fir      Decimator state.
+ * @param[in]  p_state    Memory for the sample history, of
+ *                        @ref APP_AUDIO_FIR_STATE_SIZE(APP_AUDIO_RESAMPLE_16K_8K_TAPS, block_size)
+ *                        samples.
+ * @param[in]  block_size Largest number of input samples per call, even.
+ *
+ * @retval NRF_SUCCESS             If the resampler was initialized.
+ * @retval NRF_ERROR_INVALID_PARAM If a parameter is out of range.
+ */
+ret_code_t app_audio_resample_16k_8k_init(app_audio_fir_decim_t * p_fir,
+                                          int16_t *               p_state,
+                                          uint16_t                block_size);
+
+#endif // APP_AUDIO_DSP_H__
+
+/** @} */
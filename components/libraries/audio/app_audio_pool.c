@@ -0,0 +1,157 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_audio_pool.h"
+#include <stddef.h>
+#include "app_util_platform.h"
+
+#define POOL_SPARE_IDX(p_pool) ((uint8_t)((p_pool)->block_count - 1))
+
+
+static void queue_push(app_audio_pool_queue_t * p_queue, uint8_t idx)
+{
+    uint8_t pos = (uint8_t)((p_queue->read_pos + p_queue->count) % APP_AUDIO_POOL_MAX_BLOCKS);
+
+    p_queue->idx[pos] = idx;
+    p_queue->count++;
+}
+
+
+static uint8_t queue_pop(app_audio_pool_queue_t * p_queue)
+{
+    uint8_t idx = p_queue->idx[p_queue->read_pos];
+
+    p_queue->read_pos = (uint8_t)((p_queue->read_pos + 1) % APP_AUDIO_POOL_MAX_BLOCKS);
+    p_queue->count--;
+    return idx;
+}
+
+
+static int16_t * block_get(app_audio_pool_t const * p_pool, uint8_t idx)
+{
+    return &p_pool->p_memory[(uint32_t)idx * p_pool->block_size];
+}
+
+
+static uint8_t block_idx(app_audio_pool_t const * p_pool, int16_t const * p_block)
+{
+    return (uint8_t)((uint32_t)(p_block - p_pool->p_memory) / p_pool->block_size);
+}
+
+
+ret_code_t app_audio_pool_init(app_audio_pool_t * p_pool,
+                               int16_t *          p_memory,
+                               uint16_t           block_size,
+                               uint8_t            block_count)
+{
+    if ((p_pool == NULL) || (p_memory == NULL) || (block_size == 0) ||
+        (block_count < 3) || (block_count > APP_AUDIO_POOL_MAX_BLOCKS))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_pool->p_memory    = p_memory;
+    p_pool->block_size  = block_size;
+    p_pool->block_count = block_count;
+    app_audio_pool_reset(p_pool);
+
+    return NRF_SUCCESS;
+}
+
+
+void app_audio_pool_reset(app_audio_pool_t * p_pool)
+{
+    CRITICAL_REGION_ENTER();
+    p_pool->free.read_pos  = 0;
+    p_pool->free.count     = 0;
+    p_pool->ready.read_pos = 0;
+    p_pool->ready.count    = 0;
+    for (uint8_t idx = 0; idx < POOL_SPARE_IDX(p_pool); idx++)
+    {
+        queue_push(&p_pool->free, idx);
+    }
+    p_pool->overruns  = 0;
+    p_pool->underruns = 0;
+    CRITICAL_REGION_EXIT();
+}
+
+
+int16_t * app_audio_pool_fill_get(app_audio_pool_t * p_pool)
+{
+    uint8_t idx;
+
+    CRITICAL_REGION_ENTER();
+    if (p_pool->free.count != 0)
+    {
+        idx = queue_pop(&p_pool->free);
+    }
+    else
+    {
+        // The consumer has fallen behind. Overwrite the oldest audio, or
+        // drop the new audio if the consumer holds every block.
+        p_pool->overruns++;
+        idx = (p_pool->ready.count != 0) ? queue_pop(&p_pool->ready) : POOL_SPARE_IDX(p_pool);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return block_get(p_pool, idx);
+}
+
+
+void app_audio_pool_fill_done(app_audio_pool_t * p_pool, int16_t const * p_block)
+{
+    uint8_t idx = block_idx(p_pool, p_block);
+
+    if (idx == POOL_SPARE_IDX(p_pool))
+    {
+        return;
+    }
+
+    CRITICAL_REGION_ENTER();
+    queue_push(&p_pool->ready, idx);
+    CRITICAL_REGION_EXIT();
+}
+
+
+int16_t * app_audio_pool_get(app_audio_pool_t * p_pool)
+{
+    int16_t * p_block = NULL;
+
+    CRITICAL_REGION_ENTER();
+    if (p_pool->ready.count != 0)
+    {
+        p_block = block_get(p_pool, queue_pop(&p_pool->ready));
+    }
+    else
+    {
+        p_pool->underruns++;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return p_block;
+}
+
+
+void app_audio_pool_release(app_audio_pool_t * p_pool, int16_t const * p_block)
+{
+    uint8_t idx = block_idx(p_pool, p_block);
+
+    CRITICAL_REGION_ENTER();
+    queue_push(&p_pool->free, idx);
+    CRITICAL_REGION_EXIT();
+}
+
+
+uint8_t app_audio_pool_ready_count(app_audio_pool_t const * p_pool)
+{
+    return p_pool->ready.count;
+}
@@ -0,0 +1,149 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_audio_pool Audio buffer pool
+ * @{
+ * @ingroup app_common
+ * @brief Module for passing blocks of audio samples from an interrupt to a consumer.
+ *
+ * @details The pool divides a memory area into blocks of equal size. Blocks circulate between
+ *          a free queue and a ready queue:
+ *          - The producer (typically a PDM or I2S interrupt) takes a free block with
+ *            @ref app_audio_pool_fill_get, lets EasyDMA fill it, and passes it on with
+ *            @ref app_audio_pool_fill_done.
+ *          - The consumer takes filled blocks with @ref app_audio_pool_get in the order they were
+ *            produced, and returns them with @ref app_audio_pool_release.
+ *
+ *          The consumer may hold several blocks at a time and may fall behind by up to the number
+ *          of blocks in the pool without any audio being lost.
+ *
+ *          When the producer needs a block and none is free, the oldest block that is waiting for
+ *          the consumer is reused, and the overrun counter is incremented. If the consumer holds
+ *          all blocks, the last block of the pool, which is reserved for this purpose, is handed
+ *          out and its contents are dropped. The producer therefore always gets a block. When the
+ *          consumer asks for a block and none is ready, the underrun counter is incremented.
+ *
+ *          With the PDM driver, the pool is connected through the buffer request handler, so that
+ *          EasyDMA writes directly into the pool blocks:
+ *          @code
+ *          static int16_t * pdm_buffer_request(void)
+ *          {
+ *              return app_audio_pool_fill_get(&m_pool);
+ *          }
+ *
+ *          static void pdm_event_handler(uint32_t * p_buffer, uint16_t length)
+ *          {
+ *              app_audio_pool_fill_done(&m_pool, (int16_t *)p_buffer);
+ *          }
+ *          @endcode
+ *          With the I2S driver, which uses a single buffer in halves, the data handler copies the
+ *          received half into a block from @ref app_audio_pool_fill_get.
+ *
+ * @note All functions can be called from any interrupt priority.
+ */
+
+#ifndef APP_AUDIO_POOL_H__
+#define APP_AUDIO_POOL_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define APP_AUDIO_POOL_MAX_BLOCKS 16 /**< Maximum number of blocks in a pool, including the reserved block. */
+
+/**@brief Queue of block indexes. */
+typedef struct
+{
+    uint8_t idx[APP_AUDIO_POOL_MAX_BLOCKS]; /**< Block indexes. */
+    uint8_t read_pos;                       /**< Position of the oldest element. */
+    uint8_t count;                          /**< Number of elements. */
+} app_audio_pool_queue_t;
+
+/**@brief Audio buffer pool. */
+typedef struct
+{
+    int16_t *              p_memory;    /**< Sample memory, block_count * block_size samples. */
+    uint16_t               block_size;  /**< Number of samples in a block. */
+    uint8_t                block_count; /**< Number of blocks, including the reserved block. */
+    app_audio_pool_queue_t free;        /**< Blocks available to the producer. */
+    app_audio_pool_queue_t ready;       /**< Filled blocks waiting for the consumer. */
+    uint32_t               overruns;    /**< Number of blocks dropped because the consumer fell behind. */
+    uint32_t               underruns;   /**< Number of times the consumer found no block ready. */
+} app_audio_pool_t;
+
+/**@brief Function for initializing a pool.
+ *
+ * @param[out] p_pool      Pool.
+ * @param[in]  p_memory    Sample memory. Must be word aligned to be usable by EasyDMA.
+ * @param[in]  block_size  Number of samples in a block.
+ * @param[in]  block_count Number of blocks in the memory, from 3 to @ref APP_AUDIO_POOL_MAX_BLOCKS.
+ *                         The last block is reserved for overruns.
+ *
+ * @retval NRF_SUCCESS             If the pool was initialized.
+ * @retval NRF_ERROR_INVALID_PARAM If a parameter is out of range.
+ */
+ret_code_t app_audio_pool_init(app_audio_pool_t * p_pool,
+                               int16_t *          p_memory,
+                               uint16_t           block_size,
+                               uint8_t            block_count);
+
+/**@brief Function for returning all blocks to the free queue and clearing the counters.
+ *
+ * @details Call this function after the producer has been stopped, so that blocks handed out to
+ *          the producer but never filled are recovered.
+ *
+ * @param[in,out] p_pool Pool.
+ */
+void app_audio_pool_reset(app_audio_pool_t * p_pool);
+
+/**@brief Function for getting a block to be filled by the producer.
+ *
+ * @param[in,out] p_pool Pool.
+ *
+ * @return Block of block_size samples. Never NULL.
+ */
+int16_t * app_audio_pool_fill_get(app_audio_pool_t * p_pool);
+
+/**@brief Function for passing a filled block to the consumer.
+ *
+ * @param[in,out] p_pool  Pool.
+ * @param[in]     p_block Block previously obtained with @ref app_audio_pool_fill_get.
+ */
+void app_audio_pool_fill_done(app_audio_pool_t * p_pool, int16_t const * p_block);
+
+/**@brief Function for getting the oldest filled block.
+ *
+ * @param[in,out] p_pool Pool.
+ *
+ * @return Block of block_size samples, or NULL if no block is ready.
+ */
+int16_t * app_audio_pool_get(app_audio_pool_t * p_pool);
+
+/**@brief Function for returning a block to the pool after it has been consumed.
+ *
+ * @param[in,out] p_pool  Pool.
+ * @param[in]     p_block Block previously obtained with @ref app_audio_pool_get.
+ */
+void app_audio_pool_release(app_audio_pool_t * p_pool, int16_t const * p_block);
+
+/**@brief Function for getting the number of filled blocks waiting for the consumer.
+ *
+ * @param[in] p_pool Pool.
+ *
+ * @return Number of ready blocks.
+ */
+uint8_t app_audio_pool_ready_count(app_audio_pool_t const * p_pool);
+
+#endif // APP_AUDIO_POOL_H__
+
+/** @} */
@@ -17,6 +17,19 @@
 #include "nrf_assert.h"
 #include "sdk_common.h"
 
+#ifndef APP_TIMER_PRESCALER
+#define APP_TIMER_PRESCALER 0
+#endif
+
+#define HW_CONCAT_3(p1, p2, p3)  CONCAT_3(p1, p2, p3)
+#define HW_TIMER_INSTANCE(id)    NRF_DRV_TIMER_INSTANCE(id)
+
+#if defined(APP_BUTTON_HW_DEBOUNCE_TIMER) && HW_CONCAT_3(TIMER, APP_BUTTON_HW_DEBOUNCE_TIMER, _ENABLED)
+#define HW_DEBOUNCE_ENABLED 1
+#else
+#define HW_DEBOUNCE_ENABLED 0
+#endif
+
 static app_button_cfg_t *             mp_buttons = NULL;           /**< Button configuration. */
 static uint8_t                        m_button_count;              /**< Number of configured buttons. */
 static uint32_t                       m_detection_delay;           /**< Delay before a button is reported as pushed. */
@@ -25,23 +38,246 @@ APP_TIMER_DEF(m_detection_delay_timer_id);  /**< Polling timer id. */
 
 static uint32_t m_pin_state;
 static uint32_t m_pin_transition;
+static uint32_t m_last_edge_ticks;          /**< RTC counter value at the last GPIOTE event. */
+static bool     m_detection_pending;        /**< The detection delay timer is running. */
+static uint32_t m_hw_pins;                  /**< Pins debounced by the TIMER instead of the app_timer. */
+
+/**@brief Function for reporting a debounced button level to the button handler. */
+static void button_report(app_button_cfg_t const * p_btn, bool pin_is_set)
+{
+    uint32_t transition = !(pin_is_set ^ (p_btn->active_state == APP_BUTTON_ACTIVE_HIGH));
+
+    if (p_btn->button_handler)
+    {
+        p_btn->button_handler(p_btn->pin_no, transition);
+    }
+}
+
+#if HW_DEBOUNCE_ENABLED
+#include "nrf_drv_timer.h"
+#include "nrf_drv_ppi.h"
+
+#define HW_TIMER_FREQ_HZ    31250                       /**< Matches NRF_TIMER_FREQ_31250Hz. */
+#define HW_TIMER_CC         NRF_TIMER_CC_CHANNEL0
+#define HW_WINDOW_MAX       0xFFFF                      /**< Largest window for a 16 bit TIMER. */
+#define HW_PPI_MAX          (2 * NUMBER_OF_GPIO_TE)     /**< Two channels per pin when forks are not available. */
+
+static nrf_drv_timer_t const m_hw_timer = HW_TIMER_INSTANCE(APP_BUTTON_HW_DEBOUNCE_TIMER);
+static bool                  m_hw_ready;                /**< TIMER and PPI are initialized. */
+static uint32_t              m_hw_state;                /**< Last reported level of the TIMER debounced pins. */
+static nrf_ppi_channel_t     m_hw_ppi[HW_PPI_MAX];
+static uint8_t               m_hw_ppi_count;
+
+/**@brief Function for handling the end of a debounce window.
+ *
+ * @details Every edge on a TIMER debounced pin clears and starts the TIMER through PPI, so the
+ *          compare event only fires once all those pins have been stable for the detection
+ *          delay. The TIMER stops itself on the compare event.
+ */
+static void hw_timer_event_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    uint32_t pins    = nrf_gpio_pins_read() & m_hw_pins;
+    uint32_t changed = pins ^ m_hw_state;
+
+    m_hw_state = pins;
+
+    for (uint8_t i = 0; (i < m_button_count) && (changed != 0); i++)
+    {
+        app_button_cfg_t * p_btn    = &mp_buttons[i];
+        uint32_t           btn_mask = 1 << p_btn->pin_no;
+
+        if (changed & btn_mask)
+        {
+            changed &= ~btn_mask;
+            button_report(p_btn, (pins & btn_mask) != 0);
+        }
+    }
+}
+
+/**@brief Function for setting up the TIMER that measures the debounce windows.
+ *
+ * @param[in]  detection_delay  Window length in app_timer ticks.
+ */
+static void hw_init(uint32_t detection_delay)
+{
+    nrf_drv_timer_config_t config = NRF_DRV_TIMER_DEFAULT_CONFIG(APP_BUTTON_HW_DEBOUNCE_TIMER);
+    uint32_t               window;
+    uint32_t               err_code;
+
+    m_hw_ready     = false;
+    m_hw_state     = 0;
+    m_hw_ppi_count = 0;
+
+    window = (uint32_t)ROUNDED_DIV((uint64_t)detection_delay * (APP_TIMER_PRESCALER + 1) * HW_TIMER_FREQ_HZ,
+                                   APP_TIMER_CLOCK_FREQ);
+    if (window > HW_WINDOW_MAX)
+    {
+        return;
+    }
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != MODULE_ALREADY_INITIALIZED))
+    {
+        return;
+    }
+
+    config.frequency = NRF_TIMER_FREQ_31250Hz;
+    config.bit_width = NRF_TIMER_BIT_WIDTH_16;
+    config.mode      = NRF_TIMER_MODE_TIMER;
+    if (nrf_drv_timer_init(&m_hw_timer, &config, hw_timer_event_handler) != NRF_SUCCESS)
+    {
+        return;
+    }
+
+    // The TIMER is only started by PPI, so it does not run between bounce bursts.
+    nrf_drv_timer_extended_compare(&m_hw_timer,
+                                   HW_TIMER_CC,
+                                   MAX(window, 1),
+                                   (nrf_timer_short_mask_t)(NRF_TIMER_SHORT_COMPARE0_STOP_MASK |
+                                                            NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK),
+                                   true);
+    m_hw_ready = true;
+}
+
+/**@brief Function for connecting a GPIOTE IN event to the clear and start tasks of the TIMER. */
+static uint32_t hw_ppi_connect(uint32_t eep)
+{
+    uint32_t tep_clear = nrf_drv_timer_task_address_get(&m_hw_timer, NRF_TIMER_TASK_CLEAR);
+    uint32_t tep_start = nrf_drv_timer_task_address_get(&m_hw_timer, NRF_TIMER_TASK_START);
+    uint32_t err_code;
+
+    if (m_hw_ppi_count >= HW_PPI_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    err_code = nrf_drv_ppi_channel_alloc(&m_hw_ppi[m_hw_ppi_count]);
+    VERIFY_SUCCESS(err_code);
+    m_hw_ppi_count++;
+
+    err_code = nrf_drv_ppi_channel_assign(m_hw_ppi[m_hw_ppi_count - 1], eep, tep_clear);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_ppi_channel_fork_assign(m_hw_ppi[m_hw_ppi_count - 1], tep_start);
+    if (err_code != NRF_ERROR_NOT_SUPPORTED)
+    {
+        return err_code;
+    }
+
+    // No fork endpoints (nRF51), a second channel starts the TIMER.
+    if (m_hw_ppi_count >= HW_PPI_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    err_code = nrf_drv_ppi_channel_alloc(&m_hw_ppi[m_hw_ppi_count]);
+    VERIFY_SUCCESS(err_code);
+    m_hw_ppi_count++;
+
+    return nrf_drv_ppi_channel_assign(m_hw_ppi[m_hw_ppi_count - 1], eep, tep_start);
+}
+
+/**@brief Function for moving a button to TIMER debouncing.
+ *
+ * @details Needs a GPIOTE IN channel and one or two PPI channels. When any of them is not
+ *          available the button is left to the app_timer based debouncing.
+ *
+ * @retval true   The button is debounced by the TIMER.
+ * @retval false  The button must use the GPIOTE PORT event.
+ */
+static bool hw_button_claim(app_button_cfg_t const * p_btn)
+{
+    nrf_drv_gpiote_in_config_t config    = GPIOTE_CONFIG_IN_SENSE_TOGGLE(true);
+    uint8_t                    ppi_count = m_hw_ppi_count;
+
+    if (!m_hw_ready)
+    {
+        return false;
+    }
+
+    config.pull = p_btn->pull_cfg;
+    if (nrf_drv_gpiote_in_init(p_btn->pin_no, &config, NULL) != NRF_SUCCESS)
+    {
+        return false;
+    }
+
+    if (hw_ppi_connect(nrf_drv_gpiote_in_event_addr_get(p_btn->pin_no)) != NRF_SUCCESS)
+    {
+        while (m_hw_ppi_count > ppi_count)
+        {
+            (void)nrf_drv_ppi_channel_free(m_hw_ppi[--m_hw_ppi_count]);
+        }
+        nrf_drv_gpiote_in_uninit(p_btn->pin_no);
+        return false;
+    }
+
+    m_hw_pins |= 1 << p_btn->pin_no;
+    return true;
+}
+
+static uint32_t hw_enable(void)
+{
+    uint32_t err_code;
+
+    m_hw_state = nrf_gpio_pins_read() & m_hw_pins;
+
+    for (uint8_t i = 0; i < m_hw_ppi_count; i++)
+    {
+        err_code = nrf_drv_ppi_channel_enable(m_hw_ppi[i]);
+        VERIFY_SUCCESS(err_code);
+    }
+    return NRF_SUCCESS;
+}
+
+static void hw_disable(void)
+{
+    for (uint8_t i = 0; i < m_hw_ppi_count; i++)
+    {
+        (void)nrf_drv_ppi_channel_disable(m_hw_ppi[i]);
+    }
+
+    if (m_hw_ready)
+    {
+        nrf_timer_task_trigger(m_hw_timer.p_reg, NRF_TIMER_TASK_STOP);
+        nrf_timer_task_trigger(m_hw_timer.p_reg, NRF_TIMER_TASK_CLEAR);
+        nrf_timer_event_clear(m_hw_timer.p_reg, NRF_TIMER_EVENT_COMPARE0);
+    }
+}
+#else
+#define hw_init(detection_delay)
+#define hw_button_claim(p_btn)  false
+#define hw_enable()             NRF_SUCCESS
+#define hw_disable()
+#endif // HW_DEBOUNCE_ENABLED
 
 /**@brief Function for handling the timeout that delays reporting buttons as pushed.
  *
  * @details    The detection_delay_timeout_handler(...) is a call-back issued from the app_timer
- *             module. It is called with the p_context parameter. The p_context parameter is
- *             provided to the app_timer module when a timer is started, using the call
- *             @ref app_timer_start. On @ref app_timer_start the p_context will be holding the
- *             currently pressed buttons.
+ *             module. The timer is not restarted on every bounce. Instead, the handler re-arms it
+ *             until no GPIOTE event has been seen for the full detection delay, and only then
+ *             reports the pins that changed level.
  *
- * @param[in]  p_context   Pointer used for passing information app_start_timer() was called.
- *                         In the app_button module the p_context holds information on pressed
- *                         buttons.
+ * @param[in]  p_context   Not used.
  */
 static void detection_delay_timeout_handler(void * p_context)
 {
-    uint8_t i;
-    
+    uint8_t  i;
+    uint32_t now;
+    uint32_t quiet;
+
+    (void)app_timer_cnt_get(&now);
+    (void)app_timer_cnt_diff_compute(now, m_last_edge_ticks, &quiet);
+
+    if (quiet < m_detection_delay)
+    {
+        // Still bouncing, wait for the rest of the quiet period.
+        uint32_t remaining = MAX(m_detection_delay - quiet, APP_TIMER_MIN_TIMEOUT_TICKS);
+
+        if (app_timer_start(m_detection_delay_timer_id, remaining, NULL) == NRF_SUCCESS)
+        {
+            return;
+        }
+    }
+    m_detection_pending = false;
+
     // Pushed button(s) detected, execute button handler(s).
     for (i = 0; i < m_button_count; i++)
     {
@@ -53,12 +289,7 @@ static void detection_delay_timeout_handler(void * p_context)
             bool pin_is_set = nrf_drv_gpiote_in_is_set(p_btn->pin_no);
             if ((m_pin_state & (1 << p_btn->pin_no)) == (pin_is_set << p_btn->pin_no))
             {
-                uint32_t transition = !(pin_is_set ^ (p_btn->active_state == APP_BUTTON_ACTIVE_HIGH));
-
-                if (p_btn->button_handler)
-                {
-                    p_btn->button_handler(p_btn->pin_no, transition);
-                }
+                button_report(p_btn, pin_is_set);
             }
         }
     }
@@ -69,17 +300,9 @@ static void gpiote_event_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t
     uint32_t err_code;
     uint32_t pin_mask = 1 << pin;
 
-    // Start detection timer. If timer is already running, the detection period is restarted.
-    // NOTE: Using the p_context parameter of app_timer_start() to transfer the pin states to the
-    //       timeout handler (by casting event_pins_mask into the equally sized void * p_context
-    //       parameter).
-    err_code = app_timer_stop(m_detection_delay_timer_id);
-    if (err_code != NRF_SUCCESS)
-    {
-        // The impact in app_button of the app_timer queue running full is losing a button press.
-        // The current implementation ensures that the system will continue working as normal.
-        return;
-    }
+    // Only stamp the edge. A running detection timer is left alone and re-armed by the timeout
+    // handler, so a bounce burst costs one app_timer operation instead of two per edge.
+    (void)app_timer_cnt_get(&m_last_edge_ticks);
 
     if (!(m_pin_transition & pin_mask))
     {
@@ -93,11 +316,15 @@ static void gpiote_event_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t
         }
         m_pin_transition |= (pin_mask);
 
-        err_code = app_timer_start(m_detection_delay_timer_id, m_detection_delay, NULL);
-        if (err_code != NRF_SUCCESS)
+        if (!m_detection_pending)
         {
-            // The impact in app_button of the app_timer queue running full is losing a button press.
-            // The current implementation ensures that the system will continue working as normal.
+            err_code = app_timer_start(m_detection_delay_timer_id, m_detection_delay, NULL);
+            if (err_code == NRF_SUCCESS)
+            {
+                m_detection_pending = true;
+            }
+            // Otherwise the app_timer queue is full. The impact in app_button is losing a button
+            // press, the system will continue working as normal.
         }
     }
     else
@@ -128,13 +355,22 @@ uint32_t app_button_init(app_button_cfg_t *             p_buttons,
     m_button_count      = button_count;
     m_detection_delay   = detection_delay;
 
-    m_pin_state      = 0;
-    m_pin_transition = 0;
-    
+    m_pin_state         = 0;
+    m_pin_transition    = 0;
+    m_detection_pending = false;
+    m_hw_pins           = 0;
+
+    hw_init(detection_delay);
+
     while (button_count--)
     {
         app_button_cfg_t * p_btn = &p_buttons[button_count];
 
+        if (hw_button_claim(p_btn))
+        {
+            continue;
+        }
+
         nrf_drv_gpiote_in_config_t config = GPIOTE_CONFIG_IN_SENSE_TOGGLE(false);
         config.pull = p_btn->pull_cfg;
         
@@ -155,10 +391,13 @@ uint32_t app_button_enable(void)
     uint32_t i;
     for (i = 0; i < m_button_count; i++)
     {
-        nrf_drv_gpiote_in_event_enable(mp_buttons[i].pin_no, true);
+        // TIMER debounced pins only feed PPI and never interrupt on an edge.
+        bool int_enable = !(m_hw_pins & (1 << mp_buttons[i].pin_no));
+
+        nrf_drv_gpiote_in_event_enable(mp_buttons[i].pin_no, int_enable);
     }
 
-    return NRF_SUCCESS;
+    return hw_enable();
 }
 
 
@@ -172,7 +411,12 @@ uint32_t app_button_disable(void)
        nrf_drv_gpiote_in_event_disable(mp_buttons[i].pin_no);
     }
 
-    // Make sure polling timer is not running.
+    hw_disable();
+
+    // Make sure polling timer is not running, and drop the transitions it was timing. Edges are
+    // not seen while disabled, so they could not be matched after the next enable.
+    m_detection_pending = false;
+    m_pin_transition    = 0;
     return app_timer_stop(m_detection_delay_timer_id);
 }
 
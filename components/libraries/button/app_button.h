@@ -21,13 +21,19 @@
  * @details The button handler uses the @ref app_gpiote to detect that a button has been
  *          pushed. To handle debouncing, it will start a timer in the GPIOTE event handler.
  *          The button will only be reported as pushed if the corresponding pin is still active when
- *          the timer expires. If there is a new GPIOTE event while the timer is running, the timer
- *          is restarted.
+ *          the timer expires. If there are new GPIOTE events while the timer is running, the timer
+ *          is re-armed on expiry until no event has been seen for the full detection delay.
+ *
+ * @details If @ref APP_BUTTON_HW_DEBOUNCE_TIMER is defined and that TIMER instance is enabled in
+ *          nrf_drv_config.h, buttons are debounced in hardware as long as GPIOTE IN channels and
+ *          PPI channels are available. Each edge clears and starts the TIMER through PPI, and the
+ *          CPU is only woken up by the TIMER compare event once the pins have been stable for the
+ *          detection delay. The remaining buttons use the GPIOTE PORT event and the app_timer.
  *
  * @note    The app_button module uses the app_timer module. The user must ensure that the queue in
- *          app_timer is large enough to hold the app_timer_stop() / app_timer_start() operations
- *          which will be executed on each event from GPIOTE module (2 operations), as well as other
- *          app_timer operations queued simultaneously in the application.
+ *          app_timer is large enough to hold the app_timer_start() operation executed at the start
+ *          of each debounce period, as well as other app_timer operations queued simultaneously in
+ *          the application.
  *
  * @note    Even if the scheduler is not used, app_button.h will include app_scheduler.h, so when
  *          compiling, app_scheduler.h must be available in one of the compiler include paths.
@@ -47,6 +53,10 @@
 #define APP_BUTTON_ACTIVE_HIGH 1                               /**< Indicates that a button is active high. */
 #define APP_BUTTON_ACTIVE_LOW  0                               /**< Indicates that a button is active low. */
 
+#ifdef DOXYGEN
+#define APP_BUTTON_HW_DEBOUNCE_TIMER 1                         /**< TIMER instance used for hardware debouncing. Not defined by default. */
+#endif
+
 /**@brief Button event handler type. */
 typedef void (*app_button_handler_t)(uint8_t pin_no, uint8_t button_action);
 
@@ -0,0 +1,181 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "decimator.h"
+#include <stddef.h>
+#include <string.h>
+
+
+// Divides with rounding to the nearest integer, halves away from zero.
+static int32_t div_round(int32_t value, int32_t divisor)
+{
+    if (value >= 0)
+    {
+        return (value + (divisor / 2)) / divisor;
+    }
+    return (value - (divisor / 2)) / divisor;
+}
+
+
+// Arithmetic right shift with rounding that does not depend on how the
+// compiler shifts negative numbers.
+static int32_t shift_round(int32_t value, uint8_t shift)
+{
+    if (shift == 0)
+    {
+        return value;
+    }
+    return div_round(value, (int32_t)1 << shift);
+}
+
+
+static int16_t saturate(int32_t value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+
+ret_code_t decimator_init(decimator_t * p_decimator, decimator_config_t const * p_config)
+{
+    if ((p_decimator == NULL) || (p_config == NULL) || (p_config->factor == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    switch (p_config->filter)
+    {
+        case DECIMATOR_FILTER_AVERAGE:
+            break;
+
+        case DECIMATOR_FILTER_CIC2:
+            if (p_config->factor > DECIMATOR_CIC2_MAX_FACTOR)
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+            break;
+
+        case DECIMATOR_FILTER_EMA:
+            if (p_config->ema_shift > DECIMATOR_EMA_MAX_SHIFT)
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+            break;
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_decimator->config = *p_config;
+    decimator_reset(p_decimator);
+
+    return NRF_SUCCESS;
+}
+
+
+void decimator_reset(decimator_t * p_decimator)
+{
+    memset(p_decimator->acc,   0, sizeof(p_decimator->acc));
+    memset(p_decimator->delay, 0, sizeof(p_decimator->delay));
+    p_decimator->count = 0;
+}
+
+
+bool decimator_put(decimator_t * p_decimator, int16_t sample, int16_t * p_out)
+{
+    uint16_t factor = p_decimator->config.factor;
+    int32_t  result;
+
+    switch (p_decimator->config.filter)
+    {
+        case DECIMATOR_FILTER_AVERAGE:
+            p_decimator->acc[0] += (uint32_t)(int32_t)sample;
+            if (++p_decimator->count < factor)
+            {
+                return false;
+            }
+            result = div_round((int32_t)p_decimator->acc[0], factor);
+            p_decimator->acc[0] = 0;
+            break;
+
+        case DECIMATOR_FILTER_CIC2:
+        {
+            // The integrators are allowed to wrap around, the combs undo it.
+            p_decimator->acc[0] += (uint32_t)(int32_t)sample;
+            p_decimator->acc[1] += p_decimator->acc[0];
+            if (++p_decimator->count < factor)
+            {
+                return false;
+            }
+            uint32_t comb1 = p_decimator->acc[1] - p_decimator->delay[0];
+            uint32_t comb2 = comb1               - p_decimator->delay[1];
+            p_decimator->delay[0] = p_decimator->acc[1];
+            p_decimator->delay[1] = comb1;
+            result = div_round((int32_t)comb2, (int32_t)factor * factor);
+            break;
+        }
+
+        case DECIMATOR_FILTER_EMA:
+        {
+            // The state holds the filtered value scaled by 2^ema_shift.
+            int32_t state = (int32_t)p_decimator->acc[0];
+            if (p_decimator->delay[0] == 0)
+            {
+                // Start from the first sample instead of ramping up from zero.
+                state = (int32_t)sample * ((int32_t)1 << p_decimator->config.ema_shift);
+                p_decimator->delay[0] = 1;
+            }
+            state += (int32_t)sample - shift_round(state, p_decimator->config.ema_shift);
+            p_decimator->acc[0] = (uint32_t)state;
+            if (++p_decimator->count < factor)
+            {
+                return false;
+            }
+            result = shift_round(state, p_decimator->config.ema_shift);
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    p_decimator->count = 0;
+    *p_out = saturate(result);
+    return true;
+}
+
+
+uint16_t decimator_process(decimator_t *   p_decimator,
+                           int16_t const * p_in,
+                           uint16_t        in_count,
+                           uint16_t        stride,
+                           int16_t *       p_out)
+{
+    uint16_t out_count = 0;
+
+    for (uint16_t i = 0; i < in_count; i++)
+    {
+        if (decimator_put(p_decimator, p_in[i * stride], &p_out[out_count]))
+        {
+            out_count++;
+        }
+    }
+
+    return out_count;
+}
@@ -0,0 +1,111 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup decimator Fixed-point decimator
+ * @{
+ * @ingroup app_common
+ * @brief Module for filtering a stream of samples and reducing its rate.
+ *
+ * @details A decimator takes one input sample at a time and produces one output sample for every
+ *          @ref decimator_config_t::factor input samples. The filter that is applied before the
+ *          rate reduction is selectable. All arithmetic is done in fixed point, and the module
+ *          depends on nothing but the standard integer types, so it can also be compiled and
+ *          verified on a host computer.
+ */
+
+#ifndef DECIMATOR_H__
+#define DECIMATOR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#define DECIMATOR_CIC2_MAX_FACTOR  256 /**< Largest decimation factor of @ref DECIMATOR_FILTER_CIC2 for which 16-bit samples cannot overflow the integrators. */
+#define DECIMATOR_EMA_MAX_SHIFT    15  /**< Largest smoothing shift of @ref DECIMATOR_FILTER_EMA. */
+
+/**@brief Filters applied before the rate reduction. */
+typedef enum
+{
+    DECIMATOR_FILTER_AVERAGE, /**< Mean of the last factor samples (boxcar). */
+    DECIMATOR_FILTER_CIC2,    /**< Second-order cascaded integrator-comb. Better alias rejection than the average, at the cost of two extra additions per sample. */
+    DECIMATOR_FILTER_EMA,     /**< Exponential moving average with a time constant of 2^ema_shift samples. The output is the filter state at every factor-th sample. */
+} decimator_filter_t;
+
+/**@brief Decimator configuration. */
+typedef struct
+{
+    decimator_filter_t filter;    /**< Filter type. */
+    uint16_t           factor;    /**< Number of input samples per output sample. */
+    uint8_t            ema_shift; /**< Smoothing shift, used only by @ref DECIMATOR_FILTER_EMA. */
+} decimator_config_t;
+
+/**@brief Decimator state. */
+typedef struct
+{
+    decimator_config_t config;     /**< Configuration. */
+    uint32_t           acc[2];     /**< Accumulators (average sum, CIC integrators, or EMA state). */
+    uint32_t           delay[2];   /**< CIC comb delay elements. */
+    uint16_t           count;      /**< Number of input samples since the last output sample. */
+} decimator_t;
+
+/**@brief Function for initializing a decimator.
+ *
+ * @param[out] p_decimator Decimator state.
+ * @param[in]  p_config    Decimator configuration.
+ *
+ * @retval NRF_SUCCESS             If the decimator was initialized.
+ * @retval NRF_ERROR_INVALID_PARAM If the factor is zero or too large for the filter, or the
+ *                                 smoothing shift is too large.
+ */
+ret_code_t decimator_init(decimator_t * p_decimator, decimator_config_t const * p_config);
+
+/**@brief Function for resetting the filter state of a decimator.
+ *
+ * @param[in,out] p_decimator Decimator state.
+ */
+void decimator_reset(decimator_t * p_decimator);
+
+/**@brief Function for passing one sample through a decimator.
+ *
+ * @param[in,out] p_decimator Decimator state.
+ * @param[in]     sample      Input sample.
+ * @param[out]    p_out       Output sample. Written only when the function returns true.
+ *
+ * @retval true  If an output sample was produced.
+ * @retval false If more input samples are needed.
+ */
+bool decimator_put(decimator_t * p_decimator, int16_t sample, int16_t * p_out);
+
+/**@brief Function for passing a block of samples through a decimator.
+ *
+ * @details Samples are read from every stride-th position of the input, so that one channel can
+ *          be taken from a buffer with interleaved channels.
+ *
+ * @param[in,out] p_decimator Decimator state.
+ * @param[in]     p_in        Input samples.
+ * @param[in]     in_count    Number of samples to read.
+ * @param[in]     stride      Distance between consecutive samples in the input, in samples.
+ * @param[out]    p_out       Output samples. Must have room for in_count / factor + 1 samples.
+ *
+ * @return Number of output samples produced.
+ */
+uint16_t decimator_process(decimator_t *   p_decimator,
+                           int16_t const * p_in,
+                           uint16_t        in_count,
+                           uint16_t        stride,
+                           int16_t *       p_out);
+
+#endif // DECIMATOR_H__
+
+/** @} */
@@ -23,9 +23,56 @@
 #include "nrf_log.h"
 #include "nrf_drv_rng.h"
 #include "ecc.h"
+#if ECC_ASYNC_ENABLED
+#include <stdbool.h>
+#include "app_util_platform.h"
+#include "app_scheduler.h"
+#endif
+#if APP_PROFILER_ENABLED
+#include "app_profiler.h"
+#else
+#define APP_PROFILE(NAME, CALL)     CALL
+#endif
 
 #include "uECC.h"
 
+#if ECC_ASYNC_ENABLED
+
+/**@brief States of the precomputed key pair. */
+typedef enum
+{
+    ECC_KEYPAIR_OFF,        /**< Precomputation not started. */
+    ECC_KEYPAIR_EMPTY,      /**< No key pair ready and no computation scheduled. */
+    ECC_KEYPAIR_BUSY,       /**< Computation scheduled or in progress. */
+    ECC_KEYPAIR_READY       /**< Key pair ready to be taken. */
+} ecc_keypair_state_t;
+
+/**@brief Steps of the key pair computation. The job yields to the scheduler between steps. */
+typedef enum
+{
+    ECC_KEYPAIR_STEP_SK,    /**< Draw a random private key. */
+    ECC_KEYPAIR_STEP_PK     /**< Compute the public key. */
+} ecc_keypair_step_t;
+
+/**@brief Pending asynchronous shared secret computation. */
+typedef struct
+{
+    uint8_t const *  p_le_sk;
+    uint8_t const *  p_le_pk;
+    uint8_t *        p_le_ss;
+    ecc_ss_handler_t handler;
+    void *           p_context;
+    bool             busy;
+} ecc_ss_request_t;
+
+static volatile ecc_keypair_state_t m_keypair_state = ECC_KEYPAIR_OFF;
+static ecc_keypair_step_t           m_keypair_step;
+static uint32_t                     m_sk[ECC_P256_SK_LEN / sizeof(uint32_t)]; /**< Precomputed private key. */
+static uint32_t                     m_pk[ECC_P256_PK_LEN / sizeof(uint32_t)]; /**< Precomputed public key. */
+static ecc_ss_request_t             m_ss_request;
+
+#endif // ECC_ASYNC_ENABLED
+
 
 static int ecc_rng(uint8_t *dest, unsigned size)
 {
@@ -41,6 +88,118 @@ void ecc_init(void)
     uECC_set_rng(ecc_rng);
 }
 
+#if ECC_ASYNC_ENABLED
+
+/**@brief Scheduler handler computing the precomputed key pair, one step per call. */
+static void keypair_precompute_handler(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    int ret = 0;
+
+    switch (m_keypair_step)
+    {
+        case ECC_KEYPAIR_STEP_SK:
+            ret = ecc_rng((uint8_t *) m_sk, ECC_P256_SK_LEN);
+            if (ret)
+            {
+                m_keypair_step = ECC_KEYPAIR_STEP_PK;
+            }
+            break;
+
+        case ECC_KEYPAIR_STEP_PK:
+            /* Fails for a private key out of range, a new one is drawn then. */
+            APP_PROFILE("ecc_p256_pk",
+                        ret = uECC_compute_public_key((uint8_t *) m_sk, (uint8_t *) m_pk, uECC_secp256r1()));
+            m_keypair_step = ECC_KEYPAIR_STEP_SK;
+            if (ret)
+            {
+                m_keypair_state = ECC_KEYPAIR_READY;
+                return;
+            }
+            break;
+    }
+
+    /* Yield to pending events before the next step. */
+    if (app_sched_event_put_prio(NULL, 0, keypair_precompute_handler, APP_SCHED_PRIORITY_LOWEST)
+        != NRF_SUCCESS)
+    {
+        m_keypair_state = ECC_KEYPAIR_EMPTY;
+    }
+}
+
+
+/**@brief Function for scheduling the computation of the next key pair, if none is ready. */
+static ret_code_t keypair_precompute_schedule(void)
+{
+    ret_code_t err_code = NRF_SUCCESS;
+    bool       schedule;
+
+    CRITICAL_REGION_ENTER();
+    schedule = (m_keypair_state == ECC_KEYPAIR_EMPTY);
+    if (schedule)
+    {
+        m_keypair_state = ECC_KEYPAIR_BUSY;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (schedule)
+    {
+        m_keypair_step = ECC_KEYPAIR_STEP_SK;
+        err_code       = app_sched_event_put_prio(NULL, 0, keypair_precompute_handler,
+                                                  APP_SCHED_PRIORITY_LOWEST);
+        if (err_code != NRF_SUCCESS)
+        {
+            m_keypair_state = ECC_KEYPAIR_EMPTY;
+        }
+    }
+
+    return err_code;
+}
+
+
+ret_code_t ecc_p256_keypair_precompute_start(void)
+{
+    CRITICAL_REGION_ENTER();
+    if (m_keypair_state == ECC_KEYPAIR_OFF)
+    {
+        m_keypair_state = ECC_KEYPAIR_EMPTY;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return keypair_precompute_schedule();
+}
+
+
+/**@brief Function for taking the precomputed key pair, if one is ready.
+ *
+ * @return  True if the key pair was copied to the output buffers.
+ */
+static bool keypair_take(uint8_t * p_le_sk, uint8_t * p_le_pk)
+{
+    bool taken;
+
+    CRITICAL_REGION_ENTER();
+    taken = (m_keypair_state == ECC_KEYPAIR_READY);
+    if (taken)
+    {
+        m_keypair_state = ECC_KEYPAIR_EMPTY;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (taken)
+    {
+        memcpy(p_le_sk, m_sk, ECC_P256_SK_LEN);
+        memcpy(p_le_pk, m_pk, ECC_P256_PK_LEN);
+        memset(m_sk, 0, ECC_P256_SK_LEN);
+    }
+
+    return taken;
+}
+
+#endif // ECC_ASYNC_ENABLED
+
 ret_code_t ecc_p256_keypair_gen(uint8_t *p_le_sk, uint8_t *p_le_pk)
 {
     const struct uECC_Curve_t * p_curve;
@@ -55,9 +214,21 @@ ret_code_t ecc_p256_keypair_gen(uint8_t *p_le_sk, uint8_t *p_le_pk)
         return NRF_ERROR_INVALID_ADDR;
     }
 
+#if ECC_ASYNC_ENABLED
+    if (keypair_take(p_le_sk, p_le_pk))
+    {
+        (void)keypair_precompute_schedule();
+        return NRF_SUCCESS;
+    }
+#endif
+
     p_curve = uECC_secp256r1();
 
-    int ret = uECC_make_key((uint8_t *) p_le_pk, (uint8_t *) p_le_sk, p_curve);
+    int ret;
+    APP_PROFILE("ecc_p256_keypair", ret = uECC_make_key((uint8_t *) p_le_pk, (uint8_t *) p_le_sk, p_curve));
+#if ECC_ASYNC_ENABLED
+    (void)keypair_precompute_schedule();
+#endif
     if(!ret)
     {
         return NRF_ERROR_INTERNAL;
@@ -110,7 +281,8 @@ ret_code_t ecc_p256_shared_secret_compute(uint8_t const *p_le_sk, uint8_t const
     p_curve = uECC_secp256r1();
 
     NRF_LOG_PRINTF("uECC_shared_secret\n");
-    int ret = uECC_shared_secret((uint8_t *) p_le_pk, (uint8_t *) p_le_sk, p_le_ss, p_curve);
+    int ret;
+    APP_PROFILE("ecc_p256_ss", ret = uECC_shared_secret((uint8_t *) p_le_pk, (uint8_t *) p_le_sk, p_le_ss, p_curve));
     if(!ret)
     {
         return NRF_ERROR_INTERNAL;
@@ -120,4 +292,67 @@ ret_code_t ecc_p256_shared_secret_compute(uint8_t const *p_le_sk, uint8_t const
     return NRF_SUCCESS;    
 }
 
+#if ECC_ASYNC_ENABLED
+
+/**@brief Scheduler handler computing the shared secret requested by
+ *        @ref ecc_p256_shared_secret_compute_async. */
+static void shared_secret_handler(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    ecc_ss_request_t request = m_ss_request;
+    ret_code_t       result;
+
+    result = ecc_p256_shared_secret_compute(request.p_le_sk, request.p_le_pk, request.p_le_ss);
+
+    m_ss_request.busy = false;
+    request.handler(result, request.p_le_ss, request.p_context);
+}
+
+ret_code_t ecc_p256_shared_secret_compute_async(uint8_t const *  p_le_sk,
+                                                uint8_t const *  p_le_pk,
+                                                uint8_t *        p_le_ss,
+                                                ecc_ss_handler_t handler,
+                                                void *           p_context)
+{
+    ret_code_t err_code;
+    bool       busy;
+
+    if(!p_le_sk || !p_le_pk || !p_le_ss || !handler)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if(!is_word_aligned(p_le_sk) || !is_word_aligned(p_le_pk) || !is_word_aligned(p_le_ss))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    CRITICAL_REGION_ENTER();
+    busy = m_ss_request.busy;
+    m_ss_request.busy = true;
+    CRITICAL_REGION_EXIT();
+
+    if (busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    m_ss_request.p_le_sk   = p_le_sk;
+    m_ss_request.p_le_pk   = p_le_pk;
+    m_ss_request.p_le_ss   = p_le_ss;
+    m_ss_request.handler   = handler;
+    m_ss_request.p_context = p_context;
+
+    /* Ahead of the key pair precomputation, which runs at the lowest priority. */
+    err_code = app_sched_event_put_prio(NULL, 0, shared_secret_handler, APP_SCHED_PRIORITY_DEFAULT);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_ss_request.busy = false;
+    }
+
+    return err_code;
+}
 
+#endif // ECC_ASYNC_ENABLED
@@ -16,13 +16,48 @@
 #include "nordic_common.h"
 #include "nrf_error.h"
 
+#ifndef ECC_ASYNC_ENABLED
+#define ECC_ASYNC_ENABLED 0         /**< Key pair precomputation and asynchronous shared secret, on app_scheduler. */
+#endif
+
 #define ECC_P256_SK_LEN 32
 #define ECC_P256_PK_LEN 64
 
+#if ECC_ASYNC_ENABLED
+
+/**@brief Completion handler of @ref ecc_p256_shared_secret_compute_async.
+ *
+ * @param[in]  result     Result, as returned by @ref ecc_p256_shared_secret_compute.
+ * @param[in]  p_le_ss    Shared secret buffer given to the request.
+ * @param[in]  p_context  Context given to the request.
+ */
+typedef void (*ecc_ss_handler_t)(ret_code_t result, uint8_t * p_le_ss, void * p_context);
+
+#endif // ECC_ASYNC_ENABLED
+
 /**@brief Initialize the ECC module. */
 void ecc_init(void);
 
+#if ECC_ASYNC_ENABLED
+
+/**@brief Keep a precomputed public/private key pair ready for @ref ecc_p256_keypair_gen.
+ *
+ * @details Key pairs are computed by the scheduler at its lowest priority, in steps, so the work
+ *          is done while no other event is pending. A new key pair is scheduled every time one is
+ *          taken. Requires an initialized scheduler and @ref ecc_init.
+ *
+ * @retval     NRF_SUCCESS              Precomputation started.
+ * @return     Other codes propagated from app_sched_event_put_prio().
+ */
+ret_code_t ecc_p256_keypair_precompute_start(void);
+
+#endif // ECC_ASYNC_ENABLED
+
 /**@brief Create a public/private key pair.
+ *
+ * @details With ECC_ASYNC_ENABLED, once @ref ecc_p256_keypair_precompute_start has been called, a
+ *          precomputed key pair is returned when one is ready. Otherwise the key pair is computed
+ *          before returning.
  *
  * @param[out]  p_le_sk   Private key. Pointer must be aligned to a 4-byte boundary.
  * @param[out]  p_le_pk   Public key. Pointer must be aligned to a 4-byte boundary.
@@ -59,3 +94,29 @@ ret_code_t ecc_p256_public_key_compute(uint8_t const *p_le_sk, uint8_t* p_le_pk)
  */
 ret_code_t ecc_p256_shared_secret_compute(uint8_t const *p_le_sk, uint8_t const * p_le_pk, uint8_t *p_le_ss);
 
+#if ECC_ASYNC_ENABLED
+
+/**@brief Create a shared secret in the background.
+ *
+ * @details The shared secret is computed by the scheduler and @p handler is called from it with
+ *          the result. The buffers must stay valid until then. Only one request can be pending.
+ *
+ * @param[in]   p_le_sk     Private key. Pointer must be aligned to a 4-byte boundary.
+ * @param[in]   p_le_pk     Public key. Pointer must be aligned to a 4-byte boundary.
+ * @param[out]  p_le_ss     Shared secret. Pointer must be aligned to a 4-byte boundary.
+ * @param[in]   handler     Completion handler.
+ * @param[in]   p_context   Context passed to the handler.
+ *
+ * @retval     NRF_SUCCESS              Computation scheduled.
+ * @retval     NRF_ERROR_NULL           NULL pointer provided.
+ * @retval     NRF_ERROR_INVALID_ADDR   Unaligned pointer provided.
+ * @retval     NRF_ERROR_BUSY           Another computation is pending.
+ * @return     Other codes propagated from app_sched_event_put_prio().
+ */
+ret_code_t ecc_p256_shared_secret_compute_async(uint8_t const *  p_le_sk,
+                                                uint8_t const *  p_le_pk,
+                                                uint8_t *        p_le_ss,
+                                                ecc_ss_handler_t handler,
+                                                void *           p_context);
+
+#endif // ECC_ASYNC_ENABLED
@@ -0,0 +1,202 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_energy.h"
+
+#if APP_ENERGY_ENABLED
+
+#include <string.h>
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_log.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+
+STATIC_ASSERT(APP_ENERGY_SUBSYS_COUNT <= 32);
+
+static app_energy_model_t    m_model;                               /**< Current model. */
+static app_energy_counters_t m_counters;                            /**< Accumulated times. */
+static uint8_t               m_nesting[APP_ENERGY_SUBSYS_COUNT];    /**< Open begin calls per subsystem. */
+static uint32_t              m_active_mask;                         /**< Bit per subsystem with open begin calls. */
+static uint32_t              m_last;                                /**< Timestamp of the last update. */
+
+static char const * const    m_names[APP_ENERGY_SUBSYS_COUNT] =
+{
+    [APP_ENERGY_CPU]   = "cpu",
+    [APP_ENERGY_RADIO] = "radio",
+    [APP_ENERGY_FLASH] = "flash",
+    [APP_ENERGY_TWI]   = "twi",
+    [APP_ENERGY_SPI]   = "spi",
+    [APP_ENERGY_UART]  = "uart",
+};
+
+
+/**@brief Function for adding the time since the last update to the elapsed time and to every
+ *        active subsystem. Must be called from a critical region.
+ */
+static void counters_update(void)
+{
+    uint32_t now   = APP_ENERGY_TIMESTAMP_GET();
+    uint32_t delta = (now - m_last) & APP_ENERGY_TIMESTAMP_MASK;
+
+    m_last              = now;
+    m_counters.elapsed += delta;
+
+    for (uint32_t mask = m_active_mask, i = 0; mask != 0; mask >>= 1, i++)
+    {
+        if (mask & 1)
+        {
+            m_counters.active[i] += delta;
+        }
+    }
+}
+
+
+void app_energy_init(app_energy_model_t const * p_model)
+{
+    static app_energy_model_t const default_model = APP_ENERGY_MODEL_DEFAULT;
+
+    CRITICAL_REGION_ENTER();
+    m_model       = (p_model != NULL) ? *p_model : default_model;
+    m_active_mask = 0;
+    m_last        = APP_ENERGY_TIMESTAMP_GET();
+    memset(m_nesting, 0, sizeof(m_nesting));
+    memset(&m_counters, 0, sizeof(m_counters));
+    CRITICAL_REGION_EXIT();
+
+    app_energy_begin(APP_ENERGY_CPU);
+}
+
+
+void app_energy_begin(app_energy_subsys_t subsys)
+{
+    CRITICAL_REGION_ENTER();
+    counters_update();
+    if (m_nesting[subsys]++ == 0)
+    {
+        m_active_mask |= (1UL << subsys);
+        m_counters.count[subsys]++;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+void app_energy_end(app_energy_subsys_t subsys)
+{
+    CRITICAL_REGION_ENTER();
+    if (m_nesting[subsys] > 0)
+    {
+        counters_update();
+        if (--m_nesting[subsys] == 0)
+        {
+            m_active_mask &= ~(1UL << subsys);
+        }
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+void app_energy_update(void)
+{
+    CRITICAL_REGION_ENTER();
+    counters_update();
+    CRITICAL_REGION_EXIT();
+}
+
+
+void app_energy_counters_get(app_energy_counters_t * p_counters)
+{
+    CRITICAL_REGION_ENTER();
+    counters_update();
+    *p_counters = m_counters;
+    CRITICAL_REGION_EXIT();
+}
+
+
+void app_energy_charge_get(app_energy_counters_t * p_counters, app_energy_charge_t * p_charge)
+{
+    app_energy_counters_t counters;
+
+    app_energy_counters_get(&counters);
+    app_energy_charge_compute(&m_model, &counters, APP_ENERGY_TICK_HZ, p_charge);
+
+    if (p_counters != NULL)
+    {
+        *p_counters = counters;
+    }
+}
+
+
+void app_energy_reset(void)
+{
+    CRITICAL_REGION_ENTER();
+    counters_update();
+    memset(&m_counters, 0, sizeof(m_counters));
+    CRITICAL_REGION_EXIT();
+}
+
+
+ret_code_t app_energy_report_encode(uint8_t * p_buf, uint16_t * p_len)
+{
+    app_energy_counters_t counters;
+    app_energy_charge_t   charge;
+    uint16_t              len = 0;
+
+    if (*p_len < APP_ENERGY_REPORT_SIZE)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    app_energy_charge_get(&counters, &charge);
+
+    len += uint32_encode((uint32_t)(counters.elapsed / APP_ENERGY_TICK_HZ), &p_buf[len]);
+    len += uint32_encode((uint32_t)(charge.total_nc / 1000), &p_buf[len]);
+    len += uint32_encode(app_energy_average_ua(&charge, &counters, APP_ENERGY_TICK_HZ),
+                         &p_buf[len]);
+
+    for (uint32_t i = 0; i < APP_ENERGY_SUBSYS_COUNT; i++)
+    {
+        len += uint32_encode(app_energy_ticks_to_ms(counters.active[i], APP_ENERGY_TICK_HZ),
+                             &p_buf[len]);
+        len += uint32_encode(counters.count[i], &p_buf[len]);
+        len += uint32_encode((uint32_t)(charge.active_nc[i] / 1000), &p_buf[len]);
+    }
+
+    *p_len = len;
+    return NRF_SUCCESS;
+}
+
+
+void app_energy_dump(void)
+{
+    app_energy_counters_t counters;
+    app_energy_charge_t   charge;
+
+    app_energy_charge_get(&counters, &charge);
+
+    NRF_LOG_PRINTF("energy: %u s, %u uC, avg %u uA\r\n",
+                   (uint32_t)(counters.elapsed / APP_ENERGY_TICK_HZ),
+                   (uint32_t)(charge.total_nc / 1000),
+                   app_energy_average_ua(&charge, &counters, APP_ENERGY_TICK_HZ));
+    NRF_LOG_PRINTF("sleep %u uC\r\n", (uint32_t)(charge.sleep_nc / 1000));
+
+    for (uint32_t i = 0; i < APP_ENERGY_SUBSYS_COUNT; i++)
+    {
+        NRF_LOG_PRINTF("%s %u ms %u times %u uC\r\n",
+                       m_names[i],
+                       app_energy_ticks_to_ms(counters.active[i], APP_ENERGY_TICK_HZ),
+                       counters.count[i],
+                       (uint32_t)(charge.active_nc[i] / 1000));
+    }
+}
+
+#endif // APP_ENERGY_ENABLED
@@ -0,0 +1,143 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_energy Energy accounting
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for measuring where active time goes and estimating the charge it costs.
+ *
+ * @details Drivers and libraries mark the active periods of their subsystem with
+ *          @ref APP_ENERGY_BEGIN and @ref APP_ENERGY_END, see @ref app_energy_hook. The module
+ *          adds up the active time of each subsystem and the total elapsed time, and estimates
+ *          the charge with a current model, see @ref app_energy_model.
+ *
+ *          The following are instrumented:
+ *          - CPU: the application calls @ref APP_ENERGY_END before sd_app_evt_wait() and
+ *            @ref APP_ENERGY_BEGIN after it returns. Interrupts handled while sleeping are not
+ *            counted.
+ *          - Radio: ble_radio_notification, from the notification before the radio event to the
+ *            one after it.
+ *          - Flash: operations of fstorage and pstorage, from their start to the SoC event.
+ *          - TWI, SPI and UART: non-blocking transfers, continuous UART reception and UARTE RX
+ *            streams. Blocking transfers keep the CPU awake and are counted as CPU time only.
+ *
+ *          Each hook is a timestamp read and a few additions in a critical region, so the module
+ *          can be left enabled in production. Time is measured with RTC1, which must be running,
+ *          for example with a repeated app_timer. The RTC counter wraps every 512 seconds with
+ *          prescaler 0, so @ref app_energy_update must be called more often than that if the
+ *          hooks are not.
+ *
+ *          Results are read with @ref app_energy_charge_get, printed with @ref app_energy_dump
+ *          (over RTT or UART, depending on the nrf_log backend), or packed with
+ *          @ref app_energy_report_encode, for example to be exposed through a GATT
+ *          characteristic or written to an RTT stream.
+ *
+ *          The module is enabled by defining APP_ENERGY_ENABLED as 1, for every source file that
+ *          contains hooks. When it is not enabled, the hooks expand to nothing and the other
+ *          functions are not available.
+ */
+
+#ifndef APP_ENERGY_H__
+#define APP_ENERGY_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "app_energy_hook.h"
+#include "app_energy_model.h"
+
+#ifndef APP_ENERGY_TIMESTAMP_GET
+#define APP_ENERGY_TIMESTAMP_GET()  (NRF_RTC1->COUNTER)     /**< Time base of the module. */
+#endif
+
+#ifndef APP_ENERGY_TIMESTAMP_MASK
+#define APP_ENERGY_TIMESTAMP_MASK   0x00FFFFFF              /**< Valid bits of @ref APP_ENERGY_TIMESTAMP_GET. */
+#endif
+
+#ifndef APP_ENERGY_TICK_HZ
+#define APP_ENERGY_TICK_HZ          32768                   /**< Frequency of @ref APP_ENERGY_TIMESTAMP_GET, 32768 / (APP_TIMER_PRESCALER + 1). */
+#endif
+
+/**@brief Size of the output of @ref app_energy_report_encode. */
+#define APP_ENERGY_REPORT_SIZE      (12 + 12 * APP_ENERGY_SUBSYS_COUNT)
+
+#if APP_ENERGY_ENABLED
+
+/**@brief Function for initializing the module.
+ *
+ * @details Clears all counters and starts counting CPU time, as the CPU is running.
+ *
+ * @param[in]   p_model     Current model, copied by the module. NULL to use
+ *                          @ref APP_ENERGY_MODEL_DEFAULT.
+ */
+void app_energy_init(app_energy_model_t const * p_model);
+
+/**@brief Function for adding the time since the last hook to the counters.
+ *
+ * @details Must be called at least once per wrap of @ref APP_ENERGY_TIMESTAMP_GET. Calling it
+ *          from a periodic timer is enough.
+ */
+void app_energy_update(void);
+
+/**@brief Function for getting the accumulated times.
+ *
+ * @details Periods still in progress are included up to now.
+ *
+ * @param[out]  p_counters  Accumulated times, in ticks of @ref APP_ENERGY_TICK_HZ.
+ */
+void app_energy_counters_get(app_energy_counters_t * p_counters);
+
+/**@brief Function for getting the accumulated times and the estimated charge.
+ *
+ * @param[out]  p_counters  Accumulated times. Can be NULL.
+ * @param[out]  p_charge    Estimated charge.
+ */
+void app_energy_charge_get(app_energy_counters_t * p_counters, app_energy_charge_t * p_charge);
+
+/**@brief Function for clearing the counters. Subsystems that are active stay active. */
+void app_energy_reset(void);
+
+/**@brief Function for packing the counters and the estimated charge.
+ *
+ * @details The report is little endian 32-bit values:
+ *          - elapsed time in seconds, total charge in microcoulombs and average current in
+ *            microamperes,
+ *          - then for each subsystem, in @ref app_energy_subsys_t order: active time in
+ *            milliseconds, number of active periods and charge in microcoulombs.
+ *
+ *          Values that do not fit in 32 bits are truncated.
+ *
+ * @param[out]    p_buf   Output buffer.
+ * @param[in,out] p_len   In: size of p_buf. Out: number of bytes written.
+ *
+ * @retval      NRF_SUCCESS               Report packed.
+ * @retval      NRF_ERROR_DATA_SIZE       Buffer smaller than @ref APP_ENERGY_REPORT_SIZE. Nothing
+ *                                        was written.
+ */
+ret_code_t app_energy_report_encode(uint8_t * p_buf, uint16_t * p_len);
+
+/**@brief Function for printing the counters and the estimated charge using nrf_log. */
+void app_energy_dump(void);
+
+#else // APP_ENERGY_ENABLED
+
+#define app_energy_init(p_model)
+#define app_energy_update()
+#define app_energy_dump()
+
+#endif // APP_ENERGY_ENABLED
+
+#endif // APP_ENERGY_H__
+
+/** @} */
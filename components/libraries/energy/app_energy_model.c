@@ -0,0 +1,71 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_energy_model.h"
+
+#define NC_PER_UC   1000    /**< Nanocoulombs in a microcoulomb. */
+
+
+/**@brief Function for scaling a value by a fraction without overflowing the intermediate product.
+ *
+ * @details Computes value * mul / div, with value * mul / div fitting in 64 bits and mul, div
+ *          small.
+ */
+static uint64_t scale(uint64_t value, uint32_t mul, uint32_t div)
+{
+    return (value / div) * mul + ((value % div) * mul) / div;
+}
+
+
+uint64_t app_energy_charge_nc(uint32_t current_ua, uint64_t ticks, uint32_t tick_hz)
+{
+    // current_ua * ticks is in microamperes times ticks. Dividing by tick_hz gives microcoulombs.
+    return scale((uint64_t)current_ua * ticks, NC_PER_UC, tick_hz);
+}
+
+
+void app_energy_charge_compute(app_energy_model_t const    * p_model,
+                               app_energy_counters_t const * p_counters,
+                               uint32_t                      tick_hz,
+                               app_energy_charge_t         * p_charge)
+{
+    p_charge->sleep_nc = app_energy_charge_nc(p_model->sleep_ua, p_counters->elapsed, tick_hz);
+    p_charge->total_nc = p_charge->sleep_nc;
+
+    for (uint32_t i = 0; i < APP_ENERGY_SUBSYS_COUNT; i++)
+    {
+        p_charge->active_nc[i] = app_energy_charge_nc(p_model->active_ua[i],
+                                                      p_counters->active[i],
+                                                      tick_hz);
+        p_charge->total_nc    += p_charge->active_nc[i];
+    }
+}
+
+
+uint32_t app_energy_average_ua(app_energy_charge_t const   * p_charge,
+                               app_energy_counters_t const * p_counters,
+                               uint32_t                      tick_hz)
+{
+    if (p_counters->elapsed == 0)
+    {
+        return 0;
+    }
+
+    // Charge in microcoulombs divided by the elapsed time in seconds.
+    return (uint32_t)((p_charge->total_nc * tick_hz / NC_PER_UC) / p_counters->elapsed);
+}
+
+
+uint32_t app_energy_ticks_to_ms(uint64_t ticks, uint32_t tick_hz)
+{
+    return (uint32_t)scale(ticks, 1000, tick_hz);
+}
@@ -0,0 +1,123 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_energy_model Energy accounting current model
+ * @{
+ * @ingroup app_energy
+ *
+ * @brief Estimation of the charge drawn from the battery, from active times and a current model.
+ *
+ * @details The functions are plain C without target dependencies, so the model can be built and
+ *          checked on a host.
+ *
+ *          The sleep current flows all the time. The current of a subsystem is added to it while
+ *          the subsystem is active, so it is the difference between the subsystem running and
+ *          the system sleeping. Subsystems that are active at the same time add up.
+ */
+
+#ifndef APP_ENERGY_MODEL_H__
+#define APP_ENERGY_MODEL_H__
+
+#include <stdint.h>
+#include "app_energy_hook.h"
+
+/**@brief Current model. */
+typedef struct
+{
+    uint32_t sleep_ua;                              /**< Current of the sleeping system, in microamperes. */
+    uint32_t active_ua[APP_ENERGY_SUBSYS_COUNT];    /**< Current added while a subsystem is active, in microamperes. */
+} app_energy_model_t;
+
+/**@brief Default current model.
+ *
+ * @details Approximate figures for an nRF52832 with the DC/DC converter enabled, the CPU running
+ *          from flash and the radio at 0 dBm. Peripherals include the HFCLK they request. Measure
+ *          the actual board to get meaningful results.
+ */
+#define APP_ENERGY_MODEL_DEFAULT                    \
+{                                                   \
+    .sleep_ua  = 3,                                 \
+    .active_ua =                                    \
+    {                                               \
+        [APP_ENERGY_CPU]   = 3700,                  \
+        [APP_ENERGY_RADIO] = 6500,                  \
+        [APP_ENERGY_FLASH] = 3700,                  \
+        [APP_ENERGY_TWI]   = 600,                   \
+        [APP_ENERGY_SPI]   = 600,                   \
+        [APP_ENERGY_UART]  = 700,                   \
+    },                                              \
+}
+
+/**@brief Accumulated times. */
+typedef struct
+{
+    uint64_t elapsed;                               /**< Time since the counters were cleared, in ticks. */
+    uint64_t active[APP_ENERGY_SUBSYS_COUNT];       /**< Active time of each subsystem, in ticks. */
+    uint32_t count[APP_ENERGY_SUBSYS_COUNT];        /**< Number of times each subsystem became active. */
+} app_energy_counters_t;
+
+/**@brief Estimated charge. */
+typedef struct
+{
+    uint64_t sleep_nc;                              /**< Charge of the sleep current over the elapsed time, in nanocoulombs. */
+    uint64_t active_nc[APP_ENERGY_SUBSYS_COUNT];    /**< Charge added by each subsystem, in nanocoulombs. */
+    uint64_t total_nc;                              /**< Sum of all the above, in nanocoulombs. */
+} app_energy_charge_t;
+
+/**@brief Function for computing the charge of a constant current.
+ *
+ * @param[in]   current_ua  Current in microamperes.
+ * @param[in]   ticks       Duration in ticks. The product with @p current_ua must fit in 64 bits.
+ * @param[in]   tick_hz     Tick frequency in Hz.
+ *
+ * @return      Charge in nanocoulombs.
+ */
+uint64_t app_energy_charge_nc(uint32_t current_ua, uint64_t ticks, uint32_t tick_hz);
+
+/**@brief Function for estimating the charge drawn during the accumulated times.
+ *
+ * @param[in]   p_model     Current model.
+ * @param[in]   p_counters  Accumulated times.
+ * @param[in]   tick_hz     Tick frequency of @p p_counters in Hz.
+ * @param[out]  p_charge    Estimated charge.
+ */
+void app_energy_charge_compute(app_energy_model_t const    * p_model,
+                               app_energy_counters_t const * p_counters,
+                               uint32_t                      tick_hz,
+                               app_energy_charge_t         * p_charge);
+
+/**@brief Function for computing the average current over the elapsed time.
+ *
+ * @param[in]   p_charge    Estimated charge.
+ * @param[in]   p_counters  Accumulated times the charge was computed from.
+ * @param[in]   tick_hz     Tick frequency of @p p_counters in Hz.
+ *
+ * @return      Average current in microamperes, or 0 if no time has elapsed.
+ */
+uint32_t app_energy_average_ua(app_energy_charge_t const   * p_charge,
+                               app_energy_counters_t const * p_counters,
+                               uint32_t                      tick_hz);
+
+/**@brief Function for converting ticks to milliseconds.
+ *
+ * @param[in]   ticks       Duration in ticks.
+ * @param[in]   tick_hz     Tick frequency in Hz.
+ *
+ * @return      Duration in milliseconds, truncated to 32 bits.
+ */
+uint32_t app_energy_ticks_to_ms(uint64_t ticks, uint32_t tick_hz);
+
+#endif // APP_ENERGY_MODEL_H__
+
+/** @} */
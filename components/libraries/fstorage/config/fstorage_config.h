@@ -53,6 +53,52 @@
     #define FS_MAX_WRITE_SIZE_WORDS     (1024)
 #endif
 
+
+/**@brief   Enables scheduling of flash operations into predicted radio idle windows.
+ *
+ * @details When enabled, the application reports the connection interval with
+ *          @ref fs_radio_conn_interval_set and forwards radio notifications (see
+ *          ble_radio_notification) to @ref fs_radio_notification_evt_handler. While a connection
+ *          is active, flash operations are then started right after a radio event, writes are
+ *          split into chunks that fit the time left before the next radio event, and page erases
+ *          are held back until an idle window long enough for them is predicted. Operations of
+ *          different users are ordered by how close they are to their deadline.
+ *
+ *          Until the first radio notification is received, operations are started right away, as
+ *          without this option.
+ */
+#ifndef FS_RADIO_AWARE_SCHEDULING
+    #define FS_RADIO_AWARE_SCHEDULING   (1)
+#endif
+
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+
+/**@brief   Time reserved for each connection event, including SoftDevice overhead, in
+ *          microseconds. Only the rest of the connection interval is used for flash operations.
+ */
+#define FS_RADIO_EVENT_LENGTH_US    (2500)
+
+/**@brief   Longest time a write waits for a suitable idle window before it is attempted
+ *          regardless, in milliseconds.
+ */
+#define FS_STORE_MAX_DEFER_MS       (100)
+
+/**@brief   Longest time an erase waits for a suitable idle window before it is attempted
+ *          regardless, in milliseconds.
+ */
+#define FS_ERASE_MAX_DEFER_MS       (10000)
+
+/**@brief   Worst-case flash timings, in microseconds. */
+#if   defined (NRF51)
+    #define FS_WORD_WRITE_TIME_US   (47)
+    #define FS_PAGE_ERASE_TIME_US   (22300)
+#elif defined (NRF52)
+    #define FS_WORD_WRITE_TIME_US   (68)
+    #define FS_PAGE_ERASE_TIME_US   (89700)
+#endif
+
+#endif // FS_RADIO_AWARE_SCHEDULING
+
 /** @} */
 
 #endif // FS_CONFIG_H__
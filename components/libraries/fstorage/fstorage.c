@@ -19,11 +19,19 @@
 #include <stdbool.h>
 #include "nrf_error.h"
 #include "nrf_soc.h"
+#include "nordic_common.h"
+#include "app_energy_hook.h"
 
 
 static uint8_t       m_flags;       // fstorage status flags.
 static fs_op_queue_t m_queue;       // Queue of requested operations.
 static uint8_t       m_retry_count; // Number of times the last flash operation was retried.
+static fs_stats_t    m_stats;       // Statistics.
+
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+static uint32_t      m_conn_interval_us;            // Connection interval, zero if not connected.
+static uint32_t      m_idle_budget_us = UINT32_MAX; // Predicted idle time left before the next radio event.
+#endif
 
 
 // Sends events to the application.
@@ -69,8 +77,148 @@ static bool check_config(fs_config_t const * const config)
 }
 
 
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+
+// Returns the number of connection events an operation may wait for a suitable idle window.
+static uint32_t op_max_wait_events(fs_op_t const * const p_op)
+{
+    uint32_t max_defer_ms = (p_op->op_code == FS_OP_ERASE) ? FS_ERASE_MAX_DEFER_MS :
+                                                            FS_STORE_MAX_DEFER_MS;
+
+    return (max_defer_ms * 1000) / m_conn_interval_us;
+}
+
+
+// Returns the number of connection events left before an operation is overdue.
+static int32_t op_slack(fs_op_t const * const p_op)
+{
+    if (m_conn_interval_us == 0)
+    {
+        return 0;
+    }
+
+    return (int32_t)op_max_wait_events(p_op) - (int32_t)p_op->waited_events;
+}
+
+
+// Returns the worst-case duration of an operation, in microseconds.
+static uint32_t op_duration_us(fs_op_t const * const p_op)
+{
+    if (p_op->op_code == FS_OP_ERASE)
+    {
+        return FS_PAGE_ERASE_TIME_US;
+    }
+
+    return p_op->store.chunk_len * FS_WORD_WRITE_TIME_US;
+}
+
+
+// Subtracts the duration of an operation which has been started from the idle budget.
+static void idle_budget_consume(fs_op_t const * const p_op)
+{
+    uint32_t duration = op_duration_us(p_op);
+
+    if (m_idle_budget_us == UINT32_MAX)
+    {
+        return;
+    }
+
+    m_idle_budget_us = (m_idle_budget_us > duration) ? (m_idle_budget_us - duration) : 0;
+}
+
+#endif // FS_RADIO_AWARE_SCHEDULING
+
+
+// Checks whether an operation may be started now.
+static bool op_is_ready(fs_op_t const * const p_op)
+{
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    if ((m_idle_budget_us == UINT32_MAX) || (op_slack(p_op) <= 0))
+    {
+        // Not connected, or the operation is overdue and is attempted regardless.
+        return true;
+    }
+
+    if (p_op->op_code == FS_OP_ERASE)
+    {
+        return (m_idle_budget_us >= FS_PAGE_ERASE_TIME_US);
+    }
+
+    return (m_idle_budget_us >= FS_WORD_WRITE_TIME_US);
+#else
+    UNUSED_PARAMETER(p_op);
+    return true;
+#endif
+}
+
+
+// Checks whether operation a should be started before operation b.
+static bool op_is_more_urgent(fs_op_t const * const p_a, fs_op_t const * const p_b)
+{
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    int32_t slack_a = op_slack(p_a);
+    int32_t slack_b = op_slack(p_b);
+
+    if (slack_a != slack_b)
+    {
+        return (slack_a < slack_b);
+    }
+#endif
+
+    return ((int32_t)(p_a->seq - p_b->seq) < 0);
+}
+
+
+// Checks that no earlier operation of the same user is queued.
+static bool op_is_first_of_user(fs_op_t const * const p_op)
+{
+    for (uint32_t i = 0; i < FS_QUEUE_SIZE; i++)
+    {
+        fs_op_t const * const p_other = &m_queue.op[i];
+
+        if ((p_other->op_code  != FS_OP_NONE)       &&
+            (p_other->p_config == p_op->p_config)   &&
+            ((int32_t)(p_other->seq - p_op->seq) < 0))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Selects the next operation to start. Operations of one user are started in the order they
+// were requested. Among users, the most urgent operation which may be started now is selected.
+// Returns FS_OP_IDX_INVALID if no operation may be started now.
+static uint32_t queue_select(void)
+{
+    uint32_t selected = FS_OP_IDX_INVALID;
+
+    for (uint32_t i = 0; i < FS_QUEUE_SIZE; i++)
+    {
+        fs_op_t const * const p_op = &m_queue.op[i];
+
+        if ((p_op->op_code == FS_OP_NONE) ||
+            !op_is_first_of_user(p_op)    ||
+            !op_is_ready(p_op))
+        {
+            continue;
+        }
+
+        if ((selected == FS_OP_IDX_INVALID) ||
+            op_is_more_urgent(p_op, &m_queue.op[selected]))
+        {
+            selected = i;
+        }
+    }
+
+    return selected;
+}
+
+
 // Executes a store operation.
-static uint32_t store_execute(fs_op_t const * const p_op)
+static uint32_t store_execute(fs_op_t * const p_op)
 {
     uint16_t chunk_len;
 
@@ -83,6 +231,21 @@ static uint32_t store_execute(fs_op_t const * const p_op)
         chunk_len = FS_MAX_WRITE_SIZE_WORDS;
     }
 
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    // Write only as much as fits before the next radio event.
+    if ((m_idle_budget_us != UINT32_MAX) && (op_slack(p_op) > 0))
+    {
+        uint32_t fitting_words = m_idle_budget_us / FS_WORD_WRITE_TIME_US;
+
+        if (chunk_len > fitting_words)
+        {
+            chunk_len = (fitting_words > 0) ? fitting_words : 1;
+        }
+    }
+#endif
+
+    p_op->store.chunk_len = chunk_len;
+
     return sd_flash_write((uint32_t*)p_op->store.p_dest + p_op->store.offset,
                           (uint32_t*)p_op->store.p_src  + p_op->store.offset,
                           chunk_len);
@@ -96,30 +259,63 @@ static uint32_t erase_execute(fs_op_t const * const p_op)
 }
 
 
-// Advances the queue, wrapping around if necessary.
+// Removes an operation from the queue.
 // If no elements are left in the queue, clears the FS_FLAG_PROCESSING flag.
-static void queue_advance(void)
+static void queue_remove(fs_op_t * const p_op)
 {
+    p_op->op_code = FS_OP_NONE;
+
     if (--m_queue.count == 0)
     {
         m_flags &= ~FS_FLAG_PROCESSING;
     }
+}
+
+
+// Completes an operation, notifies the application and removes the operation from the queue.
+static void op_complete(fs_op_t * const p_op, fs_ret_t result)
+{
+    if (result == FS_SUCCESS)
+    {
+        m_stats.ops_completed++;
+    }
+    else
+    {
+        m_stats.ops_failed++;
+    }
 
-    if (++m_queue.rp == FS_QUEUE_SIZE)
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    if (p_op->waited_events > m_stats.wait_events_max)
     {
-        m_queue.rp = 0;
+        m_stats.wait_events_max = p_op->waited_events;
     }
+#endif
+
+    send_event(p_op, result);
+    queue_remove(p_op);
 }
 
 
-// Processes the current element in the queue. If the queue is empty, does nothing.
+// Starts the next operation in the queue. If the queue is empty, does nothing.
 static void queue_process(void)
 {
-    uint32_t         ret;
-    fs_op_t  * const p_op = &m_queue.op[m_queue.rp];
+    uint32_t ret;
 
-    if (m_queue.count > 0)
+    while (m_queue.count > 0)
     {
+        uint32_t const idx = queue_select();
+
+        if (idx == FS_OP_IDX_INVALID)
+        {
+            // All operations are waiting for a longer radio idle window.
+            m_flags &= ~FS_FLAG_PROCESSING;
+            m_flags |= FS_FLAG_WAITING_FOR_RADIO;
+            return;
+        }
+
+        fs_op_t * const p_op = &m_queue.op[idx];
+        m_queue.current      = idx;
+
         switch (p_op->op_code)
         {
             case FS_OP_STORE:
@@ -141,15 +337,22 @@ static void queue_process(void)
         {
             m_flags &= ~FS_FLAG_PROCESSING;
             m_flags |= FS_FLAG_FLASH_REQ_PENDING;
+            return;
         }
         else if (ret != NRF_SUCCESS)
         {
-            // An error has occurred.
-            send_event(p_op, FS_ERR_INTERNAL);
+            // An error has occurred. Drop the operation and continue with the next one.
+            op_complete(p_op, FS_ERR_INTERNAL);
         }
         else
         {
             // Operation is executing.
+            m_flags |= FS_FLAG_FLASH_OP_EXECUTING;
+            APP_ENERGY_BEGIN(APP_ENERGY_FLASH);
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+            idle_budget_consume(p_op);
+#endif
+            return;
         }
     }
 }
@@ -162,14 +365,33 @@ static void queue_start(void)
     if (!(m_flags & FS_FLAG_PROCESSING) &&
         !(m_flags & FS_FLAG_FLASH_REQ_PENDING))
     {
+        m_flags &= ~FS_FLAG_WAITING_FOR_RADIO;
         m_flags |= FS_FLAG_PROCESSING;
         queue_process();
     }
 }
 
 
+// Starts processing the queue after an operation has been requested.
+static void queue_start_on_request(void)
+{
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    if ((m_idle_budget_us != UINT32_MAX) &&
+        !(m_flags & FS_FLAG_PROCESSING)  &&
+        !(m_flags & FS_FLAG_FLASH_REQ_PENDING))
+    {
+        // The time left in the current idle window is unknown. Start in the next one.
+        m_flags |= FS_FLAG_WAITING_FOR_RADIO;
+        return;
+    }
+#endif
+
+    queue_start();
+}
+
+
 // Flash operation success callback handler. Keeps track of the progress of an operation.
-// If it has finished, advances the queue and notifies the application.
+// If it has finished, removes it from the queue and notifies the application.
 static void on_operation_success(fs_op_t * const p_op)
 {
     m_retry_count = 0;
@@ -178,24 +400,12 @@ static void on_operation_success(fs_op_t * const p_op)
     {
         case FS_OP_STORE:
         {
-            uint16_t chunk_len;
-
-            if ((p_op->store.length_words - p_op->store.offset) < FS_MAX_WRITE_SIZE_WORDS)
-            {
-                chunk_len = p_op->store.length_words - p_op->store.offset;
-            }
-            else
-            {
-                chunk_len = FS_MAX_WRITE_SIZE_WORDS;
-            }
-
-            p_op->store.offset += chunk_len;
+            p_op->store.offset += p_op->store.chunk_len;
 
             if (p_op->store.offset == p_op->store.length_words)
             {
                 // The operation has finished.
-                send_event(p_op, FS_SUCCESS);
-                queue_advance();
+                op_complete(p_op, FS_SUCCESS);
             }
         }
         break;
@@ -207,8 +417,7 @@ static void on_operation_success(fs_op_t * const p_op)
 
             if (p_op->erase.pages_erased == p_op->erase.pages_to_erase)
             {
-                send_event(p_op, FS_SUCCESS);
-                queue_advance();
+                op_complete(p_op, FS_SUCCESS);
             }
         }
         break;
@@ -221,22 +430,31 @@ static void on_operation_success(fs_op_t * const p_op)
 
 
 // Flash operation failure callback handler. If the maximum number of retries has
-// been reached, notifies the application and advances the queue.
-static void on_operation_failure(fs_op_t const * const p_op)
+// been reached, notifies the application and removes the operation from the queue.
+static void on_operation_failure(fs_op_t * const p_op)
 {
+    m_stats.flash_errors++;
+
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    // The prediction was wrong. Retry in the next idle window instead of right away.
+    if (m_idle_budget_us != UINT32_MAX)
+    {
+        m_idle_budget_us = 0;
+    }
+#endif
+
     if (++m_retry_count > FS_OP_MAX_RETRIES)
     {
         m_retry_count = 0;
 
-        send_event(p_op, FS_ERR_OPERATION_TIMEOUT);
-        queue_advance();
+        op_complete(p_op, FS_ERR_OPERATION_TIMEOUT);
     }
 }
 
 
-// Retrieves a pointer to the next free element in the queue.
+// Retrieves a pointer to a free element in the queue and assigns it the given op-code.
 // Additionally, increases the number of elements stored in the queue.
-static bool queue_get_next_free(fs_op_t ** p_op)
+static bool queue_get_next_free(fs_op_code_t op_code, fs_op_t ** p_op)
 {
     uint32_t idx;
 
@@ -245,14 +463,22 @@ static bool queue_get_next_free(fs_op_t ** p_op)
         return false;
     }
 
-    idx = ((m_queue.rp + m_queue.count) < FS_QUEUE_SIZE) ?
-           (m_queue.rp + m_queue.count) : 0;
+    for (idx = 0; idx < FS_QUEUE_SIZE; idx++)
+    {
+        if (m_queue.op[idx].op_code == FS_OP_NONE)
+        {
+            break;
+        }
+    }
 
     m_queue.count++;
 
     // Zero the element so that unassigned fields will be zero.
     memset(&m_queue.op[idx], 0x00, sizeof(fs_op_t));
 
+    m_queue.op[idx].op_code = op_code;
+    m_queue.op[idx].seq     = m_queue.seq_next++;
+
     *p_op = &m_queue.op[idx];
 
     return true;
@@ -370,19 +596,18 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
         return FS_ERR_INVALID_ARG;
     }
 
-    if (!queue_get_next_free(&p_op))
+    if (!queue_get_next_free(FS_OP_STORE, &p_op))
     {
         return FS_ERR_QUEUE_FULL;
     }
 
     // Initialize the operation.
     p_op->p_config           = p_config;
-    p_op->op_code            = FS_OP_STORE;
     p_op->store.p_src        = p_src;
     p_op->store.p_dest       = p_dest;
     p_op->store.length_words = length_words;
 
-    queue_start();
+    queue_start_on_request();
 
     return FS_SUCCESS;
 }
@@ -427,18 +652,17 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
         return FS_ERR_INVALID_ARG;
     }
 
-    if (!queue_get_next_free(&p_op))
+    if (!queue_get_next_free(FS_OP_ERASE, &p_op))
     {
         return FS_ERR_QUEUE_FULL;
     }
 
     // Initialize the operation.
     p_op->p_config             = p_config;
-    p_op->op_code              = FS_OP_ERASE;
     p_op->erase.page           = ((uint32_t)p_page_addr / FS_PAGE_SIZE);
     p_op->erase.pages_to_erase = num_pages;
 
-    queue_start();
+    queue_start_on_request();
 
     return FS_SUCCESS;
 }
@@ -459,8 +683,15 @@ fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count)
 
 void fs_sys_event_handler(uint32_t sys_evt)
 {
-    fs_op_t * const p_op = &m_queue.op[m_queue.rp];
-    
+    fs_op_t * const p_op = &m_queue.op[m_queue.current];
+
+    if ((m_flags & FS_FLAG_FLASH_OP_EXECUTING) &&
+        ((sys_evt == NRF_EVT_FLASH_OPERATION_SUCCESS) || (sys_evt == NRF_EVT_FLASH_OPERATION_ERROR)))
+    {
+        m_flags &= ~FS_FLAG_FLASH_OP_EXECUTING;
+        APP_ENERGY_END(APP_ENERGY_FLASH);
+    }
+
     if (m_flags & FS_FLAG_PROCESSING)
     {
         // A flash operation was initiated by this module. Handle the result.
@@ -489,6 +720,91 @@ void fs_sys_event_handler(uint32_t sys_evt)
     }
 
     // Resume processing the queue, if necessary.
-    queue_process();
+    if (m_flags & FS_FLAG_PROCESSING)
+    {
+        queue_process();
+    }
+}
+
+
+void fs_radio_conn_interval_set(uint32_t interval_us)
+{
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    m_conn_interval_us = interval_us;
+
+    // The idle windows are predicted from the first radio notification on.
+    if (interval_us == 0)
+    {
+        // No radio events to avoid. Resume operations held back for an idle window.
+        m_idle_budget_us = UINT32_MAX;
+        if (m_flags & FS_FLAG_WAITING_FOR_RADIO)
+        {
+            queue_start();
+        }
+    }
+#else
+    UNUSED_PARAMETER(interval_us);
+#endif
+}
+
+
+void fs_radio_notification_evt_handler(bool radio_active)
+{
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    if (m_conn_interval_us == 0)
+    {
+        return;
+    }
+
+    if (radio_active)
+    {
+        m_idle_budget_us = 0;
+        return;
+    }
+
+    // The radio event has ended. The radio stays idle until the next connection event.
+    m_idle_budget_us = (m_conn_interval_us > FS_RADIO_EVENT_LENGTH_US) ?
+                       (m_conn_interval_us - FS_RADIO_EVENT_LENGTH_US) : 0;
+
+    for (uint32_t i = 0; i < FS_QUEUE_SIZE; i++)
+    {
+        fs_op_t * const p_op = &m_queue.op[i];
+
+        if (p_op->op_code == FS_OP_NONE)
+        {
+            continue;
+        }
+
+        if (p_op->waited_events < UINT16_MAX)
+        {
+            p_op->waited_events++;
+        }
+
+        if ((p_op->op_code == FS_OP_ERASE) && op_is_first_of_user(p_op) && !op_is_ready(p_op))
+        {
+            m_stats.erase_deferrals++;
+        }
+    }
+
+    if (m_flags & FS_FLAG_WAITING_FOR_RADIO)
+    {
+        queue_start();
+    }
+#else
+    UNUSED_PARAMETER(radio_active);
+#endif
+}
+
+
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return FS_ERR_NULL_ARG;
+    }
+
+    *p_stats = m_stats;
+
+    return FS_SUCCESS;
 }
 
@@ -22,6 +22,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "section_vars.h"
 
 
@@ -220,6 +221,17 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
 fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count);
 
 
+/**@brief   fstorage statistics. */
+typedef struct
+{
+    uint32_t ops_completed;     //!< Number of operations that completed successfully.
+    uint32_t ops_failed;        //!< Number of operations that failed.
+    uint32_t flash_errors;      //!< Number of flash accesses the SoftDevice could not schedule. Each one leads to a retry.
+    uint32_t erase_deferrals;   //!< Number of connection events during which an erase was held back because the predicted idle window was too short.
+    uint16_t wait_events_max;   //!< Largest number of connection events an operation spent in the queue.
+} fs_stats_t;
+
+
 /**@brief   Function for handling system events from the SoftDevice.
  *
  * @details If any of the modules used by the application rely on fstorage, the application should
@@ -230,6 +242,38 @@ fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count);
 void fs_sys_event_handler(uint32_t sys_evt);
 
 
+/**@brief   Function for reporting the connection interval to fstorage.
+ *
+ * @details Call this function when a connection is established, when its parameters are updated,
+ *          and with zero when it is terminated. Has no effect unless FS_RADIO_AWARE_SCHEDULING is
+ *          enabled.
+ *
+ * @param[in]   interval_us     Connection interval in microseconds, or zero if not connected.
+ */
+void fs_radio_conn_interval_set(uint32_t interval_us);
+
+
+/**@brief   Function for handling radio notifications.
+ *
+ * @details Must be called at the same interrupt priority as @ref fs_sys_event_handler. Has no
+ *          effect unless FS_RADIO_AWARE_SCHEDULING is enabled.
+ *
+ * @param[in]   radio_active    True if the radio is about to become active, false if it has just
+ *                              become inactive.
+ */
+void fs_radio_notification_evt_handler(bool radio_active);
+
+
+/**@brief   Function for retrieving fstorage statistics.
+ *
+ * @param[out]  p_stats     Statistics.
+ *
+ * @retval  FS_SUCCESS          If the statistics were retrieved successfully.
+ * @retval  FS_ERR_NULL_ARG     If @p p_stats is NULL.
+ */
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats);
+
+
 /** @} */
 
 #endif // FSTORAGE_H__
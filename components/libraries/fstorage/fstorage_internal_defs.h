@@ -20,6 +20,10 @@
 #define FS_FLAG_PROCESSING          (1 << 1)  // The module is processing flash operations.
 // The module is waiting for a flash operation initiated by another module to complete.
 #define FS_FLAG_FLASH_REQ_PENDING   (1 << 2)
+// The module is waiting for a radio idle window long enough for the queued operations.
+#define FS_FLAG_WAITING_FOR_RADIO   (1 << 3)
+// A flash operation initiated by this module is executing.
+#define FS_FLAG_FLASH_OP_EXECUTING  (1 << 4)
 
 #define FS_ERASED_WORD              (0xFFFFFFFF)
 
@@ -65,6 +69,10 @@ typedef struct
 {
     fs_config_t  const * p_config;          // Application-specific fstorage configuration.
     fs_op_code_t         op_code;           // ID of the operation.
+    uint32_t             seq;               // Order in which the operation was requested.
+#if (FS_RADIO_AWARE_SCHEDULING == 1)
+    uint16_t             waited_events;     // Number of connection events since the operation was requested.
+#endif
     union
     {
         struct
@@ -73,6 +81,7 @@ typedef struct
             uint32_t const * p_dest;        // Destination of the data in flash.
             uint16_t         length_words;  // Length of the data to be written, in words.
             uint16_t         offset;        // Write offset.
+            uint16_t         chunk_len;     // Length of the chunk being written, in words.
         } store;
         struct
         {
@@ -93,17 +102,24 @@ typedef struct
 
 
 // Queue of requested operations.
-// This queue holds flash operations requested to the module.
+// This queue holds flash operations requested to the module. Free elements have the op-code
+// FS_OP_NONE. Operations of one user are executed in the order they were requested, but
+// operations of different users may be reordered by the scheduler.
 // The data to be written to flash must be kept in memory until the write operation
 // is completed, i.e., an event indicating completion is received.
 typedef struct
 {
     fs_op_t  op[FS_QUEUE_SIZE];  // Queue elements.
-    uint32_t rp;                 // Index of the operation being processed.
+    uint32_t current;            // Index of the operation being processed.
     uint32_t count;              // Number of elements in the queue.
+    uint32_t seq_next;           // Sequence number of the next requested operation.
 } fs_op_queue_t;
 
 
+// Index used when no operation is selected.
+#define FS_OP_IDX_INVALID   (FS_QUEUE_SIZE)
+
+
 // Size of a flash page in bytes.
 #if   defined (NRF51)
     #define FS_PAGE_SIZE    (1024)
@@ -26,6 +26,7 @@ typedef struct
 {
     bool                    leds_is_on;     /**< Flag for indicating if LEDs are on. */
     bool                    is_counting_up; /**< Flag for indicating if counter is incrementing or decrementing. */
+    bool                    pattern_in_hw;  /**< Flag for indicating if the PWM peripheral plays the blink pattern. */
     nrf_drv_state_t         led_sb_state;   /**< Indicates current state of instance. */
     uint16_t                duty_cycle;     /**< Current pulse width. */
     uint32_t                bit_mask;       /**< Mask of used pins. */
@@ -36,6 +37,9 @@ typedef struct
 
 static led_sb_context_t m_led_sb = {0};
 
+/* Duty cycles of one blink, played back by the PWM peripheral. */
+static uint8_t m_ramp[LED_SB_RAMP_MAX_LEN];
+
 /**@brief Timer event handler for softblink.
  *
  * @param[in] p_context            General purpose pointer. Will be passed to the time-out handler
@@ -140,12 +144,68 @@ ret_code_t led_softblink_init(led_sb_init_params_t * p_init_params)
 }
 
 
+/**@brief Function for starting the PWM peripheral playing the blink pattern.
+ *
+ * @retval NRF_ERROR_NOT_SUPPORTED  If the PWM peripheral is not available.
+ * @retval NRF_ERROR_NO_MEM         If the pattern is too long.
+ */
+static ret_code_t led_softblink_pattern_start(uint32_t leds_pin_bit_mask)
+{
+    ret_code_t              err_code;
+    low_power_pwm_pattern_t pattern;
+
+    err_code = led_softblink_ramp_build(&m_led_sb.params, PWM_PERIOD, m_ramp, LED_SB_RAMP_MAX_LEN,
+                                        &pattern.length, &pattern.idle_periods);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    pattern.p_duty_cycles   = m_ramp;
+    pattern.idle_duty_cycle = m_led_sb.params.duty_cycle_min;
+
+    err_code = low_power_pwm_pattern_start(&m_led_sb.pwm_instance, leds_pin_bit_mask, &pattern);
+    if (err_code == NRF_SUCCESS)
+    {
+        m_led_sb.pattern_in_hw = true;
+        m_led_sb.bit_mask      = leds_pin_bit_mask;
+    }
+
+    return err_code;
+}
+
+
+/**@brief Function for playing the changed pattern, if the PWM peripheral plays it. */
+static void led_softblink_pattern_restart(void)
+{
+    ret_code_t err_code;
+
+    if (!m_led_sb.pattern_in_hw)
+    {
+        // The timer based implementation picks the new parameters up by itself.
+        return;
+    }
+
+    err_code = led_softblink_stop();
+    APP_ERROR_CHECK(err_code);
+
+    err_code = led_softblink_start(m_led_sb.bit_mask);
+    APP_ERROR_CHECK(err_code);
+}
+
+
 ret_code_t led_softblink_start(uint32_t leds_pin_bit_mask)
 {
     ret_code_t err_code;
     
     ASSERT(m_led_sb.led_sb_state == NRF_DRV_STATE_INITIALIZED);
     
+    err_code = led_softblink_pattern_start(leds_pin_bit_mask);
+    if ((err_code != NRF_ERROR_NOT_SUPPORTED) && (err_code != NRF_ERROR_NO_MEM))
+    {
+        return err_code;
+    }
+
     err_code = low_power_pwm_start(&m_led_sb.pwm_instance, leds_pin_bit_mask);
     
     return err_code;
@@ -157,6 +217,7 @@ ret_code_t led_softblink_stop(void)
     ret_code_t err_code;
     
     err_code = low_power_pwm_stop(&m_led_sb.pwm_instance);
+    m_led_sb.pattern_in_hw = false;
     
     return err_code;
 }
@@ -167,6 +228,7 @@ void led_softblink_off_time_set(uint32_t off_time_ticks)
     ASSERT(m_led_sb.led_sb_state != NRF_DRV_STATE_UNINITIALIZED);
 
     m_led_sb.params.off_time_ticks = off_time_ticks;
+    led_softblink_pattern_restart();
 }
 
 
@@ -175,6 +237,7 @@ void led_softblink_on_time_set(uint32_t on_time_ticks)
     ASSERT(m_led_sb.led_sb_state != NRF_DRV_STATE_UNINITIALIZED);
 
     m_led_sb.params.on_time_ticks = on_time_ticks;
+    led_softblink_pattern_restart();
 }
 
 
@@ -22,6 +22,12 @@
  *
  * LED softblink needs one timer. It can use any number of output channels that are available. 
  *
+ * On nRF52, when @ref low_power_pwm can use the PWM peripheral, the whole blink pattern is
+ * precomputed with @ref led_softblink_ramp_build and played back in a loop by the peripheral.
+ * The CPU is then only involved when the pattern changes. The timer based implementation is used
+ * on nRF51, for more than four LEDs, or when the pattern is longer than
+ * @ref LED_SB_RAMP_MAX_LEN PWM periods.
+ *
  * Only one instance of LED softblink can run at a time.
  */
 
@@ -32,6 +38,11 @@
 #include <stdint.h>
 #include "sdk_errors.h"
 
+/**@brief Maximum number of PWM periods in a pattern played back by the PWM peripheral. */
+#ifndef LED_SB_RAMP_MAX_LEN
+#define LED_SB_RAMP_MAX_LEN 128
+#endif
+
 /**
  * @brief Structure holding the initialization parameters.
  */
@@ -119,6 +130,32 @@ void led_softblink_off_time_set(uint32_t off_time_ticks);
  */
 void led_softblink_on_time_set(uint32_t on_time_ticks);
 
+/**
+ * @brief Function for building the duty cycles of one blink.
+ *
+ * One duty cycle is generated per PWM period, in the same way as the timer based implementation
+ * steps through them: the rising slope, the maximum held for the on time and the falling slope
+ * down to the minimum. The minimum is then held for @p p_off_periods periods.
+ *
+ * The function has no hardware dependencies.
+ *
+ * @param[in]  p_params        Softblink parameters.
+ * @param[in]  period          Length of the PWM period in ticks.
+ * @param[out] p_duty_cycles   Duty cycles, one per PWM period.
+ * @param[in]  max_len         Size of @p p_duty_cycles.
+ * @param[out] p_len           Number of duty cycles written.
+ * @param[out] p_off_periods   Number of periods the minimum is held after the last duty cycle.
+ *
+ * @retval NRF_SUCCESS         If the duty cycles were built.
+ * @retval NRF_ERROR_NO_MEM    If the blink does not fit in @p max_len duty cycles.
+ */
+ret_code_t led_softblink_ramp_build(led_sb_init_params_t const * p_params,
+                                    uint8_t                      period,
+                                    uint8_t                    * p_duty_cycles,
+                                    uint16_t                     max_len,
+                                    uint16_t                   * p_len,
+                                    uint32_t                   * p_off_periods);
+
 /**
  * @brief Function for uninitializing LED softblink.
  *
@@ -0,0 +1,92 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "led_softblink.h"
+
+/* Ticks added to the on and off times by the timer based implementation
+ * (APP_TIMER_MIN_TIMEOUT_TICKS). Kept here so that the file has no dependencies. */
+#define PAUSE_EXTRA_TICKS 5
+
+/**@brief Function for computing the number of PWM periods a pause of the given length lasts. */
+static uint32_t pause_periods(uint32_t pause_ticks, uint8_t period)
+{
+    if (pause_ticks == 0)
+    {
+        return 0;
+    }
+    return (pause_ticks + PAUSE_EXTRA_TICKS + period - 1) / period;
+}
+
+
+ret_code_t led_softblink_ramp_build(led_sb_init_params_t const * p_params,
+                                    uint8_t                      period,
+                                    uint8_t                    * p_duty_cycles,
+                                    uint16_t                     max_len,
+                                    uint16_t                   * p_len,
+                                    uint32_t                   * p_off_periods)
+{
+    uint16_t len  = 0;
+    int32_t  duty = p_params->duty_cycle_min;
+    uint32_t hold;
+
+    // Rising slope, ending with the maximum.
+    do
+    {
+        if (duty >= (p_params->duty_cycle_max - p_params->duty_cycle_step))
+        {
+            duty = p_params->duty_cycle_max;
+        }
+        else
+        {
+            duty += p_params->duty_cycle_step;
+        }
+
+        if (len == max_len)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+        p_duty_cycles[len++] = (uint8_t)duty;
+    } while (duty != p_params->duty_cycle_max);
+
+    // The maximum is held for the on time.
+    for (hold = pause_periods(p_params->on_time_ticks, period); hold > 0; hold--)
+    {
+        if (len == max_len)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+        p_duty_cycles[len++] = p_params->duty_cycle_max;
+    }
+
+    // Falling slope, ending with the minimum.
+    do
+    {
+        if (duty <= (p_params->duty_cycle_min + p_params->duty_cycle_step))
+        {
+            duty = p_params->duty_cycle_min;
+        }
+        else
+        {
+            duty -= p_params->duty_cycle_step;
+        }
+
+        if (len == max_len)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+        p_duty_cycles[len++] = (uint8_t)duty;
+    } while (duty != p_params->duty_cycle_min);
+
+    *p_len         = len;
+    *p_off_periods = pause_periods(p_params->off_time_ticks, period);
+
+    return NRF_SUCCESS;
+}
@@ -14,6 +14,115 @@
 #include "nrf_gpio.h"
 #include "app_timer.h"
 #include "nrf_assert.h"
+#include "nordic_common.h"
+#include "app_util.h"
+
+#ifndef APP_TIMER_PRESCALER
+#define APP_TIMER_PRESCALER 0
+#endif
+
+#define HW_CONCAT_3(p1, p2, p3)  CONCAT_3(p1, p2, p3)
+#define HW_PWM_INSTANCE(id)      NRF_DRV_PWM_INSTANCE(id)
+
+#if defined(NRF52) && HW_CONCAT_3(PWM, LOW_POWER_PWM_HW_INSTANCE, _ENABLED)
+#define HW_PWM_ENABLED 1
+#else
+#define HW_PWM_ENABLED 0
+#endif
+
+#if HW_PWM_ENABLED
+#include "nrf_drv_pwm.h"
+#include "app_util_platform.h"
+
+#define HW_BASE_CLOCK_HZ    125000              /**< Matches NRF_PWM_CLK_125kHz. */
+#define HW_POLARITY_HIGH    0x8000              /**< Output high until the compare value is reached. */
+#define HW_TOP_MAX          0x7FFF              /**< Largest counter top value. */
+
+static nrf_drv_pwm_t const m_hw_pwm = HW_PWM_INSTANCE(LOW_POWER_PWM_HW_INSTANCE);
+
+static low_power_pwm_t * mp_hw_owner = NULL;    /**< Instance using the PWM peripheral. */
+static bool              m_hw_running = false;  /**< The PWM peripheral is playing. */
+static bool              m_hw_pattern = false;  /**< The PWM peripheral is playing a pattern. */
+static uint16_t          m_hw_top;              /**< Counter top value matching the period of the owner. */
+static uint16_t          m_hw_seq0[LOW_POWER_PWM_HW_SEQ_MAX_LEN];
+static uint16_t          m_hw_seq1[1];
+
+
+/**
+ * @brief Function for converting a duty cycle to a PWM peripheral sequence value.
+ */
+static uint16_t hw_value(low_power_pwm_t const * p_pwm_instance, uint8_t duty_cycle)
+{
+    uint16_t compare = (uint16_t)((duty_cycle * m_hw_top) / p_pwm_instance->period);
+
+    return p_pwm_instance->active_high ? (compare | HW_POLARITY_HIGH) : compare;
+}
+
+
+/**
+ * @brief Function for starting the PWM peripheral on the given pins.
+ *
+ * Sequence values are loaded in common mode, so all pins get the same duty cycle.
+ */
+static ret_code_t hw_start(low_power_pwm_t const * p_pwm_instance, uint32_t pin_mask)
+{
+    nrf_drv_pwm_config_t config =
+    {
+        .irq_priority = APP_IRQ_PRIORITY_LOW,
+        .base_clock   = NRF_PWM_CLK_125kHz,
+        .count_mode   = NRF_PWM_MODE_UP,
+        .top_value    = m_hw_top,
+        .load_mode    = NRF_PWM_LOAD_COMMON,
+        .step_mode    = NRF_PWM_STEP_AUTO
+    };
+    uint8_t  channel    = 0;
+    uint32_t pin_number = 0;
+
+    for (channel = 0; channel < NRF_PWM_CHANNEL_COUNT; channel++)
+    {
+        config.output_pins[channel] = NRF_DRV_PWM_PIN_NOT_USED;
+    }
+
+    channel = 0;
+    while (pin_mask)
+    {
+        if (pin_mask & 0x1UL)
+        {
+            // Idle state of the pin is the LED off.
+            config.output_pins[channel++] = (uint8_t)pin_number |
+                                   (p_pwm_instance->active_high ? 0 : NRF_DRV_PWM_PIN_INVERTED);
+        }
+        pin_number++;
+        pin_mask >>= 1UL;
+    }
+
+    // No event handler, so the PWM peripheral does not generate interrupts.
+    return nrf_drv_pwm_init(&m_hw_pwm, &config, NULL);
+}
+
+
+/**
+ * @brief Function for claiming the PWM peripheral for an instance, if it can use it.
+ */
+static void hw_claim(low_power_pwm_t * p_pwm_instance)
+{
+    uint32_t top = ROUNDED_DIV((uint32_t)p_pwm_instance->period * HW_BASE_CLOCK_HZ * (APP_TIMER_PRESCALER + 1),
+                               APP_TIMER_CLOCK_FREQ);
+    uint32_t pins = 0;
+    uint32_t bit_mask;
+
+    for (bit_mask = p_pwm_instance->bit_mask; bit_mask != 0; bit_mask &= (bit_mask - 1))
+    {
+        pins++;
+    }
+
+    if ((mp_hw_owner == NULL) && (pins <= NRF_PWM_CHANNEL_COUNT) && (top <= HW_TOP_MAX))
+    {
+        mp_hw_owner = p_pwm_instance;
+        m_hw_top    = (uint16_t)top;
+    }
+}
+#endif // HW_PWM_ENABLED
 
 /**
  * @brief Function for turning on LEDs.
@@ -158,6 +267,10 @@ ret_code_t low_power_pwm_init(low_power_pwm_t * p_pwm_instance, low_power_pwm_co
     led_off(p_pwm_instance);
     p_pwm_instance->pwm_state = NRF_DRV_STATE_INITIALIZED;
 
+#if HW_PWM_ENABLED
+    hw_claim(p_pwm_instance);
+#endif
+
     return NRF_SUCCESS;
 }
 
@@ -174,6 +287,32 @@ ret_code_t low_power_pwm_start(low_power_pwm_t * p_pwm_instance,
     led_off(p_pwm_instance);
     
     p_pwm_instance->bit_mask = leds_pin_bit_mask;
+
+#if HW_PWM_ENABLED
+    // Without a time-out handler the duty cycle only changes through low_power_pwm_duty_set().
+    if ((mp_hw_owner == p_pwm_instance) && (p_pwm_instance->handler == NULL))
+    {
+        ret_code_t         err_code;
+        nrf_pwm_sequence_t seq = {0};
+
+        m_hw_seq0[0]         = hw_value(p_pwm_instance, p_pwm_instance->duty_cycle);
+        seq.values.p_common  = m_hw_seq0;
+        seq.length           = 1;
+
+        err_code = hw_start(p_pwm_instance, leds_pin_bit_mask);
+        if (err_code != NRF_SUCCESS)
+        {
+            p_pwm_instance->pwm_state = NRF_DRV_STATE_INITIALIZED;
+            return err_code;
+        }
+        nrf_drv_pwm_simple_playback(&m_hw_pwm, &seq, 1, NRF_DRV_PWM_FLAG_LOOP);
+        m_hw_running = true;
+        m_hw_pattern = false;
+
+        return NRF_SUCCESS;
+    }
+#endif
+
     p_pwm_instance->evt_type = LOW_POWER_PWM_EVENT_PERIOD;
     pwm_timeout_handler(p_pwm_instance);
     
@@ -187,6 +326,20 @@ ret_code_t low_power_pwm_stop(low_power_pwm_t * p_pwm_instance)
 
     ret_code_t err_code;    
     
+#if HW_PWM_ENABLED
+    if ((mp_hw_owner == p_pwm_instance) && m_hw_running)
+    {
+        // Stops the playback immediately and hands the pins back to GPIO.
+        nrf_drv_pwm_uninit(&m_hw_pwm);
+        m_hw_running = false;
+        m_hw_pattern = false;
+        led_off(p_pwm_instance);
+        p_pwm_instance->pwm_state = NRF_DRV_STATE_INITIALIZED;
+
+        return NRF_SUCCESS;
+    }
+#endif
+
     err_code = app_timer_stop(*p_pwm_instance->p_timer_id);
     
     led_off(p_pwm_instance);
@@ -212,5 +365,91 @@ ret_code_t low_power_pwm_duty_set(low_power_pwm_t * p_pwm_instance, uint8_t duty
 
     p_pwm_instance->duty_cycle = duty_cycle;
 
+#if HW_PWM_ENABLED
+    if ((mp_hw_owner == p_pwm_instance) && m_hw_running && !m_hw_pattern)
+    {
+        // Loaded by the PWM peripheral at the start of the next period.
+        m_hw_seq0[0] = hw_value(p_pwm_instance, duty_cycle);
+    }
+#endif
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t low_power_pwm_pattern_start(low_power_pwm_t               * p_pwm_instance,
+                                       uint32_t                        leds_pin_bit_mask,
+                                       low_power_pwm_pattern_t const * p_pattern)
+{
+#if HW_PWM_ENABLED
+    ASSERT(p_pwm_instance->pwm_state == NRF_DRV_STATE_INITIALIZED);
+    ASSERT(((~p_pwm_instance->bit_mask) & leds_pin_bit_mask) == false);
+
+    ret_code_t         err_code;
+    nrf_pwm_sequence_t seq0 = {0};
+    nrf_pwm_sequence_t seq1 = {0};
+    uint16_t           i;
+
+    if (mp_hw_owner != p_pwm_instance)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if ((p_pattern->length == 0) || (p_pattern->length > LOW_POWER_PWM_HW_SEQ_MAX_LEN))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    if (p_pattern->idle_duty_cycle > p_pwm_instance->period)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (i = 0; i < p_pattern->length; i++)
+    {
+        if (p_pattern->p_duty_cycles[i] > p_pwm_instance->period)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        m_hw_seq0[i] = hw_value(p_pwm_instance, p_pattern->p_duty_cycles[i]);
+    }
+
+    err_code = hw_start(p_pwm_instance, leds_pin_bit_mask);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_pwm_instance->pwm_state       = NRF_DRV_STATE_POWERED_ON;
+    p_pwm_instance->bit_mask_toggle = leds_pin_bit_mask;
+    p_pwm_instance->bit_mask        = leds_pin_bit_mask;
+    m_hw_running                    = true;
+    m_hw_pattern                    = true;
+
+    seq0.values.p_common = m_hw_seq0;
+    seq0.length          = p_pattern->length;
+
+    if (p_pattern->idle_periods == 0)
+    {
+        nrf_drv_pwm_simple_playback(&m_hw_pwm, &seq0, 1, NRF_DRV_PWM_FLAG_LOOP);
+    }
+    else
+    {
+        // The idle duty cycle is played once and then repeated.
+        m_hw_seq1[0]         = hw_value(p_pwm_instance, p_pattern->idle_duty_cycle);
+        seq1.values.p_common = m_hw_seq1;
+        seq1.length          = 1;
+        seq1.repeats         = p_pattern->idle_periods - 1;
+
+        nrf_drv_pwm_complex_playback(&m_hw_pwm, &seq0, &seq1, 1, NRF_DRV_PWM_FLAG_LOOP);
+    }
+
     return NRF_SUCCESS;
+#else
+    UNUSED_PARAMETER(p_pwm_instance);
+    UNUSED_PARAMETER(leds_pin_bit_mask);
+    UNUSED_PARAMETER(p_pattern);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+#endif
 }
@@ -23,6 +23,12 @@
  * Each low-power PWM instance utilizes one app_timer. This means it runs on RTC 
  * and does not require HFCLK to be running. There can be any number of output 
  * channels per instance.
+ *
+ * On nRF52, the first instance with at most four pins uses the PWM peripheral selected by
+ * @ref LOW_POWER_PWM_HW_INSTANCE, if that peripheral is enabled in nrf_drv_config.h. Such an
+ * instance, started without a time-out handler, or started with @ref low_power_pwm_pattern_start,
+ * runs without waking up the CPU. The PWM peripheral keeps HFCLK running while it is active.
+ * Other instances, and all instances on nRF51, use the app_timer.
  */
 
 #ifndef LOW_POWER_PWM_H__
@@ -34,6 +40,14 @@
 #include "nrf_drv_common.h"
 #include "sdk_errors.h"
 
+#ifndef LOW_POWER_PWM_HW_INSTANCE
+#define LOW_POWER_PWM_HW_INSTANCE       0       /**< PWM peripheral used on nRF52. */
+#endif
+
+#ifndef LOW_POWER_PWM_HW_SEQ_MAX_LEN
+#define LOW_POWER_PWM_HW_SEQ_MAX_LEN    128     /**< Maximum length of a pattern. */
+#endif
+
 /**
  * @brief Event types.
  */
@@ -46,6 +60,17 @@ typedef enum
 /**@brief Application time-out handler type. */
 typedef void (*low_power_pwm_timeout_user)(void * p_context, low_power_pwm_evt_type_t evt_type);
 
+/**
+ * @brief Pattern of duty cycles played back in a loop, one per PWM period.
+ */
+typedef struct
+{
+    uint8_t const * p_duty_cycles;      /**< Duty cycles. */
+    uint16_t        length;             /**< Number of duty cycles. */
+    uint8_t         idle_duty_cycle;    /**< Duty cycle held after the last one. */
+    uint32_t        idle_periods;       /**< Number of periods idle_duty_cycle is held, 0 for none. */
+} low_power_pwm_pattern_t;
+
 /**
  * @brief Structure holding the initialization parameters.
  */
@@ -163,6 +188,25 @@ ret_code_t low_power_pwm_stop(low_power_pwm_t * p_pwm_instance);
  */
 ret_code_t low_power_pwm_duty_set(low_power_pwm_t * p_pwm_instance, uint8_t duty_cycle);
 
+/**
+ * @brief   Function for starting a low-power PWM instance with a pattern played by the PWM peripheral.
+ *
+ * The pattern is copied, and the CPU is not involved until the instance is stopped.
+ *
+ * @param[in] p_pwm_instance            Pointer to the instance to be started.
+ * @param[in] leds_pin_bit_mask         Bit mask of pins to be started.
+ * @param[in] p_pattern                 Pattern to play back.
+ *
+ * @retval NRF_SUCCESS                  If the playback was started.
+ * @retval NRF_ERROR_NOT_SUPPORTED      If the instance does not use the PWM peripheral.
+ * @retval NRF_ERROR_INVALID_LENGTH     If the pattern is empty or longer than
+ *                                      @ref LOW_POWER_PWM_HW_SEQ_MAX_LEN.
+ * @retval NRF_ERROR_INVALID_PARAM      If a duty cycle is larger than the period.
+ */
+ret_code_t low_power_pwm_pattern_start(low_power_pwm_t               * p_pwm_instance,
+                                       uint32_t                        leds_pin_bit_mask,
+                                       low_power_pwm_pattern_t const * p_pattern);
+
 #endif // LOW_POWER_PWM_H__
 
 /** @} */
@@ -0,0 +1,243 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_profiler.h"
+
+#if APP_PROFILER_ENABLED
+
+#include <string.h>
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_log.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#ifdef APP_SCHEDULER_WITH_PROFILER
+#include "app_scheduler.h"
+#endif
+#if defined(__unix)
+#include <time.h>
+#endif
+
+STATIC_ASSERT(IS_POWER_OF_TWO(APP_PROFILER_RING_SIZE));
+STATIC_ASSERT(APP_PROFILER_MAX_SLOTS < APP_PROFILER_SLOT_INVALID);
+
+static app_profiler_stats_t  m_stats[APP_PROFILER_MAX_SLOTS];  /**< Statistics per call site. */
+static uint8_t               m_slot_count;                     /**< Number of registered call sites. */
+static app_profiler_sample_t m_ring[APP_PROFILER_RING_SIZE];   /**< Most recent samples. */
+static uint32_t              m_ring_wr_idx;                    /**< Free running write index. */
+static uint32_t              m_ring_rd_idx;                    /**< Free running read index. */
+
+
+void app_profiler_init(void)
+{
+#if defined(__CORTEX_M) && (__CORTEX_M >= 0x03)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    m_slot_count = 0;
+    app_profiler_reset();
+}
+
+
+uint32_t app_profiler_timestamp_get(void)
+{
+#if defined(__unix)
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+#elif defined(__CORTEX_M) && (__CORTEX_M >= 0x03)
+    return DWT->CYCCNT;
+#else
+    return NRF_RTC1->COUNTER;
+#endif
+}
+
+
+/**@brief Function for getting the time elapsed since a timestamp. */
+static __INLINE uint32_t elapsed_get(uint32_t start)
+{
+#if !defined(__unix) && !(defined(__CORTEX_M) && (__CORTEX_M >= 0x03))
+    // RTC counter is 24 bits wide.
+    return (app_profiler_timestamp_get() - start) & 0x00FFFFFF;
+#else
+    return app_profiler_timestamp_get() - start;
+#endif
+}
+
+
+void app_profiler_record(uint8_t * p_slot, char const * p_name, uint32_t start)
+{
+    uint32_t               duration = elapsed_get(start);
+    app_profiler_stats_t * p_stats;
+
+    CRITICAL_REGION_ENTER();
+
+    if ((*p_slot == APP_PROFILER_SLOT_INVALID) && (m_slot_count < APP_PROFILER_MAX_SLOTS))
+    {
+        *p_slot                  = m_slot_count++;
+        m_stats[*p_slot].p_name  = p_name;
+        m_stats[*p_slot].min     = UINT32_MAX;
+    }
+
+    if (*p_slot != APP_PROFILER_SLOT_INVALID)
+    {
+        p_stats = &m_stats[*p_slot];
+
+        p_stats->count++;
+        p_stats->total += duration;
+        if (duration < p_stats->min)
+        {
+            p_stats->min = duration;
+        }
+        if (duration > p_stats->max)
+        {
+            p_stats->max = duration;
+        }
+
+        // Overwrite the oldest sample when the ring is full.
+        if ((m_ring_wr_idx - m_ring_rd_idx) == APP_PROFILER_RING_SIZE)
+        {
+            m_ring_rd_idx++;
+        }
+        m_ring[m_ring_wr_idx & (APP_PROFILER_RING_SIZE - 1)].slot     = *p_slot;
+        m_ring[m_ring_wr_idx & (APP_PROFILER_RING_SIZE - 1)].duration = duration;
+        m_ring_wr_idx++;
+    }
+
+    CRITICAL_REGION_EXIT();
+}
+
+
+uint8_t app_profiler_slot_count_get(void)
+{
+    return m_slot_count;
+}
+
+
+ret_code_t app_profiler_stats_get(uint8_t slot, app_profiler_stats_t * p_stats)
+{
+    if (slot >= m_slot_count)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats[slot];
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_profiler_sample_get(app_profiler_sample_t * p_sample)
+{
+    ret_code_t err_code = NRF_ERROR_NOT_FOUND;
+
+    CRITICAL_REGION_ENTER();
+    if (m_ring_rd_idx != m_ring_wr_idx)
+    {
+        *p_sample = m_ring[m_ring_rd_idx & (APP_PROFILER_RING_SIZE - 1)];
+        m_ring_rd_idx++;
+        err_code = NRF_SUCCESS;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+
+void app_profiler_reset(void)
+{
+    CRITICAL_REGION_ENTER();
+    for (uint8_t i = 0; i < APP_PROFILER_MAX_SLOTS; i++)
+    {
+        m_stats[i].count = 0;
+        m_stats[i].min   = UINT32_MAX;
+        m_stats[i].max   = 0;
+        m_stats[i].total = 0;
+    }
+    m_ring_wr_idx = 0;
+    m_ring_rd_idx = 0;
+    CRITICAL_REGION_EXIT();
+}
+
+
+/**@brief Function for computing the average duration of a call site. */
+static uint32_t average_get(app_profiler_stats_t const * p_stats)
+{
+    return (p_stats->count == 0) ? 0 : (uint32_t)(p_stats->total / p_stats->count);
+}
+
+
+ret_code_t app_profiler_stats_encode(uint8_t * p_buf, uint16_t * p_len)
+{
+    app_profiler_stats_t stats;
+    uint16_t             len = 0;
+    uint8_t              slot;
+
+    for (slot = 0; slot < m_slot_count; slot++)
+    {
+        if ((len + APP_PROFILER_ENCODED_SIZE) > *p_len)
+        {
+            *p_len = len;
+            return NRF_ERROR_DATA_SIZE;
+        }
+
+        (void)app_profiler_stats_get(slot, &stats);
+        len += uint32_encode(stats.count, &p_buf[len]);
+        len += uint32_encode((stats.count == 0) ? 0 : stats.min, &p_buf[len]);
+        len += uint32_encode(average_get(&stats), &p_buf[len]);
+        len += uint32_encode(stats.max, &p_buf[len]);
+    }
+
+    *p_len = len;
+    return NRF_SUCCESS;
+}
+
+
+void app_profiler_dump(void)
+{
+    app_profiler_stats_t stats;
+    uint8_t              slot;
+
+    NRF_LOG_PRINTF("profiler: name count min avg max\r\n");
+    for (slot = 0; slot < m_slot_count; slot++)
+    {
+        (void)app_profiler_stats_get(slot, &stats);
+        NRF_LOG_PRINTF("%s %u %u %u %u\r\n",
+                       stats.p_name,
+                       stats.count,
+                       (stats.count == 0) ? 0 : stats.min,
+                       average_get(&stats),
+                       stats.max);
+    }
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+    for (uint8_t priority = 0; priority < APP_SCHED_PRIORITY_LEVELS; priority++)
+    {
+        app_sched_latency_stats_t sched_stats;
+
+        if (app_sched_latency_stats_get(priority, &sched_stats) == NRF_SUCCESS)
+        {
+            NRF_LOG_PRINTF("sched prio %u: events %u max wait %u\r\n",
+                           priority,
+                           sched_stats.event_count,
+                           sched_stats.max_latency);
+        }
+    }
+#endif
+}
+
+#endif // APP_PROFILER_ENABLED
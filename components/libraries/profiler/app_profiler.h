@@ -0,0 +1,177 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_profiler Event handler profiler
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for measuring how long event handlers run.
+ *
+ * @details Wrap a handler call in @ref APP_PROFILE to record its call count and minimum,
+ *          average and maximum duration. The most recent measurements are also kept in a ring
+ *          buffer. Results can be printed with @ref app_profiler_dump (over RTT or UART,
+ *          depending on the nrf_log backend), or packed with @ref app_profiler_stats_encode,
+ *          for example to be exposed through a GATT characteristic.
+ *
+ *          On Cortex-M3/M4 durations are measured in CPU cycles by the DWT cycle counter. On
+ *          Cortex-M0, which has no DWT, ticks of RTC1 are used. On a host build, nanoseconds from
+ *          clock_gettime() are used.
+ *
+ *          The module is enabled by defining APP_PROFILER_ENABLED as 1. When it is not enabled,
+ *          @ref APP_PROFILE expands to the wrapped call only and the other functions are not
+ *          available.
+ *
+ *          Time spent in the scheduler queue is measured by the scheduler itself, see
+ *          app_sched_latency_stats_get(). It is included in @ref app_profiler_dump when
+ *          APP_SCHEDULER_WITH_PROFILER is defined.
+ */
+
+#ifndef APP_PROFILER_H__
+#define APP_PROFILER_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifndef APP_PROFILER_ENABLED
+#define APP_PROFILER_ENABLED        0
+#endif
+
+#ifndef APP_PROFILER_MAX_SLOTS
+#define APP_PROFILER_MAX_SLOTS      16      /**< Maximum number of profiled call sites. */
+#endif
+
+#ifndef APP_PROFILER_RING_SIZE
+#define APP_PROFILER_RING_SIZE      32      /**< Number of samples kept in the ring buffer. Must be a power of two. */
+#endif
+
+#define APP_PROFILER_SLOT_INVALID   0xFF    /**< Slot of a call site that has not been registered yet. */
+#define APP_PROFILER_ENCODED_SIZE   16      /**< Size of one slot in the output of app_profiler_stats_encode(). */
+
+/**@brief Statistics of one profiled call site. */
+typedef struct
+{
+    char const * p_name;                    /**< Name given to APP_PROFILE. */
+    uint32_t     count;                     /**< Number of calls. */
+    uint32_t     min;                       /**< Shortest call. */
+    uint32_t     max;                       /**< Longest call. */
+    uint64_t     total;                     /**< Sum of all calls, used to compute the average. */
+} app_profiler_stats_t;
+
+/**@brief One sample in the ring buffer. */
+typedef struct
+{
+    uint8_t  slot;                          /**< Slot of the call site. */
+    uint32_t duration;                      /**< Duration of the call. */
+} app_profiler_sample_t;
+
+#if APP_PROFILER_ENABLED
+
+/**@brief Macro for profiling a call.
+ *
+ * @details Each use of the macro is one call site with its own statistics. The call site is
+ *          registered the first time it runs.
+ *
+ * @param[in]   NAME    Name of the call site. Must be a string literal.
+ * @param[in]   CALL    Statement to profile.
+ */
+#define APP_PROFILE(NAME, CALL)                                                                    \
+    do                                                                                             \
+    {                                                                                              \
+        static uint8_t PROFILER_SLOT = APP_PROFILER_SLOT_INVALID;                                  \
+        uint32_t       PROFILER_START = app_profiler_timestamp_get();                              \
+        CALL;                                                                                      \
+        app_profiler_record(&PROFILER_SLOT, (NAME), PROFILER_START);                               \
+    } while (0)
+
+/**@brief Function for initializing the profiler.
+ *
+ * @details Enables the DWT cycle counter where available and clears all statistics.
+ */
+void app_profiler_init(void);
+
+/**@brief Function for reading the profiler time base.
+ *
+ * @return      Current timestamp.
+ */
+uint32_t app_profiler_timestamp_get(void);
+
+/**@brief Function for recording the end of a profiled call.
+ *
+ * @note Do not call this function directly. Use @ref APP_PROFILE instead.
+ *
+ * @param[in,out] p_slot    Slot of the call site, registered on first use.
+ * @param[in]     p_name    Name of the call site.
+ * @param[in]     start     Timestamp taken before the call.
+ */
+void app_profiler_record(uint8_t * p_slot, char const * p_name, uint32_t start);
+
+/**@brief Function for getting the number of registered call sites.
+ *
+ * @return      Number of slots in use.
+ */
+uint8_t app_profiler_slot_count_get(void);
+
+/**@brief Function for getting the statistics of a call site.
+ *
+ * @param[in]   slot      Slot index, lower than app_profiler_slot_count_get().
+ * @param[out]  p_stats   Statistics.
+ *
+ * @retval      NRF_SUCCESS               Statistics copied.
+ * @retval      NRF_ERROR_INVALID_PARAM   Slot not in use.
+ */
+ret_code_t app_profiler_stats_get(uint8_t slot, app_profiler_stats_t * p_stats);
+
+/**@brief Function for taking the oldest sample from the ring buffer.
+ *
+ * @details When the ring buffer is full, new samples overwrite the oldest ones.
+ *
+ * @param[out]  p_sample  Sample.
+ *
+ * @retval      NRF_SUCCESS               Sample copied.
+ * @retval      NRF_ERROR_NOT_FOUND       Ring buffer is empty.
+ */
+ret_code_t app_profiler_sample_get(app_profiler_sample_t * p_sample);
+
+/**@brief Function for clearing all statistics and samples. Registered slots are kept. */
+void app_profiler_reset(void);
+
+/**@brief Function for packing the statistics of all call sites.
+ *
+ * @details Each slot is packed as four little endian 32-bit values: count, minimum, average and
+ *          maximum, in slot order.
+ *
+ * @param[out]    p_buf   Output buffer.
+ * @param[in,out] p_len   In: size of p_buf. Out: number of bytes written.
+ *
+ * @retval      NRF_SUCCESS               Statistics packed.
+ * @retval      NRF_ERROR_DATA_SIZE       Buffer too small for all slots. As many complete slots
+ *                                        as fit were written.
+ */
+ret_code_t app_profiler_stats_encode(uint8_t * p_buf, uint16_t * p_len);
+
+/**@brief Function for printing the statistics of all call sites using nrf_log. */
+void app_profiler_dump(void);
+
+#else // APP_PROFILER_ENABLED
+
+#define APP_PROFILE(NAME, CALL)     CALL
+
+#define app_profiler_init()
+#define app_profiler_dump()
+
+#endif // APP_PROFILER_ENABLED
+
+#endif // APP_PROFILER_H__
+
+/** @} */
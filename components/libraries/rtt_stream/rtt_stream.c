@@ -0,0 +1,208 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "rtt_stream.h"
+#include <string.h>
+#include "nrf.h"
+#include "SEGGER_RTT.h"
+#include "app_util_platform.h"
+#include "sdk_common.h"
+
+STATIC_ASSERT(sizeof(rtt_stream_hdr_t) == RTT_STREAM_HDR_SIZE);
+STATIC_ASSERT((RTT_STREAM_BUFFER_SIZE % sizeof(uint32_t)) == 0);
+STATIC_ASSERT(RTT_STREAM_BUFFER_SIZE <= 0x10000);
+STATIC_ASSERT(RTT_STREAM_BUFFER_INDEX < SEGGER_RTT_MAX_NUM_UP_BUFFERS);
+STATIC_ASSERT(RTT_STREAM_MAX_STREAMS <= RTT_STREAM_ID_PAD);
+
+static uint32_t          m_buf[RTT_STREAM_BUFFER_SIZE / sizeof(uint32_t)];
+static volatile bool     m_reserved;                            /**< A record is reserved and not committed yet. */
+static uint32_t          m_res_off;                             /**< Offset of the reserved record. */
+static uint32_t          m_res_pad_off;                         /**< Offset of the padding before the record, or the buffer size if none. */
+static rtt_stream_hdr_t  m_res_hdr;                             /**< Header of the reserved record. */
+static uint8_t           m_dropped_pending[RTT_STREAM_MAX_STREAMS]; /**< Drops to report in the next record of each stream. */
+static uint32_t          m_dropped_total[RTT_STREAM_MAX_STREAMS];   /**< Drops since initialization. */
+
+/**@brief Function for getting the up-buffer descriptor in the RTT control block. */
+static __INLINE SEGGER_RTT_RING_BUFFER * ring_get(void)
+{
+    return &_SEGGER_RTT.aUp[RTT_STREAM_BUFFER_INDEX];
+}
+
+/**@brief Function for writing a header to the buffer. */
+static __INLINE void hdr_put(uint32_t offset, rtt_stream_hdr_t const * p_hdr)
+{
+    memcpy((uint8_t *)m_buf + offset, p_hdr, sizeof(rtt_stream_hdr_t));
+}
+
+/**@brief Function for counting a dropped record. Must be called from a critical region. */
+static void drop_count(uint8_t stream_id)
+{
+    if (m_dropped_pending[stream_id] < RTT_STREAM_DROPPED_MAX)
+    {
+        m_dropped_pending[stream_id]++;
+    }
+    m_dropped_total[stream_id]++;
+}
+
+/**@brief Function for finding room for a record.
+ *
+ * @details The host only moves RdOff forward, so the free space can only grow while the
+ *          record is being filled.
+ *
+ * @param[in]  size  Size of the record, including the header and padding.
+ *
+ * @retval     true   Room found. @ref m_res_off and @ref m_res_pad_off are set.
+ * @retval     false  Not enough free space.
+ */
+static bool room_find(uint32_t size)
+{
+    SEGGER_RTT_RING_BUFFER * p_ring = ring_get();
+    uint32_t                 wr_off = p_ring->WrOff;
+    uint32_t                 rd_off = p_ring->RdOff;
+    uint32_t                 tail;
+
+    m_res_pad_off = RTT_STREAM_BUFFER_SIZE;
+
+    if (rd_off > wr_off)
+    {
+        // One byte is always left free, so that a full buffer is not mistaken for an empty one.
+        m_res_off = wr_off;
+        return (size < (rd_off - wr_off));
+    }
+
+    tail = RTT_STREAM_BUFFER_SIZE - wr_off;
+    if ((size < tail) || ((size == tail) && (rd_off != 0)))
+    {
+        m_res_off = wr_off;
+        return true;
+    }
+
+    // Wrap around. The end of the buffer is given up and the record is placed at offset 0.
+    if (size < rd_off)
+    {
+        m_res_pad_off = wr_off;
+        m_res_off     = 0;
+        return true;
+    }
+
+    return false;
+}
+
+ret_code_t rtt_stream_init(void)
+{
+    if (SEGGER_RTT_ConfigUpBuffer(RTT_STREAM_BUFFER_INDEX,
+                                  "Stream",
+                                  m_buf,
+                                  RTT_STREAM_BUFFER_SIZE,
+                                  SEGGER_RTT_MODE_NO_BLOCK_SKIP) != 0)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_reserved = false;
+    memset(m_dropped_pending, 0, sizeof(m_dropped_pending));
+    memset(m_dropped_total, 0, sizeof(m_dropped_total));
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t rtt_stream_reserve(uint8_t stream_id, uint16_t length, void ** pp_payload)
+{
+    ret_code_t err_code = NRF_SUCCESS;
+    uint32_t   size     = RTT_STREAM_RECORD_SIZE(length);
+
+    if ((stream_id >= RTT_STREAM_MAX_STREAMS) || (size >= RTT_STREAM_BUFFER_SIZE))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (m_reserved)
+    {
+        err_code = NRF_ERROR_BUSY;
+    }
+    else if (!room_find(size))
+    {
+        err_code = NRF_ERROR_NO_MEM;
+    }
+
+    if (err_code == NRF_SUCCESS)
+    {
+        m_reserved = true;
+
+        m_res_hdr.length             = length;
+        m_res_hdr.stream_id          = stream_id;
+        m_res_hdr.dropped            = m_dropped_pending[stream_id];
+        m_res_hdr.timestamp          = RTT_STREAM_TIMESTAMP_GET();
+        m_dropped_pending[stream_id] = 0;
+    }
+    else
+    {
+        drop_count(stream_id);
+    }
+    CRITICAL_REGION_EXIT();
+
+    VERIFY_SUCCESS(err_code);
+
+    *pp_payload = (uint8_t *)m_buf + m_res_off + RTT_STREAM_HDR_SIZE;
+    return NRF_SUCCESS;
+}
+
+void rtt_stream_commit(void)
+{
+    SEGGER_RTT_RING_BUFFER * p_ring = ring_get();
+    uint32_t                 wr_off;
+
+    if (!m_reserved)
+    {
+        return;
+    }
+
+    if ((RTT_STREAM_BUFFER_SIZE - m_res_pad_off) >= RTT_STREAM_HDR_SIZE)
+    {
+        rtt_stream_hdr_t pad =
+        {
+            .length    = (uint16_t)(RTT_STREAM_BUFFER_SIZE - m_res_pad_off - RTT_STREAM_HDR_SIZE),
+            .stream_id = RTT_STREAM_ID_PAD,
+        };
+        hdr_put(m_res_pad_off, &pad);
+    }
+    hdr_put(m_res_off, &m_res_hdr);
+
+    wr_off = m_res_off + RTT_STREAM_RECORD_SIZE(m_res_hdr.length);
+    if (wr_off == RTT_STREAM_BUFFER_SIZE)
+    {
+        wr_off = 0;
+    }
+
+    // The record must be in memory before the host can see the new write offset.
+    __DMB();
+    p_ring->WrOff = wr_off;
+    m_reserved    = false;
+}
+
+ret_code_t rtt_stream_write(uint8_t stream_id, void const * p_data, uint16_t length)
+{
+    void     * p_payload;
+    ret_code_t err_code = rtt_stream_reserve(stream_id, length, &p_payload);
+    VERIFY_SUCCESS(err_code);
+
+    memcpy(p_payload, p_data, length);
+    rtt_stream_commit();
+
+    return NRF_SUCCESS;
+}
+
+uint32_t rtt_stream_dropped_get(uint8_t stream_id)
+{
+    return (stream_id < RTT_STREAM_MAX_STREAMS) ? m_dropped_total[stream_id] : 0;
+}
@@ -0,0 +1,122 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup rtt_stream Binary data streaming over RTT
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for streaming timestamped binary records over a dedicated RTT up-buffer.
+ *
+ * @details The module owns one RTT up-buffer, separate from the one used by nrf_log. Writes never
+ *          block: a record that does not fit is dropped and counted for its stream, and the count
+ *          is carried in the header of the next record of that stream. Records are written in
+ *          place with @ref rtt_stream_reserve and @ref rtt_stream_commit, so the producer can
+ *          fill the payload without an intermediate copy.
+ *
+ *          Each record starts at a 4-byte aligned offset with an @ref rtt_stream_hdr_t, followed
+ *          by the payload padded to a multiple of 4 bytes. A record is never split at the end
+ *          of the buffer:
+ *          - If at least @ref RTT_STREAM_HDR_SIZE bytes are left, they are covered by a record
+ *            with the stream ID @ref RTT_STREAM_ID_PAD.
+ *          - Otherwise the reader skips the remaining bytes and continues at offset 0.
+ */
+
+#ifndef RTT_STREAM_H__
+#define RTT_STREAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#ifndef RTT_STREAM_BUFFER_INDEX
+#define RTT_STREAM_BUFFER_INDEX     1       /**< RTT up-buffer used for the stream. Buffer 0 is the nrf_log terminal. */
+#endif
+
+#ifndef RTT_STREAM_BUFFER_SIZE
+#define RTT_STREAM_BUFFER_SIZE      4096    /**< Size of the up-buffer in bytes. Must be a multiple of 4. */
+#endif
+
+#ifndef RTT_STREAM_MAX_STREAMS
+#define RTT_STREAM_MAX_STREAMS      8       /**< Number of stream IDs with their own drop counter. */
+#endif
+
+#ifndef RTT_STREAM_TIMESTAMP_GET
+#define RTT_STREAM_TIMESTAMP_GET()  (NRF_RTC1->COUNTER) /**< Timestamp stored with each record. */
+#endif
+
+#define RTT_STREAM_ID_PAD           0xFF    /**< Stream ID of a record that fills the end of the buffer. */
+#define RTT_STREAM_HDR_SIZE         8       /**< Size of @ref rtt_stream_hdr_t in bytes. */
+#define RTT_STREAM_DROPPED_MAX      0xFF    /**< Largest drop count carried in a header. */
+
+/**@brief Record header, little endian. */
+typedef struct
+{
+    uint16_t length;        /**< Payload length in bytes, without padding. */
+    uint8_t  stream_id;     /**< Stream ID, or @ref RTT_STREAM_ID_PAD. */
+    uint8_t  dropped;       /**< Records of this stream dropped since the previous one, saturates at @ref RTT_STREAM_DROPPED_MAX. */
+    uint32_t timestamp;     /**< Value of @ref RTT_STREAM_TIMESTAMP_GET when the record was reserved. */
+} rtt_stream_hdr_t;
+
+/**@brief Macro for the space taken in the buffer by a record with the given payload length. */
+#define RTT_STREAM_RECORD_SIZE(length)  (RTT_STREAM_HDR_SIZE + (((uint32_t)(length) + 3) & ~3UL))
+
+/**@brief Function for initializing the module and configuring its RTT up-buffer.
+ *
+ * @retval NRF_SUCCESS              Module initialized.
+ * @retval NRF_ERROR_INVALID_STATE  The up-buffer could not be configured.
+ */
+ret_code_t rtt_stream_init(void);
+
+/**@brief Function for reserving space for a record in the RTT buffer.
+ *
+ * @details Only one record can be reserved at a time. A reservation attempted from an interrupt
+ *          while another one is open is dropped, as is a record that does not fit. Both are
+ *          counted for the stream.
+ *
+ * @param[in]  stream_id    Stream ID, lower than @ref RTT_STREAM_MAX_STREAMS.
+ * @param[in]  length       Payload length in bytes.
+ * @param[out] pp_payload   Pointer to the 4-byte aligned payload area, to be filled before
+ *                          @ref rtt_stream_commit.
+ *
+ * @retval NRF_SUCCESS              Space reserved.
+ * @retval NRF_ERROR_INVALID_PARAM  Invalid stream ID or length.
+ * @retval NRF_ERROR_BUSY           Another record is reserved. The record was dropped.
+ * @retval NRF_ERROR_NO_MEM         Not enough free space. The record was dropped.
+ */
+ret_code_t rtt_stream_reserve(uint8_t stream_id, uint16_t length, void ** pp_payload);
+
+/**@brief Function for making the reserved record visible to the host. */
+void rtt_stream_commit(void);
+
+/**@brief Function for writing a record by copying the payload.
+ *
+ * @param[in]  stream_id    Stream ID.
+ * @param[in]  p_data       Payload.
+ * @param[in]  length       Payload length in bytes.
+ *
+ * @return Return codes of @ref rtt_stream_reserve.
+ */
+ret_code_t rtt_stream_write(uint8_t stream_id, void const * p_data, uint16_t length);
+
+/**@brief Function for getting the total number of dropped records of a stream.
+ *
+ * @param[in]  stream_id    Stream ID.
+ *
+ * @return Number of records dropped since initialization, or 0 for an invalid stream ID.
+ */
+uint32_t rtt_stream_dropped_get(uint8_t stream_id);
+
+#endif // RTT_STREAM_H__
+
+/** @} */
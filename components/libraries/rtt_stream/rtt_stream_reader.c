@@ -0,0 +1,188 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "rtt_stream_reader.h"
+#include <string.h>
+
+#define CB_ID               "SEGGER RTT"
+#define CB_ID_SIZE          16      /**< Size of acID in the control block. */
+#define CB_UP_OFFSET        24      /**< Offset of aUp, after acID and the two buffer counts. */
+#define CB_RING_SIZE        24      /**< Size of a ring buffer descriptor on a 32-bit target. */
+
+/**@brief Offsets of the fields in a ring buffer descriptor on a 32-bit target. */
+#define RING_BUFFER_OFFSET  4
+#define RING_SIZE_OFFSET    8
+#define RING_WR_OFFSET      12
+#define RING_RD_OFFSET      16
+
+/**@brief Function for reading a little endian 32-bit word. */
+static uint32_t le32_get(uint8_t const * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void reader_reset(rtt_stream_reader_t * p_reader)
+{
+    memset(p_reader, 0, sizeof(rtt_stream_reader_t));
+}
+
+ret_code_t rtt_stream_reader_dump_init(rtt_stream_reader_t * p_reader,
+                                       uint8_t const       * p_dump,
+                                       uint32_t              dump_size,
+                                       uint32_t              dump_address,
+                                       uint32_t              buffer_index)
+{
+    uint8_t const * p_cb = NULL;
+
+    reader_reset(p_reader);
+
+    // The control block is word aligned.
+    for (uint32_t offset = 0; offset + CB_UP_OFFSET <= dump_size; offset += sizeof(uint32_t))
+    {
+        if (memcmp(&p_dump[offset], CB_ID, sizeof(CB_ID)) == 0)
+        {
+            p_cb = &p_dump[offset];
+            break;
+        }
+    }
+    if (p_cb == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    uint32_t        num_up = le32_get(&p_cb[CB_ID_SIZE]);
+    uint8_t const * p_ring = &p_cb[CB_UP_OFFSET + buffer_index * CB_RING_SIZE];
+
+    if ((buffer_index >= num_up) || ((p_ring + CB_RING_SIZE) > (p_dump + dump_size)))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    uint32_t address = le32_get(&p_ring[RING_BUFFER_OFFSET]);
+    uint32_t size    = le32_get(&p_ring[RING_SIZE_OFFSET]);
+
+    if ((size == 0) || (address < dump_address) || ((address - dump_address) > dump_size) ||
+        (size > (dump_size - (address - dump_address))))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    p_reader->p_buf       = &p_dump[address - dump_address];
+    p_reader->size        = size;
+    p_reader->wr_off      = le32_get(&p_ring[RING_WR_OFFSET]);
+    p_reader->rd_off      = le32_get(&p_ring[RING_RD_OFFSET]);
+    p_reader->release_off = p_reader->rd_off;
+
+    if ((p_reader->wr_off >= size) || (p_reader->rd_off >= size))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t rtt_stream_reader_ring_init(rtt_stream_reader_t    * p_reader,
+                                       SEGGER_RTT_RING_BUFFER * p_ring)
+{
+    reader_reset(p_reader);
+
+    if ((p_ring->pBuffer == NULL) || (p_ring->SizeOfBuffer == 0))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    p_reader->p_buf       = (uint8_t const *)p_ring->pBuffer;
+    p_reader->size        = p_ring->SizeOfBuffer;
+    p_reader->p_ring      = p_ring;
+    p_reader->rd_off      = p_ring->RdOff;
+    p_reader->release_off = p_reader->rd_off;
+
+    return NRF_SUCCESS;
+}
+
+bool rtt_stream_reader_next(rtt_stream_reader_t * p_reader,
+                            rtt_stream_hdr_t    * p_hdr,
+                            uint8_t const      ** pp_payload)
+{
+    for (;;)
+    {
+        uint32_t wr_off;
+        uint32_t used;
+        uint32_t record_size;
+
+        p_reader->rd_off = p_reader->release_off;
+        if (p_reader->p_ring != NULL)
+        {
+            p_reader->p_ring->RdOff = p_reader->rd_off;
+            wr_off                  = p_reader->p_ring->WrOff;
+        }
+        else
+        {
+            wr_off = p_reader->wr_off;
+        }
+
+        if (p_reader->rd_off == wr_off)
+        {
+            return false;
+        }
+
+        // Too little left for a header, the producer continued at offset 0.
+        if ((p_reader->size - p_reader->rd_off) < RTT_STREAM_HDR_SIZE)
+        {
+            p_reader->stats.bytes += p_reader->size - p_reader->rd_off;
+            p_reader->release_off  = 0;
+            continue;
+        }
+
+        used = (wr_off > p_reader->rd_off) ? (wr_off - p_reader->rd_off)
+                                           : (p_reader->size - p_reader->rd_off);
+
+        p_hdr->length    = (uint16_t)(p_reader->p_buf[p_reader->rd_off] |
+                                      (p_reader->p_buf[p_reader->rd_off + 1] << 8));
+        p_hdr->stream_id = p_reader->p_buf[p_reader->rd_off + 2];
+        p_hdr->dropped   = p_reader->p_buf[p_reader->rd_off + 3];
+        p_hdr->timestamp = le32_get(&p_reader->p_buf[p_reader->rd_off + 4]);
+
+        record_size = RTT_STREAM_RECORD_SIZE(p_hdr->length);
+        if (record_size > used)
+        {
+            // Records are published whole, so this is a corrupted buffer. Drop what is there.
+            p_reader->stats.errors++;
+            p_reader->stats.bytes += used;
+            p_reader->release_off  = (p_reader->rd_off + used == p_reader->size) ?
+                                     0 : (p_reader->rd_off + used);
+            continue;
+        }
+
+        p_reader->stats.bytes += record_size;
+        p_reader->release_off  = p_reader->rd_off + record_size;
+        if (p_reader->release_off == p_reader->size)
+        {
+            p_reader->release_off = 0;
+        }
+
+        if (p_hdr->stream_id == RTT_STREAM_ID_PAD)
+        {
+            continue;
+        }
+
+        p_reader->stats.records++;
+        p_reader->stats.dropped += p_hdr->dropped;
+        if (p_hdr->stream_id < RTT_STREAM_MAX_STREAMS)
+        {
+            p_reader->stats.dropped_per_stream[p_hdr->stream_id] += p_hdr->dropped;
+        }
+
+        *pp_payload = &p_reader->p_buf[p_reader->rd_off + RTT_STREAM_HDR_SIZE];
+        return true;
+    }
+}
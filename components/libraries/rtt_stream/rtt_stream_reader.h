@@ -0,0 +1,108 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup rtt_stream_reader Host reader for RTT binary streams
+ * @{
+ * @ingroup rtt_stream
+ *
+ * @brief Host side decoder for the records written by @ref rtt_stream.
+ *
+ * @details The reader is plain C and does not depend on the target. It works on either:
+ *          - a RAM dump of the target. The RTT control block is found by its ID string and
+ *            target addresses are translated to offsets in the dump. The target's read offset is
+ *            not updated.
+ *          - an RTT control block in the same address space, for example when the producer is
+ *            built for the host. Consumed records are released by moving RdOff forward, as a
+ *            debug probe would.
+ */
+
+#ifndef RTT_STREAM_READER_H__
+#define RTT_STREAM_READER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "rtt_stream.h"
+#include "SEGGER_RTT.h"
+
+/**@brief Reader statistics. */
+typedef struct
+{
+    uint32_t records;                           /**< Records read, padding excluded. */
+    uint32_t bytes;                             /**< Bytes consumed from the buffer, including headers and padding. */
+    uint32_t dropped;                           /**< Sum of the drop counts in the headers read. */
+    uint32_t dropped_per_stream[RTT_STREAM_MAX_STREAMS];
+    uint32_t errors;                            /**< Malformed records. The rest of the buffer was skipped. */
+} rtt_stream_reader_stats_t;
+
+/**@brief Reader instance. Fields are internal. */
+typedef struct
+{
+    uint8_t const          * p_buf;         /**< Start of the buffer data. */
+    uint32_t                 size;          /**< Size of the buffer. */
+    uint32_t                 rd_off;        /**< Next offset to read. */
+    uint32_t                 wr_off;        /**< Write offset of the producer, for dumps. */
+    uint32_t                 release_off;   /**< Offset to release to the producer on the next read. */
+    SEGGER_RTT_RING_BUFFER * p_ring;        /**< Live up-buffer, NULL for dumps. */
+    rtt_stream_reader_stats_t stats;
+} rtt_stream_reader_t;
+
+/**@brief Function for reading a stream from a RAM dump of the target.
+ *
+ * @param[out] p_reader         Reader instance.
+ * @param[in]  p_dump           Dump of target RAM.
+ * @param[in]  dump_size        Size of the dump in bytes.
+ * @param[in]  dump_address     Target address of the first byte of the dump.
+ * @param[in]  buffer_index     RTT up-buffer index, usually @ref RTT_STREAM_BUFFER_INDEX.
+ *
+ * @retval NRF_SUCCESS              Reader initialized at the target's read offset.
+ * @retval NRF_ERROR_NOT_FOUND      No RTT control block in the dump.
+ * @retval NRF_ERROR_INVALID_DATA   The up-buffer is not configured, or not inside the dump.
+ */
+ret_code_t rtt_stream_reader_dump_init(rtt_stream_reader_t * p_reader,
+                                       uint8_t const       * p_dump,
+                                       uint32_t              dump_size,
+                                       uint32_t              dump_address,
+                                       uint32_t              buffer_index);
+
+/**@brief Function for reading a stream from an up-buffer in the same address space.
+ *
+ * @param[out] p_reader         Reader instance.
+ * @param[in]  p_ring           Up-buffer descriptor, usually in @ref _SEGGER_RTT.
+ *
+ * @retval NRF_SUCCESS              Reader initialized.
+ * @retval NRF_ERROR_INVALID_DATA   The up-buffer is not configured.
+ */
+ret_code_t rtt_stream_reader_ring_init(rtt_stream_reader_t    * p_reader,
+                                       SEGGER_RTT_RING_BUFFER * p_ring);
+
+/**@brief Function for getting the next record.
+ *
+ * @details The previous record is released to the producer first, so @p pp_payload is only valid
+ *          until the next call.
+ *
+ * @param[in]  p_reader     Reader instance.
+ * @param[out] p_hdr        Header of the record.
+ * @param[out] pp_payload   Payload of the record.
+ *
+ * @retval true   A record was read.
+ * @retval false  No complete record is available.
+ */
+bool rtt_stream_reader_next(rtt_stream_reader_t * p_reader,
+                            rtt_stream_hdr_t    * p_hdr,
+                            uint8_t const      ** pp_payload);
+
+#endif // RTT_STREAM_READER_H__
+
+/** @} */
@@ -0,0 +1,217 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_saadc_acq.h"
+#include "sdk_common.h"
+#include "nrf_drv_ppi.h"
+#include "app_util_platform.h"
+
+/**@brief Acquisition control block. */
+typedef struct
+{
+    app_saadc_acq_handler_t handler;                              /**< Handler for filtered results. */
+    nrf_drv_timer_t const * p_timer;                              /**< Trigger TIMER. */
+    decimator_t             decimators[NRF_SAADC_CHANNEL_COUNT];  /**< One decimator per channel. */
+    uint8_t                 channel_count;                        /**< Number of channels. */
+    nrf_ppi_channel_t       ppi_channel;                          /**< PPI channel from the TIMER compare event to the SAMPLE task. */
+    bool                    running;                              /**< True while the acquisition is active. */
+} app_saadc_acq_cb_t;
+
+static app_saadc_acq_cb_t m_cb;
+
+
+static void timer_event_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    // The compare interrupt is not enabled, the TIMER is used only for PPI.
+    UNUSED_PARAMETER(event_type);
+    UNUSED_PARAMETER(p_context);
+}
+
+
+static void saadc_event_handler(nrf_drv_saadc_evt_t const * p_event)
+{
+    if (p_event->type != NRF_DRV_SAADC_EVT_DONE)
+    {
+        return;
+    }
+
+    nrf_saadc_value_t const * p_samples = p_event->data.done.p_buffer;
+    uint16_t                  size      = p_event->data.done.size;
+    uint8_t                   count     = m_cb.channel_count;
+    int16_t                   results[NRF_SAADC_CHANNEL_COUNT];
+
+    // Samples of all channels are interleaved, one set per SAMPLE task. The
+    // decimators of all channels produce their results at the same time.
+    for (uint16_t i = 0; (i + count) <= size; i += count)
+    {
+        bool ready = false;
+
+        for (uint8_t channel = 0; channel < count; channel++)
+        {
+            ready = decimator_put(&m_cb.decimators[channel],
+                                  p_samples[i + channel],
+                                  &results[channel]);
+        }
+
+        if (ready)
+        {
+            m_cb.handler(results, count);
+        }
+    }
+
+    if (m_cb.running)
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_saadc_buffer_convert(p_event->data.done.p_buffer,
+                                                          p_event->data.done.size));
+    }
+}
+
+
+static ret_code_t trigger_init(app_saadc_acq_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    nrf_drv_timer_config_t timer_config =
+    {
+        .frequency          = NRF_TIMER_FREQ_1MHz,
+        .mode               = NRF_TIMER_MODE_TIMER,
+        .bit_width          = NRF_TIMER_BIT_WIDTH_32,
+        .interrupt_priority = APP_IRQ_PRIORITY_LOW,
+        .p_context          = NULL
+    };
+
+    err_code = nrf_drv_timer_init(p_config->p_timer, &timer_config, timer_event_handler);
+    VERIFY_SUCCESS(err_code);
+    nrf_drv_timer_enable(p_config->p_timer);
+    nrf_drv_timer_pause(p_config->p_timer);
+
+    nrf_drv_timer_extended_compare(p_config->p_timer,
+                                   NRF_TIMER_CC_CHANNEL0,
+                                   nrf_drv_timer_us_to_ticks(p_config->p_timer,
+                                                             p_config->sample_interval_us),
+                                   NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                   false);
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != MODULE_ALREADY_INITIALIZED))
+    {
+        nrf_drv_timer_uninit(p_config->p_timer);
+        return err_code;
+    }
+
+    err_code = nrf_drv_ppi_channel_alloc(&m_cb.ppi_channel);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_timer_uninit(p_config->p_timer);
+        return err_code;
+    }
+
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_assign(m_cb.ppi_channel,
+        nrf_drv_timer_compare_event_address_get(p_config->p_timer, NRF_TIMER_CC_CHANNEL0),
+        nrf_drv_saadc_sample_task_get()));
+
+    return NRF_SUCCESS;
+}
+
+
+static void trigger_uninit(void)
+{
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_disable(m_cb.ppi_channel));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(m_cb.ppi_channel));
+    nrf_drv_timer_uninit(m_cb.p_timer);
+}
+
+
+ret_code_t app_saadc_acq_start(app_saadc_acq_config_t const * p_config,
+                               app_saadc_acq_handler_t        handler)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_channels);
+    VERIFY_PARAM_NOT_NULL(p_config->p_timer);
+    VERIFY_PARAM_NOT_NULL(p_config->p_buffer);
+    VERIFY_PARAM_NOT_NULL(handler);
+    VERIFY_TRUE((p_config->channel_count != 0) &&
+                (p_config->channel_count <= NRF_SAADC_CHANNEL_COUNT) &&
+                (p_config->buffer_size   >= p_config->channel_count) &&
+                ((p_config->buffer_size % p_config->channel_count) == 0),
+                NRF_ERROR_INVALID_PARAM);
+    VERIFY_FALSE(m_cb.running, NRF_ERROR_INVALID_STATE);
+
+    for (uint8_t channel = 0; channel < p_config->channel_count; channel++)
+    {
+        err_code = decimator_init(&m_cb.decimators[channel], &p_config->decimator);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    m_cb.handler       = handler;
+    m_cb.p_timer       = p_config->p_timer;
+    m_cb.channel_count = p_config->channel_count;
+
+    err_code = nrf_drv_saadc_init(NULL, saadc_event_handler);
+    VERIFY_SUCCESS(err_code);
+
+    for (uint8_t channel = 0; channel < p_config->channel_count; channel++)
+    {
+        err_code = nrf_drv_saadc_channel_init(channel, &p_config->p_channels[channel]);
+        if (err_code != NRF_SUCCESS)
+        {
+            nrf_drv_saadc_uninit();
+            return err_code;
+        }
+    }
+
+    err_code = trigger_init(p_config);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_saadc_uninit();
+        return err_code;
+    }
+
+    // Both buffers are queued. The driver moves to the second one when the
+    // first is full, and the event handler queues the first one again.
+    m_cb.running = true;
+    err_code = nrf_drv_saadc_buffer_convert(p_config->p_buffer, p_config->buffer_size);
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = nrf_drv_saadc_buffer_convert(p_config->p_buffer + p_config->buffer_size,
+                                                p_config->buffer_size);
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        app_saadc_acq_stop();
+        return err_code;
+    }
+
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_enable(m_cb.ppi_channel));
+    nrf_drv_timer_resume(m_cb.p_timer);
+
+    return NRF_SUCCESS;
+}
+
+
+void app_saadc_acq_stop(void)
+{
+    if (!m_cb.running)
+    {
+        return;
+    }
+
+    m_cb.running = false;
+
+    nrf_drv_timer_pause(m_cb.p_timer);
+    trigger_uninit();
+
+    nrf_drv_saadc_abort();
+    nrf_drv_saadc_uninit();
+}
@@ -0,0 +1,82 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_saadc_acq Continuous SAADC acquisition
+ * @{
+ * @ingroup app_common
+ * @brief Module for sampling SAADC channels at a fixed rate and delivering filtered results.
+ *
+ * @details A TIMER compare event triggers the SAADC SAMPLE task through PPI, so conversions
+ *          happen at an exact rate without CPU involvement. Samples are stored by EasyDMA in two
+ *          alternating buffers. When a buffer is full, it is passed through one @ref decimator
+ *          per channel and queued again. Every time the decimators produce a result, the
+ *          application handler is called with one value per channel.
+ *
+ *          The CPU is therefore woken up once per buffer instead of once per sample, and the
+ *          application sees the results at the decimated rate.
+ *
+ * @note The TIMER keeps the high frequency clock running while the acquisition is active.
+ */
+
+#ifndef APP_SAADC_ACQ_H__
+#define APP_SAADC_ACQ_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "nrf_drv_saadc.h"
+#include "nrf_drv_timer.h"
+#include "decimator.h"
+
+/**@brief Handler for filtered results.
+ *
+ * @param[in] p_results     One result per channel, in channel order.
+ * @param[in] channel_count Number of results.
+ */
+typedef void (*app_saadc_acq_handler_t)(int16_t const * p_results, uint8_t channel_count);
+
+/**@brief Acquisition configuration. */
+typedef struct
+{
+    nrf_saadc_channel_config_t const * p_channels;         /**< Channel configurations. Channel i of the SAADC is configured with element i. */
+    uint8_t                            channel_count;      /**< Number of channels, at most NRF_SAADC_CHANNEL_COUNT. */
+    nrf_drv_timer_t const *            p_timer;            /**< TIMER instance used to trigger the conversions. */
+    uint32_t                           sample_interval_us; /**< Time between two conversions of all channels. */
+    nrf_saadc_value_t *                p_buffer;           /**< Sample memory, split into two buffers of buffer_size samples each. */
+    uint16_t                           buffer_size;        /**< Size of each buffer, in samples. Must be a multiple of channel_count. */
+    decimator_config_t                 decimator;          /**< Filter applied to every channel. */
+} app_saadc_acq_config_t;
+
+/**@brief Function for initializing the SAADC and starting the acquisition.
+ *
+ * @param[in] p_config Acquisition configuration. The buffer memory must stay valid until
+ *                     @ref app_saadc_acq_stop is called.
+ * @param[in] handler  Handler for filtered results, called in the SAADC interrupt context.
+ *
+ * @retval NRF_SUCCESS             If the acquisition was started.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration is invalid.
+ * @retval NRF_ERROR_INVALID_STATE If the acquisition is already running.
+ * @retval NRF_ERROR_NO_MEM        If no PPI channel was available.
+ * @return Other errors from the SAADC or TIMER driver.
+ */
+ret_code_t app_saadc_acq_start(app_saadc_acq_config_t const * p_config,
+                               app_saadc_acq_handler_t        handler);
+
+/**@brief Function for stopping the acquisition and releasing the SAADC, the TIMER, and the PPI
+ *        channel.
+ */
+void app_saadc_acq_stop(void);
+
+#endif // APP_SAADC_ACQ_H__
+
+/** @} */
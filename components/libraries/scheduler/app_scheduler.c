@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include "nrf.h"
 #include "nrf_soc.h"
 #include "nrf_assert.h"
 #include "app_util.h"
@@ -24,56 +25,104 @@ typedef struct
 {
     app_sched_event_handler_t handler;          /**< Pointer to event handler to receive the event. */
     uint16_t                  event_data_size;  /**< Size of event data. */
+    uint16_t                  next;             /**< Index of the next entry in the same list. */
+#ifdef APP_SCHEDULER_WITH_PROFILER
+    uint32_t                  timestamp;        /**< Time at which the event was scheduled. */
+#endif
 } event_header_t;
 
 STATIC_ASSERT(sizeof(event_header_t) <= APP_SCHED_EVENT_HEADER_SIZE);
+STATIC_ASSERT(APP_SCHED_PRIORITY_LEVELS > 0);
+
+#define EVENT_INDEX_INVALID  0xFFFF             /**< Marks the end of an entry list. */
+#define EVENT_INDEX_RESERVED 0xFFFE             /**< Marks an entry reserved by app_sched_event_alloc(). */
+
+/**@brief Structure for holding a singly linked FIFO of queue entries. */
+typedef struct
+{
+    uint16_t head;                              /**< Index of the first entry, or EVENT_INDEX_INVALID. */
+    uint16_t tail;                              /**< Index of the last entry. */
+} event_list_t;
 
 static event_header_t * m_queue_event_headers;  /**< Array for holding the queue event headers. */
 static uint8_t        * m_queue_event_data;     /**< Array for holding the queue event data. */
-static volatile uint8_t m_queue_start_index;    /**< Index of queue entry at the start of the queue. */
-static volatile uint8_t m_queue_end_index;      /**< Index of queue entry at the end of the queue. */
-static uint16_t         m_queue_event_size;     /**< Maximum event size in queue. */
+static event_list_t     m_event_lists[APP_SCHED_PRIORITY_LEVELS]; /**< Pending entries, per priority. */
+static uint16_t         m_free_head;            /**< Index of the first unused entry. */
+static volatile uint16_t m_queue_utilization;   /**< Number of entries in use. */
+static uint16_t         m_queue_event_size;     /**< Size of an event data slot. */
 static uint16_t         m_queue_size;           /**< Number of queue entries. */
+static uint16_t         m_drain_budget;         /**< Maximum events per app_sched_execute(), 0 for no limit. */
 
 #ifdef APP_SCHEDULER_WITH_PROFILER
 static uint16_t m_max_queue_utilization;    /**< Maximum observed queue utilization. */
+static app_sched_latency_stats_t m_latency_stats[APP_SCHED_PRIORITY_LEVELS]; /**< Latency statistics. */
 #endif
 
-/**@brief Function for incrementing a queue index, and handle wrap-around.
- *
- * @param[in]   index   Old index.
+
+/**@brief Function for appending an entry to a list. Must be called from a critical region.
  *
- * @return      New (incremented) index.
+ * @param[in]   p_list   List to append to.
+ * @param[in]   index    Index of the entry.
  */
-static __INLINE uint8_t next_index(uint8_t index)
+static __INLINE void event_list_append(event_list_t * p_list, uint16_t index)
 {
-    return (index < m_queue_size) ? (index + 1) : 0;
+    m_queue_event_headers[index].next = EVENT_INDEX_INVALID;
+
+    if (p_list->head == EVENT_INDEX_INVALID)
+    {
+        p_list->head = index;
+    }
+    else
+    {
+        m_queue_event_headers[p_list->tail].next = index;
+    }
+    p_list->tail = index;
 }
 
 
-static __INLINE uint8_t app_sched_queue_full()
+/**@brief Function for taking an entry from the free list. Must be called from a critical region.
+ *
+ * @return      Index of the entry, or EVENT_INDEX_INVALID if the queue is full.
+ */
+static __INLINE uint16_t event_entry_alloc(void)
 {
-  uint8_t tmp = m_queue_start_index;
-  return next_index(m_queue_end_index) == tmp;
-}
+    uint16_t index = m_free_head;
 
-/**@brief Macro for checking if a queue is full. */
-#define APP_SCHED_QUEUE_FULL() app_sched_queue_full()
+    if (index != EVENT_INDEX_INVALID)
+    {
+        m_free_head = m_queue_event_headers[index].next;
+        m_queue_utilization++;
 
+    #ifdef APP_SCHEDULER_WITH_PROFILER
+        if (m_queue_utilization > m_max_queue_utilization)
+        {
+            m_max_queue_utilization = m_queue_utilization;
+        }
+    #endif
+    }
 
-static __INLINE uint8_t app_sched_queue_empty()
-{
-  uint8_t tmp = m_queue_start_index;
-  return m_queue_end_index == tmp;
+    return index;
 }
 
-/**@brief Macro for checking if a queue is empty. */
-#define APP_SCHED_QUEUE_EMPTY() app_sched_queue_empty()
+
+/**@brief Function for returning an entry to the free list.
+ *
+ * @param[in]   index   Index of the entry.
+ */
+static void event_entry_free(uint16_t index)
+{
+    CRITICAL_REGION_ENTER();
+    m_queue_event_headers[index].next = m_free_head;
+    m_free_head                       = index;
+    m_queue_utilization--;
+    CRITICAL_REGION_EXIT();
+}
 
 
 uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
 {
-    uint16_t data_start_index = (queue_size + 1) * sizeof(event_header_t);
+    uint32_t data_start_index = (queue_size + 1) * sizeof(event_header_t);
+    uint16_t i;
 
     // Check that buffer is correctly aligned
     if (!is_word_aligned(p_event_buffer))
@@ -81,16 +130,37 @@ uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event
         return NRF_ERROR_INVALID_PARAM;
     }
 
+    // The free list uses 0xFFFF as terminator, and reserved entries are marked with 0xFFFE.
+    if ((queue_size == 0) || (queue_size >= EVENT_INDEX_RESERVED))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
     // Initialize event scheduler
     m_queue_event_headers = p_event_buffer;
     m_queue_event_data    = &((uint8_t *)p_event_buffer)[data_start_index];
-    m_queue_end_index     = 0;
-    m_queue_start_index   = 0;
-    m_queue_event_size    = event_size;
+    m_queue_event_size    = APP_SCHED_EVENT_SLOT_SIZE(event_size);
     m_queue_size          = queue_size;
+    m_queue_utilization   = 0;
+    m_drain_budget        = 0;
+
+    for (i = 0; i < APP_SCHED_PRIORITY_LEVELS; i++)
+    {
+        m_event_lists[i].head = EVENT_INDEX_INVALID;
+        m_event_lists[i].tail = EVENT_INDEX_INVALID;
+    }
+
+    // Chain all entries into the free list.
+    for (i = 0; i < queue_size; i++)
+    {
+        m_queue_event_headers[i].next = i + 1;
+    }
+    m_queue_event_headers[queue_size - 1].next = EVENT_INDEX_INVALID;
+    m_free_head                                = 0;
 
 #ifdef APP_SCHEDULER_WITH_PROFILER
     m_max_queue_utilization = 0;
+    app_sched_latency_stats_clear();
 #endif
 
     return NRF_SUCCESS;
@@ -98,130 +168,266 @@ uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event
 
 
 #ifdef APP_SCHEDULER_WITH_PROFILER
-static void queue_utilization_check(void)
+uint16_t app_sched_queue_utilization_get(void)
 {
-    uint16_t start = m_queue_start_index;
-    uint16_t end   = m_queue_end_index;
-    uint16_t queue_utilization = (end >= start) ? (end - start) :
-        (m_queue_size + 1 - start + end);
+    return m_max_queue_utilization;
+}
+
+
+/**@brief Function for recording the dispatch latency of an event.
+ *
+ * @param[in]   priority    Priority level the event was scheduled with.
+ * @param[in]   timestamp   Time at which the event was scheduled.
+ */
+static void latency_record(uint8_t priority, uint32_t timestamp)
+{
+    app_sched_latency_stats_t * p_stats = &m_latency_stats[priority];
+    uint32_t                    latency;
+    uint32_t                    bucket = 0;
+
+    latency = (APP_SCHED_TIMESTAMP_GET() - timestamp) & APP_SCHED_TIMESTAMP_MASK;
 
-    if (queue_utilization > m_max_queue_utilization)
+    while ((latency >> bucket) != 0 && bucket < (APP_SCHED_LATENCY_BUCKETS - 1))
     {
-        m_max_queue_utilization = queue_utilization;
+        bucket++;
+    }
+
+    p_stats->histogram[bucket]++;
+    p_stats->event_count++;
+    if (latency > p_stats->max_latency)
+    {
+        p_stats->max_latency = latency;
     }
 }
 
-uint16_t app_sched_queue_utilization_get(void)
+
+uint32_t app_sched_latency_stats_get(uint8_t priority, app_sched_latency_stats_t * p_stats)
 {
-    return m_max_queue_utilization;
+    if (priority >= APP_SCHED_PRIORITY_LEVELS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    *p_stats = m_latency_stats[priority];
+
+    return NRF_SUCCESS;
+}
+
+
+void app_sched_latency_stats_clear(void)
+{
+    memset(m_latency_stats, 0, sizeof(m_latency_stats));
 }
 #endif
 
 
-uint32_t app_sched_event_put(void                    * p_event_data,
-                             uint16_t                  event_data_size,
-                             app_sched_event_handler_t handler)
+uint32_t app_sched_event_alloc(uint16_t event_data_size, void ** pp_event_data)
 {
-    uint32_t err_code;
+    uint16_t event_index;
 
-    if (event_data_size <= m_queue_event_size)
+    if (event_data_size > m_queue_event_size)
     {
-        uint16_t event_index = 0xFFFF;
+        return NRF_ERROR_INVALID_LENGTH;
+    }
 
-        CRITICAL_REGION_ENTER();
+    CRITICAL_REGION_ENTER();
+    event_index = event_entry_alloc();
+    CRITICAL_REGION_EXIT();
 
-        if (!APP_SCHED_QUEUE_FULL())
-        {
-            event_index       = m_queue_end_index;
-            m_queue_end_index = next_index(m_queue_end_index);
-
-        #ifdef APP_SCHEDULER_WITH_PROFILER
-            // This function call must be protected with critical region because
-            // it modifies 'm_max_queue_utilization'.
-            queue_utilization_check();
-        #endif
-        }
+    if (event_index == EVENT_INDEX_INVALID)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
 
-        CRITICAL_REGION_EXIT();
+    // NOTE: The entry is on neither the free list nor an event list until it is committed, so it
+    //       can be filled in outside of the critical region.
+    m_queue_event_headers[event_index].event_data_size = event_data_size;
+    m_queue_event_headers[event_index].next            = EVENT_INDEX_RESERVED;
+    *pp_event_data = &m_queue_event_data[(uint32_t)event_index * m_queue_event_size];
 
-        if (event_index != 0xFFFF)
-        {
-            // NOTE: This can be done outside the critical region since the event consumer will
-            //       always be called from the main loop, and will thus never interrupt this code.
-            m_queue_event_headers[event_index].handler = handler;
-            if ((p_event_data != NULL) && (event_data_size > 0))
-            {
-                memcpy(&m_queue_event_data[event_index * m_queue_event_size],
-                       p_event_data,
-                       event_data_size);
-                m_queue_event_headers[event_index].event_data_size = event_data_size;
-            }
-            else
-            {
-                m_queue_event_headers[event_index].event_data_size = 0;
-            }
-
-            err_code = NRF_SUCCESS;
-        }
-        else
-        {
-            err_code = NRF_ERROR_NO_MEM;
-        }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_commit(void                    * p_event_data,
+                                app_sched_event_handler_t handler,
+                                uint8_t                   priority)
+{
+    uint32_t offset   = (uint8_t *)p_event_data - m_queue_event_data;
+    uint32_t err_code = NRF_ERROR_INVALID_STATE;
+    uint16_t event_index;
+
+    if ((priority >= APP_SCHED_PRIORITY_LEVELS) || (m_queue_event_size == 0) ||
+        ((uint8_t *)p_event_data < m_queue_event_data) || ((offset % m_queue_event_size) != 0) ||
+        ((offset / m_queue_event_size) >= m_queue_size))
+    {
+        return NRF_ERROR_INVALID_PARAM;
     }
-    else
+
+    event_index = offset / m_queue_event_size;
+
+    CRITICAL_REGION_ENTER();
+    if (m_queue_event_headers[event_index].next == EVENT_INDEX_RESERVED)
     {
-        err_code = NRF_ERROR_INVALID_LENGTH;
+        m_queue_event_headers[event_index].handler = handler;
+    #ifdef APP_SCHEDULER_WITH_PROFILER
+        m_queue_event_headers[event_index].timestamp = APP_SCHED_TIMESTAMP_GET();
+    #endif
+        event_list_append(&m_event_lists[priority], event_index);
+        err_code = NRF_SUCCESS;
     }
+    CRITICAL_REGION_EXIT();
 
+    // Otherwise the entry is free, or was already committed.
     return err_code;
 }
 
 
-/**@brief Function for reading the next event from specified event queue.
+uint32_t app_sched_event_put_prio(void                    * p_event_data,
+                                  uint16_t                  event_data_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority)
+{
+    uint32_t event_index;
+    uint32_t offset;
+
+    if (priority >= APP_SCHED_PRIORITY_LEVELS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (event_data_size > m_queue_event_size)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    if (p_event_data == NULL)
+    {
+        event_data_size = 0;
+    }
+
+    CRITICAL_REGION_ENTER();
+    event_index = event_entry_alloc();
+    CRITICAL_REGION_EXIT();
+
+    if (event_index == EVENT_INDEX_INVALID)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    // NOTE: This can be done outside the critical region since the entry is owned by this call
+    //       until it is linked into an event list.
+    offset = event_index * m_queue_event_size;
+    if (event_data_size > 0)
+    {
+        memcpy(&m_queue_event_data[offset], p_event_data, event_data_size);
+    }
+    m_queue_event_headers[event_index].event_data_size = event_data_size;
+    m_queue_event_headers[event_index].handler         = handler;
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+    m_queue_event_headers[event_index].timestamp = APP_SCHED_TIMESTAMP_GET();
+#endif
+
+    CRITICAL_REGION_ENTER();
+    event_list_append(&m_event_lists[priority], event_index);
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_put(void                    * p_event_data,
+                             uint16_t                  event_data_size,
+                             app_sched_event_handler_t handler)
+{
+    return app_sched_event_put_prio(p_event_data,
+                                    event_data_size,
+                                    handler,
+                                    APP_SCHED_PRIORITY_DEFAULT);
+}
+
+
+/**@brief Function for taking the next event from the highest priority non-empty list.
  *
- * @param[out]  pp_event_data       Pointer to pointer to event data.
- * @param[out]  p_event_data_size   Pointer to size of event data.
- * @param[out]  p_event_handler     Pointer to event handler function pointer.
+ * @param[out]  p_priority   Priority level of the event.
  *
- * @return      NRF_SUCCESS if new event, NRF_ERROR_NOT_FOUND if event queue is empty.
+ * @return      Index of the entry, or EVENT_INDEX_INVALID if no event is pending.
  */
-static uint32_t app_sched_event_get(void                     ** pp_event_data,
-                                    uint16_t *                  p_event_data_size,
-                                    app_sched_event_handler_t * p_event_handler)
+static uint16_t app_sched_event_get(uint8_t * p_priority)
 {
-    uint32_t err_code = NRF_ERROR_NOT_FOUND;
+    uint16_t event_index = EVENT_INDEX_INVALID;
+    uint8_t  priority;
+
+    CRITICAL_REGION_ENTER();
 
-    if (!APP_SCHED_QUEUE_EMPTY())
+    for (priority = 0; priority < APP_SCHED_PRIORITY_LEVELS; priority++)
     {
-        uint16_t event_index;
+        event_index = m_event_lists[priority].head;
+        if (event_index != EVENT_INDEX_INVALID)
+        {
+            m_event_lists[priority].head = m_queue_event_headers[event_index].next;
+            *p_priority                  = priority;
+            break;
+        }
+    }
+
+    CRITICAL_REGION_EXIT();
 
-        // NOTE: There is no need for a critical region here, as this function will only be called
-        //       from app_sched_execute() from inside the main loop, so it will never interrupt
-        //       app_sched_event_put(). Also, updating of (i.e. writing to) the start index will be
-        //       an atomic operation.
-        event_index         = m_queue_start_index;
-        m_queue_start_index = next_index(m_queue_start_index);
+    return event_index;
+}
 
-        *pp_event_data     = &m_queue_event_data[event_index * m_queue_event_size];
-        *p_event_data_size = m_queue_event_headers[event_index].event_data_size;
-        *p_event_handler   = m_queue_event_headers[event_index].handler;
 
-        err_code = NRF_SUCCESS;
+void app_sched_execute(void)
+{
+    uint16_t budget = m_drain_budget;
+    uint16_t event_index;
+    uint8_t  priority;
+
+    // Get next event (if any), and execute handler. The entry is returned to the free list only
+    // after the handler has returned, so the event data stays valid during the call.
+    while ((event_index = app_sched_event_get(&priority)) != EVENT_INDEX_INVALID)
+    {
+        event_header_t * p_header = &m_queue_event_headers[event_index];
+
+    #ifdef APP_SCHEDULER_WITH_PROFILER
+        latency_record(priority, p_header->timestamp);
+    #else
+        UNUSED_VARIABLE(priority);
+    #endif
+
+        p_header->handler(&m_queue_event_data[(uint32_t)event_index * m_queue_event_size],
+                          p_header->event_data_size);
+
+        event_entry_free(event_index);
+
+        if ((budget != 0) && (--budget == 0))
+        {
+            break;
+        }
     }
+}
 
-    return err_code;
+
+void app_sched_drain_budget_set(uint16_t max_events)
+{
+    m_drain_budget = max_events;
 }
 
 
-void app_sched_execute(void)
+bool app_sched_queue_is_empty(void)
 {
-    void                    * p_event_data;
-    uint16_t                  event_data_size;
-    app_sched_event_handler_t event_handler;
+    uint8_t priority;
 
-    // Get next event (if any), and execute handler
-    while ((app_sched_event_get(&p_event_data, &event_data_size, &event_handler) == NRF_SUCCESS))
+    for (priority = 0; priority < APP_SCHED_PRIORITY_LEVELS; priority++)
     {
-        event_handler(p_event_data, event_data_size);
+        if (m_event_lists[priority].head != EVENT_INDEX_INVALID)
+        {
+            return false;
+        }
     }
+
+    return true;
 }
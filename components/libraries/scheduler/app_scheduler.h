@@ -51,10 +51,38 @@
 #define APP_SCHEDULER_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "app_error.h"
 #include "app_util.h"
 
+#ifndef APP_SCHED_PRIORITY_LEVELS
+#define APP_SCHED_PRIORITY_LEVELS 3         /**< Number of event priority levels. Level 0 is executed first. */
+#endif
+
+#define APP_SCHED_PRIORITY_HIGHEST 0                                /**< Highest event priority. */
+#define APP_SCHED_PRIORITY_LOWEST  (APP_SCHED_PRIORITY_LEVELS - 1)  /**< Lowest event priority. */
+#define APP_SCHED_PRIORITY_DEFAULT (APP_SCHED_PRIORITY_LOWEST / 2)  /**< Priority used by app_sched_event_put(). */
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+#define APP_SCHED_EVENT_HEADER_SIZE 12      /**< Size of app_scheduler.event_header_t (only for use inside APP_SCHED_BUF_SIZE()). */
+#define APP_SCHED_LATENCY_BUCKETS   12      /**< Number of buckets in the event latency histogram. */
+
+#ifndef APP_SCHED_TIMESTAMP_GET
+/**@brief Timestamp used for latency measurements. Defaults to the RTC used by app_timer. */
+#define APP_SCHED_TIMESTAMP_GET()   (NRF_RTC1->COUNTER)
+#define APP_SCHED_TIMESTAMP_MASK    0x00FFFFFF  /**< Valid bits of APP_SCHED_TIMESTAMP_GET(). */
+#endif
+
+#ifndef APP_SCHED_TIMESTAMP_MASK
+#define APP_SCHED_TIMESTAMP_MASK    0xFFFFFFFF
+#endif
+#else
 #define APP_SCHED_EVENT_HEADER_SIZE 8       /**< Size of app_scheduler.event_header_t (only for use inside APP_SCHED_BUF_SIZE()). */
+#endif
+
+/**@brief Size of a single event data slot, rounded up so that every slot is word aligned. */
+#define APP_SCHED_EVENT_SLOT_SIZE(EVENT_SIZE)                                                      \
+            (CEIL_DIV((EVENT_SIZE), sizeof(uint32_t)) * sizeof(uint32_t))
 
 /**@brief Compute number of bytes required to hold the scheduler buffer.
  *
@@ -65,8 +93,8 @@
  * @return    Required scheduler buffer size (in bytes).
  */
 #define APP_SCHED_BUF_SIZE(EVENT_SIZE, QUEUE_SIZE)                                                 \
-            (((EVENT_SIZE) + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1))
-            
+            ((APP_SCHED_EVENT_SLOT_SIZE(EVENT_SIZE) + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1))
+
 /**@brief Scheduler event handler type. */
 typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_size);
 
@@ -111,13 +139,33 @@ typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_si
  */
 uint32_t app_sched_init(uint16_t max_event_size, uint16_t queue_size, void * p_evt_buffer);
 
-/**@brief Function for executing all scheduled events.
+/**@brief Function for executing scheduled events.
  *
  * @details This function must be called from within the main loop. It will execute all events
- *          scheduled since the last time it was called.
+ *          scheduled since the last time it was called, highest priority first. An event scheduled
+ *          with a higher priority while the queue is being drained is executed before any pending
+ *          event of lower priority.
+ *
+ *          If a drain budget has been set with @ref app_sched_drain_budget_set, at most that many
+ *          events are executed per call. Use @ref app_sched_queue_is_empty to check whether
+ *          events are still pending before putting the CPU to sleep.
  */
 void app_sched_execute(void);
 
+/**@brief Function for limiting the number of events executed by one call to app_sched_execute().
+ *
+ * @param[in]   max_events   Maximum number of events to execute per call. 0 means no limit,
+ *                           which is the default.
+ */
+void app_sched_drain_budget_set(uint16_t max_events);
+
+/**@brief Function for checking if there are no events pending in the scheduler.
+ *
+ * @retval      true    No event is pending.
+ * @retval      false   At least one event is waiting to be executed.
+ */
+bool app_sched_queue_is_empty(void);
+
 /**@brief Function for scheduling an event.
  *
  * @details Puts an event into the event queue.
@@ -132,6 +180,58 @@ uint32_t app_sched_event_put(void *                    p_event_data,
                              uint16_t                  event_size,
                              app_sched_event_handler_t handler);
 
+/**@brief Function for scheduling an event with a given priority.
+ *
+ * @details Puts an event into the event queue of the given priority level.
+ *
+ * @param[in]   p_event_data   Pointer to event data to be scheduled.
+ * @param[in]   event_size     Size of event data to be scheduled.
+ * @param[in]   handler        Event handler to receive the event.
+ * @param[in]   priority       Priority level, from @ref APP_SCHED_PRIORITY_HIGHEST to
+ *                             @ref APP_SCHED_PRIORITY_LOWEST.
+ *
+ * @retval      NRF_SUCCESS               Event scheduled.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority level.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Event data does not fit in a queue entry.
+ * @retval      NRF_ERROR_NO_MEM          Queue is full.
+ */
+uint32_t app_sched_event_put_prio(void *                    p_event_data,
+                                  uint16_t                  event_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority);
+
+/**@brief Function for reserving a queue entry to be filled in place.
+ *
+ * @details Lets the caller build the event data directly in the scheduler buffer instead of
+ *          in a local variable that is then copied by app_sched_event_put(). The entry is not
+ *          visible to app_sched_execute() until @ref app_sched_event_commit is called, and
+ *          every successful reservation must be committed.
+ *
+ * @param[in]   event_size       Size of event data that will be written to the entry.
+ * @param[out]  pp_event_data    Pointer to the word aligned event data area of the entry.
+ *
+ * @retval      NRF_SUCCESS               Entry reserved.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Event data does not fit in a queue entry.
+ * @retval      NRF_ERROR_NO_MEM          Queue is full.
+ */
+uint32_t app_sched_event_alloc(uint16_t event_size, void ** pp_event_data);
+
+/**@brief Function for scheduling an entry reserved with app_sched_event_alloc().
+ *
+ * @param[in]   p_event_data   Event data pointer returned by @ref app_sched_event_alloc.
+ * @param[in]   handler        Event handler to receive the event.
+ * @param[in]   priority       Priority level, from @ref APP_SCHED_PRIORITY_HIGHEST to
+ *                             @ref APP_SCHED_PRIORITY_LOWEST.
+ *
+ * @retval      NRF_SUCCESS               Event scheduled.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority level or event data pointer.
+ * @retval      NRF_ERROR_INVALID_STATE   The entry is not reserved, for example because it was
+ *                                        already committed.
+ */
+uint32_t app_sched_event_commit(void *                    p_event_data,
+                                app_sched_event_handler_t handler,
+                                uint8_t                   priority);
+
 #ifdef APP_SCHEDULER_WITH_PROFILER
 /**@brief Function for getting the maximum observed queue utilization.
  *
@@ -140,6 +240,33 @@ uint32_t app_sched_event_put(void *                    p_event_data,
  * @return Maximum number of events in queue observed so far.
  */
 uint16_t app_sched_queue_utilization_get(void);
+
+/**@brief Enqueue-to-dispatch latency statistics of one priority level.
+ *
+ * @details Latencies are measured in ticks of @ref APP_SCHED_TIMESTAMP_GET. Bucket 0 counts
+ *          events dispatched within the same tick, bucket n counts latencies in the range
+ *          [2^(n-1), 2^n) ticks and the last bucket counts everything above.
+ */
+typedef struct
+{
+    uint32_t histogram[APP_SCHED_LATENCY_BUCKETS]; /**< Number of events per latency bucket. */
+    uint32_t max_latency;                          /**< Highest latency observed, in ticks. */
+    uint32_t event_count;                          /**< Number of events dispatched. */
+} app_sched_latency_stats_t;
+
+/**@brief Function for getting the latency statistics of a priority level.
+ *
+ * @param[in]   priority   Priority level.
+ * @param[out]  p_stats    Latency statistics.
+ *
+ * @retval      NRF_SUCCESS               Statistics copied.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority level.
+ * @retval      NRF_ERROR_NULL            p_stats is NULL.
+ */
+uint32_t app_sched_latency_stats_get(uint8_t priority, app_sched_latency_stats_t * p_stats);
+
+/**@brief Function for clearing the latency statistics of all priority levels. */
+void app_sched_latency_stats_clear(void);
 #endif
 
 #ifdef APP_SCHEDULER_WITH_PAUSE
@@ -30,8 +30,8 @@ STATIC_ASSERT(sizeof (event_header_t) <= APP_SCHED_EVENT_HEADER_SIZE);
 
 static event_header_t * m_queue_event_headers; /**< Array for holding the queue event headers. */
 static uint8_t *        m_queue_event_data;    /**< Array for holding the queue event data. */
-static volatile uint8_t m_queue_start_index;   /**< Index of queue entry at the start of the queue. */
-static volatile uint8_t m_queue_end_index;     /**< Index of queue entry at the end of the queue. */
+static volatile uint16_t m_queue_start_index;   /**< Index of queue entry at the start of the queue. */
+static volatile uint16_t m_queue_end_index;     /**< Index of queue entry at the end of the queue. */
 static uint16_t         m_queue_event_size;    /**< Maximum event size in queue. */
 static uint16_t         m_queue_size;          /**< Number of queue entries. */
 
@@ -48,14 +48,14 @@ static uint32_t m_scheduler_paused_counter = 0; /**< Counter storing the differe
  *
  * @return      New (incremented) index.
  */
-static __INLINE uint8_t next_index(uint8_t index)
+static __INLINE uint16_t next_index(uint16_t index)
 {
     return (index < m_queue_size) ? (index + 1) : 0;
 }
 
 static __INLINE uint8_t app_sched_queue_full(void)
 {
-  uint8_t tmp = m_queue_start_index;
+  uint16_t tmp = m_queue_start_index;
   return next_index(m_queue_end_index) == tmp;
 }
 
@@ -64,7 +64,7 @@ static __INLINE uint8_t app_sched_queue_full(void)
 
 static __INLINE uint8_t app_sched_queue_empty(void)
 {
-  uint8_t tmp = m_queue_start_index;
+  uint16_t tmp = m_queue_start_index;
   return m_queue_end_index == tmp;
 }
 
@@ -74,7 +74,7 @@ static __INLINE uint8_t app_sched_queue_empty(void)
 
 uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
 {
-    uint16_t data_start_index = (queue_size + 1) * sizeof (event_header_t);
+    uint32_t data_start_index = (queue_size + 1) * sizeof (event_header_t);
 
     //Check that buffer is correctly aligned
     if (!is_word_aligned(p_event_buffer))
@@ -177,6 +177,21 @@ uint32_t app_sched_event_put(void *                    p_event_data,
 }
 
 
+uint32_t app_sched_event_put_prio(void *                    p_event_data,
+                                  uint16_t                  event_data_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority)
+{
+    // The connectivity scheduler has a single queue, all events are executed in order.
+    if (priority >= APP_SCHED_PRIORITY_LEVELS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    return app_sched_event_put(p_event_data, event_data_size, handler);
+}
+
+
 /**@brief Function for reading the next event from specified event queue.
  *
  * @param[out]  pp_event_data       Pointer to pointer to event data.
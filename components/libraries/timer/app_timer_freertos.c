@@ -39,7 +39,7 @@
 #define APP_TIMER_WAIT_FOR_QUEUE 2
 
 /**@brief This structure keeps information about osTimer.*/
-typedef struct
+typedef struct app_timer_info_s
 {
     void                      * argument;
     TimerHandle_t               osHandle;
@@ -49,6 +49,8 @@ typedef struct
      * FreeRTOS may have timer running even after stop function is called,
      * because it processes commands in Timer task and stopping function only puts command into the queue. */
     bool                        active;
+    /** Next created timer, used by @ref app_timer_stop_all. */
+    struct app_timer_info_s   * p_next;
 }app_timer_info_t;
 
 /**
@@ -61,6 +63,9 @@ typedef struct
  */
 static uint32_t m_prescaler;
 
+/** @brief List of created timers. */
+static app_timer_info_t * mp_timers;
+
 /* Check if freeRTOS timers are activated */
 #if configUSE_TIMERS == 0
     #error app_timer for freeRTOS requires configUSE_TIMERS option to be activated.
@@ -70,6 +75,32 @@ static uint32_t m_prescaler;
 STATIC_ASSERT(sizeof(app_timer_info_t) <= sizeof(app_timer_t));
 
 
+/**
+ * @brief Function for converting app_timer ticks to system ticks.
+ *
+ * @param[in] timeout_ticks Number of ticks at the frequency set by the app_timer prescaler.
+ *
+ * @return Number of system ticks, at least 1.
+ */
+static TickType_t ticks_to_os_ticks(uint32_t timeout_ticks)
+{
+    uint32_t rtc_prescaler = portNRF_RTC_REG->PRESCALER + 1;
+    uint64_t os_ticks      = ROUNDED_DIV((uint64_t)timeout_ticks * m_prescaler, rtc_prescaler);
+
+    if(os_ticks == 0)
+    {
+        /* FreeRTOS does not accept a zero period. */
+        os_ticks = 1;
+    }
+    else if(os_ticks > portMAX_DELAY)
+    {
+        os_ticks = portMAX_DELAY;
+    }
+
+    return (TickType_t)os_ticks;
+}
+
+
 /**
  * @brief Internal callback function for the system timer
  *
@@ -107,7 +138,7 @@ uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
                           app_timer_mode_t            mode,
                           app_timer_timeout_handler_t timeout_handler)
 {
-    app_timer_info_t * pinfo = (app_timer_info_t*)(*p_timer_id);
+    app_timer_info_t * pinfo;
     uint32_t      err_code = NRF_SUCCESS;
     unsigned long timer_mode;
 
@@ -115,6 +146,7 @@ uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
     {
         return NRF_ERROR_INVALID_PARAM;
     }
+    pinfo = (app_timer_info_t*)(*p_timer_id);
     if(pinfo->active)
     {
         return NRF_ERROR_INVALID_STATE;
@@ -123,7 +155,7 @@ uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
     if(pinfo->osHandle == NULL)
     {
         /* New timer is created */
-        memset(pinfo, 0, sizeof(pinfo));
+        memset(pinfo, 0, sizeof(*pinfo));
 
         if(mode == APP_TIMER_MODE_SINGLE_SHOT)
             timer_mode = pdFALSE;
@@ -134,7 +166,16 @@ uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
         pinfo->osHandle = xTimerCreate(" ", 1000, timer_mode, pinfo, app_timer_callback);
 
         if(pinfo->osHandle == NULL)
+        {
             err_code = NRF_ERROR_NULL;
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            pinfo->p_next = mp_timers;
+            mp_timers     = pinfo;
+            taskEXIT_CRITICAL();
+        }
     }
     else
     {
@@ -150,9 +191,7 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
 {
     app_timer_info_t * pinfo = (app_timer_info_t*)(timer_id);
     TimerHandle_t hTimer = pinfo->osHandle;
-    uint32_t rtc_prescaler = portNRF_RTC_REG->PRESCALER  + 1;
-    /* Get back the microseconds to wait */
-    uint32_t timeout_corrected = ROUNDED_DIV(timeout_ticks*m_prescaler, rtc_prescaler);
+    TickType_t timeout_corrected = ticks_to_os_ticks(timeout_ticks);
 
     if(hTimer == NULL)
     {
@@ -211,7 +250,7 @@ uint32_t app_timer_stop(app_timer_id_t timer_id)
     if(__get_IPSR() != 0)
     {
         BaseType_t yieldReq = pdFALSE;
-        if(xTimerStopFromISR(timer_id, &yieldReq) != pdPASS)
+        if(xTimerStopFromISR(hTimer, &yieldReq) != pdPASS)
         {
             return NRF_ERROR_NO_MEM;
         }
@@ -219,7 +258,7 @@ uint32_t app_timer_stop(app_timer_id_t timer_id)
     }
     else
     {
-        if(xTimerStop(timer_id, APP_TIMER_WAIT_FOR_QUEUE) != pdPASS)
+        if(xTimerStop(hTimer, APP_TIMER_WAIT_FOR_QUEUE) != pdPASS)
         {
             return NRF_ERROR_NO_MEM;
         }
@@ -228,3 +267,53 @@ uint32_t app_timer_stop(app_timer_id_t timer_id)
     pinfo->active = false;
     return NRF_SUCCESS;
 }
+
+
+uint32_t app_timer_stop_all(void)
+{
+    app_timer_info_t * pinfo;
+
+    for(pinfo = mp_timers; pinfo != NULL; pinfo = pinfo->p_next)
+    {
+        if(pinfo->active)
+        {
+            uint32_t err_code = app_timer_stop((app_timer_id_t)pinfo);
+            if(err_code != NRF_SUCCESS)
+            {
+                return err_code;
+            }
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_get(uint32_t * p_ticks)
+{
+    uint32_t rtc_prescaler = portNRF_RTC_REG->PRESCALER + 1;
+
+    /* The RTC runs at the system tick rate, scale it to the app_timer prescaler. */
+    *p_ticks = (uint32_t)(((uint64_t)portNRF_RTC_REG->COUNTER * rtc_prescaler) / m_prescaler);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_diff_compute(uint32_t   ticks_to,
+                                    uint32_t   ticks_from,
+                                    uint32_t * p_ticks_diff)
+{
+    uint32_t rtc_prescaler = portNRF_RTC_REG->PRESCALER + 1;
+    /* Value at which the scaled counter wraps around. */
+    uint32_t wrap = (uint32_t)(((uint64_t)portNRF_RTC_MAXTICKS + 1) * rtc_prescaler / m_prescaler);
+
+    if(ticks_to >= ticks_from)
+    {
+        *p_ticks_diff = ticks_to - ticks_from;
+    }
+    else
+    {
+        *p_ticks_diff = (wrap - ticks_from) + ticks_to;
+    }
+    return NRF_SUCCESS;
+}
@@ -24,6 +24,12 @@
         p_queue->idx = (idx > p_queue->size) ? 0 : idx; \
     } while (0)
 
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+#define SEQUENCE_RUNNING(p_app_twi) ((p_app_twi)->p_sequence != NULL)
+#else
+#define SEQUENCE_RUNNING(p_app_twi) false
+#endif
+
 
 static bool queue_put(app_twi_queue_t *             p_queue,
                       app_twi_transaction_t const * p_transaction)
@@ -154,7 +160,8 @@ static void start_pending_transaction(app_twi_t * p_app_twi,
         bool start_transaction = false;
 
         CRITICAL_REGION_ENTER();
-        if (switch_transaction || app_twi_is_idle(p_app_twi))
+        // Queued transactions wait until a running sequence is stopped.
+        if ((switch_transaction || app_twi_is_idle(p_app_twi)) && !SEQUENCE_RUNNING(p_app_twi))
         {
             p_app_twi->p_current_transaction = queue_get(&p_app_twi->queue);
             if (p_app_twi->p_current_transaction != NULL)
@@ -193,6 +200,10 @@ static void start_pending_transaction(app_twi_t * p_app_twi,
 }
 
 
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+static void sequence_end(app_twi_t * p_app_twi, ret_code_t result);
+#endif
+
 static void twi_event_handler(nrf_drv_twi_evt_t const * p_event,
                               void *                    p_context)
 {
@@ -201,6 +212,15 @@ static void twi_event_handler(nrf_drv_twi_evt_t const * p_event,
     app_twi_t * p_app_twi = (app_twi_t *)p_context;
     ret_code_t result;
 
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+    if (SEQUENCE_RUNNING(p_app_twi))
+    {
+        // Reads of a sequence generate driver events only on errors.
+        sequence_end(p_app_twi, NRF_ERROR_INTERNAL);
+        return;
+    }
+#endif
+
     // This callback should be called only during transaction.
     ASSERT(p_app_twi->p_current_transaction != NULL);
 
@@ -273,6 +293,9 @@ ret_code_t app_twi_init(app_twi_t *                     p_app_twi,
 
     p_app_twi->internal_transaction_in_progress = false;
     p_app_twi->p_current_transaction            = NULL;
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+    p_app_twi->p_sequence                       = NULL;
+#endif
 
     return NRF_SUCCESS;
 }
@@ -374,3 +397,300 @@ ret_code_t app_twi_perform(app_twi_t *                p_app_twi,
         return p_app_twi->internal_transaction_result;
     }
 }
+
+
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+// Sets up the repeated read so that the next trigger stores the data
+// in the first frame of the ring.
+static ret_code_t sequence_xfer_setup(app_twi_t * p_app_twi)
+{
+    app_twi_sequence_t const * p_sequence = p_app_twi->p_sequence;
+    nrf_drv_twi_xfer_desc_t    xfer_desc  =
+        NRF_DRV_TWI_XFER_DESC_TXRX(p_sequence->address,
+                                   p_sequence->p_reg,    p_sequence->reg_length,
+                                   p_sequence->p_frames, p_sequence->frame_length);
+
+    return nrf_drv_twi_xfer(&p_app_twi->twi, &xfer_desc,
+                            NRF_DRV_TWI_FLAG_HOLD_XFER           |
+                            NRF_DRV_TWI_FLAG_REPEATED_XFER       |
+                            NRF_DRV_TWI_FLAG_RX_POSTINC          |
+                            NRF_DRV_TWI_FLAG_NO_XFER_EVT_HANDLER);
+}
+
+
+// Calls back for every group of frames_per_event frames read up to frames_done.
+static void sequence_frames_report(app_twi_t * p_app_twi, uint32_t frames_done)
+{
+    app_twi_sequence_t const * p_sequence = p_app_twi->p_sequence;
+
+    while ((p_app_twi->p_sequence == p_sequence) &&
+           (p_app_twi->sequence_frame_idx + p_sequence->frames_per_event <= frames_done))
+    {
+        uint16_t first_frame = p_app_twi->sequence_frame_idx;
+
+        p_app_twi->sequence_frame_idx = first_frame + p_sequence->frames_per_event;
+        if (p_sequence->callback)
+        {
+            p_sequence->callback(NRF_SUCCESS,
+                                 &p_sequence->p_frames[first_frame * p_sequence->frame_length],
+                                 p_sequence->frames_per_event,
+                                 p_sequence->p_user_data);
+        }
+    }
+}
+
+
+static void sequence_counter_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    app_twi_t                * p_app_twi  = (app_twi_t *)p_context;
+    app_twi_sequence_t const * p_sequence = p_app_twi->p_sequence;
+
+    if (p_sequence == NULL)
+    {
+        return;
+    }
+
+    if (event_type == NRF_TIMER_EVENT_COMPARE1)
+    {
+        // The end of the ring has been reached. The counter has been cleared and the trigger
+        // channel disabled through its group, so no read is started until the EasyDMA list
+        // is rewound.
+        sequence_frames_report(p_app_twi, p_sequence->frame_count);
+        if (p_app_twi->p_sequence != p_sequence)
+        {
+            return;
+        }
+
+        ret_code_t err_code = sequence_xfer_setup(p_app_twi);
+        if (err_code != NRF_SUCCESS)
+        {
+            sequence_end(p_app_twi, err_code);
+            return;
+        }
+        p_app_twi->sequence_frame_idx = 0;
+        nrf_drv_timer_compare(p_sequence->p_counter, NRF_TIMER_CC_CHANNEL0,
+                              p_sequence->frames_per_event, true);
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_group_enable(p_app_twi->sequence_ppi_group));
+    }
+    else if (event_type == NRF_TIMER_EVENT_COMPARE0)
+    {
+        uint32_t next_boundary;
+
+        // When the interrupt is served late, the counter may already have passed the next
+        // boundary, which then raises no event.
+        do
+        {
+            sequence_frames_report(p_app_twi,
+                nrf_drv_timer_capture(p_sequence->p_counter, NRF_TIMER_CC_CHANNEL2));
+            if (p_app_twi->p_sequence != p_sequence)
+            {
+                return;
+            }
+
+            // The last frames of the ring are reported on COMPARE1.
+            next_boundary = p_app_twi->sequence_frame_idx + p_sequence->frames_per_event;
+            if (next_boundary >= p_sequence->frame_count)
+            {
+                return;
+            }
+            nrf_drv_timer_compare(p_sequence->p_counter, NRF_TIMER_CC_CHANNEL0,
+                                  next_boundary, true);
+        } while (nrf_drv_timer_capture(p_sequence->p_counter, NRF_TIMER_CC_CHANNEL2)
+                 >= next_boundary);
+    }
+}
+
+
+static ret_code_t sequence_resources_alloc(app_twi_t *                p_app_twi,
+                                           app_twi_sequence_t const * p_sequence)
+{
+    ret_code_t err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != MODULE_ALREADY_INITIALIZED))
+    {
+        return err_code;
+    }
+
+    err_code = nrf_drv_ppi_group_alloc(&p_app_twi->sequence_ppi_group);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_ppi_channel_alloc(&p_app_twi->sequence_ppi_trigger);
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = nrf_drv_ppi_channel_alloc(&p_app_twi->sequence_ppi_count);
+        if (err_code == NRF_SUCCESS)
+        {
+            err_code = nrf_drv_ppi_channel_alloc(&p_app_twi->sequence_ppi_stop);
+            if (err_code != NRF_SUCCESS)
+            {
+                UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_count));
+            }
+        }
+        if (err_code != NRF_SUCCESS)
+        {
+            UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_trigger));
+        }
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_group_free(p_app_twi->sequence_ppi_group));
+        return err_code;
+    }
+
+    nrf_drv_timer_config_t timer_config =
+    {
+        .frequency          = NRF_TIMER_FREQ_16MHz,
+        .mode               = NRF_TIMER_MODE_COUNTER,
+        .bit_width          = NRF_TIMER_BIT_WIDTH_16,
+        .interrupt_priority = APP_IRQ_PRIORITY_LOW,
+        .p_context          = p_app_twi
+    };
+
+    err_code = nrf_drv_timer_init(p_sequence->p_counter, &timer_config, sequence_counter_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_stop));
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_count));
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_trigger));
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_group_free(p_app_twi->sequence_ppi_group));
+        return err_code;
+    }
+
+    // The counter holds the number of frames read since the last rewind. COMPARE0 marks the
+    // next group of frames to be reported, COMPARE1 the end of the ring.
+    nrf_drv_timer_compare(p_sequence->p_counter,
+                          NRF_TIMER_CC_CHANNEL0,
+                          p_sequence->frames_per_event,
+                          true);
+    nrf_drv_timer_extended_compare(p_sequence->p_counter,
+                                   NRF_TIMER_CC_CHANNEL1,
+                                   p_sequence->frame_count,
+                                   NRF_TIMER_SHORT_COMPARE1_CLEAR_MASK,
+                                   true);
+    nrf_drv_timer_clear(p_sequence->p_counter);
+    nrf_drv_timer_enable(p_sequence->p_counter);
+
+    return NRF_SUCCESS;
+}
+
+
+static void sequence_resources_free(app_twi_t *                p_app_twi,
+                                    app_twi_sequence_t const * p_sequence)
+{
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_group_disable(p_app_twi->sequence_ppi_group));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_disable(p_app_twi->sequence_ppi_trigger));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_disable(p_app_twi->sequence_ppi_count));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_disable(p_app_twi->sequence_ppi_stop));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_trigger));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_count));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(p_app_twi->sequence_ppi_stop));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_remove_from_group(p_app_twi->sequence_ppi_trigger,
+                                                              p_app_twi->sequence_ppi_group));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_group_free(p_app_twi->sequence_ppi_group));
+
+    nrf_drv_timer_uninit(p_sequence->p_counter);
+}
+
+
+static void sequence_end(app_twi_t * p_app_twi, ret_code_t result)
+{
+    app_twi_sequence_t const * p_sequence = p_app_twi->p_sequence;
+
+    app_twi_sequence_stop(p_app_twi);
+
+    if (p_sequence->callback)
+    {
+        p_sequence->callback(result, NULL, 0, p_sequence->p_user_data);
+    }
+}
+
+
+ret_code_t app_twi_sequence_start(app_twi_t *                p_app_twi,
+                                  app_twi_sequence_t const * p_sequence)
+{
+    ASSERT(p_app_twi != NULL);
+    ASSERT(p_sequence != NULL);
+    ASSERT(p_sequence->p_counter != NULL);
+
+    ret_code_t err_code;
+    bool       busy;
+
+    VERIFY_TRUE(p_app_twi->twi.use_easy_dma, NRF_ERROR_NOT_SUPPORTED);
+    VERIFY_TRUE((p_sequence->reg_length       != 0) &&
+                (p_sequence->frame_length     != 0) &&
+                (p_sequence->frame_count      != 0) &&
+                (p_sequence->frames_per_event != 0) &&
+                (p_sequence->frame_count >= 2 * p_sequence->frames_per_event) &&
+                ((p_sequence->frame_count % p_sequence->frames_per_event) == 0),
+                NRF_ERROR_INVALID_PARAM);
+
+    CRITICAL_REGION_ENTER();
+    busy = !app_twi_is_idle(p_app_twi) || SEQUENCE_RUNNING(p_app_twi);
+    if (!busy)
+    {
+        p_app_twi->p_sequence = p_sequence;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    p_app_twi->sequence_frame_idx = 0;
+
+    err_code = sequence_resources_alloc(p_app_twi, p_sequence);
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = sequence_xfer_setup(p_app_twi);
+        if (err_code != NRF_SUCCESS)
+        {
+            sequence_resources_free(p_app_twi, p_sequence);
+        }
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        p_app_twi->p_sequence = NULL;
+        start_pending_transaction(p_app_twi, false);
+        return err_code;
+    }
+
+    // The trigger event starts the read, and the end of each read is counted. The trigger
+    // channel is the only one in the group, which is disabled at the end of the ring.
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_assign(p_app_twi->sequence_ppi_trigger,
+        p_sequence->trigger_event,
+        nrf_drv_twi_start_task_get(&p_app_twi->twi, NRF_DRV_TWI_XFER_TXRX)));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_assign(p_app_twi->sequence_ppi_count,
+        nrf_drv_twi_stopped_event_get(&p_app_twi->twi),
+        nrf_drv_timer_task_address_get(p_sequence->p_counter, NRF_TIMER_TASK_COUNT)));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_assign(p_app_twi->sequence_ppi_stop,
+        nrf_drv_timer_compare_event_address_get(p_sequence->p_counter, NRF_TIMER_CC_CHANNEL1),
+        nrf_drv_ppi_task_addr_group_disable_get(p_app_twi->sequence_ppi_group)));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_include_in_group(p_app_twi->sequence_ppi_trigger,
+                                                             p_app_twi->sequence_ppi_group));
+
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_enable(p_app_twi->sequence_ppi_count));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_enable(p_app_twi->sequence_ppi_stop));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_group_enable(p_app_twi->sequence_ppi_group));
+
+    return NRF_SUCCESS;
+}
+
+
+void app_twi_sequence_stop(app_twi_t * p_app_twi)
+{
+    ASSERT(p_app_twi != NULL);
+
+    app_twi_sequence_t const * p_sequence = p_app_twi->p_sequence;
+
+    if (p_sequence == NULL)
+    {
+        return;
+    }
+
+    sequence_resources_free(p_app_twi, p_sequence);
+    p_app_twi->p_sequence = NULL;
+
+    // Start transactions that were scheduled while the sequence was running.
+    start_pending_transaction(p_app_twi, false);
+}
+#endif // APP_TWI_SEQUENCE_SUPPORT
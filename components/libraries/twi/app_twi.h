@@ -16,6 +16,10 @@
 #include <stdint.h>
 #include "nrf_drv_twi.h"
 #include "sdk_errors.h"
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+#include "nrf_drv_timer.h"
+#include "nrf_drv_ppi.h"
+#endif
 
 /**
  * @defgroup app_twi TWI transaction manager
@@ -124,6 +128,69 @@ typedef struct {
     ///< Number of transfers that make up the transaction.
 } app_twi_transaction_t;
 
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+/**
+ * @brief TWI sequence callback prototype.
+ *
+ * @param     result      NRF_SUCCESS when frames are ready, otherwise the error that stopped
+ *                        the sequence.
+ * @param[in] p_frames    Pointer to the first ready frame. The frames stay valid while the
+ *                        next frame_count - frames_per_event frames are read, and are then
+ *                        overwritten. NULL if result is not NRF_SUCCESS.
+ * @param     frame_count Number of ready frames.
+ * @param[in] p_user_data Pointer to user data defined in sequence descriptor.
+ */
+typedef void (* app_twi_sequence_callback_t)(ret_code_t result,
+                                             uint8_t *  p_frames,
+                                             uint16_t   frame_count,
+                                             void *     p_user_data);
+
+/**
+ * @brief TWI sequence descriptor.
+ *
+ * A sequence is a register read (a write of @ref p_reg followed by a read of
+ * @ref frame_length bytes with a repeated start) that is started by a hardware event
+ * through PPI, for example an RTC or TIMER compare event. The read data is stored by
+ * EasyDMA in list mode in consecutive frames of a ring, and the CPU is interrupted
+ * only after @ref frames_per_event frames.
+ */
+typedef struct {
+    uint8_t                     address;
+    ///< Slave address.
+
+    uint8_t                     reg_length;
+    ///< Number of register address bytes written before each read.
+
+    uint8_t                     frame_length;
+    ///< Number of bytes read on each trigger.
+
+    uint16_t                    frame_count;
+    ///< Number of frames in the ring. Must be a multiple of frames_per_event, and at least
+    ///< twice frames_per_event.
+
+    uint16_t                    frames_per_event;
+    ///< Number of frames read between two callbacks.
+
+    uint8_t *                   p_reg;
+    ///< Register address bytes. Must be placed in Data RAM.
+
+    uint8_t *                   p_frames;
+    ///< Frame ring of frame_count * frame_length bytes. Must be placed in Data RAM.
+
+    uint32_t                    trigger_event;
+    ///< Address of the event that starts a read.
+
+    nrf_drv_timer_t const *     p_counter;
+    ///< Timer instance used to count the completed reads, with its CC channels 0 to 2.
+
+    app_twi_sequence_callback_t callback;
+    ///< User-specified function to be called when frames are ready.
+
+    void *                      p_user_data;
+    ///< Pointer to user data to be passed to the callback.
+} app_twi_sequence_t;
+#endif // APP_TWI_SEQUENCE_SUPPORT
+
 /**
  * @brief TWI transaction queue.
  */
@@ -155,6 +222,26 @@ typedef struct {
 
     nrf_drv_twi_t const twi;
     ///< TWI master driver instance.
+
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+    app_twi_sequence_t const * volatile p_sequence;
+    ///< Sequence that is running, NULL if there is none.
+
+    uint16_t                   sequence_frame_idx;
+    ///< Index of the first frame to be reported for the running sequence.
+
+    nrf_ppi_channel_t          sequence_ppi_trigger;
+    ///< PPI channel connecting the trigger event to the start task.
+
+    nrf_ppi_channel_t          sequence_ppi_count;
+    ///< PPI channel connecting the STOPPED event to the frame counter.
+
+    nrf_ppi_channel_t          sequence_ppi_stop;
+    ///< PPI channel disabling the trigger channel at the end of the frame ring.
+
+    nrf_ppi_channel_group_t    sequence_ppi_group;
+    ///< PPI channel group holding the trigger channel.
+#endif
 } app_twi_t;
 
 /**
@@ -269,6 +356,51 @@ ret_code_t app_twi_perform(app_twi_t *                p_app_twi,
                            uint8_t                    number_of_transfers,
                            void (* user_function)(void));
 
+#ifdef APP_TWI_SEQUENCE_SUPPORT
+/**
+ * @brief Function for starting a TWI sequence.
+ *
+ * The transfer descriptors are set up once, and every read is started by the trigger
+ * event through PPI without CPU involvement. Completed reads are counted by the timer
+ * in counter mode, which interrupts after @ref app_twi_sequence_t::frames_per_event
+ * reads. The callback is called from the timer interrupt, and a late interrupt reports
+ * all the groups of frames read since the previous one.
+ *
+ * At the end of the frame ring, the trigger channel is disabled through a PPI channel
+ * group, so no frame is written past the ring. The timer interrupt rewinds the buffer
+ * pointer and enables the group again; trigger events in between are skipped.
+ *
+ * Scheduled transactions are kept in the queue while the sequence is running.
+ *
+ * @note Supported only by TWIM.
+ *
+ * @param[in] p_app_twi  Pointer to the TWI transaction manager instance.
+ * @param[in] p_sequence Pointer to the sequence descriptor. Must be valid until the
+ *                       sequence is stopped.
+ *
+ * @retval NRF_SUCCESS             If the sequence has been started.
+ * @retval NRF_ERROR_NOT_SUPPORTED If the TWI instance does not use EasyDMA.
+ * @retval NRF_ERROR_INVALID_PARAM If the frame layout is invalid.
+ * @retval NRF_ERROR_BUSY          If a transaction or another sequence is in progress.
+ * @retval NRF_ERROR_NO_MEM        If no PPI channels or channel groups are available.
+ * @retval -                       Other error codes returned by nrf_drv_timer_init() or
+ *                                 nrf_drv_twi_xfer().
+ */
+ret_code_t app_twi_sequence_start(app_twi_t *                p_app_twi,
+                                  app_twi_sequence_t const * p_sequence);
+
+/**
+ * @brief Function for stopping the TWI sequence.
+ *
+ * No new reads are triggered after this call. Should be called from the sequence
+ * callback or when the trigger event source is stopped, so that no read is in progress.
+ * Queued transactions are started afterwards.
+ *
+ * @param[in] p_app_twi Pointer to the TWI transaction manager instance.
+ */
+void app_twi_sequence_stop(app_twi_t * p_app_twi);
+#endif // APP_TWI_SEQUENCE_SUPPORT
+
 /**
  * @brief Function for getting the current state of a TWI transaction manager
  *        instance.
@@ -15,13 +15,74 @@
 #include "nrf_assert.h"
 #include "sdk_common.h"
 
+#if defined(NRF52) && (UART_RX_STREAM_SUPPORT == 1)
+#define APP_UART_RX_STREAM
+#ifndef APP_UART_RX_STREAM_BUFFER_SIZE
+#define APP_UART_RX_STREAM_BUFFER_SIZE 128          /**< Size of the buffer used for continuous reception in Easy DMA mode. */
+#endif
+#ifndef APP_UART_RX_IDLE_TIMEOUT_US
+#define APP_UART_RX_IDLE_TIMEOUT_US    500          /**< Idle time after which partially received data is reported. */
+#endif
+#ifndef APP_UART_RX_CHUNK_EVENTS
+#define APP_UART_RX_CHUNK_EVENTS       0            /**< Report each received chunk in one APP_UART_DATA_CHUNK event instead of one APP_UART_DATA event per byte. */
+#endif
+#endif
+
 static uint8_t tx_buffer[1];
 static uint8_t rx_buffer[1];
 static volatile bool rx_done;
 static app_uart_event_handler_t   m_event_handler;            /**< Event handler function. */
+#ifdef APP_UART_RX_STREAM
+static uint8_t m_rx_stream_buffer[APP_UART_RX_STREAM_BUFFER_SIZE];    /**< Buffer for continuous reception, must be placed in Data RAM. */
+static bool    m_rx_stream;                                         /**< Continuous reception is used instead of single byte transfers. */
+
+/**@brief Function for reporting a chunk of continuously received data.
+ *
+ * @details The chunk is passed in one APP_UART_DATA_CHUNK event, or byte by byte in APP_UART_DATA
+ *          events for handlers written for single byte reception. It is released to the driver
+ *          once the handler returns, so the driver does not reuse its buffer before.
+ *
+ * @param[in] p_data  Received data.
+ * @param[in] length  Number of received bytes.
+ */
+static void rx_chunk_report(uint8_t const * p_data, uint32_t length)
+{
+    app_uart_evt_t app_uart_event;
+
+#if APP_UART_RX_CHUNK_EVENTS
+    app_uart_event.evt_type          = APP_UART_DATA_CHUNK;
+    app_uart_event.data.chunk.p_data = p_data;
+    app_uart_event.data.chunk.length = length;
+    m_event_handler(&app_uart_event);
+#else
+    app_uart_event.evt_type = APP_UART_DATA;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        app_uart_event.data.value = p_data[i];
+        m_event_handler(&app_uart_event);
+    }
+#endif
+    nrf_drv_uart_rx_stream_release();
+}
+#endif
 
 void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
 {
+#ifdef APP_UART_RX_STREAM
+    if (m_rx_stream && (p_event->type == NRF_DRV_UART_EVT_RX_DONE))
+    {
+        rx_chunk_report(p_event->data.rxtx.p_data, p_event->data.rxtx.bytes);
+    }
+    else if (m_rx_stream && (p_event->type == NRF_DRV_UART_EVT_ERROR))
+    {
+        // Continuous reception is not interrupted by errors.
+        app_uart_evt_t app_uart_event;
+        app_uart_event.evt_type                 = APP_UART_COMMUNICATION_ERROR;
+        app_uart_event.data.error_communication = p_event->data.error.error_mask;
+        m_event_handler(&app_uart_event);
+    }
+    else
+#endif
     if (p_event->type == NRF_DRV_UART_EVT_RX_DONE)
     {
         app_uart_evt_t app_uart_event;
@@ -77,6 +138,15 @@ uint32_t app_uart_init(const app_uart_comm_params_t * p_comm_params,
     uint32_t err_code = nrf_drv_uart_init(&config, uart_event_handler);
     VERIFY_SUCCESS(err_code);
 
+#ifdef APP_UART_RX_STREAM
+    m_rx_stream = config.use_easy_dma;
+    if (m_rx_stream)
+    {
+        return nrf_drv_uart_rx_stream_start(m_rx_stream_buffer,
+                                            sizeof(m_rx_stream_buffer),
+                                            APP_UART_RX_IDLE_TIMEOUT_US);
+    }
+#endif
 #ifdef NRF52
     if (!config.use_easy_dma)
 #endif
@@ -91,6 +161,13 @@ uint32_t app_uart_get(uint8_t * p_byte)
 {
     ASSERT(p_byte);
     uint32_t err_code = NRF_SUCCESS;
+#ifdef APP_UART_RX_STREAM
+    // There is no RX buffer to read from, received bytes are only passed in APP_UART_DATA events.
+    if (m_rx_stream)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+#endif
     if (rx_done)
     {
         *p_byte = rx_buffer[0];
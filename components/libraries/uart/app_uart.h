@@ -72,6 +72,7 @@ typedef enum
     APP_UART_COMMUNICATION_ERROR, /**< An communication error has occured during reception. The error is stored in app_uart_evt_t.data.error_communication field. */
     APP_UART_TX_EMPTY,            /**< An event indicating that UART has completed transmission of all available data in the TX FIFO. */
     APP_UART_DATA,                /**< An event indicating that UART data has been received, and data is present in data field. This event is only used when no FIFO is configured. */
+    APP_UART_DATA_CHUNK,          /**< An event indicating that a chunk of UART data has been received, the data is described by the chunk field. This event is only used when no FIFO is configured, the reception is continuous and APP_UART_RX_CHUNK_EVENTS is 1. The data is only valid until the event handler returns. */
 } app_uart_evt_type_t;
 
 /**@brief Struct containing events from the UART module.
@@ -87,6 +88,11 @@ typedef struct
         uint32_t error_communication; /**< Field used if evt_type is: APP_UART_COMMUNICATION_ERROR. This field contains the value in the ERRORSRC register for the UART peripheral. The UART_ERRORSRC_x defines from nrf5x_bitfields.h can be used to parse the error code. See also the \nRFXX Series Reference Manual for specification. */
         uint32_t error_code;          /**< Field used if evt_type is: NRF_ERROR_x. Additional status/error code if the error event type is APP_UART_FIFO_ERROR. This error code refer to errors defined in nrf_error.h. */
         uint8_t  value;               /**< Field used if evt_type is: NRF_ERROR_x. Additional status/error code if the error event type is APP_UART_FIFO_ERROR. This error code refer to errors defined in nrf_error.h. */
+        struct
+        {
+            uint8_t const * p_data;   /**< Received bytes. */
+            uint32_t        length;   /**< Number of received bytes. */
+        } chunk;                      /**< Field used if evt_type is: APP_UART_DATA_CHUNK. */
     } data;
 } app_uart_evt_t;
 
@@ -189,6 +195,9 @@ uint32_t app_uart_init(const app_uart_comm_params_t * p_comm_params,
  *
  * @retval NRF_SUCCESS          If a byte has been received and pushed to the pointer provided.
  * @retval NRF_ERROR_NOT_FOUND  If no byte is available in the RX buffer of the app_uart module.
+ * @retval NRF_ERROR_INVALID_STATE If app_uart.c (without FIFO) receives continuously in Easy DMA
+ *                                 mode. Bytes are then only passed in @ref APP_UART_DATA or
+ *                                 @ref APP_UART_DATA_CHUNK events.
  */
 uint32_t app_uart_get(uint8_t * p_byte);
 
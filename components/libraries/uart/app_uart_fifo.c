@@ -24,18 +24,96 @@ static __INLINE uint32_t fifo_length(app_fifo_t * const fifo)
 
 #define FIFO_LENGTH(F) fifo_length(&F)              /**< Macro to calculate length of a FIFO. */
 
+#ifndef APP_UART_TX_CHUNK_SIZE
+#define APP_UART_TX_CHUNK_SIZE        32            /**< Maximum number of bytes moved from the TX FIFO to the driver in one transfer. */
+#endif
+
+#if defined(NRF52) && (UART_RX_STREAM_SUPPORT == 1)
+#define APP_UART_RX_STREAM
+#ifndef APP_UART_RX_STREAM_BUFFER_SIZE
+#define APP_UART_RX_STREAM_BUFFER_SIZE 128          /**< Size of the buffer used for continuous reception in Easy DMA mode. */
+#endif
+#ifndef APP_UART_RX_IDLE_TIMEOUT_US
+#define APP_UART_RX_IDLE_TIMEOUT_US    500          /**< Idle time after which partially received data is moved to the RX FIFO. */
+#endif
+#endif
 
 static app_uart_event_handler_t   m_event_handler;            /**< Event handler function. */
-static uint8_t tx_buffer[1];
+static uint8_t tx_buffer[APP_UART_TX_CHUNK_SIZE];
 static uint8_t rx_buffer[1];
+#ifdef APP_UART_RX_STREAM
+static uint8_t m_rx_stream_buffer[APP_UART_RX_STREAM_BUFFER_SIZE];    /**< Buffer for continuous reception, must be placed in Data RAM. */
+static bool    m_rx_stream;                                         /**< Continuous reception is used instead of single byte transfers. */
+#endif
 
 static app_fifo_t                  m_rx_fifo;                               /**< RX FIFO buffer for storing data received on the UART until the application fetches them using app_uart_get(). */
 static app_fifo_t                  m_tx_fifo;                               /**< TX FIFO buffer for storing data to be transmitted on the UART when TXD is ready. Data is put to the buffer on using app_uart_put(). */
 
+/**@brief Function for starting transmission of the next chunk of data from the TX FIFO.
+ *
+ * @retval NRF_SUCCESS         If a transfer was started.
+ * @retval NRF_ERROR_NOT_FOUND If the TX FIFO is empty.
+ */
+static uint32_t tx_chunk_send(void)
+{
+    uint32_t length = sizeof(tx_buffer);
+    uint32_t err_code = app_fifo_read(&m_tx_fifo, tx_buffer, &length);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = nrf_drv_uart_tx(tx_buffer, length);
+    }
+    return err_code;
+}
+
+#ifdef APP_UART_RX_STREAM
+/**@brief Function for moving a chunk of received data to the RX FIFO.
+ *
+ * @param[in] p_data  Received data.
+ * @param[in] length  Number of received bytes.
+ */
+static void rx_chunk_put(uint8_t const * p_data, uint32_t length)
+{
+    app_uart_evt_t app_uart_event;
+    bool           was_empty = (FIFO_LENGTH(m_rx_fifo) == 0);
+    uint32_t       written   = length;
+    uint32_t       err_code  = app_fifo_write(&m_rx_fifo, p_data, &written);
+
+    // Notify that new data is available if the FIFO was empty.
+    if ((err_code == NRF_SUCCESS) && was_empty)
+    {
+        app_uart_event.evt_type = APP_UART_DATA_READY;
+        m_event_handler(&app_uart_event);
+    }
+    // Reception is not paused when the FIFO is full, the bytes that do not fit are lost.
+    if ((err_code != NRF_SUCCESS) || (written < length))
+    {
+        app_uart_event.evt_type          = APP_UART_FIFO_ERROR;
+        app_uart_event.data.error_code   = NRF_ERROR_NO_MEM;
+        m_event_handler(&app_uart_event);
+    }
+}
+#endif
+
 static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
 {
     app_uart_evt_t app_uart_event;
 
+#ifdef APP_UART_RX_STREAM
+    if (m_rx_stream && (p_event->type == NRF_DRV_UART_EVT_RX_DONE))
+    {
+        rx_chunk_put(p_event->data.rxtx.p_data, p_event->data.rxtx.bytes);
+        nrf_drv_uart_rx_stream_release();
+    }
+    else if (m_rx_stream && (p_event->type == NRF_DRV_UART_EVT_ERROR))
+    {
+        // Continuous reception is not interrupted by errors.
+        app_uart_event.evt_type                 = APP_UART_COMMUNICATION_ERROR;
+        app_uart_event.data.error_communication = p_event->data.error.error_mask;
+        m_event_handler(&app_uart_event);
+    }
+    else
+#endif
     if (p_event->type == NRF_DRV_UART_EVT_RX_DONE)
     {
         // Write received byte to FIFO
@@ -70,11 +148,8 @@ static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
     }
     else if (p_event->type == NRF_DRV_UART_EVT_TX_DONE)
     {
-        // Get next byte from FIFO.
-        if (app_fifo_get(&m_tx_fifo, tx_buffer) == NRF_SUCCESS)
-        {
-            (void)nrf_drv_uart_tx(tx_buffer, 1);
-        }
+        // Get next chunk from FIFO.
+        (void)tx_chunk_send();
         if (FIFO_LENGTH(m_tx_fifo) == 0)
         {
             // Last byte from FIFO transmitted, notify the application.
@@ -120,6 +195,15 @@ uint32_t app_uart_init(const app_uart_comm_params_t * p_comm_params,
     err_code = nrf_drv_uart_init(&config, uart_event_handler);
     VERIFY_SUCCESS(err_code);
 
+#ifdef APP_UART_RX_STREAM
+    m_rx_stream = config.use_easy_dma;
+    if (m_rx_stream)
+    {
+        return nrf_drv_uart_rx_stream_start(m_rx_stream_buffer,
+                                            sizeof(m_rx_stream_buffer),
+                                            APP_UART_RX_IDLE_TIMEOUT_US);
+    }
+#endif
 #ifdef NRF52
     if (!config.use_easy_dma)
 #endif
@@ -146,7 +230,11 @@ uint32_t app_uart_get(uint8_t * p_byte)
 {
     ASSERT(p_byte);
     // If FIFO was full new request to receive one byte was not scheduled. Must be done here.
-    if (FIFO_LENGTH(m_rx_fifo) == m_rx_fifo.buf_size_mask)
+    if (
+#ifdef APP_UART_RX_STREAM
+        !m_rx_stream &&
+#endif
+        (FIFO_LENGTH(m_rx_fifo) == m_rx_fifo.buf_size_mask))
     {
         uint32_t err_code = nrf_drv_uart_rx(rx_buffer,1);
         if (err_code != NRF_SUCCESS)
@@ -174,9 +262,10 @@ uint32_t app_uart_put(uint8_t byte)
             // just added a byte to FIFO, but if some bigger delay occurred
             // (some heavy interrupt handler routine has been executed) since
             // that time, FIFO might be empty already.
-            if (app_fifo_get(&m_tx_fifo, tx_buffer) == NRF_SUCCESS)
+            err_code = tx_chunk_send();
+            if (err_code == NRF_ERROR_NOT_FOUND)
             {
-                err_code = nrf_drv_uart_tx(tx_buffer, 1);
+                err_code = NRF_SUCCESS;
             }
         }
     }
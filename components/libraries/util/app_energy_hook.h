@@ -0,0 +1,77 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_energy_hook Energy accounting hooks
+ * @{
+ * @ingroup app_energy
+ *
+ * @brief Hooks used by drivers and libraries to report when a subsystem is active.
+ *
+ * @details This header has no dependencies, so that any module can include it. The hooks expand
+ *          to nothing unless APP_ENERGY_ENABLED is defined as 1, in which case
+ *          components/libraries/energy must be part of the build. See @ref app_energy.
+ */
+
+#ifndef APP_ENERGY_HOOK_H__
+#define APP_ENERGY_HOOK_H__
+
+#ifndef APP_ENERGY_ENABLED
+#define APP_ENERGY_ENABLED          0
+#endif
+
+/**@brief Subsystems with their own active time. */
+typedef enum
+{
+    APP_ENERGY_CPU,                 /**< CPU awake, between wake-up and the next sd_app_evt_wait(). */
+    APP_ENERGY_RADIO,               /**< Radio events, as reported by Radio Notification. */
+    APP_ENERGY_FLASH,               /**< Flash write or erase operations of fstorage and pstorage. */
+    APP_ENERGY_TWI,                 /**< Non-blocking TWI transfers. */
+    APP_ENERGY_SPI,                 /**< Non-blocking SPI transfers. */
+    APP_ENERGY_UART,                /**< Non-blocking UART transmissions and continuous reception. */
+    APP_ENERGY_SUBSYS_COUNT         /**< Number of subsystems. */
+} app_energy_subsys_t;
+
+#if APP_ENERGY_ENABLED
+
+/**@brief Function for marking the start of an active period of a subsystem.
+ *
+ * @details Calls can be nested, for example for two instances of the same peripheral. The
+ *          subsystem is active until every call has been matched by @ref app_energy_end.
+ *          Can be called from any interrupt priority.
+ *
+ * @param[in]   subsys  Subsystem.
+ */
+void app_energy_begin(app_energy_subsys_t subsys);
+
+/**@brief Function for marking the end of an active period of a subsystem.
+ *
+ * @details A call without a matching @ref app_energy_begin is ignored.
+ *
+ * @param[in]   subsys  Subsystem.
+ */
+void app_energy_end(app_energy_subsys_t subsys);
+
+#define APP_ENERGY_BEGIN(SUBSYS)    app_energy_begin(SUBSYS)
+#define APP_ENERGY_END(SUBSYS)      app_energy_end(SUBSYS)
+
+#else // APP_ENERGY_ENABLED
+
+#define APP_ENERGY_BEGIN(SUBSYS)
+#define APP_ENERGY_END(SUBSYS)
+
+#endif // APP_ENERGY_ENABLED
+
+#endif // APP_ENERGY_HOOK_H__
+
+/** @} */
@@ -390,6 +390,220 @@ uint32_t log_raw_uart_read_input(char * c)
 
 #endif // NRF_LOG_USES_RAW_UART == 1
 
+#if defined(NRF_LOG_USES_DEFERRED) && NRF_LOG_USES_DEFERRED == 1
+
+#include <SEGGER_RTT_Conf.h>
+#include <SEGGER_RTT.h>
+#include "app_util_platform.h"
+
+#define DEFERRED_BUFFER_MASK    (NRF_LOG_DEFERRED_BUFFER_SIZE - 1)
+#define DEFERRED_HEADER_WORDS   2       /**< Format string address and header word. */
+
+STATIC_ASSERT(IS_POWER_OF_TWO(NRF_LOG_DEFERRED_BUFFER_SIZE));
+STATIC_ASSERT(NRF_LOG_DEFERRED_MAX_ARGS <= (NRF_LOG_DEFERRED_HDR_NUM_ARGS_Msk >> NRF_LOG_DEFERRED_HDR_NUM_ARGS_Pos));
+
+static char buf_normal_up[BUFFER_SIZE_UP];
+
+// Word 0 of an entry is written last and cleared when the entry is consumed, so a zero word 0
+// at the read index means that the producer of that entry has not finished yet.
+static volatile uint32_t m_deferred_buf[NRF_LOG_DEFERRED_BUFFER_SIZE];
+static volatile uint32_t m_deferred_wr_idx;     /**< Free running index of the next word to reserve. */
+static volatile uint32_t m_deferred_rd_idx;     /**< Free running index of the next word to process. */
+static volatile uint32_t m_deferred_dropped;    /**< Number of entries dropped because the ring was full. */
+
+uint32_t log_deferred_init(void)
+{
+    static bool initialized = false;
+    if (initialized)
+    {
+        return NRF_SUCCESS;
+    }
+
+    // In binary mode an entry is either written as a whole or skipped, so the host decoder never
+    // sees a partial entry.
+    if (SEGGER_RTT_ConfigUpBuffer(LOG_TERMINAL_NORMAL,
+                                  "Normal",
+                                  buf_normal_up,
+                                  BUFFER_SIZE_UP,
+                                  NRF_LOG_DEFERRED_BINARY ? SEGGER_RTT_MODE_NO_BLOCK_SKIP :
+                                                            SEGGER_RTT_MODE_NO_BLOCK_TRIM
+                                 )
+        != 0)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    initialized = true;
+
+    return NRF_SUCCESS;
+}
+
+/**@brief Function for reserving space for an entry in the ring.
+ *
+ * @details Lock free on Cortex-M3 and M4. Cortex-M0 has no exclusive access instructions, so a
+ *          critical region is used to update the write index.
+ *
+ * @param[in]   num_words   Size of the entry in words.
+ * @param[out]  p_index     Free running index of the first word of the entry.
+ *
+ * @retval      true    Space reserved.
+ * @retval      false   Not enough free space, the entry was counted as dropped.
+ */
+static bool deferred_reserve(uint32_t num_words, uint32_t * p_index)
+{
+    uint32_t wr_idx;
+    bool     reserved;
+
+#if defined(__CORTEX_M) && (__CORTEX_M >= 0x03)
+    // The outcome is decided inside the loop. Checking the free space again after the loop
+    // could succeed without a store if the reader advanced in between.
+    do
+    {
+        wr_idx = __LDREXW((uint32_t *)&m_deferred_wr_idx);
+        if ((wr_idx + num_words - m_deferred_rd_idx) > NRF_LOG_DEFERRED_BUFFER_SIZE)
+        {
+            __CLREX();
+            reserved = false;
+            break;
+        }
+        reserved = (__STREXW(wr_idx + num_words, (uint32_t *)&m_deferred_wr_idx) == 0);
+    } while (!reserved);
+
+    if (!reserved)
+    {
+        uint32_t dropped;
+        do
+        {
+            dropped = __LDREXW((uint32_t *)&m_deferred_dropped);
+        } while (__STREXW(dropped + 1, (uint32_t *)&m_deferred_dropped) != 0);
+    }
+#else
+    CRITICAL_REGION_ENTER();
+    wr_idx   = m_deferred_wr_idx;
+    reserved = ((wr_idx + num_words - m_deferred_rd_idx) <= NRF_LOG_DEFERRED_BUFFER_SIZE);
+    if (reserved)
+    {
+        m_deferred_wr_idx = wr_idx + num_words;
+    }
+    else
+    {
+        m_deferred_dropped++;
+    }
+    CRITICAL_REGION_EXIT();
+#endif
+
+    *p_index = wr_idx;
+    return reserved;
+}
+
+/**@brief Function for building the header word of an entry. */
+static __INLINE uint32_t deferred_header(uint32_t level, uint32_t num_args)
+{
+    return (NRF_LOG_DEFERRED_TIMESTAMP_GET() & NRF_LOG_DEFERRED_HDR_TIMESTAMP_Msk)
+         | ((num_args << NRF_LOG_DEFERRED_HDR_NUM_ARGS_Pos) & NRF_LOG_DEFERRED_HDR_NUM_ARGS_Msk)
+         | ((level << NRF_LOG_DEFERRED_HDR_LEVEL_Pos) & NRF_LOG_DEFERRED_HDR_LEVEL_Msk);
+}
+
+void log_deferred_write(uint32_t level, uint32_t num_args, const char * p_format, ...)
+{
+    uint32_t index;
+    va_list  p_args;
+
+    if (num_args > NRF_LOG_DEFERRED_MAX_ARGS)
+    {
+        num_args = NRF_LOG_DEFERRED_MAX_ARGS;
+    }
+
+    if (!deferred_reserve(DEFERRED_HEADER_WORDS + num_args, &index))
+    {
+        return;
+    }
+
+    //lint -save -e516 -e530 -e526 -e628 -e26 -e10 -e64
+    va_start(p_args, p_format);
+    for (uint32_t i = 0; i < num_args; i++)
+    {
+        m_deferred_buf[(index + DEFERRED_HEADER_WORDS + i) & DEFERRED_BUFFER_MASK] =
+            va_arg(p_args, uint32_t);
+    }
+    va_end(p_args);
+    //lint -restore
+
+    m_deferred_buf[(index + 1) & DEFERRED_BUFFER_MASK] = deferred_header(level, num_args);
+    m_deferred_buf[index & DEFERRED_BUFFER_MASK]       = (uint32_t)p_format;
+}
+
+void log_deferred_write_string_many(uint32_t level, int num_args, ...)
+{
+    uint32_t index;
+    va_list  p_args;
+
+    //lint -save -e516 -e530 -e526 -e628 -e26 -e10 -e64
+    va_start(p_args, num_args);
+    for (int i = 0; i < num_args; i++)
+    {
+        const char * p_msg = va_arg(p_args, const char *);
+
+        if (deferred_reserve(DEFERRED_HEADER_WORDS, &index))
+        {
+            m_deferred_buf[(index + 1) & DEFERRED_BUFFER_MASK] =
+                deferred_header(level, 0) | NRF_LOG_DEFERRED_HDR_STRING;
+            m_deferred_buf[index & DEFERRED_BUFFER_MASK] = (uint32_t)p_msg;
+        }
+    }
+    va_end(p_args);
+    //lint -restore
+}
+
+bool log_deferred_process(void)
+{
+    uint32_t entry[DEFERRED_HEADER_WORDS + NRF_LOG_DEFERRED_MAX_ARGS] = {0};
+    uint32_t rd_idx = m_deferred_rd_idx;
+    uint32_t num_words;
+
+    if ((rd_idx == m_deferred_wr_idx) || (m_deferred_buf[rd_idx & DEFERRED_BUFFER_MASK] == 0))
+    {
+        return false;
+    }
+
+    entry[1]  = m_deferred_buf[(rd_idx + 1) & DEFERRED_BUFFER_MASK];
+    num_words = DEFERRED_HEADER_WORDS + ((entry[1] & NRF_LOG_DEFERRED_HDR_NUM_ARGS_Msk) >>
+                                         NRF_LOG_DEFERRED_HDR_NUM_ARGS_Pos);
+
+    for (uint32_t i = 0; i < num_words; i++)
+    {
+        uint32_t index = (rd_idx + i) & DEFERRED_BUFFER_MASK;
+
+        entry[i]              = m_deferred_buf[index];
+        m_deferred_buf[index] = 0;
+    }
+    m_deferred_rd_idx = rd_idx + num_words;
+
+#if NRF_LOG_DEFERRED_BINARY
+    (void)SEGGER_RTT_Write(LOG_TERMINAL_NORMAL, entry, num_words * sizeof(uint32_t));
+#else
+    if (entry[1] & NRF_LOG_DEFERRED_HDR_STRING)
+    {
+        (void)SEGGER_RTT_WriteString(LOG_TERMINAL_NORMAL, (const char *)entry[0]);
+    }
+    else
+    {
+        // Unused argument words are zero, passing them to printf is harmless.
+        (void)SEGGER_RTT_printf(LOG_TERMINAL_NORMAL, (const char *)entry[0],
+                                entry[2], entry[3], entry[4], entry[5], entry[6], entry[7]);
+    }
+#endif
+
+    return (m_deferred_rd_idx != m_deferred_wr_idx);
+}
+
+uint32_t log_deferred_dropped_get(void)
+{
+    return m_deferred_dropped;
+}
+
+#endif // NRF_LOG_USES_DEFERRED == 1
+
 
 const char* log_hex_char(const char c)
 {
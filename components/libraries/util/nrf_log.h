@@ -5,6 +5,7 @@
 
 #include <stdint.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <app_util.h>
 
 #ifndef NRF_LOG_USES_RTT
@@ -19,6 +20,10 @@
 #define NRF_LOG_USES_RAW_UART 0
 #endif
 
+#ifndef NRF_LOG_USES_DEFERRED
+#define NRF_LOG_USES_DEFERRED 0
+#endif
+
 #ifndef NRF_LOG_USES_COLORS
     #define NRF_LOG_USES_COLORS 1
 #endif
@@ -180,6 +185,8 @@ uint32_t log_rtt_read_input(char* p_char);
 #define NRF_LOG_HAS_INPUT()             log_rtt_has_input()                                                                     /*!< Check if the input buffer has unconsumed characters. */
 #define NRF_LOG_READ_INPUT(p_char)      log_rtt_read_input(p_char)                                                              /*!< Consume a character from the input buffer. */
 
+#define NRF_LOG_PROCESS()               false                                                                                   /*!< Nothing is deferred, output is written immediately. */
+
 #if !defined(DEBUG) && !defined(DOXYGEN)
 
 #undef NRF_LOG_DEBUG
@@ -355,6 +362,8 @@ uint32_t log_uart_read_input(char* p_char);
 #define NRF_LOG_HAS_INPUT()             log_uart_has_input()                                                    /*!< Check if the input buffer has unconsumed characters. */
 #define NRF_LOG_READ_INPUT(p_char)      log_uart_read_input(p_char)                                             /*!< Consume a character from the input buffer. */
 
+#define NRF_LOG_PROCESS()               false                                                                   /*!< Nothing is deferred, output is written immediately. */
+
 #if !defined(DEBUG) && !defined(DOXYGEN)
 
 #undef NRF_LOG_DEBUG
@@ -532,6 +541,8 @@ uint32_t log_raw_uart_read_input(char* p_char);
 #define NRF_LOG_HAS_INPUT()             log_raw_uart_has_input()                                                    /*!< Check if the input buffer has unconsumed characters. */
 #define NRF_LOG_READ_INPUT(p_char)      log_raw_uart_read_input(p_char)                                             /*!< Consume a character from the input buffer. */
 
+#define NRF_LOG_PROCESS()               false                                                                       /*!< Nothing is deferred, output is written immediately. */
+
 #if !defined(DEBUG) && !defined(DOXYGEN)
 
 #undef NRF_LOG_DEBUG
@@ -551,6 +562,164 @@ uint32_t log_raw_uart_read_input(char* p_char);
 
 #endif // !defined(DEBUG) && !defined(DOXYGEN)
 
+#elif defined(NRF_LOG_USES_DEFERRED) && NRF_LOG_USES_DEFERRED == 1
+
+#define LOG_TERMINAL_NORMAL         (0)
+#define LOG_TERMINAL_INPUT          (0)
+
+#define NRF_LOG_LEVEL_ERROR         (1)     /**< Deferred log level for errors. */
+#define NRF_LOG_LEVEL_WARNING       (2)     /**< Deferred log level for warnings. */
+#define NRF_LOG_LEVEL_INFO          (3)     /**< Deferred log level for regular messages. */
+#define NRF_LOG_LEVEL_DEBUG         (4)     /**< Deferred log level for debug messages. */
+
+#ifndef NRF_LOG_DEFERRED_LEVEL
+#ifdef DEBUG
+#define NRF_LOG_DEFERRED_LEVEL      NRF_LOG_LEVEL_DEBUG
+#else
+#define NRF_LOG_DEFERRED_LEVEL      NRF_LOG_LEVEL_INFO
+#endif
+#endif
+
+#ifndef NRF_LOG_DEFERRED_BUFFER_SIZE
+#define NRF_LOG_DEFERRED_BUFFER_SIZE 256    /**< Size of the entry ring, in 32-bit words. Must be a power of two. */
+#endif
+
+#ifndef NRF_LOG_DEFERRED_BINARY
+#define NRF_LOG_DEFERRED_BINARY     0       /**< 1: Entries are sent unformatted over RTT and formatted by a host decoder. */
+#endif
+
+#ifndef NRF_LOG_DEFERRED_TIMESTAMP_GET
+#define NRF_LOG_DEFERRED_TIMESTAMP_GET() (NRF_RTC1->COUNTER)  /**< 24-bit timestamp stored with each entry. */
+#endif
+
+#define NRF_LOG_DEFERRED_MAX_ARGS   6       /**< Maximum number of arguments stored per entry. */
+
+/**@brief Deferred entry header word layout.
+ *
+ * @details Each entry in the ring, and in the binary RTT stream, is a sequence of little endian
+ *          32-bit words:
+ *          - word 0: address of the format string, used as its ID by the host decoder.
+ *          - word 1: timestamp (bits 0-23), number of arguments (bits 24-27),
+ *                    level (bits 28-30) and @ref NRF_LOG_DEFERRED_HDR_STRING (bit 31).
+ *          - word 2 and up: arguments, one word each.
+ *
+ *          tools/nrf_log_decode formats a capture of this stream on a Linux host, using
+ *          @ref nrf_log_decoder and the firmware ELF file.
+ */
+#define NRF_LOG_DEFERRED_HDR_TIMESTAMP_Msk  0x00FFFFFFUL
+#define NRF_LOG_DEFERRED_HDR_NUM_ARGS_Pos   24
+#define NRF_LOG_DEFERRED_HDR_NUM_ARGS_Msk   (0x0FUL << NRF_LOG_DEFERRED_HDR_NUM_ARGS_Pos)
+#define NRF_LOG_DEFERRED_HDR_LEVEL_Pos      28
+#define NRF_LOG_DEFERRED_HDR_LEVEL_Msk      (0x07UL << NRF_LOG_DEFERRED_HDR_LEVEL_Pos)
+#define NRF_LOG_DEFERRED_HDR_STRING         (1UL << 31) /**< Word 0 points to a plain string, not a format. */
+
+/**@brief Function for initializing the deferred logger.
+ *
+ * This function is available only when NRF_LOG_USES_DEFERRED is defined as 1.
+ *
+ * @note Do not call this function directly. Use the macro @ref NRF_LOG_INIT instead.
+ *
+ * @retval     NRF_SUCCESS     If initialization was successful.
+ * @retval     NRF_ERROR       Otherwise.
+ */
+uint32_t log_deferred_init(void);
+
+/**@brief Function for recording a printf style entry.
+ *
+ * @details Only the format string address, the arguments and a timestamp are stored; no
+ *          formatting is done in the calling context. The function can be called from any
+ *          interrupt priority. If the ring is full the entry is dropped.
+ *
+ *          Every argument is stored as one 32-bit word. 64-bit and floating point arguments are
+ *          not supported. Strings passed as %s arguments must still be valid when the entry is
+ *          processed, and can only be resolved by the host decoder if they are in flash.
+ *
+ * This function is available only when NRF_LOG_USES_DEFERRED is defined as 1.
+ *
+ * @note Do not call this function directly. Use one of the NRF_LOG_PRINTF macros instead.
+ *
+ * @param   level       Log level of the entry.
+ * @param   num_args    Number of arguments following the format string.
+ * @param   p_format    Printf format string.
+ */
+void log_deferred_write(uint32_t level, uint32_t num_args, const char * p_format, ...);
+
+/**@brief Function for recording null-terminated strings, one entry per string.
+ *
+ * This function is available only when NRF_LOG_USES_DEFERRED is defined as 1.
+ *
+ * @note Do not call this function directly. Use one of the NRF_LOG macros instead.
+ *
+ * @param   level       Log level of the entries.
+ * @param   num_args    Number of strings.
+ */
+void log_deferred_write_string_many(uint32_t level, int num_args, ...);
+
+/**@brief Function for outputting one pending entry.
+ *
+ * @details Call from the main loop when there is nothing else to do. The entry is either
+ *          formatted and written to RTT, or forwarded as is when NRF_LOG_DEFERRED_BINARY is 1.
+ *
+ * This function is available only when NRF_LOG_USES_DEFERRED is defined as 1.
+ *
+ * @note Do not call this function directly. Use @ref NRF_LOG_PROCESS instead.
+ *
+ * @retval      true    More entries are pending.
+ * @retval      false   No more entries are pending.
+ */
+bool log_deferred_process(void);
+
+/**@brief Function for getting the number of entries dropped because the ring was full.
+ *
+ * This function is available only when NRF_LOG_USES_DEFERRED is defined as 1.
+ *
+ * @return      Number of dropped entries since initialization.
+ */
+uint32_t log_deferred_dropped_get(void);
+
+/**@brief Macro for recording an entry if its level is enabled at compile time. */
+#define NRF_LOG_DEFERRED_WRITE(level, ...)                                                          \
+    do                                                                                              \
+    {                                                                                               \
+        if ((level) <= NRF_LOG_DEFERRED_LEVEL)                                                      \
+        {                                                                                           \
+            log_deferred_write((level), NUM_VA_ARGS(__VA_ARGS__) - 1, __VA_ARGS__);                 \
+        }                                                                                           \
+    } while (0)
+
+/**@brief Macro for recording strings if the level is enabled at compile time. */
+#define NRF_LOG_DEFERRED_STRING(level, ...)                                                         \
+    do                                                                                              \
+    {                                                                                               \
+        if ((level) <= NRF_LOG_DEFERRED_LEVEL)                                                      \
+        {                                                                                           \
+            log_deferred_write_string_many((level), NUM_VA_ARGS(__VA_ARGS__), __VA_ARGS__);         \
+        }                                                                                           \
+    } while (0)
+
+#define NRF_LOG_INIT()                  log_deferred_init()                                                 /*!< Initialize the module. */
+
+#define NRF_LOG_PRINTF(...)             NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_INFO, __VA_ARGS__)             /*!< Record a log message using printf. */
+#define NRF_LOG_PRINTF_DEBUG(...)       NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_DEBUG, __VA_ARGS__)            /*!< If the debug level is enabled, record a log message using printf. */
+#define NRF_LOG_PRINTF_ERROR(...)       NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_ERROR, __VA_ARGS__)            /*!< Record a log message using printf with the error level. */
+
+#define NRF_LOG(...)                    NRF_LOG_DEFERRED_STRING(NRF_LOG_LEVEL_INFO, __VA_ARGS__)            /*!< Record a log message. The input string must be null-terminated. */
+#define NRF_LOG_DEBUG(...)              NRF_LOG_DEFERRED_STRING(NRF_LOG_LEVEL_DEBUG, __VA_ARGS__)           /*!< If the debug level is enabled, record a log message. The input string must be null-terminated. */
+#define NRF_LOG_ERROR(...)              NRF_LOG_DEFERRED_STRING(NRF_LOG_LEVEL_ERROR, __VA_ARGS__)           /*!< Record a log message with the error level. The input string must be null-terminated. */
+
+#define NRF_LOG_HEX(val)                NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_INFO, "0x%08X", (val))         /*!< Log an integer as HEX value (example output: 0x89ABCDEF). */
+#define NRF_LOG_HEX_DEBUG(val)          NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_DEBUG, "0x%08X", (val))        /*!< If the debug level is enabled, log an integer as HEX value (example output: 0x89ABCDEF). */
+#define NRF_LOG_HEX_ERROR(val)          NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_ERROR, "0x%08X", (val))        /*!< Log an integer as HEX value with the error level (example output: 0x89ABCDEF). */
+
+#define NRF_LOG_HEX_CHAR(val)           NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_INFO, "%02X", (val))           /*!< Log a character as HEX value (example output: AA). */
+#define NRF_LOG_HEX_CHAR_DEBUG(val)     NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_DEBUG, "%02X", (val))          /*!< If the debug level is enabled, log a character as HEX value (example output: AA). */
+#define NRF_LOG_HEX_CHAR_ERROR(val)     NRF_LOG_DEFERRED_WRITE(NRF_LOG_LEVEL_ERROR, "%02X", (val))          /*!< Log a character as HEX value with the error level (example output: AA). */
+
+#define NRF_LOG_HAS_INPUT()             0                                                                   /*!< Input is not supported by the deferred logger. */
+#define NRF_LOG_READ_INPUT(p_char)      NRF_ERROR_NULL                                                      /*!< Input is not supported by the deferred logger. */
+
+#define NRF_LOG_PROCESS()               log_deferred_process()                                              /*!< Output one pending entry. */
+
 #else
 
 #include "nrf_error.h"
@@ -578,6 +747,8 @@ uint32_t log_raw_uart_read_input(char* p_char);
 #define NRF_LOG_HAS_INPUT()              0
 #define NRF_LOG_READ_INPUT(ignore)       NRF_SUCCESS
 
+#define NRF_LOG_PROCESS()                false
+
 #endif
 
 /**@brief Function for writing HEX values.
@@ -612,8 +783,9 @@ const char* log_hex_char(const char value);
  *
  * This library provides macros that call the respective functions depending on
  * which protocol is used. Define LOG_USES_RTT=1 to enable logging over RTT,
- * NRF_LOG_USES_UART=1 to enable logging over UART, or NRF_LOG_USES_RAW_UART=1
- * to enable logging over raw UART. One of these defines must be set for any of
+ * NRF_LOG_USES_UART=1 to enable logging over UART, NRF_LOG_USES_RAW_UART=1
+ * to enable logging over raw UART, or NRF_LOG_USES_DEFERRED=1 to record
+ * binary entries that are formatted later over RTT. One of these defines must be set for any of
  * the macros to have effect. If you choose to not output information, all
  * logging macros can be left in the code without any cost; they will just be
  * ignored.
@@ -694,6 +866,17 @@ int NRF_LOG_HAS_INPUT(void);
  */
 uint32_t NRF_LOG_READ_INPUT(char* p_char);
 
+/**@brief Macro for outputting one log entry that was deferred.
+ *
+ * @details Only does work when NRF_LOG_USES_DEFERRED is set to 1. In that case log calls only
+ *          record the format string address and arguments, and this macro must be called from
+ *          the main loop when the application is idle.
+ *
+ * @retval      true    More entries are pending.
+ * @retval      false   No more entries are pending.
+ */
+bool NRF_LOG_PROCESS(void);
+
 /** @} */
 #endif // DOXYGEN
 #endif // NRF_LOG_H_
@@ -0,0 +1,332 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "nrf_log_decoder.h"
+#include <string.h>
+
+#define HEADER_WORDS        2           /**< Format address and header word. */
+
+// Header word layout, see NRF_LOG_DEFERRED_HDR_* in nrf_log.h.
+#define HDR_TIMESTAMP_Msk   0x00FFFFFFUL
+#define HDR_NUM_ARGS_Pos    24
+#define HDR_NUM_ARGS_Msk    (0x0FUL << HDR_NUM_ARGS_Pos)
+#define HDR_LEVEL_Pos       28
+#define HDR_LEVEL_Msk       (0x07UL << HDR_LEVEL_Pos)
+#define HDR_STRING          (1UL << 31)
+
+#define LEVEL_MIN           1
+#define LEVEL_MAX           4
+
+#define FLAG_LEFT_JUSTIFY   (1 << 0)
+#define FLAG_PAD_ZERO       (1 << 1)
+#define FLAG_PRINT_SIGN     (1 << 2)
+
+/**@brief Output buffer that counts the characters that do not fit. */
+typedef struct
+{
+    char   * p_buf;
+    size_t   size;
+    size_t   len;
+} out_t;
+
+
+static uint32_t word_get(uint8_t const * p_data)
+{
+    return ((uint32_t)p_data[0]) | ((uint32_t)p_data[1] << 8) |
+           ((uint32_t)p_data[2] << 16) | ((uint32_t)p_data[3] << 24);
+}
+
+
+ret_code_t nrf_log_decoder_entry_parse(uint8_t const           * p_data,
+                                       size_t                    length,
+                                       nrf_log_decoder_entry_t * p_entry,
+                                       size_t                  * p_consumed)
+{
+    uint32_t header;
+    uint32_t num_args;
+
+    if (length < HEADER_WORDS * sizeof(uint32_t))
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    header   = word_get(&p_data[4]);
+    num_args = (header & HDR_NUM_ARGS_Msk) >> HDR_NUM_ARGS_Pos;
+
+    p_entry->format    = word_get(&p_data[0]);
+    p_entry->timestamp = header & HDR_TIMESTAMP_Msk;
+    p_entry->level     = (uint8_t)((header & HDR_LEVEL_Msk) >> HDR_LEVEL_Pos);
+    p_entry->is_string = ((header & HDR_STRING) != 0);
+    p_entry->num_args  = (uint8_t)num_args;
+
+    // Word 0 is never zero on the target, it marks entries that are not committed yet.
+    if ((p_entry->format == 0)                                    ||
+        (num_args > NRF_LOG_DECODER_MAX_ARGS)                     ||
+        (p_entry->is_string && (num_args != 0))                   ||
+        (p_entry->level < LEVEL_MIN) || (p_entry->level > LEVEL_MAX))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    if (length < (HEADER_WORDS + num_args) * sizeof(uint32_t))
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    for (uint32_t i = 0; i < num_args; i++)
+    {
+        p_entry->args[i] = word_get(&p_data[(HEADER_WORDS + i) * sizeof(uint32_t)]);
+    }
+
+    *p_consumed = (HEADER_WORDS + num_args) * sizeof(uint32_t);
+    return NRF_SUCCESS;
+}
+
+
+static void out_char(out_t * p_out, char c)
+{
+    if (p_out->len + 1 < p_out->size)
+    {
+        p_out->p_buf[p_out->len] = c;
+    }
+    p_out->len++;
+}
+
+
+static void out_string(out_t * p_out, char const * p_str)
+{
+    while (*p_str != '\0')
+    {
+        out_char(p_out, *p_str++);
+    }
+}
+
+
+/**@brief Function for printing a number the way SEGGER_RTT_printf does.
+ *
+ * @param[in] p_out       Output.
+ * @param[in] value       Absolute value.
+ * @param[in] negative    Print a minus sign.
+ * @param[in] base        10 or 16.
+ * @param[in] num_digits  Minimum number of digits.
+ * @param[in] width       Minimum field width.
+ * @param[in] flags       FLAG_* values.
+ */
+static void out_number(out_t  * p_out,
+                       uint32_t value,
+                       bool     negative,
+                       uint32_t base,
+                       uint32_t num_digits,
+                       uint32_t width,
+                       uint32_t flags)
+{
+    static char const digits[] = "0123456789ABCDEF";
+
+    char     tmp[12];
+    uint32_t n    = 0;
+    char     sign = negative ? '-' : ((flags & FLAG_PRINT_SIGN) ? '+' : '\0');
+    uint32_t len;
+
+    do
+    {
+        tmp[n++] = digits[value % base];
+        value   /= base;
+    } while (value != 0);
+
+    // Zero padding only applies without precision and without left justification.
+    if ((flags & FLAG_PAD_ZERO) && !(flags & FLAG_LEFT_JUSTIFY) && (num_digits == 0))
+    {
+        num_digits = (width > (sign ? 1u : 0u)) ? width - (sign ? 1u : 0u) : 0;
+    }
+
+    len = ((n > num_digits) ? n : num_digits) + (sign ? 1 : 0);
+
+    if (!(flags & FLAG_LEFT_JUSTIFY))
+    {
+        for (; len < width; width--)
+        {
+            out_char(p_out, ' ');
+        }
+    }
+    if (sign)
+    {
+        out_char(p_out, sign);
+    }
+    for (uint32_t i = n; i < num_digits; i++)
+    {
+        out_char(p_out, '0');
+    }
+    while (n > 0)
+    {
+        out_char(p_out, tmp[--n]);
+    }
+    if (flags & FLAG_LEFT_JUSTIFY)
+    {
+        for (; len < width; width--)
+        {
+            out_char(p_out, ' ');
+        }
+    }
+}
+
+
+static void out_address(out_t * p_out, uint32_t address)
+{
+    out_string(p_out, "<0x");
+    out_number(p_out, address, false, 16, 8, 0, 0);
+    out_char(p_out, '>');
+}
+
+
+size_t nrf_log_decoder_format(nrf_log_decoder_entry_t const * p_entry,
+                              nrf_log_decoder_string_get_t    string_get,
+                              void                          * p_context,
+                              char                          * p_out,
+                              size_t                          out_size)
+{
+    out_t        out    = {.p_buf = p_out, .size = out_size, .len = 0};
+    char const * p_fmt  = string_get(p_entry->format, p_context);
+    uint32_t     arg    = 0;
+
+    if (p_fmt == NULL)
+    {
+        out_address(&out, p_entry->format);
+        for (uint32_t i = 0; i < p_entry->num_args; i++)
+        {
+            out_char(&out, ' ');
+            out_number(&out, p_entry->args[i], false, 16, 8, 0, 0);
+        }
+    }
+    else if (p_entry->is_string)
+    {
+        out_string(&out, p_fmt);
+    }
+    else
+    {
+        while (*p_fmt != '\0')
+        {
+            char     c     = *p_fmt++;
+            uint32_t flags = 0;
+            uint32_t width = 0;
+            uint32_t prec  = 0;
+            uint32_t value;
+
+            if (c != '%')
+            {
+                out_char(&out, c);
+                continue;
+            }
+
+            for (bool more = true; more; )
+            {
+                switch (*p_fmt)
+                {
+                    case '-': flags |= FLAG_LEFT_JUSTIFY; p_fmt++; break;
+                    case '0': flags |= FLAG_PAD_ZERO;     p_fmt++; break;
+                    case '+': flags |= FLAG_PRINT_SIGN;   p_fmt++; break;
+                    case '#':                             p_fmt++; break;
+                    default:  more = false;                        break;
+                }
+            }
+            while ((*p_fmt >= '0') && (*p_fmt <= '9'))
+            {
+                width = width * 10 + (uint32_t)(*p_fmt++ - '0');
+            }
+            if (*p_fmt == '.')
+            {
+                p_fmt++;
+                while ((*p_fmt >= '0') && (*p_fmt <= '9'))
+                {
+                    prec = prec * 10 + (uint32_t)(*p_fmt++ - '0');
+                }
+            }
+            while ((*p_fmt == 'l') || (*p_fmt == 'h'))
+            {
+                p_fmt++;
+            }
+
+            c = *p_fmt;
+            if (c == '\0')
+            {
+                break;
+            }
+            p_fmt++;
+
+            if (c == '%')
+            {
+                out_char(&out, '%');
+                continue;
+            }
+            if ((c != 'c') && (c != 'd') && (c != 'u') && (c != 'x') && (c != 'X') &&
+                (c != 's') && (c != 'p'))
+            {
+                // Unknown conversions print nothing, as on the target.
+                continue;
+            }
+
+            // Missing arguments were zero on the target.
+            value = (arg < p_entry->num_args) ? p_entry->args[arg] : 0;
+            arg++;
+
+            switch (c)
+            {
+                case 'c':
+                    out_char(&out, (char)value);
+                    break;
+
+                case 'd':
+                    if ((int32_t)value < 0)
+                    {
+                        out_number(&out, 0u - value, true, 10, prec, width, flags);
+                    }
+                    else
+                    {
+                        out_number(&out, value, false, 10, prec, width, flags);
+                    }
+                    break;
+
+                case 'u':
+                    out_number(&out, value, false, 10, prec, width, flags);
+                    break;
+
+                case 'x':
+                case 'X':
+                    out_number(&out, value, false, 16, prec, width, flags);
+                    break;
+
+                case 'p':
+                    out_number(&out, value, false, 16, 8, 8, 0);
+                    break;
+
+                default: // 's'
+                {
+                    char const * p_str = string_get(value, p_context);
+                    if (p_str != NULL)
+                    {
+                        out_string(&out, p_str);
+                    }
+                    else
+                    {
+                        out_address(&out, value);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (out_size != 0)
+    {
+        out.p_buf[(out.len < out_size) ? out.len : out_size - 1] = '\0';
+    }
+    return out.len;
+}
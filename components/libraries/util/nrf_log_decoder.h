@@ -0,0 +1,98 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup nrf_log_decoder Host decoder for deferred binary logs
+ * @{
+ * @ingroup nrf_log
+ *
+ * @brief Host side decoder for the entries sent by nrf_log when NRF_LOG_USES_DEFERRED and
+ *        NRF_LOG_DEFERRED_BINARY are 1.
+ *
+ * @details The decoder is plain C and does not depend on the target. Entries only carry the
+ *          address of their format string, so strings are fetched through a callback, typically
+ *          from the ELF file of the firmware. Formatting follows SEGGER_RTT_printf, which is what
+ *          the target uses when it formats entries itself: flags '-', '0', '+' and '#', field
+ *          width, precision, and the conversions c, d, u, x, X, s, p and %.
+ */
+
+#ifndef NRF_LOG_DECODER_H__
+#define NRF_LOG_DECODER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#define NRF_LOG_DECODER_MAX_ARGS    6   /**< Must match NRF_LOG_DEFERRED_MAX_ARGS of the target. */
+
+/**@brief Decoded entry. */
+typedef struct
+{
+    uint32_t format;                            /**< Target address of the format string, or of the plain string. */
+    uint32_t timestamp;                         /**< 24-bit timestamp. */
+    uint8_t  level;                             /**< Log level, 1 (error) to 4 (debug). */
+    bool     is_string;                         /**< The entry is a plain string without arguments. */
+    uint8_t  num_args;                          /**< Number of arguments. */
+    uint32_t args[NRF_LOG_DECODER_MAX_ARGS];    /**< Arguments. */
+} nrf_log_decoder_entry_t;
+
+/**@brief Callback for looking up a null terminated string at a target address.
+ *
+ * @param[in] address   Target address.
+ * @param[in] p_context Context given to @ref nrf_log_decoder_format.
+ *
+ * @return Pointer to the string, or NULL if the address is not known.
+ */
+typedef char const * (*nrf_log_decoder_string_get_t)(uint32_t address, void * p_context);
+
+/**@brief Function for parsing one entry from the start of a byte stream.
+ *
+ * @param[in]  p_data       Stream data.
+ * @param[in]  length       Number of bytes available.
+ * @param[out] p_entry      Decoded entry.
+ * @param[out] p_consumed   Number of bytes used by the entry.
+ *
+ * @retval NRF_SUCCESS            Entry decoded.
+ * @retval NRF_ERROR_DATA_SIZE    The entry is not complete, more data is needed.
+ * @retval NRF_ERROR_INVALID_DATA The data does not start with a valid entry. The caller should
+ *                                skip one word and try again.
+ */
+ret_code_t nrf_log_decoder_entry_parse(uint8_t const           * p_data,
+                                       size_t                    length,
+                                       nrf_log_decoder_entry_t * p_entry,
+                                       size_t                  * p_consumed);
+
+/**@brief Function for formatting an entry.
+ *
+ * @details String arguments that cannot be resolved, and entries whose format is unknown, are
+ *          printed as addresses.
+ *
+ * @param[in]  p_entry      Entry.
+ * @param[in]  string_get   String lookup callback.
+ * @param[in]  p_context    Context passed to @p string_get.
+ * @param[out] p_out        Output buffer. Always null terminated if @p out_size is not 0.
+ * @param[in]  out_size     Size of the output buffer.
+ *
+ * @return Length of the complete text, excluding the terminator. If it is not smaller than
+ *         @p out_size, the output was truncated.
+ */
+size_t nrf_log_decoder_format(nrf_log_decoder_entry_t const * p_entry,
+                              nrf_log_decoder_string_get_t    string_get,
+                              void                          * p_context,
+                              char                          * p_out,
+                              size_t                          out_size);
+
+#endif // NRF_LOG_DECODER_H__
+
+/** @} */
@@ -119,6 +119,13 @@ static nrf_esb_payload_tx_fifo_t    m_tx_fifo;
 static nrf_esb_payload_t            m_rx_fifo_payload[NRF_ESB_RX_FIFO_SIZE];
 static nrf_esb_payload_rx_fifo_t    m_rx_fifo;
 
+// Borrowed FIFO slots
+static bool                         m_tx_slot_reserved          = false;
+static bool                         m_rx_slot_borrowed          = false;
+
+// FIFO statistics
+static nrf_esb_fifo_stats_t         m_fifo_stats;
+
 // Payload buffers
 static  uint8_t                     m_tx_payload_buffer[NRF_ESB_MAX_PAYLOAD_LENGTH + 2];
 static  uint8_t                     m_rx_payload_buffer[NRF_ESB_MAX_PAYLOAD_LENGTH + 2];
@@ -318,6 +325,9 @@ static void reset_fifos()
     m_rx_fifo.entry_point = 0;
     m_rx_fifo.exit_point  = 0;
     m_rx_fifo.count       = 0;
+
+    m_tx_slot_reserved    = false;
+    m_rx_slot_borrowed    = false;
 }
 
 
@@ -400,9 +410,17 @@ static bool rx_fifo_push_rfbuf(uint8_t pipe, uint8_t pid)
         }
         m_rx_fifo.count++;
 
+        if (m_rx_fifo.count > m_fifo_stats.rx_max_count)
+        {
+            m_fifo_stats.rx_max_count = m_rx_fifo.count;
+        }
+        m_fifo_stats.rx_packets++;
+
         return true;
     }
 
+    m_fifo_stats.rx_dropped++;
+
     return false;
 }
 
@@ -697,6 +715,7 @@ static void on_radio_disabled_rx(void)
 
     if(m_rx_fifo.count >= NRF_ESB_RX_FIFO_SIZE)
     {
+        m_fifo_stats.rx_dropped++;
         clear_events_restart_rx();
         return;
     }
@@ -830,6 +849,7 @@ uint32_t nrf_esb_init(nrf_esb_config_t const * p_config)
 
     memset(m_rx_pipe_info, 0, sizeof(m_rx_pipe_info));
     memset(m_pids, 0, sizeof(m_pids));
+    memset(&m_fifo_stats, 0, sizeof(m_fifo_stats));
 
     update_radio_parameters();
 
@@ -925,11 +945,83 @@ void ESB_EVT_IRQHandler(void)
     }
 }
 
+/**@brief Function for committing the TX FIFO slot at the entry point.
+ *
+ * @details The payload must already be in place in the slot. Must be called with the RF IRQ
+ *          disabled.
+ */
+static void tx_fifo_commit_entry(void)
+{
+    nrf_esb_payload_t * p_entry = m_tx_fifo.p_payload[m_tx_fifo.entry_point];
+
+    m_pids[p_entry->pipe] = (m_pids[p_entry->pipe] + 1) % (NRF_ESB_PID_MAX + 1);
+    p_entry->pid = m_pids[p_entry->pipe];
+
+    if (++m_tx_fifo.entry_point >= NRF_ESB_TX_FIFO_SIZE)
+    {
+        m_tx_fifo.entry_point = 0;
+    }
+
+    m_tx_fifo.count++;
+
+    if (m_tx_fifo.count > m_fifo_stats.tx_max_count)
+    {
+        m_fifo_stats.tx_max_count = m_tx_fifo.count;
+    }
+    m_fifo_stats.tx_packets++;
+}
+
+
+/**@brief Function for starting a transmission after new payloads were queued, if the TX mode
+ *        allows it.
+ */
+static void tx_auto_start(void)
+{
+    if (m_config_local.mode == NRF_ESB_MODE_PTX &&
+        m_config_local.tx_mode == NRF_ESB_TXMODE_AUTO &&
+        m_nrf_esb_mainstate == NRF_ESB_STATE_IDLE)
+    {
+        start_tx_transaction();
+    }
+}
+
+
+/**@brief Function for copying the payload header and the used part of the data area. */
+static void payload_copy(nrf_esb_payload_t * p_dst, nrf_esb_payload_t const * p_src)
+{
+    p_dst->length = p_src->length;
+    p_dst->pipe   = p_src->pipe;
+    p_dst->rssi   = p_src->rssi;
+    p_dst->noack  = p_src->noack;
+    p_dst->pid    = p_src->pid;
+    memcpy(p_dst->data, p_src->data, p_src->length);
+}
+
+
+/**@brief Function for copying out the RX FIFO element at the exit point and removing it.
+ *
+ * @details Only the used part of the data area is copied. Must be called with the RF IRQ
+ *          disabled.
+ */
+static void rx_fifo_pop(nrf_esb_payload_t * p_payload)
+{
+    payload_copy(p_payload, m_rx_fifo.p_payload[m_rx_fifo.exit_point]);
+
+    if (++m_rx_fifo.exit_point >= NRF_ESB_RX_FIFO_SIZE)
+    {
+        m_rx_fifo.exit_point = 0;
+    }
+
+    m_rx_fifo.count--;
+}
+
+
 uint32_t nrf_esb_write_payload(nrf_esb_payload_t const * p_payload)
 {
     VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
     VERIFY_PARAM_NOT_NULL(p_payload);
     VERIFY_PAYLOAD_LENGTH(p_payload);
+    VERIFY_FALSE(m_tx_slot_reserved, NRF_ERROR_BUSY);
     VERIFY_FALSE(m_tx_fifo.count >= NRF_ESB_TX_FIFO_SIZE, NRF_ERROR_NO_MEM);
 
     if (m_config_local.mode == NRF_ESB_MODE_PTX &&
@@ -940,28 +1032,68 @@ uint32_t nrf_esb_write_payload(nrf_esb_payload_t const * p_payload)
 
     DISABLE_RF_IRQ();
 
-    memcpy(m_tx_fifo.p_payload[m_tx_fifo.entry_point], p_payload, sizeof(nrf_esb_payload_t));
+    payload_copy(m_tx_fifo.p_payload[m_tx_fifo.entry_point], p_payload);
+    tx_fifo_commit_entry();
 
-    m_pids[p_payload->pipe] = (m_pids[p_payload->pipe] + 1) % (NRF_ESB_PID_MAX + 1);
-    m_tx_fifo.p_payload[m_tx_fifo.entry_point]->pid = m_pids[p_payload->pipe];
+    ENABLE_RF_IRQ();
 
-    if (++m_tx_fifo.entry_point >= NRF_ESB_TX_FIFO_SIZE)
+    tx_auto_start();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_tx_payload_reserve(nrf_esb_payload_t ** pp_payload)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_PARAM_NOT_NULL(pp_payload);
+    VERIFY_FALSE(m_tx_slot_reserved, NRF_ERROR_BUSY);
+    VERIFY_FALSE(m_tx_fifo.count >= NRF_ESB_TX_FIFO_SIZE, NRF_ERROR_NO_MEM);
+
+    // The radio only reads from the exit point, so the slot at the entry point is owned by
+    // the caller until it is committed.
+    m_tx_slot_reserved = true;
+    *pp_payload        = m_tx_fifo.p_payload[m_tx_fifo.entry_point];
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_tx_payload_commit(bool commit)
+{
+    nrf_esb_payload_t const * p_entry;
+
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_TRUE(m_tx_slot_reserved, NRF_ERROR_INVALID_STATE);
+
+    if (!commit)
     {
-        m_tx_fifo.entry_point = 0;
+        m_tx_slot_reserved = false;
+        return NRF_SUCCESS;
     }
 
-    m_tx_fifo.count++;
-
-    ENABLE_RF_IRQ();
+    // An invalid payload keeps the slot reserved, so it can be corrected or discarded.
+    p_entry = m_tx_fifo.p_payload[m_tx_fifo.entry_point];
 
+    VERIFY_PAYLOAD_LENGTH(p_entry);
+    VERIFY_TRUE(p_entry->pipe < NRF_ESB_PIPE_COUNT, NRF_ERROR_INVALID_PARAM);
 
     if (m_config_local.mode == NRF_ESB_MODE_PTX &&
-        m_config_local.tx_mode == NRF_ESB_TXMODE_AUTO &&
-        m_nrf_esb_mainstate == NRF_ESB_STATE_IDLE)
+        p_entry->noack && !m_config_local.selective_auto_ack )
     {
-        start_tx_transaction();
+        return NRF_ERROR_NOT_SUPPORTED;
     }
 
+    m_tx_slot_reserved = false;
+
+    DISABLE_RF_IRQ();
+
+    tx_fifo_commit_entry();
+
+    ENABLE_RF_IRQ();
+
+    tx_auto_start();
+
     return NRF_SUCCESS;
 }
 
@@ -970,19 +1102,82 @@ uint32_t nrf_esb_read_rx_payload(nrf_esb_payload_t * p_payload)
 {
     VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
     VERIFY_PARAM_NOT_NULL(p_payload);
+    VERIFY_FALSE(m_rx_slot_borrowed, NRF_ERROR_BUSY);
+
+    if (m_rx_fifo.count == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    DISABLE_RF_IRQ();
+
+    rx_fifo_pop(p_payload);
+
+    ENABLE_RF_IRQ();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_read_rx_payloads(nrf_esb_payload_t * p_payloads,
+                                  uint32_t            max_count,
+                                  uint32_t          * p_count)
+{
+    uint32_t count = 0;
+
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_PARAM_NOT_NULL(p_payloads);
+    VERIFY_PARAM_NOT_NULL(p_count);
+    VERIFY_FALSE(m_rx_slot_borrowed, NRF_ERROR_BUSY);
 
     if (m_rx_fifo.count == 0)
     {
+        *p_count = 0;
         return NRF_ERROR_NOT_FOUND;
     }
 
     DISABLE_RF_IRQ();
 
-    p_payload->length = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->length;
-    p_payload->pipe   = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->pipe;
-    p_payload->rssi   = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->rssi;
-    p_payload->pid    = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->pid;
-    memcpy(p_payload->data, m_rx_fifo.p_payload[m_rx_fifo.exit_point]->data, p_payload->length);
+    while ((count < max_count) && (m_rx_fifo.count > 0))
+    {
+        rx_fifo_pop(&p_payloads[count]);
+        count++;
+    }
+
+    ENABLE_RF_IRQ();
+
+    *p_count = count;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_rx_payload_borrow(nrf_esb_payload_t const ** pp_payload)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_PARAM_NOT_NULL(pp_payload);
+    VERIFY_FALSE(m_rx_slot_borrowed, NRF_ERROR_BUSY);
+
+    if (m_rx_fifo.count == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    // The radio only writes to the entry point, and never into an occupied slot, so the
+    // element at the exit point stays untouched until it is released.
+    m_rx_slot_borrowed = true;
+    *pp_payload        = m_rx_fifo.p_payload[m_rx_fifo.exit_point];
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_rx_payload_release(void)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_TRUE(m_rx_slot_borrowed, NRF_ERROR_INVALID_STATE);
+
+    DISABLE_RF_IRQ();
 
     if (++m_rx_fifo.exit_point >= NRF_ESB_RX_FIFO_SIZE)
     {
@@ -993,6 +1188,39 @@ uint32_t nrf_esb_read_rx_payload(nrf_esb_payload_t * p_payload)
 
     ENABLE_RF_IRQ();
 
+    m_rx_slot_borrowed = false;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_fifo_stats_get(nrf_esb_fifo_stats_t * p_stats)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    DISABLE_RF_IRQ();
+
+    *p_stats          = m_fifo_stats;
+    p_stats->tx_count = m_tx_fifo.count;
+    p_stats->rx_count = m_rx_fifo.count;
+
+    ENABLE_RF_IRQ();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_fifo_stats_clear(void)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+
+    DISABLE_RF_IRQ();
+
+    memset(&m_fifo_stats, 0, sizeof(m_fifo_stats));
+
+    ENABLE_RF_IRQ();
+
     return NRF_SUCCESS;
 }
 
@@ -1069,6 +1297,7 @@ uint32_t nrf_esb_flush_tx(void)
     m_tx_fifo.count = 0;
     m_tx_fifo.entry_point = 0;
     m_tx_fifo.exit_point = 0;
+    m_tx_slot_reserved = false;
 
     ENABLE_RF_IRQ();
 
@@ -1104,6 +1333,7 @@ uint32_t nrf_esb_flush_rx(void)
     m_rx_fifo.count = 0;
     m_rx_fifo.entry_point = 0;
     m_rx_fifo.exit_point = 0;
+    m_rx_slot_borrowed = false;
 
     memset(m_rx_pipe_info, 0, sizeof(m_rx_pipe_info));
 
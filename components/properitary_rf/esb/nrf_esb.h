@@ -248,6 +248,19 @@ typedef struct
 } nrf_esb_payload_t;
 
 
+/**@brief Enhanced ShockBurst FIFO statistics. */
+typedef struct
+{
+    uint32_t tx_count;                              /**< Current number of payloads in the TX FIFO. */
+    uint32_t rx_count;                              /**< Current number of payloads in the RX FIFO. */
+    uint32_t tx_max_count;                          /**< Highest TX FIFO depth seen since the statistics were cleared. */
+    uint32_t rx_max_count;                          /**< Highest RX FIFO depth seen since the statistics were cleared. */
+    uint32_t tx_packets;                            /**< Number of payloads queued for transmission. */
+    uint32_t rx_packets;                            /**< Number of payloads pushed to the RX FIFO. */
+    uint32_t rx_dropped;                            /**< Number of received packets dropped because the RX FIFO was full. */
+} nrf_esb_fifo_stats_t;
+
+
 /**@brief Enhanced ShockBurst event. */
 typedef struct
 {
@@ -354,6 +367,104 @@ uint32_t nrf_esb_write_payload(nrf_esb_payload_t const * p_payload);
 uint32_t nrf_esb_read_rx_payload(nrf_esb_payload_t * p_payload);
 
 
+/**@brief Function to reserve the next free TX FIFO slot for in-place payload construction.
+ *
+ * @details Instead of building the payload in a separate structure and copying it with
+ *          @ref nrf_esb_write_payload, the application can fill the returned slot directly and
+ *          queue it with @ref nrf_esb_tx_payload_commit. Only one slot can be reserved at a time,
+ *          and @ref nrf_esb_write_payload is unavailable while a slot is reserved. The PID of the
+ *          slot is assigned on commit.
+ *
+ * @param[out]  pp_payload    Pointer to the reserved FIFO slot.
+ *
+ * @retval  NRF_SUCCESS                     Slot was reserved.
+ * @retval  NRF_ERROR_NULL                  Required parameter was NULL.
+ * @retval  NRF_INVALID_STATE               Module is not initialized.
+ * @retval  NRF_ERROR_BUSY                  A slot is already reserved.
+ * @retval  NRF_ERROR_NO_MEM                The TX FIFO is full.
+ */
+uint32_t nrf_esb_tx_payload_reserve(nrf_esb_payload_t ** pp_payload);
+
+
+/**@brief Function to queue or discard the TX FIFO slot reserved by @ref nrf_esb_tx_payload_reserve.
+ *
+ * @details If the payload in the slot is invalid, the slot stays reserved. The application can
+ *          then correct the payload and commit again, or discard it.
+ *
+ * @param[in]   commit        True to queue the payload in the slot, false to discard it.
+ *
+ * @retval  NRF_SUCCESS                     Payload was queued or discarded.
+ * @retval  NRF_INVALID_STATE               Module is not initialized, or no slot was reserved.
+ * @retval  NRF_ERROR_INVALID_PARAM         Pipe number in the slot was invalid.
+ * @retval  NRF_ERROR_NOT_SUPPORTED         noack was set while selective ack was not enabled.
+ * @retval  NRF_ERROR_INVALID_LENGTH        Payload length was invalid (zero or larger than max allowed).
+ */
+uint32_t nrf_esb_tx_payload_commit(bool commit);
+
+
+/**@brief Function to read several RX payloads at once.
+ *
+ * @details Pops up to @p max_count payloads with the radio interrupt disabled only once. Only
+ *          the used part of each payload data area is copied.
+ *
+ * @param[out]  p_payloads    Array of at least @p max_count payloads.
+ * @param[in]   max_count     Maximum number of payloads to read.
+ * @param[out]  p_count       Number of payloads read.
+ *
+ * @retval  NRF_SUCCESS                     At least one payload was read.
+ * @retval  NRF_ERROR_NULL                  Required parameter was NULL.
+ * @retval  NRF_INVALID_STATE               Module is not initialized.
+ * @retval  NRF_ERROR_BUSY                  An RX payload is currently borrowed.
+ * @retval  NRF_ERROR_NOT_FOUND             The RX FIFO is empty.
+ */
+uint32_t nrf_esb_read_rx_payloads(nrf_esb_payload_t * p_payloads,
+                                  uint32_t            max_count,
+                                  uint32_t          * p_count);
+
+
+/**@brief Function to access the oldest RX payload in place.
+ *
+ * @details The payload stays in the RX FIFO, and the slot is not reused by the radio, until
+ *          @ref nrf_esb_rx_payload_release is called. Only one payload can be borrowed at a time.
+ *
+ * @param[out]  pp_payload    Pointer to the oldest payload in the RX FIFO.
+ *
+ * @retval  NRF_SUCCESS                     Payload is available.
+ * @retval  NRF_ERROR_NULL                  Required parameter was NULL.
+ * @retval  NRF_INVALID_STATE               Module is not initialized.
+ * @retval  NRF_ERROR_BUSY                  A payload is already borrowed.
+ * @retval  NRF_ERROR_NOT_FOUND             The RX FIFO is empty.
+ */
+uint32_t nrf_esb_rx_payload_borrow(nrf_esb_payload_t const ** pp_payload);
+
+
+/**@brief Function to remove the payload borrowed by @ref nrf_esb_rx_payload_borrow from the RX FIFO.
+ *
+ * @retval  NRF_SUCCESS                     Payload was removed.
+ * @retval  NRF_INVALID_STATE               Module is not initialized, or no payload was borrowed.
+ */
+uint32_t nrf_esb_rx_payload_release(void);
+
+
+/**@brief Function to get the FIFO statistics.
+ *
+ * @param[out]  p_stats       Current FIFO depths and statistics.
+ *
+ * @retval  NRF_SUCCESS                     Call was successful.
+ * @retval  NRF_ERROR_NULL                  Required parameter was NULL.
+ * @retval  NRF_INVALID_STATE               Module is not initialized.
+ */
+uint32_t nrf_esb_fifo_stats_get(nrf_esb_fifo_stats_t * p_stats);
+
+
+/**@brief Function to clear the FIFO statistics.
+ *
+ * @retval  NRF_SUCCESS                     Call was successful.
+ * @retval  NRF_INVALID_STATE               Module is not initialized.
+ */
+uint32_t nrf_esb_fifo_stats_clear(void);
+
+
 /**@brief Function to start transmitting.
  *
  * @retval  NRF_SUCCESS                     TX started successfully.
@@ -0,0 +1,67 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stdint.h>
+#include "app_error.h"
+#include "ble_serialization.h"
+#include "ser_sd_transport.h"
+#include "conn_evt_batch.h"
+
+
+/**@brief Command response callback function for @ref conn_evt_batch_enable.
+ *
+ * @param[in] p_buffer  Pointer to begin of command response buffer.
+ * @param[in] length    Length of data in bytes.
+ *
+ * @return Decoded command response return code.
+ */
+static uint32_t evt_batch_cfg_rsp_dec(const uint8_t * p_buffer, uint16_t length)
+{
+    uint32_t result_code = 0;
+
+    const uint32_t err_code = ser_ble_cmd_rsp_dec(p_buffer,
+                                                  length,
+                                                  SER_EVT_BATCH_CFG_OP_CODE,
+                                                  &result_code);
+
+    //@note: Should never fail.
+    APP_ERROR_CHECK(err_code);
+
+    return result_code;
+}
+
+
+uint32_t conn_evt_batch_enable(uint16_t max_len, uint8_t max_events)
+{
+    uint32_t  err_code;
+    uint8_t * p_tx_buf   = NULL;
+    uint16_t  tx_buf_len = 0;
+    uint32_t  index      = SER_PKT_OP_CODE_POS;
+
+    err_code = ser_sd_transport_tx_alloc(&p_tx_buf, &tx_buf_len);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    SER_ASSERT_LENGTH_LEQ(SER_PKT_DATA_POS + sizeof (uint16_t) + sizeof (uint8_t), tx_buf_len);
+    p_tx_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_CMD;
+    p_tx_buf[index++]          = SER_EVT_BATCH_CFG_OP_CODE;
+
+    err_code = uint16_t_enc(&max_len, p_tx_buf, tx_buf_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = uint8_t_enc(&max_events, p_tx_buf, tx_buf_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    return ser_sd_transport_cmd_write(p_tx_buf, (uint16_t)index, evt_batch_cfg_rsp_dec);
+}
@@ -0,0 +1,51 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef CONN_EVT_BATCH_H__
+#define CONN_EVT_BATCH_H__
+
+#include <stdint.h>
+
+/**
+ * @addtogroup ser_codecs Serialization codecs
+ * @ingroup ble_sdk_lib_serialization
+ */
+
+/**
+ * @addtogroup ser_app_common_codecs Application common codecs
+ * @ingroup ser_codecs
+ */
+
+/**@file
+ *
+ * @defgroup conn_evt_batch Connectivity chip event batching command request encoder.
+ * @{
+ * @ingroup  ser_app_common_codecs
+ *
+ * @brief    Connectivity chip event batching command request encoder.
+ */
+
+/**@brief Function for asking the connectivity chip to coalesce events into batch packets.
+ *
+ * @param[in] max_len     Maximum length of a batch packet the application can receive.
+ * @param[in] max_events  Maximum number of events in a batch packet. Values below 2 disable
+ *                        batching.
+ *
+ * @retval NRF_SUCCESS              Batching configured.
+ * @retval NRF_ERROR_NOT_SUPPORTED  Connectivity firmware does not support batching. Events keep
+ *                                  coming in separate packets.
+ * @retval NRF_ERROR_INTERNAL       Encoding failure. Transport error.
+ */
+uint32_t conn_evt_batch_enable(uint16_t max_len, uint8_t max_events);
+
+/** @} */
+#endif // CONN_EVT_BATCH_H__
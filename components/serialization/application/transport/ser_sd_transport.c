@@ -54,6 +54,47 @@ static volatile bool m_rsp_wait = false;
 /** SoftDevice call return value decoded by user decoder handler. */
 static uint32_t m_return_value;
 
+/** Flag indicating that events of a batch packet are being passed to the event handler. The packet
+ *  is freed once, after the last event. */
+static bool m_evt_batch_split = false;
+
+/**@brief Function for passing every event of a batch packet to the event handler.
+ *
+ * @param[in]   p_data   Pointer to the batch, after the packet type field.
+ * @param[in]   length   Size of the batch.
+ */
+static void ser_sd_transport_evt_batch_split(uint8_t * p_data, uint16_t length)
+{
+    uint16_t index = 0;
+    uint16_t evt_len;
+
+    m_evt_batch_split = true;
+
+    while ((length - index) >= SER_EVT_BATCH_LEN_SIZE)
+    {
+        evt_len = uint16_decode(&p_data[index]);
+        index  += SER_EVT_BATCH_LEN_SIZE;
+
+        if (evt_len > (length - index))
+        {
+            break;
+        }
+
+        APPL_LOG("\r\n[EVT_ID]: 0x%X \r\n", uint16_decode(&p_data[index + SER_EVT_ID_POS]));
+        m_evt_handler(&p_data[index], evt_len);
+        index += evt_len;
+    }
+
+    m_evt_batch_split = false;
+    (void)ser_sd_transport_rx_free(p_data);
+
+    if (index != length)
+    {
+        /* Malformed batch. */
+        APP_ERROR_HANDLER(SER_PKT_TYPE_EVT_BATCH);
+    }
+}
+
 /**@brief Function for handling the rx packets comming from hal_transport.
  *
  * @details
@@ -105,6 +146,10 @@ static void ser_sd_transport_rx_packet_handler(uint8_t * p_data, uint16_t length
                 m_evt_handler(p_data, length);
                 break;
 
+            case SER_PKT_TYPE_EVT_BATCH:
+                ser_sd_transport_evt_batch_split(p_data, length);
+                break;
+
             default:
                 (void)ser_sd_transport_rx_free(p_data);
                 APP_ERROR_HANDLER(packet_type);
@@ -223,6 +268,12 @@ uint32_t ser_sd_transport_tx_free(uint8_t * p_data)
 
 uint32_t ser_sd_transport_rx_free(uint8_t * p_data)
 {
+    if (m_evt_batch_split)
+    {
+        /* Freed after the last event of the batch. */
+        return NRF_SUCCESS;
+    }
+
     p_data -= SER_PKT_TYPE_SIZE;
     return ser_hal_transport_rx_pkt_free(p_data);
 }
@@ -51,7 +51,9 @@ typedef uint32_t (*ser_sd_transport_rsp_handler_t)(const uint8_t * p_buffer, uin
  *       usually 'Wait for response' will only be used for handling incoming events or force
  *       application to low power mode.
  *
- * @param[in] evt_handler               Handler to be called when event packet is received.
+ * @param[in] evt_handler               Handler to be called when event packet is received. Events
+ *                                      of a @ref SER_PKT_TYPE_EVT_BATCH packet are passed one by
+ *                                      one, each valid only until the handler returns.
  * @param[in] os_rsp_wait_handler       Handler to be called after request is send. It should.
  *                                      implement 'Wait for signal' functionality in OS environment.
  * @param[in] os_rsp_set_handler        Handler to be called after response reception. It should
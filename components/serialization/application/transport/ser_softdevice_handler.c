@@ -18,10 +18,11 @@
 #include "ser_sd_transport.h"
 #include "ser_app_hal.h"
 #include "ser_config.h"
+#include "conn_evt_batch.h"
 #include "nrf_soc.h"
 
 
-#define SD_BLE_EVT_MAILBOX_QUEUE_SIZE 5 /**< Size of mailbox queue. */
+#define SD_BLE_EVT_MAILBOX_QUEUE_SIZE (4 + SER_EVT_BATCH_MAX_EVENTS) /**< Size of mailbox queue. Room for a full batch of events on top of four single events. */
 
 /** @brief Structure used to pass packet details through mailbox.
  */
@@ -183,6 +184,10 @@ uint32_t sd_softdevice_enable(nrf_clock_lf_cfg_t const * p_clock_lf_cfg,
             if (err_code == NRF_SUCCESS)
             {
               connectivity_reset_high();
+
+              /* Connectivity firmware without batching support keeps sending events one by one. */
+              (void)conn_evt_batch_enable(SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE,
+                                          SER_EVT_BATCH_MAX_EVENTS);
             }
         }
 
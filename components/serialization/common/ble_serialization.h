@@ -27,6 +27,7 @@ typedef enum
     SER_PKT_TYPE_DTM_CMD,     /**< DTM Command packet type. */
     SER_PKT_TYPE_DTM_RESP,    /**< DTM Response packet type. */
     SER_PKT_TYPE_RESET_CMD,   /**< System Reset Command packet type. */
+    SER_PKT_TYPE_EVT_BATCH,   /**< Batch of events packet type. Sent only when enabled by @ref SER_EVT_BATCH_CFG_OP_CODE. */
     SER_PKT_TYPE_MAX          /**< Upper bound. */
 } ser_pkt_type_t;
 
@@ -58,6 +59,7 @@ typedef enum
 #define SER_CMD_HEADER_SIZE            (SER_OP_CODE_SIZE)
 /** Size of the Command Response header. */
 #define SER_CMD_RSP_HEADER_SIZE        (SER_OP_CODE_SIZE + SER_ERR_CODE_SIZE)
+
 /** Position of the Command Response code. */
 #define SER_CMD_RSP_STATUS_CODE_POS    (SER_OP_CODE_SIZE)
 
@@ -70,6 +72,14 @@ typedef enum
 /** Size of event connection handler. */
 #define SER_EVT_CONN_HANDLE_SIZE       2
 
+/** Operation code of the command enabling @ref SER_PKT_TYPE_EVT_BATCH packets. Chosen outside the
+ *  SoftDevice SVC ranges. Command data: maximum batch length (uint16) and maximum number of events
+ *  in a batch (uint8). Connectivity firmware without batching support responds with
+ *  NRF_ERROR_NOT_SUPPORTED and keeps sending every event in its own packet. */
+#define SER_EVT_BATCH_CFG_OP_CODE      0xF0
+/** Size in bytes of the length field preceding every event in a @ref SER_PKT_TYPE_EVT_BATCH packet. */
+#define SER_EVT_BATCH_LEN_SIZE         2
+
 /** Position of the Op Code in the DTM command buffer.*/
 #define SER_DTM_CMD_OP_CODE_POS        0
 /** Position of the data in the DTM command buffer.*/
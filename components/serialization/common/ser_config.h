@@ -53,6 +53,19 @@
 #endif /* SER_CONNECTIVITY */
 
 
+/***********************************************************************************************//**
+ * Event batching configuration.
+ **************************************************************************************************/
+
+/** Maximum number of BLE events coalesced in one @ref SER_PKT_TYPE_EVT_BATCH packet. The
+ *  application side needs mailbox space for this many decoded events. */
+#define SER_EVT_BATCH_MAX_EVENTS        4
+
+/** Maximum time an event can wait in the connectivity side for more events to share its
+ *  packet (in milliseconds). */
+#define SER_EVT_BATCH_DEADLINE_MS       2
+
+
 /***********************************************************************************************//**
  * SER_PHY layer configuration.
  **************************************************************************************************/
@@ -4,6 +4,7 @@
 #include "conn_mw_ble_gap.h"
 #include "conn_mw_ble_gatts.h"
 #include "conn_mw_ble_gattc.h"
+#include "ser_conn_event_encoder.h"
 
 /**@brief Connectivity middleware handlers table. */
 static const conn_mw_item_t conn_mw_item[] = {
@@ -80,4 +81,6 @@ static const conn_mw_item_t conn_mw_item[] = {
     {SD_BLE_GATTS_RW_AUTHORIZE_REPLY, conn_mw_ble_gatts_rw_authorize_reply},
     {SD_BLE_GATTS_SYS_ATTR_SET, conn_mw_ble_gatts_sys_attr_set},
     {SD_BLE_GATTS_SYS_ATTR_GET, conn_mw_ble_gatts_sys_attr_get},
+    //Serialization transport
+    {SER_EVT_BATCH_CFG_OP_CODE, conn_mw_ser_evt_batch_cfg},
 };
@@ -14,12 +14,177 @@
 #include <stdint.h>
 #include "app_error.h"
 #include "app_scheduler.h"
+#include "app_timer.h"
 #include "ble_conn.h"
 #include "ble_serialization.h"
 #include "ser_config.h"
 #include "ser_hal_transport.h"
 #include "ser_conn_event_encoder.h"
 
+#ifndef APP_TIMER_PRESCALER
+#define APP_TIMER_PRESCALER 0
+#endif
+
+#define EVT_BATCH_DEADLINE_TICKS  MAX(APP_TIMER_TICKS(SER_EVT_BATCH_DEADLINE_MS, APP_TIMER_PRESCALER), \
+                                      APP_TIMER_MIN_TIMEOUT_TICKS)
+
+/** Events waiting to be sent, packet type field included. */
+static uint8_t  m_batch_buf[SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE];
+static uint16_t m_batch_len        = SER_PKT_TYPE_SIZE; /**< Number of bytes used in m_batch_buf. */
+static uint8_t  m_batch_count      = 0;                 /**< Number of events in m_batch_buf. */
+static uint16_t m_batch_max_len    = 0;                 /**< Maximum batch packet length, 0 when batching is disabled. */
+static uint8_t  m_batch_max_events = 0;                 /**< Maximum number of events in a batch packet. */
+static bool     m_batch_timer_created = false;
+static bool     m_batch_timer_running = false;
+
+static ser_conn_evt_stats_t m_stats;
+
+APP_TIMER_DEF(m_batch_timer_id);
+
+
+/**@brief Function for sending all events collected in the batch buffer.
+ *
+ * @details A batch holding a single event is sent as an ordinary event packet.
+ */
+static void evt_batch_flush(void)
+{
+    uint32_t  err_code;
+    uint8_t * p_tx_buf   = NULL;
+    uint16_t  tx_buf_len = 0;
+
+    if (m_batch_count == 0)
+    {
+        return;
+    }
+
+    if (m_batch_timer_running)
+    {
+        m_batch_timer_running = false;
+        (void)app_timer_stop(m_batch_timer_id);
+    }
+
+    do
+    {
+        err_code = ser_hal_transport_tx_pkt_alloc(&p_tx_buf, &tx_buf_len);
+    }
+    while (err_code == NRF_ERROR_NO_MEM);
+    APP_ERROR_CHECK(err_code);
+
+    if (m_batch_count == 1)
+    {
+        tx_buf_len                 = m_batch_len - SER_EVT_BATCH_LEN_SIZE;
+        p_tx_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT;
+        memcpy(&p_tx_buf[SER_PKT_OP_CODE_POS],
+               &m_batch_buf[SER_PKT_TYPE_SIZE + SER_EVT_BATCH_LEN_SIZE],
+               tx_buf_len - SER_PKT_TYPE_SIZE);
+    }
+    else
+    {
+        tx_buf_len = m_batch_len;
+        memcpy(p_tx_buf, m_batch_buf, tx_buf_len);
+    }
+
+    m_batch_len   = SER_PKT_TYPE_SIZE;
+    m_batch_count = 0;
+    m_stats.packets++;
+
+    err_code = ser_hal_transport_tx_pkt_send(p_tx_buf, tx_buf_len);
+    APP_ERROR_CHECK(err_code);
+    /* See ser_conn_ble_event_encoder() for the reason of pausing the scheduler. */
+    app_sched_pause();
+}
+
+
+/**@brief Scheduler handler flushing the batch once its deadline has passed. */
+static void evt_batch_flush_handler(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    evt_batch_flush();
+}
+
+
+/**@brief Timer handler called when the first event in the batch has waited for the deadline.
+ *
+ * @details The batch is flushed from the scheduler, in the same context the events are encoded.
+ */
+static void evt_batch_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    m_batch_timer_running = false;
+
+    uint32_t err_code = app_sched_event_put(NULL, 0, evt_batch_flush_handler);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for encoding an event at the end of the batch buffer.
+ *
+ * @param[in] p_ble_evt  Event to encode.
+ *
+ * @retval NRF_SUCCESS  Event added to the batch. Other codes are propagated from the event encoder,
+ *                      in particular when the event does not fit in the space left.
+ */
+static uint32_t evt_batch_append(ble_evt_t const * p_ble_evt)
+{
+    uint32_t err_code;
+    uint32_t evt_pos = m_batch_len + SER_EVT_BATCH_LEN_SIZE;
+    uint32_t evt_len;
+
+    if (evt_pos >= m_batch_max_len)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    evt_len  = m_batch_max_len - evt_pos;
+    err_code = ble_event_enc(p_ble_evt, 0, &m_batch_buf[evt_pos], &evt_len);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    (void)uint16_encode((uint16_t)evt_len, &m_batch_buf[m_batch_len]);
+    m_batch_len = (uint16_t)(evt_pos + evt_len);
+    m_batch_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for adding an event to the batch, sending the batch when it is full. */
+static void evt_batch_add(ble_evt_t const * p_ble_evt)
+{
+    uint32_t err_code = evt_batch_append(p_ble_evt);
+
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_NOT_SUPPORTED) && (m_batch_count != 0))
+    {
+        /* The event does not fit in the space left. Send the events collected so far and retry
+         * with an empty batch. */
+        evt_batch_flush();
+        err_code = evt_batch_append(p_ble_evt);
+    }
+
+    if (NRF_ERROR_NOT_SUPPORTED == err_code)
+    {
+        APP_ERROR_CHECK(SER_WARNING_CODE);
+        return;
+    }
+    APP_ERROR_CHECK(err_code);
+
+    if (m_batch_count >= m_batch_max_events)
+    {
+        evt_batch_flush();
+    }
+    else if ((m_batch_count == 1) && !m_batch_timer_running)
+    {
+        err_code = app_timer_start(m_batch_timer_id, EVT_BATCH_DEADLINE_TICKS, NULL);
+        APP_ERROR_CHECK(err_code);
+        m_batch_timer_running = true;
+    }
+}
+
 
 void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
 {
@@ -34,6 +199,17 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
     uint32_t    tx_buf_len = 0;
     ble_evt_t * p_ble_evt  = (ble_evt_t *)p_event_data;
 
+    m_stats.events++;
+
+    if (m_batch_max_len != 0)
+    {
+        evt_batch_add(p_ble_evt);
+        return;
+    }
+
+    /* Batching was disabled with events still waiting. Keep the order of events. */
+    evt_batch_flush();
+
     /* Allocate a memory buffer from HAL Transport layer for transmitting an event.
      * Loop until a buffer is available. */
     do
@@ -54,6 +230,7 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
     {
         APP_ERROR_CHECK(err_code);
         tx_buf_len += SER_PKT_TYPE_SIZE;
+        m_stats.packets++;
         err_code    = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
         APP_ERROR_CHECK(err_code);
         /* TX buffer is going to be freed automatically in the HAL Transport layer.
@@ -73,3 +250,69 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
     }
 }
 
+
+uint32_t ser_conn_evt_batch_enable(uint16_t max_len, uint8_t max_events)
+{
+    uint32_t err_code;
+
+    /* This runs while the TX buffer is held for the command response, so events already collected
+     * are left to the running deadline timer. */
+    if ((max_events < 2) || (max_len == 0))
+    {
+        m_batch_max_len    = 0;
+        m_batch_max_events = 0;
+        return NRF_SUCCESS;
+    }
+
+    if (!m_batch_timer_created)
+    {
+        err_code = app_timer_create(&m_batch_timer_id,
+                                    APP_TIMER_MODE_SINGLE_SHOT,
+                                    evt_batch_timeout_handler);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+        m_batch_timer_created = true;
+    }
+
+    m_batch_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT_BATCH;
+    m_batch_max_len               = MIN(max_len, sizeof(m_batch_buf));
+    m_batch_max_events            = max_events;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t conn_mw_ser_evt_batch_cfg(uint8_t const * const p_rx_buf,
+                                   uint32_t              rx_buf_len,
+                                   uint8_t * const       p_tx_buf,
+                                   uint32_t * const      p_tx_buf_len)
+{
+    SER_ASSERT_NOT_NULL(p_rx_buf);
+    SER_ASSERT_NOT_NULL(p_tx_buf);
+    SER_ASSERT_NOT_NULL(p_tx_buf_len);
+
+    uint32_t err_code;
+    uint32_t index = SER_CMD_DATA_POS;
+    uint16_t max_len;
+    uint8_t  max_events;
+
+    err_code = uint16_t_dec(p_rx_buf, rx_buf_len, &index, &max_len);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = uint8_t_dec(p_rx_buf, rx_buf_len, &index, &max_events);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    SER_ASSERT_LENGTH_EQ(index, rx_buf_len);
+
+    uint32_t result_code = ser_conn_evt_batch_enable(max_len, max_events);
+
+    index = 0;
+    return op_status_enc(SER_EVT_BATCH_CFG_OP_CODE, result_code, p_tx_buf, p_tx_buf_len, &index);
+}
+
+
+void ser_conn_evt_stats_get(ser_conn_evt_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
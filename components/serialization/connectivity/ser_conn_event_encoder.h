@@ -32,6 +32,13 @@
 
 #include <stdint.h>
 
+/**@brief Event transmission statistics. */
+typedef struct
+{
+    uint32_t events;  /**< Number of BLE events passed to the encoder. */
+    uint32_t packets; /**< Number of event packets sent to the Application Chip. */
+} ser_conn_evt_stats_t;
+
 /**@brief A function for encoding a @ref ble_evt_t. The function passes the serialized byte stream
  *        to the transport layer after encoding.
  *
@@ -45,6 +52,45 @@
  */
 void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size);
 
+/**@brief Function for enabling coalescing of events into @ref SER_PKT_TYPE_EVT_BATCH packets.
+ *
+ * @details While enabled, encoded events are collected until @p max_events are waiting, the next
+ *          event does not fit in @p max_len bytes, or the first event has waited for
+ *          @ref SER_EVT_BATCH_DEADLINE_MS. Requires an initialized app_timer.
+ *
+ * @param[in] max_len     Maximum length of a batch packet, packet type field included.
+ * @param[in] max_events  Maximum number of events in a batch packet. Values below 2 disable
+ *                        batching.
+ *
+ * @retval NRF_SUCCESS  Batching configured. Other codes are propagated from app_timer.
+ */
+uint32_t ser_conn_evt_batch_enable(uint16_t max_len, uint8_t max_events);
+
+/**@brief Connectivity middleware handler of the @ref SER_EVT_BATCH_CFG_OP_CODE command.
+ *
+ * @param[in]     p_rx_buf      Pointer to input buffer.
+ * @param[in]     rx_buf_len    Size of p_rx_buf.
+ * @param[out]    p_tx_buf      Pointer to output buffer.
+ * @param[in,out] p_tx_buf_len  \c in: size of \p p_tx_buf buffer.
+ *                              \c out: Length of valid data in \p p_tx_buf.
+ *
+ * @retval NRF_SUCCESS                Handler success.
+ * @retval NRF_ERROR_NULL             Handler failure. NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_LENGTH   Handler failure. Incorrect buffer length.
+ */
+uint32_t conn_mw_ser_evt_batch_cfg(uint8_t const * const p_rx_buf,
+                                   uint32_t              rx_buf_len,
+                                   uint8_t * const       p_tx_buf,
+                                   uint32_t * const      p_tx_buf_len);
+
+/**@brief Function for getting event transmission statistics.
+ *
+ * @details The ratio of events to packets shows how well events are coalesced.
+ *
+ * @param[out] p_stats  Statistics since reset.
+ */
+void ser_conn_evt_stats_get(ser_conn_evt_stats_t * p_stats);
+
 #endif /* SER_CONN_EVENT_ENCODER_H__ */
 
 /** @} */
@@ -86,6 +86,47 @@ static ant_evt_handler_t              m_ant_evt_handler;                /**< App
 
 static sys_evt_handler_t              m_sys_evt_handler;                /**< Application event handler for handling System (SOC) events.  */
 
+/**@brief Source of an event held in the event ring. */
+typedef enum
+{
+    EVT_SOURCE_SOC,                                                     /**< System (SOC) event. */
+    EVT_SOURCE_BLE,                                                     /**< BLE stack event. */
+    EVT_SOURCE_ANT                                                      /**< ANT stack event. */
+} evt_source_t;
+
+/**@brief Result of pulling one event into the event ring. */
+typedef enum
+{
+    PULL_DONE,                                                          /**< The SoftDevice has no more events from this source. */
+    PULL_STORED,                                                        /**< An event was stored in the ring. */
+    PULL_RING_FULL                                                      /**< No free slot, nothing was pulled. */
+} pull_result_t;
+
+/**@brief Header word of an event ring slot. */
+typedef struct
+{
+    uint16_t len;                                                       /**< Length of the event. */
+    uint8_t  source;                                                    /**< Source of the event, see @ref evt_source_t. */
+    uint8_t  reserved;
+} evt_slot_hdr_t;
+
+/**@brief Event ring. Slots are written by the stack event interrupt and read by the dispatcher. */
+typedef struct
+{
+    uint32_t                        * p_slots;                          /**< Slot buffer, NULL when events are not ring buffered. */
+    uint16_t                          slot_count;                       /**< Number of slots. */
+    uint16_t                          batch_size;                       /**< Maximum number of events dispatched per call. */
+    volatile uint16_t                 head;                             /**< Number of events stored (free running). */
+    volatile uint16_t                 tail;                             /**< Number of events dispatched (free running). */
+    volatile bool                     refill_pending;                   /**< The ring got full while pulling, events may be left in the SoftDevice. */
+    volatile bool                     dispatch_scheduled;               /**< The dispatcher has been scheduled and has not started yet. */
+    softdevice_handler_ring_stats_t   stats;                            /**< Ring statistics. */
+} evt_ring_t;
+
+static evt_ring_t                     m_ring;                           /**< Event ring. */
+
+STATIC_ASSERT(sizeof(evt_slot_hdr_t) == sizeof(uint32_t));
+
 
 /**@brief       Callback function for asserts in the SoftDevice.
  *
@@ -106,6 +147,286 @@ void softdevice_fault_handler(uint32_t id, uint32_t pc, uint32_t info)
 }
 
 
+/**@brief Function for getting the number of events held in the event ring. */
+static __INLINE uint16_t ring_count(void)
+{
+    return (uint16_t)(m_ring.head - m_ring.tail);
+}
+
+
+/**@brief Function for getting an event ring slot. */
+static __INLINE uint32_t * ring_slot_get(uint16_t index)
+{
+    // slot_count is a power of two, so the mapping stays continuous when the index wraps.
+    return &m_ring.p_slots[(index & (m_ring.slot_count - 1)) * SOFTDEVICE_EVT_RING_SLOT_WORDS];
+}
+
+
+/**@brief Function for pulling one event from the SoftDevice into the next free slot.
+ *
+ * @param[in] source  Source to pull the event from.
+ */
+static pull_result_t ring_pull(evt_source_t source)
+{
+    uint32_t         err_code;
+    uint32_t       * p_slot;
+    evt_slot_hdr_t * p_hdr;
+    uint16_t         count = ring_count();
+
+    if (count >= m_ring.slot_count)
+    {
+        return PULL_RING_FULL;
+    }
+
+    p_slot = ring_slot_get(m_ring.head);
+    p_hdr  = (evt_slot_hdr_t *)p_slot;
+
+    switch (source)
+    {
+        case EVT_SOURCE_SOC:
+            err_code   = sd_evt_get(&p_slot[1]);
+            p_hdr->len = sizeof(uint32_t);
+            break;
+
+#ifdef BLE_STACK_SUPPORT_REQD
+        case EVT_SOURCE_BLE:
+        {
+            uint16_t evt_len = (SOFTDEVICE_EVT_RING_SLOT_WORDS - 1) * sizeof(uint32_t);
+
+            err_code   = sd_ble_evt_get((uint8_t *)&p_slot[1], &evt_len);
+            p_hdr->len = evt_len;
+            break;
+        }
+#endif
+
+#ifdef ANT_STACK_SUPPORT_REQD
+        case EVT_SOURCE_ANT:
+        {
+            ant_evt_t * p_ant_evt = (ant_evt_t *)&p_slot[1];
+
+            err_code   = sd_ant_event_get(&p_ant_evt->channel,
+                                          &p_ant_evt->event,
+                                          p_ant_evt->msg.evt_buffer);
+            p_hdr->len = sizeof(ant_evt_t);
+            break;
+        }
+#endif
+
+        default:
+            return PULL_DONE;
+    }
+
+    if (err_code == NRF_ERROR_NOT_FOUND)
+    {
+        return PULL_DONE;
+    }
+    else if (err_code != NRF_SUCCESS)
+    {
+        APP_ERROR_HANDLER(err_code);
+        return PULL_DONE;
+    }
+
+    p_hdr->source = (uint8_t)source;
+    m_ring.head++;
+
+    if (count + 1 > m_ring.stats.high_water)
+    {
+        m_ring.stats.high_water = count + 1;
+    }
+
+    return PULL_STORED;
+}
+
+
+/**@brief Function for pulling all pending events from the SoftDevice into the event ring.
+ *
+ * @details One event is taken from each source in turn, so that a burst from one source does not
+ *          fill the ring ahead of the other sources. Called from the stack event interrupt only.
+ */
+static void ring_fill(void)
+{
+    bool done[3];
+
+#if CLOCK_ENABLED
+    done[EVT_SOURCE_SOC] = false;
+#else
+    done[EVT_SOURCE_SOC] = (m_sys_evt_handler == NULL);
+#endif
+#ifdef BLE_STACK_SUPPORT_REQD
+    done[EVT_SOURCE_BLE] = (m_ble_evt_handler == NULL);
+#else
+    done[EVT_SOURCE_BLE] = true;
+#endif
+#ifdef ANT_STACK_SUPPORT_REQD
+    done[EVT_SOURCE_ANT] = (m_ant_evt_handler == NULL);
+#else
+    done[EVT_SOURCE_ANT] = true;
+#endif
+
+    while (!(done[EVT_SOURCE_SOC] && done[EVT_SOURCE_BLE] && done[EVT_SOURCE_ANT]))
+    {
+        for (uint32_t source = EVT_SOURCE_SOC; source <= EVT_SOURCE_ANT; source++)
+        {
+            if (done[source])
+            {
+                continue;
+            }
+
+            switch (ring_pull((evt_source_t)source))
+            {
+                case PULL_DONE:
+                    done[source] = true;
+                    break;
+
+                case PULL_RING_FULL:
+                    // Leave the rest in the SoftDevice until the dispatcher has freed slots.
+                    m_ring.refill_pending = true;
+                    m_ring.stats.deferred++;
+                    return;
+
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+
+/**@brief Function for passing events from the event ring to the application.
+ *
+ * @param[in] max_count  Maximum number of events to pass.
+ */
+static void ring_dispatch(uint16_t max_count)
+{
+    while ((max_count > 0) && (ring_count() > 0))
+    {
+        uint32_t       * p_slot = ring_slot_get(m_ring.tail);
+        evt_slot_hdr_t * p_hdr  = (evt_slot_hdr_t *)p_slot;
+
+        switch (p_hdr->source)
+        {
+            case EVT_SOURCE_SOC:
+#if CLOCK_ENABLED
+                nrf_drv_clock_on_soc_event(p_slot[1]);
+                if (m_sys_evt_handler)
+                {
+                    m_sys_evt_handler(p_slot[1]);
+                }
+#else
+                m_sys_evt_handler(p_slot[1]);
+#endif
+                break;
+
+#ifdef BLE_STACK_SUPPORT_REQD
+            case EVT_SOURCE_BLE:
+                m_ble_evt_handler((ble_evt_t *)&p_slot[1]);
+                break;
+#endif
+
+#ifdef ANT_STACK_SUPPORT_REQD
+            case EVT_SOURCE_ANT:
+                m_ant_evt_handler((ant_evt_t *)&p_slot[1]);
+                break;
+#endif
+
+            default:
+                break;
+        }
+
+        // Free the slot only after the handler has returned, the event is passed by reference.
+        m_ring.tail++;
+        m_ring.stats.dispatched++;
+        max_count--;
+    }
+}
+
+
+/**@brief Function for signalling the SoftDevice event interrupt, to pull the events that did not
+ *        fit in the ring.
+ */
+static void ring_refill_request(void)
+{
+#ifdef SOFTDEVICE_PRESENT
+    uint32_t err_code = sd_nvic_SetPendingIRQ((IRQn_Type)SOFTDEVICE_EVT_IRQ);
+    APP_ERROR_CHECK(err_code);
+#else
+    NVIC_SetPendingIRQ(SOFTDEVICE_EVT_IRQ);
+#endif
+}
+
+
+/**@brief Function for scheduling the dispatcher, unless it is already scheduled. */
+static void ring_dispatch_schedule(void)
+{
+    if (!m_ring.dispatch_scheduled)
+    {
+        uint32_t err_code;
+
+        m_ring.dispatch_scheduled = true;
+        err_code = m_evt_schedule_func();
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+
+/**@brief Function for handling the stack event interrupt when events are ring buffered. */
+static void ring_evt_irq_handle(void)
+{
+    if (!m_softdevice_enabled)
+    {
+        return;
+    }
+
+    m_ring.refill_pending = false;
+    ring_fill();
+
+    if (m_evt_schedule_func != NULL)
+    {
+        if (ring_count() > 0)
+        {
+            ring_dispatch_schedule();
+        }
+    }
+    else
+    {
+        // No thread context, dispatch from the interrupt.
+        for (;;)
+        {
+            ring_dispatch(m_ring.slot_count);
+
+            if (!m_ring.refill_pending)
+            {
+                break;
+            }
+
+            m_ring.refill_pending = false;
+            ring_fill();
+        }
+    }
+}
+
+
+/**@brief Function for dispatching one batch of ring buffered events from thread context. */
+static void ring_events_execute(void)
+{
+    m_ring.dispatch_scheduled = false;
+
+    ring_dispatch(m_ring.batch_size);
+
+    if (m_ring.refill_pending)
+    {
+        // The interrupt pulls the remaining events and schedules the dispatcher again.
+        m_ring.refill_pending = false;
+        ring_refill_request();
+    }
+    else if (ring_count() > 0)
+    {
+        // Let other scheduled work run before the next batch.
+        ring_dispatch_schedule();
+    }
+}
+
+
 void intern_softdevice_events_execute(void)
 {
     if (!m_softdevice_enabled)
@@ -115,6 +436,13 @@ void intern_softdevice_events_execute(void)
 
         return;
     }
+
+    if (m_ring.p_slots != NULL)
+    {
+        ring_events_execute();
+        return;
+    }
+
 #if CLOCK_ENABLED
     bool no_more_soc_evts = false;
 #else
@@ -302,6 +630,34 @@ uint32_t softdevice_handler_init(nrf_clock_lf_cfg_t	*           p_clock_lf_cfg,
 }
 
 
+uint32_t softdevice_handler_ring_init(uint32_t * p_buffer,
+                                      uint16_t   slot_count,
+                                      uint16_t   batch_size)
+{
+    VERIFY_PARAM_NOT_NULL(p_buffer);
+    VERIFY_TRUE(is_word_aligned(p_buffer), NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(IS_POWER_OF_TWO(slot_count) && (batch_size != 0), NRF_ERROR_INVALID_PARAM);
+    VERIFY_FALSE(m_softdevice_enabled, NRF_ERROR_INVALID_STATE);
+
+    memset(&m_ring, 0, sizeof(m_ring));
+
+    m_ring.p_slots    = p_buffer;
+    m_ring.slot_count = slot_count;
+    m_ring.batch_size = batch_size;
+
+    return NRF_SUCCESS;
+}
+
+
+void softdevice_handler_ring_stats_get(softdevice_handler_ring_stats_t * p_stats)
+{
+    if (p_stats != NULL)
+    {
+        *p_stats = m_ring.stats;
+    }
+}
+
+
 uint32_t softdevice_handler_sd_disable(void)
 {
     uint32_t err_code = sd_softdevice_disable();
@@ -352,7 +708,11 @@ uint32_t softdevice_sys_evt_handler_set(sys_evt_handler_t sys_evt_handler)
  */
 void SOFTDEVICE_EVT_IRQHandler(void)
 {
-    if (m_evt_schedule_func != NULL)
+    if (m_ring.p_slots != NULL)
+    {
+        ring_evt_irq_handle();
+    }
+    else if (m_evt_schedule_func != NULL)
     {
         uint32_t err_code = m_evt_schedule_func();
         APP_ERROR_CHECK(err_code);
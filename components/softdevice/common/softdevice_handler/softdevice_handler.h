@@ -46,6 +46,13 @@
 #define SOFTDEVICE_SCHED_EVT_SIZE       0                                                 /**< Size of button events being passed through the scheduler (is to be used for computing the maximum size of scheduler events). For SoftDevice events, this size is 0, since the events are being pulled in the event handler. */
 #define SYS_EVT_MSG_BUF_SIZE            sizeof(uint32_t)                                  /**< Size of System (SOC) event message buffer. */
 
+/**@brief Size of one slot of the event ring, in words. A slot holds a header word followed by the
+ *        largest System (SOC), BLE or ANT event. */
+#define SOFTDEVICE_EVT_RING_SLOT_WORDS                                                             \
+    (1 + CEIL_DIV(MAX(MAX(BLE_STACK_EVT_MSG_BUF_SIZE, ANT_STACK_EVT_STRUCT_SIZE),                   \
+                      SYS_EVT_MSG_BUF_SIZE),                                                       \
+                  sizeof(uint32_t)))
+
 
 #define CHECK_RAM_START_ADDR_INTERN(CENTRAL_LINK_COUNT, PERIPHERAL_LINK_COUNT)              \
     do{                                                                                     \
@@ -72,6 +79,14 @@ typedef uint32_t (*softdevice_evt_schedule_func_t) (void);
 /**@brief Application System (SOC) event handler type. */
 typedef void (*sys_evt_handler_t) (uint32_t evt_id);
 
+/**@brief Event ring statistics. */
+typedef struct
+{
+    uint16_t high_water;    /**< Highest number of events held in the ring at once. */
+    uint32_t deferred;      /**< Number of times the ring was full while pulling. The remaining events were left in the SoftDevice and pulled once slots were freed. */
+    uint32_t dispatched;    /**< Number of events passed to the application. */
+} softdevice_handler_ring_stats_t;
+
 
 /**@brief     Macro for initializing the stack event handler.
  *
@@ -101,6 +116,37 @@ typedef void (*sys_evt_handler_t) (uint32_t evt_id);
         APP_ERROR_CHECK(ERR_CODE);                                                                 \
     } while (0)
 
+/**@brief     Macro for initializing the stack event handler with an event ring.
+ *
+ * @details   In this mode, all events pending in the SoftDevice are pulled into a ring of event
+ *            slots in the stack event interrupt, taking one System (SOC), BLE and ANT event in
+ *            turn. The events are then passed to the application from EVT_HANDLER (thread
+ *            context), at most BATCH_SIZE at a time, so that a slow handler does not hold back
+ *            pulling events from the SoftDevice.
+ *
+ * @param[in] CLOCK_SOURCE     Low frequency clock source and accuracy (type nrf_clock_lf_cfg_t_t,
+ *                             see sd_softdevice_enable() for details).
+ * @param[in] RING_SIZE        Number of event slots in the ring. Must be a power of two.
+ * @param[in] BATCH_SIZE       Maximum number of events dispatched each time EVT_HANDLER runs.
+ * @param[in] EVT_HANDLER      scheduler/RTOS event handler function. If NULL, events are
+ *                             dispatched from the stack event interrupt handler.
+ *
+ * @note      Like @ref SOFTDEVICE_HANDLER_INIT, this macro allocates buffers and must only be called
+ *            from one location.
+ */
+#define SOFTDEVICE_HANDLER_RING_INIT(CLOCK_SOURCE,                                                 \
+                                     RING_SIZE,                                                    \
+                                     BATCH_SIZE,                                                   \
+                                     EVT_HANDLER)                                                  \
+    do                                                                                             \
+    {                                                                                              \
+        static uint32_t EVT_RING[(RING_SIZE) * SOFTDEVICE_EVT_RING_SLOT_WORDS];                    \
+        uint32_t RING_ERR_CODE;                                                                    \
+        RING_ERR_CODE = softdevice_handler_ring_init(EVT_RING, (RING_SIZE), (BATCH_SIZE));         \
+        APP_ERROR_CHECK(RING_ERR_CODE);                                                            \
+        SOFTDEVICE_HANDLER_INIT(CLOCK_SOURCE, EVT_HANDLER);                                        \
+    } while (0)
+
 /**
  * @brief Function for retrieving the information about SD state
  *
@@ -143,6 +189,33 @@ uint32_t softdevice_handler_init(nrf_clock_lf_cfg_t *              p_clock_lf_cf
                                  softdevice_evt_schedule_func_t    evt_schedule_func);
 
 
+/**@brief      Function for setting up the event ring.
+ *
+ * @details    Normally this is done using the @ref SOFTDEVICE_HANDLER_RING_INIT macro.
+ *
+ * @param[in]  p_buffer    Buffer of slot_count * @ref SOFTDEVICE_EVT_RING_SLOT_WORDS words.
+ * @param[in]  slot_count  Number of event slots in the ring. Must be a power of two.
+ * @param[in]  batch_size  Maximum number of events dispatched per call of the scheduler/RTOS
+ *                         event handler.
+ *
+ * @retval     NRF_SUCCESS               The ring was set up.
+ * @retval     NRF_ERROR_NULL            p_buffer was NULL.
+ * @retval     NRF_ERROR_INVALID_PARAM   Buffer not word aligned, slot_count not a power of two, or
+ *                                       batch_size is 0.
+ * @retval     NRF_ERROR_INVALID_STATE   The SoftDevice has already been enabled.
+ */
+uint32_t softdevice_handler_ring_init(uint32_t * p_buffer,
+                                      uint16_t   slot_count,
+                                      uint16_t   batch_size);
+
+
+/**@brief     Function for getting the event ring statistics.
+ *
+ * @param[out] p_stats  Statistics since the ring was set up.
+ */
+void softdevice_handler_ring_stats_get(softdevice_handler_ring_stats_t * p_stats);
+
+
 /**@brief     Function for disabling the SoftDevice.
  *
  * @details   This function will disable the SoftDevice. It will also update the internal state
@@ -22,5 +22,5 @@ void softdevice_evt_get(void * p_event_data, uint16_t event_size)
 
 uint32_t softdevice_evt_schedule(void)
 {
-    return app_sched_event_put(NULL, 0, softdevice_evt_get);
+    return app_sched_event_put_prio(NULL, 0, softdevice_evt_get, APP_SCHED_PRIORITY_HIGHEST);
 }
@@ -0,0 +1,68 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "softdevice_handler_freertos.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "nrf.h"
+#include "nordic_common.h"
+
+static TaskHandle_t m_softdevice_task;  /**< Task pulling SoftDevice events. */
+
+
+static void softdevice_task(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    for (;;)
+    {
+        // Wakeups given while the events are executed are collapsed into one more pass.
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        intern_softdevice_events_execute();
+    }
+}
+
+
+uint32_t softdevice_handler_freertos_task_create(uint16_t stack_depth, UBaseType_t priority)
+{
+    if (xTaskCreate(softdevice_task, "SD", stack_depth, NULL, priority, &m_softdevice_task)
+        != pdPASS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t softdevice_evt_freertos_schedule(void)
+{
+    if (m_softdevice_task == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (__get_IPSR() != 0)
+    {
+        BaseType_t yield_req = pdFALSE;
+
+        vTaskNotifyGiveFromISR(m_softdevice_task, &yield_req);
+        portYIELD_FROM_ISR(yield_req);
+    }
+    else
+    {
+        // Called from the task itself when events are dispatched in batches.
+        (void) xTaskNotifyGive(m_softdevice_task);
+    }
+
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SOFTDEVICE_HANDLER_FREERTOS_H
+#define SOFTDEVICE_HANDLER_FREERTOS_H
+
+#include "softdevice_handler.h"
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+/**@brief Macro for initializing the stack event handler with events pulled by a FreeRTOS task.
+ *
+ * @details @ref softdevice_handler_freertos_task_create must be called before this macro, so that
+ *          events raised while the SoftDevice is being enabled have a task to wake up.
+ */
+#define SOFTDEVICE_HANDLER_FREERTOS_INIT(CLOCK_SOURCE) \
+    SOFTDEVICE_HANDLER_INIT(CLOCK_SOURCE, softdevice_evt_freertos_schedule)
+
+/**@brief Macro for initializing the stack event handler with events pulled into a ring by the
+ *        stack event interrupt, and dispatched by a FreeRTOS task.
+ *
+ * @details The task passes at most BATCH_SIZE events per pass, and wakes itself again while
+ *          events are left. See @ref SOFTDEVICE_HANDLER_RING_INIT.
+ *          @ref softdevice_handler_freertos_task_create must be called before this macro.
+ */
+#define SOFTDEVICE_HANDLER_FREERTOS_RING_INIT(CLOCK_SOURCE, RING_SIZE, BATCH_SIZE) \
+    SOFTDEVICE_HANDLER_RING_INIT(CLOCK_SOURCE, RING_SIZE, BATCH_SIZE, softdevice_evt_freertos_schedule)
+
+/**@brief Function for creating the task that pulls SoftDevice events.
+ *
+ * @details The task sleeps until the stack event interrupt wakes it, then calls the registered
+ *          SOC, BLE and ANT event handlers.
+ *
+ * @param[in] stack_depth  Stack size of the task, in words.
+ * @param[in] priority     Priority of the task.
+ *
+ * @retval NRF_SUCCESS       The task was created.
+ * @retval NRF_ERROR_NO_MEM  The FreeRTOS heap could not hold the task.
+ */
+uint32_t softdevice_handler_freertos_task_create(uint16_t stack_depth, UBaseType_t priority);
+
+/**@brief Function for waking up the SoftDevice event task. Passed to @ref softdevice_handler_init.
+ *
+ * @retval NRF_SUCCESS              The task was woken up.
+ * @retval NRF_ERROR_INVALID_STATE  The task has not been created.
+ */
+uint32_t softdevice_evt_freertos_schedule(void);
+
+#endif //SOFTDEVICE_HANDLER_FREERTOS_H
@@ -0,0 +1,730 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "sd_sim_internal.h"
+#include "sdk_common.h"
+#include "ble_hci.h"
+
+#define DEFAULT_CONN_INTERVAL       6           /**< 7.5 ms (in 1.25 ms units). */
+#define DEFAULT_TX_BUFFER_COUNT     7
+#define DEFAULT_PACKETS_PER_EVENT   6
+#define CONN_SUP_TIMEOUT            400         /**< 4 s (in 10 ms units). */
+#define PUMP_CALLS_MAX              16          /**< Calls of the event pump per step when events are not pulled. */
+#define SCRIPT_LINE_MAX             128
+
+/**@brief Periodic timer. */
+typedef struct
+{
+    sd_sim_timer_handler_t handler;
+    void                 * p_context;
+    uint64_t               period_us;
+    uint64_t               next_us;
+} sim_timer_t;
+
+sd_sim_t           g_sd_sim;
+static sim_timer_t m_timers[SD_SIM_TIMER_MAX];
+static uint8_t     m_timer_count;
+
+
+/**@brief Function for getting the number of BLE events waiting to be pulled. */
+static uint16_t ble_evts_pending(void)
+{
+    return (uint16_t)(g_sd_sim.ble_evt_tail - g_sd_sim.ble_evt_head);
+}
+
+
+/**@brief Function for getting the number of SoC events waiting to be pulled. */
+static uint16_t soc_evts_pending(void)
+{
+    return (uint16_t)(g_sd_sim.soc_evt_tail - g_sd_sim.soc_evt_head);
+}
+
+
+void sd_sim_ble_evt_put(ble_evt_t * p_evt, uint16_t len)
+{
+    uint16_t pending = ble_evts_pending();
+
+    if ((pending >= SD_SIM_BLE_EVT_QUEUE_SIZE) || (len > (SD_SIM_BLE_EVT_WORDS * sizeof(uint32_t))))
+    {
+        g_sd_sim.stats.evt_queue_overflows++;
+        return;
+    }
+
+    p_evt->header.evt_len = len;
+    memcpy(g_sd_sim.ble_evts[g_sd_sim.ble_evt_tail % SD_SIM_BLE_EVT_QUEUE_SIZE], p_evt, len);
+    g_sd_sim.ble_evt_tail++;
+
+    pending++;
+    if (pending > g_sd_sim.stats.evt_queue_high_water)
+    {
+        g_sd_sim.stats.evt_queue_high_water = pending;
+    }
+}
+
+
+void sd_sim_soc_evt_put(uint32_t evt_id)
+{
+    if (soc_evts_pending() >= SD_SIM_SOC_EVT_QUEUE_SIZE)
+    {
+        g_sd_sim.stats.evt_queue_overflows++;
+        return;
+    }
+
+    g_sd_sim.soc_evts[g_sd_sim.soc_evt_tail % SD_SIM_SOC_EVT_QUEUE_SIZE] = evt_id;
+    g_sd_sim.soc_evt_tail++;
+}
+
+
+/**@brief Function for getting the host time in nanoseconds. */
+static uint64_t host_time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+
+/**@brief Function for calling the event pump while it pulls events.
+ *
+ * @details An event pump that only schedules the pulling, for example through the
+ *          @ref app_scheduler, is called a limited number of times.
+ */
+static void evt_pump(void)
+{
+    uint32_t calls = 0;
+
+    if (g_sd_sim.evt_pump == NULL)
+    {
+        return;
+    }
+
+    while (((ble_evts_pending() != 0) || (soc_evts_pending() != 0)) && (calls < PUMP_CALLS_MAX))
+    {
+        uint64_t start = host_time_ns();
+        uint64_t elapsed;
+
+        g_sd_sim.evt_pump();
+
+        elapsed = host_time_ns() - start;
+        g_sd_sim.stats.pump_calls++;
+        g_sd_sim.stats.pump_time_ns += elapsed;
+        if (elapsed > g_sd_sim.stats.pump_time_max_ns)
+        {
+            g_sd_sim.stats.pump_time_max_ns = elapsed;
+        }
+        calls++;
+    }
+}
+
+
+/**@brief Function for getting the connection interval in microseconds. */
+static uint64_t conn_interval_us(void)
+{
+    return (uint64_t)g_sd_sim.conn_params.max_conn_interval * UNIT_1_25_MS;
+}
+
+
+void sd_sim_init(sd_sim_link_cfg_t const * p_link_cfg, sd_sim_evt_pump_t evt_pump)
+{
+    memset(&g_sd_sim, 0, sizeof(g_sd_sim));
+    memset(m_timers, 0, sizeof(m_timers));
+    m_timer_count = 0;
+
+    if (p_link_cfg != NULL)
+    {
+        g_sd_sim.link_cfg = *p_link_cfg;
+    }
+    else
+    {
+        g_sd_sim.link_cfg.conn_interval            = DEFAULT_CONN_INTERVAL;
+        g_sd_sim.link_cfg.tx_buffer_count          = DEFAULT_TX_BUFFER_COUNT;
+        g_sd_sim.link_cfg.packets_per_event        = DEFAULT_PACKETS_PER_EVENT;
+        g_sd_sim.link_cfg.accept_conn_param_update = true;
+    }
+
+    if (g_sd_sim.link_cfg.tx_buffer_count > SD_SIM_TX_QUEUE_SIZE)
+    {
+        g_sd_sim.link_cfg.tx_buffer_count = SD_SIM_TX_QUEUE_SIZE;
+    }
+    if (g_sd_sim.link_cfg.packets_per_event == 0)
+    {
+        g_sd_sim.link_cfg.packets_per_event = 1;
+    }
+
+    g_sd_sim.evt_pump         = evt_pump;
+    g_sd_sim.rand_state       = 0x2545F491;
+    g_sd_sim.sys_attr_missing = true;
+
+    g_sd_sim.addr.addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+    for (uint8_t i = 0; i < BLE_GAP_ADDR_LEN; i++)
+    {
+        g_sd_sim.addr.addr[i] = 0x10 + i;
+    }
+    g_sd_sim.addr.addr[BLE_GAP_ADDR_LEN - 1] |= 0xC0;
+
+    sd_sim_soc_reset();
+}
+
+
+uint32_t sd_sim_timer_add(uint32_t period_ms, sd_sim_timer_handler_t handler, void * p_context)
+{
+    sim_timer_t * p_timer;
+
+    if ((handler == NULL) || (period_ms == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (m_timer_count >= SD_SIM_TIMER_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_timer            = &m_timers[m_timer_count++];
+    p_timer->handler   = handler;
+    p_timer->p_context = p_context;
+    p_timer->period_us = (uint64_t)period_ms * 1000;
+    p_timer->next_us   = g_sd_sim.now_us + p_timer->period_us;
+
+    return NRF_SUCCESS;
+}
+
+
+void sd_sim_conn_event_run(void)
+{
+    uint8_t     budget      = g_sd_sim.link_cfg.packets_per_event;
+    uint8_t     tx_complete = 0;
+    uint32_t    evt_buf[SD_SIM_BLE_EVT_WORDS];
+    ble_evt_t * p_evt       = (ble_evt_t *)evt_buf;
+
+    g_sd_sim.stats.conn_events++;
+
+    if ((g_sd_sim.update_countdown != 0) && (--g_sd_sim.update_countdown == 0))
+    {
+        g_sd_sim.conn_params = g_sd_sim.update_params;
+
+        memset(p_evt, 0, sizeof(ble_evt_t));
+        p_evt->header.evt_id                                    = BLE_GAP_EVT_CONN_PARAM_UPDATE;
+        p_evt->evt.gap_evt.conn_handle                          = SD_SIM_CONN_HANDLE;
+        p_evt->evt.gap_evt.params.conn_param_update.conn_params = g_sd_sim.conn_params;
+        sd_sim_ble_evt_put(p_evt, sizeof(ble_evt_t));
+    }
+
+    // Central to peripheral.
+    while ((g_sd_sim.write_count != 0) && (budget != 0))
+    {
+        if (!sd_sim_gatts_write(&g_sd_sim.writes[g_sd_sim.write_head]))
+        {
+            break;
+        }
+        g_sd_sim.write_head = (g_sd_sim.write_head + 1) % SD_SIM_WRITE_QUEUE_SIZE;
+        g_sd_sim.write_count--;
+        budget--;
+    }
+
+    // Peripheral to central.
+    budget = g_sd_sim.link_cfg.packets_per_event;
+    while ((g_sd_sim.tx_count != 0) && (budget != 0))
+    {
+        sd_sim_tx_t * p_tx = &g_sd_sim.tx[g_sd_sim.tx_head];
+
+        g_sd_sim.stats.notifications++;
+        g_sd_sim.stats.notification_bytes += p_tx->len;
+        g_sd_sim.stats.tx_latency_us      += g_sd_sim.now_us - p_tx->queued_us;
+
+        if (p_tx->type == BLE_GATT_HVX_INDICATION)
+        {
+            memset(p_evt, 0, sizeof(ble_evt_t));
+            p_evt->header.evt_id                   = BLE_GATTS_EVT_HVC;
+            p_evt->evt.gatts_evt.conn_handle       = SD_SIM_CONN_HANDLE;
+            p_evt->evt.gatts_evt.params.hvc.handle = p_tx->handle;
+            sd_sim_ble_evt_put(p_evt, sizeof(ble_evt_t));
+
+            g_sd_sim.indication_pending = false;
+        }
+        else
+        {
+            tx_complete++;
+        }
+
+        g_sd_sim.tx_head = (g_sd_sim.tx_head + 1) % SD_SIM_TX_QUEUE_SIZE;
+        g_sd_sim.tx_count--;
+        budget--;
+    }
+
+    if (tx_complete != 0)
+    {
+        memset(p_evt, 0, sizeof(ble_evt_t));
+        p_evt->header.evt_id                           = BLE_EVT_TX_COMPLETE;
+        p_evt->evt.common_evt.conn_handle              = SD_SIM_CONN_HANDLE;
+        p_evt->evt.common_evt.params.tx_complete.count = tx_complete;
+        sd_sim_ble_evt_put(p_evt, sizeof(ble_evt_t));
+    }
+}
+
+
+/**@brief Function for timing out advertising. */
+static void adv_timeout(void)
+{
+    ble_evt_t evt;
+
+    g_sd_sim.advertising    = false;
+    g_sd_sim.adv_timeout_us = 0;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                  = BLE_GAP_EVT_TIMEOUT;
+    evt.evt.gap_evt.conn_handle        = BLE_CONN_HANDLE_INVALID;
+    evt.evt.gap_evt.params.timeout.src = BLE_GAP_TIMEOUT_SRC_ADVERTISING;
+    sd_sim_ble_evt_put(&evt, sizeof(evt));
+}
+
+
+void sd_sim_run(uint32_t duration_ms)
+{
+    uint64_t end_us = g_sd_sim.now_us + ((uint64_t)duration_ms * 1000);
+
+    evt_pump();
+
+    for (;;)
+    {
+        uint64_t next_us = end_us;
+
+        if (g_sd_sim.connected)
+        {
+            next_us = MIN(next_us, g_sd_sim.next_conn_event_us);
+        }
+        if (g_sd_sim.advertising && (g_sd_sim.adv_timeout_us != 0))
+        {
+            next_us = MIN(next_us, g_sd_sim.adv_timeout_us);
+        }
+        for (uint8_t i = 0; i < m_timer_count; i++)
+        {
+            next_us = MIN(next_us, m_timers[i].next_us);
+        }
+
+        g_sd_sim.now_us = next_us;
+
+        if (g_sd_sim.connected && (g_sd_sim.next_conn_event_us == next_us))
+        {
+            sd_sim_conn_event_run();
+            g_sd_sim.next_conn_event_us += conn_interval_us();
+        }
+        if (g_sd_sim.advertising && (g_sd_sim.adv_timeout_us != 0) && (g_sd_sim.adv_timeout_us == next_us))
+        {
+            adv_timeout();
+        }
+        for (uint8_t i = 0; i < m_timer_count; i++)
+        {
+            if (m_timers[i].next_us == next_us)
+            {
+                m_timers[i].next_us += m_timers[i].period_us;
+                m_timers[i].handler(m_timers[i].p_context);
+            }
+        }
+
+        evt_pump();
+
+        if (next_us >= end_us)
+        {
+            break;
+        }
+    }
+}
+
+
+uint32_t sd_sim_now_ms(void)
+{
+    return (uint32_t)(g_sd_sim.now_us / 1000);
+}
+
+
+void sd_sim_stats_get(sd_sim_stats_t * p_stats)
+{
+    if (p_stats != NULL)
+    {
+        *p_stats = g_sd_sim.stats;
+    }
+}
+
+
+uint32_t sd_sim_central_connect(void)
+{
+    ble_evt_t evt;
+
+    if (!g_sd_sim.advertising || g_sd_sim.connected)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    g_sd_sim.advertising    = false;
+    g_sd_sim.adv_timeout_us = 0;
+    g_sd_sim.connected      = true;
+
+    g_sd_sim.conn_params.min_conn_interval = g_sd_sim.link_cfg.conn_interval;
+    g_sd_sim.conn_params.max_conn_interval = g_sd_sim.link_cfg.conn_interval;
+    g_sd_sim.conn_params.slave_latency     = 0;
+    g_sd_sim.conn_params.conn_sup_timeout  = CONN_SUP_TIMEOUT;
+
+    g_sd_sim.next_conn_event_us = g_sd_sim.now_us + conn_interval_us();
+    g_sd_sim.tx_head            = 0;
+    g_sd_sim.tx_count           = 0;
+    g_sd_sim.indication_pending = false;
+    g_sd_sim.write_head         = 0;
+    g_sd_sim.write_count        = 0;
+    g_sd_sim.update_countdown   = 0;
+    g_sd_sim.pairing            = false;
+
+    memset(&g_sd_sim.conn_sec, 0, sizeof(g_sd_sim.conn_sec));
+    g_sd_sim.conn_sec.sec_mode.sm = 1;
+    g_sd_sim.conn_sec.sec_mode.lv = 1;
+
+    sd_sim_gatts_conn_reset();
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                                    = BLE_GAP_EVT_CONNECTED;
+    evt.evt.gap_evt.conn_handle                          = SD_SIM_CONN_HANDLE;
+    evt.evt.gap_evt.params.connected.peer_addr.addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+    evt.evt.gap_evt.params.connected.own_addr            = g_sd_sim.addr;
+    evt.evt.gap_evt.params.connected.role                = BLE_GAP_ROLE_PERIPH;
+    evt.evt.gap_evt.params.connected.conn_params         = g_sd_sim.conn_params;
+    memset(evt.evt.gap_evt.params.connected.peer_addr.addr, 0xC5, BLE_GAP_ADDR_LEN);
+    sd_sim_ble_evt_put(&evt, sizeof(evt));
+
+    evt_pump();
+
+    return NRF_SUCCESS;
+}
+
+
+void sd_sim_link_down(uint8_t reason)
+{
+    ble_evt_t evt;
+
+    g_sd_sim.connected          = false;
+    g_sd_sim.tx_count           = 0;
+    g_sd_sim.write_count        = 0;
+    g_sd_sim.indication_pending = false;
+    g_sd_sim.update_countdown   = 0;
+    g_sd_sim.pairing            = false;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                          = BLE_GAP_EVT_DISCONNECTED;
+    evt.evt.gap_evt.conn_handle                = SD_SIM_CONN_HANDLE;
+    evt.evt.gap_evt.params.disconnected.reason = reason;
+    sd_sim_ble_evt_put(&evt, sizeof(evt));
+}
+
+
+uint32_t sd_sim_central_disconnect(void)
+{
+    if (!g_sd_sim.connected)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    sd_sim_link_down(BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    evt_pump();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_sim_central_write(uint16_t        handle,
+                              uint8_t const * p_data,
+                              uint16_t        len,
+                              bool            with_response)
+{
+    sd_sim_write_t * p_write;
+
+    if (!g_sd_sim.connected)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if ((sd_sim_attr_get(handle) == NULL) || (len > SD_SIM_ATT_PAYLOAD_MAX) || ((p_data == NULL) && (len != 0)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (g_sd_sim.write_count >= SD_SIM_WRITE_QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_write = &g_sd_sim.writes[(g_sd_sim.write_head + g_sd_sim.write_count) % SD_SIM_WRITE_QUEUE_SIZE];
+    p_write->handle        = handle;
+    p_write->len           = len;
+    p_write->with_response = with_response;
+    if (len != 0)
+    {
+        memcpy(p_write->data, p_data, len);
+    }
+    g_sd_sim.write_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+void sd_sim_pairing_start(bool bond)
+{
+    ble_evt_t              evt;
+    ble_gap_sec_params_t * p_peer_params;
+
+    g_sd_sim.pairing      = true;
+    g_sd_sim.pairing_bond = bond;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id           = BLE_GAP_EVT_SEC_PARAMS_REQUEST;
+    evt.evt.gap_evt.conn_handle = SD_SIM_CONN_HANDLE;
+
+    p_peer_params = &evt.evt.gap_evt.params.sec_params_request.peer_params;
+    p_peer_params->bond           = bond;
+    p_peer_params->io_caps        = BLE_GAP_IO_CAPS_NONE;
+    p_peer_params->min_key_size   = 7;
+    p_peer_params->max_key_size   = 16;
+    p_peer_params->kdist_own.enc  = bond;
+    p_peer_params->kdist_own.id   = bond;
+    p_peer_params->kdist_peer.enc = bond;
+    p_peer_params->kdist_peer.id  = bond;
+    sd_sim_ble_evt_put(&evt, sizeof(evt));
+}
+
+
+uint32_t sd_sim_central_pair(bool bond)
+{
+    if (!g_sd_sim.connected)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    sd_sim_pairing_start(bond);
+    evt_pump();
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for skipping white space in a script line. */
+static char const * skip_space(char const * p_str)
+{
+    while ((*p_str != '\0') && isspace((unsigned char)*p_str))
+    {
+        p_str++;
+    }
+    return p_str;
+}
+
+
+/**@brief Function for parsing a script write target, a 16-bit UUID or #handle.
+ *
+ * @param[in,out] pp_str    Position in the line, advanced past the target.
+ * @param[out]    p_handle  Value handle.
+ */
+static uint32_t target_parse(char const ** pp_str, uint16_t * p_handle)
+{
+    char const  * p_str = skip_space(*pp_str);
+    char        * p_end;
+    unsigned long value;
+
+    if (*p_str == '#')
+    {
+        value = strtoul(p_str + 1, &p_end, 0);
+        VERIFY_TRUE(p_end != p_str + 1, NRF_ERROR_INVALID_PARAM);
+        *p_handle = (uint16_t)value;
+    }
+    else
+    {
+        value = strtoul(p_str, &p_end, 16);
+        VERIFY_TRUE(p_end != p_str, NRF_ERROR_INVALID_PARAM);
+        *p_handle = sd_sim_value_handle_find((uint16_t)value);
+        VERIFY_TRUE(*p_handle != BLE_GATT_HANDLE_INVALID, NRF_ERROR_NOT_FOUND);
+    }
+
+    *pp_str = p_end;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for parsing hexadecimal data, optionally separated by spaces or ':'. */
+static uint32_t hex_parse(char const * p_str, uint8_t * p_data, uint16_t * p_len)
+{
+    uint16_t len = 0;
+
+    for (;;)
+    {
+        char byte[3];
+        char * p_end;
+
+        while ((*p_str == ':') || isspace((unsigned char)*p_str))
+        {
+            p_str++;
+        }
+        if (*p_str == '\0')
+        {
+            break;
+        }
+
+        VERIFY_TRUE(isxdigit((unsigned char)p_str[0]) && isxdigit((unsigned char)p_str[1]),
+                    NRF_ERROR_INVALID_PARAM);
+        VERIFY_TRUE(len < SD_SIM_ATT_PAYLOAD_MAX, NRF_ERROR_INVALID_PARAM);
+
+        byte[0] = p_str[0];
+        byte[1] = p_str[1];
+        byte[2] = '\0';
+        p_data[len++] = (uint8_t)strtoul(byte, &p_end, 16);
+        p_str += 2;
+    }
+
+    *p_len = len;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for writing the CCCD of a characteristic from a script. */
+static uint32_t cccd_write(char const * p_args, uint16_t value)
+{
+    char        * p_end;
+    unsigned long uuid = strtoul(skip_space(p_args), &p_end, 16);
+    uint16_t      handle;
+    uint8_t       data[2];
+
+    VERIFY_TRUE(p_end != skip_space(p_args), NRF_ERROR_INVALID_PARAM);
+
+    handle = sd_sim_cccd_handle_find((uint16_t)uuid);
+    VERIFY_TRUE(handle != BLE_GATT_HANDLE_INVALID, NRF_ERROR_NOT_FOUND);
+
+    (void)uint16_encode(value, data);
+    return sd_sim_central_write(handle, data, sizeof(data), true);
+}
+
+
+/**@brief Function for running one script command. */
+static uint32_t command_run(char const * p_line)
+{
+    char const * p_args = p_line;
+    size_t       cmd_len;
+
+    while ((*p_args != '\0') && !isspace((unsigned char)*p_args))
+    {
+        p_args++;
+    }
+    cmd_len = (size_t)(p_args - p_line);
+
+#define CMD_IS(NAME) ((cmd_len == (sizeof(NAME) - 1)) && (strncmp(p_line, NAME, cmd_len) == 0))
+
+    if (cmd_len == 0)
+    {
+        return NRF_SUCCESS;
+    }
+    else if (CMD_IS("connect"))
+    {
+        return sd_sim_central_connect();
+    }
+    else if (CMD_IS("disconnect"))
+    {
+        return sd_sim_central_disconnect();
+    }
+    else if (CMD_IS("interval"))
+    {
+        char * p_end;
+        double ms = strtod(p_args, &p_end);
+
+        VERIFY_TRUE((p_end != p_args) && (ms >= 7.5) && (ms <= 4000), NRF_ERROR_INVALID_PARAM);
+        g_sd_sim.link_cfg.conn_interval = (uint16_t)((ms * 1000 / UNIT_1_25_MS) + 0.5);
+        return NRF_SUCCESS;
+    }
+    else if (CMD_IS("wait"))
+    {
+        char        * p_end;
+        unsigned long ms = strtoul(p_args, &p_end, 0);
+
+        VERIFY_TRUE(p_end != p_args, NRF_ERROR_INVALID_PARAM);
+        sd_sim_run((uint32_t)ms);
+        return NRF_SUCCESS;
+    }
+    else if (CMD_IS("write") || CMD_IS("writecmd"))
+    {
+        uint8_t  data[SD_SIM_ATT_PAYLOAD_MAX];
+        uint16_t len;
+        uint16_t handle;
+        uint32_t err_code;
+
+        err_code = target_parse(&p_args, &handle);
+        VERIFY_SUCCESS(err_code);
+        err_code = hex_parse(p_args, data, &len);
+        VERIFY_SUCCESS(err_code);
+
+        return sd_sim_central_write(handle, data, len, CMD_IS("write"));
+    }
+    else if (CMD_IS("subscribe"))
+    {
+        return cccd_write(p_args, BLE_GATT_HVX_NOTIFICATION);
+    }
+    else if (CMD_IS("indicate"))
+    {
+        return cccd_write(p_args, BLE_GATT_HVX_INDICATION);
+    }
+    else if (CMD_IS("unsubscribe"))
+    {
+        return cccd_write(p_args, 0);
+    }
+    else if (CMD_IS("pair"))
+    {
+        return sd_sim_central_pair(false);
+    }
+    else if (CMD_IS("bond"))
+    {
+        return sd_sim_central_pair(true);
+    }
+
+#undef CMD_IS
+
+    return NRF_ERROR_INVALID_PARAM;
+}
+
+
+uint32_t sd_sim_script_run(char const * p_script)
+{
+    VERIFY_PARAM_NOT_NULL(p_script);
+
+    while (*p_script != '\0')
+    {
+        char     line[SCRIPT_LINE_MAX];
+        size_t   len = strcspn(p_script, "\n;");
+        char   * p_comment;
+        uint32_t err_code;
+
+        VERIFY_TRUE(len < sizeof(line), NRF_ERROR_INVALID_PARAM);
+
+        memcpy(line, p_script, len);
+        line[len] = '\0';
+        p_script += len;
+        if (*p_script != '\0')
+        {
+            p_script++;
+        }
+
+        // Comments run to the end of the line.
+        p_comment = strstr(line, "//");
+        if (p_comment != NULL)
+        {
+            *p_comment = '\0';
+        }
+
+        err_code = command_run(skip_space(line));
+        VERIFY_SUCCESS(err_code);
+    }
+
+    return NRF_SUCCESS;
+}
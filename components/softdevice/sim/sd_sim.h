@@ -0,0 +1,206 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup sd_sim SoftDevice host emulator
+ * @{
+ * @ingroup  app_common
+ * @brief    In-memory implementation of the SoftDevice API for running BLE applications on a host.
+ *
+ * @details  The emulator implements the sd_ble_*, sd_ble_gap_*, sd_ble_gatts_*, sd_evt_get,
+ *           sd_flash_* and sd_ecb_* functions in memory, so that services and application event
+ *           handlers can be run and benchmarked on a PC. Compile the application and the
+ *           emulator with SVCALL_AS_NORMAL_FUNCTION defined, so that the SoftDevice headers
+ *           declare the API as ordinary functions.
+ *
+ *           A virtual central is connected to the emulated peripheral. It can connect, write,
+ *           subscribe to notifications and pair, either through the functions below or through a
+ *           script given to @ref sd_sim_script_run. Time is simulated: the link layer runs
+ *           connection events at the configured connection interval, delivers the central's
+ *           writes, carries a limited number of packets per event and reports
+ *           @ref BLE_EVT_TX_COMPLETE, with the configured number of TX buffers.
+ *
+ *           Events are passed to the application by calling the event pump given to
+ *           @ref sd_sim_init, typically the SoftDevice event interrupt handler of
+ *           @ref softdevice_handler. The time spent in the pump is measured, so that handler
+ *           latency can be tracked together with throughput in @ref sd_sim_stats_t.
+ *
+ * @note     The emulator handles one connection. Flash addresses given to sd_flash_* are offsets
+ *           into an emulated flash image, see @ref sd_sim_flash_ptr.
+ */
+
+#ifndef SD_SIM_H__
+#define SD_SIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "nrf_soc.h"
+
+#define SD_SIM_FLASH_SIZE         (512 * 1024)  /**< Size of the emulated flash. */
+#define SD_SIM_FLASH_PAGE_SIZE    4096          /**< Size of an emulated flash page. */
+#define SD_SIM_TIMER_MAX          8             /**< Maximum number of periodic timers. */
+
+/**@brief Link layer configuration. */
+typedef struct
+{
+    uint16_t conn_interval;             /**< Connection interval used by the central when connecting (in 1.25 ms units). */
+    uint8_t  tx_buffer_count;           /**< Number of packets the SoftDevice can hold for transmission. */
+    uint8_t  packets_per_event;         /**< Number of packets the link carries per connection event, in each direction. */
+    bool     accept_conn_param_update;  /**< The central accepts connection parameter update requests. */
+} sd_sim_link_cfg_t;
+
+/**@brief Function for passing pending events to the application. */
+typedef void (*sd_sim_evt_pump_t)(void);
+
+/**@brief Periodic timer handler, used to emulate application timers. */
+typedef void (*sd_sim_timer_handler_t)(void * p_context);
+
+/**@brief Emulator statistics. */
+typedef struct
+{
+    uint32_t conn_events;           /**< Connection events run. */
+    uint32_t notifications;         /**< Notifications and indications received by the central. */
+    uint32_t notification_bytes;    /**< Bytes of notification and indication data received by the central. */
+    uint32_t writes;                /**< Writes delivered from the central. */
+    uint32_t hvx_no_tx_packets;     /**< sd_ble_gatts_hvx calls rejected because all TX buffers were in use. */
+    uint32_t ble_evts;              /**< BLE events pulled by the application. */
+    uint32_t soc_evts;              /**< SoC events pulled by the application. */
+    uint16_t evt_queue_high_water;  /**< Highest number of BLE events waiting to be pulled. */
+    uint32_t evt_queue_overflows;   /**< BLE and SoC events lost because the application did not pull them. */
+    uint32_t pump_calls;            /**< Calls of the event pump. */
+    uint64_t pump_time_ns;          /**< Host time spent in the event pump. */
+    uint64_t pump_time_max_ns;      /**< Longest single call of the event pump. */
+    uint64_t tx_latency_us;         /**< Sum of simulated times from sd_ble_gatts_hvx to reception by the central. */
+} sd_sim_stats_t;
+
+/**@brief Function for initializing the emulator.
+ *
+ * @details Resets the attribute table, flash image, event queues and statistics.
+ *
+ * @param[in] p_link_cfg  Link layer configuration, or NULL for a 7.5 ms interval, 7 TX buffers,
+ *                        6 packets per event and accepted parameter updates.
+ * @param[in] evt_pump    Function called whenever events are pending.
+ */
+void sd_sim_init(sd_sim_link_cfg_t const * p_link_cfg, sd_sim_evt_pump_t evt_pump);
+
+/**@brief Function for adding a periodic timer.
+ *
+ * @param[in] period_ms  Timer period.
+ * @param[in] handler    Function called on each expiry.
+ * @param[in] p_context  Context passed to the handler.
+ *
+ * @retval NRF_SUCCESS       The timer was added.
+ * @retval NRF_ERROR_NO_MEM  @ref SD_SIM_TIMER_MAX timers have already been added.
+ */
+uint32_t sd_sim_timer_add(uint32_t period_ms, sd_sim_timer_handler_t handler, void * p_context);
+
+/**@brief Function for running the emulation.
+ *
+ * @param[in] duration_ms  Simulated time to run.
+ */
+void sd_sim_run(uint32_t duration_ms);
+
+/**@brief Function for getting the simulated time, in milliseconds since @ref sd_sim_init. */
+uint32_t sd_sim_now_ms(void);
+
+/**@brief Function for getting the emulator statistics. */
+void sd_sim_stats_get(sd_sim_stats_t * p_stats);
+
+/**@brief Function for getting a host pointer to the emulated flash.
+ *
+ * @param[in] address  Flash address.
+ *
+ * @return Pointer into the flash image, or NULL if the address is outside the flash.
+ */
+uint8_t * sd_sim_flash_ptr(uint32_t address);
+
+/**@brief Function for connecting the central to the advertising peripheral.
+ *
+ * @retval NRF_SUCCESS              Connected.
+ * @retval NRF_ERROR_INVALID_STATE  The peripheral is not advertising, or already connected.
+ */
+uint32_t sd_sim_central_connect(void);
+
+/**@brief Function for disconnecting the central.
+ *
+ * @retval NRF_SUCCESS              Disconnected.
+ * @retval NRF_ERROR_INVALID_STATE  Not connected.
+ */
+uint32_t sd_sim_central_disconnect(void);
+
+/**@brief Function for queuing a write from the central. The write is delivered at the next
+ *        connection event with room for it.
+ *
+ * @param[in] handle         Attribute handle.
+ * @param[in] p_data         Data to write.
+ * @param[in] len            Length of the data.
+ * @param[in] with_response  true for a Write Request, false for a Write Command.
+ *
+ * @retval NRF_SUCCESS              The write was queued.
+ * @retval NRF_ERROR_INVALID_STATE  Not connected.
+ * @retval NRF_ERROR_INVALID_PARAM  Unknown handle or data too long.
+ * @retval NRF_ERROR_NO_MEM         Too many writes queued.
+ */
+uint32_t sd_sim_central_write(uint16_t        handle,
+                              uint8_t const * p_data,
+                              uint16_t        len,
+                              bool            with_response);
+
+/**@brief Function for starting pairing from the central.
+ *
+ * @param[in] bond  Request bonding.
+ *
+ * @retval NRF_SUCCESS              A security parameters request was sent to the application.
+ * @retval NRF_ERROR_INVALID_STATE  Not connected.
+ */
+uint32_t sd_sim_central_pair(bool bond);
+
+/**@brief Function for finding the value handle of a characteristic by its 16-bit UUID.
+ *
+ * @return Handle, or BLE_GATT_HANDLE_INVALID if not found.
+ */
+uint16_t sd_sim_value_handle_find(uint16_t uuid);
+
+/**@brief Function for finding the CCCD handle of a characteristic by its 16-bit UUID.
+ *
+ * @return Handle, or BLE_GATT_HANDLE_INVALID if not found.
+ */
+uint16_t sd_sim_cccd_handle_find(uint16_t uuid);
+
+/**@brief Function for running a central script.
+ *
+ * @details The script holds one command per line (or separated by ';'):
+ *          - connect, disconnect
+ *          - interval MS: connection interval used by the next connect.
+ *          - wait MS: run the emulation.
+ *          - write TARGET HEX, writecmd TARGET HEX: Write Request or Write Command.
+ *          - subscribe UUID, indicate UUID, unsubscribe UUID: write the CCCD of a
+ *            characteristic.
+ *          - pair, bond
+ *
+ *          TARGET is a 16-bit characteristic UUID (0x2A53) or an attribute handle (#14). Text
+ *          following "//" is ignored.
+ *
+ * @param[in] p_script  Script, NUL terminated.
+ *
+ * @retval NRF_SUCCESS              The script was run.
+ * @retval NRF_ERROR_INVALID_PARAM  A line could not be parsed.
+ * @retval NRF_ERROR_NOT_FOUND      A characteristic was not found.
+ * @return Otherwise, the error returned by the failing command.
+ */
+uint32_t sd_sim_script_run(char const * p_script);
+
+#endif // SD_SIM_H__
+
+/** @} */
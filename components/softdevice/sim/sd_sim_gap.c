@@ -0,0 +1,735 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <string.h>
+#include "sd_sim_internal.h"
+#include "ble_hci.h"
+#include "nrf_error.h"
+
+#define UUID16_LEN              2
+#define UUID128_LEN             16
+#define UUID128_UUID16_OFFSET   12      /**< Offset of the 16-bit UUID in a 128-bit base UUID. */
+
+#define LL_VERSION_NUMBER       8       /**< Bluetooth 4.2. */
+#define COMPANY_ID_NORDIC       0x0059
+#define SUBVERSION_NUMBER       0x0081  /**< s132 v2.0.0. */
+
+
+/**@brief Function for checking the connection handle of a call. */
+static bool conn_handle_valid(uint16_t conn_handle)
+{
+    return g_sd_sim.connected && (conn_handle == SD_SIM_CONN_HANDLE);
+}
+
+
+uint32_t sd_ble_enable(ble_enable_params_t * p_ble_enable_params, uint32_t * p_app_ram_base)
+{
+    if ((p_ble_enable_params == NULL) || (p_app_ram_base == NULL))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (!g_sd_sim.enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    // RAM is not reserved on the host, the application RAM base is accepted as is.
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_evt_get(uint8_t * p_dest, uint16_t * p_len)
+{
+    ble_evt_t const * p_evt;
+
+    if (p_len == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (g_sd_sim.ble_evt_head == g_sd_sim.ble_evt_tail)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    p_evt = (ble_evt_t const *)g_sd_sim.ble_evts[g_sd_sim.ble_evt_head % SD_SIM_BLE_EVT_QUEUE_SIZE];
+
+    if (p_dest == NULL)
+    {
+        *p_len = p_evt->header.evt_len;
+        return NRF_SUCCESS;
+    }
+    if (*p_len < p_evt->header.evt_len)
+    {
+        *p_len = p_evt->header.evt_len;
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    *p_len = p_evt->header.evt_len;
+    memcpy(p_dest, p_evt, *p_len);
+    g_sd_sim.ble_evt_head++;
+    g_sd_sim.stats.ble_evts++;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_tx_packet_count_get(uint16_t conn_handle, uint8_t * p_count)
+{
+    UNUSED_PARAMETER(conn_handle);
+
+    if (p_count == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_count = g_sd_sim.link_cfg.tx_buffer_count;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * p_vs_uuid, uint8_t * p_uuid_type)
+{
+    if ((p_vs_uuid == NULL) || (p_uuid_type == NULL))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    for (uint8_t i = 0; i < g_sd_sim.vs_uuid_count; i++)
+    {
+        if (memcmp(&g_sd_sim.vs_uuids[i], p_vs_uuid, sizeof(ble_uuid128_t)) == 0)
+        {
+            *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN + i;
+            return NRF_SUCCESS;
+        }
+    }
+
+    if (g_sd_sim.vs_uuid_count >= SD_SIM_VS_UUID_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    g_sd_sim.vs_uuids[g_sd_sim.vs_uuid_count] = *p_vs_uuid;
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN + g_sd_sim.vs_uuid_count;
+    g_sd_sim.vs_uuid_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_uuid_decode(uint8_t uuid_le_len, uint8_t const * p_uuid_le, ble_uuid_t * p_uuid)
+{
+    if ((p_uuid_le == NULL) || (p_uuid == NULL))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (uuid_le_len == UUID16_LEN)
+    {
+        p_uuid->type = BLE_UUID_TYPE_BLE;
+        p_uuid->uuid = uint16_decode(p_uuid_le);
+        return NRF_SUCCESS;
+    }
+    if (uuid_le_len != UUID128_LEN)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    for (uint8_t i = 0; i < g_sd_sim.vs_uuid_count; i++)
+    {
+        uint8_t const * p_base = g_sd_sim.vs_uuids[i].uuid128;
+
+        if (   (memcmp(p_base, p_uuid_le, UUID128_UUID16_OFFSET) == 0)
+            && (memcmp(&p_base[UUID128_UUID16_OFFSET + UUID16_LEN],
+                       &p_uuid_le[UUID128_UUID16_OFFSET + UUID16_LEN],
+                       UUID128_LEN - UUID128_UUID16_OFFSET - UUID16_LEN) == 0))
+        {
+            p_uuid->type = BLE_UUID_TYPE_VENDOR_BEGIN + i;
+            p_uuid->uuid = uint16_decode(&p_uuid_le[UUID128_UUID16_OFFSET]);
+            return NRF_SUCCESS;
+        }
+    }
+
+    p_uuid->type = BLE_UUID_TYPE_UNKNOWN;
+    return NRF_ERROR_NOT_FOUND;
+}
+
+
+uint32_t sd_ble_uuid_encode(ble_uuid_t const * p_uuid, uint8_t * p_uuid_le_len, uint8_t * p_uuid_le)
+{
+    uint8_t vs_index;
+
+    if ((p_uuid == NULL) || (p_uuid_le_len == NULL))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (p_uuid->type == BLE_UUID_TYPE_BLE)
+    {
+        *p_uuid_le_len = UUID16_LEN;
+        if (p_uuid_le != NULL)
+        {
+            (void)uint16_encode(p_uuid->uuid, p_uuid_le);
+        }
+        return NRF_SUCCESS;
+    }
+
+    vs_index = p_uuid->type - BLE_UUID_TYPE_VENDOR_BEGIN;
+    if ((p_uuid->type < BLE_UUID_TYPE_VENDOR_BEGIN) || (vs_index >= g_sd_sim.vs_uuid_count))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *p_uuid_le_len = UUID128_LEN;
+    if (p_uuid_le != NULL)
+    {
+        memcpy(p_uuid_le, g_sd_sim.vs_uuids[vs_index].uuid128, UUID128_LEN);
+        (void)uint16_encode(p_uuid->uuid, &p_uuid_le[UUID128_UUID16_OFFSET]);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_version_get(ble_version_t * p_version)
+{
+    if (p_version == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    p_version->version_number    = LL_VERSION_NUMBER;
+    p_version->company_id        = COMPANY_ID_NORDIC;
+    p_version->subversion_number = SUBVERSION_NUMBER;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_user_mem_reply(uint16_t conn_handle, ble_user_mem_block_t const * p_block)
+{
+    UNUSED_PARAMETER(p_block);
+
+    return conn_handle_valid(conn_handle) ? NRF_SUCCESS : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+
+uint32_t sd_ble_opt_set(uint32_t opt_id, ble_opt_t const * p_opt)
+{
+    UNUSED_PARAMETER(opt_id);
+
+    // Options only change radio and security behavior that is not emulated.
+    return (p_opt != NULL) ? NRF_SUCCESS : NRF_ERROR_INVALID_ADDR;
+}
+
+
+uint32_t sd_ble_opt_get(uint32_t opt_id, ble_opt_t * p_opt)
+{
+    UNUSED_PARAMETER(opt_id);
+    UNUSED_PARAMETER(p_opt);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_address_set(uint8_t addr_cycle_mode, ble_gap_addr_t const * p_addr)
+{
+    UNUSED_PARAMETER(addr_cycle_mode);
+
+    if (p_addr == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    g_sd_sim.addr = *p_addr;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_address_get(ble_gap_addr_t * p_addr)
+{
+    if (p_addr == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_addr = g_sd_sim.addr;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_adv_data_set(uint8_t const * p_data,
+                                 uint8_t         dlen,
+                                 uint8_t const * p_sr_data,
+                                 uint8_t         srdlen)
+{
+    UNUSED_PARAMETER(p_data);
+    UNUSED_PARAMETER(p_sr_data);
+
+    if ((dlen > BLE_GAP_ADV_MAX_SIZE) || (srdlen > BLE_GAP_ADV_MAX_SIZE))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_adv_start(ble_gap_adv_params_t const * p_adv_params)
+{
+    if (p_adv_params == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (g_sd_sim.advertising || g_sd_sim.connected)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    g_sd_sim.advertising    = true;
+    g_sd_sim.adv_timeout_us = 0;
+    if (p_adv_params->timeout != 0)
+    {
+        g_sd_sim.adv_timeout_us = g_sd_sim.now_us + ((uint64_t)p_adv_params->timeout * 1000000);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_adv_stop(void)
+{
+    if (!g_sd_sim.advertising)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    g_sd_sim.advertising    = false;
+    g_sd_sim.adv_timeout_us = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_conn_param_update(uint16_t conn_handle, ble_gap_conn_params_t const * p_conn_params)
+{
+    if (!conn_handle_valid(conn_handle))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (g_sd_sim.update_countdown != 0)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    if (p_conn_params == NULL)
+    {
+        p_conn_params = &g_sd_sim.ppcp;
+    }
+
+    if (g_sd_sim.link_cfg.accept_conn_param_update)
+    {
+        // The central picks the shortest interval allowed.
+        g_sd_sim.update_params                   = *p_conn_params;
+        g_sd_sim.update_params.max_conn_interval = p_conn_params->min_conn_interval;
+    }
+    else
+    {
+        // A rejected request is reported with the parameters in use.
+        g_sd_sim.update_params = g_sd_sim.conn_params;
+    }
+    g_sd_sim.update_countdown = SD_SIM_CONN_PARAM_UPDATE_EVENTS;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_disconnect(uint16_t conn_handle, uint8_t hci_status_code)
+{
+    if (!conn_handle_valid(conn_handle))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (   (hci_status_code != BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION)
+        && (hci_status_code != BLE_HCI_CONN_INTERVAL_UNACCEPTABLE))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    sd_sim_link_down(BLE_HCI_LOCAL_HOST_TERMINATED_CONNECTION);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_tx_power_set(int8_t tx_power)
+{
+    UNUSED_PARAMETER(tx_power);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_appearance_set(uint16_t appearance)
+{
+    g_sd_sim.appearance = appearance;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_appearance_get(uint16_t * p_appearance)
+{
+    if (p_appearance == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_appearance = g_sd_sim.appearance;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_ppcp_set(ble_gap_conn_params_t const * p_conn_params)
+{
+    if (p_conn_params == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    g_sd_sim.ppcp = *p_conn_params;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_ppcp_get(ble_gap_conn_params_t * p_conn_params)
+{
+    if (p_conn_params == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_conn_params = g_sd_sim.ppcp;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_device_name_set(ble_gap_conn_sec_mode_t const * p_write_perm,
+                                    uint8_t const                 * p_dev_name,
+                                    uint16_t                        len)
+{
+    UNUSED_PARAMETER(p_write_perm);
+
+    if ((p_dev_name == NULL) && (len != 0))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (len > BLE_GAP_DEVNAME_MAX_LEN)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    memcpy(g_sd_sim.device_name, p_dev_name, len);
+    g_sd_sim.device_name_len = len;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_device_name_get(uint8_t * p_dev_name, uint16_t * p_len)
+{
+    if (p_len == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (p_dev_name == NULL)
+    {
+        *p_len = g_sd_sim.device_name_len;
+        return NRF_SUCCESS;
+    }
+    if (*p_len < g_sd_sim.device_name_len)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    memcpy(p_dev_name, g_sd_sim.device_name, g_sd_sim.device_name_len);
+    *p_len = g_sd_sim.device_name_len;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_authenticate(uint16_t conn_handle, ble_gap_sec_params_t const * p_sec_params)
+{
+    if (!conn_handle_valid(conn_handle))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (p_sec_params == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (g_sd_sim.pairing)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    // The central answers a security request by pairing.
+    sd_sim_pairing_start(p_sec_params->bond);
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for filling a buffer with random data. */
+static void random_fill(uint8_t * p_buf, uint8_t len)
+{
+    (void)sd_rand_application_vector_get(p_buf, len);
+}
+
+
+uint32_t sd_ble_gap_sec_params_reply(uint16_t                     conn_handle,
+                                     uint8_t                      sec_status,
+                                     ble_gap_sec_params_t const * p_sec_params,
+                                     ble_gap_sec_keyset_t const * p_sec_keyset)
+{
+    ble_evt_t                   evt;
+    ble_gap_evt_auth_status_t * p_auth_status;
+
+    if (!conn_handle_valid(conn_handle))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (!g_sd_sim.pairing)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    g_sd_sim.pairing = false;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id           = BLE_GAP_EVT_AUTH_STATUS;
+    evt.evt.gap_evt.conn_handle = SD_SIM_CONN_HANDLE;
+    p_auth_status               = &evt.evt.gap_evt.params.auth_status;
+
+    if ((sec_status != BLE_GAP_SEC_STATUS_SUCCESS) || (p_sec_params == NULL))
+    {
+        p_auth_status->auth_status = (sec_status != BLE_GAP_SEC_STATUS_SUCCESS)
+                                     ? sec_status
+                                     : BLE_GAP_SEC_STATUS_PAIRING_NOT_SUPP;
+        p_auth_status->error_src   = BLE_GAP_SEC_STATUS_SOURCE_LOCAL;
+        sd_sim_ble_evt_put(&evt, sizeof(evt));
+        return NRF_SUCCESS;
+    }
+
+    // Just Works pairing: the link is encrypted without MITM protection.
+    g_sd_sim.conn_sec.sec_mode.sm   = 1;
+    g_sd_sim.conn_sec.sec_mode.lv   = 2;
+    g_sd_sim.conn_sec.encr_key_size = p_sec_params->max_key_size;
+
+    p_auth_status->auth_status    = BLE_GAP_SEC_STATUS_SUCCESS;
+    p_auth_status->bonded         = g_sd_sim.pairing_bond && p_sec_params->bond;
+    p_auth_status->sm1_levels.lv1 = 1;
+    p_auth_status->sm1_levels.lv2 = 1;
+
+    if (p_auth_status->bonded)
+    {
+        p_auth_status->kdist_own  = p_sec_params->kdist_own;
+        p_auth_status->kdist_peer = p_sec_params->kdist_peer;
+
+        if ((p_sec_keyset != NULL) && (p_sec_keyset->keys_own.p_enc_key != NULL))
+        {
+            ble_gap_enc_key_t * p_enc_key = p_sec_keyset->keys_own.p_enc_key;
+
+            random_fill(p_enc_key->enc_info.ltk, BLE_GAP_SEC_KEY_LEN);
+            random_fill(p_enc_key->master_id.rand, BLE_GAP_SEC_RAND_LEN);
+            random_fill((uint8_t *)&p_enc_key->master_id.ediv, sizeof(p_enc_key->master_id.ediv));
+            p_enc_key->enc_info.ltk_len = BLE_GAP_SEC_KEY_LEN;
+        }
+        if ((p_sec_keyset != NULL) && (p_sec_keyset->keys_peer.p_id_key != NULL))
+        {
+            ble_gap_id_key_t * p_id_key = p_sec_keyset->keys_peer.p_id_key;
+
+            random_fill(p_id_key->id_info.irk, BLE_GAP_SEC_KEY_LEN);
+            p_id_key->id_addr_info.addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+            memset(p_id_key->id_addr_info.addr, 0xC5, BLE_GAP_ADDR_LEN);
+        }
+    }
+
+    {
+        ble_evt_t sec_evt;
+
+        memset(&sec_evt, 0, sizeof(sec_evt));
+        sec_evt.header.evt_id                               = BLE_GAP_EVT_CONN_SEC_UPDATE;
+        sec_evt.evt.gap_evt.conn_handle                     = SD_SIM_CONN_HANDLE;
+        sec_evt.evt.gap_evt.params.conn_sec_update.conn_sec = g_sd_sim.conn_sec;
+        sd_sim_ble_evt_put(&sec_evt, sizeof(sec_evt));
+    }
+
+    sd_sim_ble_evt_put(&evt, sizeof(evt));
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_auth_key_reply(uint16_t conn_handle, uint8_t key_type, uint8_t const * p_key)
+{
+    UNUSED_PARAMETER(conn_handle);
+    UNUSED_PARAMETER(key_type);
+    UNUSED_PARAMETER(p_key);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_lesc_dhkey_reply(uint16_t conn_handle, ble_gap_lesc_dhkey_t const * p_dhkey)
+{
+    UNUSED_PARAMETER(conn_handle);
+    UNUSED_PARAMETER(p_dhkey);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_keypress_notify(uint16_t conn_handle, uint8_t kp_not)
+{
+    UNUSED_PARAMETER(conn_handle);
+    UNUSED_PARAMETER(kp_not);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_lesc_oob_data_get(uint16_t                       conn_handle,
+                                      ble_gap_lesc_p256_pk_t const * p_pk_own,
+                                      ble_gap_lesc_oob_data_t      * p_oobd_own)
+{
+    UNUSED_PARAMETER(conn_handle);
+    UNUSED_PARAMETER(p_pk_own);
+    UNUSED_PARAMETER(p_oobd_own);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_lesc_oob_data_set(uint16_t                        conn_handle,
+                                      ble_gap_lesc_oob_data_t const * p_oobd_own,
+                                      ble_gap_lesc_oob_data_t const * p_oobd_peer)
+{
+    UNUSED_PARAMETER(conn_handle);
+    UNUSED_PARAMETER(p_oobd_own);
+    UNUSED_PARAMETER(p_oobd_peer);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_encrypt(uint16_t                    conn_handle,
+                            ble_gap_master_id_t const * p_master_id,
+                            ble_gap_enc_info_t const  * p_enc_info)
+{
+    UNUSED_PARAMETER(conn_handle);
+    UNUSED_PARAMETER(p_master_id);
+    UNUSED_PARAMETER(p_enc_info);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_sec_info_reply(uint16_t                    conn_handle,
+                                   ble_gap_enc_info_t const  * p_enc_info,
+                                   ble_gap_irk_t const       * p_id_info,
+                                   ble_gap_sign_info_t const * p_sign_info)
+{
+    UNUSED_PARAMETER(p_enc_info);
+    UNUSED_PARAMETER(p_id_info);
+    UNUSED_PARAMETER(p_sign_info);
+
+    return conn_handle_valid(conn_handle) ? NRF_SUCCESS : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+
+uint32_t sd_ble_gap_conn_sec_get(uint16_t conn_handle, ble_gap_conn_sec_t * p_conn_sec)
+{
+    if (p_conn_sec == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (!conn_handle_valid(conn_handle))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    *p_conn_sec = g_sd_sim.conn_sec;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_rssi_start(uint16_t conn_handle, uint8_t threshold_dbm, uint8_t skip_count)
+{
+    UNUSED_PARAMETER(threshold_dbm);
+    UNUSED_PARAMETER(skip_count);
+
+    return conn_handle_valid(conn_handle) ? NRF_SUCCESS : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+
+uint32_t sd_ble_gap_rssi_stop(uint16_t conn_handle)
+{
+    return conn_handle_valid(conn_handle) ? NRF_SUCCESS : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+
+uint32_t sd_ble_gap_rssi_get(uint16_t conn_handle, int8_t * p_rssi)
+{
+    if (p_rssi == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (!conn_handle_valid(conn_handle))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    *p_rssi = -50;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_scan_start(ble_gap_scan_params_t const * p_scan_params)
+{
+    UNUSED_PARAMETER(p_scan_params);
+
+    // Only the peripheral role is emulated.
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_scan_stop(void)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_connect(ble_gap_addr_t const        * p_peer_addr,
+                            ble_gap_scan_params_t const * p_scan_params,
+                            ble_gap_conn_params_t const * p_conn_params)
+{
+    UNUSED_PARAMETER(p_peer_addr);
+    UNUSED_PARAMETER(p_scan_params);
+    UNUSED_PARAMETER(p_conn_params);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gap_connect_cancel(void)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
@@ -0,0 +1,789 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <string.h>
+#include "sd_sim_internal.h"
+#include "ble_gatts.h"
+#include "nrf_error.h"
+
+
+/**@brief Function for adding an attribute to the table.
+ *
+ * @param[in]  type      Attribute type.
+ * @param[in]  p_uuid    Attribute UUID.
+ * @param[out] p_handle  Handle of the new attribute.
+ *
+ * @return The attribute, or NULL if the table is full.
+ */
+static sd_sim_attr_t * attr_add(sd_sim_attr_type_t type, ble_uuid_t const * p_uuid, uint16_t * p_handle)
+{
+    sd_sim_attr_t * p_attr;
+
+    if (g_sd_sim.attr_count >= SD_SIM_ATTR_MAX)
+    {
+        return NULL;
+    }
+
+    p_attr = &g_sd_sim.attrs[g_sd_sim.attr_count++];
+    memset(p_attr, 0, sizeof(*p_attr));
+    p_attr->type = type;
+    p_attr->uuid = *p_uuid;
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&p_attr->md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&p_attr->md.write_perm);
+
+    *p_handle = g_sd_sim.attr_count;
+    return p_attr;
+}
+
+
+/**@brief Function for allocating the value of an attribute.
+ *
+ * @param[in] p_attr    Attribute.
+ * @param[in] p_params  Value parameters given by the application.
+ *
+ * @retval NRF_SUCCESS       The value was set up.
+ * @retval NRF_ERROR_NO_MEM  The value pool is exhausted.
+ */
+static uint32_t attr_value_init(sd_sim_attr_t * p_attr, ble_gatts_attr_t const * p_params)
+{
+    p_attr->md      = *p_params->p_attr_md;
+    p_attr->max_len = p_params->max_len;
+    p_attr->len     = p_params->p_attr_md->vlen ? p_params->init_len : p_params->max_len;
+
+    if (p_params->p_attr_md->vloc == BLE_GATTS_VLOC_USER)
+    {
+        p_attr->p_value = p_params->p_value;
+        return NRF_SUCCESS;
+    }
+
+    if ((g_sd_sim.attr_pool_used + p_params->max_len) > SD_SIM_ATTR_POOL_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_attr->p_value = &g_sd_sim.attr_pool[g_sd_sim.attr_pool_used];
+    g_sd_sim.attr_pool_used += p_params->max_len;
+
+    memset(p_attr->p_value, 0, p_params->max_len);
+    if (p_params->p_value != NULL)
+    {
+        memcpy(p_attr->p_value + p_params->init_offs, p_params->p_value, p_params->init_len);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for adding a descriptor with a stack allocated value. */
+static uint32_t desc_add(uint16_t                    uuid,
+                         ble_gatts_attr_md_t const * p_md,
+                         uint8_t const             * p_value,
+                         uint16_t                    len,
+                         uint16_t                    max_len,
+                         uint16_t                  * p_handle)
+{
+    ble_uuid_t          desc_uuid = {uuid, BLE_UUID_TYPE_BLE};
+    ble_gatts_attr_md_t md;
+    ble_gatts_attr_t    attr;
+    sd_sim_attr_t     * p_attr = attr_add(SD_SIM_ATTR_DESC, &desc_uuid, p_handle);
+
+    if (p_attr == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memset(&md, 0, sizeof(md));
+    if (p_md != NULL)
+    {
+        md = *p_md;
+    }
+    else
+    {
+        BLE_GAP_CONN_SEC_MODE_SET_OPEN(&md.read_perm);
+        BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&md.write_perm);
+    }
+    md.vloc = BLE_GATTS_VLOC_STACK;
+    md.vlen = 1;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.p_uuid    = &desc_uuid;
+    attr.p_attr_md = &md;
+    attr.p_value   = (uint8_t *)p_value;
+    attr.init_len  = len;
+    attr.max_len   = max_len;
+
+    return attr_value_init(p_attr, &attr);
+}
+
+
+sd_sim_attr_t * sd_sim_attr_get(uint16_t handle)
+{
+    if ((handle == BLE_GATT_HANDLE_INVALID) || (handle > g_sd_sim.attr_count))
+    {
+        return NULL;
+    }
+
+    return &g_sd_sim.attrs[handle - 1];
+}
+
+
+/**@brief Function for checking whether an attribute is a CCCD. */
+static bool is_cccd(sd_sim_attr_t const * p_attr)
+{
+    return (p_attr->type == SD_SIM_ATTR_DESC)
+           && (p_attr->uuid.type == BLE_UUID_TYPE_BLE)
+           && (p_attr->uuid.uuid == BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG);
+}
+
+
+/**@brief Function for getting the CCCD value of the characteristic that owns a value handle. */
+static uint16_t cccd_value_get(uint16_t value_handle)
+{
+    for (uint16_t handle = value_handle + 1; handle <= g_sd_sim.attr_count; handle++)
+    {
+        sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+
+        if (p_attr->type != SD_SIM_ATTR_DESC)
+        {
+            break;
+        }
+        if (is_cccd(p_attr))
+        {
+            return uint16_decode(p_attr->p_value);
+        }
+    }
+
+    return 0;
+}
+
+
+void sd_sim_gatts_conn_reset(void)
+{
+    for (uint16_t handle = 1; handle <= g_sd_sim.attr_count; handle++)
+    {
+        sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+
+        if (is_cccd(p_attr))
+        {
+            memset(p_attr->p_value, 0, p_attr->max_len);
+        }
+    }
+
+    g_sd_sim.sys_attr_missing   = true;
+    g_sd_sim.sys_attr_requested = false;
+}
+
+
+bool sd_sim_gatts_write(sd_sim_write_t const * p_write)
+{
+    uint32_t        evt_buf[SD_SIM_BLE_EVT_WORDS];
+    ble_evt_t     * p_evt  = (ble_evt_t *)evt_buf;
+    sd_sim_attr_t * p_attr = sd_sim_attr_get(p_write->handle);
+    ble_gatts_evt_write_t * p_evt_write;
+    uint16_t        len;
+
+    if ((p_attr == NULL) || (p_write->len > p_attr->max_len))
+    {
+        // Rejected by the ATT layer, the application is not involved.
+        return true;
+    }
+
+    if (is_cccd(p_attr) && g_sd_sim.sys_attr_missing)
+    {
+        if (!g_sd_sim.sys_attr_requested)
+        {
+            memset(p_evt, 0, sizeof(ble_evt_t));
+            p_evt->header.evt_id                              = BLE_GATTS_EVT_SYS_ATTR_MISSING;
+            p_evt->evt.gatts_evt.conn_handle                  = SD_SIM_CONN_HANDLE;
+            p_evt->evt.gatts_evt.params.sys_attr_missing.hint = 0;
+            sd_sim_ble_evt_put(p_evt, sizeof(ble_evt_t));
+
+            g_sd_sim.sys_attr_requested = true;
+        }
+        return false;
+    }
+
+    memset(p_evt, 0, sizeof(ble_evt_t));
+    p_evt->evt.gatts_evt.conn_handle = SD_SIM_CONN_HANDLE;
+
+    if (p_attr->md.wr_auth)
+    {
+        p_evt->header.evt_id = BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST;
+        p_evt->evt.gatts_evt.params.authorize_request.type = BLE_GATTS_AUTHORIZE_TYPE_WRITE;
+        p_evt_write = &p_evt->evt.gatts_evt.params.authorize_request.request.write;
+    }
+    else
+    {
+        memcpy(p_attr->p_value, p_write->data, p_write->len);
+        if (p_attr->md.vlen)
+        {
+            p_attr->len = p_write->len;
+        }
+
+        p_evt->header.evt_id = BLE_GATTS_EVT_WRITE;
+        p_evt_write = &p_evt->evt.gatts_evt.params.write;
+    }
+
+    p_evt_write->handle = p_write->handle;
+    p_evt_write->uuid   = p_attr->uuid;
+    p_evt_write->op     = p_write->with_response ? BLE_GATTS_OP_WRITE_REQ : BLE_GATTS_OP_WRITE_CMD;
+    p_evt_write->offset = 0;
+    p_evt_write->len    = p_write->len;
+    memcpy(p_evt_write->data, p_write->data, p_write->len);
+
+    len = (uint16_t)((p_evt_write->data - (uint8_t *)p_evt) + p_write->len);
+    sd_sim_ble_evt_put(p_evt, MAX(len, sizeof(ble_evt_t)));
+
+    g_sd_sim.stats.writes++;
+
+    return true;
+}
+
+
+uint32_t sd_ble_gatts_service_add(uint8_t type, ble_uuid_t const * p_uuid, uint16_t * p_handle)
+{
+    sd_sim_attr_t * p_attr;
+
+    if ((p_uuid == NULL) || (p_handle == NULL))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((type != BLE_GATTS_SRVC_TYPE_PRIMARY) && (type != BLE_GATTS_SRVC_TYPE_SECONDARY))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_attr = attr_add(SD_SIM_ATTR_SERVICE, p_uuid, p_handle);
+    return (p_attr != NULL) ? NRF_SUCCESS : NRF_ERROR_NO_MEM;
+}
+
+
+uint32_t sd_ble_gatts_include_add(uint16_t service_handle, uint16_t inc_srvc_handle, uint16_t * p_include_handle)
+{
+    ble_uuid_t      uuid = {BLE_UUID_SERVICE_INCLUDE, BLE_UUID_TYPE_BLE};
+    sd_sim_attr_t * p_attr;
+
+    if ((sd_sim_attr_get(service_handle) == NULL) || (sd_sim_attr_get(inc_srvc_handle) == NULL))
+    {
+        return BLE_ERROR_INVALID_ATTR_HANDLE;
+    }
+
+    p_attr = attr_add(SD_SIM_ATTR_DESC, &uuid, p_include_handle);
+    return (p_attr != NULL) ? NRF_SUCCESS : NRF_ERROR_NO_MEM;
+}
+
+
+uint32_t sd_ble_gatts_characteristic_add(uint16_t                   service_handle,
+                                         ble_gatts_char_md_t const * p_char_md,
+                                         ble_gatts_attr_t const    * p_attr_char_value,
+                                         ble_gatts_char_handles_t  * p_handles)
+{
+    ble_uuid_t      decl_uuid = {BLE_UUID_CHARACTERISTIC, BLE_UUID_TYPE_BLE};
+    sd_sim_attr_t * p_attr;
+    uint16_t        handle;
+    uint32_t        err_code;
+
+    if ((p_char_md == NULL) || (p_attr_char_value == NULL) || (p_handles == NULL)
+        || (p_attr_char_value->p_uuid == NULL) || (p_attr_char_value->p_attr_md == NULL))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((service_handle != BLE_GATT_HANDLE_INVALID) && (sd_sim_attr_get(service_handle) == NULL))
+    {
+        return BLE_ERROR_INVALID_ATTR_HANDLE;
+    }
+    if (p_attr_char_value->init_len + p_attr_char_value->init_offs > p_attr_char_value->max_len)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(p_handles, 0, sizeof(*p_handles));
+
+    if (attr_add(SD_SIM_ATTR_CHAR_DECL, &decl_uuid, &handle) == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_attr = attr_add(SD_SIM_ATTR_CHAR_VALUE, p_attr_char_value->p_uuid, &p_handles->value_handle);
+    if (p_attr == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    p_attr->props = p_char_md->char_props;
+
+    err_code = attr_value_init(p_attr, p_attr_char_value);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    g_sd_sim.last_char_handle = p_handles->value_handle;
+
+    if (p_char_md->p_char_user_desc != NULL)
+    {
+        err_code = desc_add(BLE_UUID_DESCRIPTOR_CHAR_USER_DESC,
+                            p_char_md->p_user_desc_md,
+                            p_char_md->p_char_user_desc,
+                            p_char_md->char_user_desc_size,
+                            MAX(p_char_md->char_user_desc_max_size, p_char_md->char_user_desc_size),
+                            &p_handles->user_desc_handle);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+
+    if (p_char_md->p_char_pf != NULL)
+    {
+        uint16_t pf_handle;
+
+        err_code = desc_add(BLE_UUID_DESCRIPTOR_CHAR_PRESENTATION_FORMAT,
+                            NULL,
+                            (uint8_t const *)p_char_md->p_char_pf,
+                            sizeof(*p_char_md->p_char_pf),
+                            sizeof(*p_char_md->p_char_pf),
+                            &pf_handle);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+
+    if (p_char_md->char_props.notify || p_char_md->char_props.indicate)
+    {
+        static uint8_t const cccd_init[2] = {0, 0};
+        ble_gatts_attr_md_t  cccd_md;
+
+        if (p_char_md->p_cccd_md != NULL)
+        {
+            cccd_md = *p_char_md->p_cccd_md;
+        }
+        else
+        {
+            memset(&cccd_md, 0, sizeof(cccd_md));
+            BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+            BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+        }
+
+        err_code = desc_add(BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG,
+                            &cccd_md,
+                            cccd_init,
+                            sizeof(cccd_init),
+                            sizeof(cccd_init),
+                            &p_handles->cccd_handle);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+
+    if (p_char_md->char_props.broadcast)
+    {
+        static uint8_t const sccd_init[2] = {0, 0};
+
+        err_code = desc_add(BLE_UUID_DESCRIPTOR_SERVER_CHAR_CONFIG,
+                            p_char_md->p_sccd_md,
+                            sccd_init,
+                            sizeof(sccd_init),
+                            sizeof(sccd_init),
+                            &p_handles->sccd_handle);
+    }
+
+    return err_code;
+}
+
+
+uint32_t sd_ble_gatts_descriptor_add(uint16_t char_handle, ble_gatts_attr_t const * p_attr, uint16_t * p_handle)
+{
+    sd_sim_attr_t * p_desc;
+
+    if ((p_attr == NULL) || (p_handle == NULL) || (p_attr->p_uuid == NULL) || (p_attr->p_attr_md == NULL))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((char_handle == BLE_GATT_HANDLE_INVALID) && (g_sd_sim.last_char_handle == BLE_GATT_HANDLE_INVALID))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_desc = attr_add(SD_SIM_ATTR_DESC, p_attr->p_uuid, p_handle);
+    if (p_desc == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    return attr_value_init(p_desc, p_attr);
+}
+
+
+uint32_t sd_ble_gatts_value_set(uint16_t conn_handle, uint16_t handle, ble_gatts_value_t * p_value)
+{
+    sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+
+    UNUSED_PARAMETER(conn_handle);
+
+    if (p_value == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((p_attr == NULL) || (p_attr->p_value == NULL))
+    {
+        return BLE_ERROR_INVALID_ATTR_HANDLE;
+    }
+    if (p_value->offset > p_attr->max_len)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if ((uint32_t)p_value->offset + p_value->len > p_attr->max_len)
+    {
+        p_value->len = p_attr->max_len - p_value->offset;
+    }
+
+    if (p_value->p_value != NULL)
+    {
+        memcpy(p_attr->p_value + p_value->offset, p_value->p_value, p_value->len);
+    }
+    if (p_attr->md.vlen)
+    {
+        p_attr->len = p_value->offset + p_value->len;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_value_get(uint16_t conn_handle, uint16_t handle, ble_gatts_value_t * p_value)
+{
+    sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+    uint16_t        avail;
+
+    UNUSED_PARAMETER(conn_handle);
+
+    if (p_value == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((p_attr == NULL) || (p_attr->p_value == NULL))
+    {
+        return BLE_ERROR_INVALID_ATTR_HANDLE;
+    }
+    if (p_value->offset > p_attr->len)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    avail = p_attr->len - p_value->offset;
+    if (p_value->p_value == NULL)
+    {
+        p_value->len = avail;
+        return NRF_SUCCESS;
+    }
+
+    p_value->len = MIN(p_value->len, avail);
+    memcpy(p_value->p_value, p_attr->p_value + p_value->offset, p_value->len);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * p_hvx_params)
+{
+    sd_sim_attr_t * p_attr;
+    sd_sim_tx_t   * p_tx;
+    uint16_t        cccd;
+    uint16_t        len;
+
+    if (p_hvx_params == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (!g_sd_sim.connected || (conn_handle != SD_SIM_CONN_HANDLE))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    p_attr = sd_sim_attr_get(p_hvx_params->handle);
+    if ((p_attr == NULL) || (p_attr->type != SD_SIM_ATTR_CHAR_VALUE))
+    {
+        return BLE_ERROR_INVALID_ATTR_HANDLE;
+    }
+    if (g_sd_sim.sys_attr_missing)
+    {
+        return BLE_ERROR_GATTS_SYS_ATTR_MISSING;
+    }
+
+    cccd = cccd_value_get(p_hvx_params->handle);
+    if (p_hvx_params->type == BLE_GATT_HVX_NOTIFICATION)
+    {
+        if (!(cccd & BLE_GATT_HVX_NOTIFICATION))
+        {
+            return NRF_ERROR_INVALID_STATE;
+        }
+        if (g_sd_sim.tx_count >= g_sd_sim.link_cfg.tx_buffer_count)
+        {
+            g_sd_sim.stats.hvx_no_tx_packets++;
+            return BLE_ERROR_NO_TX_PACKETS;
+        }
+    }
+    else if (p_hvx_params->type == BLE_GATT_HVX_INDICATION)
+    {
+        if (!(cccd & BLE_GATT_HVX_INDICATION))
+        {
+            return NRF_ERROR_INVALID_STATE;
+        }
+        if (g_sd_sim.indication_pending)
+        {
+            return NRF_ERROR_BUSY;
+        }
+    }
+    else
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if ((p_hvx_params->p_len != NULL) && (p_hvx_params->p_data != NULL))
+    {
+        ble_gatts_value_t value;
+
+        value.len     = *p_hvx_params->p_len;
+        value.offset  = p_hvx_params->offset;
+        value.p_value = p_hvx_params->p_data;
+        (void)sd_ble_gatts_value_set(conn_handle, p_hvx_params->handle, &value);
+    }
+
+    len = MIN(p_attr->len, SD_SIM_ATT_PAYLOAD_MAX);
+    if (p_hvx_params->p_len != NULL)
+    {
+        *p_hvx_params->p_len = len;
+    }
+
+    if (p_hvx_params->type == BLE_GATT_HVX_INDICATION)
+    {
+        g_sd_sim.indication_pending = true;
+        g_sd_sim.indication_handle  = p_hvx_params->handle;
+    }
+
+    p_tx = &g_sd_sim.tx[(g_sd_sim.tx_head + g_sd_sim.tx_count) % SD_SIM_TX_QUEUE_SIZE];
+    p_tx->handle    = p_hvx_params->handle;
+    p_tx->len       = len;
+    p_tx->type      = p_hvx_params->type;
+    p_tx->queued_us = g_sd_sim.now_us;
+    g_sd_sim.tx_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_service_changed(uint16_t conn_handle, uint16_t start_handle, uint16_t end_handle)
+{
+    UNUSED_PARAMETER(conn_handle);
+    UNUSED_PARAMETER(start_handle);
+    UNUSED_PARAMETER(end_handle);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_ble_gatts_rw_authorize_reply(uint16_t                                      conn_handle,
+                                         ble_gatts_rw_authorize_reply_params_t const * p_rw_authorize_reply_params)
+{
+    ble_gatts_authorize_params_t const * p_params;
+
+    if (p_rw_authorize_reply_params == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (!g_sd_sim.connected || (conn_handle != SD_SIM_CONN_HANDLE))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    p_params = (p_rw_authorize_reply_params->type == BLE_GATTS_AUTHORIZE_TYPE_WRITE)
+               ? &p_rw_authorize_reply_params->params.write
+               : &p_rw_authorize_reply_params->params.read;
+
+    // The emulator does not keep track of the request, the value is updated in place.
+    UNUSED_PARAMETER(p_params);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_sys_attr_set(uint16_t        conn_handle,
+                                   uint8_t const * p_sys_attr_data,
+                                   uint16_t        len,
+                                   uint32_t        flags)
+{
+    UNUSED_PARAMETER(flags);
+
+    if (!g_sd_sim.connected || (conn_handle != SD_SIM_CONN_HANDLE))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    sd_sim_gatts_conn_reset();
+
+    if (p_sys_attr_data != NULL)
+    {
+        uint16_t index = 0;
+
+        // Entries of handle, length and value, followed by a 16-bit CRC.
+        while ((uint32_t)(index + 4 + sizeof(uint16_t)) <= len)
+        {
+            uint16_t        handle    = uint16_decode(&p_sys_attr_data[index]);
+            uint16_t        entry_len = uint16_decode(&p_sys_attr_data[index + 2]);
+            sd_sim_attr_t * p_attr    = sd_sim_attr_get(handle);
+
+            index += 4;
+            if ((p_attr == NULL) || !is_cccd(p_attr) || (entry_len > p_attr->max_len)
+                || ((index + entry_len) > len))
+            {
+                return NRF_ERROR_INVALID_DATA;
+            }
+
+            memcpy(p_attr->p_value, &p_sys_attr_data[index], entry_len);
+            index += entry_len;
+        }
+    }
+
+    g_sd_sim.sys_attr_missing = false;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_sys_attr_get(uint16_t  conn_handle,
+                                   uint8_t * p_sys_attr_data,
+                                   uint16_t * p_len,
+                                   uint32_t  flags)
+{
+    uint16_t index = 0;
+
+    UNUSED_PARAMETER(flags);
+
+    if (p_len == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (!g_sd_sim.connected || (conn_handle != SD_SIM_CONN_HANDLE))
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    for (uint16_t handle = 1; handle <= g_sd_sim.attr_count; handle++)
+    {
+        sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+
+        if (!is_cccd(p_attr))
+        {
+            continue;
+        }
+
+        if (p_sys_attr_data != NULL)
+        {
+            if ((index + 4 + p_attr->len + sizeof(uint16_t)) > *p_len)
+            {
+                return NRF_ERROR_DATA_SIZE;
+            }
+            (void)uint16_encode(handle, &p_sys_attr_data[index]);
+            (void)uint16_encode(p_attr->len, &p_sys_attr_data[index + 2]);
+            memcpy(&p_sys_attr_data[index + 4], p_attr->p_value, p_attr->len);
+        }
+        index += 4 + p_attr->len;
+    }
+
+    if (p_sys_attr_data != NULL)
+    {
+        // The CRC is not checked by the emulator.
+        (void)uint16_encode(0, &p_sys_attr_data[index]);
+    }
+    *p_len = index + sizeof(uint16_t);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_initial_user_handle_get(uint16_t * p_handle)
+{
+    if (p_handle == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_handle = 1;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_attr_get(uint16_t handle, ble_uuid_t * p_uuid, ble_gatts_attr_md_t * p_md)
+{
+    sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+
+    if (p_attr == NULL)
+    {
+        return BLE_ERROR_INVALID_ATTR_HANDLE;
+    }
+    if (p_uuid != NULL)
+    {
+        *p_uuid = p_attr->uuid;
+    }
+    if (p_md != NULL)
+    {
+        *p_md = p_attr->md;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint16_t sd_sim_value_handle_find(uint16_t uuid)
+{
+    for (uint16_t handle = 1; handle <= g_sd_sim.attr_count; handle++)
+    {
+        sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+
+        if ((p_attr->type == SD_SIM_ATTR_CHAR_VALUE) && (p_attr->uuid.uuid == uuid))
+        {
+            return handle;
+        }
+    }
+
+    return BLE_GATT_HANDLE_INVALID;
+}
+
+
+uint16_t sd_sim_cccd_handle_find(uint16_t uuid)
+{
+    uint16_t value_handle = sd_sim_value_handle_find(uuid);
+
+    if (value_handle == BLE_GATT_HANDLE_INVALID)
+    {
+        return BLE_GATT_HANDLE_INVALID;
+    }
+
+    for (uint16_t handle = value_handle + 1; handle <= g_sd_sim.attr_count; handle++)
+    {
+        sd_sim_attr_t * p_attr = sd_sim_attr_get(handle);
+
+        if (p_attr->type != SD_SIM_ATTR_DESC)
+        {
+            break;
+        }
+        if (is_cccd(p_attr))
+        {
+            return handle;
+        }
+    }
+
+    return BLE_GATT_HANDLE_INVALID;
+}
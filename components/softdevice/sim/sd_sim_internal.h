@@ -0,0 +1,179 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SD_SIM_INTERNAL_H__
+#define SD_SIM_INTERNAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sd_sim.h"
+#include "nordic_common.h"
+#include "app_util.h"
+
+#define SD_SIM_ATTR_MAX             96      /**< Maximum number of attributes. */
+#define SD_SIM_ATTR_POOL_SIZE       2048    /**< Bytes available for attribute values kept by the emulator. */
+#define SD_SIM_VS_UUID_MAX          4       /**< Maximum number of vendor specific base UUIDs. */
+#define SD_SIM_BLE_EVT_QUEUE_SIZE   32      /**< Maximum number of BLE events waiting to be pulled. */
+#define SD_SIM_SOC_EVT_QUEUE_SIZE   8       /**< Maximum number of SoC events waiting to be pulled. */
+#define SD_SIM_TX_QUEUE_SIZE        32      /**< Upper limit on the configured TX buffer count. */
+#define SD_SIM_WRITE_QUEUE_SIZE     16      /**< Maximum number of queued central writes. */
+#define SD_SIM_CONN_HANDLE          0       /**< Handle of the emulated connection. */
+#define SD_SIM_ATT_PAYLOAD_MAX      (GATT_MTU_SIZE_DEFAULT - 3)
+#define SD_SIM_CONN_PARAM_UPDATE_EVENTS 6   /**< Connection events until a parameter update takes effect. */
+
+#define SD_SIM_BLE_EVT_WORDS        CEIL_DIV(sizeof(ble_evt_t) + GATT_MTU_SIZE_DEFAULT, sizeof(uint32_t))
+
+/**@brief Attribute types. */
+typedef enum
+{
+    SD_SIM_ATTR_SERVICE,
+    SD_SIM_ATTR_CHAR_DECL,
+    SD_SIM_ATTR_CHAR_VALUE,
+    SD_SIM_ATTR_DESC
+} sd_sim_attr_type_t;
+
+/**@brief Attribute. The handle is the index in the table plus one. */
+typedef struct
+{
+    ble_uuid_t          uuid;
+    sd_sim_attr_type_t  type;
+    ble_gatt_char_props_t props;        /**< Properties, for characteristic values. */
+    ble_gatts_attr_md_t md;
+    uint8_t           * p_value;
+    uint16_t            len;
+    uint16_t            max_len;
+} sd_sim_attr_t;
+
+/**@brief Notification or indication waiting for transmission. */
+typedef struct
+{
+    uint16_t handle;
+    uint16_t len;
+    uint8_t  type;
+    uint64_t queued_us;
+} sd_sim_tx_t;
+
+/**@brief Write waiting for transmission from the central. */
+typedef struct
+{
+    uint16_t handle;
+    uint16_t len;
+    bool     with_response;
+    uint8_t  data[SD_SIM_ATT_PAYLOAD_MAX];
+} sd_sim_write_t;
+
+/**@brief Emulator state shared by the SoftDevice API and the virtual central. */
+typedef struct
+{
+    sd_sim_link_cfg_t     link_cfg;
+    sd_sim_evt_pump_t     evt_pump;
+    sd_sim_stats_t        stats;
+    uint64_t              now_us;
+    bool                  enabled;
+    uint32_t              rand_state;
+
+    /* Event queues. */
+    uint32_t              ble_evts[SD_SIM_BLE_EVT_QUEUE_SIZE][SD_SIM_BLE_EVT_WORDS];
+    uint16_t              ble_evt_head;
+    uint16_t              ble_evt_tail;
+    uint32_t              soc_evts[SD_SIM_SOC_EVT_QUEUE_SIZE];
+    uint16_t              soc_evt_head;
+    uint16_t              soc_evt_tail;
+
+    /* GATT server. */
+    sd_sim_attr_t         attrs[SD_SIM_ATTR_MAX];
+    uint16_t              attr_count;
+    uint8_t               attr_pool[SD_SIM_ATTR_POOL_SIZE];
+    uint16_t              attr_pool_used;
+    uint16_t              last_char_handle;
+    ble_uuid128_t         vs_uuids[SD_SIM_VS_UUID_MAX];
+    uint8_t               vs_uuid_count;
+    bool                  sys_attr_missing;
+    bool                  sys_attr_requested;   /**< The system attributes missing event was raised. */
+
+    /* GAP. */
+    bool                  advertising;
+    uint64_t              adv_timeout_us;   /**< Time at which advertising times out, 0 for none. */
+    ble_gap_conn_params_t ppcp;
+    ble_gap_addr_t        addr;
+    uint16_t              appearance;
+    uint8_t               device_name[BLE_GAP_DEVNAME_MAX_LEN];
+    uint16_t              device_name_len;
+
+    /* Link. */
+    bool                  connected;
+    ble_gap_conn_params_t conn_params;
+    uint64_t              next_conn_event_us;
+    sd_sim_tx_t           tx[SD_SIM_TX_QUEUE_SIZE];
+    uint8_t               tx_head;
+    uint8_t               tx_count;
+    bool                  indication_pending;
+    uint16_t              indication_handle;
+    sd_sim_write_t        writes[SD_SIM_WRITE_QUEUE_SIZE];
+    uint8_t               write_head;
+    uint8_t               write_count;
+    ble_gap_conn_params_t update_params;
+    uint8_t               update_countdown; /**< Connection events until a parameter update takes effect, 0 if none. */
+    bool                  pairing;
+    bool                  pairing_bond;
+    ble_gap_conn_sec_t    conn_sec;
+} sd_sim_t;
+
+extern sd_sim_t g_sd_sim;
+
+/**@brief Function for queuing a BLE event for the application.
+ *
+ * @param[in] p_evt  Event. The header length is filled in.
+ * @param[in] len    Length of the event, including the header.
+ */
+void sd_sim_ble_evt_put(ble_evt_t * p_evt, uint16_t len);
+
+/**@brief Function for queuing a SoC event for the application. */
+void sd_sim_soc_evt_put(uint32_t evt_id);
+
+/**@brief Function for getting an attribute by handle, NULL if the handle is not in use. */
+sd_sim_attr_t * sd_sim_attr_get(uint16_t handle);
+
+/**@brief Function for clearing the CCCDs at the start of a connection. */
+void sd_sim_gatts_conn_reset(void);
+
+/**@brief Function for applying a write from the central to the attribute table.
+ *
+ * @details Raises the write, or authorization request, event for the application. A CCCD write
+ *          waits until the application has set the system attributes.
+ *
+ * @retval true   The write was handled.
+ * @retval false  The write must be retried at a later connection event.
+ */
+bool sd_sim_gatts_write(sd_sim_write_t const * p_write);
+
+/**@brief Function for running the link layer of one connection event. */
+void sd_sim_conn_event_run(void);
+
+/**@brief Function for ending the connection and raising the disconnected event.
+ *
+ * @param[in] reason  HCI status code reported to the application.
+ */
+void sd_sim_link_down(uint8_t reason);
+
+/**@brief Function for starting pairing on behalf of the central.
+ *
+ * @details Raises the security parameters request event for the application.
+ *
+ * @param[in] bond  Request bonding.
+ */
+void sd_sim_pairing_start(bool bond);
+
+/**@brief Function for erasing the emulated flash and resetting the SoC state. */
+void sd_sim_soc_reset(void);
+
+#endif // SD_SIM_INTERNAL_H__
@@ -0,0 +1,672 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <string.h>
+#include "sd_sim_internal.h"
+#include "nrf_sdm.h"
+#include "nrf_error.h"
+#include "nrf_error_soc.h"
+
+#define RAND_POOL_CAPACITY      64
+#define TEMP_ROOM               100     /**< 25 degrees Celsius (in 0.25 degree units). */
+#define AES_ROUNDS              10
+#define AES_BLOCK_SIZE          16
+
+static uint32_t m_flash[SD_SIM_FLASH_SIZE / sizeof(uint32_t)];  /**< Emulated flash image. */
+static uint32_t m_gpregret;
+static uint32_t m_ppi_channels;
+static bool     m_hfclk_running;
+
+static const uint8_t m_sbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+
+void sd_sim_soc_reset(void)
+{
+    memset(m_flash, 0xFF, sizeof(m_flash));
+    m_gpregret      = 0;
+    m_ppi_channels  = 0;
+    m_hfclk_running = false;
+}
+
+
+uint8_t * sd_sim_flash_ptr(uint32_t address)
+{
+    if (address >= SD_SIM_FLASH_SIZE)
+    {
+        return NULL;
+    }
+
+    return (uint8_t *)m_flash + address;
+}
+
+
+/**@brief Function for mapping a flash pointer given to the SoftDevice to the flash image.
+ *
+ * @details Both flash addresses, as used on the device, and pointers into the image, as
+ *          returned by @ref sd_sim_flash_ptr, are accepted.
+ *
+ * @return Word offset in the flash image, or -1 if the pointer is outside the flash.
+ */
+static int32_t flash_word_offset(uint32_t const * p_addr)
+{
+    uintptr_t addr  = (uintptr_t)p_addr;
+    uintptr_t image = (uintptr_t)m_flash;
+
+    if ((addr >= image) && (addr < (image + sizeof(m_flash))))
+    {
+        addr -= image;
+    }
+    else if (addr >= SD_SIM_FLASH_SIZE)
+    {
+        return -1;
+    }
+
+    if ((addr % sizeof(uint32_t)) != 0)
+    {
+        return -1;
+    }
+
+    return (int32_t)(addr / sizeof(uint32_t));
+}
+
+
+uint32_t sd_flash_write(uint32_t * const p_dst, uint32_t const * const p_src, uint32_t size)
+{
+    int32_t offset = flash_word_offset(p_dst);
+
+    if ((offset < 0) || (p_src == NULL) || (((uintptr_t)p_src % sizeof(uint32_t)) != 0))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((size == 0) || (size > (SD_SIM_FLASH_PAGE_SIZE / sizeof(uint32_t)))
+        || (((uint32_t)offset + size) > (SD_SIM_FLASH_SIZE / sizeof(uint32_t))))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    // Programming can only clear bits.
+    for (uint32_t i = 0; i < size; i++)
+    {
+        m_flash[offset + i] &= p_src[i];
+    }
+
+    sd_sim_soc_evt_put(NRF_EVT_FLASH_OPERATION_SUCCESS);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_flash_page_erase(uint32_t page_number)
+{
+    if (page_number >= (SD_SIM_FLASH_SIZE / SD_SIM_FLASH_PAGE_SIZE))
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    memset((uint8_t *)m_flash + (page_number * SD_SIM_FLASH_PAGE_SIZE), 0xFF, SD_SIM_FLASH_PAGE_SIZE);
+    sd_sim_soc_evt_put(NRF_EVT_FLASH_OPERATION_SUCCESS);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_flash_protect(uint32_t block_cfg0, uint32_t block_cfg1, uint32_t block_cfg2, uint32_t block_cfg3)
+{
+    UNUSED_PARAMETER(block_cfg0);
+    UNUSED_PARAMETER(block_cfg1);
+    UNUSED_PARAMETER(block_cfg2);
+    UNUSED_PARAMETER(block_cfg3);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_evt_get(uint32_t * p_evt_id)
+{
+    if (p_evt_id == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (g_sd_sim.soc_evt_head == g_sd_sim.soc_evt_tail)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_evt_id = g_sd_sim.soc_evts[g_sd_sim.soc_evt_head % SD_SIM_SOC_EVT_QUEUE_SIZE];
+    g_sd_sim.soc_evt_head++;
+    g_sd_sim.stats.soc_evts++;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for multiplying by x in GF(2^8). */
+static uint8_t xtime(uint8_t value)
+{
+    return (uint8_t)((value << 1) ^ ((value & 0x80) ? 0x1B : 0x00));
+}
+
+
+/**@brief Function for encrypting one block with AES-128, as done by the ECB peripheral. */
+static void aes128_encrypt(uint8_t const * p_key, uint8_t const * p_in, uint8_t * p_out)
+{
+    uint8_t round_key[AES_BLOCK_SIZE];
+    uint8_t state[AES_BLOCK_SIZE];
+    uint8_t rcon = 0x01;
+
+    memcpy(round_key, p_key, AES_BLOCK_SIZE);
+    for (uint8_t i = 0; i < AES_BLOCK_SIZE; i++)
+    {
+        state[i] = p_in[i] ^ round_key[i];
+    }
+
+    for (uint8_t round = 1; round <= AES_ROUNDS; round++)
+    {
+        uint8_t tmp[AES_BLOCK_SIZE];
+
+        // SubBytes and ShiftRows.
+        for (uint8_t col = 0; col < 4; col++)
+        {
+            for (uint8_t row = 0; row < 4; row++)
+            {
+                tmp[(col * 4) + row] = m_sbox[state[(((col + row) % 4) * 4) + row]];
+            }
+        }
+
+        // MixColumns, except in the last round.
+        if (round != AES_ROUNDS)
+        {
+            for (uint8_t col = 0; col < 4; col++)
+            {
+                uint8_t * p_col = &tmp[col * 4];
+                uint8_t   all   = p_col[0] ^ p_col[1] ^ p_col[2] ^ p_col[3];
+                uint8_t   first = p_col[0];
+
+                p_col[0] ^= all ^ xtime(p_col[0] ^ p_col[1]);
+                p_col[1] ^= all ^ xtime(p_col[1] ^ p_col[2]);
+                p_col[2] ^= all ^ xtime(p_col[2] ^ p_col[3]);
+                p_col[3] ^= all ^ xtime(p_col[3] ^ first);
+            }
+        }
+
+        // Next round key.
+        round_key[0] ^= m_sbox[round_key[13]] ^ rcon;
+        round_key[1] ^= m_sbox[round_key[14]];
+        round_key[2] ^= m_sbox[round_key[15]];
+        round_key[3] ^= m_sbox[round_key[12]];
+        for (uint8_t i = 4; i < AES_BLOCK_SIZE; i++)
+        {
+            round_key[i] ^= round_key[i - 4];
+        }
+        rcon = xtime(rcon);
+
+        for (uint8_t i = 0; i < AES_BLOCK_SIZE; i++)
+        {
+            state[i] = tmp[i] ^ round_key[i];
+        }
+    }
+
+    memcpy(p_out, state, AES_BLOCK_SIZE);
+}
+
+
+uint32_t sd_ecb_block_encrypt(nrf_ecb_hal_data_t * p_ecb_data)
+{
+    if (p_ecb_data == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    aes128_encrypt(p_ecb_data->key, p_ecb_data->cleartext, p_ecb_data->ciphertext);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ecb_blocks_encrypt(uint8_t block_count, nrf_ecb_hal_data_block_t * p_data_blocks)
+{
+    if (p_data_blocks == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    for (uint8_t i = 0; i < block_count; i++)
+    {
+        aes128_encrypt(*p_data_blocks[i].p_key,
+                       *p_data_blocks[i].p_cleartext,
+                       *p_data_blocks[i].p_ciphertext);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_rand_application_pool_capacity_get(uint8_t * p_pool_capacity)
+{
+    if (p_pool_capacity == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_pool_capacity = RAND_POOL_CAPACITY;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_rand_application_bytes_available_get(uint8_t * p_bytes_available)
+{
+    if (p_bytes_available == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    // The pool never runs dry, so that runs are reproducible.
+    *p_bytes_available = RAND_POOL_CAPACITY;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_rand_application_vector_get(uint8_t * p_buff, uint8_t length)
+{
+    if ((p_buff == NULL) && (length != 0))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (length > RAND_POOL_CAPACITY)
+    {
+        return NRF_ERROR_SOC_RAND_NOT_ENOUGH_VALUES;
+    }
+
+    // Deterministic xorshift sequence, seeded by sd_sim_init.
+    for (uint8_t i = 0; i < length; i++)
+    {
+        g_sd_sim.rand_state ^= g_sd_sim.rand_state << 13;
+        g_sd_sim.rand_state ^= g_sd_sim.rand_state >> 17;
+        g_sd_sim.rand_state ^= g_sd_sim.rand_state << 5;
+        p_buff[i] = (uint8_t)g_sd_sim.rand_state;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_mutex_new(nrf_mutex_t * p_mutex)
+{
+    if (p_mutex == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_mutex = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_mutex_acquire(nrf_mutex_t * p_mutex)
+{
+    if (p_mutex == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (*p_mutex != 0)
+    {
+        return NRF_ERROR_SOC_MUTEX_ALREADY_TAKEN;
+    }
+
+    *p_mutex = 1;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_mutex_release(nrf_mutex_t * p_mutex)
+{
+    if (p_mutex == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_mutex = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_reset_reason_get(uint32_t * p_reset_reason)
+{
+    if (p_reset_reason == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_reset_reason = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_reset_reason_clr(uint32_t reset_reason_clr_msk)
+{
+    UNUSED_PARAMETER(reset_reason_clr_msk);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_mode_set(uint8_t power_mode)
+{
+    if ((power_mode != NRF_POWER_MODE_CONSTLAT) && (power_mode != NRF_POWER_MODE_LOWPWR))
+    {
+        return NRF_ERROR_SOC_POWER_MODE_UNKNOWN;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_system_off(void)
+{
+    return NRF_ERROR_SOC_POWER_OFF_SHOULD_NOT_RETURN;
+}
+
+
+uint32_t sd_power_pof_enable(uint8_t pof_enable)
+{
+    UNUSED_PARAMETER(pof_enable);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_pof_threshold_set(uint8_t threshold)
+{
+    UNUSED_PARAMETER(threshold);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_ramon_set(uint32_t ramon)
+{
+    UNUSED_PARAMETER(ramon);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_ramon_clr(uint32_t ramon)
+{
+    UNUSED_PARAMETER(ramon);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_ramon_get(uint32_t * p_ramon)
+{
+    if (p_ramon == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_ramon = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_gpregret_set(uint32_t gpregret_msk)
+{
+    m_gpregret |= gpregret_msk;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_gpregret_clr(uint32_t gpregret_msk)
+{
+    m_gpregret &= ~gpregret_msk;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_gpregret_get(uint32_t * p_gpregret)
+{
+    if (p_gpregret == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_gpregret = m_gpregret;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_power_dcdc_mode_set(uint8_t dcdc_mode)
+{
+    UNUSED_PARAMETER(dcdc_mode);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_clock_hfclk_request(void)
+{
+    m_hfclk_running = true;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_clock_hfclk_release(void)
+{
+    m_hfclk_running = false;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_clock_hfclk_is_running(uint32_t * p_is_running)
+{
+    if (p_is_running == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_is_running = m_hfclk_running ? 1 : 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_app_evt_wait(void)
+{
+    // Time only advances in sd_sim_run, there is nothing to wait for.
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_channel_enable_get(uint32_t * p_channel_enable)
+{
+    if (p_channel_enable == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_channel_enable = m_ppi_channels;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_channel_enable_set(uint32_t channel_enable_set_msk)
+{
+    m_ppi_channels |= channel_enable_set_msk;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_channel_enable_clr(uint32_t channel_enable_clr_msk)
+{
+    m_ppi_channels &= ~channel_enable_clr_msk;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_channel_assign(uint8_t               channel_num,
+                               const volatile void * evt_endpoint,
+                               const volatile void * task_endpoint)
+{
+    UNUSED_PARAMETER(channel_num);
+    UNUSED_PARAMETER(evt_endpoint);
+    UNUSED_PARAMETER(task_endpoint);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_group_task_enable(uint8_t group_num)
+{
+    UNUSED_PARAMETER(group_num);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_group_task_disable(uint8_t group_num)
+{
+    UNUSED_PARAMETER(group_num);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_group_assign(uint8_t group_num, uint32_t channel_msk)
+{
+    UNUSED_PARAMETER(group_num);
+    UNUSED_PARAMETER(channel_msk);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ppi_group_get(uint8_t group_num, uint32_t * p_channel_msk)
+{
+    UNUSED_PARAMETER(group_num);
+
+    if (p_channel_msk == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_channel_msk = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_radio_notification_cfg_set(uint8_t type, uint8_t distance)
+{
+    UNUSED_PARAMETER(type);
+    UNUSED_PARAMETER(distance);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_temp_get(int32_t * p_temp)
+{
+    if (p_temp == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_temp = TEMP_ROOM;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_radio_session_open(nrf_radio_signal_callback_t p_radio_signal_callback)
+{
+    UNUSED_PARAMETER(p_radio_signal_callback);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_radio_session_close(void)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_radio_request(nrf_radio_request_t * p_request)
+{
+    UNUSED_PARAMETER(p_request);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+uint32_t sd_softdevice_enable(nrf_clock_lf_cfg_t const * p_clock_lf_cfg, nrf_fault_handler_t fault_handler)
+{
+    UNUSED_PARAMETER(fault_handler);
+
+    if (p_clock_lf_cfg == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (g_sd_sim.enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    g_sd_sim.enabled = true;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_softdevice_disable(void)
+{
+    g_sd_sim.enabled     = false;
+    g_sd_sim.advertising = false;
+    g_sd_sim.connected   = false;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_softdevice_is_enabled(uint8_t * p_softdevice_enabled)
+{
+    if (p_softdevice_enabled == NULL)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    *p_softdevice_enabled = g_sd_sim.enabled ? 1 : 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_softdevice_vector_table_base_set(uint32_t address)
+{
+    UNUSED_PARAMETER(address);
+
+    return NRF_SUCCESS;
+}
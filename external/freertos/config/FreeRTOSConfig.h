@@ -93,9 +93,9 @@
 
 #define configUSE_PREEMPTION                                                      1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION                                   0
-#define configUSE_TICKLESS_IDLE                                                   0
+#define configUSE_TICKLESS_IDLE                                                   1
 #define configCPU_CLOCK_HZ                                                        ( SystemCoreClock )
-#define configTICK_RATE_HZ                                                        1000
+#define configTICK_RATE_HZ                                                        1024 /* Divides the 32768 Hz RTC clock exactly. */
 #define configMAX_PRIORITIES                                                      ( 3 )
 #define configMINIMAL_STACK_SIZE                                                  ( 60 )
 #define configTOTAL_HEAP_SIZE                                                     ( 4096 )
@@ -128,7 +128,7 @@
 #define configMAX_CO_ROUTINE_PRIORITIES                                           ( 2 )
 
 /* Software timer definitions. */
-#define configUSE_TIMERS                                                          0
+#define configUSE_TIMERS                                                          1
 #define configTIMER_TASK_PRIORITY                                                 ( 2 )
 #define configTIMER_QUEUE_LENGTH                                                  32
 #define configTIMER_TASK_STACK_DEPTH                                              ( 80 )
@@ -137,6 +137,9 @@
 #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP                                     2
 
 /* Tickless idle/low power functionality. */
+#if (configUSE_TICKLESS_IDLE == 1) && (configTICK_SOURCE != FREERTOS_USE_RTC)
+    #error Tickless idle requires the RTC tick source.
+#endif
 
 
 /* Define to trap errors during development. */
@@ -145,6 +145,10 @@ void vPortSetupTimerInterrupt( void )
 
 #include "nrf_rtc.h"
 #include "nrf_drv_clock.h"
+#ifdef SOFTDEVICE_PRESENT
+#include "nrf_sdm.h"
+#include "nrf_soc.h"
+#endif
 
 
 /*-----------------------------------------------------------*/
@@ -167,13 +171,16 @@ void xPortSysTickHandler( void )
         TickType_t actualTicks = xTaskGetTickCountFromISR();
         TickType_t hwTicks     = nrf_rtc_counter_get(portNRF_RTC_REG);
 
+        /* The RTC counter runs at the tick rate, so after sleeping the
+        difference is the number of ticks that were suppressed plus the one
+        incremented below. */
         diff = (hwTicks - actualTicks) & portNRF_RTC_MAXTICKS;
-        if(diff <= 0)
+        if(diff == 0)
         {
             break;
         }
 
-        if(diff > 2) // Correct internat ticks
+        if(diff > 1)
         {
             vTaskStepTick(diff - 1);
         }
@@ -211,9 +218,14 @@ void vPortSetupTimerInterrupt( void )
 
 #if configUSE_TICKLESS_IDLE == 1
 
+/* The RTC does not generate a compare event for a CC value less than two
+counts ahead of the counter. */
+#define portNRF_RTC_MIN_CC_DIFF     2
+
 void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 {
     TickType_t wakeupTime;
+    TickType_t now;
 
     /* Make sure the SysTick reload value does not overflow the counter. */
     if( xExpectedIdleTime > portNRF_RTC_MAXTICKS - configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
@@ -226,9 +238,14 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
     /* Stop tick events */
     nrf_rtc_int_disable(portNRF_RTC_REG, NRF_RTC_INT_TICK_MASK);
 
-    /* Configure CTC interrupt */
-    wakeupTime = nrf_rtc_counter_get(portNRF_RTC_REG) + xExpectedIdleTime;
-    wakeupTime &= portNRF_RTC_MAXTICKS;
+    /* Configure CTC interrupt. The wakeup is counted from the tick count, not
+    from the counter, so that time already spent in this tick is not added. */
+    wakeupTime = (xTaskGetTickCount() + xExpectedIdleTime) & portNRF_RTC_MAXTICKS;
+    now        = nrf_rtc_counter_get(portNRF_RTC_REG);
+    if( ((wakeupTime - now) & portNRF_RTC_MAXTICKS) < portNRF_RTC_MIN_CC_DIFF )
+    {
+        wakeupTime = (now + portNRF_RTC_MIN_CC_DIFF) & portNRF_RTC_MAXTICKS;
+    }
     nrf_rtc_cc_set(portNRF_RTC_REG, 0, wakeupTime);
     nrf_rtc_event_clear(portNRF_RTC_REG, NRF_RTC_EVENT_COMPARE_0);
     nrf_rtc_int_enable(portNRF_RTC_REG, NRF_RTC_INT_COMPARE0_MASK);
@@ -243,24 +260,34 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
         configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
         if( xModifiableIdleTime > 0 )
         {
+#ifdef SOFTDEVICE_PRESENT
+            uint8_t sd_enabled = 0;
+
+            (void) sd_softdevice_is_enabled(&sd_enabled);
+#endif
             __DSB();
 #ifdef SOFTDEVICE_PRESENT
-            /* With SD there is no problem with possibility of interrupt lost.
-             * every interrupt is counted and the counter is processed inside
-             * sd_app_evt_wait function. */
-            portENABLE_INTERRUPTS();
-            sd_app_evt_wait();
-#else
-            /* No SD -  we would just block interrupts globally.
-             * BASEPRI cannot be used for that because it would prevent WFE from wake up.
-             */
-            __disable_irq();
-            portENABLE_INTERRUPTS();
-            do{
-                __WFE();
-            } while(0 == (NVIC->ISPR[0] | NVIC->ISPR[1]));
-            __enable_irq();
+            if( sd_enabled )
+            {
+                /* With SD there is no problem with possibility of interrupt lost.
+                 * every interrupt is counted and the counter is processed inside
+                 * sd_app_evt_wait function. */
+                portENABLE_INTERRUPTS();
+                sd_app_evt_wait();
+            }
+            else
 #endif
+            {
+                /* No SD -  we would just block interrupts globally.
+                 * BASEPRI cannot be used for that because it would prevent WFE from wake up.
+                 */
+                __disable_irq();
+                portENABLE_INTERRUPTS();
+                do{
+                    __WFE();
+                } while(0 == (NVIC->ISPR[0] | NVIC->ISPR[1]));
+                __enable_irq();
+            }
         }
         configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
         portENABLE_INTERRUPTS();
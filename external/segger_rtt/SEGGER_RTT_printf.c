@@ -42,7 +42,9 @@ Purpose : Replacement for printf to write formatted data via RTT
 ----------------------------------------------------------------------
 */
 
-#if defined(NRF_LOG_USES_RTT) && NRF_LOG_USES_RTT == 1
+// The deferred logger formats its entries with SEGGER_RTT_printf when it outputs them.
+#if (defined(NRF_LOG_USES_RTT) && NRF_LOG_USES_RTT == 1) || \
+    (defined(NRF_LOG_USES_DEFERRED) && NRF_LOG_USES_DEFERRED == 1)
 
 #include "SEGGER_RTT.h"
 #include "SEGGER_RTT_Conf.h"
@@ -494,6 +496,6 @@ int SEGGER_RTT_printf(unsigned BufferIndex, const char * sFormat, ...) {
 }
 
 
-#endif /* NRF_LOG_USES_RTT == 1 */
+#endif /* NRF_LOG_USES_RTT == 1 || NRF_LOG_USES_DEFERRED == 1 */
 
 /*************************** End of file ****************************/
@@ -0,0 +1,112 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Throughput of the ANCS Data Source parser.
+ *
+ * @details A Get Notification Attributes response is requested and received in notifications of
+ *          the default ATT payload size. The events are built once, so only the client is timed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "host_util.h"
+#include "ancs_harness.h"
+
+#define CHUNK_LEN       20          /**< Notification payload with the default ATT MTU. */
+#define ITERATIONS      200000
+
+static uint16_t const m_attr_lens[BLE_ANCS_NB_OF_ATTRS] =
+{
+    [BLE_ANCS_NOTIF_ATTR_ID_APP_IDENTIFIER] = 32,
+    [BLE_ANCS_NOTIF_ATTR_ID_TITLE]          = 32,
+    [BLE_ANCS_NOTIF_ATTR_ID_MESSAGE]        = 32,
+};
+
+static uint8_t const m_rsp[] =
+{
+    BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES, 0x01, 0x00, 0x00, 0x00,
+    BLE_ANCS_NOTIF_ATTR_ID_APP_IDENTIFIER, 19, 0, 'c','o','m','.','a','p','p','l','e','.',
+                                                  'M','o','b','i','l','e','S','M','S',
+    BLE_ANCS_NOTIF_ATTR_ID_TITLE, 5, 0, 'A','l','i','c','e',
+    BLE_ANCS_NOTIF_ATTR_ID_MESSAGE, 25, 0, 'H','e','l','l','o',' ','t','h','e','r','e',',',' ',
+                                           'l','o','n','g',' ','m','e','s','s','a','g','e',
+};
+
+#define CHUNKS  ((sizeof(m_rsp) + CHUNK_LEN - 1) / CHUNK_LEN)
+
+static union
+{
+    ble_evt_t evt;
+    uint8_t   raw[offsetof(ble_evt_t, evt.gattc_evt.params.hvx.data) + CHUNK_LEN];
+} m_chunks[CHUNKS];
+
+
+int main(void)
+{
+    static ble_ancs_c_t ancs;
+
+    ble_ancs_c_evt_notif_t notif = {.notif_uid = 1};
+    ble_evt_t              write_rsp;
+    uint64_t               start;
+    uint64_t               elapsed;
+    uint32_t               evts = 0;
+
+    memset(&write_rsp, 0, sizeof(write_rsp));
+    write_rsp.header.evt_id             = BLE_GATTC_EVT_WRITE_RSP;
+    write_rsp.evt.gattc_evt.conn_handle = ANCS_HARNESS_CONN_HANDLE;
+
+    for (uint32_t i = 0; i < CHUNKS; i++)
+    {
+        ble_gattc_evt_hvx_t * p_hvx = &m_chunks[i].evt.evt.gattc_evt.params.hvx;
+        uint32_t              len   = sizeof(m_rsp) - i * CHUNK_LEN;
+
+        len = (len > CHUNK_LEN) ? CHUNK_LEN : len;
+        m_chunks[i].evt.header.evt_id             = BLE_GATTC_EVT_HVX;
+        m_chunks[i].evt.evt.gattc_evt.conn_handle = ANCS_HARNESS_CONN_HANDLE;
+        p_hvx->handle = ANCS_HARNESS_DATA_SOURCE;
+        p_hvx->type   = BLE_GATT_HVX_NOTIFICATION;
+        p_hvx->len    = (uint16_t)len;
+        memcpy(p_hvx->data, &m_rsp[i * CHUNK_LEN], len);
+    }
+
+    ancs_harness_init(&ancs, m_attr_lens);
+
+    start = host_time_ns();
+    for (uint32_t n = 0; n < ITERATIONS; n++)
+    {
+        (void)ble_ancs_c_request_attrs(&ancs, &notif);
+        ble_ancs_c_on_ble_evt(&ancs, &write_rsp);
+        for (uint32_t i = 0; i < CHUNKS; i++)
+        {
+            ble_ancs_c_on_ble_evt(&ancs, &m_chunks[i].evt);
+        }
+        evts += g_ancs_evt_count;
+        ancs_harness_clear();
+    }
+    elapsed = host_time_ns() - start;
+
+    ancs_harness_uninit(&ancs);
+
+    if (evts != ITERATIONS * 3)
+    {
+        printf("bench_ble_ancs_c: %u attributes parsed, %u expected\n", evts, ITERATIONS * 3);
+        return 1;
+    }
+    printf("ancs data source: %u-byte chunks, %7.1f MB/s, %6.0f ns per response\n",
+           CHUNK_LEN,
+           (double)ITERATIONS * sizeof(m_rsp) * 1e3 / (double)elapsed,
+           (double)elapsed / ITERATIONS);
+    return 0;
+}
@@ -0,0 +1,94 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Throughput of the decimator filters, per sample and per block.
+ */
+
+#include <stdio.h>
+#include "host_util.h"
+#include "decimator.h"
+
+#define BLOCK_LEN   512
+#define BLOCKS      20000
+
+static int16_t m_in[BLOCK_LEN];
+static int16_t m_out[BLOCK_LEN + 1];
+static volatile int32_t m_sink;     /**< Keeps the results alive. */
+
+
+static void run(char const * p_name, decimator_config_t const * p_config)
+{
+    decimator_t decimator;
+    uint64_t    start;
+    uint64_t    put_ns;
+    uint64_t    block_ns;
+    int32_t     sum = 0;
+
+    (void)decimator_init(&decimator, p_config);
+    start = host_time_ns();
+    for (uint32_t b = 0; b < BLOCKS; b++)
+    {
+        for (uint32_t i = 0; i < BLOCK_LEN; i++)
+        {
+            int16_t out;
+            if (decimator_put(&decimator, m_in[i], &out))
+            {
+                sum += out;
+            }
+        }
+    }
+    put_ns = host_time_ns() - start;
+
+    (void)decimator_init(&decimator, p_config);
+    start = host_time_ns();
+    for (uint32_t b = 0; b < BLOCKS; b++)
+    {
+        uint16_t count = decimator_process(&decimator, m_in, BLOCK_LEN, 1, m_out);
+        sum += m_out[count / 2];
+    }
+    block_ns = host_time_ns() - start;
+
+    m_sink = sum;
+    printf("%-8s factor %3u: put %7.1f Msamples/s, process %7.1f Msamples/s\n",
+           p_name,
+           p_config->factor,
+           (double)BLOCKS * BLOCK_LEN * 1e3 / (double)put_ns,
+           (double)BLOCKS * BLOCK_LEN * 1e3 / (double)block_ns);
+}
+
+
+int main(void)
+{
+    static const uint16_t factors[] = {4, 16, 64};
+
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < BLOCK_LEN; i++)
+    {
+        m_in[i] = (int16_t)host_rand(&seed);
+    }
+
+    for (uint32_t i = 0; i < sizeof(factors) / sizeof(factors[0]); i++)
+    {
+        decimator_config_t average = {.filter = DECIMATOR_FILTER_AVERAGE, .factor = factors[i]};
+        decimator_config_t cic2    = {.filter = DECIMATOR_FILTER_CIC2,    .factor = factors[i]};
+        decimator_config_t ema     = {.filter = DECIMATOR_FILTER_EMA,     .factor = factors[i],
+                                      .ema_shift = 4};
+
+        run("average", &average);
+        run("cic2",    &cic2);
+        run("ema",     &ema);
+    }
+    return 0;
+}
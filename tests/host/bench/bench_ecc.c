@@ -0,0 +1,163 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Cost of the P-256 operations of the ECC module: key pair, public key and shared secret.
+ *
+ * @details The module is built as applications without ECC_ASYNC_ENABLED build it, without the
+ *          scheduler, so every call computes in place. The shared secret is checked against the
+ *          LE Secure Connections sample data of the Bluetooth Core Specification.
+ *
+ *          On x86 the figures include TSC ticks per call. They are host figures, micro-ecc runs
+ *          with 64-bit words here: use them to compare builds of micro-ecc, not to predict
+ *          Cortex-M cycle counts.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host_util.h"
+#include "nrf_error.h"
+#include "nrf_drv_rng.h"
+#include "ecc.h"
+
+#define CALLS           500
+
+typedef enum
+{
+    OP_KEYPAIR,         /**< ecc_p256_keypair_gen(). */
+    OP_PUBLIC_KEY,      /**< ecc_p256_public_key_compute(). */
+    OP_SHARED_SECRET,   /**< ecc_p256_shared_secret_compute(). */
+} op_t;
+
+typedef struct
+{
+    uint64_t ns;
+    uint64_t cycles;
+} cost_t;
+
+/** Private key of device A and public key of device B, little endian, and their DHKey. */
+static uint32_t m_sk_a[ECC_P256_SK_LEN / sizeof(uint32_t)] =
+{
+    0xcd3c1abd, 0x5899b8a6, 0xeb40b799, 0x4aff607b, 0xd2103f50, 0x74c9b3e3, 0xa3c55f38, 0x3f49f6d4
+};
+static uint32_t m_pk_b[ECC_P256_PK_LEN / sizeof(uint32_t)] =
+{
+    0x2faaa190, 0x559077b2, 0x8615a69f, 0x47b58afd, 0xf19e4c00, 0x09592284, 0x1faf1d96, 0x1ea1f0f0,
+    0x15b1214a, 0x5f89aff9, 0xe28e3676, 0x472d1130, 0x9ab85160, 0x7356703a, 0x429dad37, 0x4c55f33e
+};
+static uint32_t const m_dhkey[ECC_P256_SK_LEN / sizeof(uint32_t)] =
+{
+    0x73bfa698, 0x868d34f3, 0xb4f866f1, 0x99796b13, 0x0a397d9b, 0x341010a6, 0x57c8ad05, 0xec0234a3
+};
+
+static uint32_t m_rng_state = 0x2545F491;
+
+
+ret_code_t nrf_drv_rng_block_rand(uint8_t * p_buff, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        p_buff[i] = (uint8_t)host_rand(&m_rng_state);
+    }
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for timing one operation.
+ *
+ * @return  Number of calls that did not return NRF_SUCCESS or gave a wrong shared secret.
+ */
+static uint32_t run(op_t op, cost_t * p_cost)
+{
+    uint32_t sk[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t pk[ECC_P256_PK_LEN / sizeof(uint32_t)];
+    uint32_t ss[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t errors = 0;
+    uint64_t start_ns;
+    uint64_t start_cycles;
+
+    *p_cost = (cost_t){0};
+
+    for (uint32_t n = 0; n < CALLS; n++)
+    {
+        ret_code_t err_code = NRF_SUCCESS;
+
+        start_ns     = host_time_ns();
+        start_cycles = host_cycles();
+        switch (op)
+        {
+            case OP_KEYPAIR:
+                err_code = ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk);
+                break;
+
+            case OP_PUBLIC_KEY:
+                err_code = ecc_p256_public_key_compute((uint8_t *)m_sk_a, (uint8_t *)pk);
+                break;
+
+            case OP_SHARED_SECRET:
+                err_code = ecc_p256_shared_secret_compute((uint8_t *)m_sk_a, (uint8_t *)m_pk_b,
+                                                          (uint8_t *)ss);
+                break;
+        }
+        p_cost->cycles += host_cycles() - start_cycles;
+        p_cost->ns     += host_time_ns() - start_ns;
+
+        if (   (err_code != NRF_SUCCESS)
+            || ((op == OP_SHARED_SECRET) && (memcmp(ss, m_dhkey, sizeof(ss)) != 0)))
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+
+int main(void)
+{
+    static const struct
+    {
+        op_t         op;
+        char const * p_name;
+    } runs[] =
+    {
+        {OP_KEYPAIR,       "keypair"},
+        {OP_PUBLIC_KEY,    "public key"},
+        {OP_SHARED_SECRET, "shared secret"},
+    };
+
+    cost_t   cost;
+    uint32_t errors;
+    int      err = 0;
+
+    ecc_init();
+
+    for (uint32_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++)
+    {
+        errors = run(runs[i].op, &cost);
+        if (errors != 0)
+        {
+            printf("bench_ecc: %s: %u of %u calls failed\n", runs[i].p_name, errors, CALLS);
+            err = 1;
+            continue;
+        }
+        printf("ecc %-16s %8.1f us per call", runs[i].p_name, (double)cost.ns / CALLS / 1e3);
+        if (cost.cycles != 0)
+        {
+            printf(", %10.0f TSC ticks per call", (double)cost.cycles / CALLS);
+        }
+        printf("\n");
+    }
+
+    return err;
+}
@@ -0,0 +1,309 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Identity resolution of connecting peers in the ID Manager.
+ *
+ * @details The peer database and the connection state are kept in RAM by this file, the AES
+ *          encryption of the ECB is the software one of the SoftDevice emulator. Each run connects
+ *          peers that use resolvable private addresses and checks that they are matched to the
+ *          right bond:
+ *          - "scan": every bond read from the peer database and resolved with
+ *            im_address_resolve(), as connections were matched before the identity cache.
+ *          - "new address": the connect event, each address seen for the first time.
+ *          - "reconnect": the connect event, with an address that was resolved recently.
+ *
+ *          With more bonds than IM_PEER_CACHE_SIZE, the bonds that do not fit are still read from
+ *          the peer database.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host_util.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "ble.h"
+#include "ble_conn_state.h"
+#include "id_manager.h"
+#include "peer_database.h"
+#include "peer_manager_internal.h"
+
+#define MAX_PEERS       32
+#define ADDRS           1024        /**< Distinct addresses used by the connecting peers. */
+#define CONNECTS        200000
+#define CONN_HANDLES    8
+
+void ah(uint8_t const * p_k, uint8_t const * p_r, uint8_t * p_local_hash);
+
+typedef enum
+{
+    RUN_SCAN,
+    RUN_NEW_ADDRESS,
+    RUN_RECONNECT,
+} run_t;
+
+static pm_peer_data_bonding_t m_bonds[MAX_PEERS];
+static uint32_t               m_peer_count;
+static pdb_evt_handler_t      m_pdb_evt_handler;
+static bool                   m_conn_flags[CONN_HANDLES];
+static uint16_t               m_bonded_conn_handle;     /**< Connection of the last bonded peer event. */
+
+static ble_gap_addr_t         m_addrs[ADDRS];
+static pm_peer_id_t           m_addr_peers[ADDRS];      /**< Peer that each address belongs to. */
+static uint32_t               m_rand = 0x2545F491;
+
+
+pm_peer_id_t pdb_next_peer_id_get(pm_peer_id_t prev_peer_id)
+{
+    pm_peer_id_t next = (prev_peer_id == PM_PEER_ID_INVALID) ? 0 : prev_peer_id + 1;
+
+    return (next < m_peer_count) ? next : PM_PEER_ID_INVALID;
+}
+
+
+ret_code_t pdb_read_buf_get(pm_peer_id_t           peer_id,
+                            pm_peer_data_id_t      data_id,
+                            pm_peer_data_flash_t * p_peer_data,
+                            pm_store_token_t     * p_token)
+{
+    if ((peer_id >= m_peer_count) || (data_id != PM_PEER_DATA_ID_BONDING))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    p_peer_data->data_id        = data_id;
+    p_peer_data->p_bonding_data = &m_bonds[peer_id];
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pdb_register(pdb_evt_handler_t evt_handler)
+{
+    m_pdb_evt_handler = evt_handler;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pdb_peer_free(pm_peer_id_t peer_id)
+{
+    return NRF_SUCCESS;
+}
+
+
+ble_conn_state_user_flag_id_t ble_conn_state_user_flag_acquire(void)
+{
+    return BLE_CONN_STATE_USER_FLAG0;
+}
+
+
+bool ble_conn_state_user_flag_get(uint16_t conn_handle, ble_conn_state_user_flag_id_t flag_id)
+{
+    return (conn_handle < CONN_HANDLES) && m_conn_flags[conn_handle];
+}
+
+
+void ble_conn_state_user_flag_set(uint16_t                      conn_handle,
+                                  ble_conn_state_user_flag_id_t flag_id,
+                                  bool                          value)
+{
+    if (conn_handle < CONN_HANDLES)
+    {
+        m_conn_flags[conn_handle] = value;
+    }
+}
+
+
+ble_conn_state_status_t ble_conn_state_status(uint16_t conn_handle)
+{
+    return BLE_CONN_STATUS_DISCONNECTED;
+}
+
+
+static void im_evt_handler(im_evt_t const * p_event)
+{
+    if (p_event->evt_id == IM_EVT_BONDED_PEER_CONNECTED)
+    {
+        m_bonded_conn_handle = p_event->conn_handle;
+    }
+}
+
+
+/**@brief Function for bonding peers up to the given count, telling the ID Manager as flash would. */
+static void peers_bond(uint32_t count)
+{
+    while (m_peer_count < count)
+    {
+        pm_peer_data_bonding_t * p_bond = &m_bonds[m_peer_count];
+        pdb_evt_t                evt;
+
+        for (uint32_t i = 0; i < BLE_GAP_SEC_KEY_LEN; i++)
+        {
+            p_bond->peer_id.id_info.irk[i] = (uint8_t)host_rand(&m_rand);
+        }
+        p_bond->peer_id.id_addr_info.addr_type = BLE_GAP_ADDR_TYPE_PUBLIC;
+        for (uint32_t i = 0; i < BLE_GAP_ADDR_LEN; i++)
+        {
+            p_bond->peer_id.id_addr_info.addr[i] = (uint8_t)host_rand(&m_rand);
+        }
+
+        evt.evt_id  = PDB_EVT_RAW_STORED;
+        evt.peer_id = (pm_peer_id_t)m_peer_count++;
+        evt.data_id = PM_PEER_DATA_ID_BONDING;
+        m_pdb_evt_handler(&evt);
+    }
+}
+
+
+/**@brief Function for creating the addresses of the connecting peers, picked among the bonds. */
+static void addrs_create(void)
+{
+    for (uint32_t n = 0; n < ADDRS; n++)
+    {
+        ble_gap_addr_t * p_addr = &m_addrs[n];
+        pm_peer_id_t     peer_id = (pm_peer_id_t)(host_rand(&m_rand) % m_peer_count);
+
+        // prand in the upper half with its two most significant bits 0b01, hash in the lower.
+        p_addr->addr_type = BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE;
+        p_addr->addr[3]   = (uint8_t)host_rand(&m_rand);
+        p_addr->addr[4]   = (uint8_t)host_rand(&m_rand);
+        p_addr->addr[5]   = (uint8_t)((host_rand(&m_rand) & 0x3F) | 0x40);
+        ah(m_bonds[peer_id].peer_id.id_info.irk, &p_addr->addr[3], &p_addr->addr[0]);
+        m_addr_peers[n] = peer_id;
+    }
+}
+
+
+/**@brief Function for matching an address the way connections were matched before the cache. */
+static pm_peer_id_t scan_peer_find(ble_gap_addr_t const * p_addr)
+{
+    pm_peer_id_t peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
+
+    while (peer_id != PM_PEER_ID_INVALID)
+    {
+        pm_peer_data_flash_t data;
+
+        if (   (pdb_read_buf_get(peer_id, PM_PEER_DATA_ID_BONDING, &data, NULL) == NRF_SUCCESS)
+            && im_address_resolve(p_addr, &data.p_bonding_data->peer_id.id_info))
+        {
+            return peer_id;
+        }
+        peer_id = pdb_next_peer_id_get(peer_id);
+    }
+    return PM_PEER_ID_INVALID;
+}
+
+
+/**@brief Function for connecting a peer through the ID Manager, then disconnecting it.
+ *
+ * @return The bond the peer was matched to, or PM_PEER_ID_INVALID.
+ */
+static pm_peer_id_t connect_peer_find(ble_gap_addr_t const * p_addr, uint16_t conn_handle)
+{
+    ble_evt_t    evt = {0};
+    pm_peer_id_t peer_id;
+
+    evt.header.evt_id                            = BLE_GAP_EVT_CONNECTED;
+    evt.evt.gap_evt.conn_handle                  = conn_handle;
+    evt.evt.gap_evt.params.connected.peer_addr   = *p_addr;
+    evt.evt.gap_evt.params.connected.irk_match   = 0;
+
+    m_bonded_conn_handle = BLE_CONN_HANDLE_INVALID;
+    im_ble_evt_handler(&evt);
+    peer_id = (m_bonded_conn_handle == conn_handle) ? im_peer_id_get_by_conn_handle(conn_handle)
+                                                    : PM_PEER_ID_INVALID;
+
+    // Disconnected, as ble_conn_state clears the user flags.
+    ble_conn_state_user_flag_set(conn_handle, BLE_CONN_STATE_USER_FLAG0, false);
+    return peer_id;
+}
+
+
+static int run(run_t run, char const * p_name)
+{
+    uint32_t errors = 0;
+    uint64_t start;
+    uint64_t elapsed;
+
+    start = host_time_ns();
+    for (uint32_t n = 0; n < CONNECTS; n++)
+    {
+        // Reconnects cycle through fewer addresses than IM_RPA_CACHE_SIZE.
+        uint32_t     index = (run == RUN_RECONNECT) ? (n % 2) : (n % ADDRS);
+        pm_peer_id_t peer_id;
+
+        if (run == RUN_SCAN)
+        {
+            peer_id = scan_peer_find(&m_addrs[index]);
+        }
+        else
+        {
+            peer_id = connect_peer_find(&m_addrs[index], (uint16_t)(n % CONN_HANDLES));
+        }
+        errors += (peer_id != m_addr_peers[index]);
+    }
+    elapsed = host_time_ns() - start;
+
+    if (errors != 0)
+    {
+        printf("bench_id_manager: %u peers %s: %u of %u connections not matched\n",
+               m_peer_count, p_name, errors, CONNECTS);
+        return 1;
+    }
+    printf("id_manager %2u peers %-12s %8.1f ns per connection\n",
+           m_peer_count, p_name, (double)elapsed / CONNECTS);
+    return 0;
+}
+
+
+/**@brief Function for checking ah() against the sample data of the Bluetooth Core Specification. */
+static int ah_check(void)
+{
+    // IRK ec0234a357c8ad05341010a60a397d9b, prand 708194, hash 0dfbaa, least significant first.
+    static uint8_t const irk[BLE_GAP_SEC_KEY_LEN] =
+    {
+        0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
+        0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
+    };
+    static uint8_t const prand[3]    = {0x94, 0x81, 0x70};
+    static uint8_t const expected[3] = {0xaa, 0xfb, 0x0d};
+
+    uint8_t hash[3];
+
+    ah(irk, prand, hash);
+    if (memcmp(hash, expected, sizeof(hash)) != 0)
+    {
+        printf("bench_id_manager: ah() does not match the specification sample\n");
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(void)
+{
+    static uint32_t const peer_counts[] = {1, 8, 16, MAX_PEERS};
+
+    int err = ah_check();
+
+    (void)im_register(im_evt_handler);
+
+    for (uint32_t i = 0; (i < sizeof(peer_counts) / sizeof(peer_counts[0])) && (err == 0); i++)
+    {
+        peers_bond(peer_counts[i]);
+        addrs_create();
+
+        err |= run(RUN_SCAN,        "scan");
+        err |= run(RUN_NEW_ADDRESS, "new address");
+        err |= run(RUN_RECONNECT,   "reconnect");
+    }
+    return err;
+}
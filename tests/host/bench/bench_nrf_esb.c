@@ -0,0 +1,239 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Packets per second through the ESB FIFOs, with the RADIO registers in RAM.
+ *
+ * @details The bench plays the RADIO: it sets EVENTS_DISABLED and calls the RADIO IRQ handler
+ *          where the hardware would, and runs the event IRQ when it is pending. Only driver time
+ *          is measured, so the figures compare the copy and the zero-copy FIFO paths.
+ *
+ *          PTX sends 32-byte payloads without ACK. PRX receives 32-byte payloads and ACKs them,
+ *          and the event IRQ runs once every RX_EVT_INTERVAL packets, as it does when it has a
+ *          lower priority than the radio.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host_util.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_esb.h"
+
+#define PAYLOAD_LEN         32
+#define PACKETS             2000000
+#define RX_EVT_INTERVAL     4           /**< Packets received between two runs of the event IRQ. */
+
+void RADIO_IRQHandler(void);
+void ESB_EVT_IRQHandler(void);
+
+typedef enum
+{
+    MODE_COPY,          /**< nrf_esb_write_payload, nrf_esb_read_rx_payload per packet. */
+    MODE_BURST,         /**< nrf_esb_read_rx_payloads for all packets in the FIFO. */
+    MODE_ZERO_COPY,     /**< Reserve/commit and borrow/release. */
+} bench_mode_t;
+
+static bench_mode_t      m_mode;
+static uint32_t          m_done;            /**< Payloads sent or read by the application. */
+static volatile uint32_t m_sink;            /**< Keeps the payload reads alive. */
+
+
+static void esb_evt_handler(nrf_esb_evt_t const * p_event)
+{
+    nrf_esb_payload_t         payloads[NRF_ESB_RX_FIFO_SIZE];
+    nrf_esb_payload_t const * p_payload;
+    uint32_t                  count;
+
+    if (p_event->evt_id != NRF_ESB_EVENT_RX_RECEIVED)
+    {
+        return;
+    }
+
+    switch (m_mode)
+    {
+        case MODE_COPY:
+            while (nrf_esb_read_rx_payload(&payloads[0]) == NRF_SUCCESS)
+            {
+                m_sink += payloads[0].data[0];
+                m_done++;
+            }
+            break;
+
+        case MODE_BURST:
+            if (nrf_esb_read_rx_payloads(payloads, NRF_ESB_RX_FIFO_SIZE, &count) == NRF_SUCCESS)
+            {
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    m_sink += payloads[i].data[0];
+                }
+                m_done += count;
+            }
+            break;
+
+        case MODE_ZERO_COPY:
+            while (nrf_esb_rx_payload_borrow(&p_payload) == NRF_SUCCESS)
+            {
+                m_sink += p_payload->data[0];
+                (void)nrf_esb_rx_payload_release();
+                m_done++;
+            }
+            break;
+    }
+}
+
+
+static void evt_irq_run(void)
+{
+    if (NVIC_GetPendingIRQ(ESB_EVT_IRQ))
+    {
+        NVIC_ClearPendingIRQ(ESB_EVT_IRQ);
+        ESB_EVT_IRQHandler();
+    }
+}
+
+
+/**@brief Function for ending the current radio operation, as EVENTS_DISABLED would. */
+static void radio_disabled(void)
+{
+    NRF_RADIO->EVENTS_DISABLED = 1;
+    RADIO_IRQHandler();
+}
+
+
+static void esb_start(nrf_esb_mode_t mode)
+{
+    nrf_esb_config_t config = NRF_ESB_DEFAULT_CONFIG;
+
+    host_periph_reset();
+    config.mode               = mode;
+    config.event_handler      = esb_evt_handler;
+    config.selective_auto_ack = true;
+    (void)nrf_esb_init(&config);
+    m_done = 0;
+}
+
+
+static uint64_t ptx_run(bench_mode_t mode)
+{
+    static nrf_esb_payload_t payload = {.length = PAYLOAD_LEN, .pipe = 0, .noack = true};
+
+    uint64_t start;
+
+    m_mode = mode;
+    esb_start(NRF_ESB_MODE_PTX);
+
+    start = host_time_ns();
+    while (m_done < PACKETS)
+    {
+        nrf_esb_payload_t * p_slot;
+
+        // Fill the FIFO, then let the radio empty it.
+        for (uint32_t i = 0; i < NRF_ESB_TX_FIFO_SIZE; i++)
+        {
+            if (mode == MODE_ZERO_COPY)
+            {
+                (void)nrf_esb_tx_payload_reserve(&p_slot);
+                p_slot->length  = PAYLOAD_LEN;
+                p_slot->pipe    = 0;
+                p_slot->noack   = true;
+                memset(p_slot->data, (uint8_t)m_done, PAYLOAD_LEN);
+                (void)nrf_esb_tx_payload_commit(true);
+            }
+            else
+            {
+                memset(payload.data, (uint8_t)m_done, PAYLOAD_LEN);
+                (void)nrf_esb_write_payload(&payload);
+            }
+        }
+        while (!nrf_esb_is_idle())
+        {
+            radio_disabled();
+            m_done++;
+        }
+        evt_irq_run();
+    }
+    return host_time_ns() - start;
+}
+
+
+static uint64_t prx_run(bench_mode_t mode)
+{
+    uint8_t * p_rf_buf;
+    uint64_t  start;
+
+    m_mode = mode;
+    esb_start(NRF_ESB_MODE_PRX);
+    (void)nrf_esb_start_rx();
+
+    // The RX packet buffer of the driver, the program is linked without PIE.
+    p_rf_buf = (uint8_t *)(uintptr_t)NRF_RADIO->PACKETPTR;
+
+    start = host_time_ns();
+    for (uint32_t n = 0; n < PACKETS; n++)
+    {
+        // A new packet with ACK requested: length, PID and no-ACK bit, then the data.
+        p_rf_buf[0] = PAYLOAD_LEN;
+        p_rf_buf[1] = (uint8_t)((n & 0x03) << 1);
+        memset(&p_rf_buf[2], (uint8_t)n, PAYLOAD_LEN);
+        NRF_RADIO->CRCSTATUS = 1;
+        NRF_RADIO->RXCRC     = n + 1;
+        NRF_RADIO->RXMATCH   = 0;
+        radio_disabled();
+
+        // ACK sent, back to RX.
+        radio_disabled();
+
+        if ((n % RX_EVT_INTERVAL) == RX_EVT_INTERVAL - 1)
+        {
+            evt_irq_run();
+        }
+    }
+    evt_irq_run();
+    return host_time_ns() - start;
+}
+
+
+static int report(char const * p_name, uint64_t elapsed_ns)
+{
+    nrf_esb_fifo_stats_t stats;
+
+    (void)nrf_esb_fifo_stats_get(&stats);
+    (void)nrf_esb_disable();
+    if (m_done != PACKETS || stats.rx_dropped != 0)
+    {
+        printf("bench_nrf_esb: %s: %u packets, %u dropped, %u expected\n",
+               p_name, m_done, stats.rx_dropped, PACKETS);
+        return 1;
+    }
+    printf("esb %-16s %6.2f Mpackets/s, %5.1f ns per packet\n",
+           p_name,
+           (double)PACKETS * 1e3 / (double)elapsed_ns,
+           (double)elapsed_ns / PACKETS);
+    return 0;
+}
+
+
+int main(void)
+{
+    int err = 0;
+
+    err |= report("ptx write",        ptx_run(MODE_COPY));
+    err |= report("ptx reserve",      ptx_run(MODE_ZERO_COPY));
+    err |= report("prx read",         prx_run(MODE_COPY));
+    err |= report("prx read burst",   prx_run(MODE_BURST));
+    err |= report("prx borrow",       prx_run(MODE_ZERO_COPY));
+
+    (void)m_sink;
+    return err;
+}
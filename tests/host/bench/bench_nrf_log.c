@@ -0,0 +1,173 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Cost of a log call in the deferred logger, against formatting to RTT in place.
+ *
+ * @details The deferred calls are timed on their own, the entries are then output with
+ *          NRF_LOG_PROCESS outside of the measurement, as the idle loop would. That output is
+ *          timed separately. The RTT up buffer is emptied after every batch, playing the debugger.
+ *
+ *          On x86 the figures include TSC ticks per call. They are host figures: use them to
+ *          compare the log paths, not to predict Cortex-M cycle counts.
+ */
+
+#include <stdio.h>
+#include "host_util.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_log.h"
+#include "SEGGER_RTT.h"
+
+#define CALLS           4000000
+#define BATCH           32          /**< Entries per batch, the ring holds them with 6 arguments. */
+
+typedef enum
+{
+    CALL_ARGS_0,        /**< NRF_LOG_PRINTF with a plain format. */
+    CALL_ARGS_2,        /**< NRF_LOG_PRINTF with two arguments. */
+    CALL_ARGS_6,        /**< NRF_LOG_PRINTF with the maximum number of arguments. */
+    CALL_STRING,        /**< NRF_LOG with one string. */
+    CALL_RTT_PRINTF,    /**< SEGGER_RTT_printf with two arguments, what the RTT backend does. */
+} call_t;
+
+typedef struct
+{
+    uint64_t ns;
+    uint64_t cycles;
+} cost_t;
+
+static volatile uint32_t m_arg;             /**< Keeps the arguments from being folded. */
+
+
+static void rtt_drain(void)
+{
+    _SEGGER_RTT.aUp[LOG_TERMINAL_NORMAL].RdOff = _SEGGER_RTT.aUp[LOG_TERMINAL_NORMAL].WrOff;
+}
+
+
+static void log_call(call_t call, uint32_t n)
+{
+    switch (call)
+    {
+        case CALL_ARGS_0:
+            NRF_LOG_PRINTF("tick\r\n");
+            break;
+
+        case CALL_ARGS_2:
+            NRF_LOG_PRINTF("rx %d bytes on pipe %d\r\n", n, m_arg);
+            break;
+
+        case CALL_ARGS_6:
+            NRF_LOG_PRINTF("%d %d %d %d %d %d\r\n", n, m_arg, n, m_arg, n, m_arg);
+            break;
+
+        case CALL_STRING:
+            NRF_LOG("connected\r\n");
+            break;
+
+        case CALL_RTT_PRINTF:
+            (void)SEGGER_RTT_printf(LOG_TERMINAL_NORMAL, "rx %d bytes on pipe %d\r\n", n, m_arg);
+            break;
+    }
+}
+
+
+/**@brief Function for timing the log calls and, separately, the output of the entries. */
+static void run(call_t call, cost_t * p_call, cost_t * p_process)
+{
+    uint64_t start_ns;
+    uint64_t start_cycles;
+
+    *p_call    = (cost_t){0};
+    *p_process = (cost_t){0};
+
+    for (uint32_t n = 0; n < CALLS; n += BATCH)
+    {
+        start_ns     = host_time_ns();
+        start_cycles = host_cycles();
+        for (uint32_t i = 0; i < BATCH; i++)
+        {
+            log_call(call, n + i);
+        }
+        p_call->cycles += host_cycles() - start_cycles;
+        p_call->ns     += host_time_ns() - start_ns;
+
+        start_ns     = host_time_ns();
+        start_cycles = host_cycles();
+        while (NRF_LOG_PROCESS())
+        {
+        }
+        p_process->cycles += host_cycles() - start_cycles;
+        p_process->ns     += host_time_ns() - start_ns;
+
+        rtt_drain();
+    }
+}
+
+
+static void report(char const * p_name, cost_t const * p_cost)
+{
+    printf("nrf_log %-24s %6.1f ns per call", p_name, (double)p_cost->ns / CALLS);
+    if (p_cost->cycles != 0)
+    {
+        printf(", %6.1f TSC ticks per call", (double)p_cost->cycles / CALLS);
+    }
+    printf("\n");
+}
+
+
+int main(void)
+{
+    static const struct
+    {
+        call_t       call;
+        char const * p_name;
+    } runs[] =
+    {
+        {CALL_ARGS_0,     "printf 0 args"},
+        {CALL_ARGS_2,     "printf 2 args"},
+        {CALL_ARGS_6,     "printf 6 args"},
+        {CALL_STRING,     "string"},
+        {CALL_RTT_PRINTF, "rtt printf 2 args"},
+    };
+
+    cost_t call;
+    cost_t process;
+
+    if (NRF_LOG_INIT() != NRF_SUCCESS)
+    {
+        printf("bench_nrf_log: init failed\n");
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++)
+    {
+        run(runs[i].call, &call, &process);
+        report(runs[i].p_name, &call);
+        if (runs[i].call != CALL_RTT_PRINTF)
+        {
+            char name[32];
+
+            (void)snprintf(name, sizeof(name), "%s output", runs[i].p_name);
+            report(name, &process);
+        }
+    }
+
+    if (log_deferred_dropped_get() != 0)
+    {
+        printf("bench_nrf_log: %u entries dropped\n", log_deferred_dropped_get());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Records per second decoded by rtt_stream_reader, for several payload sizes.
+ *
+ * @details The producer fills the up-buffer with rtt_stream_write until a record is dropped, then
+ *          the reader empties it from the live control block, releasing each record, as a debug
+ *          probe would. Each payload is copied out, as a tool saving the stream does. Only the
+ *          reader is in the main figures, the write cost per record is printed next to them.
+ *
+ *          Every payload carries a sequence number, and the drop counts of the headers must
+ *          account for the records the producer could not write.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host_util.h"
+#include "nrf_error.h"
+#include "SEGGER_RTT.h"
+#include "rtt_stream.h"
+#include "rtt_stream_reader.h"
+
+#define RECORDS         4000000
+#define STREAM_ID       1
+#define MAX_LENGTH      240
+
+typedef struct
+{
+    uint64_t read_ns;
+    uint64_t write_ns;
+    uint64_t bytes;
+} cost_t;
+
+
+/**@brief Function for streaming @ref RECORDS records of one payload length.
+ *
+ * @return  Number of records missing, out of order or with a wrong length.
+ */
+static uint32_t run(uint16_t length, cost_t * p_cost)
+{
+    static uint8_t      data[MAX_LENGTH];
+    static uint8_t      sink[MAX_LENGTH];
+    rtt_stream_reader_t reader;
+    rtt_stream_hdr_t    hdr;
+    uint8_t const     * p_payload;
+    uint32_t            written = 0;
+    uint32_t            read    = 0;
+    uint32_t            errors  = 0;
+    uint64_t            start;
+
+    *p_cost = (cost_t){0};
+    memset(data, 0x5A, sizeof(data));
+    if (   (rtt_stream_init() != NRF_SUCCESS)
+        || (rtt_stream_reader_ring_init(&reader, &_SEGGER_RTT.aUp[RTT_STREAM_BUFFER_INDEX])
+            != NRF_SUCCESS))
+    {
+        return RECORDS;
+    }
+
+    while (read < RECORDS)
+    {
+        start = host_time_ns();
+        for (;;)
+        {
+            memcpy(data, &written, sizeof(written));
+            if (rtt_stream_write(STREAM_ID, data, length) != NRF_SUCCESS)
+            {
+                break;
+            }
+            written++;
+        }
+        p_cost->write_ns += host_time_ns() - start;
+
+        start = host_time_ns();
+        while (rtt_stream_reader_next(&reader, &hdr, &p_payload))
+        {
+            uint32_t seq = ~read;
+
+            if (hdr.length == length)
+            {
+                memcpy(sink, p_payload, length);
+                memcpy(&seq, sink, sizeof(seq));
+            }
+            if ((hdr.stream_id != STREAM_ID) || (seq != read))
+            {
+                errors++;
+            }
+            read++;
+        }
+        p_cost->read_ns += host_time_ns() - start;
+    }
+
+    // The record dropped by the last fill is reported by the next one, which is not written.
+    if (   (read != written)
+        || (reader.stats.dropped + 1 != rtt_stream_dropped_get(STREAM_ID))
+        || (reader.stats.errors != 0)
+        || (sink[length - 1] != data[length - 1]))
+    {
+        errors++;
+    }
+    p_cost->bytes = reader.stats.bytes;
+
+    return errors;
+}
+
+
+int main(void)
+{
+    static const uint16_t lengths[] = {4, 16, 64, MAX_LENGTH};
+
+    cost_t   cost;
+    uint32_t errors;
+    int      err = 0;
+
+    for (uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        errors = run(lengths[i], &cost);
+        if (errors != 0)
+        {
+            printf("bench_rtt_stream: %u-byte records: %u errors\n", lengths[i], errors);
+            err = 1;
+            continue;
+        }
+        printf("rtt_stream reader %3u-byte records %7.2f Mrecords/s, %7.1f MB/s, write %5.1f ns per record\n",
+               lengths[i],
+               (double)RECORDS * 1e3 / (double)cost.read_ns,
+               (double)cost.bytes * 1e3 / (double)cost.read_ns,
+               (double)cost.write_ns / RECORDS);
+    }
+
+    return err;
+}
@@ -0,0 +1,324 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Running Speed and Cadence and data sync Services of ble_app_rscs on the SoftDevice emulator.
+ *
+ * @details The services are registered with ble_evt_router as ble_app_rscs does, the event pump
+ *          stands in for softdevice_handler. The virtual central connects, subscribes to the RSC
+ *          Measurement and to the data sync Control Point, then writes a request to the Control
+ *          Point every CTRL_PT_PERIOD_MS. The application streams measurements: it fills the TX
+ *          buffers when notifications are enabled and on each BLE_EVT_TX_COMPLETE.
+ *
+ *          Each run reports, for one connection interval and TX buffer count, the notifications
+ *          received per simulated second, their mean time from sd_ble_gatts_hvx to reception, and
+ *          the host time spent in the event pump per call. Every Control Point request must be
+ *          answered.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "nrf_error.h"
+#include "ble.h"
+#include "ble_srv_common.h"
+#include "ble_evt_router.h"
+#include "ble_rscs.h"
+#include "ble_data_sync.h"
+#include "sd_sim.h"
+
+#define SETTLE_MS           1000        /**< Time given to the connection and the subscriptions. */
+#define RUN_MS              20000
+#define DRAIN_MS            1000        /**< Time given to the queued notifications once the streaming stops. */
+#define CTRL_PT_PERIOD_MS   250
+#define CTRL_PT_REQUEST     0x5A        /**< Control Point request answered by the data sync Service. */
+#define PACKETS_PER_EVENT   6
+
+/**@brief Event buffer, aligned for ble_evt_t and large enough for a write of a full ATT payload. */
+typedef union
+{
+    ble_evt_t evt;
+    uint8_t   buf[sizeof(ble_evt_t) + GATT_MTU_SIZE_DEFAULT];
+} evt_buf_t;
+
+static ble_rscs_t      m_rscs;
+static ble_data_sync_t m_data_sync;
+static bool            m_routes_registered;
+static bool            m_streaming;
+static ble_rscs_meas_t m_meas;
+static uint32_t        m_meas_queued;       /**< Measurements accepted by sd_ble_gatts_hvx. */
+static uint32_t        m_ctrl_pt_writes;    /**< Control Point requests queued by the central. */
+static uint32_t        m_errors;
+
+
+static void rscs_ble_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_rscs_on_ble_evt((ble_rscs_t *)p_context, p_ble_evt);
+}
+
+
+static void data_sync_ble_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_data_sync_on_ble_evt((ble_data_sync_t *)p_context, p_ble_evt);
+}
+
+
+/**@brief Function for sending measurements until the TX buffers are full. */
+static void measurements_send(void)
+{
+    uint32_t err_code = NRF_SUCCESS;
+
+    while (m_streaming && (err_code == NRF_SUCCESS))
+    {
+        m_meas.inst_speed   = (uint16_t)(m_meas.inst_speed + 7);
+        m_meas.inst_cadence = (uint8_t)(m_meas.inst_cadence + 1);
+        m_meas.inst_stride_length++;
+
+        err_code = ble_rscs_measurement_send(&m_rscs, &m_meas);
+        if (err_code == NRF_SUCCESS)
+        {
+            m_meas_queued++;
+        }
+        else if (   (err_code != BLE_ERROR_NO_TX_PACKETS)
+                 && (err_code != NRF_ERROR_INVALID_STATE)
+                 && (err_code != BLE_ERROR_GATTS_SYS_ATTR_MISSING))
+        {
+            m_errors++;
+        }
+    }
+}
+
+
+/**@brief Function for handling the BLE events of the application. */
+static void on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GATTS_EVT_SYS_ATTR_MISSING:
+            if (sd_ble_gatts_sys_attr_set(p_ble_evt->evt.gatts_evt.conn_handle, NULL, 0, 0) != NRF_SUCCESS)
+            {
+                m_errors++;
+            }
+            break;
+
+        case BLE_GATTS_EVT_WRITE:
+            if (p_ble_evt->evt.gatts_evt.params.write.handle == m_rscs.meas_handles.cccd_handle)
+            {
+                measurements_send();
+            }
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            measurements_send();
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+static void evt_pump(void)
+{
+    evt_buf_t evt;
+    uint16_t  len = sizeof(evt);
+    uint32_t  evt_id;
+
+    while (sd_ble_evt_get(evt.buf, &len) == NRF_SUCCESS)
+    {
+        ble_evt_router_on_ble_evt(&evt.evt);
+        on_ble_evt(&evt.evt);
+        len = sizeof(evt);
+    }
+
+    while (sd_evt_get(&evt_id) == NRF_SUCCESS)
+    {
+        // No SoC event is used.
+    }
+}
+
+
+/**@brief Function for writing a request to the Control Point, as the central. */
+static void ctrl_pt_write(void * p_context)
+{
+    static uint8_t const request[] = {CTRL_PT_REQUEST};
+
+    if (m_streaming)
+    {
+        if (sd_sim_central_write(m_data_sync.data_sync_ctrl_pt_handles.value_handle,
+                                 request,
+                                 sizeof(request),
+                                 true) == NRF_SUCCESS)
+        {
+            m_ctrl_pt_writes++;
+        }
+        else
+        {
+            m_errors++;
+        }
+    }
+}
+
+
+/**@brief Function for building the attribute table of the services.
+ *
+ * @details The table is rebuilt the same way for each run, the routes registered on the first
+ *          run stay valid.
+ */
+static uint32_t services_init(void)
+{
+    ble_rscs_init_t      rscs_init;
+    ble_data_sync_init_t data_sync_init;
+    uint32_t             err_code;
+
+    memset(&rscs_init, 0, sizeof(rscs_init));
+    rscs_init.feature = BLE_RSCS_FEATURE_INSTANT_STRIDE_LEN_BIT
+                        | BLE_RSCS_FEATURE_WALKING_OR_RUNNING_STATUS_BIT;
+    rscs_init.initial_rcm.is_inst_stride_len_present = true;
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&rscs_init.rsc_meas_attr_md.cccd_write_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&rscs_init.rsc_meas_attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&rscs_init.rsc_meas_attr_md.write_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&rscs_init.rsc_feature_attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&rscs_init.rsc_feature_attr_md.write_perm);
+
+    err_code = ble_rscs_init(&m_rscs, &rscs_init);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    memset(&data_sync_init, 0, sizeof(data_sync_init));
+    data_sync_init.revision = 0x02;
+
+    err_code = ble_data_sync_init(&m_data_sync, &data_sync_init);
+    if ((err_code != NRF_SUCCESS) || m_routes_registered)
+    {
+        return err_code;
+    }
+
+    err_code = ble_evt_router_service_register(m_rscs.service_handle, rscs_ble_evt_route, &m_rscs);
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = ble_evt_router_subscribe(rscs_ble_evt_route, &m_rscs);
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = ble_evt_router_service_register(m_data_sync.service_handle,
+                                                   data_sync_ble_evt_route,
+                                                   &m_data_sync);
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = ble_evt_router_subscribe(data_sync_ble_evt_route, &m_data_sync);
+    }
+    m_routes_registered = (err_code == NRF_SUCCESS);
+
+    return err_code;
+}
+
+
+static int run(uint16_t conn_interval, uint8_t tx_buffer_count)
+{
+    sd_sim_link_cfg_t    link_cfg = {conn_interval, tx_buffer_count, PACKETS_PER_EVENT, false};
+    ble_gap_adv_params_t adv_params;
+    sd_sim_stats_t       start;
+    sd_sim_stats_t       end;
+    sd_sim_stats_t       drained;
+    char                 script[64];
+    uint32_t             notifications;
+    uint32_t             responses;
+    uint32_t             err_code;
+
+    sd_sim_init(&link_cfg, evt_pump);
+    memset(&m_meas, 0, sizeof(m_meas));
+    m_meas.is_inst_stride_len_present = true;
+    m_meas_queued    = 0;
+    m_ctrl_pt_writes = 0;
+    m_errors         = 0;
+    m_streaming      = true;
+
+    err_code = services_init();
+    if (err_code == NRF_SUCCESS)
+    {
+        memset(&adv_params, 0, sizeof(adv_params));
+        adv_params.type     = BLE_GAP_ADV_TYPE_ADV_IND;
+        adv_params.interval = 64;
+        err_code = sd_ble_gap_adv_start(&adv_params);
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        (void)snprintf(script, sizeof(script), "connect; subscribe %X; subscribe %X; wait %u",
+                       BLE_UUID_RSC_MEASUREMENT_CHAR, BLE_DATA_SYNC_CTRL_PT_UUID, SETTLE_MS);
+        err_code = sd_sim_script_run(script);
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        // The requests start once both subscriptions are in place.
+        err_code = sd_sim_timer_add(CTRL_PT_PERIOD_MS, ctrl_pt_write, NULL);
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        printf("bench_sd_sim: setup failed, error 0x%08X\n", err_code);
+        return 1;
+    }
+
+    sd_sim_stats_get(&start);
+    sd_sim_run(RUN_MS);
+    sd_sim_stats_get(&end);
+
+    m_streaming = false;
+    sd_sim_run(DRAIN_MS);
+    sd_sim_stats_get(&drained);
+
+    // Every notification that is not a measurement is a Control Point response. The two other
+    // writes are the subscriptions.
+    responses = drained.notifications - m_meas_queued;
+    if ((m_errors != 0) || (drained.evt_queue_overflows != 0) || (m_meas_queued == 0)
+        || (drained.writes != m_ctrl_pt_writes + 2) || (responses != m_ctrl_pt_writes))
+    {
+        printf("bench_sd_sim: %4.1f ms, %u TX buffers: %u errors, %u events lost, "
+               "%u measurements, %u of %u requests answered\n",
+               conn_interval * 1.25, tx_buffer_count, m_errors, drained.evt_queue_overflows,
+               m_meas_queued, responses, m_ctrl_pt_writes);
+        return 1;
+    }
+
+    notifications = end.notifications - start.notifications;
+    printf("rscs %5.1f ms interval, %u TX buffers: %7.1f notifications/s, %6.2f ms TX latency, "
+           "handler %5.0f ns mean, %6.0f ns max\n",
+           conn_interval * 1.25,
+           tx_buffer_count,
+           notifications * 1000.0 / RUN_MS,
+           (double)(end.tx_latency_us - start.tx_latency_us) / notifications / 1000,
+           (double)(end.pump_time_ns - start.pump_time_ns) / (end.pump_calls - start.pump_calls),
+           (double)end.pump_time_max_ns);
+
+    return 0;
+}
+
+
+int main(void)
+{
+    static uint16_t const conn_intervals[]   = {6, 24, 80};    // 7.5, 30 and 100 ms.
+    static uint8_t const  tx_buffer_counts[] = {1, 3, 7};
+
+    int err = 0;
+
+    for (uint32_t i = 0; i < sizeof(conn_intervals) / sizeof(conn_intervals[0]); i++)
+    {
+        for (uint32_t j = 0; j < sizeof(tx_buffer_counts) / sizeof(tx_buffer_counts[0]); j++)
+        {
+            err |= run(conn_intervals[i], tx_buffer_counts[j]);
+        }
+    }
+    return err;
+}
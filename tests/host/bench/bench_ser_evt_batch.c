@@ -0,0 +1,292 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief BLE events per second through the serialization event encoder and decoder, in loopback.
+ *
+ * @details The connectivity side encodes the events with ser_conn_ble_event_encoder, single or
+ *          batched. The HAL transport is replaced by a copy of every packet into the receive
+ *          buffer of the application side, where ser_sd_transport splits the batches and the
+ *          events are decoded with ble_event_dec. The PHY is not part of the figures: packets and
+ *          bytes per event are printed next to them, as those set the cost of a real link.
+ *
+ *          The events are a mix of 20-byte GATTS writes and GATTC notifications, TX complete
+ *          and RSSI changes, as seen during a transfer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_util.h"
+#include "nrf_error.h"
+#include "ble.h"
+#include "app_timer.h"
+#include "app_scheduler.h"
+#include "ble_serialization.h"
+#include "ser_config.h"
+#include "ser_hal_transport.h"
+#include "ser_sd_transport.h"
+#include "ser_conn_event_encoder.h"
+#include "ble_app.h"
+
+#define EVENTS          2000000
+#define DATA_LEN        20
+#define EVT_TYPES       4
+#define EVT_BUF_SIZE    (sizeof(ble_evt_t) + DATA_LEN)
+
+/**@brief Event buffer with room for the data of writes and notifications. */
+typedef union
+{
+    ble_evt_t evt;
+    uint8_t   raw[EVT_BUF_SIZE];
+} evt_buf_t;
+
+static ser_hal_transport_events_handler_t m_hal_handler;
+static uint8_t                            m_tx_buf[SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE];
+static uint8_t                            m_rx_buf[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+static evt_buf_t                          m_events[EVT_TYPES];
+static evt_buf_t                          m_decoded;
+static uint32_t                           m_decoded_count;
+static uint32_t                           m_errors;
+static uint64_t                           m_packets;
+static uint64_t                           m_bytes;
+
+
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t * p_file_name)
+{
+    printf("bench_ser_evt_batch: error 0x%08X at %s:%u\n",
+           error_code, (char const *)p_file_name, line_num);
+    exit(1);
+}
+
+
+void app_error_handler_bare(uint32_t error_code)
+{
+    printf("bench_ser_evt_batch: error 0x%08X\n", error_code);
+    exit(1);
+}
+
+
+uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                          app_timer_mode_t            mode,
+                          app_timer_timeout_handler_t timeout_handler)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_stop(app_timer_id_t timer_id)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_put(void * p_event_data, uint16_t event_size,
+                             app_sched_event_handler_t handler)
+{
+    return NRF_SUCCESS;
+}
+
+
+void app_sched_pause(void)
+{
+}
+
+
+bool ser_app_power_system_off_get(void)
+{
+    return false;
+}
+
+
+void ser_app_power_system_off_enter(void)
+{
+}
+
+
+uint32_t ser_hal_transport_open(ser_hal_transport_events_handler_t events_handler)
+{
+    m_hal_handler = events_handler;
+    return NRF_SUCCESS;
+}
+
+
+void ser_hal_transport_close(void)
+{
+    m_hal_handler = NULL;
+}
+
+
+uint32_t ser_hal_transport_tx_pkt_alloc(uint8_t ** pp_memory, uint16_t * p_num_of_bytes)
+{
+    *pp_memory      = m_tx_buf;
+    *p_num_of_bytes = sizeof(m_tx_buf);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ser_hal_transport_tx_pkt_free(uint8_t * p_buffer)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ser_hal_transport_rx_pkt_free(uint8_t * p_buffer)
+{
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Loopback: the packet is copied to the application side, as the PHY would. */
+uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
+{
+    ser_hal_transport_evt_t event;
+
+    m_packets++;
+    m_bytes += num_of_bytes;
+    memcpy(m_rx_buf, p_buffer, num_of_bytes);
+
+    event.evt_type                               = SER_HAL_TRANSP_EVT_RX_PKT_RECEIVED;
+    event.evt_params.rx_pkt_received.p_buffer     = m_rx_buf;
+    event.evt_params.rx_pkt_received.num_of_bytes = num_of_bytes;
+    m_hal_handler(event);
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Application side event handler: decodes the event and checks it against the one sent. */
+static void app_evt_handler(uint8_t * p_data, uint16_t length)
+{
+    ble_evt_t const * p_sent = &m_events[m_decoded_count % EVT_TYPES].evt;
+    uint32_t          evt_len = sizeof(m_decoded);
+
+    if (   (ble_event_dec(p_data, length, &m_decoded.evt, &evt_len) != NRF_SUCCESS)
+        || (m_decoded.evt.header.evt_id != p_sent->header.evt_id))
+    {
+        m_errors++;
+    }
+    else if (   (p_sent->header.evt_id == BLE_GATTS_EVT_WRITE)
+             && (memcmp(m_decoded.evt.evt.gatts_evt.params.write.data,
+                        p_sent->evt.gatts_evt.params.write.data, DATA_LEN) != 0))
+    {
+        m_errors++;
+    }
+    else if (   (p_sent->header.evt_id == BLE_GATTC_EVT_HVX)
+             && (memcmp(m_decoded.evt.evt.gattc_evt.params.hvx.data,
+                        p_sent->evt.gattc_evt.params.hvx.data, DATA_LEN) != 0))
+    {
+        m_errors++;
+    }
+    m_decoded_count++;
+    (void)ser_sd_transport_rx_free(p_data);
+}
+
+
+static void events_init(void)
+{
+    ble_evt_t * p_evt;
+    uint8_t   * p_data;
+
+    memset(m_events, 0, sizeof(m_events));
+
+    p_evt                                  = &m_events[0].evt;
+    p_evt->header.evt_id                   = BLE_GATTS_EVT_WRITE;
+    p_evt->header.evt_len                  = (uint16_t)(offsetof(ble_evt_t, evt.gatts_evt.params.write.data) + DATA_LEN);
+    p_evt->evt.gatts_evt.conn_handle       = 0;
+    p_evt->evt.gatts_evt.params.write.handle = 0x0010;
+    p_evt->evt.gatts_evt.params.write.op   = BLE_GATTS_OP_WRITE_CMD;
+    p_evt->evt.gatts_evt.params.write.len  = DATA_LEN;
+    p_data = p_evt->evt.gatts_evt.params.write.data;
+    for (uint32_t i = 0; i < DATA_LEN; i++)
+    {
+        p_data[i] = (uint8_t)(i * 7 + 1);
+    }
+
+    p_evt                              = &m_events[1].evt;
+    p_evt->header.evt_id               = BLE_EVT_TX_COMPLETE;
+    p_evt->header.evt_len              = sizeof(ble_evt_t);
+    p_evt->evt.common_evt.conn_handle  = 0;
+    p_evt->evt.common_evt.params.tx_complete.count = 2;
+
+    p_evt                                = &m_events[2].evt;
+    p_evt->header.evt_id                 = BLE_GATTC_EVT_HVX;
+    p_evt->header.evt_len                = (uint16_t)(offsetof(ble_evt_t, evt.gattc_evt.params.hvx.data) + DATA_LEN);
+    p_evt->evt.gattc_evt.conn_handle     = 0;
+    p_evt->evt.gattc_evt.params.hvx.handle = 0x0020;
+    p_evt->evt.gattc_evt.params.hvx.type = BLE_GATT_HVX_NOTIFICATION;
+    p_evt->evt.gattc_evt.params.hvx.len  = DATA_LEN;
+    memset(p_evt->evt.gattc_evt.params.hvx.data, 0x5A, DATA_LEN);
+
+    p_evt                                       = &m_events[3].evt;
+    p_evt->header.evt_id                        = BLE_GAP_EVT_RSSI_CHANGED;
+    p_evt->header.evt_len                       = sizeof(ble_evt_t);
+    p_evt->evt.gap_evt.conn_handle              = 0;
+    p_evt->evt.gap_evt.params.rssi_changed.rssi = -60;
+}
+
+
+static int run(char const * p_name, uint8_t max_events)
+{
+    uint64_t start;
+    uint64_t elapsed_ns;
+
+    m_decoded_count = 0;
+    m_errors        = 0;
+    m_packets       = 0;
+    m_bytes         = 0;
+    (void)ser_conn_evt_batch_enable(SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE, max_events);
+
+    // EVENTS is a multiple of every batch size, no event is left waiting for the deadline.
+    start = host_time_ns();
+    for (uint32_t n = 0; n < EVENTS; n++)
+    {
+        ser_conn_ble_event_encoder(&m_events[n % EVT_TYPES], EVT_BUF_SIZE);
+    }
+    elapsed_ns = host_time_ns() - start;
+
+    if ((m_decoded_count != EVENTS) || (m_errors != 0))
+    {
+        printf("bench_ser_evt_batch: %s: %u events decoded, %u errors, %u expected\n",
+               p_name, m_decoded_count, m_errors, EVENTS);
+        return 1;
+    }
+    printf("evt batch %-10s %6.2f Mevents/s, %5.1f ns per event, %4.2f packets and %5.1f bytes per event\n",
+           p_name,
+           (double)EVENTS * 1e3 / (double)elapsed_ns,
+           (double)elapsed_ns / EVENTS,
+           (double)m_packets / EVENTS,
+           (double)m_bytes / EVENTS);
+    return 0;
+}
+
+
+int main(void)
+{
+    int err = 0;
+
+    events_init();
+    (void)ser_sd_transport_open(app_evt_handler, NULL, NULL, NULL);
+
+    err |= run("single",    0);
+    err |= run("2 events",  2);
+    err |= run("4 events",  SER_EVT_BATCH_MAX_EVENTS);
+    err |= run("8 events",  8);
+
+    return err;
+}
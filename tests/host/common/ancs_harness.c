@@ -0,0 +1,203 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ancs_harness.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+ancs_harness_evt_t   g_ancs_evts[ANCS_HARNESS_MAX_EVTS];
+uint32_t             g_ancs_evt_count;
+ancs_harness_write_t g_ancs_writes[ANCS_HARNESS_MAX_WRITES];
+uint32_t             g_ancs_write_count;
+bool                 g_ancs_busy;
+
+
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * p_vs_uuid, uint8_t * p_uuid_type)
+{
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gattc_read(uint16_t conn_handle, uint16_t handle, uint16_t offset)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, ble_gattc_write_params_t const * p_write_params)
+{
+    if (g_ancs_busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    if (g_ancs_write_count < ANCS_HARNESS_MAX_WRITES)
+    {
+        ancs_harness_write_t * p_write = &g_ancs_writes[g_ancs_write_count];
+
+        p_write->write_op = p_write_params->write_op;
+        p_write->handle   = p_write_params->handle;
+        p_write->offset   = p_write_params->offset;
+        p_write->len      = p_write_params->len;
+        if ((p_write_params->p_value != NULL) && (p_write_params->len <= sizeof(p_write->value)))
+        {
+            memcpy(p_write->value, p_write_params->p_value, p_write_params->len);
+        }
+    }
+    g_ancs_write_count++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_db_discovery_evt_register(ble_uuid_t const * const p_uuid)
+{
+    return NRF_SUCCESS;
+}
+
+
+static void evt_handler(ble_ancs_c_evt_t * p_evt)
+{
+    ancs_harness_evt_t * p_rec;
+
+    if (g_ancs_evt_count >= ANCS_HARNESS_MAX_EVTS)
+    {
+        g_ancs_evt_count++;
+        return;
+    }
+
+    p_rec = &g_ancs_evts[g_ancs_evt_count++];
+    memset(p_rec, 0, sizeof(*p_rec));
+    p_rec->type = p_evt->evt_type;
+
+    switch (p_evt->evt_type)
+    {
+        case BLE_ANCS_C_EVT_NOTIF:
+            p_rec->notif = p_evt->notif;
+            break;
+
+        case BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE:
+            p_rec->notif_uid = p_evt->attr.notif_uid;
+            p_rec->attr_id   = p_evt->attr.attr_id;
+            p_rec->attr_len  = p_evt->attr.attr_len;
+            strncpy(p_rec->data, (char const *)p_evt->attr.p_attr_data, BLE_ANCS_ATTR_DATA_MAX);
+            break;
+
+        case BLE_ANCS_C_EVT_APP_ATTRIBUTE:
+            p_rec->attr_id  = p_evt->app_attr.attr_id;
+            p_rec->attr_len = p_evt->app_attr.attr_len;
+            strncpy(p_rec->app_id, (char const *)p_evt->app_attr.p_app_id, BLE_ANCS_ATTR_DATA_MAX);
+            strncpy(p_rec->data, (char const *)p_evt->app_attr.p_attr_data, BLE_ANCS_ATTR_DATA_MAX);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+static void handles_assign(ble_ancs_c_t * p_ancs)
+{
+    ble_ancs_c_service_t service;
+
+    memset(&service, 0, sizeof(service));
+    service.notif_source_char.handle_value  = ANCS_HARNESS_NOTIF_SOURCE;
+    service.data_source_char.handle_value   = ANCS_HARNESS_DATA_SOURCE;
+    service.control_point_char.handle_value = ANCS_HARNESS_CONTROL_POINT;
+    (void)ble_ancs_c_handles_assign(p_ancs, ANCS_HARNESS_CONN_HANDLE, &service);
+}
+
+
+void ancs_harness_init(ble_ancs_c_t * p_ancs, uint16_t const p_attr_lens[BLE_ANCS_NB_OF_ATTRS])
+{
+    ble_ancs_c_init_t init = {.evt_handler = evt_handler};
+
+    memset(p_ancs, 0, sizeof(*p_ancs));
+    (void)ble_ancs_c_init(p_ancs, &init);
+    handles_assign(p_ancs);
+
+    for (uint32_t i = 0; i < BLE_ANCS_NB_OF_ATTRS; i++)
+    {
+        if (p_attr_lens[i] != 0)
+        {
+            // The client terminates the data, so the buffer has one more byte than the length.
+            uint8_t * p_buf = malloc(p_attr_lens[i] + 1);
+            (void)ble_ancs_c_attr_add(p_ancs, (ble_ancs_c_notif_attr_id_values_t)i, p_buf, p_attr_lens[i]);
+        }
+    }
+    ancs_harness_clear();
+    g_ancs_busy = false;
+}
+
+
+void ancs_harness_uninit(ble_ancs_c_t * p_ancs)
+{
+    for (uint32_t i = 0; i < BLE_ANCS_NB_OF_ATTRS; i++)
+    {
+        if (p_ancs->ancs_attr_list[i].get)
+        {
+            free(p_ancs->ancs_attr_list[i].p_attr_data);
+            p_ancs->ancs_attr_list[i].get = false;
+        }
+    }
+}
+
+
+void ancs_harness_hvx(ble_ancs_c_t * p_ancs, uint16_t handle, uint8_t const * p_data, uint16_t len)
+{
+    // The event ends right after the data, like the events taken from the SoftDevice.
+    size_t      size  = offsetof(ble_evt_t, evt.gattc_evt.params.hvx.data) + len;
+    ble_evt_t * p_evt = malloc(size);
+
+    p_evt->header.evt_id                = BLE_GATTC_EVT_HVX;
+    p_evt->header.evt_len               = (uint16_t)(size - sizeof(ble_evt_hdr_t));
+    p_evt->evt.gattc_evt.conn_handle    = ANCS_HARNESS_CONN_HANDLE;
+    p_evt->evt.gattc_evt.gatt_status    = BLE_GATT_STATUS_SUCCESS;
+    p_evt->evt.gattc_evt.params.hvx.handle = handle;
+    p_evt->evt.gattc_evt.params.hvx.type   = BLE_GATT_HVX_NOTIFICATION;
+    p_evt->evt.gattc_evt.params.hvx.len    = len;
+    memcpy(p_evt->evt.gattc_evt.params.hvx.data, p_data, len);
+
+    ble_ancs_c_on_ble_evt(p_ancs, p_evt);
+    free(p_evt);
+}
+
+
+void ancs_harness_write_rsp(ble_ancs_c_t * p_ancs)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id              = BLE_GATTC_EVT_WRITE_RSP;
+    evt.evt.gattc_evt.conn_handle  = ANCS_HARNESS_CONN_HANDLE;
+    ble_ancs_c_on_ble_evt(p_ancs, &evt);
+}
+
+
+void ancs_harness_reconnect(ble_ancs_c_t * p_ancs)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id            = BLE_GAP_EVT_DISCONNECTED;
+    evt.evt.gap_evt.conn_handle  = ANCS_HARNESS_CONN_HANDLE;
+    ble_ancs_c_on_ble_evt(p_ancs, &evt);
+
+    handles_assign(p_ancs);
+}
+
+
+void ancs_harness_clear(void)
+{
+    g_ancs_evt_count   = 0;
+    g_ancs_write_count = 0;
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Host harness for the ANCS client: SoftDevice stubs and event injection.
+ *
+ * @details Buffers given to the client are allocated with their exact size, so AddressSanitizer
+ *          reports any access past them. Events are recorded with a copy of their data.
+ */
+
+#ifndef ANCS_HARNESS_H__
+#define ANCS_HARNESS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_ancs_c.h"
+
+#define ANCS_HARNESS_CONN_HANDLE    1
+#define ANCS_HARNESS_NOTIF_SOURCE   0x0010  /**< Value handle of the Notification Source. */
+#define ANCS_HARNESS_DATA_SOURCE    0x0020  /**< Value handle of the Data Source. */
+#define ANCS_HARNESS_CONTROL_POINT  0x0030  /**< Value handle of the Control Point. */
+
+#define ANCS_HARNESS_MAX_EVTS       64
+#define ANCS_HARNESS_MAX_WRITES     32
+
+/**@brief Recorded ANCS client event. */
+typedef struct
+{
+    ble_ancs_c_evt_type_t type;
+    ble_ancs_c_evt_notif_t notif;
+    uint32_t              notif_uid;
+    uint32_t              attr_id;
+    uint16_t              attr_len;
+    char                  app_id[BLE_ANCS_ATTR_DATA_MAX + 1];
+    char                  data[BLE_ANCS_ATTR_DATA_MAX + 1];
+} ancs_harness_evt_t;
+
+/**@brief Recorded Control Point or CCCD write. */
+typedef struct
+{
+    uint8_t  write_op;
+    uint16_t handle;
+    uint16_t offset;
+    uint16_t len;
+    uint8_t  value[20];
+} ancs_harness_write_t;
+
+extern ancs_harness_evt_t   g_ancs_evts[ANCS_HARNESS_MAX_EVTS];
+extern uint32_t             g_ancs_evt_count;
+extern ancs_harness_write_t g_ancs_writes[ANCS_HARNESS_MAX_WRITES];
+extern uint32_t             g_ancs_write_count;
+extern bool                 g_ancs_busy;            /**< sd_ble_gattc_write returns NRF_ERROR_BUSY. */
+
+/**@brief Function for initializing a connected client.
+ *
+ * @param[out] p_ancs       Client instance.
+ * @param[in]  p_attr_lens  Buffer size of every notification attribute, 0 for attributes that are
+ *                          not requested.
+ */
+void ancs_harness_init(ble_ancs_c_t * p_ancs, uint16_t const p_attr_lens[BLE_ANCS_NB_OF_ATTRS]);
+
+/**@brief Function for releasing the attribute buffers. */
+void ancs_harness_uninit(ble_ancs_c_t * p_ancs);
+
+/**@brief Function for giving the client a notification or indication from the peer. */
+void ancs_harness_hvx(ble_ancs_c_t * p_ancs, uint16_t handle, uint8_t const * p_data, uint16_t len);
+
+/**@brief Function for giving the client a write response, which sends the next queued request. */
+void ancs_harness_write_rsp(ble_ancs_c_t * p_ancs);
+
+/**@brief Function for disconnecting and connecting again. */
+void ancs_harness_reconnect(ble_ancs_c_t * p_ancs);
+
+/**@brief Function for forgetting the recorded events and writes. */
+void ancs_harness_clear(void);
+
+#endif // ANCS_HARNESS_H__
@@ -0,0 +1,103 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Stand-alone driver for the fuzz targets.
+ *
+ * @details The targets implement LLVMFuzzerTestOneInput, so they can also be linked with
+ *          libFuzzer (clang -fsanitize=fuzzer) instead of this file. Without libFuzzer, this
+ *          driver replays the files given on the command line, or feeds random inputs:
+ *
+ *          fuzz_<name> [-n iterations] [-s seed] [file ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "host_util.h"
+
+#define FUZZ_MAX_INPUT      1024
+#define FUZZ_ITERATIONS     200000
+
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size);
+
+
+static int file_run(char const * p_path)
+{
+    static uint8_t buf[1 << 16];
+
+    FILE * p_file = fopen(p_path, "rb");
+    size_t size;
+
+    if (p_file == NULL)
+    {
+        perror(p_path);
+        return 1;
+    }
+    size = fread(buf, 1, sizeof(buf), p_file);
+    fclose(p_file);
+
+    (void)LLVMFuzzerTestOneInput(buf, size);
+    return 0;
+}
+
+
+int main(int argc, char ** argv)
+{
+    static uint8_t buf[FUZZ_MAX_INPUT];
+
+    unsigned long iterations = FUZZ_ITERATIONS;
+    uint32_t      seed       = 1;
+    int           files      = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+        {
+            iterations = strtoul(argv[++i], NULL, 0);
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+            seed = (seed == 0) ? 1 : seed;
+        }
+        else
+        {
+            if (file_run(argv[i]) != 0)
+            {
+                return 1;
+            }
+            files++;
+        }
+    }
+    if (files != 0)
+    {
+        return 0;
+    }
+
+    for (unsigned long n = 0; n < iterations; n++)
+    {
+        // Short inputs are more likely to reach the corner cases of the parsers.
+        size_t size = host_rand(&seed) % ((host_rand(&seed) & 1) ? 64 : FUZZ_MAX_INPUT);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            buf[i] = (uint8_t)host_rand(&seed);
+        }
+        (void)LLVMFuzzerTestOneInput(buf, size);
+    }
+
+    printf("%s: %lu inputs\n", argv[0], iterations);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Minimal check macros for the host tests.
+ *
+ * @details Every test program includes this header once. A failed check prints its location and
+ *          the test continues, UNIT_TEST_RESULT() is the exit code of the program.
+ */
+
+#ifndef UNIT_TEST_H__
+#define UNIT_TEST_H__
+
+#include <stdio.h>
+#include <string.h>
+
+static unsigned m_unit_checks;
+static unsigned m_unit_failures;
+
+#define CHECK(cond)                                                                     \
+    do                                                                                  \
+    {                                                                                   \
+        m_unit_checks++;                                                                \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            m_unit_failures++;                                                          \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);             \
+        }                                                                               \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                      \
+    do                                                                                  \
+    {                                                                                   \
+        long long a__ = (long long)(actual);                                            \
+        long long e__ = (long long)(expected);                                          \
+        m_unit_checks++;                                                                \
+        if (a__ != e__)                                                                 \
+        {                                                                               \
+            m_unit_failures++;                                                          \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual,   \
+                   a__, e__);                                                           \
+        }                                                                               \
+    } while (0)
+
+#define CHECK_STR(actual, expected)                                                     \
+    do                                                                                  \
+    {                                                                                   \
+        char const * a__ = (actual);                                                    \
+        char const * e__ = (expected);                                                  \
+        m_unit_checks++;                                                                \
+        if (strcmp(a__, e__) != 0)                                                      \
+        {                                                                               \
+            m_unit_failures++;                                                          \
+            printf("%s:%d: %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__,        \
+                   #actual, a__, e__);                                                  \
+        }                                                                               \
+    } while (0)
+
+/**@brief Prints the summary line and evaluates to the exit code of the test program. */
+#define UNIT_TEST_RESULT()                                                              \
+    (printf("%s: %u checks, %u failed\n", __FILE__, m_unit_checks, m_unit_failures),    \
+     (m_unit_failures == 0) ? 0 : 1)
+
+#endif // UNIT_TEST_H__
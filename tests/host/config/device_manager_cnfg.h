@@ -0,0 +1,27 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Device Manager configuration of the host tests: the SDK defaults, with a bond table
+ *        that spans several words of the device bitmaps.
+ */
+
+#ifndef DEVICE_MANAGER_CNFG_H_HOST__
+#define DEVICE_MANAGER_CNFG_H_HOST__
+
+#include "../../../components/ble/device_manager/config/device_manager_cnfg.h"
+
+#undef  DEVICE_MANAGER_MAX_BONDS
+#define DEVICE_MANAGER_MAX_BONDS 70
+
+#endif // DEVICE_MANAGER_CNFG_H_HOST__
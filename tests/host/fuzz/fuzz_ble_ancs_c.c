@@ -0,0 +1,131 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Fuzz target for the ANCS client.
+ *
+ * @details The input is a script. Each step starts with a control byte: the upper three bits
+ *          select the action, the lower five bits the number of payload bytes that follow.
+ *
+ *          0-3  Data Source notification with the payload.
+ *          4    Notification Source notification with the payload.
+ *          5    App attribute request with the payload as app identifier.
+ *          6    Notification attribute request, UID from the payload.
+ *          7    Write response if the payload is empty, otherwise disconnect and reconnect.
+ *
+ *          Attribute buffers are allocated with their exact size, so a write past one of them is
+ *          caught by AddressSanitizer. Reported attributes must also fit their buffers.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ancs_harness.h"
+
+/**@brief Small buffers, so that truncation is exercised. */
+static uint16_t const m_attr_lens[BLE_ANCS_NB_OF_ATTRS] =
+{
+    [BLE_ANCS_NOTIF_ATTR_ID_APP_IDENTIFIER] = BLE_ANCS_ATTR_DATA_MAX,
+    [BLE_ANCS_NOTIF_ATTR_ID_TITLE]          = 1,
+    [BLE_ANCS_NOTIF_ATTR_ID_MESSAGE]        = 7,
+    [BLE_ANCS_NOTIF_ATTR_ID_DATE]           = 15,
+};
+
+
+static void evts_check(void)
+{
+    uint32_t count = (g_ancs_evt_count < ANCS_HARNESS_MAX_EVTS) ? g_ancs_evt_count : ANCS_HARNESS_MAX_EVTS;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ancs_harness_evt_t const * p_evt = &g_ancs_evts[i];
+
+        if ((p_evt->type == BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE) &&
+            ((p_evt->attr_id >= BLE_ANCS_NB_OF_ATTRS) ||
+             (strlen(p_evt->data) > m_attr_lens[p_evt->attr_id])))
+        {
+            abort();
+        }
+        if ((p_evt->type == BLE_ANCS_C_EVT_APP_ATTRIBUTE) && (strlen(p_evt->app_id) == 0))
+        {
+            abort();
+        }
+    }
+    ancs_harness_clear();
+}
+
+
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size)
+{
+    static ble_ancs_c_t ancs;
+
+    size_t pos = 0;
+
+    ancs_harness_init(&ancs, m_attr_lens);
+
+    // Requests set the number of expected attributes, so start with one.
+    {
+        ble_ancs_c_evt_notif_t notif = {.notif_uid = 1};
+        (void)ble_ancs_c_request_attrs(&ancs, &notif);
+    }
+
+    while (pos < size)
+    {
+        uint8_t         ctrl      = p_data[pos++];
+        uint16_t        len       = (uint16_t)(ctrl & 0x1F);
+        uint8_t const * p_payload = &p_data[pos];
+
+        if (len > size - pos)
+        {
+            len = (uint16_t)(size - pos);
+        }
+
+        switch (ctrl >> 5)
+        {
+            case 4:
+                ancs_harness_hvx(&ancs, ANCS_HARNESS_NOTIF_SOURCE, p_payload, len);
+                break;
+
+            case 5:
+                (void)ble_ancs_c_app_attr_request(&ancs, p_payload, len);
+                break;
+
+            case 6:
+            {
+                ble_ancs_c_evt_notif_t notif = {.notif_uid = 0};
+                memcpy(&notif.notif_uid, p_payload, (len < 4) ? len : 4);
+                (void)ble_ancs_c_request_attrs(&ancs, &notif);
+                break;
+            }
+
+            case 7:
+                if (len == 0)
+                {
+                    ancs_harness_write_rsp(&ancs);
+                }
+                else
+                {
+                    ancs_harness_reconnect(&ancs);
+                }
+                break;
+
+            default:
+                ancs_harness_hvx(&ancs, ANCS_HARNESS_DATA_SOURCE, p_payload, len);
+                break;
+        }
+        pos += len;
+        evts_check();
+    }
+
+    ancs_harness_uninit(&ancs);
+    return 0;
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Fuzz target for the deferred log decoder.
+ *
+ * @details The input is decoded as a capture, the way nrf_log_decode does. It also serves as the
+ *          firmware image: every address is taken modulo the input size, so format strings and
+ *          string arguments are fuzzed too.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "nrf_log_decoder.h"
+
+typedef struct
+{
+    uint8_t const * p_data;
+    size_t          size;
+} image_t;
+
+
+static char const * string_get(uint32_t address, void * p_context)
+{
+    image_t const * p_image = p_context;
+    size_t          offset;
+
+    if (p_image->size == 0)
+    {
+        return NULL;
+    }
+    offset = address % p_image->size;
+    if (memchr(&p_image->p_data[offset], '\0', p_image->size - offset) == NULL)
+    {
+        return NULL;
+    }
+    return (char const *)&p_image->p_data[offset];
+}
+
+
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size)
+{
+    image_t image = {.p_data = p_data, .size = size};
+    size_t  pos   = 0;
+
+    while (pos < size)
+    {
+        nrf_log_decoder_entry_t entry;
+        size_t                  consumed = 0;
+        char                    line[256];
+        char                    small[5];
+        size_t                  len;
+        ret_code_t              err_code;
+
+        err_code = nrf_log_decoder_entry_parse(&p_data[pos], size - pos, &entry, &consumed);
+        if (err_code == NRF_ERROR_DATA_SIZE)
+        {
+            break;
+        }
+        if (err_code != NRF_SUCCESS)
+        {
+            pos += sizeof(uint32_t);
+            continue;
+        }
+        if ((consumed == 0) || (consumed > size - pos) || (entry.num_args > NRF_LOG_DECODER_MAX_ARGS))
+        {
+            abort();
+        }
+
+        // %c with a zero argument puts a NUL in the text, so the length is an upper bound.
+        len = nrf_log_decoder_format(&entry, string_get, &image, line, sizeof(line));
+        if ((strlen(line) > len) || (strlen(line) >= sizeof(line)))
+        {
+            abort();
+        }
+
+        // A truncated result must be a prefix of the full one.
+        (void)nrf_log_decoder_format(&entry, string_get, &image, small, sizeof(small));
+        if (strncmp(small, line, strlen(small)) != 0)
+        {
+            abort();
+        }
+
+        pos += consumed;
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Host replacement of the ANT SoftDevice API.
+ *
+ * @details The ANT SoftDevice headers are not part of this SDK. Only the event pull used by
+ *          softdevice_handler is declared, the test that builds it with ANT support provides it.
+ */
+
+#ifndef ANT_INTERFACE_H__
+#define ANT_INTERFACE_H__
+
+#include <stdint.h>
+
+/**@brief Function for pulling an ANT event. Returns NRF_ERROR_NOT_FOUND when none is pending. */
+uint32_t sd_ant_event_get(uint8_t * pucChannel, uint8_t * pucEvent, uint8_t * aucANTMesg);
+
+#endif // ANT_INTERFACE_H__
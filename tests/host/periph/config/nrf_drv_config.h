@@ -0,0 +1,76 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Driver configuration of the host tests: the SDK defaults, with the instances the tests
+ *        use enabled.
+ */
+
+#ifndef NRF_DRV_CONFIG_H_HOST__
+#define NRF_DRV_CONFIG_H_HOST__
+
+#include "../../../../components/drivers_nrf/config/nrf_drv_config.h"
+
+// UARTE0 with continuous reception, which counts bytes with TIMER1 and detects idle with TIMER2.
+#undef  TIMER1_ENABLED
+#define TIMER1_ENABLED 1
+#define TIMER1_CONFIG_FREQUENCY    NRF_TIMER_FREQ_16MHz
+#define TIMER1_CONFIG_MODE         TIMER_MODE_MODE_Timer
+#define TIMER1_CONFIG_BIT_WIDTH    TIMER_BITMODE_BITMODE_16Bit
+#define TIMER1_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOW
+#define TIMER1_INSTANCE_INDEX      (TIMER0_ENABLED)
+
+#undef  TIMER2_ENABLED
+#define TIMER2_ENABLED 1
+#define TIMER2_CONFIG_FREQUENCY    NRF_TIMER_FREQ_16MHz
+#define TIMER2_CONFIG_MODE         TIMER_MODE_MODE_Timer
+#define TIMER2_CONFIG_BIT_WIDTH    TIMER_BITMODE_BITMODE_16Bit
+#define TIMER2_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOW
+#define TIMER2_INSTANCE_INDEX      (TIMER1_ENABLED+TIMER0_ENABLED)
+
+#undef  UART0_ENABLED
+#define UART0_ENABLED 1
+#define UART0_CONFIG_HWFC         NRF_UART_HWFC_DISABLED
+#define UART0_CONFIG_PARITY       NRF_UART_PARITY_EXCLUDED
+#define UART0_CONFIG_BAUDRATE     NRF_UART_BAUDRATE_1000000
+#define UART0_CONFIG_PSEL_TXD     6
+#define UART0_CONFIG_PSEL_RXD     8
+#define UART0_CONFIG_PSEL_CTS     7
+#define UART0_CONFIG_PSEL_RTS     5
+#define UART0_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOW
+#define UART0_CONFIG_USE_EASY_DMA true
+#define UART_EASY_DMA_SUPPORT     1
+#define UART_LEGACY_SUPPORT       1
+#define UART_RX_STREAM_SUPPORT    1
+#define UART0_CONFIG_RX_STREAM_COUNTER_TIMER 1
+#define UART0_CONFIG_RX_STREAM_IDLE_TIMER    2
+
+// TWIM0 for the app_twi sequences, which count the reads with TIMER3.
+#undef  TIMER3_ENABLED
+#define TIMER3_ENABLED 1
+#define TIMER3_CONFIG_FREQUENCY    NRF_TIMER_FREQ_16MHz
+#define TIMER3_CONFIG_MODE         TIMER_MODE_MODE_Timer
+#define TIMER3_CONFIG_BIT_WIDTH    TIMER_BITMODE_BITMODE_16Bit
+#define TIMER3_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOW
+#define TIMER3_INSTANCE_INDEX      (TIMER2_ENABLED+TIMER1_ENABLED+TIMER0_ENABLED)
+
+#undef  TWI0_ENABLED
+#define TWI0_ENABLED 1
+#define TWI0_USE_EASY_DMA        1
+#define TWI0_CONFIG_FREQUENCY    NRF_TWI_FREQ_400K
+#define TWI0_CONFIG_SCL          27
+#define TWI0_CONFIG_SDA          26
+#define TWI0_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOW
+#define TWI0_INSTANCE_INDEX      0
+
+#endif // NRF_DRV_CONFIG_H_HOST__
@@ -0,0 +1,116 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Host replacement of the Cortex-M4 core header.
+ *
+ * @details The NVIC only records what the module under test asks for: enabled, pending and
+ *          priority per IRQ. Nothing runs by itself, the test calls the IRQ handlers.
+ */
+
+#ifndef CORE_CM4_H_HOST__
+#define CORE_CM4_H_HOST__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Read-only registers are writable, the test sets them where the hardware would.
+#define __I     volatile
+#define __O     volatile
+#define __IO    volatile
+#define __IM    volatile
+#define __OM    volatile
+#define __IOM   volatile
+
+#define __STATIC_INLINE     static inline
+
+#define __CORTEX_M          (0x04U)
+
+#define HOST_NVIC_IRQ_COUNT     64
+
+extern uint64_t host_nvic_enabled;                      /**< Bit n set: IRQ n is enabled. */
+extern uint64_t host_nvic_pending;                      /**< Bit n set: IRQ n is pending. */
+extern uint32_t host_nvic_priority[HOST_NVIC_IRQ_COUNT];
+extern uint32_t host_primask;
+
+/**@brief Enable registers, used only by the SoftDevice critical region of nrf_nvic.h. They are not
+ *        tied to host_nvic_enabled. */
+typedef struct
+{
+    volatile uint32_t ISER[2];
+    volatile uint32_t ICER[2];
+} NVIC_Type;
+
+extern NVIC_Type host_NVIC;
+#define NVIC (&host_NVIC)
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)        { host_nvic_enabled |=  (1ULL << irq); }
+static inline void NVIC_DisableIRQ(IRQn_Type irq)       { host_nvic_enabled &= ~(1ULL << irq); }
+static inline void NVIC_SetPendingIRQ(IRQn_Type irq)    { host_nvic_pending |=  (1ULL << irq); }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq)  { host_nvic_pending &= ~(1ULL << irq); }
+
+static inline uint32_t NVIC_GetPendingIRQ(IRQn_Type irq)
+{
+    return (uint32_t)((host_nvic_pending >> irq) & 1);
+}
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+    if (irq >= 0)
+    {
+        host_nvic_priority[irq] = priority;
+    }
+}
+
+static inline uint32_t NVIC_GetPriority(IRQn_Type irq)
+{
+    return (irq >= 0) ? host_nvic_priority[irq] : 0;
+}
+
+static inline void     __disable_irq(void)             { host_primask = 1; }
+static inline void     __enable_irq(void)              { host_primask = 0; }
+static inline uint32_t __get_PRIMASK(void)             { return host_primask; }
+static inline void     __set_PRIMASK(uint32_t primask) { host_primask = primask; }
+static inline uint32_t __get_IPSR(void)                { return 0; }
+static inline uint32_t __get_CONTROL(void)             { return 0; }
+
+static inline void NVIC_SystemReset(void)              { __builtin_trap(); }
+
+static inline void __NOP(void) {}
+static inline void __WFE(void) {}
+static inline void __WFI(void) {}
+static inline void __SEV(void) {}
+static inline void __DSB(void) { __sync_synchronize(); }
+static inline void __DMB(void) { __sync_synchronize(); }
+static inline void __ISB(void) { __sync_synchronize(); }
+
+// The test runs one context at a time, so an exclusive store always succeeds.
+static inline uint32_t __LDREXW(volatile uint32_t * p_addr)                 { return *p_addr; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t * p_addr) { *p_addr = value; return 0; }
+static inline void     __CLREX(void)                                        {}
+
+static inline uint32_t __REV(uint32_t value)  { return __builtin_bswap32(value); }
+static inline uint8_t  __CLZ(uint32_t value)  { return value ? (uint8_t)__builtin_clz(value) : 32; }
+
+static inline uint32_t __RBIT(uint32_t value)
+{
+    uint32_t result = 0;
+
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        result = (result << 1) | ((value >> i) & 1);
+    }
+    return result;
+}
+
+#endif // CORE_CM4_H_HOST__
@@ -0,0 +1,169 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Register storage of the host peripherals declared in nrf.h.
+ */
+
+#include <string.h>
+#include "nrf.h"
+
+uint64_t host_nvic_enabled;
+uint64_t host_nvic_pending;
+uint32_t host_nvic_priority[HOST_NVIC_IRQ_COUNT];
+uint32_t host_primask;
+NVIC_Type host_NVIC;
+uint32_t SystemCoreClock = 64000000;
+
+NRF_FICR_Type    host_NRF_FICR;
+NRF_UICR_Type    host_NRF_UICR;
+NRF_BPROT_Type   host_NRF_BPROT;
+NRF_POWER_Type   host_NRF_POWER;
+NRF_CLOCK_Type   host_NRF_CLOCK;
+NRF_AMLI_Type    host_NRF_AMLI;
+NRF_RADIO_Type   host_NRF_RADIO;
+NRF_UARTE_Type   host_NRF_UARTE0;
+NRF_UART_Type    host_NRF_UART0;
+NRF_SPIM_Type    host_NRF_SPIM0;
+NRF_SPIS_Type    host_NRF_SPIS0;
+NRF_TWIM_Type    host_NRF_TWIM0;
+NRF_TWIS_Type    host_NRF_TWIS0;
+NRF_SPI_Type     host_NRF_SPI0;
+NRF_TWI_Type     host_NRF_TWI0;
+NRF_SPIM_Type    host_NRF_SPIM1;
+NRF_SPIS_Type    host_NRF_SPIS1;
+NRF_TWIM_Type    host_NRF_TWIM1;
+NRF_TWIS_Type    host_NRF_TWIS1;
+NRF_SPI_Type     host_NRF_SPI1;
+NRF_TWI_Type     host_NRF_TWI1;
+NRF_NFCT_Type    host_NRF_NFCT;
+NRF_GPIOTE_Type  host_NRF_GPIOTE;
+NRF_SAADC_Type   host_NRF_SAADC;
+NRF_TIMER_Type   host_NRF_TIMER0;
+NRF_TIMER_Type   host_NRF_TIMER1;
+NRF_TIMER_Type   host_NRF_TIMER2;
+NRF_RTC_Type     host_NRF_RTC0;
+NRF_TEMP_Type    host_NRF_TEMP;
+NRF_RNG_Type     host_NRF_RNG;
+NRF_ECB_Type     host_NRF_ECB;
+NRF_CCM_Type     host_NRF_CCM;
+NRF_AAR_Type     host_NRF_AAR;
+NRF_WDT_Type     host_NRF_WDT;
+NRF_RTC_Type     host_NRF_RTC1;
+NRF_QDEC_Type    host_NRF_QDEC;
+NRF_COMP_Type    host_NRF_COMP;
+NRF_LPCOMP_Type  host_NRF_LPCOMP;
+NRF_SWI_Type     host_NRF_SWI0;
+NRF_EGU_Type     host_NRF_EGU0;
+NRF_SWI_Type     host_NRF_SWI1;
+NRF_EGU_Type     host_NRF_EGU1;
+NRF_SWI_Type     host_NRF_SWI2;
+NRF_EGU_Type     host_NRF_EGU2;
+NRF_SWI_Type     host_NRF_SWI3;
+NRF_EGU_Type     host_NRF_EGU3;
+NRF_SWI_Type     host_NRF_SWI4;
+NRF_EGU_Type     host_NRF_EGU4;
+NRF_SWI_Type     host_NRF_SWI5;
+NRF_EGU_Type     host_NRF_EGU5;
+NRF_TIMER_Type   host_NRF_TIMER3;
+NRF_TIMER_Type   host_NRF_TIMER4;
+NRF_PWM_Type     host_NRF_PWM0;
+NRF_PDM_Type     host_NRF_PDM;
+NRF_NVMC_Type    host_NRF_NVMC;
+NRF_PPI_Type     host_NRF_PPI;
+NRF_MWU_Type     host_NRF_MWU;
+NRF_PWM_Type     host_NRF_PWM1;
+NRF_PWM_Type     host_NRF_PWM2;
+NRF_SPIM_Type    host_NRF_SPIM2;
+NRF_SPIS_Type    host_NRF_SPIS2;
+NRF_SPI_Type     host_NRF_SPI2;
+NRF_RTC_Type     host_NRF_RTC2;
+NRF_I2S_Type     host_NRF_I2S;
+NRF_FPU_Type     host_NRF_FPU;
+NRF_GPIO_Type    host_NRF_P0;
+
+
+void host_periph_reset(void)
+{
+    memset((void *)&host_NRF_FICR, 0, sizeof(host_NRF_FICR));
+    memset((void *)&host_NRF_UICR, 0, sizeof(host_NRF_UICR));
+    memset((void *)&host_NRF_BPROT, 0, sizeof(host_NRF_BPROT));
+    memset((void *)&host_NRF_POWER, 0, sizeof(host_NRF_POWER));
+    memset((void *)&host_NRF_CLOCK, 0, sizeof(host_NRF_CLOCK));
+    memset((void *)&host_NRF_AMLI, 0, sizeof(host_NRF_AMLI));
+    memset((void *)&host_NRF_RADIO, 0, sizeof(host_NRF_RADIO));
+    memset((void *)&host_NRF_UARTE0, 0, sizeof(host_NRF_UARTE0));
+    memset((void *)&host_NRF_UART0, 0, sizeof(host_NRF_UART0));
+    memset((void *)&host_NRF_SPIM0, 0, sizeof(host_NRF_SPIM0));
+    memset((void *)&host_NRF_SPIS0, 0, sizeof(host_NRF_SPIS0));
+    memset((void *)&host_NRF_TWIM0, 0, sizeof(host_NRF_TWIM0));
+    memset((void *)&host_NRF_TWIS0, 0, sizeof(host_NRF_TWIS0));
+    memset((void *)&host_NRF_SPI0, 0, sizeof(host_NRF_SPI0));
+    memset((void *)&host_NRF_TWI0, 0, sizeof(host_NRF_TWI0));
+    memset((void *)&host_NRF_SPIM1, 0, sizeof(host_NRF_SPIM1));
+    memset((void *)&host_NRF_SPIS1, 0, sizeof(host_NRF_SPIS1));
+    memset((void *)&host_NRF_TWIM1, 0, sizeof(host_NRF_TWIM1));
+    memset((void *)&host_NRF_TWIS1, 0, sizeof(host_NRF_TWIS1));
+    memset((void *)&host_NRF_SPI1, 0, sizeof(host_NRF_SPI1));
+    memset((void *)&host_NRF_TWI1, 0, sizeof(host_NRF_TWI1));
+    memset((void *)&host_NRF_NFCT, 0, sizeof(host_NRF_NFCT));
+    memset((void *)&host_NRF_GPIOTE, 0, sizeof(host_NRF_GPIOTE));
+    memset((void *)&host_NRF_SAADC, 0, sizeof(host_NRF_SAADC));
+    memset((void *)&host_NRF_TIMER0, 0, sizeof(host_NRF_TIMER0));
+    memset((void *)&host_NRF_TIMER1, 0, sizeof(host_NRF_TIMER1));
+    memset((void *)&host_NRF_TIMER2, 0, sizeof(host_NRF_TIMER2));
+    memset((void *)&host_NRF_RTC0, 0, sizeof(host_NRF_RTC0));
+    memset((void *)&host_NRF_TEMP, 0, sizeof(host_NRF_TEMP));
+    memset((void *)&host_NRF_RNG, 0, sizeof(host_NRF_RNG));
+    memset((void *)&host_NRF_ECB, 0, sizeof(host_NRF_ECB));
+    memset((void *)&host_NRF_CCM, 0, sizeof(host_NRF_CCM));
+    memset((void *)&host_NRF_AAR, 0, sizeof(host_NRF_AAR));
+    memset((void *)&host_NRF_WDT, 0, sizeof(host_NRF_WDT));
+    memset((void *)&host_NRF_RTC1, 0, sizeof(host_NRF_RTC1));
+    memset((void *)&host_NRF_QDEC, 0, sizeof(host_NRF_QDEC));
+    memset((void *)&host_NRF_COMP, 0, sizeof(host_NRF_COMP));
+    memset((void *)&host_NRF_LPCOMP, 0, sizeof(host_NRF_LPCOMP));
+    memset((void *)&host_NRF_SWI0, 0, sizeof(host_NRF_SWI0));
+    memset((void *)&host_NRF_EGU0, 0, sizeof(host_NRF_EGU0));
+    memset((void *)&host_NRF_SWI1, 0, sizeof(host_NRF_SWI1));
+    memset((void *)&host_NRF_EGU1, 0, sizeof(host_NRF_EGU1));
+    memset((void *)&host_NRF_SWI2, 0, sizeof(host_NRF_SWI2));
+    memset((void *)&host_NRF_EGU2, 0, sizeof(host_NRF_EGU2));
+    memset((void *)&host_NRF_SWI3, 0, sizeof(host_NRF_SWI3));
+    memset((void *)&host_NRF_EGU3, 0, sizeof(host_NRF_EGU3));
+    memset((void *)&host_NRF_SWI4, 0, sizeof(host_NRF_SWI4));
+    memset((void *)&host_NRF_EGU4, 0, sizeof(host_NRF_EGU4));
+    memset((void *)&host_NRF_SWI5, 0, sizeof(host_NRF_SWI5));
+    memset((void *)&host_NRF_EGU5, 0, sizeof(host_NRF_EGU5));
+    memset((void *)&host_NRF_TIMER3, 0, sizeof(host_NRF_TIMER3));
+    memset((void *)&host_NRF_TIMER4, 0, sizeof(host_NRF_TIMER4));
+    memset((void *)&host_NRF_PWM0, 0, sizeof(host_NRF_PWM0));
+    memset((void *)&host_NRF_PDM, 0, sizeof(host_NRF_PDM));
+    memset((void *)&host_NRF_NVMC, 0, sizeof(host_NRF_NVMC));
+    memset((void *)&host_NRF_PPI, 0, sizeof(host_NRF_PPI));
+    memset((void *)&host_NRF_MWU, 0, sizeof(host_NRF_MWU));
+    memset((void *)&host_NRF_PWM1, 0, sizeof(host_NRF_PWM1));
+    memset((void *)&host_NRF_PWM2, 0, sizeof(host_NRF_PWM2));
+    memset((void *)&host_NRF_SPIM2, 0, sizeof(host_NRF_SPIM2));
+    memset((void *)&host_NRF_SPIS2, 0, sizeof(host_NRF_SPIS2));
+    memset((void *)&host_NRF_SPI2, 0, sizeof(host_NRF_SPI2));
+    memset((void *)&host_NRF_RTC2, 0, sizeof(host_NRF_RTC2));
+    memset((void *)&host_NRF_I2S, 0, sizeof(host_NRF_I2S));
+    memset((void *)&host_NRF_FPU, 0, sizeof(host_NRF_FPU));
+    memset((void *)&host_NRF_P0, 0, sizeof(host_NRF_P0));
+    memset((void *)&host_NVIC, 0, sizeof(host_NVIC));
+    host_nvic_enabled = 0;
+    host_nvic_pending = 0;
+    host_primask      = 0;
+    memset(host_nvic_priority, 0, sizeof(host_nvic_priority));
+}
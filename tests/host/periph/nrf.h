@@ -0,0 +1,314 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Host replacement of nrf.h for the programs that drive peripheral registers.
+ *
+ * @details The register layouts are the ones of nrf52.h. Every peripheral is a zeroed structure
+ *          in RAM (host_periph.c), so a test reads the tasks the module triggered and sets the
+ *          events it wants the module to see.
+ */
+
+#ifndef NRF_H
+#define NRF_H
+
+#ifndef NRF52
+#define NRF52 1
+#endif
+
+#include "nrf52.h"
+#include "nrf52_bitfields.h"
+#include "nrf51_to_nrf52.h"
+#include "nrf52_name_change.h"
+
+#ifndef __INLINE
+#define __INLINE    inline
+#endif
+#ifndef __WEAK
+#define __WEAK      __attribute__((weak))
+#endif
+#ifndef __ALIGN
+#define __ALIGN(n)  __attribute__((aligned(n)))
+#endif
+#ifndef __ASM
+#define __ASM       __asm
+#endif
+
+#undef  NRF_FICR
+extern NRF_FICR_Type host_NRF_FICR;
+#define NRF_FICR (&host_NRF_FICR)
+
+#undef  NRF_UICR
+extern NRF_UICR_Type host_NRF_UICR;
+#define NRF_UICR (&host_NRF_UICR)
+
+#undef  NRF_BPROT
+extern NRF_BPROT_Type host_NRF_BPROT;
+#define NRF_BPROT (&host_NRF_BPROT)
+
+#undef  NRF_POWER
+extern NRF_POWER_Type host_NRF_POWER;
+#define NRF_POWER (&host_NRF_POWER)
+
+#undef  NRF_CLOCK
+extern NRF_CLOCK_Type host_NRF_CLOCK;
+#define NRF_CLOCK (&host_NRF_CLOCK)
+
+#undef  NRF_AMLI
+extern NRF_AMLI_Type host_NRF_AMLI;
+#define NRF_AMLI (&host_NRF_AMLI)
+
+#undef  NRF_RADIO
+extern NRF_RADIO_Type host_NRF_RADIO;
+#define NRF_RADIO (&host_NRF_RADIO)
+
+#undef  NRF_UARTE0
+extern NRF_UARTE_Type host_NRF_UARTE0;
+#define NRF_UARTE0 (&host_NRF_UARTE0)
+
+#undef  NRF_UART0
+extern NRF_UART_Type host_NRF_UART0;
+#define NRF_UART0 (&host_NRF_UART0)
+
+#undef  NRF_SPIM0
+extern NRF_SPIM_Type host_NRF_SPIM0;
+#define NRF_SPIM0 (&host_NRF_SPIM0)
+
+#undef  NRF_SPIS0
+extern NRF_SPIS_Type host_NRF_SPIS0;
+#define NRF_SPIS0 (&host_NRF_SPIS0)
+
+#undef  NRF_TWIM0
+extern NRF_TWIM_Type host_NRF_TWIM0;
+#define NRF_TWIM0 (&host_NRF_TWIM0)
+
+#undef  NRF_TWIS0
+extern NRF_TWIS_Type host_NRF_TWIS0;
+#define NRF_TWIS0 (&host_NRF_TWIS0)
+
+#undef  NRF_SPI0
+extern NRF_SPI_Type host_NRF_SPI0;
+#define NRF_SPI0 (&host_NRF_SPI0)
+
+#undef  NRF_TWI0
+extern NRF_TWI_Type host_NRF_TWI0;
+#define NRF_TWI0 (&host_NRF_TWI0)
+
+#undef  NRF_SPIM1
+extern NRF_SPIM_Type host_NRF_SPIM1;
+#define NRF_SPIM1 (&host_NRF_SPIM1)
+
+#undef  NRF_SPIS1
+extern NRF_SPIS_Type host_NRF_SPIS1;
+#define NRF_SPIS1 (&host_NRF_SPIS1)
+
+#undef  NRF_TWIM1
+extern NRF_TWIM_Type host_NRF_TWIM1;
+#define NRF_TWIM1 (&host_NRF_TWIM1)
+
+#undef  NRF_TWIS1
+extern NRF_TWIS_Type host_NRF_TWIS1;
+#define NRF_TWIS1 (&host_NRF_TWIS1)
+
+#undef  NRF_SPI1
+extern NRF_SPI_Type host_NRF_SPI1;
+#define NRF_SPI1 (&host_NRF_SPI1)
+
+#undef  NRF_TWI1
+extern NRF_TWI_Type host_NRF_TWI1;
+#define NRF_TWI1 (&host_NRF_TWI1)
+
+#undef  NRF_NFCT
+extern NRF_NFCT_Type host_NRF_NFCT;
+#define NRF_NFCT (&host_NRF_NFCT)
+
+#undef  NRF_GPIOTE
+extern NRF_GPIOTE_Type host_NRF_GPIOTE;
+#define NRF_GPIOTE (&host_NRF_GPIOTE)
+
+#undef  NRF_SAADC
+extern NRF_SAADC_Type host_NRF_SAADC;
+#define NRF_SAADC (&host_NRF_SAADC)
+
+#undef  NRF_TIMER0
+extern NRF_TIMER_Type host_NRF_TIMER0;
+#define NRF_TIMER0 (&host_NRF_TIMER0)
+
+#undef  NRF_TIMER1
+extern NRF_TIMER_Type host_NRF_TIMER1;
+#define NRF_TIMER1 (&host_NRF_TIMER1)
+
+#undef  NRF_TIMER2
+extern NRF_TIMER_Type host_NRF_TIMER2;
+#define NRF_TIMER2 (&host_NRF_TIMER2)
+
+#undef  NRF_RTC0
+extern NRF_RTC_Type host_NRF_RTC0;
+#define NRF_RTC0 (&host_NRF_RTC0)
+
+#undef  NRF_TEMP
+extern NRF_TEMP_Type host_NRF_TEMP;
+#define NRF_TEMP (&host_NRF_TEMP)
+
+#undef  NRF_RNG
+extern NRF_RNG_Type host_NRF_RNG;
+#define NRF_RNG (&host_NRF_RNG)
+
+#undef  NRF_ECB
+extern NRF_ECB_Type host_NRF_ECB;
+#define NRF_ECB (&host_NRF_ECB)
+
+#undef  NRF_CCM
+extern NRF_CCM_Type host_NRF_CCM;
+#define NRF_CCM (&host_NRF_CCM)
+
+#undef  NRF_AAR
+extern NRF_AAR_Type host_NRF_AAR;
+#define NRF_AAR (&host_NRF_AAR)
+
+#undef  NRF_WDT
+extern NRF_WDT_Type host_NRF_WDT;
+#define NRF_WDT (&host_NRF_WDT)
+
+#undef  NRF_RTC1
+extern NRF_RTC_Type host_NRF_RTC1;
+#define NRF_RTC1 (&host_NRF_RTC1)
+
+#undef  NRF_QDEC
+extern NRF_QDEC_Type host_NRF_QDEC;
+#define NRF_QDEC (&host_NRF_QDEC)
+
+#undef  NRF_COMP
+extern NRF_COMP_Type host_NRF_COMP;
+#define NRF_COMP (&host_NRF_COMP)
+
+#undef  NRF_LPCOMP
+extern NRF_LPCOMP_Type host_NRF_LPCOMP;
+#define NRF_LPCOMP (&host_NRF_LPCOMP)
+
+#undef  NRF_SWI0
+extern NRF_SWI_Type host_NRF_SWI0;
+#define NRF_SWI0 (&host_NRF_SWI0)
+
+#undef  NRF_EGU0
+extern NRF_EGU_Type host_NRF_EGU0;
+#define NRF_EGU0 (&host_NRF_EGU0)
+
+#undef  NRF_SWI1
+extern NRF_SWI_Type host_NRF_SWI1;
+#define NRF_SWI1 (&host_NRF_SWI1)
+
+#undef  NRF_EGU1
+extern NRF_EGU_Type host_NRF_EGU1;
+#define NRF_EGU1 (&host_NRF_EGU1)
+
+#undef  NRF_SWI2
+extern NRF_SWI_Type host_NRF_SWI2;
+#define NRF_SWI2 (&host_NRF_SWI2)
+
+#undef  NRF_EGU2
+extern NRF_EGU_Type host_NRF_EGU2;
+#define NRF_EGU2 (&host_NRF_EGU2)
+
+#undef  NRF_SWI3
+extern NRF_SWI_Type host_NRF_SWI3;
+#define NRF_SWI3 (&host_NRF_SWI3)
+
+#undef  NRF_EGU3
+extern NRF_EGU_Type host_NRF_EGU3;
+#define NRF_EGU3 (&host_NRF_EGU3)
+
+#undef  NRF_SWI4
+extern NRF_SWI_Type host_NRF_SWI4;
+#define NRF_SWI4 (&host_NRF_SWI4)
+
+#undef  NRF_EGU4
+extern NRF_EGU_Type host_NRF_EGU4;
+#define NRF_EGU4 (&host_NRF_EGU4)
+
+#undef  NRF_SWI5
+extern NRF_SWI_Type host_NRF_SWI5;
+#define NRF_SWI5 (&host_NRF_SWI5)
+
+#undef  NRF_EGU5
+extern NRF_EGU_Type host_NRF_EGU5;
+#define NRF_EGU5 (&host_NRF_EGU5)
+
+#undef  NRF_TIMER3
+extern NRF_TIMER_Type host_NRF_TIMER3;
+#define NRF_TIMER3 (&host_NRF_TIMER3)
+
+#undef  NRF_TIMER4
+extern NRF_TIMER_Type host_NRF_TIMER4;
+#define NRF_TIMER4 (&host_NRF_TIMER4)
+
+#undef  NRF_PWM0
+extern NRF_PWM_Type host_NRF_PWM0;
+#define NRF_PWM0 (&host_NRF_PWM0)
+
+#undef  NRF_PDM
+extern NRF_PDM_Type host_NRF_PDM;
+#define NRF_PDM (&host_NRF_PDM)
+
+#undef  NRF_NVMC
+extern NRF_NVMC_Type host_NRF_NVMC;
+#define NRF_NVMC (&host_NRF_NVMC)
+
+#undef  NRF_PPI
+extern NRF_PPI_Type host_NRF_PPI;
+#define NRF_PPI (&host_NRF_PPI)
+
+#undef  NRF_MWU
+extern NRF_MWU_Type host_NRF_MWU;
+#define NRF_MWU (&host_NRF_MWU)
+
+#undef  NRF_PWM1
+extern NRF_PWM_Type host_NRF_PWM1;
+#define NRF_PWM1 (&host_NRF_PWM1)
+
+#undef  NRF_PWM2
+extern NRF_PWM_Type host_NRF_PWM2;
+#define NRF_PWM2 (&host_NRF_PWM2)
+
+#undef  NRF_SPIM2
+extern NRF_SPIM_Type host_NRF_SPIM2;
+#define NRF_SPIM2 (&host_NRF_SPIM2)
+
+#undef  NRF_SPIS2
+extern NRF_SPIS_Type host_NRF_SPIS2;
+#define NRF_SPIS2 (&host_NRF_SPIS2)
+
+#undef  NRF_SPI2
+extern NRF_SPI_Type host_NRF_SPI2;
+#define NRF_SPI2 (&host_NRF_SPI2)
+
+#undef  NRF_RTC2
+extern NRF_RTC_Type host_NRF_RTC2;
+#define NRF_RTC2 (&host_NRF_RTC2)
+
+#undef  NRF_I2S
+extern NRF_I2S_Type host_NRF_I2S;
+#define NRF_I2S (&host_NRF_I2S)
+
+#undef  NRF_FPU
+extern NRF_FPU_Type host_NRF_FPU;
+#define NRF_FPU (&host_NRF_FPU)
+
+#undef  NRF_P0
+extern NRF_GPIO_Type host_NRF_P0;
+#define NRF_P0 (&host_NRF_P0)
+
+/**@brief Function for clearing all peripheral registers and the NVIC state. */
+void host_periph_reset(void);
+
+#endif // NRF_H
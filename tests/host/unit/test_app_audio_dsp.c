@@ -0,0 +1,339 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Fixed-point audio kernels: known answers for rounding and saturation, sample history
+ *        across calls, and the response of the 16 kHz to 8 kHz resampler.
+ *
+ * @details The kernels round halves towards positive infinity: they add half an LSB before the
+ *          arithmetic shift.
+ */
+
+#include <math.h>
+#include "unit_test.h"
+#include "host_util.h"
+#include "nrf_error.h"
+#include "app_audio_dsp.h"
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+#define PI           3.14159265358979323846
+
+static uint32_t m_rand = 0x6D2B79F5;
+
+
+static void gain_check(int16_t sample, int16_t gain, int16_t expected)
+{
+    app_audio_gain(&sample, 1, gain);
+    CHECK_EQ(sample, expected);
+}
+
+
+static void test_gain(void)
+{
+    int16_t samples[] = {1000, -1000, 3, -3, 32767, -32768, 7};
+
+    // Unity leaves the samples unchanged, the odd count covers the single sample tail.
+    app_audio_gain(samples, ARRAY_LEN(samples), APP_AUDIO_GAIN_UNITY);
+    CHECK_EQ(samples[0], 1000);
+    CHECK_EQ(samples[3], -3);
+    CHECK_EQ(samples[4], 32767);
+    CHECK_EQ(samples[5], -32768);
+    CHECK_EQ(samples[6], 7);
+
+    // Rounding with a gain of 0.5: 0.5 -> 1, -0.5 -> 0, 1.5 -> 2, -1.5 -> -1.
+    gain_check(1,  2048, 1);
+    gain_check(-1, 2048, 0);
+    gain_check(3,  2048, 2);
+    gain_check(-3, 2048, -1);
+    gain_check(5,  1024, 1);                // 1.25
+    gain_check(-5, 1024, -1);               // -1.25
+
+    // Saturation.
+    gain_check(20000,  8192,  32767);
+    gain_check(-20000, 8192,  -32768);
+    gain_check(-32768, -4096, 32767);
+    gain_check(32767,  32767, 32767);
+    gain_check(-32768, 32767, -32768);
+    gain_check(16383,  8192,  32766);       // Just below the limit.
+
+    // Every sample of a block is scaled, in place.
+    int16_t block[9];
+    for (uint32_t i = 0; i < ARRAY_LEN(block); i++)
+    {
+        block[i] = (int16_t)(i * 1000);
+    }
+    app_audio_gain(block, ARRAY_LEN(block), 3 * APP_AUDIO_GAIN_UNITY / 2);
+    for (uint32_t i = 0; i < ARRAY_LEN(block); i++)
+    {
+        CHECK_EQ(block[i], i * 1500);
+    }
+}
+
+
+static void test_dc_filter(void)
+{
+    app_audio_dc_filter_t filter;
+    int16_t               samples[2000];
+
+    // Without the pole the filter is a difference: x[n] - x[n-1].
+    int16_t diff[] = {100, 100, -50, -32768, 32767, 32767};
+    app_audio_dc_filter_init(&filter, 0);
+    app_audio_dc_filter(&filter, diff, ARRAY_LEN(diff));
+    CHECK_EQ(diff[0], 100);
+    CHECK_EQ(diff[1], 0);
+    CHECK_EQ(diff[2], -150);
+    CHECK_EQ(diff[3], -32718);
+    CHECK_EQ(diff[4], 32767);               // 65535 saturated.
+    CHECK_EQ(diff[5], 0);
+
+    // A step decays with the pole: 10000, then 10000 * 32604 / 32768 = 9949.95.
+    app_audio_dc_filter_init(&filter, 32604);
+    for (uint32_t i = 0; i < ARRAY_LEN(samples); i++)
+    {
+        samples[i] = 10000;
+    }
+    app_audio_dc_filter(&filter, samples, ARRAY_LEN(samples));
+    CHECK_EQ(samples[0], 10000);
+    CHECK_EQ(samples[1], 9950);
+    CHECK(samples[100] < samples[99]);
+    CHECK_EQ(samples[ARRAY_LEN(samples) - 1], 0);
+
+    // The state carries over between calls.
+    int16_t whole[64];
+    int16_t split[64];
+    for (uint32_t i = 0; i < ARRAY_LEN(whole); i++)
+    {
+        whole[i] = (int16_t)host_rand(&m_rand);
+        split[i] = whole[i];
+    }
+    app_audio_dc_filter_init(&filter, 32604);
+    app_audio_dc_filter(&filter, whole, ARRAY_LEN(whole));
+    app_audio_dc_filter_init(&filter, 32604);
+    for (uint32_t i = 0; i < ARRAY_LEN(split); i += 16)
+    {
+        app_audio_dc_filter(&filter, &split[i], 16);
+    }
+    CHECK(memcmp(whole, split, sizeof(whole)) == 0);
+}
+
+
+static void test_fir_init(void)
+{
+    static int16_t const coeffs[4] = {0};
+
+    app_audio_fir_decim_t fir;
+    int16_t               state[APP_AUDIO_FIR_STATE_SIZE(4, 8)];
+
+    CHECK_EQ(app_audio_fir_decim_init(&fir, coeffs, 4, 2, state, 8), NRF_SUCCESS);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, coeffs, 3, 2, state, 8), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, coeffs, 0, 2, state, 8), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, coeffs, 4, 0, state, 8), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, coeffs, 4, 3, state, 8), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, coeffs, 4, 2, state, 1), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, NULL, 4, 2, state, 8), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, coeffs, 4, 2, NULL, 8), NRF_ERROR_INVALID_PARAM);
+}
+
+
+static void test_fir_rounding(void)
+{
+    static int16_t const half[2] = {16384, 16384};
+    static int16_t const full[2] = {32767, 32767};
+
+    app_audio_fir_decim_t fir;
+    int16_t               state[APP_AUDIO_FIR_STATE_SIZE(2, 8)];
+    int16_t               out[4];
+
+    // The mean of two samples: 1.5 -> 2, -1.5 -> -1, 0.5 -> 1, -0.5 -> 0.
+    int16_t in[8] = {1, 2, -1, -2, 0, 1, 0, -1};
+    CHECK_EQ(app_audio_fir_decim_init(&fir, half, 2, 2, state, 8), NRF_SUCCESS);
+    CHECK_EQ(app_audio_fir_decim(&fir, in, out, 8), 4);
+    CHECK_EQ(out[0], 2);
+    CHECK_EQ(out[1], -1);
+    CHECK_EQ(out[2], 1);
+    CHECK_EQ(out[3], 0);
+
+    // Two full scale samples at a gain of almost 2 saturate.
+    int16_t loud[4] = {32767, 32767, -32768, -32768};
+    CHECK_EQ(app_audio_fir_decim_init(&fir, full, 2, 2, state, 8), NRF_SUCCESS);
+    CHECK_EQ(app_audio_fir_decim(&fir, loud, out, 4), 2);
+    CHECK_EQ(out[0], 32767);
+    CHECK_EQ(out[1], -32768);
+
+    // A single sample at Q15 32767 loses one LSB at full scale: 32767 * 32767 / 32768.
+    int16_t single[2] = {32767, 0};
+    CHECK_EQ(app_audio_fir_decim_init(&fir, full, 2, 1, state, 8), NRF_SUCCESS);
+    CHECK_EQ(app_audio_fir_decim(&fir, single, out, 2), 2);
+    CHECK_EQ(out[0], 32766);
+    CHECK_EQ(out[1], 32766);
+}
+
+
+static void test_fir_history(void)
+{
+    // The first coefficient is applied to the oldest sample: a delay of 3 samples, scaled by 1/4.
+    static int16_t const delay[4] = {8192, 0, 0, 0};
+
+    app_audio_fir_decim_t fir;
+    int16_t               state[APP_AUDIO_FIR_STATE_SIZE(4, 4)];
+    int16_t               in[4];
+    int16_t               out[4];
+
+    CHECK_EQ(app_audio_fir_decim_init(&fir, delay, 4, 1, state, 4), NRF_SUCCESS);
+    for (int16_t call = 0; call < 3; call++)
+    {
+        for (int16_t i = 0; i < 4; i++)
+        {
+            in[i] = (int16_t)(4 * (call * 4 + i + 1));
+        }
+        CHECK_EQ(app_audio_fir_decim(&fir, in, out, 4), 4);
+        for (int16_t i = 0; i < 4; i++)
+        {
+            int16_t n = call * 4 + i;
+            CHECK_EQ(out[i], (n < 3) ? 0 : n - 2);
+        }
+    }
+
+    // Blocks larger than block_size, or not a multiple of the factor, are not processed.
+    CHECK_EQ(app_audio_fir_decim(&fir, in, out, 5), 0);
+    CHECK_EQ(app_audio_fir_decim_init(&fir, delay, 4, 2, state, 4), NRF_SUCCESS);
+    CHECK_EQ(app_audio_fir_decim(&fir, in, out, 3), 0);
+}
+
+
+/**@brief Function for checking the resampler against its exact rational output.
+ *
+ * @details The output is sum(c[k] * x[k]) / 32768 rounded half up and saturated, and the input is
+ *          resampled in place, in blocks.
+ */
+static void test_resample_reference(void)
+{
+    enum { BLOCK = 32, BLOCKS = 20, LENGTH = BLOCK * BLOCKS };
+
+    app_audio_fir_decim_t fir;
+    int16_t               state[APP_AUDIO_FIR_STATE_SIZE(APP_AUDIO_RESAMPLE_16K_8K_TAPS, BLOCK)];
+    int16_t               input[LENGTH];
+    int16_t               block[BLOCK];
+
+    for (uint32_t i = 0; i < LENGTH; i++)
+    {
+        // Full scale noise, with a run of extremes to reach the saturation.
+        input[i] = (i >= 100 && i < 140) ? (int16_t)((i & 1) ? -32768 : 32767)
+                                         : (int16_t)host_rand(&m_rand);
+    }
+
+    CHECK_EQ(app_audio_resample_16k_8k_init(&fir, state, BLOCK), NRF_SUCCESS);
+    for (uint32_t b = 0; b < BLOCKS; b++)
+    {
+        memcpy(block, &input[b * BLOCK], sizeof(block));
+        CHECK_EQ(app_audio_fir_decim(&fir, block, block, BLOCK), BLOCK / 2);
+
+        for (uint32_t j = 0; j < BLOCK / 2; j++)
+        {
+            int32_t newest = (int32_t)(b * BLOCK + 2 * j + 1);
+            int64_t acc    = 0;
+
+            for (int32_t k = 0; k < APP_AUDIO_RESAMPLE_16K_8K_TAPS; k++)
+            {
+                int32_t n = newest - (APP_AUDIO_RESAMPLE_16K_8K_TAPS - 1) + k;
+                acc += (n < 0) ? 0 : (int64_t)app_audio_resample_16k_8k_coeffs[k] * input[n];
+            }
+            acc = (int64_t)floor((double)acc / 32768.0 + 0.5);
+            acc = (acc > INT16_MAX) ? INT16_MAX : (acc < INT16_MIN) ? INT16_MIN : acc;
+            CHECK_EQ(block[j], acc);
+        }
+    }
+}
+
+
+/**@brief Function for getting the output amplitude of the resampler for a 16 kHz tone.
+ *
+ * @details The amplitude is measured from the RMS value, over whole periods of the tones used.
+ */
+static int32_t resample_tone_amplitude(double frequency, int16_t amplitude)
+{
+    enum { BLOCK = 64, BLOCKS = 16 };
+
+    app_audio_fir_decim_t fir;
+    int16_t               state[APP_AUDIO_FIR_STATE_SIZE(APP_AUDIO_RESAMPLE_16K_8K_TAPS, BLOCK)];
+    int16_t               block[BLOCK];
+    double                energy = 0.0;
+
+    (void)app_audio_resample_16k_8k_init(&fir, state, BLOCK);
+    for (uint32_t b = 0; b < BLOCKS; b++)
+    {
+        for (uint32_t i = 0; i < BLOCK; i++)
+        {
+            double t = (double)(b * BLOCK + i) / 16000.0;
+            block[i] = (int16_t)lround(amplitude * sin(2.0 * PI * frequency * t));
+        }
+        (void)app_audio_fir_decim(&fir, block, block, BLOCK);
+
+        // The first block holds the start of the filter response.
+        for (uint32_t i = 0; (b > 0) && (i < BLOCK / 2); i++)
+        {
+            energy += (double)block[i] * block[i];
+        }
+    }
+    return (int32_t)lround(sqrt(2.0 * energy / ((BLOCKS - 1) * BLOCK / 2)));
+}
+
+
+static void test_resample_response(void)
+{
+    app_audio_fir_decim_t fir;
+    int16_t               state[APP_AUDIO_FIR_STATE_SIZE(APP_AUDIO_RESAMPLE_16K_8K_TAPS, 64)];
+    int16_t               block[64];
+    int32_t               sum = 0;
+
+    // The coefficients sum to exactly 1.0, so constant input comes out unchanged.
+    for (uint32_t k = 0; k < APP_AUDIO_RESAMPLE_16K_8K_TAPS; k++)
+    {
+        sum += app_audio_resample_16k_8k_coeffs[k];
+    }
+    CHECK_EQ(sum, 32768);
+
+    static int16_t const levels[] = {10000, -1, 32767, -32768};
+    for (uint32_t l = 0; l < ARRAY_LEN(levels); l++)
+    {
+        CHECK_EQ(app_audio_resample_16k_8k_init(&fir, state, 64), NRF_SUCCESS);
+        for (uint32_t i = 0; i < ARRAY_LEN(block); i++)
+        {
+            block[i] = levels[l];
+        }
+        CHECK_EQ(app_audio_fir_decim(&fir, block, block, 64), 32);
+        CHECK_EQ(block[31], levels[l]);
+    }
+
+    // Pass band, -6 dB at 3.6 kHz, and more than 60 dB of attenuation above 5 kHz.
+    int32_t level = resample_tone_amplitude(1000.0, 16000);
+    CHECK(level >= 15900 && level <= 16100);
+    level = resample_tone_amplitude(3600.0, 16000);
+    CHECK(level >= 7600 && level <= 8400);
+    CHECK(resample_tone_amplitude(5000.0, 16000) <= 16);
+    CHECK(resample_tone_amplitude(6000.0, 16000) <= 16);
+}
+
+
+int main(void)
+{
+    test_gain();
+    test_dc_filter();
+    test_fir_init();
+    test_fir_rounding();
+    test_fir_history();
+    test_resample_reference();
+    test_resample_response();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,458 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief app_button debouncing against simulated contact bounce.
+ *
+ * @details The test plays the GPIOTE driver and app_timer on a timeline in RTC ticks. A script of
+ *          pin edges is applied in time order; every edge calls the GPIOTE handler of the pin,
+ *          and the single-shot detection timer calls its handler when it expires. The RTC counter
+ *          is 24 bits wide and wraps, as on target.
+ *
+ *          app_button is built without APP_BUTTON_HW_DEBOUNCE_TIMER, so all buttons use the PORT
+ *          event path: edges are only stamped, and the timeout handler re-arms the timer until
+ *          the pins have been quiet for the detection delay.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "nrf_error.h"
+#include "app_timer.h"
+#include "app_button.h"
+#include "nrf_drv_gpiote.h"
+
+#define RTC_COUNTER_MASK    0x00FFFFFF
+#define DETECTION_DELAY     160                 /**< About 5 ms, in ticks of a prescaler 0 app_timer. */
+#define PIN_LOW_ACTIVE      3                   /**< Active low button with pull-up. */
+#define PIN_HIGH_ACTIVE     17                  /**< Active high button with pull-down. */
+#define MAX_EDGES           256
+#define MAX_REPORTS         16
+
+/**@brief One pin edge of the script. */
+typedef struct
+{
+    uint64_t time;
+    uint8_t  pin;
+    bool     level;
+} edge_t;
+
+/**@brief One call of a button handler. */
+typedef struct
+{
+    uint64_t time;
+    uint8_t  pin;
+    uint8_t  action;
+} report_t;
+
+/**@brief State of the simulated GPIOTE driver and app_timer. */
+static struct
+{
+    uint64_t                     now;
+    uint32_t                     counter_base;      /**< RTC counter at time 0. */
+    uint32_t                     levels;
+    uint32_t                     enabled;           /**< Pins with the GPIOTE event enabled. */
+    nrf_drv_gpiote_evt_handler_t gpiote_handler;
+    app_timer_timeout_handler_t  timer_handler;
+    bool                         timer_running;
+    uint64_t                     timer_expiry;
+    uint32_t                     timer_starts;
+    uint32_t                     timer_restarts;    /**< Starts of a running timer. */
+    uint32_t                     timer_failures;    /**< Starts left to fail, as with a full queue. */
+    edge_t                       edges[MAX_EDGES];
+    uint32_t                     edge_count;
+    uint32_t                     next_edge;
+} m_sim;
+
+static report_t m_reports[MAX_REPORTS];
+static uint32_t m_report_count;
+
+static app_button_cfg_t m_buttons[2];
+
+
+uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                          app_timer_mode_t            mode,
+                          app_timer_timeout_handler_t timeout_handler)
+{
+    CHECK_EQ(mode, APP_TIMER_MODE_SINGLE_SHOT);
+    m_sim.timer_handler = timeout_handler;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    CHECK(timeout_ticks >= APP_TIMER_MIN_TIMEOUT_TICKS);
+    if (m_sim.timer_failures != 0)
+    {
+        m_sim.timer_failures--;
+        return NRF_ERROR_NO_MEM;
+    }
+    if (m_sim.timer_running)
+    {
+        m_sim.timer_restarts++;
+    }
+    m_sim.timer_starts++;
+    m_sim.timer_running = true;
+    m_sim.timer_expiry  = m_sim.now + timeout_ticks;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_stop(app_timer_id_t timer_id)
+{
+    m_sim.timer_running = false;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_get(uint32_t * p_ticks)
+{
+    *p_ticks = (uint32_t)(m_sim.counter_base + m_sim.now) & RTC_COUNTER_MASK;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from, uint32_t * p_ticks_diff)
+{
+    *p_ticks_diff = (ticks_to - ticks_from) & RTC_COUNTER_MASK;
+    return NRF_SUCCESS;
+}
+
+
+bool nrf_drv_gpiote_is_init(void)
+{
+    return true;
+}
+
+
+ret_code_t nrf_drv_gpiote_init(void)
+{
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_drv_gpiote_in_init(nrf_drv_gpiote_pin_t               pin,
+                                  nrf_drv_gpiote_in_config_t const * p_config,
+                                  nrf_drv_gpiote_evt_handler_t       evt_handler)
+{
+    CHECK(!p_config->hi_accuracy);
+    CHECK_EQ(p_config->sense, NRF_GPIOTE_POLARITY_TOGGLE);
+    m_sim.gpiote_handler = evt_handler;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_gpiote_in_event_enable(nrf_drv_gpiote_pin_t pin, bool int_enable)
+{
+    CHECK(int_enable);
+    m_sim.enabled |= 1UL << pin;
+}
+
+
+void nrf_drv_gpiote_in_event_disable(nrf_drv_gpiote_pin_t pin)
+{
+    m_sim.enabled &= ~(1UL << pin);
+}
+
+
+bool nrf_drv_gpiote_in_is_set(nrf_drv_gpiote_pin_t pin)
+{
+    return (m_sim.levels & (1UL << pin)) != 0;
+}
+
+
+static void button_handler(uint8_t pin_no, uint8_t button_action)
+{
+    CHECK(m_report_count < MAX_REPORTS);
+    if (m_report_count < MAX_REPORTS)
+    {
+        m_reports[m_report_count].time   = m_sim.now;
+        m_reports[m_report_count].pin    = pin_no;
+        m_reports[m_report_count].action = button_action;
+        m_report_count++;
+    }
+}
+
+
+/**@brief Function for adding an edge to the script. Edges must be added in time order. */
+static void edge_add(uint64_t time, uint8_t pin, bool level)
+{
+    CHECK(m_sim.edge_count < MAX_EDGES);
+    CHECK((m_sim.edge_count == 0) || (m_sim.edges[m_sim.edge_count - 1].time <= time));
+    if (m_sim.edge_count < MAX_EDGES)
+    {
+        m_sim.edges[m_sim.edge_count++] = (edge_t){time, pin, level};
+    }
+}
+
+
+/**@brief Function for adding a bouncing transition: the pin toggles every @p period ticks,
+ *        @p toggles times, and then settles at @p level.
+ *
+ * @return  Time of the last edge.
+ */
+static uint64_t bounce_add(uint64_t start, uint8_t pin, bool level, uint32_t toggles, uint32_t period)
+{
+    uint64_t time = start;
+
+    for (uint32_t i = 0; i < toggles; i++, time += period)
+    {
+        edge_add(time, pin, (i % 2 == 0) ? level : !level);
+    }
+    edge_add(time, pin, level);
+    return time;
+}
+
+
+/**@brief Function for running the script until @p end, in time order. An edge and a timer
+ *        expiry at the same time: the edge comes first. */
+static void run_until(uint64_t end)
+{
+    for (;;)
+    {
+        bool     edge_next  = (m_sim.next_edge < m_sim.edge_count);
+        uint64_t edge_time  = edge_next ? m_sim.edges[m_sim.next_edge].time : UINT64_MAX;
+        uint64_t timer_time = m_sim.timer_running ? m_sim.timer_expiry : UINT64_MAX;
+
+        if ((edge_time > end) && (timer_time > end))
+        {
+            break;
+        }
+
+        if (edge_time <= timer_time)
+        {
+            edge_t const * p_edge = &m_sim.edges[m_sim.next_edge++];
+            uint32_t       mask   = 1UL << p_edge->pin;
+
+            m_sim.now = edge_time;
+            if (((m_sim.levels & mask) != 0) != p_edge->level)
+            {
+                m_sim.levels ^= mask;
+                if (m_sim.enabled & mask)
+                {
+                    m_sim.gpiote_handler(p_edge->pin, NRF_GPIOTE_POLARITY_TOGGLE);
+                }
+            }
+        }
+        else
+        {
+            m_sim.now           = timer_time;
+            m_sim.timer_running = false;
+            m_sim.timer_handler(NULL);
+        }
+    }
+    m_sim.now = end;
+}
+
+
+/**@brief Function for restarting the simulation with the buttons released.
+ *
+ * @param[in]  counter_base  RTC counter at time 0.
+ */
+static void sim_reset(uint32_t counter_base)
+{
+    memset(&m_sim, 0, sizeof(m_sim));
+    m_sim.counter_base = counter_base;
+    m_sim.levels       = 1UL << PIN_LOW_ACTIVE;
+    m_report_count     = 0;
+
+    CHECK_EQ(app_button_init(m_buttons, 2, DETECTION_DELAY), NRF_SUCCESS);
+    CHECK_EQ(app_button_enable(), NRF_SUCCESS);
+}
+
+
+static void test_clean_press(void)
+{
+    sim_reset(0);
+    edge_add(1000, PIN_LOW_ACTIVE, false);
+    edge_add(5000, PIN_LOW_ACTIVE, true);
+    run_until(10000);
+
+    CHECK_EQ(m_report_count, 2);
+    CHECK_EQ(m_reports[0].time, 1000 + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].pin, PIN_LOW_ACTIVE);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+    CHECK_EQ(m_reports[1].time, 5000 + DETECTION_DELAY);
+    CHECK_EQ(m_reports[1].action, APP_BUTTON_RELEASE);
+    CHECK_EQ(m_sim.timer_starts, 2);
+    CHECK_EQ(m_sim.timer_restarts, 0);
+}
+
+
+/**@brief A burst shorter than the detection delay: one start, one re-arm for the rest of the
+ *        quiet period, and the button is reported exactly one delay after the last edge. */
+static void test_short_burst(void)
+{
+    uint64_t last;
+
+    sim_reset(0);
+    last = bounce_add(1000, PIN_LOW_ACTIVE, false, 6, 5);
+    run_until(3000);
+
+    CHECK_EQ(m_report_count, 1);
+    CHECK_EQ(m_reports[0].time, last + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+    CHECK_EQ(m_sim.timer_starts, 2);
+    CHECK_EQ(m_sim.timer_restarts, 0);
+}
+
+
+/**@brief A burst several delays long: the timer is re-armed about once per delay, not on every
+ *        edge, and nothing is reported while the contact bounces. */
+static void test_long_burst(void)
+{
+    uint32_t const toggles = 40;
+    uint32_t const period  = 30;
+    uint64_t       last;
+
+    sim_reset(0);
+    last = bounce_add(1000, PIN_HIGH_ACTIVE, true, toggles, period);
+    run_until(last + DETECTION_DELAY - 1);
+    CHECK_EQ(m_report_count, 0);
+    run_until(last + 4 * DETECTION_DELAY);
+
+    CHECK_EQ(m_report_count, 1);
+    CHECK_EQ(m_reports[0].time, last + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].pin, PIN_HIGH_ACTIVE);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+    CHECK(m_sim.timer_starts <= (toggles * period) / DETECTION_DELAY + 2);
+    CHECK(m_sim.timer_starts < toggles / 4);
+    CHECK_EQ(m_sim.timer_restarts, 0);
+}
+
+
+/**@brief A glitch that returns to the idle level within the delay is not reported. */
+static void test_glitch(void)
+{
+    sim_reset(0);
+    edge_add(1000, PIN_LOW_ACTIVE, false);
+    edge_add(1020, PIN_LOW_ACTIVE, true);
+    bounce_add(2000, PIN_HIGH_ACTIVE, false, 4, 7);    // Even number of edges back to idle.
+    run_until(4000);
+
+    CHECK_EQ(m_report_count, 0);
+}
+
+
+/**@brief Two buttons bouncing at the same time share the timer, and both are reported once the
+ *        last edge on either of them is a delay old. */
+static void test_two_buttons(void)
+{
+    uint64_t last;
+
+    sim_reset(0);
+    edge_add(1000, PIN_LOW_ACTIVE, false);
+    edge_add(1004, PIN_HIGH_ACTIVE, true);
+    edge_add(1010, PIN_LOW_ACTIVE, true);
+    edge_add(1013, PIN_HIGH_ACTIVE, false);
+    edge_add(1020, PIN_LOW_ACTIVE, false);
+    edge_add(1030, PIN_HIGH_ACTIVE, true);
+    last = 1030;
+    run_until(3000);
+
+    CHECK_EQ(m_report_count, 2);
+    CHECK_EQ(m_reports[0].time, last + DETECTION_DELAY);
+    CHECK_EQ(m_reports[1].time, last + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+    CHECK_EQ(m_reports[1].action, APP_BUTTON_PUSH);
+    CHECK(m_reports[0].pin != m_reports[1].pin);
+    CHECK_EQ(m_sim.timer_restarts, 0);
+}
+
+
+/**@brief The quiet time is measured across the wrap of the 24-bit RTC counter. */
+static void test_counter_wrap(void)
+{
+    uint64_t last;
+
+    sim_reset(RTC_COUNTER_MASK - 1030);
+    last = bounce_add(1000, PIN_LOW_ACTIVE, false, 10, 8);
+    run_until(3000);
+
+    CHECK_EQ(m_report_count, 1);
+    CHECK_EQ(m_reports[0].time, last + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+}
+
+
+/**@brief A timer that cannot be started loses the press, and the module keeps working for the
+ *        next one. When the re-arm cannot be started, the level is reported at once instead of
+ *        being lost. */
+static void test_timer_failures(void)
+{
+    uint64_t last;
+
+    sim_reset(0);
+    m_sim.timer_failures = 1;
+    edge_add(1000, PIN_LOW_ACTIVE, false);
+    edge_add(2000, PIN_LOW_ACTIVE, true);
+    edge_add(3000, PIN_LOW_ACTIVE, false);
+    run_until(4000);
+    CHECK_EQ(m_report_count, 1);
+    CHECK_EQ(m_reports[0].time, 3000 + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+
+    sim_reset(0);
+    last = bounce_add(1000, PIN_LOW_ACTIVE, false, 3, 50);
+    run_until(1000 + DETECTION_DELAY - 1);
+    m_sim.timer_failures = 1;
+    run_until(last + 2 * DETECTION_DELAY);
+    CHECK_EQ(m_report_count, 1);
+    CHECK_EQ(m_reports[0].time, 1000 + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+    CHECK(!m_sim.timer_running);
+}
+
+
+/**@brief Disabling the buttons while the delay runs drops the pending detection. The release
+ *        while disabled is not seen, and the next press after enabling them again is reported. */
+static void test_disable(void)
+{
+    sim_reset(0);
+    edge_add(1000, PIN_LOW_ACTIVE, false);
+    edge_add(2000, PIN_LOW_ACTIVE, true);
+    edge_add(3000, PIN_LOW_ACTIVE, false);
+    run_until(1050);
+    CHECK_EQ(app_button_disable(), NRF_SUCCESS);
+    CHECK(!m_sim.timer_running);
+    run_until(2500);
+    CHECK_EQ(m_report_count, 0);
+
+    CHECK_EQ(app_button_enable(), NRF_SUCCESS);
+    run_until(4000);
+    CHECK_EQ(m_report_count, 1);
+    CHECK_EQ(m_reports[0].time, 3000 + DETECTION_DELAY);
+    CHECK_EQ(m_reports[0].action, APP_BUTTON_PUSH);
+}
+
+
+int main(void)
+{
+    m_buttons[0] = (app_button_cfg_t){PIN_LOW_ACTIVE,  APP_BUTTON_ACTIVE_LOW,  NRF_GPIO_PIN_PULLUP,   button_handler};
+    m_buttons[1] = (app_button_cfg_t){PIN_HIGH_ACTIVE, APP_BUTTON_ACTIVE_HIGH, NRF_GPIO_PIN_PULLDOWN, button_handler};
+
+    CHECK_EQ(app_button_init(m_buttons, 2, APP_TIMER_MIN_TIMEOUT_TICKS - 1), NRF_ERROR_INVALID_PARAM);
+
+    test_clean_press();
+    test_short_burst();
+    test_long_burst();
+    test_glitch();
+    test_two_buttons();
+    test_counter_wrap();
+    test_timer_failures();
+    test_disable();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Energy accounting current model, checked against hand computed charges.
+ */
+
+#include "unit_test.h"
+#include "app_energy_model.h"
+
+#define TICK_HZ     32768
+#define DAY_TICKS   (86400ULL * TICK_HZ)
+
+
+static void test_charge(void)
+{
+    // 1 mA for one second is 1 mC.
+    CHECK_EQ(app_energy_charge_nc(1000, TICK_HZ, TICK_HZ), 1000000);
+
+    // 3 uA for one tick, 91.55 nC truncated.
+    CHECK_EQ(app_energy_charge_nc(3, 1, TICK_HZ), 0);
+    CHECK_EQ(app_energy_charge_nc(3, 1000, TICK_HZ), 91);
+
+    CHECK_EQ(app_energy_charge_nc(0, DAY_TICKS, TICK_HZ), 0);
+    CHECK_EQ(app_energy_charge_nc(5000, 0, TICK_HZ), 0);
+
+    // 10 mA for one year must not overflow the intermediate product.
+    CHECK_EQ(app_energy_charge_nc(10000, 365 * DAY_TICKS, TICK_HZ), 315360000000000ULL);
+
+    // Other tick rates, for counters kept in TIMER ticks.
+    CHECK_EQ(app_energy_charge_nc(6500, 1000000, 1000000), 6500000);
+    CHECK_EQ(app_energy_charge_nc(1, 3, 3), 1000);
+}
+
+
+static void test_compute(void)
+{
+    app_energy_model_t    model    = APP_ENERGY_MODEL_DEFAULT;
+    app_energy_counters_t counters = {0};
+    app_energy_charge_t   charge;
+    uint64_t              sum;
+
+    // One hour with the CPU awake 1 % of the time and the radio 0.1 %.
+    counters.elapsed                  = 3600ULL * TICK_HZ;
+    counters.active[APP_ENERGY_CPU]   = counters.elapsed / 100;
+    counters.active[APP_ENERGY_RADIO] = counters.elapsed / 1000;
+
+    app_energy_charge_compute(&model, &counters, TICK_HZ, &charge);
+
+    CHECK_EQ(charge.sleep_nc, 3ULL * 3600 * 1000);
+    CHECK_EQ(charge.active_nc[APP_ENERGY_CPU], app_energy_charge_nc(3700, counters.elapsed / 100, TICK_HZ));
+    CHECK_EQ(charge.active_nc[APP_ENERGY_RADIO], app_energy_charge_nc(6500, counters.elapsed / 1000, TICK_HZ));
+    CHECK_EQ(charge.active_nc[APP_ENERGY_FLASH], 0);
+
+    sum = charge.sleep_nc;
+    for (uint32_t i = 0; i < APP_ENERGY_SUBSYS_COUNT; i++)
+    {
+        sum += charge.active_nc[i];
+    }
+    CHECK_EQ(charge.total_nc, sum);
+
+    // 3 uA + 1 % of 3.7 mA + 0.1 % of 6.5 mA = 46.5 uA, truncated.
+    CHECK_EQ(app_energy_average_ua(&charge, &counters, TICK_HZ), 46);
+}
+
+
+static void test_average(void)
+{
+    app_energy_model_t    model    = {.sleep_ua = 2};
+    app_energy_counters_t counters = {0};
+    app_energy_charge_t   charge;
+
+    app_energy_charge_compute(&model, &counters, TICK_HZ, &charge);
+    CHECK_EQ(charge.total_nc, 0);
+    CHECK_EQ(app_energy_average_ua(&charge, &counters, TICK_HZ), 0);
+
+    // Overlapping subsystems add up.
+    model.active_ua[APP_ENERGY_TWI] = 600;
+    model.active_ua[APP_ENERGY_SPI] = 400;
+    counters.elapsed                = 10 * TICK_HZ;
+    counters.active[APP_ENERGY_TWI] = counters.elapsed;
+    counters.active[APP_ENERGY_SPI] = counters.elapsed;
+
+    app_energy_charge_compute(&model, &counters, TICK_HZ, &charge);
+    CHECK_EQ(app_energy_average_ua(&charge, &counters, TICK_HZ), 1002);
+}
+
+
+static void test_ticks_to_ms(void)
+{
+    CHECK_EQ(app_energy_ticks_to_ms(0, TICK_HZ), 0);
+    CHECK_EQ(app_energy_ticks_to_ms(TICK_HZ, TICK_HZ), 1000);
+    CHECK_EQ(app_energy_ticks_to_ms(33, TICK_HZ), 1);
+    CHECK_EQ(app_energy_ticks_to_ms(32, TICK_HZ), 0);
+    CHECK_EQ(app_energy_ticks_to_ms(DAY_TICKS, TICK_HZ), 86400000);
+}
+
+
+int main(void)
+{
+    test_charge();
+    test_compute();
+    test_average();
+    test_ticks_to_ms();
+
+    return UNIT_TEST_RESULT();
+}
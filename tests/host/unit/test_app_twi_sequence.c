@@ -0,0 +1,652 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief app_twi sequences on TWIM0: frame order, the end of the ring and late interrupts.
+ *
+ * @details The TWI driver runs on the TWIM0 registers, the PPI and TIMER drivers are played by
+ *          the test, since their set and clear registers do not hold in RAM. Each trigger event
+ *          goes through the enabled PPI channels: TWIM0 writes one frame at RXD.PTR and moves it
+ *          on in list mode, and its STOPPED event counts on TIMER3, with the compare events,
+ *          shortcuts and channel group tasks they are connected to. The timer interrupt is
+ *          served a given number of triggers after it is raised, to play the latency.
+ *
+ *          Every frame holds the number of the read that wrote it, so the frames reported must
+ *          be consecutive reads, whatever the latency. The EasyDMA buffers are linked at the
+ *          start of the Data RAM, where the driver requires them to be.
+ */
+
+#include <string.h>
+#include "unit_test.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "app_util_platform.h"
+#include "app_twi.h"
+#include "nrf_drv_ppi.h"
+#include "nrf_drv_timer.h"
+
+#define FRAME_LENGTH        6
+#define FRAMES_PER_EVENT    4
+#define FRAME_COUNT         (4 * FRAMES_PER_EVENT)
+#define GUARD_LENGTH        16
+#define TRIGGERS            500
+#define LATENCY_NEVER       0xFFFFFFFF
+
+#define PPI_CHANNELS        16
+#define PPI_GROUPS          6
+#define CC_CHANNELS         4
+
+#define DMA_RAM             __attribute__((section(".dma_ram")))
+
+static uint32_t m_trigger_event;                    /**< Event starting the reads, as an RTC one. */
+static uint8_t  m_reg[1] DMA_RAM = {0x28};
+static uint8_t  m_ring[FRAME_COUNT * FRAME_LENGTH + GUARD_LENGTH] DMA_RAM;
+
+static app_twi_t                     m_app_twi = APP_TWI_INSTANCE(0);
+static app_twi_transaction_t const * m_queue[4];
+static nrf_drv_timer_t const         m_counter = NRF_DRV_TIMER_INSTANCE(3);
+
+/**@brief State of the PPI played by the test. */
+static struct
+{
+    uint32_t allocated;
+    uint32_t enabled;
+    uint32_t eep[PPI_CHANNELS];
+    uint32_t tep[PPI_CHANNELS];
+    uint32_t groups_allocated;
+    uint32_t group[PPI_GROUPS];
+} m_ppi;
+
+/**@brief State of TIMER3 played by the test. One bit per CC channel in the masks. */
+static struct
+{
+    nrf_timer_event_handler_t handler;
+    void *                    p_context;
+    bool                      running;
+    uint32_t                  counter;
+    uint32_t                  cc[CC_CHANNELS];
+    uint32_t                  clear_shorts;
+    uint32_t                  inten;
+    uint32_t                  events;
+} m_timer;
+
+/**@brief State of the reads. */
+static struct
+{
+    uint32_t reads;                 /**< Frames written by TWIM0. */
+    uint32_t overruns;              /**< Frames that would have been written past the ring. */
+    uint32_t skipped;               /**< Trigger events that started no read. */
+    uint32_t irq_age;               /**< Triggers since the timer interrupt was raised. */
+} m_hw;
+
+/**@brief Frames reported by the callback. */
+static struct
+{
+    uint32_t next_read;             /**< Read expected in the next reported frame. */
+    uint32_t frames;
+    uint32_t events;
+    uint32_t errors;
+    uint32_t stop_after;            /**< Events after which the callback stops the sequence. */
+} m_cb;
+
+
+uint32_t nrf_drv_ppi_init(void)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_channel_alloc(nrf_ppi_channel_t * p_channel)
+{
+    for (uint32_t ch = 0; ch < PPI_CHANNELS; ch++)
+    {
+        if (!(m_ppi.allocated & (1UL << ch)))
+        {
+            m_ppi.allocated |= 1UL << ch;
+            *p_channel = (nrf_ppi_channel_t)ch;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NO_MEM;
+}
+
+
+uint32_t nrf_drv_ppi_channel_free(nrf_ppi_channel_t channel)
+{
+    CHECK(m_ppi.allocated & (1UL << channel));
+    m_ppi.allocated &= ~(1UL << channel);
+    m_ppi.enabled   &= ~(1UL << channel);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_channel_assign(nrf_ppi_channel_t channel, uint32_t eep, uint32_t tep)
+{
+    CHECK(m_ppi.allocated & (1UL << channel));
+    m_ppi.eep[channel] = eep;
+    m_ppi.tep[channel] = tep;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_channel_enable(nrf_ppi_channel_t channel)
+{
+    CHECK(m_ppi.allocated & (1UL << channel));
+    m_ppi.enabled |= 1UL << channel;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_channel_disable(nrf_ppi_channel_t channel)
+{
+    m_ppi.enabled &= ~(1UL << channel);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_group_alloc(nrf_ppi_channel_group_t * p_group)
+{
+    for (uint32_t group = 0; group < PPI_GROUPS; group++)
+    {
+        if (!(m_ppi.groups_allocated & (1UL << group)))
+        {
+            m_ppi.groups_allocated |= 1UL << group;
+            *p_group = (nrf_ppi_channel_group_t)group;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NO_MEM;
+}
+
+
+uint32_t nrf_drv_ppi_group_free(nrf_ppi_channel_group_t group)
+{
+    CHECK(m_ppi.groups_allocated & (1UL << group));
+    m_ppi.groups_allocated &= ~(1UL << group);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_channels_include_in_group(uint32_t                channel_mask,
+                                               nrf_ppi_channel_group_t group)
+{
+    m_ppi.group[group] |= channel_mask;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_channels_remove_from_group(uint32_t                channel_mask,
+                                                nrf_ppi_channel_group_t group)
+{
+    m_ppi.group[group] &= ~channel_mask;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_group_enable(nrf_ppi_channel_group_t group)
+{
+    m_ppi.enabled |= m_ppi.group[group];
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_drv_ppi_group_disable(nrf_ppi_channel_group_t group)
+{
+    m_ppi.enabled &= ~m_ppi.group[group];
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_drv_timer_init(nrf_drv_timer_t const * const  p_instance,
+                              nrf_drv_timer_config_t const * p_config,
+                              nrf_timer_event_handler_t      timer_event_handler)
+{
+    CHECK(p_instance->p_reg == NRF_TIMER3);
+    CHECK_EQ(p_config->mode, NRF_TIMER_MODE_COUNTER);
+    if (m_timer.handler != NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    memset(&m_timer, 0, sizeof(m_timer));
+    m_timer.handler   = timer_event_handler;
+    m_timer.p_context = p_config->p_context;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_timer_uninit(nrf_drv_timer_t const * const p_instance)
+{
+    memset(&m_timer, 0, sizeof(m_timer));
+}
+
+
+void nrf_drv_timer_enable(nrf_drv_timer_t const * const p_instance)
+{
+    m_timer.running = true;
+}
+
+
+void nrf_drv_timer_clear(nrf_drv_timer_t const * const p_instance)
+{
+    m_timer.counter = 0;
+}
+
+
+uint32_t nrf_drv_timer_capture(nrf_drv_timer_t const * const p_instance,
+                               nrf_timer_cc_channel_t        cc_channel)
+{
+    m_timer.cc[cc_channel] = m_timer.counter;
+    return m_timer.counter;
+}
+
+
+void nrf_drv_timer_compare(nrf_drv_timer_t const * const p_instance,
+                           nrf_timer_cc_channel_t        cc_channel,
+                           uint32_t                      cc_value,
+                           bool                          enable_int)
+{
+    m_timer.cc[cc_channel] = cc_value;
+    if (enable_int)
+    {
+        m_timer.inten |= 1UL << cc_channel;
+    }
+    else
+    {
+        m_timer.inten &= ~(1UL << cc_channel);
+    }
+}
+
+
+void nrf_drv_timer_extended_compare(nrf_drv_timer_t const * const p_instance,
+                                    nrf_timer_cc_channel_t        cc_channel,
+                                    uint32_t                      cc_value,
+                                    nrf_timer_short_mask_t        timer_short_mask,
+                                    bool                          enable_int)
+{
+    CHECK_EQ(timer_short_mask & ~(TIMER_SHORTS_COMPARE0_CLEAR_Msk << cc_channel), 0);
+    m_timer.clear_shorts &= ~(1UL << cc_channel);
+    if (timer_short_mask != 0)
+    {
+        m_timer.clear_shorts |= 1UL << cc_channel;
+    }
+    nrf_drv_timer_compare(p_instance, cc_channel, cc_value, enable_int);
+}
+
+
+static uint32_t frame_read_get(uint8_t const * p_frame)
+{
+    uint32_t read;
+
+    memcpy(&read, p_frame, sizeof(read));
+    return read;
+}
+
+
+static bool ppi_event(uint32_t event_address);
+
+
+/**@brief Function for one read: the register write, then a frame written at RXD.PTR. */
+static void twim_starttx(void)
+{
+    uint8_t * p_frame = (uint8_t *)(uintptr_t)NRF_TWIM0->RXD.PTR;
+
+    CHECK(NRF_TWIM0->TXD.PTR == (uint32_t)(uintptr_t)m_reg);
+    CHECK_EQ(NRF_TWIM0->RXD.MAXCNT, FRAME_LENGTH);
+    if (p_frame + FRAME_LENGTH > &m_ring[FRAME_COUNT * FRAME_LENGTH])
+    {
+        m_hw.overruns++;
+    }
+    else
+    {
+        memcpy(p_frame, &m_hw.reads, sizeof(m_hw.reads));
+        memset(p_frame + sizeof(m_hw.reads), 0xA5, FRAME_LENGTH - sizeof(m_hw.reads));
+    }
+    m_hw.reads++;
+    if (NRF_TWIM0->RXD.LIST == TWIM_RXD_LIST_LIST_ArrayList)
+    {
+        NRF_TWIM0->RXD.PTR += NRF_TWIM0->RXD.MAXCNT;
+    }
+    NRF_TWIM0->EVENTS_STOPPED = 1;
+    UNUSED_RETURN_VALUE(ppi_event((uint32_t)(uintptr_t)&NRF_TWIM0->EVENTS_STOPPED));
+}
+
+
+static void timer_count(void)
+{
+    uint32_t matches = 0;
+
+    if (!m_timer.running)
+    {
+        return;
+    }
+    m_timer.counter = (m_timer.counter + 1) & 0xFFFF;
+    for (uint32_t i = 0; i < CC_CHANNELS; i++)
+    {
+        if (m_timer.cc[i] == m_timer.counter)
+        {
+            matches |= 1UL << i;
+        }
+    }
+    m_timer.events |= matches;
+    for (uint32_t i = 0; i < CC_CHANNELS; i++)
+    {
+        if (matches & (1UL << i))
+        {
+            UNUSED_RETURN_VALUE(ppi_event((uint32_t)(uintptr_t)&NRF_TIMER3->EVENTS_COMPARE[i]));
+        }
+    }
+    if (matches & m_timer.clear_shorts)
+    {
+        m_timer.counter = 0;
+    }
+}
+
+
+static void ppi_task(uint32_t task_address)
+{
+    if (task_address == (uint32_t)(uintptr_t)&NRF_TWIM0->TASKS_STARTTX)
+    {
+        twim_starttx();
+        return;
+    }
+    if (task_address == (uint32_t)(uintptr_t)&NRF_TIMER3->TASKS_COUNT)
+    {
+        timer_count();
+        return;
+    }
+    for (uint32_t group = 0; group < PPI_GROUPS; group++)
+    {
+        if (task_address == nrf_drv_ppi_task_addr_group_disable_get(group))
+        {
+            m_ppi.enabled &= ~m_ppi.group[group];
+            return;
+        }
+    }
+    CHECK(false);
+}
+
+
+/**@brief Function for running the tasks of the enabled channels connected to an event.
+ *
+ * @return  True if a channel is connected to the event.
+ */
+static bool ppi_event(uint32_t event_address)
+{
+    // The channels are taken before any of their tasks runs.
+    uint32_t enabled   = m_ppi.enabled;
+    bool     connected = false;
+
+    for (uint32_t ch = 0; ch < PPI_CHANNELS; ch++)
+    {
+        if ((enabled & (1UL << ch)) && (m_ppi.eep[ch] == event_address))
+        {
+            connected = true;
+            ppi_task(m_ppi.tep[ch]);
+        }
+    }
+    return connected;
+}
+
+
+static void timer_irq(void)
+{
+    for (uint32_t i = 0; i < CC_CHANNELS; i++)
+    {
+        if ((m_timer.handler != NULL) && (m_timer.events & m_timer.inten & (1UL << i)))
+        {
+            m_timer.events &= ~(1UL << i);
+            m_timer.handler(nrf_timer_compare_event_get(i), m_timer.p_context);
+        }
+    }
+}
+
+
+/**@brief Function for the trigger event, followed by the timer interrupt once it is old enough. */
+static void trigger(uint32_t latency)
+{
+    if (!ppi_event((uint32_t)(uintptr_t)&m_trigger_event))
+    {
+        // While the sequence runs, reads stop only between the end of the ring and the rewind.
+        CHECK((m_timer.handler == NULL) || (m_timer.events & (1UL << NRF_TIMER_CC_CHANNEL1)));
+        m_hw.skipped++;
+    }
+
+    if (!(m_timer.events & m_timer.inten))
+    {
+        m_hw.irq_age = 0;
+    }
+    else if (m_hw.irq_age++ >= latency)
+    {
+        m_hw.irq_age = 0;
+        timer_irq();
+    }
+}
+
+
+static void sequence_callback(ret_code_t result,
+                              uint8_t *  p_frames,
+                              uint16_t   frame_count,
+                              void *     p_user_data)
+{
+    if (result != NRF_SUCCESS)
+    {
+        m_cb.errors++;
+        return;
+    }
+
+    CHECK_EQ(frame_count, FRAMES_PER_EVENT);
+    CHECK(p_frames == &m_ring[(m_cb.frames % FRAME_COUNT) * FRAME_LENGTH]);
+    for (uint32_t i = 0; i < frame_count; i++)
+    {
+        uint8_t const * p_frame = &p_frames[i * FRAME_LENGTH];
+
+        CHECK_EQ(frame_read_get(p_frame), m_cb.next_read);
+        CHECK_EQ(p_frame[FRAME_LENGTH - 1], 0xA5);
+        m_cb.next_read = frame_read_get(p_frame) + 1;
+    }
+    m_cb.frames += frame_count;
+    m_cb.events++;
+
+    if (m_cb.events == m_cb.stop_after)
+    {
+        app_twi_sequence_stop(&m_app_twi);
+    }
+}
+
+
+static app_twi_sequence_t m_sequence =
+{
+    .address          = 0x1D,
+    .reg_length       = sizeof(m_reg),
+    .frame_length     = FRAME_LENGTH,
+    .frame_count      = FRAME_COUNT,
+    .frames_per_event = FRAMES_PER_EVENT,
+    .p_reg            = m_reg,
+    .p_frames         = m_ring,
+    .p_counter        = &m_counter,
+    .callback         = sequence_callback,
+};
+
+
+static void sequence_start(void)
+{
+    memset(&m_hw, 0, sizeof(m_hw));
+    memset(&m_cb, 0, sizeof(m_cb));
+    memset(m_ring, 0, sizeof(m_ring));
+
+    m_sequence.trigger_event = (uint32_t)(uintptr_t)&m_trigger_event;
+    CHECK_EQ(app_twi_sequence_start(&m_app_twi, &m_sequence), NRF_SUCCESS);
+    CHECK(app_twi_is_idle(&m_app_twi));
+}
+
+
+/**@brief Function for checking that a stopped sequence left no PPI or timer resource behind. */
+static void resources_check(void)
+{
+    CHECK_EQ(m_ppi.allocated, 0);
+    CHECK_EQ(m_ppi.enabled, 0);
+    CHECK_EQ(m_ppi.groups_allocated, 0);
+    for (uint32_t group = 0; group < PPI_GROUPS; group++)
+    {
+        CHECK_EQ(m_ppi.group[group], 0);
+    }
+    CHECK(m_timer.handler == NULL);
+}
+
+
+static void sequence_stop(void)
+{
+    app_twi_sequence_stop(&m_app_twi);
+    resources_check();
+}
+
+
+static void guard_check(void)
+{
+    for (uint32_t i = FRAME_COUNT * FRAME_LENGTH; i < sizeof(m_ring); i++)
+    {
+        CHECK_EQ(m_ring[i], 0);
+    }
+    CHECK_EQ(m_hw.overruns, 0);
+}
+
+
+/**@brief Whatever the latency, the frames are reported in order before they are overwritten, and
+ *        nothing is written past the ring. */
+static void test_latency(uint32_t latency)
+{
+    sequence_start();
+    for (uint32_t i = 0; i < TRIGGERS; i++)
+    {
+        trigger(latency);
+    }
+    CHECK_EQ(m_hw.reads + m_hw.skipped, TRIGGERS);
+    CHECK_EQ(m_cb.errors, 0);
+    CHECK_EQ(m_cb.next_read, m_cb.frames);
+    CHECK(m_hw.reads - m_cb.frames <= FRAME_COUNT);
+    if (latency == 0)
+    {
+        CHECK_EQ(m_hw.skipped, 0);
+        CHECK_EQ(m_cb.frames, TRIGGERS - TRIGGERS % FRAMES_PER_EVENT);
+    }
+    else
+    {
+        // At most the latency is lost at the end of each ring.
+        CHECK(m_hw.skipped <= (TRIGGERS / FRAME_COUNT) * latency);
+        CHECK(m_cb.frames >= FRAME_COUNT);
+    }
+    guard_check();
+    sequence_stop();
+}
+
+
+/**@brief The interrupt is not served: the ring is filled once and the reads stop there. */
+static void test_no_interrupt(void)
+{
+    sequence_start();
+    for (uint32_t i = 0; i < TRIGGERS; i++)
+    {
+        trigger(LATENCY_NEVER);
+    }
+    CHECK_EQ(m_hw.reads, FRAME_COUNT);
+    CHECK_EQ(m_cb.frames, 0);
+    CHECK_EQ(m_timer.counter, 0);
+    guard_check();
+
+    // The interrupt then reports the whole ring and the reads go on from the first frame.
+    timer_irq();
+    CHECK_EQ(m_cb.frames, FRAME_COUNT);
+    CHECK_EQ(m_cb.events, FRAME_COUNT / FRAMES_PER_EVENT);
+    for (uint32_t i = 0; i < FRAMES_PER_EVENT; i++)
+    {
+        trigger(0);
+    }
+    CHECK_EQ(m_cb.frames, FRAME_COUNT + FRAMES_PER_EVENT);
+    CHECK_EQ(m_cb.next_read, FRAME_COUNT + FRAMES_PER_EVENT);
+    guard_check();
+    sequence_stop();
+}
+
+
+/**@brief The sequence stopped from its callback reports nothing more and frees its resources. */
+static void test_stop_in_callback(void)
+{
+    sequence_start();
+    m_cb.stop_after = 3;
+    for (uint32_t i = 0; i < TRIGGERS; i++)
+    {
+        trigger(0);
+    }
+    CHECK_EQ(m_cb.events, 3);
+    CHECK_EQ(m_hw.reads, 3 * FRAMES_PER_EVENT);
+    resources_check();
+
+    // The instance takes the next sequence.
+    test_latency(0);
+}
+
+
+static void test_invalid(void)
+{
+    app_twi_sequence_t sequence = m_sequence;
+    nrf_ppi_channel_t  channel;
+
+    // A ring of a single group of frames could not be read while the next one is written.
+    sequence.frame_count = FRAMES_PER_EVENT;
+    CHECK_EQ(app_twi_sequence_start(&m_app_twi, &sequence), NRF_ERROR_INVALID_PARAM);
+    sequence.frame_count = 3 * FRAMES_PER_EVENT / 2;
+    CHECK_EQ(app_twi_sequence_start(&m_app_twi, &sequence), NRF_ERROR_INVALID_PARAM);
+    sequence.frame_count      = FRAME_COUNT;
+    sequence.frames_per_event = 0;
+    CHECK_EQ(app_twi_sequence_start(&m_app_twi, &sequence), NRF_ERROR_INVALID_PARAM);
+
+    sequence_start();
+    CHECK_EQ(app_twi_sequence_start(&m_app_twi, &m_sequence), NRF_ERROR_BUSY);
+    sequence_stop();
+
+    // Without the three PPI channels, what was taken is given back.
+    for (uint32_t i = 0; i < PPI_CHANNELS - 2; i++)
+    {
+        CHECK_EQ(nrf_drv_ppi_channel_alloc(&channel), NRF_SUCCESS);
+    }
+    CHECK_EQ(app_twi_sequence_start(&m_app_twi, &m_sequence), NRF_ERROR_NO_MEM);
+    CHECK_EQ(m_ppi.allocated, (1UL << (PPI_CHANNELS - 2)) - 1);
+    CHECK_EQ(m_ppi.groups_allocated, 0);
+    m_ppi.allocated = 0;
+}
+
+
+int main(void)
+{
+    nrf_drv_twi_config_t config =
+    {
+        .scl                = 27,
+        .sda                = 26,
+        .frequency          = NRF_TWI_FREQ_400K,
+        .interrupt_priority = APP_IRQ_PRIORITY_LOW,
+    };
+
+    CHECK_EQ(app_twi_init(&m_app_twi, &config, sizeof(m_queue) / sizeof(m_queue[0]), m_queue),
+             NRF_SUCCESS);
+
+    test_invalid();
+    test_latency(0);
+    test_latency(FRAMES_PER_EVENT - 1);
+    test_latency(2 * FRAMES_PER_EVENT + 1);
+    test_latency(FRAME_COUNT);
+    test_latency(3 * FRAME_COUNT);
+    test_no_interrupt();
+    test_stop_in_callback();
+
+    return UNIT_TEST_RESULT();
+}
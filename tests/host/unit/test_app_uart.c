@@ -0,0 +1,177 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Chunk events of app_uart (without FIFO) on continuous UARTE reception.
+ *
+ * @details app_uart is built with APP_UART_RX_CHUNK_EVENTS. The driver is played by the test: its
+ *          chunks are passed to the app_uart handler, and each chunk must come back in one
+ *          APP_UART_DATA_CHUNK event and be released to the driver only after that event.
+ */
+
+#include <string.h>
+#include "unit_test.h"
+#include "nrf_error.h"
+#include "nrf_drv_uart.h"
+#include "app_uart.h"
+
+#define CHUNK_MAX       32
+
+static nrf_uart_event_handler_t m_drv_handler;
+static uint8_t *                m_stream_buffer;
+static size_t                   m_stream_length;
+static uint32_t                 m_release_count;
+static uint32_t                 m_rx_count;
+
+static uint32_t                 m_evt_count;
+static app_uart_evt_t           m_evt;
+static uint8_t                  m_evt_data[CHUNK_MAX];
+static uint32_t                 m_evt_release_count;    /**< Releases seen when the event was handled. */
+
+
+ret_code_t nrf_drv_uart_init(nrf_drv_uart_config_t const * p_config,
+                             nrf_uart_event_handler_t      event_handler)
+{
+    m_drv_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_uart_uninit(void)
+{
+    m_drv_handler = NULL;
+}
+
+
+ret_code_t nrf_drv_uart_rx_stream_start(uint8_t * p_buffer, size_t length, uint32_t idle_timeout_us)
+{
+    m_stream_buffer = p_buffer;
+    m_stream_length = length;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_uart_rx_stream_release(void)
+{
+    m_release_count++;
+}
+
+
+ret_code_t nrf_drv_uart_rx(uint8_t * p_data, size_t length)
+{
+    m_rx_count++;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_uart_rx_enable(void)
+{
+}
+
+
+ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, size_t length)
+{
+    return NRF_SUCCESS;
+}
+
+
+static void app_uart_event_handler(app_uart_evt_t * p_event)
+{
+    m_evt_count++;
+    m_evt               = *p_event;
+    m_evt_release_count = m_release_count;
+    if ((p_event->evt_type == APP_UART_DATA_CHUNK) && (p_event->data.chunk.length <= CHUNK_MAX))
+    {
+        memcpy(m_evt_data, p_event->data.chunk.p_data, p_event->data.chunk.length);
+    }
+}
+
+
+/**@brief Function for passing a chunk of the stream buffer to app_uart, as the driver does. */
+static void chunk_report(uint32_t offset, uint32_t length)
+{
+    nrf_drv_uart_event_t event;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        m_stream_buffer[offset + i] = (uint8_t)(offset * 3 + i);
+    }
+    event.type                  = NRF_DRV_UART_EVT_RX_DONE;
+    event.data.rxtx.p_data      = &m_stream_buffer[offset];
+    event.data.rxtx.bytes       = length;
+    m_drv_handler(&event, NULL);
+}
+
+
+static void test_chunks(void)
+{
+    app_uart_comm_params_t params =
+    {
+        .rx_pin_no    = 8,
+        .tx_pin_no    = 6,
+        .rts_pin_no   = 5,
+        .cts_pin_no   = 7,
+        .flow_control = APP_UART_FLOW_CONTROL_DISABLED,
+        .use_parity   = false,
+        .baud_rate    = UART_BAUDRATE_BAUDRATE_Baud1M,
+    };
+    uint8_t byte;
+
+    CHECK_EQ(app_uart_init(&params, NULL, app_uart_event_handler, APP_IRQ_PRIORITY_LOW),
+             NRF_SUCCESS);
+    CHECK(m_stream_buffer != NULL);
+    CHECK(m_stream_length >= 2 * CHUNK_MAX);
+    CHECK_EQ(m_rx_count, 0);
+    CHECK_EQ(app_uart_get(&byte), NRF_ERROR_INVALID_STATE);
+
+    // One event per chunk, whatever its length, and the release follows the event.
+    chunk_report(0, CHUNK_MAX);
+    CHECK_EQ(m_evt_count, 1);
+    CHECK_EQ(m_evt.evt_type, APP_UART_DATA_CHUNK);
+    CHECK(m_evt.data.chunk.p_data == m_stream_buffer);
+    CHECK_EQ(m_evt.data.chunk.length, CHUNK_MAX);
+    CHECK(memcmp(m_evt_data, m_stream_buffer, CHUNK_MAX) == 0);
+    CHECK_EQ(m_evt_release_count, 0);
+    CHECK_EQ(m_release_count, 1);
+
+    chunk_report(CHUNK_MAX, 1);
+    CHECK_EQ(m_evt_count, 2);
+    CHECK(m_evt.data.chunk.p_data == &m_stream_buffer[CHUNK_MAX]);
+    CHECK_EQ(m_evt.data.chunk.length, 1);
+    CHECK_EQ(m_evt_data[0], (uint8_t)(CHUNK_MAX * 3));
+    CHECK_EQ(m_evt_release_count, 1);
+    CHECK_EQ(m_release_count, 2);
+
+    // Errors do not stop continuous reception, nothing is restarted or released.
+    {
+        nrf_drv_uart_event_t event;
+
+        event.type                  = NRF_DRV_UART_EVT_ERROR;
+        event.data.error.error_mask = UART_ERRORSRC_FRAMING_Msk;
+        m_drv_handler(&event, NULL);
+    }
+    CHECK_EQ(m_evt.evt_type, APP_UART_COMMUNICATION_ERROR);
+    CHECK_EQ(m_evt.data.error_communication, UART_ERRORSRC_FRAMING_Msk);
+    CHECK_EQ(m_rx_count, 0);
+    CHECK_EQ(m_release_count, 2);
+
+    CHECK_EQ(app_uart_close(), NRF_SUCCESS);
+}
+
+
+int main(void)
+{
+    test_chunks();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,273 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief ANCS client: Data Source parsing at every split, app attribute cache and request
+ *        coalescing.
+ */
+
+#include "unit_test.h"
+#include "ancs_harness.h"
+
+#define NOTIF_UID   0x11223344
+
+static uint16_t const m_attr_lens[BLE_ANCS_NB_OF_ATTRS] =
+{
+    [BLE_ANCS_NOTIF_ATTR_ID_APP_IDENTIFIER] = 32,
+    [BLE_ANCS_NOTIF_ATTR_ID_TITLE]          = 16,
+    [BLE_ANCS_NOTIF_ATTR_ID_MESSAGE]        = 8,
+};
+
+static ble_ancs_c_t m_ancs;
+
+/**@brief Get Notification Attributes response for NOTIF_UID. The message is longer than its buffer. */
+static uint8_t const m_notif_rsp[] =
+{
+    BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES, 0x44, 0x33, 0x22, 0x11,
+    BLE_ANCS_NOTIF_ATTR_ID_APP_IDENTIFIER, 19, 0, 'c','o','m','.','a','p','p','l','e','.',
+                                                  'M','o','b','i','l','e','S','M','S',
+    BLE_ANCS_NOTIF_ATTR_ID_TITLE, 5, 0, 'A','l','i','c','e',
+    BLE_ANCS_NOTIF_ATTR_ID_MESSAGE, 25, 0, 'H','e','l','l','o',' ','t','h','e','r','e',',',' ',
+                                           'l','o','n','g',' ','m','e','s','s','a','g','e',
+};
+
+/**@brief Get App Attributes response with the display name of the app above. */
+static uint8_t const m_app_rsp[] =
+{
+    BLE_ANCS_COMMAND_ID_GET_APP_ATTRIBUTES,
+    'c','o','m','.','a','p','p','l','e','.','M','o','b','i','l','e','S','M','S', 0,
+    BLE_ANCS_APP_ATTR_ID_DISPLAY_NAME, 8, 0, 'M','e','s','s','a','g','e','s',
+};
+
+static uint8_t const m_app_id[] = "com.apple.MobileSMS";
+
+
+static void notif_request(void)
+{
+    ble_ancs_c_evt_notif_t notif = {.notif_uid = NOTIF_UID};
+
+    CHECK_EQ(ble_ancs_c_request_attrs(&m_ancs, &notif), NRF_SUCCESS);
+}
+
+
+static void notif_rsp_check(void)
+{
+    CHECK_EQ(g_ancs_evt_count, 3);
+    CHECK_EQ(g_ancs_evts[0].type, BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE);
+    CHECK_EQ(g_ancs_evts[0].notif_uid, NOTIF_UID);
+    CHECK_EQ(g_ancs_evts[0].attr_id, BLE_ANCS_NOTIF_ATTR_ID_APP_IDENTIFIER);
+    CHECK_STR(g_ancs_evts[0].data, "com.apple.MobileSMS");
+    CHECK_EQ(g_ancs_evts[1].attr_id, BLE_ANCS_NOTIF_ATTR_ID_TITLE);
+    CHECK_STR(g_ancs_evts[1].data, "Alice");
+    CHECK_EQ(g_ancs_evts[2].attr_id, BLE_ANCS_NOTIF_ATTR_ID_MESSAGE);
+    CHECK_EQ(g_ancs_evts[2].attr_len, 25);
+    CHECK_STR(g_ancs_evts[2].data, "Hello th");
+}
+
+
+static void test_notif_source(void)
+{
+    uint8_t const valid[]   = {BLE_ANCS_EVENT_ID_NOTIFICATION_ADDED, 0x02, BLE_ANCS_CATEGORY_ID_SOCIAL,
+                               3, 0x44, 0x33, 0x22, 0x11};
+    uint8_t const invalid[] = {BLE_ANCS_EVENT_ID_NOTIFICATION_ADDED, 0x02, 0x7F, 3, 0, 0, 0, 0};
+
+    ancs_harness_init(&m_ancs, m_attr_lens);
+
+    ancs_harness_hvx(&m_ancs, ANCS_HARNESS_NOTIF_SOURCE, valid, sizeof(valid));
+    CHECK_EQ(g_ancs_evt_count, 1);
+    CHECK_EQ(g_ancs_evts[0].type, BLE_ANCS_C_EVT_NOTIF);
+    CHECK_EQ(g_ancs_evts[0].notif.notif_uid, NOTIF_UID);
+    CHECK_EQ(g_ancs_evts[0].notif.category_id, BLE_ANCS_CATEGORY_ID_SOCIAL);
+    CHECK_EQ(g_ancs_evts[0].notif.category_count, 3);
+    CHECK(g_ancs_evts[0].notif.evt_flags.important);
+    CHECK(!g_ancs_evts[0].notif.evt_flags.silent);
+
+    ancs_harness_clear();
+    ancs_harness_hvx(&m_ancs, ANCS_HARNESS_NOTIF_SOURCE, invalid, sizeof(invalid));
+    CHECK_EQ(g_ancs_evt_count, 1);
+    CHECK_EQ(g_ancs_evts[0].type, BLE_ANCS_C_EVT_INVALID_NOTIF);
+
+    // A short notification is reported once and not read past its end.
+    ancs_harness_clear();
+    ancs_harness_hvx(&m_ancs, ANCS_HARNESS_NOTIF_SOURCE, valid, 5);
+    CHECK_EQ(g_ancs_evt_count, 1);
+    CHECK_EQ(g_ancs_evts[0].type, BLE_ANCS_C_EVT_INVALID_NOTIF);
+
+    ancs_harness_uninit(&m_ancs);
+}
+
+
+static void test_notif_attrs_split(void)
+{
+    ancs_harness_init(&m_ancs, m_attr_lens);
+    notif_request();
+    CHECK_EQ(g_ancs_write_count, 1);
+    CHECK_EQ(g_ancs_writes[0].handle, ANCS_HARNESS_CONTROL_POINT);
+    CHECK_EQ(g_ancs_writes[0].value[0], BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES);
+
+    ancs_harness_clear();
+    ancs_harness_hvx(&m_ancs, ANCS_HARNESS_DATA_SOURCE, m_notif_rsp, sizeof(m_notif_rsp));
+    notif_rsp_check();
+
+    // The same events whatever the notification boundaries are.
+    for (uint16_t split = 1; split < sizeof(m_notif_rsp); split++)
+    {
+        ancs_harness_clear();
+        ancs_harness_hvx(&m_ancs, ANCS_HARNESS_DATA_SOURCE, m_notif_rsp, split);
+        ancs_harness_hvx(&m_ancs, ANCS_HARNESS_DATA_SOURCE, &m_notif_rsp[split],
+                         (uint16_t)(sizeof(m_notif_rsp) - split));
+        notif_rsp_check();
+    }
+
+    ancs_harness_clear();
+    for (uint16_t i = 0; i < sizeof(m_notif_rsp); i++)
+    {
+        ancs_harness_hvx(&m_ancs, ANCS_HARNESS_DATA_SOURCE, &m_notif_rsp[i], 1);
+    }
+    notif_rsp_check();
+
+    // Two responses in one notification.
+    {
+        uint8_t two[2 * sizeof(m_notif_rsp)];
+
+        memcpy(two, m_notif_rsp, sizeof(m_notif_rsp));
+        memcpy(&two[sizeof(m_notif_rsp)], m_notif_rsp, sizeof(m_notif_rsp));
+        ancs_harness_clear();
+        ancs_harness_hvx(&m_ancs, ANCS_HARNESS_DATA_SOURCE, two, sizeof(two));
+        CHECK_EQ(g_ancs_evt_count, 6);
+        CHECK_STR(g_ancs_evts[5].data, "Hello th");
+    }
+
+    ancs_harness_uninit(&m_ancs);
+}
+
+
+static void test_app_attrs(void)
+{
+    ancs_harness_init(&m_ancs, m_attr_lens);
+
+    // The command is longer than one write, so it goes out as prepared writes, one per write
+    // response.
+    CHECK_EQ(ble_ancs_c_app_attr_request(&m_ancs, m_app_id, sizeof(m_app_id) - 1), NRF_SUCCESS);
+    CHECK_EQ(g_ancs_write_count, 1);
+    ancs_harness_write_rsp(&m_ancs);
+    ancs_harness_write_rsp(&m_ancs);
+    ancs_harness_write_rsp(&m_ancs);
+    CHECK_EQ(g_ancs_write_count, 3);
+    CHECK_EQ(g_ancs_writes[0].write_op, BLE_GATT_OP_PREP_WRITE_REQ);
+    CHECK_EQ(g_ancs_writes[0].offset, 0);
+    CHECK_EQ(g_ancs_writes[0].value[0], BLE_ANCS_COMMAND_ID_GET_APP_ATTRIBUTES);
+    CHECK_EQ(g_ancs_writes[1].write_op, BLE_GATT_OP_PREP_WRITE_REQ);
+    CHECK_EQ(g_ancs_writes[1].offset, g_ancs_writes[0].len);
+    CHECK_EQ(g_ancs_writes[0].len + g_ancs_writes[1].len, sizeof(m_app_id) + 2);
+    CHECK_EQ(g_ancs_writes[2].write_op, BLE_GATT_OP_EXEC_WRITE_REQ);
+
+    // A second request while the first is pending sends nothing.
+    ancs_harness_clear();
+    CHECK_EQ(ble_ancs_c_app_attr_request(&m_ancs, m_app_id, sizeof(m_app_id) - 1), NRF_SUCCESS);
+    CHECK_EQ(g_ancs_write_count, 0);
+    CHECK_EQ(g_ancs_evt_count, 0);
+
+    for (uint16_t i = 0; i < sizeof(m_app_rsp); i += 3)
+    {
+        uint16_t len = (uint16_t)MIN(3u, sizeof(m_app_rsp) - i);
+        ancs_harness_hvx(&m_ancs, ANCS_HARNESS_DATA_SOURCE, &m_app_rsp[i], len);
+    }
+    CHECK_EQ(g_ancs_evt_count, 1);
+    CHECK_EQ(g_ancs_evts[0].type, BLE_ANCS_C_EVT_APP_ATTRIBUTE);
+    CHECK_STR(g_ancs_evts[0].app_id, "com.apple.MobileSMS");
+    CHECK_STR(g_ancs_evts[0].data, "Messages");
+
+    // Now served from the cache.
+    ancs_harness_clear();
+    CHECK_EQ(ble_ancs_c_app_attr_request(&m_ancs, m_app_id, sizeof(m_app_id) - 1), NRF_SUCCESS);
+    CHECK_EQ(g_ancs_write_count, 0);
+    CHECK_EQ(g_ancs_evt_count, 1);
+    CHECK_STR(g_ancs_evts[0].data, "Messages");
+
+    CHECK_EQ(ble_ancs_c_app_attr_request(&m_ancs, m_app_id, 0), NRF_ERROR_INVALID_LENGTH);
+
+    ancs_harness_uninit(&m_ancs);
+}
+
+
+static void test_app_cache_eviction(void)
+{
+    uint8_t rsp[32];
+
+    ancs_harness_init(&m_ancs, m_attr_lens);
+
+    // One more app than the cache holds. The least recently used one is replaced.
+    for (uint8_t app = 0; app <= BLE_ANCS_APP_ATTR_CACHE_SIZE; app++)
+    {
+        uint8_t id[2] = {(uint8_t)('a' + app), 0};
+
+        CHECK_EQ(ble_ancs_c_app_attr_request(&m_ancs, id, 1), NRF_SUCCESS);
+
+        rsp[0] = BLE_ANCS_COMMAND_ID_GET_APP_ATTRIBUTES;
+        rsp[1] = id[0];
+        rsp[2] = 0;
+        rsp[3] = BLE_ANCS_APP_ATTR_ID_DISPLAY_NAME;
+        rsp[4] = 1;
+        rsp[5] = 0;
+        rsp[6] = (uint8_t)('A' + app);
+        ancs_harness_hvx(&m_ancs, ANCS_HARNESS_DATA_SOURCE, rsp, 7);
+    }
+
+    ancs_harness_clear();
+    CHECK_EQ(ble_ancs_c_app_attr_request(&m_ancs, (uint8_t const *)"e", 1), NRF_SUCCESS);
+    CHECK_EQ(g_ancs_write_count, 0);
+    CHECK_EQ(g_ancs_evt_count, 1);
+
+    ancs_harness_clear();
+    CHECK_EQ(ble_ancs_c_app_attr_request(&m_ancs, (uint8_t const *)"a", 1), NRF_SUCCESS);
+    CHECK_EQ(g_ancs_write_count, 1);
+    CHECK_EQ(g_ancs_evt_count, 0);
+
+    ancs_harness_uninit(&m_ancs);
+}
+
+
+static void test_request_coalescing(void)
+{
+    ble_ancs_c_evt_notif_t other = {.notif_uid = NOTIF_UID + 1};
+
+    ancs_harness_init(&m_ancs, m_attr_lens);
+
+    g_ancs_busy = true;
+    notif_request();
+    notif_request();
+    CHECK_EQ(ble_ancs_c_request_attrs(&m_ancs, &other), NRF_SUCCESS);
+    notif_request();
+
+    g_ancs_busy = false;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        ancs_harness_write_rsp(&m_ancs);
+    }
+    CHECK_EQ(g_ancs_write_count, 2);
+
+    ancs_harness_uninit(&m_ancs);
+}
+
+
+int main(void)
+{
+    test_notif_source();
+    test_notif_attrs_split();
+    test_app_attrs();
+    test_app_cache_eviction();
+    test_request_coalescing();
+
+    return UNIT_TEST_RESULT();
+}
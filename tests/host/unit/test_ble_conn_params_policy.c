@@ -0,0 +1,678 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Connection parameters policy on top of ble_conn_params, against a simulated link.
+ *
+ * @details The test plays the SoftDevice and the central on a timeline in timer ticks. The
+ *          central answers each parameter update request when the test says so: it either takes
+ *          the requested maximum interval and slave latency, or reports the parameters in use
+ *          unchanged. BLE events are passed to ble_conn_params first and to the policy after it,
+ *          as the policy requires.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "nrf_error.h"
+#include "ble.h"
+#include "ble_gap.h"
+#include "app_timer.h"
+#include "ble_conn_params.h"
+#include "ble_conn_params_policy.h"
+
+#define EVAL_TICKS          100
+#define FIRST_UPDATE_DELAY  500
+#define NEXT_UPDATE_DELAY   300
+#define MAX_UPDATE_COUNT    3
+
+#define LOW_MIN_INTERVAL    400                 /**< 500 ms. */
+#define LOW_MAX_INTERVAL    800                 /**< 1000 ms. */
+#define LOW_LATENCY         4
+#define HIGH_MIN_INTERVAL   6                   /**< 7.5 ms. */
+#define HIGH_MAX_INTERVAL   24                  /**< 30 ms. */
+#define SUP_TIMEOUT         600
+
+#define RX_HIGH_BYTES       200
+#define RX_LOW_BYTES        20
+#define TX_HIGH_PACKETS     8
+#define TX_LOW_PACKETS      2
+#define TX_QUEUE_HIGH       4
+#define BULK_HIGH_BYTES     64
+#define IDLE_EVALS          5
+#define RETRY_EVALS         10
+
+#define TIMERS_MAX          4
+
+/**@brief Timer of the simulated app_timer. */
+typedef struct
+{
+    app_timer_id_t              id;
+    app_timer_mode_t            mode;
+    app_timer_timeout_handler_t handler;
+    bool                        running;
+    uint32_t                    interval;
+    uint64_t                    expiry;
+} sim_timer_t;
+
+/**@brief State of the simulated SoftDevice and central. */
+static struct
+{
+    uint16_t              conn_handle;          /**< BLE_CONN_HANDLE_INVALID while there is no link. */
+    ble_gap_conn_params_t current;              /**< Parameters in use on the link. */
+    ble_gap_conn_params_t ppcp;
+    ble_gap_conn_params_t requested;            /**< Last update request. */
+    bool                  update_pending;
+    uint32_t              update_requests;
+    uint32_t              closed_link_requests; /**< Update requests for a link that is gone. */
+} m_sd;
+
+/**@brief What the application saw. */
+static struct
+{
+    uint32_t                          conn_params_evts;     /**< Events of ble_conn_params left to the application. */
+    ble_conn_params_evt_type_t        conn_params_evt;
+    uint32_t                          policy_evts;
+    ble_conn_params_policy_evt_type_t policy_evt;
+    ble_conn_params_policy_mode_t     policy_mode;
+    uint32_t                          errors;
+} m_app;
+
+static sim_timer_t m_timers[TIMERS_MAX];
+static uint32_t    m_timer_count;
+static uint64_t    m_now;
+static uint16_t    m_next_conn_handle;
+
+static ble_gap_conn_params_t const m_low_params =
+{
+    .min_conn_interval = LOW_MIN_INTERVAL,
+    .max_conn_interval = LOW_MAX_INTERVAL,
+    .slave_latency     = LOW_LATENCY,
+    .conn_sup_timeout  = SUP_TIMEOUT
+};
+
+static ble_gap_conn_params_t const m_high_params =
+{
+    .min_conn_interval = HIGH_MIN_INTERVAL,
+    .max_conn_interval = HIGH_MAX_INTERVAL,
+    .slave_latency     = 0,
+    .conn_sup_timeout  = SUP_TIMEOUT
+};
+
+
+static sim_timer_t * timer_find(app_timer_id_t timer_id)
+{
+    for (uint32_t i = 0; i < m_timer_count; i++)
+    {
+        if (m_timers[i].id == timer_id)
+        {
+            return &m_timers[i];
+        }
+    }
+    CHECK(false);
+    return NULL;
+}
+
+
+uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                          app_timer_mode_t            mode,
+                          app_timer_timeout_handler_t timeout_handler)
+{
+    CHECK(m_timer_count < TIMERS_MAX);
+
+    memset(&m_timers[m_timer_count], 0, sizeof(m_timers[0]));
+    m_timers[m_timer_count].id      = *p_timer_id;
+    m_timers[m_timer_count].mode    = mode;
+    m_timers[m_timer_count].handler = timeout_handler;
+    m_timer_count++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    sim_timer_t * p_timer = timer_find(timer_id);
+
+    p_timer->running  = true;
+    p_timer->interval = timeout_ticks;
+    p_timer->expiry   = m_now + timeout_ticks;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_find(timer_id)->running = false;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_ppcp_set(ble_gap_conn_params_t const * p_conn_params)
+{
+    m_sd.ppcp = *p_conn_params;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_ppcp_get(ble_gap_conn_params_t * p_conn_params)
+{
+    *p_conn_params = m_sd.ppcp;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_conn_param_update(uint16_t conn_handle, ble_gap_conn_params_t const * p_conn_params)
+{
+    if ((m_sd.conn_handle == BLE_CONN_HANDLE_INVALID) || (conn_handle != m_sd.conn_handle))
+    {
+        m_sd.closed_link_requests++;
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    m_sd.requested      = *p_conn_params;
+    m_sd.update_pending = true;
+    m_sd.update_requests++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_disconnect(uint16_t conn_handle, uint8_t hci_status_code)
+{
+    CHECK(false);
+    return NRF_SUCCESS;
+}
+
+
+static void error_handler(uint32_t nrf_error)
+{
+    m_app.errors++;
+}
+
+
+static void conn_params_evt_handler(ble_conn_params_evt_t * p_evt)
+{
+    if (ble_conn_params_policy_on_conn_params_evt(p_evt))
+    {
+        return;
+    }
+
+    m_app.conn_params_evts++;
+    m_app.conn_params_evt = p_evt->evt_type;
+}
+
+
+static void policy_evt_handler(ble_conn_params_policy_evt_t * p_evt)
+{
+    m_app.policy_evts++;
+    m_app.policy_evt  = p_evt->evt_type;
+    m_app.policy_mode = p_evt->mode;
+}
+
+
+/**@brief Function for passing a BLE event in the order the policy requires. */
+static void ble_evt_send(ble_evt_t * p_ble_evt)
+{
+    ble_conn_params_on_ble_evt(p_ble_evt);
+    ble_conn_params_policy_on_ble_evt(p_ble_evt);
+}
+
+
+/**@brief Function for running the timers that expire in the next ticks, in order. */
+static void time_advance(uint64_t ticks)
+{
+    uint64_t end = m_now + ticks;
+
+    for (;;)
+    {
+        sim_timer_t * p_next = NULL;
+
+        for (uint32_t i = 0; i < m_timer_count; i++)
+        {
+            if (   m_timers[i].running && (m_timers[i].expiry <= end)
+                && ((p_next == NULL) || (m_timers[i].expiry < p_next->expiry)))
+            {
+                p_next = &m_timers[i];
+            }
+        }
+        if (p_next == NULL)
+        {
+            break;
+        }
+
+        m_now = p_next->expiry;
+        if (p_next->mode == APP_TIMER_MODE_REPEATED)
+        {
+            p_next->expiry += p_next->interval;
+        }
+        else
+        {
+            p_next->running = false;
+        }
+        p_next->handler(NULL);
+    }
+    m_now = end;
+}
+
+
+/**@brief Function for running a number of demand evaluations. */
+static void evals_run(uint32_t count)
+{
+    time_advance((uint64_t)count * EVAL_TICKS);
+}
+
+
+static void link_connect(uint16_t max_conn_interval, uint16_t slave_latency)
+{
+    ble_evt_t evt;
+
+    m_sd.conn_handle                   = ++m_next_conn_handle;
+    m_sd.current                       = m_low_params;
+    m_sd.current.min_conn_interval     = max_conn_interval;
+    m_sd.current.max_conn_interval     = max_conn_interval;
+    m_sd.current.slave_latency         = slave_latency;
+    m_sd.update_pending                = false;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                              = BLE_GAP_EVT_CONNECTED;
+    evt.evt.gap_evt.conn_handle                    = m_sd.conn_handle;
+    evt.evt.gap_evt.params.connected.conn_params   = m_sd.current;
+    ble_evt_send(&evt);
+}
+
+
+static void link_disconnect(void)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id           = BLE_GAP_EVT_DISCONNECTED;
+    evt.evt.gap_evt.conn_handle = m_sd.conn_handle;
+    m_sd.conn_handle            = BLE_CONN_HANDLE_INVALID;
+    m_sd.update_pending         = false;
+    ble_evt_send(&evt);
+}
+
+
+/**@brief Function for letting the central answer the pending update request. */
+static void central_answer(bool accept)
+{
+    ble_evt_t evt;
+
+    CHECK(m_sd.update_pending);
+    m_sd.update_pending = false;
+    if (accept)
+    {
+        m_sd.current.max_conn_interval = m_sd.requested.max_conn_interval;
+        m_sd.current.min_conn_interval = m_sd.requested.max_conn_interval;
+        m_sd.current.slave_latency     = m_sd.requested.slave_latency;
+    }
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                                   = BLE_GAP_EVT_CONN_PARAM_UPDATE;
+    evt.evt.gap_evt.conn_handle                         = m_sd.conn_handle;
+    evt.evt.gap_evt.params.conn_param_update.conn_params = m_sd.current;
+    ble_evt_send(&evt);
+}
+
+
+/**@brief Function for letting the SoftDevice report queued packets as sent. */
+static void tx_complete(uint8_t count)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                           = BLE_EVT_TX_COMPLETE;
+    evt.evt.common_evt.conn_handle              = m_sd.conn_handle;
+    evt.evt.common_evt.params.tx_complete.count = count;
+    ble_evt_send(&evt);
+}
+
+
+/**@brief Function for reporting traffic of the current evaluation interval. */
+static void traffic(uint16_t rx_bytes, uint8_t tx_packets)
+{
+    ble_evt_t evt;
+
+    if (rx_bytes > 0)
+    {
+        memset(&evt, 0, sizeof(evt));
+        evt.header.evt_id                  = BLE_GATTS_EVT_WRITE;
+        evt.evt.gatts_evt.conn_handle      = m_sd.conn_handle;
+        evt.evt.gatts_evt.params.write.len = rx_bytes;
+        ble_evt_send(&evt);
+    }
+    if (tx_packets > 0)
+    {
+        ble_conn_params_policy_tx_queued(tx_packets);
+        tx_complete(tx_packets);
+    }
+}
+
+
+/**@brief Function for running evaluations with the same traffic in each. */
+static void traffic_evals_run(uint32_t count, uint16_t rx_bytes, uint8_t tx_packets)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        traffic(rx_bytes, tx_packets);
+        evals_run(1);
+    }
+}
+
+
+static void setup(void)
+{
+    ble_conn_params_init_t        cp_init;
+    ble_conn_params_policy_init_t policy_init;
+
+    memset(&m_sd, 0, sizeof(m_sd));
+    memset(&m_app, 0, sizeof(m_app));
+    m_sd.conn_handle = BLE_CONN_HANDLE_INVALID;
+    m_timer_count    = 0;
+    m_now            = 0;
+
+    memset(&cp_init, 0, sizeof(cp_init));
+    cp_init.p_conn_params                  = (ble_gap_conn_params_t *)&m_low_params;
+    cp_init.first_conn_params_update_delay = FIRST_UPDATE_DELAY;
+    cp_init.next_conn_params_update_delay  = NEXT_UPDATE_DELAY;
+    cp_init.max_conn_params_update_count   = MAX_UPDATE_COUNT;
+    cp_init.start_on_notify_cccd_handle    = BLE_GATT_HANDLE_INVALID;
+    cp_init.disconnect_on_fail             = false;
+    cp_init.evt_handler                    = conn_params_evt_handler;
+    cp_init.error_handler                  = error_handler;
+    CHECK_EQ(ble_conn_params_init(&cp_init), NRF_SUCCESS);
+
+    memset(&policy_init, 0, sizeof(policy_init));
+    policy_init.low_power_params       = m_low_params;
+    policy_init.high_throughput_params = m_high_params;
+    policy_init.eval_interval          = EVAL_TICKS;
+    policy_init.rx_high_bytes          = RX_HIGH_BYTES;
+    policy_init.rx_low_bytes           = RX_LOW_BYTES;
+    policy_init.tx_high_packets        = TX_HIGH_PACKETS;
+    policy_init.tx_low_packets         = TX_LOW_PACKETS;
+    policy_init.tx_queue_high          = TX_QUEUE_HIGH;
+    policy_init.bulk_high_bytes        = BULK_HIGH_BYTES;
+    policy_init.idle_evals             = IDLE_EVALS;
+    policy_init.retry_evals            = RETRY_EVALS;
+    policy_init.evt_handler            = policy_evt_handler;
+    policy_init.error_handler          = error_handler;
+    CHECK_EQ(ble_conn_params_policy_init(&policy_init), NRF_SUCCESS);
+}
+
+
+/**@brief Function for connecting with acceptable parameters and going to high throughput. */
+static void high_throughput_enter(void)
+{
+    link_connect(LOW_MAX_INTERVAL, LOW_LATENCY);
+    ble_conn_params_policy_bulk_pending_set(BULK_HIGH_BYTES);
+    central_answer(true);
+    CHECK_EQ(ble_conn_params_policy_mode_get(), BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT);
+}
+
+
+static void test_init_params(void)
+{
+    ble_conn_params_policy_init_t policy_init;
+
+    CHECK_EQ(ble_conn_params_policy_init(NULL), NRF_ERROR_NULL);
+
+    memset(&policy_init, 0, sizeof(policy_init));
+    policy_init.eval_interval   = EVAL_TICKS;
+    policy_init.rx_low_bytes    = RX_HIGH_BYTES;
+    policy_init.rx_high_bytes   = RX_HIGH_BYTES;
+    policy_init.tx_low_packets  = TX_LOW_PACKETS;
+    policy_init.tx_high_packets = TX_HIGH_PACKETS;
+    policy_init.tx_queue_high   = TX_QUEUE_HIGH;
+    policy_init.bulk_high_bytes = BULK_HIGH_BYTES;
+    CHECK_EQ(ble_conn_params_policy_init(&policy_init), NRF_ERROR_INVALID_PARAM);
+
+    policy_init.rx_low_bytes  = RX_LOW_BYTES;
+    policy_init.eval_interval = 0;
+    CHECK_EQ(ble_conn_params_policy_init(&policy_init), NRF_ERROR_INVALID_PARAM);
+}
+
+
+static void test_initial_negotiation(void)
+{
+    // Acceptable parameters on connection: the outcome goes to the application.
+    setup();
+    link_connect(LOW_MAX_INTERVAL, LOW_LATENCY);
+    CHECK_EQ(m_app.conn_params_evts, 1);
+    CHECK_EQ(m_app.conn_params_evt, BLE_CONN_PARAMS_EVT_SUCCEEDED);
+    link_disconnect();
+
+    // The central connects fast. Demand is high, but the policy waits for the negotiation of
+    // ble_conn_params to end.
+    setup();
+    link_connect(HIGH_MAX_INTERVAL, 0);
+    ble_conn_params_policy_tx_queued(TX_QUEUE_HIGH);
+    evals_run(FIRST_UPDATE_DELAY / EVAL_TICKS - 1);
+    CHECK_EQ(m_sd.update_requests, 0);
+    evals_run(1);
+    CHECK_EQ(m_sd.update_requests, 1);
+    CHECK_EQ(m_sd.requested.max_conn_interval, LOW_MAX_INTERVAL);
+    central_answer(true);
+    CHECK_EQ(m_app.conn_params_evts, 1);
+    CHECK_EQ(m_app.conn_params_evt, BLE_CONN_PARAMS_EVT_SUCCEEDED);
+    CHECK_EQ(m_app.policy_evts, 0);
+
+    // The next evaluation asks for the fast parameters, its outcome stays with the policy.
+    evals_run(1);
+    CHECK_EQ(m_sd.update_requests, 2);
+    CHECK_EQ(m_sd.requested.max_conn_interval, HIGH_MAX_INTERVAL);
+    CHECK_EQ(m_sd.requested.slave_latency, 0);
+    central_answer(true);
+    CHECK_EQ(m_app.conn_params_evts, 1);
+    CHECK_EQ(m_app.policy_evts, 1);
+    CHECK_EQ(m_app.policy_evt, BLE_CONN_PARAMS_POLICY_EVT_MODE_CHANGED);
+    CHECK_EQ(m_app.policy_mode, BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT);
+    CHECK_EQ(m_app.errors, 0);
+}
+
+
+static void test_hysteresis(void)
+{
+    ble_conn_params_policy_stats_t stats;
+
+    setup();
+    link_connect(LOW_MAX_INTERVAL, LOW_LATENCY);
+
+    // Traffic between the thresholds does not leave low power mode.
+    traffic_evals_run(20, RX_LOW_BYTES + 1, TX_LOW_PACKETS + 1);
+    CHECK_EQ(m_sd.update_requests, 0);
+
+    // Reaching a high threshold does.
+    traffic_evals_run(1, RX_HIGH_BYTES, 0);
+    CHECK_EQ(m_sd.update_requests, 1);
+    central_answer(true);
+    CHECK_EQ(ble_conn_params_policy_mode_get(), BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT);
+
+    traffic_evals_run(1, 0, TX_HIGH_PACKETS);
+
+    // Traffic between the thresholds keeps high throughput mode, and so do idle evaluations
+    // short of the count.
+    traffic_evals_run(20, RX_HIGH_BYTES - 1, TX_HIGH_PACKETS - 1);
+    traffic_evals_run(IDLE_EVALS - 1, RX_LOW_BYTES, TX_LOW_PACKETS);
+    traffic_evals_run(1, RX_LOW_BYTES + 1, 0);
+    traffic_evals_run(IDLE_EVALS - 1, 0, 0);
+    CHECK_EQ(m_sd.update_requests, 1);
+
+    // The idle count is complete.
+    traffic_evals_run(1, 0, 0);
+    CHECK_EQ(m_sd.update_requests, 2);
+    CHECK_EQ(m_sd.requested.max_conn_interval, LOW_MAX_INTERVAL);
+    CHECK_EQ(m_sd.requested.slave_latency, LOW_LATENCY);
+    central_answer(true);
+    CHECK_EQ(ble_conn_params_policy_mode_get(), BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER);
+    CHECK_EQ(m_app.policy_evts, 2);
+    CHECK_EQ(m_app.conn_params_evts, 1);
+
+    ble_conn_params_policy_stats_get(&stats);
+    CHECK_EQ(stats.requests, 2);
+    CHECK_EQ(stats.rejected, 0);
+    CHECK_EQ(stats.low_power_evals, 21);
+    CHECK_EQ(stats.high_throughput_evals, 1 + 20 + 2 * IDLE_EVALS);
+    CHECK_EQ(stats.rx_bytes, 20 * (RX_LOW_BYTES + 1) + RX_HIGH_BYTES + 20 * (RX_HIGH_BYTES - 1) +
+                             (IDLE_EVALS - 1) * RX_LOW_BYTES + RX_LOW_BYTES + 1);
+    CHECK_EQ(stats.tx_packets, 20 * (TX_LOW_PACKETS + 1) + TX_HIGH_PACKETS +
+                               20 * (TX_HIGH_PACKETS - 1) + (IDLE_EVALS - 1) * TX_LOW_PACKETS);
+    CHECK_EQ(stats.conn_interval, LOW_MAX_INTERVAL);
+    CHECK_EQ(stats.slave_latency, LOW_LATENCY);
+    CHECK_EQ(m_app.errors, 0);
+}
+
+
+static void test_tx_queue(void)
+{
+    setup();
+    link_connect(LOW_MAX_INTERVAL, LOW_LATENCY);
+
+    // Queued packets count until the SoftDevice reports them sent.
+    ble_conn_params_policy_tx_queued(TX_QUEUE_HIGH - 1);
+    evals_run(3);
+    CHECK_EQ(m_sd.update_requests, 0);
+    ble_conn_params_policy_tx_queued(1);
+    evals_run(1);
+    CHECK_EQ(m_sd.update_requests, 1);
+    central_answer(true);
+
+    // A queued packet keeps the demand above low.
+    tx_complete(TX_QUEUE_HIGH - 1);
+    evals_run(IDLE_EVALS * 3);
+    CHECK_EQ(m_sd.update_requests, 1);
+
+    tx_complete(1);
+    evals_run(IDLE_EVALS);
+    CHECK_EQ(m_sd.update_requests, 2);
+    central_answer(true);
+    CHECK_EQ(ble_conn_params_policy_mode_get(), BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER);
+}
+
+
+static void test_bulk_pending(void)
+{
+    setup();
+    link_connect(LOW_MAX_INTERVAL, LOW_LATENCY);
+
+    // Below the threshold, the bulk bytes wait for the evaluation and only keep the demand up.
+    ble_conn_params_policy_bulk_pending_set(BULK_HIGH_BYTES - 1);
+    evals_run(5);
+    CHECK_EQ(m_sd.update_requests, 0);
+
+    // Reaching it requests the fast parameters at once.
+    ble_conn_params_policy_bulk_pending_set(BULK_HIGH_BYTES);
+    CHECK_EQ(m_sd.update_requests, 1);
+    CHECK_EQ(m_sd.requested.max_conn_interval, HIGH_MAX_INTERVAL);
+    central_answer(true);
+
+    // The end of the transfer is seen after the idle evaluations.
+    ble_conn_params_policy_bulk_pending_set(1);
+    evals_run(IDLE_EVALS * 3);
+    CHECK_EQ(m_sd.update_requests, 1);
+    ble_conn_params_policy_bulk_pending_set(0);
+    evals_run(IDLE_EVALS - 1);
+    CHECK_EQ(m_sd.update_requests, 1);
+    evals_run(1);
+    CHECK_EQ(m_sd.update_requests, 2);
+    CHECK_EQ(m_sd.requested.max_conn_interval, LOW_MAX_INTERVAL);
+    central_answer(true);
+    CHECK_EQ(m_app.errors, 0);
+}
+
+
+static void test_rejection(void)
+{
+    ble_conn_params_policy_stats_t stats;
+
+    setup();
+    link_connect(LOW_MAX_INTERVAL, LOW_LATENCY);
+
+    // The central keeps its parameters, the failure goes to the policy and not to the
+    // application.
+    ble_conn_params_policy_tx_queued(TX_QUEUE_HIGH);
+    evals_run(1);
+    CHECK_EQ(m_sd.update_requests, 1);
+    central_answer(false);
+    CHECK_EQ(m_app.policy_evts, 1);
+    CHECK_EQ(m_app.policy_evt, BLE_CONN_PARAMS_POLICY_EVT_REQUEST_REJECTED);
+    CHECK_EQ(m_app.policy_mode, BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER);
+    CHECK_EQ(m_app.conn_params_evts, 1);
+
+    // The request is made again after the back-off, also when the bulk bytes ask for it.
+    evals_run(RETRY_EVALS - 1);
+    ble_conn_params_policy_bulk_pending_set(BULK_HIGH_BYTES);
+    CHECK_EQ(m_sd.update_requests, 1);
+    evals_run(1);
+    CHECK_EQ(m_sd.update_requests, 2);
+    central_answer(true);
+    CHECK_EQ(ble_conn_params_policy_mode_get(), BLE_CONN_PARAMS_POLICY_MODE_HIGH_THROUGHPUT);
+
+    ble_conn_params_policy_stats_get(&stats);
+    CHECK_EQ(stats.requests, 2);
+    CHECK_EQ(stats.rejected, 1);
+    CHECK_EQ(stats.conn_interval, HIGH_MAX_INTERVAL);
+    CHECK_EQ(stats.slave_latency, 0);
+    CHECK_EQ(m_app.errors, 0);
+}
+
+
+static void test_disconnect(void)
+{
+    setup();
+    high_throughput_enter();
+
+    // The low power parameters are preferred again, without a request on the closed link.
+    link_disconnect();
+    CHECK_EQ(m_sd.ppcp.min_conn_interval, LOW_MIN_INTERVAL);
+    CHECK_EQ(m_sd.ppcp.max_conn_interval, LOW_MAX_INTERVAL);
+    CHECK_EQ(m_sd.ppcp.slave_latency, LOW_LATENCY);
+    CHECK_EQ(m_sd.closed_link_requests, 0);
+    CHECK_EQ(ble_conn_params_policy_mode_get(), BLE_CONN_PARAMS_POLICY_MODE_LOW_POWER);
+
+    // Evaluations stop with the link.
+    evals_run(IDLE_EVALS * 3);
+    CHECK_EQ(m_sd.update_requests, 1);
+
+    // The next connection negotiates as usual, and the bulk bytes of the previous one are gone.
+    link_connect(LOW_MAX_INTERVAL, LOW_LATENCY);
+    CHECK_EQ(m_app.conn_params_evts, 2);
+    CHECK_EQ(m_app.conn_params_evt, BLE_CONN_PARAMS_EVT_SUCCEEDED);
+    evals_run(IDLE_EVALS * 3);
+    CHECK_EQ(m_sd.update_requests, 1);
+
+    // A fast connection on the low power preference is brought back to it by ble_conn_params.
+    link_disconnect();
+    link_connect(HIGH_MAX_INTERVAL, 0);
+    time_advance(FIRST_UPDATE_DELAY);
+    CHECK_EQ(m_sd.update_requests, 2);
+    CHECK_EQ(m_sd.requested.max_conn_interval, LOW_MAX_INTERVAL);
+    central_answer(true);
+    CHECK_EQ(m_app.conn_params_evts, 3);
+    CHECK_EQ(m_app.conn_params_evt, BLE_CONN_PARAMS_EVT_SUCCEEDED);
+    CHECK_EQ(m_app.errors, 0);
+}
+
+
+int main(void)
+{
+    test_init_params();
+    test_initial_negotiation();
+    test_hysteresis();
+    test_tx_queue();
+    test_bulk_pending();
+    test_rejection();
+    test_disconnect();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,383 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief GATT attribute tables built by ble_gatt_table on the SoftDevice emulator.
+ *
+ * @details The data sync Service table is checked against the characteristic-by-characteristic
+ *          initialization it replaced, kept below as the reference: both are run on an empty
+ *          emulator, and the resulting attribute tables must match attribute by attribute, with
+ *          the same handles given back to the service. The table validation is then driven
+ *          through each of its error paths.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "unit_test.h"
+#include "nrf_error.h"
+#include "sd_sim.h"
+#include "sd_sim_internal.h"
+#include "ble_gatt_table.h"
+#include "ble_data_sync.h"
+
+#define REVISION        0x0102
+
+/**@brief Attribute table snapshot, with copies of the values. */
+typedef struct
+{
+    sd_sim_attr_t attrs[SD_SIM_ATTR_MAX];
+    uint8_t       values[SD_SIM_ATTR_MAX][BLE_DATA_SYNC_DIAG_MAX_LEN];
+    uint16_t      count;
+} table_snapshot_t;
+
+/**@brief Context of the table of the validation tests. */
+typedef struct
+{
+    uint16_t                 service_handle;
+    ble_gatts_char_handles_t char_handles;
+    uint16_t                 desc_handle;
+    uint8_t                  value[4];
+} context_t;
+
+static table_snapshot_t m_reference;
+static table_snapshot_t m_table;
+
+
+static void evt_pump(void)
+{
+}
+
+
+static void snapshot_take(table_snapshot_t * p_snapshot)
+{
+    memset(p_snapshot, 0, sizeof(*p_snapshot));
+    p_snapshot->count = g_sd_sim.attr_count;
+    for (uint16_t i = 0; i < g_sd_sim.attr_count; i++)
+    {
+        sd_sim_attr_t const * p_attr = &g_sd_sim.attrs[i];
+
+        p_snapshot->attrs[i] = *p_attr;
+        if ((p_attr->p_value != NULL) && (p_attr->len <= BLE_DATA_SYNC_DIAG_MAX_LEN))
+        {
+            memcpy(p_snapshot->values[i], p_attr->p_value, p_attr->len);
+        }
+    }
+}
+
+
+static bool sec_mode_equal(ble_gap_conn_sec_mode_t a, ble_gap_conn_sec_mode_t b)
+{
+    return (a.sm == b.sm) && (a.lv == b.lv);
+}
+
+
+/**@brief Function for adding the data sync Service as it was added before the table: one
+ *        characteristic at a time, with the SoftDevice default CCCD of the Control Point.
+ */
+static uint32_t reference_init(ble_data_sync_t * p_data, uint16_t revision)
+{
+    uint32_t            err_code;
+    ble_uuid_t          uuid;
+    ble_uuid128_t       base_uuid = VSTEAM_BLE_BASE_UUID;
+    ble_gatts_char_md_t char_md;
+    ble_gatts_attr_md_t attr_md;
+    ble_gatts_attr_t    attr_char_value;
+
+    err_code = sd_ble_uuid_vs_add(&base_uuid, &uuid.type);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+    p_data->uuid_type = uuid.type;
+
+    uuid.uuid = BLE_DATA_SYNC_SERVICE_UUID;
+    err_code  = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &uuid, &p_data->service_handle);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Revision characteristic.
+    uuid.uuid = BLE_DATA_SYNC_REV_CHAR_UUID;
+    memset(&char_md, 0, sizeof(char_md));
+    char_md.char_props.read = 1;
+    memset(&attr_md, 0, sizeof(attr_md));
+    attr_md.vloc = BLE_GATTS_VLOC_STACK;
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.write_perm);
+    memset(&attr_char_value, 0, sizeof(attr_char_value));
+    attr_char_value.p_uuid    = &uuid;
+    attr_char_value.p_attr_md = &attr_md;
+    attr_char_value.max_len   = sizeof(uint16_t);
+    attr_char_value.init_len  = sizeof(uint16_t);
+    attr_char_value.p_value   = (uint8_t *)&revision;
+    err_code = sd_ble_gatts_characteristic_add(p_data->service_handle, &char_md, &attr_char_value,
+                                               &p_data->data_sync_rev_handles);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Control Point characteristic.
+    uuid.uuid = BLE_DATA_SYNC_CTRL_PT_UUID;
+    memset(&char_md, 0, sizeof(char_md));
+    char_md.char_props.write  = 1;
+    char_md.char_props.notify = 1;
+    memset(&attr_md, 0, sizeof(attr_md));
+    attr_md.vloc = BLE_GATTS_VLOC_STACK;
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.write_perm);
+    memset(&attr_char_value, 0, sizeof(attr_char_value));
+    attr_char_value.p_uuid    = &uuid;
+    attr_char_value.p_attr_md = &attr_md;
+    attr_char_value.max_len   = BLE_L2CAP_MTU_DEF;
+    return sd_ble_gatts_characteristic_add(p_data->service_handle, &char_md, &attr_char_value,
+                                           &p_data->data_sync_ctrl_pt_handles);
+}
+
+
+static void attr_check(uint16_t handle)
+{
+    sd_sim_attr_t const * p_ref   = &m_reference.attrs[handle - 1];
+    sd_sim_attr_t const * p_attr  = &m_table.attrs[handle - 1];
+
+    CHECK_EQ(p_attr->type, p_ref->type);
+    CHECK_EQ(p_attr->uuid.uuid, p_ref->uuid.uuid);
+    CHECK_EQ(p_attr->uuid.type, p_ref->uuid.type);
+    CHECK(memcmp(&p_attr->props, &p_ref->props, sizeof(p_ref->props)) == 0);
+    CHECK(sec_mode_equal(p_attr->md.read_perm, p_ref->md.read_perm));
+    CHECK(sec_mode_equal(p_attr->md.write_perm, p_ref->md.write_perm));
+    CHECK_EQ(p_attr->md.vloc, p_ref->md.vloc);
+    CHECK_EQ(p_attr->md.vlen, p_ref->md.vlen);
+    CHECK_EQ(p_attr->md.rd_auth, p_ref->md.rd_auth);
+    CHECK_EQ(p_attr->md.wr_auth, p_ref->md.wr_auth);
+    CHECK_EQ(p_attr->max_len, p_ref->max_len);
+    CHECK_EQ(p_attr->len, p_ref->len);
+    CHECK(memcmp(m_table.values[handle - 1], m_reference.values[handle - 1], p_ref->len) == 0);
+}
+
+
+static void test_data_sync_table(void)
+{
+    ble_data_sync_t      reference;
+    ble_data_sync_t      data_sync;
+    ble_data_sync_init_t init;
+    uint16_t             handle;
+
+    sd_sim_init(NULL, evt_pump);
+    memset(&reference, 0, sizeof(reference));
+    CHECK_EQ(reference_init(&reference, REVISION), NRF_SUCCESS);
+    snapshot_take(&m_reference);
+
+    sd_sim_init(NULL, evt_pump);
+    memset(&data_sync, 0, sizeof(data_sync));
+    memset(&init, 0, sizeof(init));
+    init.revision = REVISION;
+    CHECK_EQ(ble_data_sync_init(&data_sync, &init), NRF_SUCCESS);
+    snapshot_take(&m_table);
+
+    // The attributes of the hand-written initialization come first, unchanged.
+    CHECK(m_table.count > m_reference.count);
+    for (handle = 1; handle <= m_reference.count; handle++)
+    {
+        attr_check(handle);
+    }
+
+    CHECK_EQ(data_sync.uuid_type, reference.uuid_type);
+    CHECK_EQ(data_sync.service_handle, reference.service_handle);
+    CHECK(memcmp(&data_sync.data_sync_rev_handles, &reference.data_sync_rev_handles,
+                 sizeof(ble_gatts_char_handles_t)) == 0);
+    CHECK(memcmp(&data_sync.data_sync_ctrl_pt_handles, &reference.data_sync_ctrl_pt_handles,
+                 sizeof(ble_gatts_char_handles_t)) == 0);
+
+    // Spelled out: the Revision is read only, without CCCD, and holds the revision.
+    handle = data_sync.data_sync_rev_handles.value_handle;
+    CHECK_EQ(handle, sd_sim_value_handle_find(BLE_DATA_SYNC_REV_CHAR_UUID));
+    CHECK_EQ(data_sync.data_sync_rev_handles.cccd_handle, BLE_GATT_HANDLE_INVALID);
+    CHECK(m_table.attrs[handle - 1].props.read);
+    CHECK(!m_table.attrs[handle - 1].props.write);
+    CHECK(!m_table.attrs[handle - 1].props.notify);
+    CHECK_EQ(m_table.attrs[handle - 1].md.read_perm.lv, 1);
+    CHECK_EQ(m_table.attrs[handle - 1].md.write_perm.lv, 0);
+    CHECK_EQ(uint16_decode(m_table.values[handle - 1]), REVISION);
+
+    // The Control Point is written and notifies, its CCCD is open like the SoftDevice default.
+    handle = data_sync.data_sync_ctrl_pt_handles.value_handle;
+    CHECK(m_table.attrs[handle - 1].props.write);
+    CHECK(m_table.attrs[handle - 1].props.notify);
+    CHECK(!m_table.attrs[handle - 1].props.read);
+    CHECK_EQ(m_table.attrs[handle - 1].md.read_perm.lv, 0);
+    CHECK_EQ(m_table.attrs[handle - 1].max_len, BLE_L2CAP_MTU_DEF);
+    CHECK_EQ(data_sync.data_sync_ctrl_pt_handles.cccd_handle, handle + 1);
+    CHECK_EQ(data_sync.data_sync_ctrl_pt_handles.cccd_handle,
+             sd_sim_cccd_handle_find(BLE_DATA_SYNC_CTRL_PT_UUID));
+    handle = data_sync.data_sync_ctrl_pt_handles.cccd_handle;
+    CHECK_EQ(m_table.attrs[handle - 1].uuid.uuid, BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG);
+    CHECK_EQ(m_table.attrs[handle - 1].md.read_perm.lv, 1);
+    CHECK_EQ(m_table.attrs[handle - 1].md.write_perm.lv, 1);
+    CHECK_EQ(m_table.attrs[handle - 1].md.vloc, BLE_GATTS_VLOC_STACK);
+
+    // The Diagnostics characteristic came with the table: a variable length read, authorized.
+    handle = data_sync.data_sync_diag_handles.value_handle;
+    CHECK_EQ(handle, m_reference.count + 2);
+    CHECK_EQ(m_table.count, handle);
+    CHECK_EQ(m_table.attrs[handle - 1].uuid.uuid, BLE_DATA_SYNC_DIAG_CHAR_UUID);
+    CHECK_EQ(m_table.attrs[handle - 1].uuid.type, data_sync.uuid_type);
+    CHECK(m_table.attrs[handle - 1].props.read);
+    CHECK(!m_table.attrs[handle - 1].props.notify);
+    CHECK_EQ(m_table.attrs[handle - 1].md.read_perm.lv, 1);
+    CHECK_EQ(m_table.attrs[handle - 1].md.write_perm.lv, 0);
+    CHECK_EQ(m_table.attrs[handle - 1].md.vlen, 1);
+    CHECK_EQ(m_table.attrs[handle - 1].md.rd_auth, 1);
+    CHECK_EQ(m_table.attrs[handle - 1].max_len, BLE_DATA_SYNC_DIAG_MAX_LEN);
+    CHECK_EQ(m_table.attrs[handle - 1].len, 0);
+    CHECK_EQ(data_sync.data_sync_diag_handles.cccd_handle, BLE_GATT_HANDLE_INVALID);
+}
+
+
+/**@brief Function for checking that a table is rejected, and that nothing of it is added. */
+static void invalid_check(ble_gatt_table_entry_t const * p_table, uint32_t count, size_t context_size)
+{
+    context_t context;
+
+    CHECK_EQ(ble_gatt_table_validate(p_table, count, context_size), NRF_ERROR_INVALID_PARAM);
+
+    sd_sim_init(NULL, evt_pump);
+    CHECK_EQ(ble_gatt_table_add(p_table, count, BLE_UUID_TYPE_BLE,
+                                (context_size != 0) ? &context : NULL, context_size),
+             NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(g_sd_sim.attr_count, 0);
+}
+
+
+static void test_validate(void)
+{
+    static uint8_t const init[2] = {1, 2};
+
+    ble_gatt_table_entry_t table[3];
+    ble_gatt_table_entry_t const service =
+        BLE_GATT_TABLE_SERVICE(0x1800, 0, offsetof(context_t, service_handle));
+    ble_gatt_table_entry_t const characteristic =
+        BLE_GATT_TABLE_CHAR_INIT(0x2A00, 0, BLE_GATT_TABLE_PROP_READ,
+                                 SEC_OPEN, SEC_NO_ACCESS, SEC_NO_ACCESS, 4, init, sizeof(init),
+                                 offsetof(context_t, char_handles));
+    ble_gatt_table_entry_t const descriptor =
+        BLE_GATT_TABLE_DESC(0x2901, 0, SEC_OPEN, SEC_NO_ACCESS, 2, init, sizeof(init),
+                            offsetof(context_t, desc_handle));
+    context_t context;
+
+    // A valid table, added with its handles written to the context.
+    table[0] = service;
+    table[1] = characteristic;
+    table[2] = descriptor;
+    CHECK_EQ(ble_gatt_table_validate(table, 3, sizeof(context_t)), NRF_SUCCESS);
+    CHECK_EQ(ble_gatt_table_validate(table, 0, 0), NRF_SUCCESS);
+    sd_sim_init(NULL, evt_pump);
+    memset(&context, 0, sizeof(context));
+    CHECK_EQ(ble_gatt_table_add(table, 3, BLE_UUID_TYPE_BLE, &context, sizeof(context)), NRF_SUCCESS);
+    CHECK_EQ(context.service_handle, 1);
+    CHECK_EQ(context.char_handles.value_handle, 3);
+    CHECK_EQ(context.desc_handle, 4);
+    CHECK_EQ(g_sd_sim.attr_count, 4);
+
+    CHECK_EQ(ble_gatt_table_validate(NULL, 1, 0), NRF_ERROR_NULL);
+    CHECK_EQ(ble_gatt_table_add(NULL, 1, BLE_UUID_TYPE_BLE, NULL, 0), NRF_ERROR_NULL);
+
+    // Characteristic without a service, descriptor without a characteristic.
+    invalid_check(&characteristic, 1, sizeof(context_t));
+    table[0] = service;
+    table[1] = descriptor;
+    invalid_check(table, 2, sizeof(context_t));
+
+    // A new service ends the characteristic the descriptors go to.
+    table[0] = service;
+    table[1] = characteristic;
+    table[2] = service;
+    table[2].handle_offset = BLE_GATT_TABLE_NO_HANDLE;
+    CHECK_EQ(ble_gatt_table_validate(table, 3, sizeof(context_t)), NRF_SUCCESS);
+    table[0] = table[2];
+    table[1] = descriptor;
+    invalid_check(table, 2, sizeof(context_t));
+
+    // Unknown entry type.
+    table[0]      = service;
+    table[1]      = characteristic;
+    table[1].type = BLE_GATT_TABLE_TYPE_DESC + 1;
+    invalid_check(table, 2, sizeof(context_t));
+
+    // Handles outside the context, or with no context at all.
+    table[0] = service;
+    invalid_check(table, 1, 0);
+    table[0].handle_offset = sizeof(context_t) - 1;
+    invalid_check(table, 1, sizeof(context_t));
+    table[0] = service;
+    table[1] = characteristic;
+    table[1].handle_offset = sizeof(context_t) - sizeof(ble_gatts_char_handles_t) + 1;
+    invalid_check(table, 2, sizeof(context_t));
+    table[1] = characteristic;
+    table[2] = descriptor;
+    table[2].handle_offset = sizeof(context_t) - 1;
+    invalid_check(table, 3, sizeof(context_t));
+
+    // Initial value longer than the value, which the macros catch at compile time.
+    table[1]          = characteristic;
+    table[1].init_len = table[1].max_len + 1;
+    invalid_check(table, 2, sizeof(context_t));
+    table[1] = characteristic;
+    table[2] = descriptor;
+    table[2].init_len = table[2].max_len + 1;
+    invalid_check(table, 3, sizeof(context_t));
+
+    // Initial value in the context, outside of it.
+    {
+        ble_gatt_table_entry_t const context_char =
+            BLE_GATT_TABLE_CHAR_INIT_CONTEXT(0x2A00, 0, BLE_GATT_TABLE_PROP_READ,
+                                             SEC_OPEN, SEC_NO_ACCESS, SEC_NO_ACCESS, 4,
+                                             offsetof(context_t, value), 4,
+                                             offsetof(context_t, char_handles));
+
+        table[1] = context_char;
+        CHECK_EQ(ble_gatt_table_validate(table, 2, sizeof(context_t)), NRF_SUCCESS);
+        table[1].init_offset = sizeof(context_t) - 3;
+        invalid_check(table, 2, sizeof(context_t));
+
+        // A user located value must be in the context, with room for the maximum length.
+        table[1]        = context_char;
+        table[1].flags |= BLE_GATT_TABLE_FLAG_VLOC_USER;
+        CHECK_EQ(ble_gatt_table_validate(table, 2, sizeof(context_t)), NRF_SUCCESS);
+        table[1].max_len = sizeof(context_t) - offsetof(context_t, value) + 1;
+        invalid_check(table, 2, sizeof(context_t));
+        table[1]        = characteristic;
+        table[1].flags |= BLE_GATT_TABLE_FLAG_VLOC_USER;
+        invalid_check(table, 2, sizeof(context_t));
+    }
+
+    // Handles that are not kept need no context.
+    table[0] = service;
+    table[1] = characteristic;
+    table[0].handle_offset = BLE_GATT_TABLE_NO_HANDLE;
+    table[1].handle_offset = BLE_GATT_TABLE_NO_HANDLE;
+    CHECK_EQ(ble_gatt_table_validate(table, 2, 0), NRF_SUCCESS);
+    sd_sim_init(NULL, evt_pump);
+    CHECK_EQ(ble_gatt_table_add(table, 2, BLE_UUID_TYPE_BLE, NULL, 0), NRF_SUCCESS);
+    CHECK_EQ(g_sd_sim.attr_count, 3);
+}
+
+
+int main(void)
+{
+    test_data_sync_table();
+    test_validate();
+
+    return UNIT_TEST_RESULT();
+}
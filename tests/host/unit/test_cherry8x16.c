@@ -0,0 +1,351 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Batched key changes of the cherry8x16 driver, with ghosting and bouncing keys.
+ *
+ * @details The matrix has no diodes. Driving a column reads every row connected to it through
+ *          pressed keys, also through other columns, so three keys on the corners of a rectangle
+ *          make the fourth one appear. The test computes the snapshots such a matrix gives and
+ *          passes them to cherry8x16_key_changes_get(), as a peripheral scanning the matrix would.
+ *
+ *          A ghost always completes a rectangle of keys in the snapshot, and four keys really
+ *          pressed on the corners of a rectangle read the same as three of them. The driver must
+ *          ignore every snapshot holding a rectangle, and report the others, which hold exactly
+ *          the keys pressed.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "host_util.h"
+#include "cherry8x16.h"
+
+#define COLUMNS         16
+#define ROWS            8
+#define KEYS            (COLUMNS * ROWS)
+#define BOUNCE_SCANS    5           /**< Scans during which a changing key reads at random. */
+#define RANDOM_SCANS    200000
+
+static uint8_t          m_lookup[KEYS];
+static volatile uint8_t m_row_port;
+static uint16_t         m_column_port;
+
+static uint8_t m_pressed[COLUMNS];      /**< Keys really pressed, row bits per column. */
+static uint8_t m_reported[COLUMNS];     /**< State built from the reported changes. */
+
+
+/**@brief Function for computing the snapshot of the diode-less matrix. */
+static void snapshot_compute(uint8_t const * p_pressed, uint8_t * p_snapshot)
+{
+    for (uint32_t column = 0; column < COLUMNS; column++)
+    {
+        uint32_t columns = 1UL << column;
+        uint32_t rows    = 0;
+        uint32_t prev;
+
+        // Rows and columns connected through pressed keys, until nothing is added.
+        do
+        {
+            prev = columns;
+            for (uint32_t c = 0; c < COLUMNS; c++)
+            {
+                if (columns & (1UL << c))
+                {
+                    rows |= p_pressed[c];
+                }
+            }
+            for (uint32_t c = 0; c < COLUMNS; c++)
+            {
+                if (p_pressed[c] & rows)
+                {
+                    columns |= 1UL << c;
+                }
+            }
+        } while (columns != prev);
+
+        p_snapshot[column] = (uint8_t)rows;
+    }
+}
+
+
+/**@brief Function for finding two columns sharing two rows in a snapshot. */
+static bool rectangle_find(uint8_t const * p_snapshot)
+{
+    for (uint32_t a = 0; a < COLUMNS; a++)
+    {
+        for (uint32_t b = a + 1; b < COLUMNS; b++)
+        {
+            uint32_t shared = p_snapshot[a] & p_snapshot[b];
+
+            if ((shared & (shared - 1)) != 0)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for getting the changes of a snapshot and applying them to m_reported.
+ *
+ * @return  Number of changes.
+ */
+static uint32_t changes_apply(uint8_t const * p_snapshot, uint8_t max_changes)
+{
+    cherry8x16_key_change_t changes[KEYS];
+    uint8_t                 count;
+
+    count = cherry8x16_key_changes_get(p_snapshot, changes, max_changes);
+    CHECK(count <= max_changes);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t column = changes[i].key_index / ROWS;
+        uint8_t  mask   = (uint8_t)(1U << (changes[i].key_index % ROWS));
+
+        CHECK_EQ(changes[i].keycode, m_lookup[changes[i].key_index]);
+        CHECK_EQ(changes[i].pressed, (m_reported[column] & mask) == 0);
+        m_reported[column] ^= mask;
+    }
+    return count;
+}
+
+
+static void key_set(uint32_t column, uint32_t row, bool pressed)
+{
+    if (pressed)
+    {
+        m_pressed[column] |= (uint8_t)(1U << row);
+    }
+    else
+    {
+        m_pressed[column] &= (uint8_t)~(1U << row);
+    }
+}
+
+
+/**@brief Function for scanning the current keys and checking that the snapshot is reported if
+ *        and only if it holds no rectangle. */
+static void scan_check(void)
+{
+    uint8_t  snapshot[CHERRY8x16_MATRIX_SIZE];
+    uint8_t  before[COLUMNS];
+    uint32_t count;
+
+    snapshot_compute(m_pressed, snapshot);
+    memcpy(before, m_reported, sizeof(before));
+    count = changes_apply(snapshot, KEYS);
+
+    if (!rectangle_find(snapshot))
+    {
+        CHECK(memcmp(snapshot, m_pressed, sizeof(snapshot)) == 0);
+        CHECK(memcmp(m_reported, m_pressed, sizeof(m_reported)) == 0);
+    }
+    else
+    {
+        CHECK_EQ(count, 0);
+        CHECK(memcmp(m_reported, before, sizeof(before)) == 0);
+    }
+}
+
+
+static void reset(void)
+{
+    m_row_port    = 0;
+    m_column_port = 0xFFFF;
+    CHECK_EQ(cherry8x16_init(&m_row_port, &m_column_port, m_lookup), CHERRY8x16_OK);
+    CHECK_EQ(m_column_port, 0);
+    memset(m_pressed, 0, sizeof(m_pressed));
+    memset(m_reported, 0, sizeof(m_reported));
+}
+
+
+static void test_press_release(void)
+{
+    uint8_t                 snapshot[CHERRY8x16_MATRIX_SIZE];
+    cherry8x16_key_change_t change;
+
+    reset();
+    key_set(5, 2, true);
+    snapshot_compute(m_pressed, snapshot);
+    CHECK_EQ(cherry8x16_key_changes_get(snapshot, &change, 1), 1);
+    CHECK_EQ(change.key_index, 5 * ROWS + 2);
+    CHECK_EQ(change.keycode, m_lookup[5 * ROWS + 2]);
+    CHECK(change.pressed);
+    CHECK_EQ(cherry8x16_key_changes_get(snapshot, &change, 1), 0);
+
+    key_set(5, 2, false);
+    snapshot_compute(m_pressed, snapshot);
+    CHECK_EQ(cherry8x16_key_changes_get(snapshot, &change, 1), 1);
+    CHECK_EQ(change.key_index, 5 * ROWS + 2);
+    CHECK(!change.pressed);
+}
+
+
+/**@brief Three corners of a rectangle make the fourth appear. The snapshot is ignored until one
+ *        key is released, and the changes are then reported against the last reported state. */
+static void test_ghost(void)
+{
+    reset();
+    key_set(1, 1, true);
+    key_set(1, 6, true);
+    scan_check();
+    CHECK_EQ(m_reported[1], (1 << 1) | (1 << 6));
+
+    key_set(9, 6, true);
+    scan_check();
+    CHECK_EQ(m_reported[9], 0);
+
+    // Two keys in one column, one of them sharing its row with the other column, is the same
+    // circuit whichever column is scanned first.
+    key_set(1, 1, false);
+    key_set(9, 1, true);
+    scan_check();
+    CHECK_EQ(m_reported[9], 0);
+
+    key_set(9, 1, false);
+    scan_check();
+    CHECK_EQ(m_reported[1], 1 << 6);
+    CHECK_EQ(m_reported[9], 1 << 6);
+
+    // Keys in one column never ghost.
+    key_set(9, 6, false);
+    key_set(1, 3, true);
+    key_set(1, 4, true);
+    scan_check();
+    CHECK_EQ(m_reported[1], (1 << 3) | (1 << 4) | (1 << 6));
+
+    // Four keys really pressed on a rectangle cannot be told from a ghost, and are ignored too.
+    key_set(12, 3, true);
+    key_set(12, 4, true);
+    scan_check();
+    CHECK_EQ(m_reported[12], 0);
+
+    key_set(1, 3, false);
+    key_set(1, 4, false);
+    scan_check();
+    CHECK_EQ(m_reported[1], 1 << 6);
+    CHECK_EQ(m_reported[12], (1 << 3) | (1 << 4));
+}
+
+
+/**@brief More changes than fit are reported by the following calls. */
+static void test_batches(void)
+{
+    uint8_t snapshot[CHERRY8x16_MATRIX_SIZE];
+
+    reset();
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        key_set(i * 3, i, true);
+    }
+    snapshot_compute(m_pressed, snapshot);
+    CHECK_EQ(changes_apply(snapshot, 2), 2);
+    CHECK_EQ(changes_apply(snapshot, 2), 2);
+    CHECK_EQ(changes_apply(snapshot, 2), 1);
+    CHECK_EQ(changes_apply(snapshot, 2), 0);
+    CHECK(memcmp(m_reported, m_pressed, sizeof(m_reported)) == 0);
+
+    memset(m_pressed, 0, sizeof(m_pressed));
+    snapshot_compute(m_pressed, snapshot);
+    CHECK_EQ(changes_apply(snapshot, 0), 0);
+    CHECK_EQ(changes_apply(snapshot, KEYS), 5);
+}
+
+
+/**@brief Keys are pressed and released at random, and read at random for a few scans around each
+ *        change, as a bouncing contact does. Bounces complete and break rectangles at any scan. */
+static void test_random_bounce(void)
+{
+    uint8_t  bounce_left[KEYS] = {0};
+    bool     target[KEYS]      = {0};
+    uint32_t seed              = 0x1F123BB5;
+    uint32_t pressed_count     = 0;
+
+    reset();
+    for (uint32_t scan = 0; scan < RANDOM_SCANS; scan++)
+    {
+        uint32_t r   = host_rand(&seed);
+        uint32_t key = (r >> 8) % KEYS;
+
+        // A key changes every few scans, up to four keys are held.
+        if (((r & 0x3) == 0) && (bounce_left[key] == 0))
+        {
+            if (target[key])
+            {
+                target[key] = false;
+                pressed_count--;
+                bounce_left[key] = BOUNCE_SCANS;
+            }
+            else if (pressed_count < 4)
+            {
+                target[key] = true;
+                pressed_count++;
+                bounce_left[key] = BOUNCE_SCANS;
+            }
+        }
+
+        for (uint32_t k = 0; k < KEYS; k++)
+        {
+            bool level = target[k];
+
+            if (bounce_left[k] != 0)
+            {
+                bounce_left[k]--;
+                level = (host_rand(&seed) & 1) != 0;
+                if (bounce_left[k] == 0)
+                {
+                    level = target[k];
+                }
+            }
+            key_set(k / ROWS, k % ROWS, level);
+        }
+        scan_check();
+    }
+}
+
+
+static void test_matrix_scan(void)
+{
+    uint8_t snapshot[CHERRY8x16_MATRIX_SIZE];
+
+    reset();
+    memset(snapshot, 0xAA, sizeof(snapshot));
+    m_column_port = 0xFFFF;
+    cherry8x16_matrix_scan(snapshot);
+    for (uint32_t column = 0; column < COLUMNS; column++)
+    {
+        CHECK_EQ(snapshot[column], 0);
+    }
+    CHECK_EQ(m_column_port, 0);
+}
+
+
+int main(void)
+{
+    for (uint32_t i = 0; i < KEYS; i++)
+    {
+        m_lookup[i] = (uint8_t)(0x80 ^ i);
+    }
+
+    test_press_release();
+    test_ghost();
+    test_batches();
+    test_random_bounce();
+    test_matrix_scan();
+
+    return UNIT_TEST_RESULT();
+}
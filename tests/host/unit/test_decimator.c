@@ -0,0 +1,227 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Decimator output compared with floating-point reference filters.
+ *
+ * @details The average and CIC outputs are exact sums divided with rounding, so they must match
+ *          the reference rounded half away from zero. The EMA state is rounded on every sample
+ *          and may differ by one LSB.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "unit_test.h"
+#include "host_util.h"
+#include "decimator.h"
+
+#define VECTOR_LEN  4096
+
+static int16_t m_in[VECTOR_LEN];
+static int16_t m_out[VECTOR_LEN + 1];
+
+
+/**@brief Reference vectors: a noisy sine, a full-scale square wave, and a ramp over the whole range. */
+static void vector_make(uint32_t type)
+{
+    uint32_t seed = 0x1234u + type;
+
+    for (uint32_t i = 0; i < VECTOR_LEN; i++)
+    {
+        switch (type)
+        {
+            case 0:
+                m_in[i] = (int16_t)(2000.0 * sin(i * 0.01) + (int32_t)(host_rand(&seed) % 201) - 100);
+                break;
+
+            case 1:
+                m_in[i] = ((i / 37) & 1) ? INT16_MAX : INT16_MIN;
+                break;
+
+            default:
+                m_in[i] = (int16_t)(INT16_MIN + (int32_t)((i * 65535u) / (VECTOR_LEN - 1)));
+                break;
+        }
+    }
+}
+
+
+static uint16_t run(decimator_filter_t filter, uint16_t factor, uint8_t ema_shift)
+{
+    decimator_t        decimator;
+    decimator_config_t config = {.filter = filter, .factor = factor, .ema_shift = ema_shift};
+
+    CHECK_EQ(decimator_init(&decimator, &config), NRF_SUCCESS);
+    return decimator_process(&decimator, m_in, VECTOR_LEN, 1, m_out);
+}
+
+
+static void test_average(void)
+{
+    static uint16_t const factors[] = {1, 2, 3, 16, 64, 1000};
+
+    for (uint32_t type = 0; type < 3; type++)
+    {
+        vector_make(type);
+        for (uint32_t f = 0; f < sizeof(factors) / sizeof(factors[0]); f++)
+        {
+            uint16_t factor = factors[f];
+            uint16_t count  = run(DECIMATOR_FILTER_AVERAGE, factor, 0);
+
+            CHECK_EQ(count, VECTOR_LEN / factor);
+            for (uint16_t m = 0; m < count; m++)
+            {
+                double sum = 0;
+                for (uint16_t k = 0; k < factor; k++)
+                {
+                    sum += m_in[m * factor + k];
+                }
+                CHECK_EQ(m_out[m], lround(sum / factor));
+            }
+        }
+    }
+}
+
+
+static void test_cic2(void)
+{
+    static uint16_t const factors[] = {1, 2, 5, 16, DECIMATOR_CIC2_MAX_FACTOR};
+
+    for (uint32_t type = 0; type < 3; type++)
+    {
+        vector_make(type);
+        for (uint32_t f = 0; f < sizeof(factors) / sizeof(factors[0]); f++)
+        {
+            uint16_t factor = factors[f];
+            uint16_t count  = run(DECIMATOR_FILTER_CIC2, factor, 0);
+
+            CHECK_EQ(count, VECTOR_LEN / factor);
+            for (uint16_t m = 0; m < count; m++)
+            {
+                // Triangular impulse response of length 2 * factor - 1, gain factor^2.
+                int32_t n   = (int32_t)(m + 1) * factor - 1;
+                double  sum = 0;
+
+                for (int32_t k = 0; k < 2 * factor - 1; k++)
+                {
+                    int32_t weight = (k < factor) ? (k + 1) : (2 * factor - 1 - k);
+                    if (n - k >= 0)
+                    {
+                        sum += (double)weight * m_in[n - k];
+                    }
+                }
+                CHECK_EQ(m_out[m], lround(sum / ((double)factor * factor)));
+            }
+        }
+    }
+}
+
+
+static void test_ema(void)
+{
+    static uint8_t const shifts[] = {0, 1, 4, 8, DECIMATOR_EMA_MAX_SHIFT};
+
+    for (uint32_t type = 0; type < 3; type++)
+    {
+        vector_make(type);
+        for (uint32_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); s++)
+        {
+            uint8_t  shift = shifts[s];
+            uint16_t count = run(DECIMATOR_FILTER_EMA, 8, shift);
+            double   y     = m_in[0];
+            uint32_t worst = 0;
+
+            CHECK_EQ(count, VECTOR_LEN / 8);
+            for (uint32_t i = 0; i < VECTOR_LEN; i++)
+            {
+                y += (m_in[i] - y) / (double)(1u << shift);
+                if ((i % 8) == 7)
+                {
+                    uint32_t diff = (uint32_t)labs(m_out[i / 8] - lround(y));
+                    worst = (diff > worst) ? diff : worst;
+                }
+            }
+            CHECK(worst <= 1);
+        }
+    }
+}
+
+
+static void test_stride_and_put(void)
+{
+    decimator_t        a;
+    decimator_t        b;
+    decimator_config_t config = {.filter = DECIMATOR_FILTER_CIC2, .factor = 4};
+    int16_t            interleaved[2 * 64];
+    int16_t            out_a[17];
+    int16_t            out_b;
+    uint16_t           count;
+    uint16_t           n = 0;
+
+    vector_make(0);
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        interleaved[2 * i]     = m_in[i];
+        interleaved[2 * i + 1] = (int16_t)-m_in[i];
+    }
+
+    CHECK_EQ(decimator_init(&a, &config), NRF_SUCCESS);
+    CHECK_EQ(decimator_init(&b, &config), NRF_SUCCESS);
+
+    count = decimator_process(&a, &interleaved[1], 64, 2, out_a);
+    CHECK_EQ(count, 16);
+
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        if (decimator_put(&b, (int16_t)-m_in[i], &out_b))
+        {
+            CHECK_EQ(out_b, out_a[n]);
+            n++;
+        }
+    }
+    CHECK_EQ(n, 16);
+}
+
+
+static void test_init(void)
+{
+    decimator_t        decimator;
+    decimator_config_t config = {.filter = DECIMATOR_FILTER_AVERAGE, .factor = 0};
+
+    CHECK_EQ(decimator_init(&decimator, &config), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(decimator_init(NULL, &config), NRF_ERROR_INVALID_PARAM);
+
+    config.filter = DECIMATOR_FILTER_CIC2;
+    config.factor = DECIMATOR_CIC2_MAX_FACTOR + 1;
+    CHECK_EQ(decimator_init(&decimator, &config), NRF_ERROR_INVALID_PARAM);
+
+    config.filter    = DECIMATOR_FILTER_EMA;
+    config.factor    = 1;
+    config.ema_shift = DECIMATOR_EMA_MAX_SHIFT + 1;
+    CHECK_EQ(decimator_init(&decimator, &config), NRF_ERROR_INVALID_PARAM);
+
+    config.filter = (decimator_filter_t)3;
+    CHECK_EQ(decimator_init(&decimator, &config), NRF_ERROR_INVALID_PARAM);
+}
+
+
+int main(void)
+{
+    test_init();
+    test_average();
+    test_cic2();
+    test_ema();
+    test_stride_and_put();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,637 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Peripheral Device Manager: bond index, instance bitmaps and whitelist.
+ *
+ * @details The test fills a bond table of 70 devices, so the bitmaps span three words. Even
+ *          devices are identified by a public address, odd devices use resolvable addresses and
+ *          are found by IRK and EDIV. pstorage is a block array in RAM whose callbacks are
+ *          delivered by storage_flush(), and the SoftDevice replies only capture the key set.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "device_manager.h"
+#include "pstorage.h"
+
+#define BONDS               DEVICE_MANAGER_MAX_BONDS
+#define BLOCK_BASE          0x1000
+#define STORAGE_SIZE        (64 * 1024)
+#define PENDING_MAX         16
+#define WHITELIST_MAX       BONDS
+
+/**@brief Storage operation whose completion is not reported yet. */
+typedef struct
+{
+    pstorage_handle_t handle;
+    uint8_t           op_code;
+    uint8_t         * p_data;
+    uint32_t          size;
+} pending_op_t;
+
+static uint8_t                m_storage[STORAGE_SIZE];
+static pstorage_ntf_cb_t      m_storage_cb;
+static uint32_t               m_block_size;
+static pending_op_t           m_pending[PENDING_MAX];
+static uint32_t               m_pending_count;
+static uint32_t               m_peer_id_writes;         /**< Writes at the start of a block. */
+static uint32_t               m_bond_writes;            /**< Other writes. */
+
+static ble_gap_sec_keyset_t   m_keyset;                 /**< Key set of the last pairing reply. */
+static uint16_t               m_conn_handle;
+static dm_application_instance_t m_app;
+
+static uint32_t               m_last_event;
+static dm_handle_t            m_last_handle;
+static ret_code_t             m_last_result;
+static uint32_t               m_connection_device;      /**< Device of the last DM_EVT_CONNECTION. */
+static ret_code_t             m_pairing_result;         /**< Result of the last security setup. */
+
+
+uint32_t pstorage_register(pstorage_module_param_t * p_module_param,
+                           pstorage_handle_t       * p_block_id)
+{
+    m_storage_cb  = p_module_param->cb;
+    m_block_size  = p_module_param->block_size;
+    CHECK(m_block_size * p_module_param->block_count <= STORAGE_SIZE);
+
+    p_block_id->module_id = 1;
+    p_block_id->block_id  = BLOCK_BASE;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t pstorage_block_identifier_get(pstorage_handle_t * p_base_id,
+                                       pstorage_size_t     block_num,
+                                       pstorage_handle_t * p_block_id)
+{
+    if (block_num >= BONDS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    p_block_id->module_id = p_base_id->module_id;
+    p_block_id->block_id  = p_base_id->block_id + block_num * m_block_size;
+    return NRF_SUCCESS;
+}
+
+
+static uint8_t * storage_ptr(pstorage_handle_t const * p_handle, uint32_t offset)
+{
+    return &m_storage[p_handle->block_id - BLOCK_BASE + offset];
+}
+
+
+static void pending_add(pstorage_handle_t * p_handle, uint8_t op_code, uint8_t * p_data,
+                        uint32_t size)
+{
+    CHECK(m_pending_count < PENDING_MAX);
+    if (m_pending_count < PENDING_MAX)
+    {
+        m_pending[m_pending_count].handle  = *p_handle;
+        m_pending[m_pending_count].op_code = op_code;
+        m_pending[m_pending_count].p_data  = p_data;
+        m_pending[m_pending_count].size    = size;
+        m_pending_count++;
+    }
+}
+
+
+uint32_t pstorage_load(uint8_t           * p_dest,
+                       pstorage_handle_t * p_src,
+                       pstorage_size_t     size,
+                       pstorage_size_t     offset)
+{
+    memcpy(p_dest, storage_ptr(p_src, offset), size);
+    return NRF_SUCCESS;
+}
+
+
+static uint32_t storage_write(pstorage_handle_t * p_dest,
+                              uint8_t           * p_src,
+                              pstorage_size_t     size,
+                              pstorage_size_t     offset,
+                              uint8_t             op_code)
+{
+    if (offset == 0)
+    {
+        m_peer_id_writes++;
+    }
+    else
+    {
+        m_bond_writes++;
+    }
+    memcpy(storage_ptr(p_dest, offset), p_src, size);
+    pending_add(p_dest, op_code, p_src, size);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t pstorage_store(pstorage_handle_t * p_dest,
+                        uint8_t           * p_src,
+                        pstorage_size_t     size,
+                        pstorage_size_t     offset)
+{
+    return storage_write(p_dest, p_src, size, offset, PSTORAGE_STORE_OP_CODE);
+}
+
+
+uint32_t pstorage_update(pstorage_handle_t * p_dest,
+                         uint8_t           * p_src,
+                         pstorage_size_t     size,
+                         pstorage_size_t     offset)
+{
+    return storage_write(p_dest, p_src, size, offset, PSTORAGE_UPDATE_OP_CODE);
+}
+
+
+uint32_t pstorage_clear(pstorage_handle_t * p_base_id, pstorage_size_t size)
+{
+    memset(storage_ptr(p_base_id, 0), 0xFF, size);
+    pending_add(p_base_id, PSTORAGE_CLEAR_OP_CODE, NULL, size);
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for reporting the completion of the storage operations. */
+static void storage_flush(void)
+{
+    for (uint32_t i = 0; i < m_pending_count; i++)
+    {
+        m_storage_cb(&m_pending[i].handle,
+                     m_pending[i].op_code,
+                     NRF_SUCCESS,
+                     m_pending[i].p_data,
+                     m_pending[i].size);
+    }
+    m_pending_count = 0;
+}
+
+
+uint32_t sd_ble_gap_sec_params_reply(uint16_t                     conn_handle,
+                                     uint8_t                      sec_status,
+                                     ble_gap_sec_params_t const * p_sec_params,
+                                     ble_gap_sec_keyset_t const * p_sec_keyset)
+{
+    if (p_sec_keyset != NULL)
+    {
+        m_keyset = *p_sec_keyset;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_sec_info_reply(uint16_t                    conn_handle,
+                                   ble_gap_enc_info_t const  * p_enc_info,
+                                   ble_gap_irk_t const       * p_id_info,
+                                   ble_gap_sign_info_t const * p_sign_info)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_authenticate(uint16_t conn_handle, ble_gap_sec_params_t const * p_sec_params)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_sys_attr_set(uint16_t conn_handle, uint8_t const * p_sys_attr_data,
+                                   uint16_t len, uint32_t flags)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_sys_attr_get(uint16_t conn_handle, uint8_t * p_sys_attr_data,
+                                   uint16_t * p_len, uint32_t flags)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_service_changed(uint16_t conn_handle, uint16_t start_handle,
+                                      uint16_t end_handle)
+{
+    return NRF_SUCCESS;
+}
+
+
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t * p_file_name)
+{
+    CHECK_EQ(error_code, NRF_SUCCESS);
+}
+
+
+static ret_code_t dm_evt_handler(dm_handle_t const * p_handle,
+                                 dm_event_t const  * p_event,
+                                 ret_code_t          event_result)
+{
+    m_last_event  = p_event->event_id;
+    m_last_handle = *p_handle;
+    m_last_result = event_result;
+    if (p_event->event_id == DM_EVT_CONNECTION)
+    {
+        m_connection_device = p_handle->device_id;
+    }
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for making the identity address of device 'n'. The bytes are scrambled so
+ *        that the address order differs from the allocation order.
+ */
+static ble_gap_addr_t addr_make(uint32_t n, uint8_t addr_type)
+{
+    ble_gap_addr_t addr;
+    uint32_t       hash = (n + 1) * 2654435761u;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.addr_type = addr_type;
+    addr.addr[0]   = (uint8_t)n;
+    addr.addr[1]   = (uint8_t)(n >> 8);
+    addr.addr[2]   = (uint8_t)hash;
+    addr.addr[3]   = (uint8_t)(hash >> 8);
+    addr.addr[4]   = (uint8_t)(hash >> 16);
+    addr.addr[5]   = (uint8_t)(hash >> 24) | 0xC0;
+    return addr;
+}
+
+
+static ble_gap_addr_t public_addr(uint32_t n)
+{
+    return addr_make(n, BLE_GAP_ADDR_TYPE_PUBLIC);
+}
+
+
+/**@brief Function for making a fresh resolvable address, never used before. */
+static ble_gap_addr_t resolvable_addr(void)
+{
+    static uint32_t count;
+
+    ble_gap_addr_t addr = addr_make(0x8000 + count++, BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE);
+    addr.addr[5] = (addr.addr[5] & 0x3F) | 0x40;
+    return addr;
+}
+
+
+static uint16_t ediv_of(uint32_t n)
+{
+    return (uint16_t)(0x5000 + n * 37);
+}
+
+
+static void ble_evt_send(uint16_t evt_id, ble_gap_evt_t const * p_gap_evt)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id = evt_id;
+    evt.evt.gap_evt   = *p_gap_evt;
+    dm_ble_evt_handler(&evt);
+}
+
+
+/**@brief Function for connecting a peer. Returns the bonded device found, or DM_INVALID_ID. */
+static uint32_t peer_connect(ble_gap_addr_t const * p_addr, bool irk_match, uint8_t irk_idx)
+{
+    ble_gap_evt_t gap_evt;
+
+    memset(&gap_evt, 0, sizeof(gap_evt));
+    gap_evt.conn_handle                   = ++m_conn_handle;
+    gap_evt.params.connected.peer_addr    = *p_addr;
+    gap_evt.params.connected.irk_match    = irk_match;
+    gap_evt.params.connected.irk_match_idx = irk_idx;
+
+    m_connection_device = 0xFFFFFFFF;
+    ble_evt_send(BLE_GAP_EVT_CONNECTED, &gap_evt);
+    CHECK_EQ(m_last_event, DM_EVT_CONNECTION);
+    return m_connection_device;
+}
+
+
+static void peer_encrypt(void)
+{
+    ble_gap_evt_t gap_evt;
+
+    memset(&gap_evt, 0, sizeof(gap_evt));
+    gap_evt.conn_handle                                = m_conn_handle;
+    gap_evt.params.conn_sec_update.conn_sec.sec_mode.sm = 1;
+    gap_evt.params.conn_sec_update.conn_sec.sec_mode.lv = 2;
+    ble_evt_send(BLE_GAP_EVT_CONN_SEC_UPDATE, &gap_evt);
+}
+
+
+static void peer_disconnect(void)
+{
+    ble_gap_evt_t gap_evt;
+
+    memset(&gap_evt, 0, sizeof(gap_evt));
+    gap_evt.conn_handle = m_conn_handle;
+    ble_evt_send(BLE_GAP_EVT_DISCONNECTED, &gap_evt);
+    storage_flush();
+}
+
+
+/**@brief Function for connecting and bonding device 'n'. Returns the device instance allocated. */
+static uint32_t peer_bond(uint32_t n)
+{
+    bool           resolvable = (n & 1);
+    ble_gap_addr_t addr       = resolvable ? resolvable_addr() : public_addr(n);
+    ble_gap_evt_t  gap_evt;
+    dm_handle_t    handle;
+
+    CHECK_EQ(peer_connect(&addr, false, 0), DM_INVALID_ID);
+
+    memset(&m_keyset, 0, sizeof(m_keyset));
+    memset(&gap_evt, 0, sizeof(gap_evt));
+    gap_evt.conn_handle = m_conn_handle;
+    ble_evt_send(BLE_GAP_EVT_SEC_PARAMS_REQUEST, &gap_evt);
+    m_pairing_result = m_last_result;
+    if (m_pairing_result != NRF_SUCCESS)
+    {
+        peer_disconnect();
+        return DM_INVALID_ID;
+    }
+
+    // The SoftDevice fills in the keys while pairing.
+    if (resolvable)
+    {
+        ble_gap_addr_t id_addr = addr_make(n, BLE_GAP_ADDR_TYPE_RANDOM_STATIC);
+
+        memset(m_keyset.keys_peer.p_id_key->id_info.irk, (int)(n + 1), BLE_GAP_SEC_KEY_LEN);
+        m_keyset.keys_peer.p_id_key->id_addr_info  = id_addr;
+        m_keyset.keys_own.p_enc_key->master_id.ediv = ediv_of(n);
+    }
+
+    memset(&gap_evt, 0, sizeof(gap_evt));
+    gap_evt.conn_handle                       = m_conn_handle;
+    gap_evt.params.auth_status.auth_status    = BLE_GAP_SEC_STATUS_SUCCESS;
+    gap_evt.params.auth_status.bonded         = 1;
+    gap_evt.params.auth_status.kdist_peer.id  = resolvable;
+    ble_evt_send(BLE_GAP_EVT_AUTH_STATUS, &gap_evt);
+
+    handle.appl_id = m_app;
+    CHECK_EQ(dm_handle_get(m_conn_handle, &handle), NRF_SUCCESS);
+    storage_flush();
+    CHECK_EQ(m_last_event, DM_EVT_DEVICE_CONTEXT_STORED);
+    peer_encrypt();
+    peer_disconnect();
+
+    return handle.device_id;
+}
+
+
+static void dm_start(bool clear)
+{
+    dm_init_param_t        init_param = { .clear_persistent_data = clear };
+    dm_application_param_t app_param;
+
+    memset(&app_param, 0, sizeof(app_param));
+    app_param.evt_handler  = dm_evt_handler;
+    app_param.service_type = DM_PROTOCOL_CNTXT_NONE;
+
+    CHECK_EQ(dm_init(&init_param), NRF_SUCCESS);
+    CHECK_EQ(dm_register(&m_app, &app_param), NRF_SUCCESS);
+    m_pending_count = 0;
+}
+
+
+static uint32_t device_of_addr(ble_gap_addr_t const * p_addr)
+{
+    uint32_t device = peer_connect(p_addr, false, 0);
+
+    peer_disconnect();
+    return device;
+}
+
+
+static uint32_t device_of_ediv(uint16_t ediv)
+{
+    ble_gap_addr_t addr = resolvable_addr();
+    ble_gap_evt_t  gap_evt;
+    dm_handle_t    handle;
+
+    CHECK_EQ(peer_connect(&addr, false, 0), DM_INVALID_ID);
+
+    memset(&gap_evt, 0, sizeof(gap_evt));
+    gap_evt.conn_handle                           = m_conn_handle;
+    gap_evt.params.sec_info_request.master_id.ediv = ediv;
+    ble_evt_send(BLE_GAP_EVT_SEC_INFO_REQUEST, &gap_evt);
+
+    handle.appl_id = m_app;
+    CHECK_EQ(dm_handle_get(m_conn_handle, &handle), NRF_SUCCESS);
+    peer_disconnect();
+    return handle.device_id;
+}
+
+
+/**@brief Function for checking that every bonded device is found, and unknown ones are not. */
+static void lookups_check(uint32_t const * p_device_of)
+{
+    for (uint32_t n = 0; n < BONDS; n++)
+    {
+        // Visit the devices out of order.
+        uint32_t       k    = (n * 29) % BONDS;
+        ble_gap_addr_t addr = public_addr(k);
+
+        if (k & 1)
+        {
+            CHECK_EQ(device_of_ediv(ediv_of(k)), p_device_of[k]);
+        }
+        else
+        {
+            CHECK_EQ(device_of_addr(&addr), p_device_of[k]);
+        }
+    }
+
+    ble_gap_addr_t unknown = public_addr(1000);
+    CHECK_EQ(device_of_addr(&unknown), DM_INVALID_ID);
+    CHECK_EQ(device_of_ediv(ediv_of(1000)), DM_INVALID_ID);
+}
+
+
+static void whitelist_get(ble_gap_whitelist_t * p_whitelist,
+                          ble_gap_addr_t     ** pp_addrs,
+                          ble_gap_irk_t      ** pp_irks,
+                          uint8_t               capacity)
+{
+    p_whitelist->pp_addrs   = pp_addrs;
+    p_whitelist->pp_irks    = pp_irks;
+    p_whitelist->addr_count = capacity;
+    p_whitelist->irk_count  = capacity;
+    CHECK_EQ(dm_whitelist_create(&m_app, p_whitelist), NRF_SUCCESS);
+}
+
+
+static uint32_t m_device_of[BONDS + 3];      /**< Device instance of each device number. */
+
+
+static void test_fill(void)
+{
+    uint32_t peer_id_writes;
+
+    memset(m_storage, 0xFF, sizeof(m_storage));
+    dm_start(false);
+
+    // Instances are allocated in order, across the words of the bitmap.
+    for (uint32_t n = 0; n < BONDS; n++)
+    {
+        m_device_of[n] = peer_bond(n);
+        CHECK_EQ(m_device_of[n], n);
+    }
+
+    // The peer identification is written once per bond, reconnections do not write it again.
+    CHECK_EQ(m_peer_id_writes, BONDS);
+    CHECK_EQ(m_bond_writes, BONDS);
+
+    peer_id_writes = m_peer_id_writes;
+    lookups_check(m_device_of);
+    CHECK_EQ(m_peer_id_writes, peer_id_writes);
+
+    // The table is full.
+    CHECK_EQ(peer_bond(BONDS), DM_INVALID_ID);
+    CHECK_EQ(m_pairing_result, DM_DEVICE_CONTEXT_FULL);
+    CHECK(m_keyset.keys_peer.p_id_key == NULL);
+}
+
+
+static void test_whitelist(void)
+{
+    ble_gap_whitelist_t whitelist;
+    ble_gap_addr_t    * p_addrs[WHITELIST_MAX];
+    ble_gap_irk_t     * p_irks[WHITELIST_MAX];
+    ble_gap_addr_t      addr = public_addr(0);
+
+    // A connected device is left out, the others come in instance order.
+    CHECK_EQ(peer_connect(&addr, false, 0), 0);
+    whitelist_get(&whitelist, p_addrs, p_irks, 8);
+    CHECK_EQ(whitelist.addr_count, 8);
+    CHECK_EQ(whitelist.irk_count, 8);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        ble_gap_addr_t expected = public_addr(2 * i + 2);
+        uint8_t        irk[BLE_GAP_SEC_KEY_LEN];
+
+        CHECK(memcmp(p_addrs[i], &expected, sizeof(expected)) == 0);
+        memset(irk, (int)(2 * i + 2), sizeof(irk));
+        CHECK(memcmp(p_irks[i]->irk, irk, sizeof(irk)) == 0);
+    }
+    peer_disconnect();
+
+    whitelist_get(&whitelist, p_addrs, p_irks, WHITELIST_MAX);
+    CHECK_EQ(whitelist.addr_count, BONDS / 2);
+    CHECK_EQ(whitelist.irk_count, BONDS / 2);
+
+    // An IRK match on connection refers to the position in the last whitelist.
+    addr = resolvable_addr();
+    CHECK_EQ(peer_connect(&addr, true, 3), 7);
+    peer_disconnect();
+}
+
+
+static void test_delete(void)
+{
+    static uint32_t const deleted[] = { 10, 40, 65 };
+    ble_gap_whitelist_t   whitelist;
+    ble_gap_addr_t      * p_addrs[WHITELIST_MAX];
+    ble_gap_irk_t       * p_irks[WHITELIST_MAX];
+    dm_handle_t           handle;
+
+    CHECK_EQ(dm_handle_initialize(&handle), NRF_SUCCESS);
+    handle.appl_id = m_app;
+
+    for (uint32_t i = 0; i < sizeof(deleted) / sizeof(deleted[0]); i++)
+    {
+        handle.device_id = deleted[i];
+        CHECK_EQ(dm_device_delete(&handle), NRF_SUCCESS);
+        storage_flush();
+        CHECK_EQ(m_last_event, DM_EVT_DEVICE_CONTEXT_DELETED);
+        CHECK_EQ(m_last_handle.device_id, deleted[i]);
+        m_device_of[deleted[i]] = DM_INVALID_ID;
+    }
+
+    lookups_check(m_device_of);
+    whitelist_get(&whitelist, p_addrs, p_irks, WHITELIST_MAX);
+    CHECK_EQ(whitelist.addr_count, BONDS / 2 - 2);
+    CHECK_EQ(whitelist.irk_count, BONDS / 2 - 1);
+
+    // The freed instances are reused lowest first.
+    for (uint32_t i = 0; i < sizeof(deleted) / sizeof(deleted[0]); i++)
+    {
+        uint32_t n = BONDS + i;
+
+        m_device_of[n] = peer_bond(n);
+        CHECK_EQ(m_device_of[n], deleted[i]);
+    }
+    CHECK_EQ(peer_bond(BONDS + 3), DM_INVALID_ID);
+}
+
+
+static void test_peer_addr_set(void)
+{
+    ble_gap_addr_t old_addr = public_addr(4);
+    ble_gap_addr_t new_addr = public_addr(2000);
+    dm_handle_t    handle;
+    uint32_t       peer_id_writes = m_peer_id_writes;
+
+    CHECK_EQ(dm_handle_initialize(&handle), NRF_SUCCESS);
+    handle.appl_id   = m_app;
+    handle.device_id = 4;
+
+    CHECK_EQ(dm_peer_addr_set(&handle, &new_addr), NRF_SUCCESS);
+    CHECK_EQ(m_peer_id_writes, peer_id_writes + 1);
+    storage_flush();
+    CHECK_EQ(m_last_event, DM_EVT_DEVICE_CONTEXT_STORED);
+
+    CHECK_EQ(device_of_addr(&new_addr), 4);
+    CHECK_EQ(device_of_addr(&old_addr), DM_INVALID_ID);
+}
+
+
+static void test_reload(void)
+{
+    ble_gap_addr_t addr = public_addr(2000);
+
+    // The indices are rebuilt from storage.
+    dm_start(false);
+    CHECK_EQ(device_of_addr(&addr), 4);
+    m_device_of[4] = DM_INVALID_ID;
+    for (uint32_t n = 0; n < BONDS; n++)
+    {
+        if ((n & 1) && (m_device_of[n] != DM_INVALID_ID))
+        {
+            CHECK_EQ(device_of_ediv(ediv_of(n)), m_device_of[n]);
+        }
+        else if (m_device_of[n] != DM_INVALID_ID)
+        {
+            addr = public_addr(n);
+            CHECK_EQ(device_of_addr(&addr), m_device_of[n]);
+        }
+    }
+    CHECK_EQ(device_of_ediv(ediv_of(BONDS + 1)), 40);
+}
+
+
+int main(void)
+{
+    test_fill();
+    test_whitelist();
+    test_delete();
+    test_peer_addr_set();
+    test_reload();
+
+    return UNIT_TEST_RESULT();
+}
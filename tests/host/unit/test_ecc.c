@@ -0,0 +1,438 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief P-256 key pairs and shared secrets of the ECC module.
+ *
+ * @details The known answers are the LE Secure Connections sample data of the Bluetooth Core
+ *          Specification, Vol 3, Part H, 2.3.5.6.1. They are written most significant byte first,
+ *          as in the specification, and reversed for the module, which takes little endian keys.
+ *
+ *          The module is built with ECC_ASYNC_ENABLED. The test plays the scheduler queue and runs
+ *          the events one at a time, highest priority first, so the steps of the precomputed key
+ *          pair can be followed. The RNG driver is replaced by a generator that can be made to
+ *          fail.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "host_util.h"
+#include "nrf_error.h"
+#include "nrf_drv_rng.h"
+#include "app_scheduler.h"
+#include "ecc.h"
+
+#define SCHED_QUEUE_SIZE    4
+
+/** Private key of device A. */
+static uint8_t const m_sk_a_be[ECC_P256_SK_LEN] =
+{
+    0x3f, 0x49, 0xf6, 0xd4, 0xa3, 0xc5, 0x5f, 0x38, 0x74, 0xc9, 0xb3, 0xe3, 0xd2, 0x10, 0x3f, 0x50,
+    0x4a, 0xff, 0x60, 0x7b, 0xeb, 0x40, 0xb7, 0x99, 0x58, 0x99, 0xb8, 0xa6, 0xcd, 0x3c, 0x1a, 0xbd
+};
+
+/** Public key of device A, X then Y. */
+static uint8_t const m_pk_a_be[ECC_P256_PK_LEN] =
+{
+    0x20, 0xb0, 0x03, 0xd2, 0xf2, 0x97, 0xbe, 0x2c, 0x5e, 0x2c, 0x83, 0xa7, 0xe9, 0xf9, 0xa5, 0xb9,
+    0xef, 0xf4, 0x91, 0x11, 0xac, 0xf4, 0xfd, 0xdb, 0xcc, 0x03, 0x01, 0x48, 0x0e, 0x35, 0x9d, 0xe6,
+    0xdc, 0x80, 0x9c, 0x49, 0x65, 0x2a, 0xeb, 0x6d, 0x63, 0x32, 0x9a, 0xbf, 0x5a, 0x52, 0x15, 0x5c,
+    0x76, 0x63, 0x45, 0xc2, 0x8f, 0xed, 0x30, 0x24, 0x74, 0x1c, 0x8e, 0xd0, 0x15, 0x89, 0xd2, 0x8b
+};
+
+/** Private key of device B. */
+static uint8_t const m_sk_b_be[ECC_P256_SK_LEN] =
+{
+    0x55, 0x18, 0x8b, 0x3d, 0x32, 0xf6, 0xbb, 0x9a, 0x90, 0x0a, 0xfc, 0xfb, 0xee, 0xd4, 0xe7, 0x2a,
+    0x59, 0xcb, 0x9a, 0xc2, 0xf1, 0x9d, 0x7c, 0xfb, 0x6b, 0x4f, 0xdd, 0x49, 0xf4, 0x7f, 0xc5, 0xfd
+};
+
+/** Public key of device B, X then Y. */
+static uint8_t const m_pk_b_be[ECC_P256_PK_LEN] =
+{
+    0x1e, 0xa1, 0xf0, 0xf0, 0x1f, 0xaf, 0x1d, 0x96, 0x09, 0x59, 0x22, 0x84, 0xf1, 0x9e, 0x4c, 0x00,
+    0x47, 0xb5, 0x8a, 0xfd, 0x86, 0x15, 0xa6, 0x9f, 0x55, 0x90, 0x77, 0xb2, 0x2f, 0xaa, 0xa1, 0x90,
+    0x4c, 0x55, 0xf3, 0x3e, 0x42, 0x9d, 0xad, 0x37, 0x73, 0x56, 0x70, 0x3a, 0x9a, 0xb8, 0x51, 0x60,
+    0x47, 0x2d, 0x11, 0x30, 0xe2, 0x8e, 0x36, 0x76, 0x5f, 0x89, 0xaf, 0xf9, 0x15, 0xb1, 0x21, 0x4a
+};
+
+/** DHKey of A and B. */
+static uint8_t const m_dhkey_be[ECC_P256_SK_LEN] =
+{
+    0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05, 0x34, 0x10, 0x10, 0xa6, 0x0a, 0x39, 0x7d, 0x9b,
+    0x99, 0x79, 0x6b, 0x13, 0xb4, 0xf8, 0x66, 0xf1, 0x86, 0x8d, 0x34, 0xf3, 0x73, 0xbf, 0xa6, 0x98
+};
+
+/**@brief Keys in the layout of the module: little endian, word aligned. */
+static struct
+{
+    uint32_t sk_a[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t pk_a[ECC_P256_PK_LEN / sizeof(uint32_t)];
+    uint32_t sk_b[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t pk_b[ECC_P256_PK_LEN / sizeof(uint32_t)];
+    uint32_t dhkey[ECC_P256_SK_LEN / sizeof(uint32_t)];
+} m_keys;
+
+static uint32_t m_rng_state = 0x2545F491;
+static uint32_t m_rng_calls;
+static bool     m_rng_fail;
+
+/**@brief Scheduler queue. */
+static struct
+{
+    struct
+    {
+        app_sched_event_handler_t handler;
+        uint8_t                   priority;
+    }        events[SCHED_QUEUE_SIZE];
+    uint32_t count;
+    bool     full;                      /**< Refuse new events, as a full queue does. */
+} m_sched;
+
+/**@brief Result of the last asynchronous shared secret. */
+static struct
+{
+    uint32_t   count;
+    ret_code_t result;
+    uint8_t  * p_le_ss;
+    void     * p_context;
+} m_ss;
+
+
+ret_code_t nrf_drv_rng_block_rand(uint8_t * p_buff, uint32_t length)
+{
+    m_rng_calls++;
+    if (m_rng_fail)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+    for (uint32_t i = 0; i < length; i++)
+    {
+        p_buff[i] = (uint8_t)host_rand(&m_rng_state);
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_put_prio(void *                    p_event_data,
+                                  uint16_t                  event_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority)
+{
+    if (m_sched.full || (m_sched.count == SCHED_QUEUE_SIZE))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    m_sched.events[m_sched.count].handler  = handler;
+    m_sched.events[m_sched.count].priority = priority;
+    m_sched.count++;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Runs the first event of the highest priority, as app_sched_execute() would.
+ *
+ * @return  False if the queue was empty.
+ */
+static bool sched_run_one(void)
+{
+    app_sched_event_handler_t handler;
+    uint32_t                  next = 0;
+
+    if (m_sched.count == 0)
+    {
+        return false;
+    }
+    for (uint32_t i = 1; i < m_sched.count; i++)
+    {
+        if (m_sched.events[i].priority < m_sched.events[next].priority)
+        {
+            next = i;
+        }
+    }
+    handler = m_sched.events[next].handler;
+    memmove(&m_sched.events[next], &m_sched.events[next + 1],
+            (m_sched.count - next - 1) * sizeof(m_sched.events[0]));
+    m_sched.count--;
+
+    handler(NULL, 0);
+    return true;
+}
+
+
+static void sched_run_all(void)
+{
+    while (sched_run_one())
+    {
+    }
+}
+
+
+/**@brief Copies a big endian number to a little endian one. Public keys are X and Y, each
+ *        reversed on its own. */
+static void reverse_copy(void * p_dst, uint8_t const * p_src, uint32_t len)
+{
+    uint8_t * p_out = p_dst;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        p_out[i] = p_src[len - 1 - i];
+    }
+}
+
+
+static void pk_copy(uint32_t * p_dst, uint8_t const * p_src)
+{
+    reverse_copy(p_dst, p_src, ECC_P256_PK_LEN / 2);
+    reverse_copy((uint8_t *)p_dst + ECC_P256_PK_LEN / 2, p_src + ECC_P256_PK_LEN / 2, ECC_P256_PK_LEN / 2);
+}
+
+
+static void ss_handler(ret_code_t result, uint8_t * p_le_ss, void * p_context)
+{
+    m_ss.count++;
+    m_ss.result    = result;
+    m_ss.p_le_ss   = p_le_ss;
+    m_ss.p_context = p_context;
+}
+
+
+static void test_known_answers(void)
+{
+    uint32_t pk[ECC_P256_PK_LEN / sizeof(uint32_t)];
+    uint32_t ss[ECC_P256_SK_LEN / sizeof(uint32_t)];
+
+    CHECK_EQ(ecc_p256_public_key_compute((uint8_t *)m_keys.sk_a, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK(memcmp(pk, m_keys.pk_a, sizeof(pk)) == 0);
+    CHECK_EQ(ecc_p256_public_key_compute((uint8_t *)m_keys.sk_b, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK(memcmp(pk, m_keys.pk_b, sizeof(pk)) == 0);
+
+    CHECK_EQ(ecc_p256_shared_secret_compute((uint8_t *)m_keys.sk_a, (uint8_t *)m_keys.pk_b,
+                                            (uint8_t *)ss), NRF_SUCCESS);
+    CHECK(memcmp(ss, m_keys.dhkey, sizeof(ss)) == 0);
+    memset(ss, 0, sizeof(ss));
+    CHECK_EQ(ecc_p256_shared_secret_compute((uint8_t *)m_keys.sk_b, (uint8_t *)m_keys.pk_a,
+                                            (uint8_t *)ss), NRF_SUCCESS);
+    CHECK(memcmp(ss, m_keys.dhkey, sizeof(ss)) == 0);
+}
+
+
+static void test_invalid_arguments(void)
+{
+    uint32_t buf[ECC_P256_PK_LEN / sizeof(uint32_t) + 1];
+    uint8_t  * p_odd = (uint8_t *)buf + 1;
+    uint32_t zero[ECC_P256_SK_LEN / sizeof(uint32_t)] = {0};
+
+    CHECK_EQ(ecc_p256_keypair_gen(NULL, (uint8_t *)buf), NRF_ERROR_NULL);
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)buf, p_odd), NRF_ERROR_INVALID_ADDR);
+    CHECK_EQ(ecc_p256_public_key_compute((uint8_t *)m_keys.sk_a, NULL), NRF_ERROR_NULL);
+    CHECK_EQ(ecc_p256_public_key_compute(p_odd, (uint8_t *)buf), NRF_ERROR_INVALID_ADDR);
+    CHECK_EQ(ecc_p256_shared_secret_compute((uint8_t *)m_keys.sk_a, (uint8_t *)m_keys.pk_b, NULL),
+             NRF_ERROR_NULL);
+    CHECK_EQ(ecc_p256_shared_secret_compute((uint8_t *)m_keys.sk_a, (uint8_t *)m_keys.pk_b, p_odd),
+             NRF_ERROR_INVALID_ADDR);
+    CHECK_EQ(ecc_p256_shared_secret_compute_async((uint8_t *)m_keys.sk_a, (uint8_t *)m_keys.pk_b,
+                                                  (uint8_t *)buf, NULL, NULL), NRF_ERROR_NULL);
+    CHECK_EQ(ecc_p256_shared_secret_compute_async((uint8_t *)m_keys.sk_a, (uint8_t *)m_keys.pk_b,
+                                                  p_odd, ss_handler, NULL), NRF_ERROR_INVALID_ADDR);
+
+    // Zero is not a valid private key.
+    CHECK_EQ(ecc_p256_public_key_compute((uint8_t *)zero, (uint8_t *)buf), NRF_ERROR_INTERNAL);
+    CHECK_EQ(ecc_p256_shared_secret_compute((uint8_t *)zero, (uint8_t *)m_keys.pk_b,
+                                            (uint8_t *)buf), NRF_ERROR_INTERNAL);
+}
+
+
+/**@brief Checks a generated key pair against the public key computed from its private key, and
+ *        the shared secrets with device A against each other. */
+static void check_keypair(uint32_t const * p_sk, uint32_t const * p_pk)
+{
+    uint32_t pk[ECC_P256_PK_LEN / sizeof(uint32_t)];
+    uint32_t ss_1[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t ss_2[ECC_P256_SK_LEN / sizeof(uint32_t)];
+
+    CHECK_EQ(ecc_p256_public_key_compute((uint8_t const *)p_sk, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK(memcmp(pk, p_pk, sizeof(pk)) == 0);
+    CHECK_EQ(ecc_p256_shared_secret_compute((uint8_t const *)p_sk, (uint8_t *)m_keys.pk_a,
+                                            (uint8_t *)ss_1), NRF_SUCCESS);
+    CHECK_EQ(ecc_p256_shared_secret_compute((uint8_t *)m_keys.sk_a, (uint8_t const *)p_pk,
+                                            (uint8_t *)ss_2), NRF_SUCCESS);
+    CHECK(memcmp(ss_1, ss_2, sizeof(ss_1)) == 0);
+}
+
+
+static void test_keypair_sync(void)
+{
+    uint32_t sk[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t pk[ECC_P256_PK_LEN / sizeof(uint32_t)];
+    uint32_t sk_2[ECC_P256_SK_LEN / sizeof(uint32_t)];
+
+    // Without precomputation the key pair is drawn and computed in the call.
+    m_rng_calls = 0;
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK(m_rng_calls > 0);
+    check_keypair(sk, pk);
+
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk_2, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK(memcmp(sk, sk_2, sizeof(sk)) != 0);
+
+    m_rng_fail = true;
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk), NRF_ERROR_INTERNAL);
+    m_rng_fail = false;
+
+    // Nothing was scheduled.
+    CHECK_EQ(m_sched.count, 0);
+}
+
+
+static void test_keypair_precompute(void)
+{
+    uint32_t sk[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t pk[ECC_P256_PK_LEN / sizeof(uint32_t)];
+    uint32_t sk_2[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t pk_2[ECC_P256_PK_LEN / sizeof(uint32_t)];
+
+    // Only one job is queued. While the RNG fails the job keeps yielding and retries.
+    m_rng_fail = true;
+    CHECK_EQ(ecc_p256_keypair_precompute_start(), NRF_SUCCESS);
+    CHECK_EQ(ecc_p256_keypair_precompute_start(), NRF_SUCCESS);
+    CHECK_EQ(m_sched.count, 1);
+    m_rng_calls = 0;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        CHECK(sched_run_one());
+        CHECK_EQ(m_sched.count, 1);
+    }
+    CHECK_EQ(m_rng_calls, 3);
+
+    // Private key, then public key, each in its own scheduler event.
+    m_rng_fail = false;
+    CHECK(sched_run_one());
+    CHECK_EQ(m_sched.count, 1);
+    CHECK(sched_run_one());
+    CHECK_EQ(m_sched.count, 0);
+    CHECK_EQ(m_rng_calls, 4);
+
+    // The ready pair is taken without drawing, the next one is computed by the scheduler.
+    m_rng_calls = 0;
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK_EQ(m_rng_calls, 0);
+    check_keypair(sk, pk);
+    CHECK_EQ(m_sched.count, 1);
+    sched_run_all();
+    CHECK(m_rng_calls > 0);
+
+    m_rng_calls = 0;
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk_2, (uint8_t *)pk_2), NRF_SUCCESS);
+    CHECK_EQ(m_rng_calls, 0);
+    check_keypair(sk_2, pk_2);
+    CHECK(memcmp(sk, sk_2, sizeof(sk)) != 0);
+
+    // Taken again before the scheduler ran: computed in the call, and still one job queued.
+    m_rng_calls = 0;
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK(m_rng_calls > 0);
+    check_keypair(sk, pk);
+    CHECK_EQ(m_sched.count, 1);
+    sched_run_all();
+    m_rng_calls = 0;
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK_EQ(m_rng_calls, 0);
+
+    // A job that cannot queue its next step leaves the module without a pair. The next take
+    // computes in the call and queues a job again.
+    m_sched.full = true;
+    CHECK(sched_run_one());
+    CHECK_EQ(m_sched.count, 0);
+    m_sched.full = false;
+    m_rng_calls  = 0;
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK(m_rng_calls > 0);
+    check_keypair(sk, pk);
+    CHECK_EQ(m_sched.count, 1);
+    sched_run_all();
+}
+
+
+static void test_shared_secret_async(void)
+{
+    uint32_t ss[ECC_P256_SK_LEN / sizeof(uint32_t)] = {0};
+    uint32_t ss_2[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t zero[ECC_P256_SK_LEN / sizeof(uint32_t)] = {0};
+    int      context;
+
+    uint32_t sk[ECC_P256_SK_LEN / sizeof(uint32_t)];
+    uint32_t pk[ECC_P256_PK_LEN / sizeof(uint32_t)];
+
+    // Taking a pair queues the next one at the lowest priority, the shared secret runs first.
+    memset(&m_ss, 0, sizeof(m_ss));
+    CHECK_EQ(ecc_p256_keypair_gen((uint8_t *)sk, (uint8_t *)pk), NRF_SUCCESS);
+    CHECK_EQ(ecc_p256_shared_secret_compute_async((uint8_t *)m_keys.sk_a, (uint8_t *)m_keys.pk_b,
+                                                  (uint8_t *)ss, ss_handler, &context),
+             NRF_SUCCESS);
+    CHECK_EQ(ecc_p256_shared_secret_compute_async((uint8_t *)m_keys.sk_b, (uint8_t *)m_keys.pk_a,
+                                                  (uint8_t *)ss_2, ss_handler, NULL),
+             NRF_ERROR_BUSY);
+    CHECK_EQ(m_ss.count, 0);
+
+    CHECK(sched_run_one());
+    CHECK_EQ(m_ss.count, 1);
+    CHECK_EQ(m_ss.result, NRF_SUCCESS);
+    CHECK(m_ss.p_le_ss == (uint8_t *)ss);
+    CHECK(m_ss.p_context == &context);
+    CHECK(memcmp(ss, m_keys.dhkey, sizeof(ss)) == 0);
+    sched_run_all();
+
+    // A failure is reported through the handler.
+    CHECK_EQ(ecc_p256_shared_secret_compute_async((uint8_t *)zero, (uint8_t *)m_keys.pk_b,
+                                                  (uint8_t *)ss, ss_handler, NULL), NRF_SUCCESS);
+    sched_run_all();
+    CHECK_EQ(m_ss.count, 2);
+    CHECK_EQ(m_ss.result, NRF_ERROR_INTERNAL);
+
+    // A full scheduler queue is reported by the call.
+    m_sched.full = true;
+    CHECK_EQ(ecc_p256_shared_secret_compute_async((uint8_t *)m_keys.sk_b, (uint8_t *)m_keys.pk_a,
+                                                  (uint8_t *)ss, ss_handler, NULL), NRF_ERROR_NO_MEM);
+    m_sched.full = false;
+    CHECK_EQ(m_sched.count, 0);
+
+    CHECK_EQ(ecc_p256_shared_secret_compute_async((uint8_t *)m_keys.sk_b, (uint8_t *)m_keys.pk_a,
+                                                  (uint8_t *)ss, ss_handler, NULL), NRF_SUCCESS);
+    sched_run_all();
+    CHECK_EQ(m_ss.count, 3);
+    CHECK_EQ(m_ss.result, NRF_SUCCESS);
+    CHECK(memcmp(ss, m_keys.dhkey, sizeof(ss)) == 0);
+}
+
+
+int main(void)
+{
+    reverse_copy(m_keys.sk_a, m_sk_a_be, ECC_P256_SK_LEN);
+    reverse_copy(m_keys.sk_b, m_sk_b_be, ECC_P256_SK_LEN);
+    pk_copy(m_keys.pk_a, m_pk_a_be);
+    pk_copy(m_keys.pk_b, m_pk_b_be);
+    reverse_copy(m_keys.dhkey, m_dhkey_be, ECC_P256_SK_LEN);
+
+    ecc_init();
+
+    test_known_answers();
+    test_invalid_arguments();
+    test_keypair_sync();
+    test_keypair_precompute();
+    test_shared_secret_async();
+
+    return UNIT_TEST_RESULT();
+}
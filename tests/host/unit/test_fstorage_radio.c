@@ -0,0 +1,560 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief fstorage scheduling against simulated radio activity.
+ *
+ * @details The test plays the SoftDevice on a timeline in microseconds. While connected, the
+ *          radio is busy for RADIO_EVENT_US at every connection event, with the radio
+ *          notifications NOTIFICATION_DISTANCE_US before and right after it. A flash access that
+ *          runs into a radio event fails with NRF_EVT_FLASH_OPERATION_ERROR when the event
+ *          starts, one started inside a radio event fails when the event ends. Flash accesses
+ *          take the worst-case times of fstorage_config.h.
+ *
+ *          An aware run reports the connection interval and forwards the radio notifications to
+ *          fstorage, as an application does. A naive run keeps them from fstorage.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_soc.h"
+#include "fstorage.h"
+#include "fstorage_config.h"
+
+#define PAGE_SIZE                   4096
+#define PAGE_WORDS                  (PAGE_SIZE / sizeof(uint32_t))
+#define CODE_PAGES                  128
+#define FLASH_END                   (CODE_PAGES * PAGE_SIZE)
+#define FLASH_PAGES                 3                           /**< Pages of the two users. */
+#define FLASH_BASE                  (FLASH_END - FLASH_PAGES * PAGE_SIZE)
+
+#define RADIO_EVENT_US              1500
+#define NOTIFICATION_DISTANCE_US    800
+#define STORE_WORDS                 512
+
+/**@brief State of the simulated SoftDevice. */
+static struct
+{
+    uint64_t         now;
+    uint32_t         interval;          /**< Connection interval, zero when not connected. */
+    bool             aware;             /**< Interval and notifications are passed to fstorage. */
+    uint64_t         next_event;        /**< Start of the next connection event. */
+    bool             active_sent;       /**< The notification before next_event was sent. */
+    bool             flash_busy;
+    uint64_t         flash_end;
+    uint32_t         flash_result;
+    uint32_t       * p_write_dst;       /**< Write in progress, NULL for an erase. */
+    uint32_t const * p_write_src;
+    uint32_t         write_words;
+    uint32_t         erase_page;
+    uint64_t         first_erase_time;  /**< Time of the first erase attempt since the reset. */
+    uint32_t         flash_ops;
+    uint32_t         flash_errors;
+} m_sim;
+
+/**@brief Events received by one user. */
+typedef struct
+{
+    uint32_t count;
+    fs_evt_t evt;
+    fs_ret_t result;
+} user_t;
+
+static uint32_t m_flash[FLASH_PAGES * PAGE_WORDS];
+static uint32_t m_data[STORE_WORDS];
+static user_t   m_user_a;
+static user_t   m_user_b;
+
+
+static void user_record(user_t * p_user, fs_evt_t const * const p_evt, fs_ret_t result)
+{
+    p_user->count++;
+    p_user->evt    = *p_evt;
+    p_user->result = result;
+}
+
+
+static void fs_evt_handler_a(fs_evt_t const * const p_evt, fs_ret_t result)
+{
+    user_record(&m_user_a, p_evt, result);
+}
+
+
+static void fs_evt_handler_b(fs_evt_t const * const p_evt, fs_ret_t result)
+{
+    user_record(&m_user_b, p_evt, result);
+}
+
+
+// The host linker only provides the bounds of sections named like C identifiers, so the
+// configurations are placed in "fs_data" directly instead of through FS_REGISTER_CFG.
+static fs_config_t m_cfg_a __attribute__((section("fs_data"), used)) =
+{
+    .callback  = fs_evt_handler_a,
+    .num_pages = 2,
+    .priority  = 0xFE,
+};
+
+static fs_config_t m_cfg_b __attribute__((section("fs_data"), used)) =
+{
+    .callback  = fs_evt_handler_b,
+    .num_pages = 1,
+    .priority  = 0xFD,
+};
+
+
+static uint32_t * flash_ptr(uint32_t address)
+{
+    if ((address < FLASH_BASE) || (address >= FLASH_END))
+    {
+        return NULL;
+    }
+    return &m_flash[(address - FLASH_BASE) / sizeof(uint32_t)];
+}
+
+
+/**@brief Function for scheduling the end of a flash access of the given duration. */
+static void flash_access_start(uint32_t duration_us)
+{
+    m_sim.flash_busy   = true;
+    m_sim.flash_ops++;
+    m_sim.flash_result = NRF_EVT_FLASH_OPERATION_SUCCESS;
+    m_sim.flash_end    = m_sim.now + duration_us;
+
+    if (m_sim.interval == 0)
+    {
+        return;
+    }
+
+    // The radio is busy from the start of every connection event for RADIO_EVENT_US. The
+    // event at next_event is the first one which has not ended.
+    uint64_t const event_start = m_sim.next_event;
+
+    if (m_sim.now >= event_start)
+    {
+        m_sim.flash_result = NRF_EVT_FLASH_OPERATION_ERROR;
+        m_sim.flash_end    = event_start + RADIO_EVENT_US;
+    }
+    else if (m_sim.flash_end > event_start)
+    {
+        m_sim.flash_result = NRF_EVT_FLASH_OPERATION_ERROR;
+        m_sim.flash_end    = event_start;
+    }
+}
+
+
+uint32_t sd_flash_write(uint32_t * const p_dst, uint32_t const * const p_src, uint32_t size)
+{
+    uint32_t * p_flash = flash_ptr((uint32_t)(uintptr_t)p_dst);
+
+    CHECK(p_flash != NULL);
+    CHECK(flash_ptr((uint32_t)(uintptr_t)(p_dst + size) - sizeof(uint32_t)) != NULL);
+    if (m_sim.flash_busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    m_sim.p_write_dst = p_flash;
+    m_sim.p_write_src = p_src;
+    m_sim.write_words = size;
+    flash_access_start(size * FS_WORD_WRITE_TIME_US);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_flash_page_erase(uint32_t page_number)
+{
+    CHECK(flash_ptr(page_number * PAGE_SIZE) != NULL);
+    if (m_sim.flash_busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    if (m_sim.first_erase_time == 0)
+    {
+        m_sim.first_erase_time = m_sim.now;
+    }
+    m_sim.p_write_dst = NULL;
+    m_sim.erase_page  = page_number;
+    flash_access_start(FS_PAGE_ERASE_TIME_US);
+    return NRF_SUCCESS;
+}
+
+
+static void flash_access_end(void)
+{
+    m_sim.now        = m_sim.flash_end;
+    m_sim.flash_busy = false;
+
+    if (m_sim.flash_result == NRF_EVT_FLASH_OPERATION_ERROR)
+    {
+        m_sim.flash_errors++;
+    }
+    else if (m_sim.p_write_dst != NULL)
+    {
+        // Writing can only clear bits.
+        for (uint32_t i = 0; i < m_sim.write_words; i++)
+        {
+            m_sim.p_write_dst[i] &= m_sim.p_write_src[i];
+        }
+    }
+    else
+    {
+        memset(flash_ptr(m_sim.erase_page * PAGE_SIZE), 0xFF, PAGE_SIZE);
+    }
+
+    fs_sys_event_handler(m_sim.flash_result);
+}
+
+
+/**@brief Function for running the timeline until the given time, or until the given number of
+ *        radio events have ended.
+ */
+static void sim_run(uint64_t until, uint32_t radio_events)
+{
+    for (;;)
+    {
+        uint64_t notification = UINT64_MAX;
+
+        if (m_sim.interval != 0)
+        {
+            notification = m_sim.active_sent ? (m_sim.next_event + RADIO_EVENT_US) :
+                                               (m_sim.next_event - NOTIFICATION_DISTANCE_US);
+        }
+
+        // A radio notification is handled before a flash access which ends at the same time.
+        if (m_sim.flash_busy && (m_sim.flash_end < notification) && (m_sim.flash_end <= until))
+        {
+            flash_access_end();
+        }
+        else if ((notification != UINT64_MAX) && (notification <= until) && (radio_events > 0))
+        {
+            m_sim.now         = notification;
+            m_sim.active_sent = !m_sim.active_sent;
+            if (!m_sim.active_sent)
+            {
+                m_sim.next_event += m_sim.interval;
+                radio_events--;
+            }
+            if (m_sim.aware)
+            {
+                fs_radio_notification_evt_handler(m_sim.active_sent);
+            }
+        }
+        else
+        {
+            if (until != UINT64_MAX)
+            {
+                m_sim.now = until;
+            }
+            return;
+        }
+    }
+}
+
+
+static void sim_run_until(uint64_t time)
+{
+    sim_run(time, UINT32_MAX);
+}
+
+
+static void sim_run_events(uint32_t radio_events)
+{
+    sim_run(UINT64_MAX, radio_events);
+}
+
+
+static void sim_connect(uint32_t interval_us, bool aware)
+{
+    m_sim.interval    = interval_us;
+    m_sim.aware       = aware;
+    m_sim.next_event  = m_sim.now + interval_us;
+    m_sim.active_sent = false;
+    if (aware)
+    {
+        fs_radio_conn_interval_set(interval_us);
+    }
+}
+
+
+/**@brief Function for changing the connection interval. The next connection event keeps its time,
+ *        the following ones are spaced by the new interval.
+ */
+static void sim_conn_update(uint32_t interval_us)
+{
+    m_sim.interval = interval_us;
+    if (m_sim.aware)
+    {
+        fs_radio_conn_interval_set(interval_us);
+    }
+}
+
+
+static void sim_disconnect(void)
+{
+    // Let operations which are still queued complete before the next scenario.
+    sim_run_events(2);
+    m_sim.interval = 0;
+    if (m_sim.aware)
+    {
+        fs_radio_conn_interval_set(0);
+    }
+    sim_run_until(UINT64_MAX);
+}
+
+
+/**@brief Function for starting a scenario with a clean flash and fresh counters. */
+static void scenario_start(void)
+{
+    uint32_t count;
+
+    CHECK_EQ(fs_queued_op_count_get(&count), FS_SUCCESS);
+    CHECK_EQ(count, 0);
+    CHECK(!m_sim.flash_busy);
+
+    memset(m_flash, 0xFF, sizeof(m_flash));
+    memset(&m_user_a, 0, sizeof(m_user_a));
+    memset(&m_user_b, 0, sizeof(m_user_b));
+    m_sim.flash_ops        = 0;
+    m_sim.flash_errors     = 0;
+    m_sim.first_erase_time = 0;
+    m_sim.now             += 1000000;
+}
+
+
+static void stats_get(fs_stats_t * p_stats)
+{
+    CHECK_EQ(fs_stats_get(p_stats), FS_SUCCESS);
+}
+
+
+static void test_init(void)
+{
+    host_periph_reset();
+    host_NRF_UICR.NRFFW[0] = 0xFFFFFFFF;
+    host_NRF_FICR.CODESIZE = CODE_PAGES;
+
+    CHECK_EQ(fs_init(), FS_SUCCESS);
+    CHECK_EQ((uintptr_t)m_cfg_a.p_end_addr,   FLASH_END);
+    CHECK_EQ((uintptr_t)m_cfg_a.p_start_addr, FLASH_END - 2 * PAGE_SIZE);
+    CHECK_EQ((uintptr_t)m_cfg_b.p_end_addr,   FLASH_END - 2 * PAGE_SIZE);
+    CHECK_EQ((uintptr_t)m_cfg_b.p_start_addr, FLASH_BASE);
+
+    for (uint32_t i = 0; i < STORE_WORDS; i++)
+    {
+        m_data[i] = 0x5A000000 | (i * 2654435761u >> 8);
+    }
+}
+
+
+static void store_check(uint32_t const * p_dest, uint32_t words)
+{
+    CHECK(memcmp(flash_ptr((uint32_t)(uintptr_t)p_dest), m_data, words * sizeof(uint32_t)) == 0);
+}
+
+
+static void test_idle_radio(void)
+{
+    uint32_t const * p_dest = m_cfg_a.p_start_addr;
+
+    // Not connected, a store starts right away and is written in one access.
+    scenario_start();
+    CHECK_EQ(fs_store(&m_cfg_a, p_dest, m_data, STORE_WORDS), FS_SUCCESS);
+    CHECK(m_sim.flash_busy);
+    sim_run_until(UINT64_MAX);
+    CHECK_EQ(m_user_a.count, 1);
+    CHECK_EQ(m_user_a.result, FS_SUCCESS);
+    CHECK_EQ(m_sim.flash_ops, 1);
+    store_check(p_dest, STORE_WORDS);
+
+    // Connected, but before the first radio notification: no prediction yet, so the store
+    // still starts right away.
+    scenario_start();
+    sim_connect(200000, true);
+    CHECK_EQ(fs_store(&m_cfg_a, p_dest, m_data, 64), FS_SUCCESS);
+    CHECK(m_sim.flash_busy);
+    sim_run_events(1);
+    CHECK_EQ(m_user_a.result, FS_SUCCESS);
+    CHECK_EQ(m_sim.flash_errors, 0);
+    sim_disconnect();
+}
+
+
+static void test_store_chunks(void)
+{
+    uint32_t const * p_dest = m_cfg_a.p_start_addr + PAGE_WORDS;
+    fs_stats_t       before;
+    fs_stats_t       after;
+
+    // 7.5 ms interval: the store is written in chunks between the connection events, and
+    // starts in the idle window after the request.
+    scenario_start();
+    stats_get(&before);
+    sim_connect(7500, true);
+    sim_run_events(2);
+    sim_run_until(m_sim.now + 3000);
+    CHECK_EQ(fs_store(&m_cfg_a, p_dest, m_data, STORE_WORDS), FS_SUCCESS);
+    CHECK(!m_sim.flash_busy);
+    sim_run_events(20);
+    stats_get(&after);
+
+    CHECK_EQ(m_user_a.count, 1);
+    CHECK_EQ(m_user_a.result, FS_SUCCESS);
+    CHECK_EQ(m_user_a.evt.store.length_words, STORE_WORDS);
+    store_check(p_dest, STORE_WORDS);
+    CHECK_EQ(m_sim.flash_errors, 0);
+    CHECK_EQ(after.flash_errors - before.flash_errors, 0);
+    CHECK_EQ(m_sim.flash_ops, (STORE_WORDS + 72) / 73);  // (7500 - 2500) / 68 words per window.
+    CHECK_EQ(after.ops_completed - before.ops_completed, 1);
+    sim_disconnect();
+}
+
+
+static void test_store_naive(void)
+{
+    uint32_t const * p_dest = m_cfg_a.p_start_addr + PAGE_WORDS;
+    fs_stats_t       before;
+    fs_stats_t       after;
+
+    // The same store without the radio information runs into a connection event on every
+    // attempt, and is given up once the retries are exhausted.
+    scenario_start();
+    stats_get(&before);
+    sim_connect(7500, false);
+    sim_run_events(2);
+    sim_run_until(m_sim.now + 3000);
+    CHECK_EQ(fs_store(&m_cfg_a, p_dest, m_data, STORE_WORDS), FS_SUCCESS);
+    sim_run_events(20);
+    stats_get(&after);
+
+    CHECK_EQ(m_user_a.count, 1);
+    CHECK_EQ(m_user_a.result, FS_ERR_OPERATION_TIMEOUT);
+    CHECK_EQ(m_sim.flash_errors, FS_OP_MAX_RETRIES + 1);
+    CHECK_EQ(after.flash_errors - before.flash_errors, FS_OP_MAX_RETRIES + 1);
+    CHECK_EQ(after.ops_failed - before.ops_failed, 1);
+    sim_disconnect();
+}
+
+
+/**@brief Function for erasing a page of user A at 200 ms, 150 ms into an idle window. */
+static void erase_late_in_window(bool aware)
+{
+    uint32_t const * p_page = m_cfg_a.p_start_addr;
+
+    scenario_start();
+    *flash_ptr((uint32_t)(uintptr_t)p_page) = 0;
+    sim_connect(200000, aware);
+    sim_run_events(2);
+    sim_run_until(m_sim.now + 150000);
+    CHECK_EQ(fs_erase(&m_cfg_a, p_page, 1), FS_SUCCESS);
+    sim_run_events(4);
+
+    CHECK_EQ(m_user_a.count, 1);
+    CHECK_EQ(m_user_a.result, FS_SUCCESS);
+    CHECK_EQ(m_user_a.evt.id, FS_EVT_ERASE);
+    CHECK_EQ(*flash_ptr((uint32_t)(uintptr_t)p_page), 0xFFFFFFFF);
+    sim_disconnect();
+}
+
+
+static void test_erase_windows(void)
+{
+    // Aware, the erase waits for the next window, which is long enough for it.
+    erase_late_in_window(true);
+    CHECK_EQ(m_sim.flash_errors, 0);
+    CHECK_EQ(m_sim.flash_ops, 1);
+
+    // Naive, it runs into the next connection event, is retried inside it and only then fits.
+    erase_late_in_window(false);
+    CHECK_EQ(m_sim.flash_errors, 2);
+    CHECK_EQ(m_sim.flash_ops, 3);
+}
+
+
+static void test_erase_deferred(void)
+{
+    fs_stats_t before;
+    fs_stats_t after;
+
+    // 30 ms interval: the idle windows are too short for an erase, which is held back while a
+    // store of the other user goes through.
+    scenario_start();
+    stats_get(&before);
+    sim_connect(30000, true);
+    sim_run_events(1);
+    CHECK_EQ(fs_erase(&m_cfg_a, m_cfg_a.p_start_addr, 1), FS_SUCCESS);
+    CHECK_EQ(fs_store(&m_cfg_b, m_cfg_b.p_start_addr, m_data, 64), FS_SUCCESS);
+    sim_run_events(10);
+    stats_get(&after);
+
+    CHECK_EQ(m_user_b.count, 1);
+    CHECK_EQ(m_user_b.result, FS_SUCCESS);
+    store_check(m_cfg_b.p_start_addr, 64);
+    CHECK_EQ(m_user_a.count, 0);
+    CHECK_EQ(m_sim.first_erase_time, 0);
+    CHECK_EQ(after.erase_deferrals - before.erase_deferrals, 10);
+
+    // The peer moves to a 200 ms interval, the erase goes in the first long window.
+    sim_conn_update(200000);
+    sim_run_events(2);
+    CHECK_EQ(m_user_a.count, 1);
+    CHECK_EQ(m_user_a.result, FS_SUCCESS);
+    CHECK_EQ(m_sim.flash_errors, 0);
+    sim_disconnect();
+}
+
+
+static void test_erase_deadline(void)
+{
+    uint64_t   requested;
+    uint32_t   max_wait = (FS_ERASE_MAX_DEFER_MS * 1000) / 30000;
+    fs_stats_t stats;
+
+    // The interval stays at 30 ms: the erase is attempted regardless once it is overdue, and
+    // is reported as failed when it never fits.
+    scenario_start();
+    sim_connect(30000, true);
+    sim_run_events(1);
+    requested = m_sim.now;
+    CHECK_EQ(fs_erase(&m_cfg_b, m_cfg_b.p_start_addr, 1), FS_SUCCESS);
+    sim_run_events(max_wait - 1);
+    CHECK_EQ(m_sim.first_erase_time, 0);
+    sim_run_events(10);
+    stats_get(&stats);
+
+    CHECK(m_sim.first_erase_time - requested >= (uint64_t)(max_wait - 1) * 30000);
+    CHECK_EQ(m_user_b.count, 1);
+    CHECK_EQ(m_user_b.result, FS_ERR_OPERATION_TIMEOUT);
+    CHECK_EQ(m_sim.flash_errors, FS_OP_MAX_RETRIES + 1);
+    CHECK(stats.wait_events_max >= max_wait);
+    sim_disconnect();
+}
+
+
+int main(void)
+{
+    test_init();
+    test_idle_radio();
+    test_store_chunks();
+    test_store_naive();
+    test_erase_windows();
+    test_erase_deferred();
+    test_erase_deadline();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,165 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Softblink ramps compared with the duty cycles of the timer based implementation.
+ *
+ * @details timer_model_step() is the stepping of led_softblink_on_timeout(), which runs once per
+ *          PWM period. Played in a loop, a ramp followed by its off periods must give the same
+ *          duty cycle for every period.
+ */
+
+#include "unit_test.h"
+#include "led_softblink.h"
+
+#define PWM_PERIOD              255     /**< Period used by led_softblink.c. */
+#define TIMER_MIN_TICKS         5       /**< APP_TIMER_MIN_TIMEOUT_TICKS. */
+#define MAX_CYCLE               4096
+
+/**@brief State of the timer based implementation. */
+typedef struct
+{
+    bool     counting_up;
+    int32_t  duty;
+    int32_t  pause_ticks;
+} timer_model_t;
+
+
+/**@brief Function for computing the duty cycle of the next period, as led_softblink_on_timeout(). */
+static uint8_t timer_model_step(timer_model_t * p_model, led_sb_init_params_t const * p_params)
+{
+    if (p_model->pause_ticks <= 0)
+    {
+        if (p_model->counting_up)
+        {
+            if (p_model->duty >= (p_params->duty_cycle_max - p_params->duty_cycle_step))
+            {
+                p_model->counting_up = false;
+                p_model->duty        = p_params->duty_cycle_max;
+                p_model->pause_ticks = p_params->on_time_ticks ?
+                                       (int32_t)p_params->on_time_ticks + TIMER_MIN_TICKS : 0;
+            }
+            else
+            {
+                p_model->duty += p_params->duty_cycle_step;
+            }
+        }
+        else
+        {
+            if (p_model->duty <= (p_params->duty_cycle_min + p_params->duty_cycle_step))
+            {
+                p_model->counting_up = true;
+                p_model->duty        = p_params->duty_cycle_min;
+                p_model->pause_ticks = p_params->off_time_ticks ?
+                                       (int32_t)p_params->off_time_ticks + TIMER_MIN_TICKS : 0;
+            }
+            else
+            {
+                p_model->duty -= p_params->duty_cycle_step;
+            }
+        }
+    }
+    else
+    {
+        p_model->pause_ticks -= PWM_PERIOD;
+    }
+    return (uint8_t)p_model->duty;
+}
+
+
+static void ramp_check(uint8_t min, uint8_t max, uint8_t step, uint32_t on_ticks, uint32_t off_ticks)
+{
+    led_sb_init_params_t params = {
+        .duty_cycle_min  = min,
+        .duty_cycle_max  = max,
+        .duty_cycle_step = step,
+        .on_time_ticks   = on_ticks,
+        .off_time_ticks  = off_ticks,
+    };
+    static uint8_t ramp[MAX_CYCLE];
+    uint16_t       len;
+    uint32_t       off_periods;
+    timer_model_t  model = {.counting_up = true, .duty = min, .pause_ticks = 0};
+    uint32_t       mismatches = 0;
+
+    CHECK_EQ(led_softblink_ramp_build(&params, PWM_PERIOD, ramp, MAX_CYCLE, &len, &off_periods),
+             NRF_SUCCESS);
+    CHECK(len > 0);
+    CHECK_EQ(ramp[len - 1], min);
+
+    // Two full cycles, starting with the first step up from the minimum.
+    for (uint32_t cycle = 0; cycle < 2; cycle++)
+    {
+        for (uint32_t i = 0; i < len + off_periods; i++)
+        {
+            uint8_t expected = (i < len) ? ramp[i] : min;
+            if (timer_model_step(&model, &params) != expected)
+            {
+                mismatches++;
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+
+static void test_patterns(void)
+{
+    // Defaults of LED_SB_INIT_DEFAULT_PARAMS: 0 to 220 in steps of 5, 1 and 2 s at 32768 Hz.
+    ramp_check(0, 220, 5, 32768, 65536);
+
+    ramp_check(0, 255, 1, 0, 0);
+    ramp_check(0, 255, 255, 0, 0);
+    ramp_check(10, 200, 7, 0, 100);
+    ramp_check(10, 200, 7, 100, 0);
+    ramp_check(10, 200, 190, 1, 1);
+    ramp_check(100, 101, 1, PWM_PERIOD, PWM_PERIOD - TIMER_MIN_TICKS);
+    ramp_check(0, 250, 100, 2 * PWM_PERIOD, 2 * PWM_PERIOD - TIMER_MIN_TICKS + 1);
+}
+
+
+static void test_length(void)
+{
+    led_sb_init_params_t params = {
+        .duty_cycle_min  = 0,
+        .duty_cycle_max  = 100,
+        .duty_cycle_step = 10,
+        .on_time_ticks   = 3 * PWM_PERIOD,
+        .off_time_ticks  = 0,
+    };
+    uint8_t  ramp[32];
+    uint16_t len;
+    uint32_t off_periods;
+
+    // 10 steps up, 4 periods held at the maximum, 10 steps down.
+    CHECK_EQ(led_softblink_ramp_build(&params, PWM_PERIOD, ramp, sizeof(ramp), &len, &off_periods),
+             NRF_SUCCESS);
+    CHECK_EQ(len, 24);
+    CHECK_EQ(off_periods, 0);
+
+    CHECK_EQ(led_softblink_ramp_build(&params, PWM_PERIOD, ramp, 24, &len, &off_periods),
+             NRF_SUCCESS);
+    CHECK_EQ(led_softblink_ramp_build(&params, PWM_PERIOD, ramp, 23, &len, &off_periods),
+             NRF_ERROR_NO_MEM);
+    CHECK_EQ(led_softblink_ramp_build(&params, PWM_PERIOD, ramp, 0, &len, &off_periods),
+             NRF_ERROR_NO_MEM);
+}
+
+
+int main(void)
+{
+    test_patterns();
+    test_length();
+
+    return UNIT_TEST_RESULT();
+}
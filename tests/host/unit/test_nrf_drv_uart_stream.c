@@ -0,0 +1,364 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Continuous UARTE reception: byte order, buffer halves held by the user and stalls.
+ *
+ * @details The test plays the UARTE EasyDMA receiver: RXD.PTR is latched by STARTRX, the
+ *          ENDRX_STARTRX shortcut starts the next transfer, and bytes that arrive while no
+ *          transfer runs wait in the UARTE until the next STARTRX. TIMER1 counts the bytes as the
+ *          PPI would, and TIMER2 expires when the test says the line is idle.
+ */
+
+#include <string.h>
+#include "unit_test.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "app_util_platform.h"
+#include "nrf_drv_uart.h"
+
+#define STREAM_LENGTH   16                  /**< Two halves of 8 bytes. */
+#define HALF_LENGTH     (STREAM_LENGTH / 2)
+#define IDLE_TIMEOUT_US 100
+#define MAX_CHUNKS      16
+#define MAX_BYTES       1024
+
+void UART0_IRQHandler(void);
+void TIMER2_IRQHandler(void);
+
+/**@brief State of the EasyDMA receiver. */
+static struct
+{
+    bool      running;                      /**< A transfer is running. */
+    uint8_t * p_dma;                        /**< RXD.PTR latched at the start of the transfer. */
+    uint32_t  maxcnt;
+    uint32_t  amount;
+    uint8_t   fifo[32];                     /**< Bytes received while no transfer runs. */
+    uint32_t  fifo_length;
+    uint32_t  startrx_count;                /**< STARTRX tasks triggered by the driver. */
+} m_hw;
+
+/**@brief Chunk reported by the driver and not released yet. */
+typedef struct
+{
+    uint8_t const * p_data;
+    size_t          length;
+    uint8_t         copy[STREAM_LENGTH];    /**< Content when reported. */
+} held_chunk_t;
+
+static uint8_t      m_stream_buffer[STREAM_LENGTH];
+static bool         m_release_in_handler;
+static held_chunk_t m_held[MAX_CHUNKS];
+static uint32_t     m_held_count;
+static uint32_t     m_chunk_count;
+static uint8_t      m_received[MAX_BYTES];  /**< Released data, in order. */
+static uint32_t     m_received_length;
+static uint8_t      m_sent[MAX_BYTES];      /**< Bytes put on the line. */
+static uint32_t     m_sent_length;
+
+
+static void received_append(uint8_t const * p_data, size_t length)
+{
+    CHECK(m_received_length + length <= MAX_BYTES);
+    memcpy(&m_received[m_received_length], p_data, length);
+    m_received_length += length;
+}
+
+
+static void uart_event_handler(nrf_drv_uart_event_t * p_event, void * p_context)
+{
+    if (p_event->type != NRF_DRV_UART_EVT_RX_DONE)
+    {
+        return;
+    }
+
+    m_chunk_count++;
+    CHECK(p_event->data.rxtx.bytes > 0);
+    CHECK(p_event->data.rxtx.bytes <= HALF_LENGTH);
+
+    if (m_release_in_handler)
+    {
+        received_append(p_event->data.rxtx.p_data, p_event->data.rxtx.bytes);
+        nrf_drv_uart_rx_stream_release();
+    }
+    else if (m_held_count < MAX_CHUNKS)
+    {
+        held_chunk_t * p_chunk = &m_held[m_held_count++];
+
+        p_chunk->p_data = p_event->data.rxtx.p_data;
+        p_chunk->length = p_event->data.rxtx.bytes;
+        memcpy(p_chunk->copy, p_chunk->p_data, p_chunk->length);
+    }
+}
+
+
+/**@brief Function for starting a transfer into the buffer given by RXD.PTR and RXD.MAXCNT. */
+static void hw_transfer_start(void)
+{
+    m_hw.p_dma   = (uint8_t *)(uintptr_t)NRF_UARTE0->RXD.PTR;
+    m_hw.maxcnt  = NRF_UARTE0->RXD.MAXCNT;
+    m_hw.amount  = 0;
+    m_hw.running = true;
+    NRF_UARTE0->EVENTS_RXSTARTED = 1;
+}
+
+
+static void hw_dma_write(uint8_t byte)
+{
+    m_hw.p_dma[m_hw.amount++] = byte;
+    if (m_hw.amount == m_hw.maxcnt)
+    {
+        m_hw.running           = false;
+        NRF_UARTE0->RXD.AMOUNT = m_hw.amount;
+        NRF_UARTE0->EVENTS_ENDRX = 1;
+        if (NRF_UARTE0->SHORTS & UARTE_SHORTS_ENDRX_STARTRX_Msk)
+        {
+            hw_transfer_start();
+        }
+    }
+}
+
+
+/**@brief Function for carrying out the tasks the driver triggered. */
+static void hw_tasks_run(void)
+{
+    if (NRF_UARTE0->TASKS_STARTRX)
+    {
+        NRF_UARTE0->TASKS_STARTRX = 0;
+        m_hw.startrx_count++;
+        hw_transfer_start();
+
+        // The bytes waiting in the UARTE go to the new buffer first.
+        uint32_t moved = 0;
+        while ((moved < m_hw.fifo_length) && m_hw.running)
+        {
+            hw_dma_write(m_hw.fifo[moved++]);
+        }
+        memmove(m_hw.fifo, &m_hw.fifo[moved], m_hw.fifo_length - moved);
+        m_hw.fifo_length -= moved;
+    }
+    if (NRF_UARTE0->TASKS_STOPRX)
+    {
+        NRF_UARTE0->TASKS_STOPRX = 0;
+        if (m_hw.running)
+        {
+            m_hw.running             = false;
+            NRF_UARTE0->RXD.AMOUNT   = m_hw.amount;
+            NRF_UARTE0->EVENTS_ENDRX = 1;
+        }
+        NRF_UARTE0->EVENTS_RXTO = 1;
+    }
+}
+
+
+/**@brief Function for running the UART interrupt while it has something to do. */
+static void irq_run(void)
+{
+    hw_tasks_run();
+    while (NRF_UARTE0->EVENTS_ENDRX || NRF_UARTE0->EVENTS_RXSTARTED ||
+           NRF_UARTE0->EVENTS_RXTO  || NVIC_GetPendingIRQ(UART0_IRQn))
+    {
+        NVIC_ClearPendingIRQ(UART0_IRQn);
+        UART0_IRQHandler();
+        hw_tasks_run();
+    }
+}
+
+
+/**@brief Function for receiving bytes on the line, each one is handled by the UART interrupt. */
+static void line_receive(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t byte = (uint8_t)(m_sent_length * 7 + 3);
+
+        m_sent[m_sent_length++] = byte;
+        NRF_TIMER1->CC[0]       = m_sent_length;    // RXDRDY counted through the PPI.
+        if (m_hw.running)
+        {
+            hw_dma_write(byte);
+        }
+        else
+        {
+            CHECK(m_hw.fifo_length < sizeof(m_hw.fifo));
+            m_hw.fifo[m_hw.fifo_length++] = byte;
+        }
+        irq_run();
+    }
+}
+
+
+/**@brief Function for letting the idle timer expire. */
+static void line_idle(void)
+{
+    NRF_TIMER2->EVENTS_COMPARE[0] = 1;
+    TIMER2_IRQHandler();
+    irq_run();
+}
+
+
+/**@brief Function for checking that the held chunks were not overwritten, then releasing them. */
+static void held_release(void)
+{
+    for (uint32_t i = 0; i < m_held_count; i++)
+    {
+        CHECK(memcmp(m_held[i].p_data, m_held[i].copy, m_held[i].length) == 0);
+        received_append(m_held[i].copy, m_held[i].length);
+    }
+    m_held_count = 0;
+    nrf_drv_uart_rx_stream_release();
+    irq_run();
+}
+
+
+static void received_check(void)
+{
+    CHECK_EQ(m_received_length, m_sent_length);
+    CHECK(memcmp(m_received, m_sent, m_sent_length) == 0);
+}
+
+
+static void stream_start(bool release_in_handler)
+{
+    nrf_drv_uart_config_t config = NRF_DRV_UART_DEFAULT_CONFIG;
+
+    host_periph_reset();
+    memset(&m_hw, 0, sizeof(m_hw));
+    m_release_in_handler = release_in_handler;
+    m_held_count         = 0;
+    m_chunk_count        = 0;
+    m_received_length    = 0;
+    m_sent_length        = 0;
+
+    CHECK_EQ(nrf_drv_uart_init(&config, uart_event_handler), NRF_SUCCESS);
+    CHECK_EQ(nrf_drv_uart_rx_stream_start(m_stream_buffer, sizeof(m_stream_buffer),
+                                          IDLE_TIMEOUT_US), NRF_SUCCESS);
+    irq_run();
+}
+
+
+static void stream_stop(void)
+{
+    nrf_drv_uart_rx_stream_stop();
+    irq_run();
+    nrf_drv_uart_uninit();
+}
+
+
+static void test_continuous(void)
+{
+    stream_start(true);
+
+    // Released from the handler, the halves alternate through the shortcut alone.
+    line_receive(100);
+    line_idle();
+    received_check();
+    CHECK_EQ(m_hw.startrx_count, 1);
+
+    // Partial halves reported on idle are completed by the next bytes.
+    line_receive(3);
+    line_idle();
+    line_receive(HALF_LENGTH);
+    line_idle();
+    received_check();
+    CHECK_EQ(m_hw.startrx_count, 1);
+
+    stream_stop();
+}
+
+
+static void test_held_halves(void)
+{
+    uint32_t chunks;
+
+    stream_start(false);
+
+    // The first half is held, so the second one is filled without the shortcut armed.
+    line_receive(HALF_LENGTH);
+    CHECK_EQ(m_held_count, 1);
+    CHECK_EQ(NRF_UARTE0->SHORTS & UARTE_SHORTS_ENDRX_STARTRX_Msk, 0);
+    line_receive(HALF_LENGTH);
+    CHECK_EQ(m_held_count, 2);
+
+    // Both halves held: reception stalls, the next bytes wait in the UARTE and the idle timer
+    // reports nothing.
+    line_receive(5);
+    CHECK(!m_hw.running);
+    CHECK_EQ(m_hw.fifo_length, 5);
+    chunks = m_chunk_count;
+    line_idle();
+    CHECK_EQ(m_chunk_count, chunks);
+    CHECK_EQ(m_hw.startrx_count, 1);
+
+    // Releasing restarts the reception with the waiting bytes first.
+    held_release();
+    CHECK(m_hw.running);
+    CHECK_EQ(m_hw.startrx_count, 2);
+    CHECK_EQ(m_hw.fifo_length, 0);
+
+    // The first half is released while the second one is filling, and is set up in time.
+    line_receive(3);
+    held_release();
+    CHECK_EQ(NRF_UARTE0->SHORTS & UARTE_SHORTS_ENDRX_STARTRX_Msk, UARTE_SHORTS_ENDRX_STARTRX_Msk);
+    line_receive(HALF_LENGTH);
+    line_receive(HALF_LENGTH + 2);
+    CHECK(!m_hw.running);
+    CHECK_EQ(m_hw.startrx_count, 2);
+
+    held_release();
+    line_idle();
+    held_release();
+    received_check();
+    CHECK_EQ(m_hw.startrx_count, 3);
+
+    stream_stop();
+}
+
+
+static void test_late_release(void)
+{
+    stream_start(false);
+
+    // Released with room left in the second half: the first half follows through the shortcut.
+    line_receive(HALF_LENGTH + 3);
+    held_release();
+    line_receive(HALF_LENGTH - 3);
+    CHECK(m_hw.running);
+    CHECK_EQ(m_hw.startrx_count, 1);
+
+    // Released with less than RX_STREAM_ARM_MARGIN bytes left: the half ends without the
+    // shortcut and the reception restarts from the interrupt.
+    line_receive(HALF_LENGTH - 1);
+    held_release();
+    CHECK_EQ(NRF_UARTE0->SHORTS & UARTE_SHORTS_ENDRX_STARTRX_Msk, 0);
+    line_receive(1);
+    CHECK(m_hw.running);
+    CHECK_EQ(m_hw.startrx_count, 2);
+
+    line_receive(5);
+    line_idle();
+    held_release();
+    received_check();
+
+    stream_stop();
+}
+
+
+int main(void)
+{
+    test_continuous();
+    test_held_halves();
+    test_late_release();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,205 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief ESB TX slot reservation and RX slot borrowing, with the RADIO registers in RAM.
+ */
+
+#include "unit_test.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_esb.h"
+
+void RADIO_IRQHandler(void);
+
+
+static void esb_start(nrf_esb_mode_t mode, nrf_esb_tx_mode_t tx_mode)
+{
+    nrf_esb_config_t config = NRF_ESB_DEFAULT_CONFIG;
+
+    host_periph_reset();
+    config.mode               = mode;
+    config.tx_mode            = tx_mode;
+    config.selective_auto_ack = true;
+    CHECK_EQ(nrf_esb_init(&config), NRF_SUCCESS);
+}
+
+
+static void tx_count_check(uint32_t expected)
+{
+    nrf_esb_fifo_stats_t stats;
+
+    CHECK_EQ(nrf_esb_fifo_stats_get(&stats), NRF_SUCCESS);
+    CHECK_EQ(stats.tx_count, expected);
+}
+
+
+static void test_reserve_commit(void)
+{
+    nrf_esb_payload_t * p_slot;
+    nrf_esb_payload_t * p_again;
+    nrf_esb_payload_t   payload = {.length = 4, .pipe = 0};
+
+    esb_start(NRF_ESB_MODE_PTX, NRF_ESB_TXMODE_MANUAL);
+
+    CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_ERROR_INVALID_STATE);
+
+    CHECK_EQ(nrf_esb_tx_payload_reserve(&p_slot), NRF_SUCCESS);
+    CHECK_EQ(nrf_esb_tx_payload_reserve(&p_again), NRF_ERROR_BUSY);
+    CHECK_EQ(nrf_esb_write_payload(&payload), NRF_ERROR_BUSY);
+
+    p_slot->length = 4;
+    p_slot->pipe   = 0;
+    CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_SUCCESS);
+    tx_count_check(1);
+
+    // A second commit without a reservation does nothing.
+    CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_ERROR_INVALID_STATE);
+    tx_count_check(1);
+
+    // Discarding releases the slot without queuing it.
+    CHECK_EQ(nrf_esb_tx_payload_reserve(&p_slot), NRF_SUCCESS);
+    CHECK_EQ(nrf_esb_tx_payload_commit(false), NRF_SUCCESS);
+    tx_count_check(1);
+    CHECK_EQ(nrf_esb_write_payload(&payload), NRF_SUCCESS);
+    tx_count_check(2);
+
+    (void)nrf_esb_disable();
+}
+
+
+static void test_invalid_commit_keeps_slot(void)
+{
+    nrf_esb_payload_t * p_slot;
+    nrf_esb_payload_t * p_again;
+
+    esb_start(NRF_ESB_MODE_PTX, NRF_ESB_TXMODE_MANUAL);
+
+    CHECK_EQ(nrf_esb_tx_payload_reserve(&p_slot), NRF_SUCCESS);
+
+    p_slot->length = 0;
+    p_slot->pipe   = 0;
+    CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_ERROR_INVALID_LENGTH);
+
+    p_slot->length = 4;
+    p_slot->pipe   = 9;                     // NRF_ESB_PIPE_COUNT of nrf_esb.c.
+    CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_ERROR_INVALID_PARAM);
+    tx_count_check(0);
+
+    // The slot is still reserved: no second reservation, and the corrected payload is queued.
+    CHECK_EQ(nrf_esb_tx_payload_reserve(&p_again), NRF_ERROR_BUSY);
+    p_slot->pipe = 1;
+    CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_SUCCESS);
+    tx_count_check(1);
+
+    // Every slot can still be filled, none was lost to the failed commits.
+    for (uint32_t i = 1; i < NRF_ESB_TX_FIFO_SIZE; i++)
+    {
+        CHECK_EQ(nrf_esb_tx_payload_reserve(&p_slot), NRF_SUCCESS);
+        p_slot->length = 4;
+        p_slot->pipe   = 0;
+        CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_SUCCESS);
+    }
+    tx_count_check(NRF_ESB_TX_FIFO_SIZE);
+    CHECK_EQ(nrf_esb_tx_payload_reserve(&p_slot), NRF_ERROR_NO_MEM);
+
+    (void)nrf_esb_disable();
+}
+
+
+static void test_tx_payload_sent(void)
+{
+    nrf_esb_payload_t * p_slot;
+    uint8_t const     * p_rf_buf;
+
+    esb_start(NRF_ESB_MODE_PTX, NRF_ESB_TXMODE_AUTO);
+
+    CHECK_EQ(nrf_esb_tx_payload_reserve(&p_slot), NRF_SUCCESS);
+    p_slot->length  = 3;
+    p_slot->pipe    = 2;
+    p_slot->noack   = true;
+    p_slot->data[0] = 0xA1;
+    p_slot->data[1] = 0xB2;
+    p_slot->data[2] = 0xC3;
+    CHECK_EQ(nrf_esb_tx_payload_commit(true), NRF_SUCCESS);
+
+    // The transmission started on commit: length, PID with the no-ACK bit, then the data.
+    CHECK_EQ(NRF_RADIO->TASKS_TXEN, 1);
+    CHECK_EQ(NRF_RADIO->TXADDRESS, 2);
+    p_rf_buf = (uint8_t const *)(uintptr_t)NRF_RADIO->PACKETPTR;
+    CHECK_EQ(p_rf_buf[0], 3);
+    CHECK_EQ(p_rf_buf[1], (1 << 1) | 0x01);
+    CHECK_EQ(p_rf_buf[2], 0xA1);
+    CHECK_EQ(p_rf_buf[4], 0xC3);
+
+    NRF_RADIO->EVENTS_DISABLED = 1;
+    RADIO_IRQHandler();
+    CHECK(nrf_esb_is_idle());
+    tx_count_check(0);
+
+    (void)nrf_esb_disable();
+}
+
+
+static void test_rx_borrow(void)
+{
+    nrf_esb_payload_t const * p_payload;
+    nrf_esb_payload_t         payload;
+    uint8_t                 * p_rf_buf;
+
+    esb_start(NRF_ESB_MODE_PRX, NRF_ESB_TXMODE_AUTO);
+    CHECK_EQ(nrf_esb_start_rx(), NRF_SUCCESS);
+    CHECK_EQ(nrf_esb_rx_payload_borrow(&p_payload), NRF_ERROR_NOT_FOUND);
+
+    for (uint8_t n = 0; n < 2; n++)
+    {
+        p_rf_buf = (uint8_t *)(uintptr_t)NRF_RADIO->PACKETPTR;
+        p_rf_buf[0] = 2;
+        p_rf_buf[1] = (uint8_t)(n << 1);
+        p_rf_buf[2] = 0x10 + n;
+        p_rf_buf[3] = 0x20 + n;
+        NRF_RADIO->CRCSTATUS = 1;
+        NRF_RADIO->RXCRC     = 0x100 + n;
+        NRF_RADIO->RXMATCH   = 0;
+
+        NRF_RADIO->EVENTS_DISABLED = 1;
+        RADIO_IRQHandler();
+        NRF_RADIO->EVENTS_DISABLED = 1;
+        RADIO_IRQHandler();
+    }
+
+    CHECK_EQ(nrf_esb_rx_payload_borrow(&p_payload), NRF_SUCCESS);
+    CHECK_EQ(p_payload->length, 2);
+    CHECK_EQ(p_payload->data[0], 0x10);
+    CHECK_EQ(nrf_esb_read_rx_payload(&payload), NRF_ERROR_BUSY);
+    CHECK_EQ(nrf_esb_rx_payload_release(), NRF_SUCCESS);
+    CHECK_EQ(nrf_esb_rx_payload_release(), NRF_ERROR_INVALID_STATE);
+
+    CHECK_EQ(nrf_esb_read_rx_payload(&payload), NRF_SUCCESS);
+    CHECK_EQ(payload.length, 2);
+    CHECK_EQ(payload.data[1], 0x21);
+    CHECK_EQ(nrf_esb_read_rx_payload(&payload), NRF_ERROR_NOT_FOUND);
+
+    (void)nrf_esb_disable();
+}
+
+
+int main(void)
+{
+    test_reserve_commit();
+    test_invalid_commit_keeps_slot();
+    test_tx_payload_sent();
+    test_rx_borrow();
+
+    return UNIT_TEST_RESULT();
+}
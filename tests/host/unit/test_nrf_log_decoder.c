@@ -0,0 +1,212 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Deferred log decoder: entry parsing and SEGGER_RTT_printf compatible formatting.
+ */
+
+#include "unit_test.h"
+#include "nrf_log_decoder.h"
+
+#define LEVEL_ERROR     1
+#define LEVEL_DEBUG     4
+
+/**@brief Strings of a pretend firmware image. */
+static struct
+{
+    uint32_t     address;
+    char const * p_str;
+} const m_strings[] =
+{
+    {0x1000, "plain\r\n"},
+    {0x2000, "%d %u %x %X %c %% end"},
+    {0x3000, "[%5d] [%-5d] [%05d] [%+d] [%.3u] [%08X]"},
+    {0x4000, "name=%s ptr=%p"},
+    {0x5000, "bob"},
+    {0x6000, "%d %d %d"},
+    {0x7000, "%q%d"},
+};
+
+
+static char const * string_get(uint32_t address, void * p_context)
+{
+    (void)p_context;
+    for (uint32_t i = 0; i < sizeof(m_strings) / sizeof(m_strings[0]); i++)
+    {
+        if (m_strings[i].address == address)
+        {
+            return m_strings[i].p_str;
+        }
+    }
+    return NULL;
+}
+
+
+static void word_put(uint8_t * p_buf, uint32_t word)
+{
+    p_buf[0] = (uint8_t)word;
+    p_buf[1] = (uint8_t)(word >> 8);
+    p_buf[2] = (uint8_t)(word >> 16);
+    p_buf[3] = (uint8_t)(word >> 24);
+}
+
+
+/**@brief Function for encoding an entry the way nrf_log.c writes it. */
+static size_t entry_put(uint8_t        * p_buf,
+                        uint32_t         format,
+                        uint32_t         timestamp,
+                        uint32_t         level,
+                        bool             is_string,
+                        uint32_t         num_args,
+                        uint32_t const * p_args)
+{
+    word_put(&p_buf[0], format);
+    word_put(&p_buf[4], (timestamp & 0x00FFFFFF) | (num_args << 24) | (level << 28) |
+                        (is_string ? (1UL << 31) : 0));
+    for (uint32_t i = 0; i < num_args; i++)
+    {
+        word_put(&p_buf[8 + 4 * i], p_args[i]);
+    }
+    return 8 + 4 * num_args;
+}
+
+
+static char const * format(uint32_t address, uint32_t num_args, uint32_t const * p_args)
+{
+    static char             line[128];
+    uint8_t                 buf[64];
+    nrf_log_decoder_entry_t entry;
+    size_t                  consumed = 0;
+    size_t                  len      = entry_put(buf, address, 0, LEVEL_DEBUG, false, num_args, p_args);
+
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, len, &entry, &consumed), NRF_SUCCESS);
+    CHECK_EQ(consumed, len);
+    (void)nrf_log_decoder_format(&entry, string_get, NULL, line, sizeof(line));
+    return line;
+}
+
+
+static void test_parse(void)
+{
+    uint8_t                 buf[64];
+    uint32_t const          args[6] = {1, 2, 3, 4, 5, 6};
+    nrf_log_decoder_entry_t entry;
+    size_t                  consumed;
+    size_t                  len;
+
+    len = entry_put(buf, 0x2000, 0xABCDEF, LEVEL_ERROR, false, 3, args);
+    CHECK_EQ(len, 20);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, len, &entry, &consumed), NRF_SUCCESS);
+    CHECK_EQ(entry.format, 0x2000);
+    CHECK_EQ(entry.timestamp, 0xABCDEF);
+    CHECK_EQ(entry.level, LEVEL_ERROR);
+    CHECK(!entry.is_string);
+    CHECK_EQ(entry.num_args, 3);
+    CHECK_EQ(entry.args[2], 3);
+    CHECK_EQ(consumed, 20);
+
+    // Every truncation asks for more data.
+    for (size_t i = 0; i < len; i++)
+    {
+        CHECK_EQ(nrf_log_decoder_entry_parse(buf, i, &entry, &consumed), NRF_ERROR_DATA_SIZE);
+    }
+
+    len = entry_put(buf, 0x1000, 1, LEVEL_DEBUG, true, 0, NULL);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, len, &entry, &consumed), NRF_SUCCESS);
+    CHECK(entry.is_string);
+    CHECK_EQ(consumed, 8);
+
+    len = entry_put(buf, 0x2000, 0, LEVEL_DEBUG, false, 6, args);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, len, &entry, &consumed), NRF_SUCCESS);
+    CHECK_EQ(entry.args[5], 6);
+}
+
+
+static void test_parse_invalid(void)
+{
+    uint8_t                 buf[64] = {0};
+    uint32_t const          args[7] = {0};
+    nrf_log_decoder_entry_t entry;
+    size_t                  consumed;
+
+    // Uncommitted entry.
+    (void)entry_put(buf, 0, 0, LEVEL_DEBUG, false, 0, NULL);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, 8, &entry, &consumed), NRF_ERROR_INVALID_DATA);
+
+    (void)entry_put(buf, 0x2000, 0, LEVEL_DEBUG, false, 7, args);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, 36, &entry, &consumed), NRF_ERROR_INVALID_DATA);
+
+    (void)entry_put(buf, 0x1000, 0, LEVEL_DEBUG, true, 1, args);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, 12, &entry, &consumed), NRF_ERROR_INVALID_DATA);
+
+    (void)entry_put(buf, 0x2000, 0, 0, false, 0, NULL);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, 8, &entry, &consumed), NRF_ERROR_INVALID_DATA);
+
+    (void)entry_put(buf, 0x2000, 0, 5, false, 0, NULL);
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, 8, &entry, &consumed), NRF_ERROR_INVALID_DATA);
+}
+
+
+static void test_format(void)
+{
+    uint32_t const basic[]  = {(uint32_t)-42, 3000000000u, 0xbeef, 0xbeef, 'A'};
+    uint32_t const widths[] = {42, (uint32_t)-42, 42, 42, 7, 0x1a2b};
+    uint32_t const string[] = {0x5000, 0x20001234};
+    uint32_t const unknown[] = {0x9000};
+
+    CHECK_STR(format(0x1000, 0, NULL), "plain\r\n");
+    CHECK_STR(format(0x2000, 5, basic), "-42 3000000000 BEEF BEEF A % end");
+    CHECK_STR(format(0x3000, 6, widths), "[   42] [-42  ] [00042] [+42] [007] [00001A2B]");
+    CHECK_STR(format(0x4000, 2, string), "name=bob ptr=20001234");
+
+    // Unknown string arguments and missing arguments.
+    CHECK_STR(format(0x4000, 1, unknown), "name=<0x00009000> ptr=00000000");
+    CHECK_STR(format(0x6000, 1, basic), "-42 0 0");
+
+    // Unknown conversions print nothing.
+    CHECK_STR(format(0x7000, 1, widths), "42");
+
+    // Unknown format string.
+    CHECK_STR(format(0x8000, 2, widths), "<0x00008000> 0000002A FFFFFFD6");
+}
+
+
+static void test_truncation(void)
+{
+    uint8_t                 buf[16];
+    char                    line[8];
+    nrf_log_decoder_entry_t entry;
+    size_t                  consumed;
+    size_t                  len = entry_put(buf, 0x1000, 0, LEVEL_DEBUG, true, 0, NULL);
+
+    CHECK_EQ(nrf_log_decoder_entry_parse(buf, len, &entry, &consumed), NRF_SUCCESS);
+
+    memset(line, 'x', sizeof(line));
+    CHECK_EQ(nrf_log_decoder_format(&entry, string_get, NULL, line, 4), 7);
+    CHECK_STR(line, "pla");
+    CHECK_EQ(line[4], 'x');
+
+    CHECK_EQ(nrf_log_decoder_format(&entry, string_get, NULL, line, 0), 7);
+    CHECK_EQ(line[0], 'p');
+}
+
+
+int main(void)
+{
+    test_parse();
+    test_parse_invalid();
+    test_format();
+    test_truncation();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,201 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Records of rtt_stream read back by rtt_stream_reader from the live up-buffer.
+ *
+ * @details The wrap-around tests place the write offset at a chosen distance from the end of the
+ *          buffer. A tail of at least @ref RTT_STREAM_HDR_SIZE bytes is covered by a pad record,
+ *          a shorter one is left as it is and skipped by the reader.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "SEGGER_RTT.h"
+#include "rtt_stream.h"
+#include "rtt_stream_reader.h"
+
+#define BUF_SIZE        RTT_STREAM_BUFFER_SIZE
+#define SENTINEL        0xEE
+
+static rtt_stream_reader_t m_reader;
+
+
+static SEGGER_RTT_RING_BUFFER * ring_get(void)
+{
+    return &_SEGGER_RTT.aUp[RTT_STREAM_BUFFER_INDEX];
+}
+
+
+static void reset(void)
+{
+    host_NRF_RTC1.COUNTER = 0;
+    CHECK_EQ(rtt_stream_init(), NRF_SUCCESS);
+    CHECK_EQ(rtt_stream_reader_ring_init(&m_reader, ring_get()), NRF_SUCCESS);
+}
+
+
+/**@brief Function for writing a record with payload bytes derived from the stream ID. */
+static ret_code_t record_write(uint8_t stream_id, uint16_t length)
+{
+    uint8_t data[BUF_SIZE];
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        data[i] = (uint8_t)(stream_id * 31 + i);
+    }
+    return rtt_stream_write(stream_id, data, length);
+}
+
+
+/**@brief Function for reading the next record and checking it against @ref record_write. */
+static void record_check(uint8_t stream_id, uint16_t length, uint8_t dropped)
+{
+    rtt_stream_hdr_t hdr;
+    uint8_t const  * p_payload = NULL;
+
+    CHECK(rtt_stream_reader_next(&m_reader, &hdr, &p_payload));
+    CHECK_EQ(hdr.stream_id, stream_id);
+    CHECK_EQ(hdr.length, length);
+    CHECK_EQ(hdr.dropped, dropped);
+    for (uint32_t i = 0; (p_payload != NULL) && (i < length) && (i < hdr.length); i++)
+    {
+        CHECK_EQ(p_payload[i], (uint8_t)(stream_id * 31 + i));
+    }
+}
+
+
+/**@brief Function for moving the write offset to @p offset and reading everything before it. */
+static void offset_move(uint32_t offset)
+{
+    rtt_stream_hdr_t hdr;
+    uint8_t const  * p_payload;
+
+    CHECK_EQ(record_write(0, (uint16_t)(offset - RTT_STREAM_HDR_SIZE)), NRF_SUCCESS);
+    CHECK_EQ(ring_get()->WrOff, offset);
+    record_check(0, (uint16_t)(offset - RTT_STREAM_HDR_SIZE), 0);
+
+    // Releases the record.
+    CHECK(!rtt_stream_reader_next(&m_reader, &hdr, &p_payload));
+    CHECK_EQ(ring_get()->RdOff, offset);
+}
+
+
+static void test_round_trip(void)
+{
+    reset();
+    host_NRF_RTC1.COUNTER = 0x123456;
+    CHECK_EQ(record_write(1, 5), NRF_SUCCESS);
+    CHECK_EQ(record_write(2, 0), NRF_SUCCESS);
+    CHECK_EQ(ring_get()->WrOff, RTT_STREAM_RECORD_SIZE(5) + RTT_STREAM_RECORD_SIZE(0));
+
+    {
+        rtt_stream_hdr_t hdr;
+        uint8_t const  * p_payload;
+
+        CHECK(rtt_stream_reader_next(&m_reader, &hdr, &p_payload));
+        CHECK_EQ(hdr.stream_id, 1);
+        CHECK_EQ(hdr.length, 5);
+        CHECK_EQ(hdr.timestamp, 0x123456);
+        CHECK_EQ(((uintptr_t)p_payload) % sizeof(uint32_t), 0);
+    }
+    record_check(2, 0, 0);
+    CHECK_EQ(m_reader.stats.records, 2);
+    CHECK_EQ(m_reader.stats.bytes, ring_get()->WrOff);
+}
+
+
+/**@brief A tail of a header or more is covered by a pad record, which the reader skips. */
+static void test_wrap_pad(void)
+{
+    uint32_t offset = BUF_SIZE - 2 * RTT_STREAM_HDR_SIZE;
+
+    reset();
+    offset_move(offset);
+
+    CHECK_EQ(record_write(3, 20), NRF_SUCCESS);
+    CHECK_EQ(ring_get()->WrOff, RTT_STREAM_RECORD_SIZE(20));
+    CHECK_EQ((uint8_t)ring_get()->pBuffer[offset + 2], RTT_STREAM_ID_PAD);
+
+    record_check(3, 20, 0);
+    CHECK_EQ(m_reader.stats.records, 2);
+    CHECK_EQ(m_reader.stats.errors, 0);
+    CHECK_EQ(m_reader.stats.bytes, BUF_SIZE + RTT_STREAM_RECORD_SIZE(20));
+}
+
+
+/**@brief A tail shorter than a header gets no pad record: the bytes are not written, and the
+ *        reader continues at offset 0 without counting an error. */
+static void test_wrap_short_tail(void)
+{
+    uint32_t offset = BUF_SIZE - sizeof(uint32_t);
+
+    reset();
+    offset_move(offset);
+    memset(&ring_get()->pBuffer[offset], SENTINEL, BUF_SIZE - offset);
+
+    CHECK_EQ(record_write(4, 9), NRF_SUCCESS);
+    CHECK_EQ(ring_get()->WrOff, RTT_STREAM_RECORD_SIZE(9));
+    for (uint32_t i = offset; i < BUF_SIZE; i++)
+    {
+        CHECK_EQ((uint8_t)ring_get()->pBuffer[i], SENTINEL);
+    }
+
+    record_check(4, 9, 0);
+    CHECK_EQ(m_reader.stats.records, 2);
+    CHECK_EQ(m_reader.stats.errors, 0);
+    CHECK_EQ(m_reader.stats.bytes, BUF_SIZE + RTT_STREAM_RECORD_SIZE(9));
+
+    // The following records continue from there.
+    CHECK_EQ(record_write(5, 0), NRF_SUCCESS);
+    record_check(5, 0, 0);
+}
+
+
+/**@brief A record fitting neither the tail nor the start of the buffer is dropped and counted in
+ *        the next record of its stream. */
+static void test_wrap_full(void)
+{
+    rtt_stream_hdr_t hdr;
+    uint8_t const  * p_payload;
+    uint32_t         offset = BUF_SIZE - sizeof(uint32_t);
+
+    reset();
+    offset_move(offset);
+
+    // RdOff is at the tail, so the record would end on it. One byte is always left free.
+    CHECK_EQ(record_write(6, (uint16_t)(offset - RTT_STREAM_HDR_SIZE)), NRF_ERROR_NO_MEM);
+    CHECK_EQ(record_write(6, (uint16_t)(offset - RTT_STREAM_HDR_SIZE)), NRF_ERROR_NO_MEM);
+    CHECK_EQ(rtt_stream_dropped_get(6), 2);
+    CHECK(!rtt_stream_reader_next(&m_reader, &hdr, &p_payload));
+
+    CHECK_EQ(record_write(6, (uint16_t)(offset - 2 * RTT_STREAM_HDR_SIZE)), NRF_SUCCESS);
+    record_check(6, (uint16_t)(offset - 2 * RTT_STREAM_HDR_SIZE), 2);
+    CHECK_EQ(m_reader.stats.dropped_per_stream[6], 2);
+    CHECK_EQ(m_reader.stats.errors, 0);
+}
+
+
+int main(void)
+{
+    test_round_trip();
+    test_wrap_pad();
+    test_wrap_short_tail();
+    test_wrap_full();
+
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,799 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief SoftDevice emulator: attribute table, GAP, central writes, notifications, flash and ECB.
+ *
+ * @details The test plays the application: its event pump pulls every BLE and SoC event into a
+ *          log. Times are simulated, the connection events of a 7.5 ms interval fall on multiples
+ *          of 7500 us from the connection.
+ */
+
+#include <string.h>
+#include "unit_test.h"
+#include "nrf_error.h"
+#include "ble.h"
+#include "ble_hci.h"
+#include "ble_srv_common.h"
+#include "nrf_soc.h"
+#include "nrf_sdm.h"
+#include "app_util.h"
+#include "sd_sim.h"
+#include "sd_sim_internal.h"
+
+#define EVT_LOG_MAX         64
+#define SOC_EVT_LOG_MAX     16
+#define UUID_A              0x1234      /**< Write and notify characteristic of the tests. */
+#define UUID_B              0x1235      /**< Write with authorization. */
+#define UUID_C              0x1236      /**< Indicate. */
+#define CHAR_MAX_LEN        8
+
+/**@brief Event buffer, aligned for ble_evt_t and large enough for a write of a full ATT payload. */
+typedef union
+{
+    ble_evt_t evt;
+    uint32_t  words[SD_SIM_BLE_EVT_WORDS];
+} evt_buf_t;
+
+static evt_buf_t                m_evts[EVT_LOG_MAX];
+static uint32_t                 m_evt_count;
+static uint32_t                 m_soc_evts[SOC_EVT_LOG_MAX];
+static uint32_t                 m_soc_evt_count;
+static bool                     m_sys_attr_reply;       /**< Answer BLE_GATTS_EVT_SYS_ATTR_MISSING from the pump. */
+
+static ble_gatts_char_handles_t m_char_a;
+static ble_gatts_char_handles_t m_char_b;
+static ble_gatts_char_handles_t m_char_c;
+static uint16_t                 m_service_handle;
+
+
+static void evt_pump(void)
+{
+    evt_buf_t buf;
+    uint16_t  len = sizeof(buf);
+    uint32_t  evt_id;
+
+    while (sd_ble_evt_get((uint8_t *)&buf, &len) == NRF_SUCCESS)
+    {
+        if (m_evt_count < EVT_LOG_MAX)
+        {
+            m_evts[m_evt_count] = buf;
+        }
+        m_evt_count++;
+
+        if (m_sys_attr_reply && (buf.evt.header.evt_id == BLE_GATTS_EVT_SYS_ATTR_MISSING))
+        {
+            (void)sd_ble_gatts_sys_attr_set(buf.evt.evt.gatts_evt.conn_handle, NULL, 0, 0);
+        }
+        len = sizeof(buf);
+    }
+
+    while (sd_evt_get(&evt_id) == NRF_SUCCESS)
+    {
+        if (m_soc_evt_count < SOC_EVT_LOG_MAX)
+        {
+            m_soc_evts[m_soc_evt_count] = evt_id;
+        }
+        m_soc_evt_count++;
+    }
+}
+
+
+static void log_reset(void)
+{
+    m_evt_count     = 0;
+    m_soc_evt_count = 0;
+}
+
+
+static ble_evt_t const * evt_get(uint32_t index)
+{
+    return &m_evts[index].evt;
+}
+
+
+/**@brief Function for adding a characteristic with an open value kept by the emulator. */
+static uint32_t char_add(uint16_t                   uuid16,
+                         ble_gatt_char_props_t      props,
+                         uint8_t                    wr_auth,
+                         ble_gatts_char_handles_t * p_handles)
+{
+    static uint8_t const init[CHAR_MAX_LEN] = {0xA0, 0xA1, 0xA2};
+
+    ble_uuid_t          uuid = {uuid16, BLE_UUID_TYPE_BLE};
+    ble_gatts_char_md_t char_md;
+    ble_gatts_attr_md_t attr_md;
+    ble_gatts_attr_t    attr;
+
+    memset(&char_md, 0, sizeof(char_md));
+    char_md.char_props = props;
+
+    memset(&attr_md, 0, sizeof(attr_md));
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.write_perm);
+    attr_md.vloc    = BLE_GATTS_VLOC_STACK;
+    attr_md.vlen    = 1;
+    attr_md.wr_auth = wr_auth;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.p_uuid    = &uuid;
+    attr.p_attr_md = &attr_md;
+    attr.init_len  = 3;
+    attr.max_len   = CHAR_MAX_LEN;
+    attr.p_value   = (uint8_t *)init;
+
+    return sd_ble_gatts_characteristic_add(BLE_GATT_HANDLE_INVALID, &char_md, &attr, p_handles);
+}
+
+
+/**@brief Function for building the table of the tests: one service with characteristics A, B, C. */
+static void table_build(void)
+{
+    ble_uuid_t            uuid  = {0x1230, BLE_UUID_TYPE_BLE};
+    ble_gatt_char_props_t props;
+
+    CHECK_EQ(sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &uuid, &m_service_handle),
+             NRF_SUCCESS);
+
+    memset(&props, 0, sizeof(props));
+    props.read   = 1;
+    props.write  = 1;
+    props.write_wo_resp = 1;
+    props.notify = 1;
+    CHECK_EQ(char_add(UUID_A, props, 0, &m_char_a), NRF_SUCCESS);
+
+    memset(&props, 0, sizeof(props));
+    props.write = 1;
+    CHECK_EQ(char_add(UUID_B, props, 1, &m_char_b), NRF_SUCCESS);
+
+    memset(&props, 0, sizeof(props));
+    props.read     = 1;
+    props.indicate = 1;
+    CHECK_EQ(char_add(UUID_C, props, 0, &m_char_c), NRF_SUCCESS);
+}
+
+
+/**@brief Function for starting advertising and connecting the central. */
+static void connect(void)
+{
+    ble_gap_adv_params_t adv_params;
+
+    memset(&adv_params, 0, sizeof(adv_params));
+    adv_params.type     = BLE_GAP_ADV_TYPE_ADV_IND;
+    adv_params.interval = 64;
+
+    CHECK_EQ(sd_ble_gap_adv_start(&adv_params), NRF_SUCCESS);
+    CHECK_EQ(sd_sim_central_connect(), NRF_SUCCESS);
+}
+
+
+static void cccd_write(uint16_t cccd_handle, uint16_t value)
+{
+    uint8_t data[BLE_CCCD_VALUE_LEN];
+
+    (void)uint16_encode(value, data);
+    CHECK_EQ(sd_sim_central_write(cccd_handle, data, sizeof(data), true), NRF_SUCCESS);
+}
+
+
+static uint16_t value_read(uint16_t handle, uint8_t * p_data)
+{
+    ble_gatts_value_t value;
+
+    memset(&value, 0, sizeof(value));
+    value.len     = CHAR_MAX_LEN;
+    value.p_value = p_data;
+    CHECK_EQ(sd_ble_gatts_value_get(SD_SIM_CONN_HANDLE, handle, &value), NRF_SUCCESS);
+
+    return value.len;
+}
+
+
+static void test_gatts(void)
+{
+    ble_uuid_t          uuid = {0x2901, BLE_UUID_TYPE_BLE};
+    ble_gatts_attr_md_t md;
+    ble_gatts_attr_t    attr;
+    ble_gatts_value_t   value;
+    uint16_t            handle;
+    uint8_t             data[CHAR_MAX_LEN + 2];
+
+    sd_sim_init(NULL, evt_pump);
+
+    memset(&md, 0, sizeof(md));
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&md.read_perm);
+    md.vloc = BLE_GATTS_VLOC_STACK;
+    memset(&attr, 0, sizeof(attr));
+    attr.p_uuid    = &uuid;
+    attr.p_attr_md = &md;
+    attr.max_len   = 2;
+
+    // A descriptor needs a characteristic to belong to.
+    CHECK_EQ(sd_ble_gatts_descriptor_add(BLE_GATT_HANDLE_INVALID, &attr, &handle),
+             NRF_ERROR_INVALID_STATE);
+
+    uuid.uuid = 0x1230;
+    CHECK_EQ(sd_ble_gatts_service_add(0, &uuid, &handle), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &uuid, NULL), NRF_ERROR_INVALID_ADDR);
+
+    // Handles follow the declaration order: service, then declaration, value and CCCD.
+    table_build();
+    CHECK_EQ(m_service_handle, 1);
+    CHECK_EQ(m_char_a.value_handle, 3);
+    CHECK_EQ(m_char_a.cccd_handle, 4);
+    CHECK_EQ(m_char_a.user_desc_handle, BLE_GATT_HANDLE_INVALID);
+    CHECK_EQ(m_char_a.sccd_handle, BLE_GATT_HANDLE_INVALID);
+    CHECK_EQ(m_char_b.value_handle, 6);
+    CHECK_EQ(m_char_b.cccd_handle, BLE_GATT_HANDLE_INVALID);
+    CHECK_EQ(m_char_c.value_handle, 8);
+    CHECK_EQ(m_char_c.cccd_handle, 9);
+
+    uuid.uuid = 0x2901;
+    CHECK_EQ(sd_ble_gatts_descriptor_add(BLE_GATT_HANDLE_INVALID, &attr, &handle), NRF_SUCCESS);
+    CHECK_EQ(handle, 10);
+
+    CHECK_EQ(sd_sim_value_handle_find(UUID_B), m_char_b.value_handle);
+    CHECK_EQ(sd_sim_cccd_handle_find(UUID_C), m_char_c.cccd_handle);
+    CHECK_EQ(sd_sim_cccd_handle_find(UUID_B), BLE_GATT_HANDLE_INVALID);
+    CHECK_EQ(sd_sim_value_handle_find(0x9999), BLE_GATT_HANDLE_INVALID);
+
+    memset(&uuid, 0, sizeof(uuid));
+    memset(&md, 0, sizeof(md));
+    CHECK_EQ(sd_ble_gatts_attr_get(m_char_b.value_handle, &uuid, &md), NRF_SUCCESS);
+    CHECK_EQ(uuid.uuid, UUID_B);
+    CHECK_EQ(uuid.type, BLE_UUID_TYPE_BLE);
+    CHECK_EQ(md.wr_auth, 1);
+    CHECK_EQ(md.vlen, 1);
+    CHECK_EQ(sd_ble_gatts_attr_get(m_char_a.cccd_handle, &uuid, &md), NRF_SUCCESS);
+    CHECK_EQ(uuid.uuid, BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG);
+    CHECK_EQ(md.write_perm.sm, 1);
+    CHECK_EQ(md.write_perm.lv, 1);
+    CHECK_EQ(sd_ble_gatts_attr_get(11, &uuid, &md), BLE_ERROR_INVALID_ATTR_HANDLE);
+
+    // Initial value of a variable length value.
+    CHECK_EQ(value_read(m_char_a.value_handle, data), 3);
+    CHECK_EQ(data[0], 0xA0);
+    CHECK_EQ(data[2], 0xA2);
+
+    // Set at an offset extends the value, set past the maximum length is cut.
+    memset(data, 0x55, sizeof(data));
+    memset(&value, 0, sizeof(value));
+    value.offset  = 2;
+    value.len     = 4;
+    value.p_value = data;
+    CHECK_EQ(sd_ble_gatts_value_set(SD_SIM_CONN_HANDLE, m_char_a.value_handle, &value), NRF_SUCCESS);
+    CHECK_EQ(value_read(m_char_a.value_handle, data), 6);
+    CHECK_EQ(data[1], 0xA1);
+    CHECK_EQ(data[2], 0x55);
+    CHECK_EQ(data[5], 0x55);
+
+    memset(data, 0x66, sizeof(data));
+    value.offset = 0;
+    value.len    = sizeof(data);
+    CHECK_EQ(sd_ble_gatts_value_set(SD_SIM_CONN_HANDLE, m_char_a.value_handle, &value), NRF_SUCCESS);
+    CHECK_EQ(value.len, CHAR_MAX_LEN);
+    value.offset = CHAR_MAX_LEN + 1;
+    CHECK_EQ(sd_ble_gatts_value_set(SD_SIM_CONN_HANDLE, m_char_a.value_handle, &value),
+             NRF_ERROR_INVALID_PARAM);
+
+    // Get without a buffer gives the length, get from an offset gives the rest.
+    value.offset  = 0;
+    value.p_value = NULL;
+    CHECK_EQ(sd_ble_gatts_value_get(SD_SIM_CONN_HANDLE, m_char_a.value_handle, &value), NRF_SUCCESS);
+    CHECK_EQ(value.len, CHAR_MAX_LEN);
+    memset(data, 0, sizeof(data));
+    value.offset  = 6;
+    value.len     = sizeof(data);
+    value.p_value = data;
+    CHECK_EQ(sd_ble_gatts_value_get(SD_SIM_CONN_HANDLE, m_char_a.value_handle, &value), NRF_SUCCESS);
+    CHECK_EQ(value.len, 2);
+    CHECK_EQ(data[1], 0x66);
+    CHECK_EQ(data[2], 0);
+    value.offset = CHAR_MAX_LEN + 1;
+    CHECK_EQ(sd_ble_gatts_value_get(SD_SIM_CONN_HANDLE, m_char_a.value_handle, &value),
+             NRF_ERROR_INVALID_PARAM);
+    value.offset = 0;
+    CHECK_EQ(sd_ble_gatts_value_get(SD_SIM_CONN_HANDLE, 11, &value), BLE_ERROR_INVALID_ATTR_HANDLE);
+    CHECK_EQ(sd_ble_gatts_value_get(SD_SIM_CONN_HANDLE, BLE_GATT_HANDLE_INVALID, &value),
+             BLE_ERROR_INVALID_ATTR_HANDLE);
+
+    // The attribute table runs out.
+    {
+        ble_gatt_char_props_t    props;
+        ble_gatts_char_handles_t handles;
+        uint32_t                 err_code = NRF_SUCCESS;
+        uint32_t                 count    = 0;
+
+        memset(&props, 0, sizeof(props));
+        props.read = 1;
+        while ((err_code == NRF_SUCCESS) && (count < SD_SIM_ATTR_MAX))
+        {
+            err_code = char_add(0x2000, props, 0, &handles);
+            count++;
+        }
+        CHECK_EQ(err_code, NRF_ERROR_NO_MEM);
+    }
+}
+
+
+static void test_gap(void)
+{
+    static uint8_t const name[] = "sd_sim";
+
+    nrf_clock_lf_cfg_t    clock_lf_cfg;
+    ble_enable_params_t   enable_params;
+    ble_gap_conn_params_t ppcp;
+    ble_gap_conn_params_t params;
+    ble_gap_adv_params_t  adv_params;
+    ble_gap_conn_sec_mode_t sec_mode;
+    uint32_t              ram_base = 0x20002000;
+    uint8_t               buf[BLE_GAP_DEVNAME_MAX_LEN + 1];
+    uint16_t              len;
+    uint16_t              appearance;
+    sd_sim_stats_t        stats;
+
+    sd_sim_init(NULL, evt_pump);
+    log_reset();
+
+    memset(&clock_lf_cfg, 0, sizeof(clock_lf_cfg));
+    memset(&enable_params, 0, sizeof(enable_params));
+    CHECK_EQ(sd_ble_enable(&enable_params, &ram_base), NRF_ERROR_INVALID_STATE);
+    CHECK_EQ(sd_softdevice_enable(&clock_lf_cfg, NULL), NRF_SUCCESS);
+    CHECK_EQ(sd_softdevice_enable(&clock_lf_cfg, NULL), NRF_ERROR_INVALID_STATE);
+    CHECK_EQ(sd_ble_enable(&enable_params, &ram_base), NRF_SUCCESS);
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&sec_mode);
+    CHECK_EQ(sd_ble_gap_device_name_set(&sec_mode, name, sizeof(name) - 1), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gap_device_name_set(&sec_mode, buf, BLE_GAP_DEVNAME_MAX_LEN + 1), NRF_ERROR_DATA_SIZE);
+    CHECK_EQ(sd_ble_gap_device_name_get(NULL, &len), NRF_SUCCESS);
+    CHECK_EQ(len, sizeof(name) - 1);
+    len = 3;
+    CHECK_EQ(sd_ble_gap_device_name_get(buf, &len), NRF_ERROR_DATA_SIZE);
+    len = sizeof(buf);
+    CHECK_EQ(sd_ble_gap_device_name_get(buf, &len), NRF_SUCCESS);
+    CHECK_EQ(len, sizeof(name) - 1);
+    CHECK(memcmp(buf, name, len) == 0);
+
+    CHECK_EQ(sd_ble_gap_appearance_set(BLE_APPEARANCE_RUNNING_WALKING_SENSOR_IN_SHOE), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gap_appearance_get(&appearance), NRF_SUCCESS);
+    CHECK_EQ(appearance, BLE_APPEARANCE_RUNNING_WALKING_SENSOR_IN_SHOE);
+
+    ppcp.min_conn_interval = 16;
+    ppcp.max_conn_interval = 24;
+    ppcp.slave_latency     = 0;
+    ppcp.conn_sup_timeout  = 400;
+    CHECK_EQ(sd_ble_gap_ppcp_set(&ppcp), NRF_SUCCESS);
+    memset(&params, 0, sizeof(params));
+    CHECK_EQ(sd_ble_gap_ppcp_get(&params), NRF_SUCCESS);
+    CHECK(memcmp(&params, &ppcp, sizeof(ppcp)) == 0);
+
+    // Advertising times out.
+    CHECK_EQ(sd_sim_central_connect(), NRF_ERROR_INVALID_STATE);
+    memset(&adv_params, 0, sizeof(adv_params));
+    adv_params.type     = BLE_GAP_ADV_TYPE_ADV_IND;
+    adv_params.interval = 64;
+    adv_params.timeout  = 1;
+    CHECK_EQ(sd_ble_gap_adv_start(&adv_params), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gap_adv_start(&adv_params), NRF_ERROR_INVALID_STATE);
+    sd_sim_run(999);
+    CHECK_EQ(m_evt_count, 0);
+    sd_sim_run(1);
+    CHECK_EQ(m_evt_count, 1);
+    CHECK_EQ(evt_get(0)->header.evt_id, BLE_GAP_EVT_TIMEOUT);
+    CHECK_EQ(evt_get(0)->evt.gap_evt.params.timeout.src, BLE_GAP_TIMEOUT_SRC_ADVERTISING);
+    CHECK_EQ(sd_ble_gap_adv_stop(), NRF_ERROR_INVALID_STATE);
+    CHECK_EQ(sd_sim_now_ms(), 1000);
+
+    // The central connects at the interval of the link configuration.
+    log_reset();
+    connect();
+    CHECK_EQ(m_evt_count, 1);
+    CHECK_EQ(evt_get(0)->header.evt_id, BLE_GAP_EVT_CONNECTED);
+    CHECK_EQ(evt_get(0)->evt.gap_evt.conn_handle, SD_SIM_CONN_HANDLE);
+    CHECK_EQ(evt_get(0)->evt.gap_evt.params.connected.role, BLE_GAP_ROLE_PERIPH);
+    CHECK_EQ(evt_get(0)->evt.gap_evt.params.connected.conn_params.max_conn_interval, 6);
+    CHECK_EQ(sd_ble_gap_adv_start(&adv_params), NRF_ERROR_INVALID_STATE);
+    CHECK_EQ(sd_sim_central_connect(), NRF_ERROR_INVALID_STATE);
+
+    // The update uses the preferred parameters and takes effect after a few connection events.
+    CHECK_EQ(sd_ble_gap_conn_param_update(SD_SIM_CONN_HANDLE + 1, NULL), BLE_ERROR_INVALID_CONN_HANDLE);
+    CHECK_EQ(sd_ble_gap_conn_param_update(SD_SIM_CONN_HANDLE, NULL), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gap_conn_param_update(SD_SIM_CONN_HANDLE, NULL), NRF_ERROR_BUSY);
+    sd_sim_run(SD_SIM_CONN_PARAM_UPDATE_EVENTS * 15 / 2 - 1);
+    CHECK_EQ(m_evt_count, 1);
+    sd_sim_run(1);
+    CHECK_EQ(m_evt_count, 2);
+    CHECK_EQ(evt_get(1)->header.evt_id, BLE_GAP_EVT_CONN_PARAM_UPDATE);
+    params = evt_get(1)->evt.gap_evt.params.conn_param_update.conn_params;
+    CHECK_EQ(params.min_conn_interval, 16);
+    CHECK_EQ(params.max_conn_interval, 16);
+
+    // Connection events follow the new interval of 20 ms.
+    sd_sim_run(40);
+    sd_sim_stats_get(&stats);
+    CHECK_EQ(stats.conn_events, SD_SIM_CONN_PARAM_UPDATE_EVENTS + 2);
+
+    // Disconnection by the application.
+    CHECK_EQ(sd_ble_gap_disconnect(SD_SIM_CONN_HANDLE, BLE_HCI_STATUS_CODE_SUCCESS), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(sd_ble_gap_disconnect(SD_SIM_CONN_HANDLE, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION),
+             NRF_SUCCESS);
+    sd_sim_run(1);
+    CHECK_EQ(m_evt_count, 3);
+    CHECK_EQ(evt_get(2)->header.evt_id, BLE_GAP_EVT_DISCONNECTED);
+    CHECK_EQ(evt_get(2)->evt.gap_evt.params.disconnected.reason, BLE_HCI_LOCAL_HOST_TERMINATED_CONNECTION);
+    CHECK_EQ(sd_ble_gap_disconnect(SD_SIM_CONN_HANDLE, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION),
+             BLE_ERROR_INVALID_CONN_HANDLE);
+    CHECK_EQ(sd_sim_central_disconnect(), NRF_ERROR_INVALID_STATE);
+
+    // Disconnection by the central.
+    connect();
+    CHECK_EQ(sd_sim_central_disconnect(), NRF_SUCCESS);
+    CHECK_EQ(m_evt_count, 5);
+    CHECK_EQ(evt_get(4)->header.evt_id, BLE_GAP_EVT_DISCONNECTED);
+    CHECK_EQ(evt_get(4)->evt.gap_evt.params.disconnected.reason, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+}
+
+
+static void test_central_write(void)
+{
+    uint8_t        data[SD_SIM_ATT_PAYLOAD_MAX + 1];
+    uint8_t        sys_attr[32];
+    uint16_t       sys_attr_len;
+    sd_sim_stats_t stats;
+    ble_gatts_evt_write_t const * p_write;
+
+    sd_sim_init(NULL, evt_pump);
+    table_build();
+    log_reset();
+    m_sys_attr_reply = false;
+
+    memset(data, 0x11, sizeof(data));
+    CHECK_EQ(sd_sim_central_write(m_char_a.value_handle, data, 1, true), NRF_ERROR_INVALID_STATE);
+    connect();
+    CHECK_EQ(sd_sim_central_write(11, data, 1, true), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(sd_sim_central_write(m_char_a.value_handle, data, sizeof(data), true),
+             NRF_ERROR_INVALID_PARAM);
+
+    // The CCCD is not written until the application has set the system attributes, which it is
+    // asked for once.
+    cccd_write(m_char_a.cccd_handle, BLE_GATT_HVX_NOTIFICATION);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 2);
+    CHECK_EQ(evt_get(1)->header.evt_id, BLE_GATTS_EVT_SYS_ATTR_MISSING);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 2);
+    CHECK_EQ(value_read(m_char_a.cccd_handle, data), BLE_CCCD_VALUE_LEN);
+    CHECK_EQ(data[0], 0);
+
+    CHECK_EQ(sd_ble_gatts_sys_attr_set(SD_SIM_CONN_HANDLE, NULL, 0, 0), NRF_SUCCESS);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 3);
+    p_write = &evt_get(2)->evt.gatts_evt.params.write;
+    CHECK_EQ(evt_get(2)->header.evt_id, BLE_GATTS_EVT_WRITE);
+    CHECK_EQ(p_write->handle, m_char_a.cccd_handle);
+    CHECK_EQ(p_write->uuid.uuid, BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG);
+    CHECK_EQ(p_write->op, BLE_GATTS_OP_WRITE_REQ);
+    CHECK_EQ(p_write->len, BLE_CCCD_VALUE_LEN);
+    CHECK_EQ(p_write->data[0], BLE_GATT_HVX_NOTIFICATION);
+    CHECK_EQ(value_read(m_char_a.cccd_handle, data), BLE_CCCD_VALUE_LEN);
+    CHECK_EQ(data[0], BLE_GATT_HVX_NOTIFICATION);
+
+    // A Write Command to a variable length value sets its length.
+    memset(data, 0x22, sizeof(data));
+    CHECK_EQ(sd_sim_central_write(m_char_a.value_handle, data, 5, false), NRF_SUCCESS);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 4);
+    p_write = &evt_get(3)->evt.gatts_evt.params.write;
+    CHECK_EQ(p_write->op, BLE_GATTS_OP_WRITE_CMD);
+    CHECK_EQ(p_write->len, 5);
+    CHECK_EQ(p_write->data[4], 0x22);
+    CHECK_EQ(value_read(m_char_a.value_handle, data), 5);
+
+    // A write that needs authorization is passed to the application, the value is left alone.
+    memset(data, 0x33, sizeof(data));
+    CHECK_EQ(sd_sim_central_write(m_char_b.value_handle, data, 2, true), NRF_SUCCESS);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 5);
+    CHECK_EQ(evt_get(4)->header.evt_id, BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST);
+    CHECK_EQ(evt_get(4)->evt.gatts_evt.params.authorize_request.type, BLE_GATTS_AUTHORIZE_TYPE_WRITE);
+    CHECK_EQ(evt_get(4)->evt.gatts_evt.params.authorize_request.request.write.handle, m_char_b.value_handle);
+    CHECK_EQ(evt_get(4)->evt.gatts_evt.params.authorize_request.request.write.data[1], 0x33);
+    CHECK_EQ(value_read(m_char_b.value_handle, data), 3);
+    CHECK_EQ(data[0], 0xA0);
+
+    // The queue holds SD_SIM_WRITE_QUEUE_SIZE writes, delivered packets_per_event at a time.
+    for (uint32_t i = 0; i < SD_SIM_WRITE_QUEUE_SIZE; i++)
+    {
+        data[0] = (uint8_t)i;
+        CHECK_EQ(sd_sim_central_write(m_char_a.value_handle, data, 1, false), NRF_SUCCESS);
+    }
+    CHECK_EQ(sd_sim_central_write(m_char_a.value_handle, data, 1, false), NRF_ERROR_NO_MEM);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 5 + 6);
+    CHECK_EQ(evt_get(10)->evt.gatts_evt.params.write.data[0], 5);
+    sd_sim_run(15);
+    CHECK_EQ(m_evt_count, 5 + SD_SIM_WRITE_QUEUE_SIZE);
+    CHECK_EQ(evt_get(5 + SD_SIM_WRITE_QUEUE_SIZE - 1)->evt.gatts_evt.params.write.data[0],
+             SD_SIM_WRITE_QUEUE_SIZE - 1);
+    sd_sim_stats_get(&stats);
+    CHECK_EQ(stats.writes, 3 + SD_SIM_WRITE_QUEUE_SIZE);
+
+    // The CCCDs are saved and restored across connections.
+    cccd_write(m_char_c.cccd_handle, BLE_GATT_HVX_INDICATION);
+    sd_sim_run(8);
+    CHECK_EQ(sd_ble_gatts_sys_attr_get(SD_SIM_CONN_HANDLE, NULL, &sys_attr_len, 0), NRF_SUCCESS);
+    CHECK_EQ(sys_attr_len, 2 * (4 + BLE_CCCD_VALUE_LEN) + 2);
+    sys_attr_len = 8;
+    CHECK_EQ(sd_ble_gatts_sys_attr_get(SD_SIM_CONN_HANDLE, sys_attr, &sys_attr_len, 0), NRF_ERROR_DATA_SIZE);
+    sys_attr_len = sizeof(sys_attr);
+    CHECK_EQ(sd_ble_gatts_sys_attr_get(SD_SIM_CONN_HANDLE, sys_attr, &sys_attr_len, 0), NRF_SUCCESS);
+    CHECK_EQ(sys_attr_len, 14);
+    CHECK_EQ(uint16_decode(&sys_attr[0]), m_char_a.cccd_handle);
+    CHECK_EQ(uint16_decode(&sys_attr[2]), BLE_CCCD_VALUE_LEN);
+    CHECK_EQ(uint16_decode(&sys_attr[4]), BLE_GATT_HVX_NOTIFICATION);
+    CHECK_EQ(uint16_decode(&sys_attr[6]), m_char_c.cccd_handle);
+    CHECK_EQ(uint16_decode(&sys_attr[10]), BLE_GATT_HVX_INDICATION);
+
+    CHECK_EQ(sd_sim_central_disconnect(), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_sys_attr_get(SD_SIM_CONN_HANDLE, NULL, &sys_attr_len, 0),
+             BLE_ERROR_INVALID_CONN_HANDLE);
+    connect();
+    CHECK_EQ(value_read(m_char_a.cccd_handle, data), BLE_CCCD_VALUE_LEN);
+    CHECK_EQ(data[0], 0);
+
+    // Only CCCDs are accepted.
+    {
+        uint8_t bad[8] = {0};
+
+        (void)uint16_encode(m_char_a.value_handle, &bad[0]);
+        (void)uint16_encode(BLE_CCCD_VALUE_LEN, &bad[2]);
+        CHECK_EQ(sd_ble_gatts_sys_attr_set(SD_SIM_CONN_HANDLE, bad, sizeof(bad), 0), NRF_ERROR_INVALID_DATA);
+    }
+    CHECK_EQ(sd_ble_gatts_sys_attr_set(SD_SIM_CONN_HANDLE, sys_attr, sys_attr_len, 0), NRF_SUCCESS);
+    CHECK_EQ(value_read(m_char_a.cccd_handle, data), BLE_CCCD_VALUE_LEN);
+    CHECK_EQ(data[0], BLE_GATT_HVX_NOTIFICATION);
+    CHECK_EQ(value_read(m_char_c.cccd_handle, data), BLE_CCCD_VALUE_LEN);
+    CHECK_EQ(data[0], BLE_GATT_HVX_INDICATION);
+
+    // The central script drives the same path.
+    log_reset();
+    CHECK_EQ(sd_sim_script_run("unsubscribe 1234 // notifications off\nwritecmd #3 0102; wait 8"),
+             NRF_SUCCESS);
+    CHECK_EQ(m_evt_count, 2);
+    CHECK_EQ(evt_get(0)->evt.gatts_evt.params.write.handle, m_char_a.cccd_handle);
+    CHECK_EQ(evt_get(0)->evt.gatts_evt.params.write.data[0], 0);
+    CHECK_EQ(evt_get(1)->evt.gatts_evt.params.write.handle, m_char_a.value_handle);
+    CHECK_EQ(evt_get(1)->evt.gatts_evt.params.write.len, 2);
+    CHECK_EQ(evt_get(1)->evt.gatts_evt.params.write.data[1], 0x02);
+    CHECK_EQ(sd_sim_script_run("subscribe 9999"), NRF_ERROR_NOT_FOUND);
+    CHECK_EQ(sd_sim_script_run("frobnicate"), NRF_ERROR_INVALID_PARAM);
+}
+
+
+static void test_notifications(void)
+{
+    sd_sim_link_cfg_t      link_cfg = {6, 3, 2, true};
+    ble_gatts_hvx_params_t hvx;
+    uint8_t                data[CHAR_MAX_LEN + 2] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    uint16_t               len;
+    uint8_t                count;
+    sd_sim_stats_t         stats;
+
+    sd_sim_init(&link_cfg, evt_pump);
+    table_build();
+    log_reset();
+    m_sys_attr_reply = false;
+
+    memset(&hvx, 0, sizeof(hvx));
+    hvx.handle = m_char_a.value_handle;
+    hvx.type   = BLE_GATT_HVX_NOTIFICATION;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), BLE_ERROR_INVALID_CONN_HANDLE);
+
+    connect();
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), BLE_ERROR_GATTS_SYS_ATTR_MISSING);
+    CHECK_EQ(sd_ble_gatts_sys_attr_set(SD_SIM_CONN_HANDLE, NULL, 0, 0), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_ERROR_INVALID_STATE);
+    hvx.handle = m_char_a.cccd_handle;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), BLE_ERROR_INVALID_ATTR_HANDLE);
+    hvx.handle = m_char_a.value_handle;
+
+    // Subscribed at the first connection event, 7.5 ms after the connection.
+    cccd_write(m_char_a.cccd_handle, BLE_GATT_HVX_NOTIFICATION);
+    cccd_write(m_char_c.cccd_handle, BLE_GATT_HVX_INDICATION);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 3);
+
+    CHECK_EQ(sd_ble_tx_packet_count_get(SD_SIM_CONN_HANDLE, &count), NRF_SUCCESS);
+    CHECK_EQ(count, 3);
+
+    // The data is written to the value, cut to its maximum length.
+    len        = sizeof(data);
+    hvx.p_len  = &len;
+    hvx.p_data = data;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_SUCCESS);
+    CHECK_EQ(len, CHAR_MAX_LEN);
+    CHECK_EQ(value_read(m_char_a.value_handle, data), CHAR_MAX_LEN);
+
+    // Three TX buffers, the fourth notification is refused.
+    hvx.p_len  = NULL;
+    hvx.p_data = NULL;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), BLE_ERROR_NO_TX_PACKETS);
+
+    // Two packets per connection event, each event completes with one BLE_EVT_TX_COMPLETE.
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 4);
+    CHECK_EQ(evt_get(3)->header.evt_id, BLE_EVT_TX_COMPLETE);
+    CHECK_EQ(evt_get(3)->evt.common_evt.params.tx_complete.count, 2);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), BLE_ERROR_NO_TX_PACKETS);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 5);
+    CHECK_EQ(evt_get(4)->evt.common_evt.params.tx_complete.count, 2);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 6);
+    CHECK_EQ(evt_get(5)->evt.common_evt.params.tx_complete.count, 1);
+
+    // Queued at 8 ms: sent at 15 and 22.5 ms. Queued at 16 ms: sent at 22.5 and 30 ms.
+    sd_sim_stats_get(&stats);
+    CHECK_EQ(stats.notifications, 5);
+    CHECK_EQ(stats.notification_bytes, 5 * CHAR_MAX_LEN);
+    CHECK_EQ(stats.hvx_no_tx_packets, 2);
+    CHECK_EQ(stats.tx_latency_us, 7000 + 7000 + 14500 + 6500 + 14000);
+
+    // One indication at a time, confirmed by BLE_GATTS_EVT_HVC.
+    hvx.handle = m_char_c.value_handle;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_ERROR_INVALID_STATE);
+    hvx.type = BLE_GATT_HVX_INDICATION;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_ERROR_BUSY);
+    hvx.handle = m_char_a.value_handle;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_ERROR_INVALID_STATE);
+    hvx.type = BLE_GATT_HVX_INVALID;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_ERROR_INVALID_PARAM);
+    sd_sim_run(8);
+    CHECK_EQ(m_evt_count, 7);
+    CHECK_EQ(evt_get(6)->header.evt_id, BLE_GATTS_EVT_HVC);
+    CHECK_EQ(evt_get(6)->evt.gatts_evt.params.hvc.handle, m_char_c.value_handle);
+    hvx.handle = m_char_c.value_handle;
+    hvx.type   = BLE_GATT_HVX_INDICATION;
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), NRF_SUCCESS);
+
+    // Queued packets are dropped with the link.
+    CHECK_EQ(sd_sim_central_disconnect(), NRF_SUCCESS);
+    CHECK_EQ(sd_ble_gatts_hvx(SD_SIM_CONN_HANDLE, &hvx), BLE_ERROR_INVALID_CONN_HANDLE);
+    sd_sim_run(100);
+    sd_sim_stats_get(&stats);
+    CHECK_EQ(stats.notifications, 6);
+    CHECK_EQ(stats.evt_queue_overflows, 0);
+}
+
+
+static void test_flash(void)
+{
+    uint32_t       words[SD_SIM_FLASH_PAGE_SIZE / sizeof(uint32_t) + 1];
+    uint32_t *     p_page = (uint32_t *)sd_sim_flash_ptr(SD_SIM_FLASH_PAGE_SIZE);
+    uint8_t *      p_byte;
+    sd_sim_stats_t stats;
+
+    sd_sim_init(NULL, evt_pump);
+    log_reset();
+
+    CHECK(sd_sim_flash_ptr(0) != NULL);
+    CHECK(sd_sim_flash_ptr(SD_SIM_FLASH_SIZE) == NULL);
+    CHECK_EQ(p_page[0], 0xFFFFFFFF);
+
+    // Device addresses and image pointers both reach the image, programming only clears bits.
+    words[0] = 0x12345678;
+    words[1] = 0xFFFF0000;
+    CHECK_EQ(sd_flash_write((uint32_t *)(uintptr_t)SD_SIM_FLASH_PAGE_SIZE, words, 2), NRF_SUCCESS);
+    CHECK_EQ(p_page[0], 0x12345678);
+    CHECK_EQ(p_page[1], 0xFFFF0000);
+    words[0] = 0xFF00FF00;
+    CHECK_EQ(sd_flash_write(&p_page[1], words, 1), NRF_SUCCESS);
+    CHECK_EQ(p_page[1], 0xFF000000);
+    CHECK_EQ(p_page[2], 0xFFFFFFFF);
+
+    // The result comes as a SoC event.
+    CHECK_EQ(m_soc_evt_count, 0);
+    sd_sim_run(1);
+    CHECK_EQ(m_soc_evt_count, 2);
+    CHECK_EQ(m_soc_evts[0], NRF_EVT_FLASH_OPERATION_SUCCESS);
+    CHECK_EQ(m_soc_evts[1], NRF_EVT_FLASH_OPERATION_SUCCESS);
+
+    CHECK_EQ(sd_flash_write((uint32_t *)(uintptr_t)(SD_SIM_FLASH_PAGE_SIZE + 2), words, 1),
+             NRF_ERROR_INVALID_ADDR);
+    p_byte = (uint8_t *)words;
+    CHECK_EQ(sd_flash_write(p_page, (uint32_t *)(p_byte + 1), 1), NRF_ERROR_INVALID_ADDR);
+    CHECK_EQ(sd_flash_write((uint32_t *)(uintptr_t)SD_SIM_FLASH_SIZE, words, 1), NRF_ERROR_INVALID_ADDR);
+    CHECK_EQ(sd_flash_write(p_page, words, 0), NRF_ERROR_INVALID_LENGTH);
+    CHECK_EQ(sd_flash_write(p_page, words, sizeof(words) / sizeof(words[0])), NRF_ERROR_INVALID_LENGTH);
+    CHECK_EQ(sd_flash_write((uint32_t *)(uintptr_t)(SD_SIM_FLASH_SIZE - sizeof(uint32_t)), words, 2),
+             NRF_ERROR_INVALID_LENGTH);
+
+    // Erase sets a whole page.
+    CHECK_EQ(sd_flash_page_erase(SD_SIM_FLASH_SIZE / SD_SIM_FLASH_PAGE_SIZE), NRF_ERROR_INTERNAL);
+    CHECK_EQ(sd_flash_page_erase(1), NRF_SUCCESS);
+    CHECK_EQ(p_page[0], 0xFFFFFFFF);
+    CHECK_EQ(p_page[1], 0xFFFFFFFF);
+
+    // SoC events that are not pulled are lost past the queue size.
+    for (uint32_t i = 0; i < SD_SIM_SOC_EVT_QUEUE_SIZE; i++)
+    {
+        CHECK_EQ(sd_flash_write(&p_page[i], words, 1), NRF_SUCCESS);
+    }
+    sd_sim_stats_get(&stats);
+    CHECK_EQ(stats.evt_queue_overflows, 1);
+    sd_sim_run(1);
+    CHECK_EQ(m_soc_evt_count, 2 + SD_SIM_SOC_EVT_QUEUE_SIZE);
+    sd_sim_stats_get(&stats);
+    CHECK_EQ(stats.soc_evts, 2 + SD_SIM_SOC_EVT_QUEUE_SIZE);
+}
+
+
+static void test_ecb(void)
+{
+    // FIPS-197, appendix B and appendix C.1.
+    static uint8_t const key_b[16] =
+        {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    static uint8_t const clear_b[16] =
+        {0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d, 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34};
+    static uint8_t const cipher_b[16] =
+        {0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb, 0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32};
+    static uint8_t const cipher_c1[16] =
+        {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+
+    nrf_ecb_hal_data_t       ecb;
+    soc_ecb_key_t            key_c1;
+    soc_ecb_cleartext_t      clear_c1;
+    soc_ecb_ciphertext_t     out[2];
+    nrf_ecb_hal_data_block_t blocks[2];
+
+    sd_sim_init(NULL, evt_pump);
+
+    memcpy(ecb.key, key_b, sizeof(ecb.key));
+    memcpy(ecb.cleartext, clear_b, sizeof(ecb.cleartext));
+    CHECK_EQ(sd_ecb_block_encrypt(&ecb), NRF_SUCCESS);
+    CHECK(memcmp(ecb.ciphertext, cipher_b, sizeof(cipher_b)) == 0);
+    CHECK_EQ(sd_ecb_block_encrypt(NULL), NRF_ERROR_INVALID_ADDR);
+
+    for (uint8_t i = 0; i < sizeof(key_c1); i++)
+    {
+        key_c1[i]   = i;
+        clear_c1[i] = (uint8_t)(i * 0x11);
+    }
+    blocks[0].p_key        = &key_c1;
+    blocks[0].p_cleartext  = &clear_c1;
+    blocks[0].p_ciphertext = &out[0];
+    blocks[1].p_key        = &ecb.key;
+    blocks[1].p_cleartext  = &ecb.cleartext;
+    blocks[1].p_ciphertext = &out[1];
+    CHECK_EQ(sd_ecb_blocks_encrypt(2, blocks), NRF_SUCCESS);
+    CHECK(memcmp(out[0], cipher_c1, sizeof(cipher_c1)) == 0);
+    CHECK(memcmp(out[1], cipher_b, sizeof(cipher_b)) == 0);
+}
+
+
+int main(void)
+{
+    test_gatts();
+    test_gap();
+    test_central_write();
+    test_notifications();
+    test_flash();
+    test_ecb();
+
+    return UNIT_TEST_RESULT();
+}
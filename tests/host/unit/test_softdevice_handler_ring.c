@@ -0,0 +1,568 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Event ring of the SoftDevice handler, built with BLE and ANT support.
+ *
+ * @details The SoftDevice is played by the test: sd_evt_get, sd_ble_evt_get and sd_ant_event_get
+ *          hand out numbered events from per-source counts, and each event fills its slot with a
+ *          pattern derived from its number, so that slots overwritten before their handler ran are
+ *          caught. The test runs the stack event interrupt when it is pending and the dispatcher
+ *          when it is scheduled, as the NVIC and the scheduler would. Every handler checks that
+ *          its source is delivered in order, and from the context the configuration asks for.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unit_test.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_soc.h"
+#include "ant_interface.h"
+#include "softdevice_handler.h"
+
+#define SLOTS_MAX       16
+#define LOG_SIZE        64
+#define BLE_EVT_ID      BLE_GAP_EVT_CONNECTED
+#define BLE_EVT_LEN     GATT_MTU_SIZE_DEFAULT
+#define ANT_EVT_ID      0x80
+#define WRAP_EVENTS     (3 * 65536UL)
+
+/**@brief Event sources, in the order the ring takes them. */
+enum
+{
+    SOURCE_SOC,
+    SOURCE_BLE,
+    SOURCE_ANT,
+    SOURCE_COUNT
+};
+
+#define LOG_ENTRY(SOURCE, SEQ)  (((uint32_t)(SOURCE) << 24) | (SEQ))
+
+/**@brief Emulated SoftDevice. */
+typedef struct
+{
+    uint32_t pending[SOURCE_COUNT];     /**< Events waiting to be pulled. */
+    uint32_t pulled[SOURCE_COUNT];      /**< Events pulled, the number of the next one. */
+} sd_t;
+
+static sd_t     m_sd;
+static uint32_t m_dispatched[SOURCE_COUNT];     /**< Events handled, per source. */
+static uint32_t m_log[LOG_SIZE];                /**< Sources and numbers of the first events handled. */
+static uint32_t m_log_count;
+static bool     m_in_irq;                       /**< The stack event interrupt is running. */
+static bool     m_dispatch_in_irq;              /**< Events are expected to be handled in the interrupt. */
+static bool     m_scheduled;                    /**< The dispatcher is scheduled. */
+static uint32_t m_schedule_count;
+static uint32_t m_raised;                       /**< Events raised in the SoftDevice. */
+static uint32_t m_preempt_period;               /**< Every this many BLE events, the interrupt preempts the handler. 0 for never. */
+
+static uint32_t m_ring_buffer[SLOTS_MAX * SOFTDEVICE_EVT_RING_SLOT_WORDS];
+static uint32_t m_ble_evt_buffer[CEIL_DIV(BLE_STACK_EVT_MSG_BUF_SIZE, sizeof(uint32_t))];
+
+/**@brief Stack event interrupt of the SoftDevice handler. */
+void SD_EVT_IRQHandler(void);
+
+
+static uint8_t pattern(uint32_t seq, uint32_t i)
+{
+    return (uint8_t)(seq * 7 + i);
+}
+
+
+uint32_t sd_softdevice_enable(nrf_clock_lf_cfg_t const * p_clock_lf_cfg,
+                              nrf_fault_handler_t        fault_handler)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_softdevice_disable(void)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_enable(ble_enable_params_t * p_ble_enable_params, uint32_t * p_app_ram_base)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_evt_get(uint32_t * p_evt_id)
+{
+    if (m_sd.pending[SOURCE_SOC] == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_sd.pending[SOURCE_SOC]--;
+    *p_evt_id = m_sd.pulled[SOURCE_SOC]++;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for pulling a BLE event. Events are only word aligned in the ring, so the
+ *        header is accessed as such, not through ble_evt_t which is 8-byte aligned on a 64-bit
+ *        host. */
+uint32_t sd_ble_evt_get(uint8_t * p_dest, uint16_t * p_len)
+{
+    ble_evt_hdr_t * p_hdr = (ble_evt_hdr_t *)p_dest;
+    uint32_t        seq;
+
+    if (m_sd.pending[SOURCE_BLE] == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (*p_len < sizeof(ble_evt_hdr_t) + BLE_EVT_LEN)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+    m_sd.pending[SOURCE_BLE]--;
+    seq = m_sd.pulled[SOURCE_BLE]++;
+
+    p_hdr->evt_id  = BLE_EVT_ID;
+    p_hdr->evt_len = BLE_EVT_LEN;
+    memcpy(&p_dest[sizeof(ble_evt_hdr_t)], &seq, sizeof(seq));
+    for (uint32_t i = sizeof(seq); i < BLE_EVT_LEN; i++)
+    {
+        p_dest[sizeof(ble_evt_hdr_t) + i] = pattern(seq, i);
+    }
+    *p_len = sizeof(ble_evt_hdr_t) + BLE_EVT_LEN;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ant_event_get(uint8_t * pucChannel, uint8_t * pucEvent, uint8_t * aucANTMesg)
+{
+    uint32_t seq;
+
+    if (m_sd.pending[SOURCE_ANT] == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_sd.pending[SOURCE_ANT]--;
+    seq = m_sd.pulled[SOURCE_ANT]++;
+
+    *pucChannel = (uint8_t)seq;
+    *pucEvent   = ANT_EVT_ID;
+    memcpy(aucANTMesg, &seq, sizeof(seq));
+    for (uint32_t i = sizeof(seq); i < ANT_STACK_EVT_MSG_BUF_SIZE; i++)
+    {
+        aucANTMesg[i] = pattern(seq, i);
+    }
+    return NRF_SUCCESS;
+}
+
+
+void app_error_handler_bare(ret_code_t error_code)
+{
+    CHECK_EQ(error_code, NRF_SUCCESS);
+}
+
+
+void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info)
+{
+    CHECK(false);
+}
+
+
+static uint32_t evt_schedule(void)
+{
+    m_scheduled = true;
+    m_schedule_count++;
+    return NRF_SUCCESS;
+}
+
+
+static void evt_record(uint32_t source, uint32_t seq)
+{
+    CHECK_EQ(seq, m_dispatched[source]);
+    CHECK_EQ(m_in_irq, m_dispatch_in_irq);
+    m_dispatched[source]++;
+    if (m_log_count < LOG_SIZE)
+    {
+        m_log[m_log_count] = LOG_ENTRY(source, seq);
+    }
+    m_log_count++;
+}
+
+
+static void sys_evt_handler(uint32_t evt_id)
+{
+    evt_record(SOURCE_SOC, evt_id);
+}
+
+
+static void events_raise(uint32_t soc, uint32_t ble, uint32_t ant);
+static void irq_run(void);
+
+
+static void ble_evt_handler(ble_evt_t * p_ble_evt)
+{
+    ble_evt_hdr_t const * p_hdr  = (ble_evt_hdr_t const *)p_ble_evt;
+    uint8_t const       * p_data = (uint8_t const *)p_ble_evt + sizeof(ble_evt_hdr_t);
+    uint32_t              seq;
+    bool                  intact = true;
+
+    // New events pulled while the handler runs must not land in its slot.
+    if ((m_preempt_period != 0) && !m_in_irq && ((m_log_count % m_preempt_period) == 0))
+    {
+        events_raise(0, 2, 1);
+        irq_run();
+    }
+
+    CHECK_EQ(p_hdr->evt_id, BLE_EVT_ID);
+    CHECK_EQ(p_hdr->evt_len, BLE_EVT_LEN);
+    memcpy(&seq, p_data, sizeof(seq));
+    for (uint32_t i = sizeof(seq); i < BLE_EVT_LEN; i++)
+    {
+        intact = intact && (p_data[i] == pattern(seq, i));
+    }
+    CHECK(intact);
+    evt_record(SOURCE_BLE, seq);
+}
+
+
+static void ant_evt_handler(ant_evt_t * p_ant_evt)
+{
+    uint32_t seq;
+    bool     intact = true;
+
+    memcpy(&seq, p_ant_evt->msg.evt_buffer, sizeof(seq));
+    CHECK_EQ(p_ant_evt->channel, (uint8_t)seq);
+    CHECK_EQ(p_ant_evt->event, ANT_EVT_ID);
+    for (uint32_t i = sizeof(seq); i < ANT_STACK_EVT_MSG_BUF_SIZE; i++)
+    {
+        intact = intact && (p_ant_evt->msg.evt_buffer[i] == pattern(seq, i));
+    }
+    CHECK(intact);
+    evt_record(SOURCE_ANT, seq);
+}
+
+
+static bool irq_pending(void)
+{
+    return (host_nvic_pending & (1ULL << SD_EVT_IRQn)) != 0;
+}
+
+
+/**@brief Function for running the stack event interrupt, as the NVIC does once it is pending. */
+static void irq_run(void)
+{
+    host_nvic_pending &= ~(1ULL << SD_EVT_IRQn);
+    m_in_irq = true;
+    SD_EVT_IRQHandler();
+    m_in_irq = false;
+}
+
+
+/**@brief Function for running the scheduled dispatcher, as the main loop or task does. */
+static void dispatcher_run(void)
+{
+    CHECK(m_scheduled);
+    m_scheduled = false;
+    intern_softdevice_events_execute();
+}
+
+
+/**@brief Function for running the interrupt and the dispatcher until there is nothing left. */
+static void run(void)
+{
+    for (;;)
+    {
+        if (irq_pending())
+        {
+            irq_run();
+        }
+        else if (m_scheduled)
+        {
+            dispatcher_run();
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+
+/**@brief Function for raising events in the SoftDevice, which pends the stack event interrupt. */
+static void events_raise(uint32_t soc, uint32_t ble, uint32_t ant)
+{
+    m_sd.pending[SOURCE_SOC] += soc;
+    m_sd.pending[SOURCE_BLE] += ble;
+    m_sd.pending[SOURCE_ANT] += ant;
+    m_raised                 += soc + ble + ant;
+    host_nvic_pending |= (1ULL << SD_EVT_IRQn);
+}
+
+
+/**@brief Function for enabling the SoftDevice handler on a new ring, with nothing pending. */
+static void setup(uint16_t slot_count, uint16_t batch_size, softdevice_evt_schedule_func_t schedule)
+{
+    CHECK_EQ(softdevice_handler_sd_disable(), NRF_SUCCESS);
+
+    memset(&m_sd, 0, sizeof(m_sd));
+    memset(m_dispatched, 0, sizeof(m_dispatched));
+    m_log_count       = 0;
+    m_scheduled       = false;
+    m_schedule_count  = 0;
+    m_raised          = 0;
+    m_preempt_period  = 0;
+    m_dispatch_in_irq = (schedule == NULL);
+    host_periph_reset();
+
+    CHECK_EQ(softdevice_handler_ring_init(m_ring_buffer, slot_count, batch_size), NRF_SUCCESS);
+    CHECK_EQ(softdevice_handler_init(NULL, m_ble_evt_buffer, sizeof(m_ble_evt_buffer), schedule),
+             NRF_SUCCESS);
+    CHECK(host_nvic_enabled & (1ULL << SD_EVT_IRQn));
+}
+
+
+static void stats_check(uint16_t high_water, uint32_t deferred, uint32_t dispatched)
+{
+    softdevice_handler_ring_stats_t stats;
+
+    softdevice_handler_ring_stats_get(&stats);
+    CHECK_EQ(stats.high_water, high_water);
+    CHECK_EQ(stats.deferred, deferred);
+    CHECK_EQ(stats.dispatched, dispatched);
+}
+
+
+static void test_init(void)
+{
+    CHECK_EQ(softdevice_handler_ring_init(NULL, 4, 1), NRF_ERROR_NULL);
+    CHECK_EQ(softdevice_handler_ring_init((uint32_t *)((uint8_t *)m_ring_buffer + 1), 4, 1),
+             NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(softdevice_handler_ring_init(m_ring_buffer, 6, 1), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(softdevice_handler_ring_init(m_ring_buffer, 0, 1), NRF_ERROR_INVALID_PARAM);
+    CHECK_EQ(softdevice_handler_ring_init(m_ring_buffer, 4, 0), NRF_ERROR_INVALID_PARAM);
+
+    setup(4, 1, evt_schedule);
+    CHECK_EQ(softdevice_handler_ring_init(m_ring_buffer, 4, 1), NRF_ERROR_INVALID_STATE);
+}
+
+
+/**@brief One event is taken from each source in turn, and handled in that order. */
+static void test_round_robin(void)
+{
+    static const uint32_t expected[] =
+    {
+        LOG_ENTRY(SOURCE_SOC, 0), LOG_ENTRY(SOURCE_BLE, 0), LOG_ENTRY(SOURCE_ANT, 0),
+        LOG_ENTRY(SOURCE_SOC, 1), LOG_ENTRY(SOURCE_BLE, 1), LOG_ENTRY(SOURCE_ANT, 1),
+        LOG_ENTRY(SOURCE_SOC, 2), LOG_ENTRY(SOURCE_BLE, 2),
+        LOG_ENTRY(SOURCE_BLE, 3),
+        LOG_ENTRY(SOURCE_BLE, 4),
+    };
+
+    setup(16, 16, evt_schedule);
+    events_raise(3, 5, 2);
+
+    // The interrupt only pulls, the handlers run from the scheduler.
+    irq_run();
+    CHECK_EQ(m_log_count, 0);
+    CHECK_EQ(m_schedule_count, 1);
+    CHECK_EQ(m_sd.pending[SOURCE_SOC] + m_sd.pending[SOURCE_BLE] + m_sd.pending[SOURCE_ANT], 0);
+
+    run();
+    CHECK_EQ(m_log_count, sizeof(expected) / sizeof(expected[0]));
+    CHECK(memcmp(m_log, expected, sizeof(expected)) == 0);
+    CHECK_EQ(m_schedule_count, 1);
+    stats_check(10, 0, 10);
+}
+
+
+/**@brief A burst larger than the ring is left in the SoftDevice, and pulled by the interrupt the
+ *        dispatcher pends once it has freed the slots. */
+static void test_burst(void)
+{
+    setup(4, 4, evt_schedule);
+    events_raise(0, 11, 0);
+
+    irq_run();
+    CHECK_EQ(m_sd.pending[SOURCE_BLE], 7);
+    CHECK_EQ(m_schedule_count, 1);
+    stats_check(4, 1, 0);
+
+    // The dispatcher empties the ring and pends the interrupt instead of scheduling itself.
+    dispatcher_run();
+    CHECK_EQ(m_log_count, 4);
+    CHECK(irq_pending());
+    CHECK(!m_scheduled);
+
+    irq_run();
+    CHECK_EQ(m_sd.pending[SOURCE_BLE], 3);
+    CHECK_EQ(m_schedule_count, 2);
+    stats_check(4, 2, 4);
+
+    // The last pull finds the SoftDevice empty, so nothing more is deferred.
+    run();
+    CHECK_EQ(m_log_count, 11);
+    CHECK_EQ(m_dispatched[SOURCE_BLE], 11);
+    CHECK(!irq_pending());
+    CHECK_EQ(m_schedule_count, 3);
+    stats_check(4, 2, 11);
+
+    // Mixed sources: the ones left behind by a full ring are not starved.
+    setup(4, 2, evt_schedule);
+    events_raise(5, 11, 3);
+    irq_run();
+    CHECK_EQ(m_sd.pulled[SOURCE_SOC], 2);
+    CHECK_EQ(m_sd.pulled[SOURCE_BLE], 1);
+    CHECK_EQ(m_sd.pulled[SOURCE_ANT], 1);
+    run();
+    CHECK_EQ(m_dispatched[SOURCE_SOC], 5);
+    CHECK_EQ(m_dispatched[SOURCE_BLE], 11);
+    CHECK_EQ(m_dispatched[SOURCE_ANT], 3);
+    // The second fill starts over from the System events.
+    CHECK_EQ(m_log[4], LOG_ENTRY(SOURCE_SOC, 2));
+    CHECK_EQ(m_log[5], LOG_ENTRY(SOURCE_BLE, 1));
+}
+
+
+/**@brief Dispatching stops after each batch and reschedules until the ring is empty. Events pulled
+ *        meanwhile join the ring without scheduling the dispatcher twice. */
+static void test_batch(void)
+{
+    setup(16, 3, evt_schedule);
+    events_raise(0, 10, 0);
+    irq_run();
+    CHECK_EQ(m_schedule_count, 1);
+
+    dispatcher_run();
+    CHECK_EQ(m_log_count, 3);
+    CHECK(m_scheduled);
+    CHECK_EQ(m_schedule_count, 2);
+
+    events_raise(2, 0, 0);
+    irq_run();
+    CHECK_EQ(m_log_count, 3);
+    CHECK_EQ(m_schedule_count, 2);
+
+    dispatcher_run();
+    CHECK_EQ(m_log_count, 6);
+    CHECK_EQ(m_schedule_count, 3);
+    dispatcher_run();
+    CHECK_EQ(m_log_count, 9);
+    CHECK_EQ(m_schedule_count, 4);
+    dispatcher_run();
+    CHECK_EQ(m_log_count, 12);
+    CHECK(!m_scheduled);
+    CHECK_EQ(m_schedule_count, 4);
+    CHECK_EQ(m_dispatched[SOURCE_SOC], 2);
+    CHECK_EQ(m_dispatched[SOURCE_BLE], 10);
+    stats_check(10, 0, 12);
+
+    // The dispatcher finds nothing left, and is not scheduled again.
+    CHECK(!irq_pending());
+    m_scheduled = true;
+    dispatcher_run();
+    CHECK(!m_scheduled);
+    CHECK_EQ(m_log_count, 12);
+}
+
+
+/**@brief Without a scheduler, the interrupt handles the events itself, pulling again each time
+ *        the ring got full. */
+static void test_no_scheduler(void)
+{
+    setup(4, 1, NULL);
+    events_raise(2, 11, 1);
+
+    irq_run();
+    CHECK_EQ(m_log_count, 14);
+    CHECK_EQ(m_dispatched[SOURCE_SOC], 2);
+    CHECK_EQ(m_dispatched[SOURCE_BLE], 11);
+    CHECK_EQ(m_dispatched[SOURCE_ANT], 1);
+    CHECK(!irq_pending());
+    CHECK_EQ(m_schedule_count, 0);
+
+    // Pulls of 4, 4, 4 and 2 events: the ring was full three times. The batch size does not apply.
+    stats_check(4, 3, 14);
+}
+
+
+/**@brief The free running 16-bit ring indexes wrap several times, with the interrupt preempting
+ *        the dispatcher between batches and inside the handlers. */
+static void test_index_wrap(void)
+{
+    uint32_t rand_state = 1;
+
+    setup(4, 3, evt_schedule);
+    m_preempt_period = 5;
+
+    while (m_raised < WRAP_EVENTS)
+    {
+        rand_state = rand_state * 1103515245 + 12345;
+
+        switch ((rand_state >> 16) % 3)
+        {
+            case 0:
+            {
+                uint32_t soc = (rand_state >> 20) & 1;
+                uint32_t ble = (rand_state >> 21) % 7;
+                uint32_t ant = (rand_state >> 24) & 1;
+
+                events_raise(soc, ble, ant);
+                break;
+            }
+
+            case 1:
+                if (irq_pending())
+                {
+                    irq_run();
+                }
+                break;
+
+            default:
+                if (m_scheduled)
+                {
+                    dispatcher_run();
+                }
+                break;
+        }
+    }
+    run();
+
+    CHECK(m_raised > 2 * 65536);
+    CHECK_EQ(m_log_count, m_raised);
+    CHECK_EQ(m_dispatched[SOURCE_SOC] + m_dispatched[SOURCE_BLE] + m_dispatched[SOURCE_ANT], m_raised);
+    CHECK_EQ(m_sd.pending[SOURCE_SOC] + m_sd.pending[SOURCE_BLE] + m_sd.pending[SOURCE_ANT], 0);
+    {
+        softdevice_handler_ring_stats_t stats;
+
+        softdevice_handler_ring_stats_get(&stats);
+        CHECK_EQ(stats.dispatched, m_raised);
+        CHECK_EQ(stats.high_water, 4);
+        CHECK(stats.deferred > 0);
+    }
+}
+
+
+int main(void)
+{
+    CHECK_EQ(softdevice_sys_evt_handler_set(sys_evt_handler), NRF_SUCCESS);
+    CHECK_EQ(softdevice_ble_evt_handler_set(ble_evt_handler), NRF_SUCCESS);
+    CHECK_EQ(softdevice_ant_evt_handler_set(ant_evt_handler), NRF_SUCCESS);
+
+    test_init();
+    test_round_robin();
+    test_burst();
+    test_batch();
+    test_no_scheduler();
+    test_index_wrap();
+
+    return UNIT_TEST_RESULT();
+}
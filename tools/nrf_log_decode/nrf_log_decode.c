@@ -0,0 +1,264 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Linux decoder for nrf_log deferred binary output.
+ *
+ * @details Reads the raw bytes of RTT up-buffer 0, as written by J-Link RTT Logger or any RTT
+ *          client that saves the channel unchanged, and prints one line per entry. Format
+ *          strings are resolved from the allocated sections of the firmware ELF file.
+ *
+ *          Usage: nrf_log_decode [-t tick_hz] firmware.elf [capture.bin]
+ *
+ *          The capture is read from standard input if no file is given, so a live channel can be
+ *          piped into the decoder. tick_hz is the frequency of NRF_LOG_DEFERRED_TIMESTAMP_GET,
+ *          32768 by default.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "nrf_log_decoder.h"
+
+#define ELF_MAX_SECTIONS    64
+#define LINE_SIZE           512
+#define READ_SIZE           4096
+
+#define SHT_NOBITS          8
+#define SHF_ALLOC           0x2
+
+/**@brief Allocated section of the firmware image. */
+typedef struct
+{
+    uint32_t        address;
+    uint32_t        size;
+    uint8_t const * p_data;
+} section_t;
+
+/**@brief Firmware image. */
+typedef struct
+{
+    uint8_t   * p_file;
+    section_t   sections[ELF_MAX_SECTIONS];
+    uint32_t    count;
+} image_t;
+
+static char const * const m_levels[] = {"?", "ERROR", "WARNING", "INFO", "DEBUG"};
+
+
+static uint32_t le32(uint8_t const * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+static uint16_t le16(uint8_t const * p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+
+static uint8_t * file_read(char const * p_path, size_t * p_size)
+{
+    FILE    * p_file = fopen(p_path, "rb");
+    uint8_t * p_buf  = NULL;
+    long      size;
+
+    if (p_file == NULL)
+    {
+        return NULL;
+    }
+    if ((fseek(p_file, 0, SEEK_END) == 0) && ((size = ftell(p_file)) > 0) &&
+        (fseek(p_file, 0, SEEK_SET) == 0))
+    {
+        p_buf = malloc((size_t)size);
+        if ((p_buf != NULL) && (fread(p_buf, 1, (size_t)size, p_file) != (size_t)size))
+        {
+            free(p_buf);
+            p_buf = NULL;
+        }
+        *p_size = (size_t)size;
+    }
+    fclose(p_file);
+    return p_buf;
+}
+
+
+/**@brief Function for loading the allocated sections of a 32-bit little endian ELF file. */
+static int image_load(image_t * p_image, char const * p_path)
+{
+    size_t          size;
+    uint8_t const * p_elf;
+    uint32_t        shoff;
+    uint16_t        shentsize;
+    uint16_t        shnum;
+
+    p_image->count  = 0;
+    p_image->p_file = file_read(p_path, &size);
+    p_elf           = p_image->p_file;
+
+    if ((p_elf == NULL) || (size < 52) || (memcmp(p_elf, "\x7f" "ELF", 4) != 0) ||
+        (p_elf[4] != 1) || (p_elf[5] != 1))
+    {
+        fprintf(stderr, "%s: not a 32-bit little endian ELF file\n", p_path);
+        return -1;
+    }
+
+    shoff     = le32(&p_elf[32]);
+    shentsize = le16(&p_elf[46]);
+    shnum     = le16(&p_elf[48]);
+
+    if ((shentsize < 40) || ((uint64_t)shoff + (uint64_t)shnum * shentsize > size))
+    {
+        fprintf(stderr, "%s: bad section table\n", p_path);
+        return -1;
+    }
+
+    for (uint32_t i = 0; (i < shnum) && (p_image->count < ELF_MAX_SECTIONS); i++)
+    {
+        uint8_t const * p_sh    = &p_elf[shoff + i * shentsize];
+        uint32_t        type    = le32(&p_sh[4]);
+        uint32_t        flags   = le32(&p_sh[8]);
+        uint32_t        address = le32(&p_sh[12]);
+        uint32_t        offset  = le32(&p_sh[16]);
+        uint32_t        length  = le32(&p_sh[20]);
+
+        if ((flags & SHF_ALLOC) && (type != SHT_NOBITS) && (length != 0) &&
+            ((uint64_t)offset + length <= size))
+        {
+            section_t * p_section = &p_image->sections[p_image->count++];
+
+            p_section->address = address;
+            p_section->size    = length;
+            p_section->p_data  = &p_elf[offset];
+        }
+    }
+    return 0;
+}
+
+
+/**@brief String lookup in the firmware image. The string must end inside its section. */
+static char const * image_string_get(uint32_t address, void * p_context)
+{
+    image_t const * p_image = p_context;
+
+    for (uint32_t i = 0; i < p_image->count; i++)
+    {
+        section_t const * p_section = &p_image->sections[i];
+
+        if ((address >= p_section->address) &&
+            (address - p_section->address < p_section->size))
+        {
+            uint32_t     offset = address - p_section->address;
+            char const * p_str  = (char const *)&p_section->p_data[offset];
+
+            if (memchr(p_str, '\0', p_section->size - offset) != NULL)
+            {
+                return p_str;
+            }
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+
+int main(int argc, char ** argv)
+{
+    static uint8_t buf[READ_SIZE + 64];
+
+    image_t   image;
+    FILE    * p_in    = stdin;
+    double    tick_hz = 32768.0;
+    size_t    len     = 0;
+    uint32_t  skipped = 0;
+    int       arg     = 1;
+
+    if ((argc > 2) && (strcmp(argv[1], "-t") == 0))
+    {
+        tick_hz = atof(argv[2]);
+        arg     = 3;
+    }
+    if ((argc - arg < 1) || (argc - arg > 2) || (tick_hz <= 0))
+    {
+        fprintf(stderr, "usage: %s [-t tick_hz] firmware.elf [capture.bin]\n", argv[0]);
+        return 2;
+    }
+    if (image_load(&image, argv[arg]) != 0)
+    {
+        return 1;
+    }
+    if ((argc - arg == 2) && ((p_in = fopen(argv[arg + 1], "rb")) == NULL))
+    {
+        perror(argv[arg + 1]);
+        return 1;
+    }
+
+    for (;;)
+    {
+        size_t got = fread(&buf[len], 1, READ_SIZE, p_in);
+        size_t pos = 0;
+
+        len += got;
+
+        while (pos < len)
+        {
+            nrf_log_decoder_entry_t entry;
+            char                    line[LINE_SIZE];
+            size_t                  consumed;
+            size_t                  line_end;
+            ret_code_t              err_code;
+
+            err_code = nrf_log_decoder_entry_parse(&buf[pos], len - pos, &entry, &consumed);
+            if (err_code == NRF_ERROR_DATA_SIZE)
+            {
+                break;
+            }
+            if (err_code != NRF_SUCCESS)
+            {
+                // Resynchronize on the next word.
+                pos     += sizeof(uint32_t);
+                skipped += sizeof(uint32_t);
+                continue;
+            }
+
+            (void)nrf_log_decoder_format(&entry, image_string_get, &image, line, sizeof(line));
+
+            // Target strings usually end with "\r\n", one line is printed per entry.
+            line_end = strlen(line);
+            while ((line_end > 0) && ((line[line_end - 1] == '\r') || (line[line_end - 1] == '\n')))
+            {
+                line[--line_end] = '\0';
+            }
+            printf("[%12.6f] <%s> %s\n", entry.timestamp / tick_hz, m_levels[entry.level], line);
+            pos += consumed;
+        }
+
+        memmove(buf, &buf[pos], len - pos);
+        len -= pos;
+
+        if (got == 0)
+        {
+            break;
+        }
+        fflush(stdout);
+    }
+
+    if ((len != 0) || (skipped != 0))
+    {
+        fprintf(stderr, "%u bytes could not be decoded\n", (unsigned)(len + skipped));
+    }
+    free(image.p_file);
+    return 0;
+}